@@ -192,6 +192,12 @@ typedef struct sheader {
    unsigned char Ahl;
 } SCN_HEADER;
 
+/* Per-call state of the JPEGL decoder, allowing images to be */
+/* decoded concurrently from multiple threads.                */
+typedef struct jpegl_decoder {
+   unsigned char code;  /* partially consumed byte of entropy coded data */
+} JPEGL_DECODER;
+
 /* GLOBAL VARIABLES */
 extern int biomeval_nbis_debug;
 
@@ -212,6 +218,13 @@ extern int biomeval_nbis_decode_data(int *, int *, int *, int *, unsigned char *
 extern int biomeval_nbis_nextbits_jpegl(unsigned short *, FILE *, int *, const int);
 extern int biomeval_nbis_getc_nextbits_jpegl(unsigned short *, unsigned char **,
                     unsigned char *, int *, const int);
+extern void biomeval_nbis_init_jpegl_decoder(JPEGL_DECODER *);
+extern int biomeval_nbis_jpegl_decode_mem_r(JPEGL_DECODER *, IMG_DAT **, int *,
+                    unsigned char *, const int);
+extern int biomeval_nbis_decode_data_r(JPEGL_DECODER *, int *, int *, int *, int *,
+                    unsigned char *, unsigned char **, unsigned char *, int *);
+extern int biomeval_nbis_getc_nextbits_jpegl_r(JPEGL_DECODER *, unsigned short *,
+                    unsigned char **, unsigned char *, int *, const int);
 
 /* huff.c */
 extern int biomeval_nbis_read_huffman_table(unsigned char *, unsigned char **,
@@ -184,6 +184,26 @@ typedef struct header_frm {
    unsigned short software;
 } FRM_HEADER_WSQ;
 
+/* Per-call state of the WSQ decoder, allowing images to be */
+/* decoded concurrently from multiple threads.              */
+typedef struct wsq_decoder {
+   DTT_TABLE dtt_table;
+   DQT_TABLE dqt_table;
+   DHT_TABLE dht_table[MAX_DHT_TABLES];
+   FRM_HEADER_WSQ frm_header_wsq;
+   W_TREE w_tree[W_TREELEN];
+   Q_TREE q_tree[Q_TREELEN];
+   unsigned char code;  /* partially consumed byte of entropy coded data */
+} WSQ_DECODER;
+
+/* Per-call state of the WSQ encoder, allowing images to be */
+/* encoded concurrently from multiple threads.              */
+typedef struct wsq_encoder {
+   QUANT_VALS quant_vals;
+   W_TREE w_tree[W_TREELEN];
+   Q_TREE q_tree[Q_TREELEN];
+} WSQ_ENCODER;
+
 /* External global variables. */
 extern int biomeval_nbis_debug;
 extern QUANT_VALS biomeval_nbis_quant_vals;
@@ -203,13 +223,23 @@ extern void biomeval_nbis_quant_block_sizes2(int *, int *, int *, const DQT_TABL
                  W_TREE *, const int, Q_TREE *, const int);
 extern int biomeval_nbis_wsq_crop_qdata(const DQT_TABLE *, Q_TREE *, Q_TREE *, Q_TREE *,
                  short *, int, int, int, int, short *);
+extern int biomeval_nbis_wsq_crop_qdata_r(const DQT_TABLE *, W_TREE *, Q_TREE *,
+                 Q_TREE *, Q_TREE *, short *, int, int, int, int, short *);
 extern int biomeval_nbis_wsq_cropcoeff_mem(unsigned char **, int *, int *, int *, int, int,
                  int, int, int *, int *, unsigned char *, const int, short **,
                  int *, int *);
+extern int biomeval_nbis_wsq_cropcoeff_mem_r(WSQ_DECODER *, unsigned char **, int *,
+                 int *, int *, int, int, int, int, int *, int *, unsigned char *,
+                 const int, short **, int *, int *);
 extern int biomeval_nbis_wsq_huffcode_mem(unsigned char *, int *, short *, int, int,
                  unsigned char *, const int, const int, const int);
+extern int biomeval_nbis_wsq_huffcode_mem_r(const DQT_TABLE *, W_TREE *, Q_TREE *,
+                 unsigned char *, int *, short *, int, int, unsigned char *,
+                 const int, const int, const int);
 extern int biomeval_nbis_wsq_dehuff_mem(short **, int *, int *, double *, double *, 
                  int *, int *, unsigned char *, const int ilen);
+extern int biomeval_nbis_wsq_dehuff_mem_r(WSQ_DECODER *, short **, int *, int *,
+                 double *, double *, int *, int *, unsigned char *, const int);
 extern int biomeval_nbis_read_wsq_frame_header(unsigned char *, const int, int *, int *,
 				 double *, double *);
 
@@ -218,6 +248,10 @@ extern int biomeval_nbis_wsq_decode_mem(unsigned char **, int *, int *, int *, i
                  unsigned char *, const int);
 extern int biomeval_nbis_wsq_decode_file(unsigned char **, int *, int *, int *, int *,
                  int *, FILE *);
+extern int biomeval_nbis_wsq_decode_mem_r(WSQ_DECODER *, unsigned char **, int *,
+                 int *, int *, int *, int *, unsigned char *, const int);
+extern int biomeval_nbis_huffman_decode_data_mem_r(WSQ_DECODER *, short *,
+                 unsigned char **, unsigned char *);
 extern int biomeval_nbis_huffman_decode_data_mem(short *, DTT_TABLE *, DQT_TABLE *,
                  DHT_TABLE *, unsigned char **, unsigned char *);
 extern int biomeval_nbis_huffman_decode_data_file(short *, DTT_TABLE *, DQT_TABLE *,
@@ -234,6 +268,9 @@ extern int biomeval_nbis_getc_nextbits_wsq(unsigned short *, unsigned short *,
 /* encoder.c */
 extern int biomeval_nbis_wsq_encode_mem(unsigned char **, int *, const float, unsigned char *,
                  const int, const int, const int, const int, char *);
+extern int biomeval_nbis_wsq_encode_mem_r(WSQ_ENCODER *, unsigned char **, int *,
+                 const float, unsigned char *, const int, const int, const int,
+                 const int, char *);
 extern int biomeval_nbis_gen_hufftable_wsq(HUFFCODE **, unsigned char **, unsigned char **,
                  short *, const int *, const int);
 extern int biomeval_nbis_compress_block(unsigned char *, int *, short *,
@@ -334,6 +371,8 @@ extern int biomeval_nbis_int_sign(const int);
 extern int biomeval_nbis_image_size(const int, short *, short *);
 extern void biomeval_nbis_init_wsq_decoder_resources(void);
 extern void biomeval_nbis_free_wsq_decoder_resources(void);
+extern void biomeval_nbis_init_wsq_decoder(WSQ_DECODER *);
+extern void biomeval_nbis_free_wsq_decoder(WSQ_DECODER *);
 
 extern int biomeval_nbis_delete_comments_wsq(unsigned char **, int *, unsigned char *, int);
 
@@ -58,14 +58,23 @@ of the software.
 #cat: biomeval_nbis_jpegl_decode_mem - Decodes a datastream of JPEGL compressed bytes
 #cat:                    from a memory buffer, returning a lossless
 #cat:                    reconstructed pixmap.
+#cat: biomeval_nbis_jpegl_decode_mem_r - Reentrant version of biomeval_nbis_jpegl_decode_mem
+#cat:                    that keeps all decoder state in a caller-supplied
+#cat:                    context.
+#cat: biomeval_nbis_init_jpegl_decoder - Initializes a reentrant JPEGL decoder
+#cat:                    context.
 #cat: biomeval_nbis_build_huff_decode_table - Builds a table of pixel difference values.
 #cat:
 #cat: biomeval_nbis_decode_data - Decodes compressed data buffer.
 #cat:
+#cat: biomeval_nbis_decode_data_r - Reentrant version of biomeval_nbis_decode_data.
+#cat:
 #cat: biomeval_nbis_nextbits_jpegl - Gets next sequence of bits for data decoding
 #cat:                    from an open file.
 #cat: biomeval_nbis_getc_nextbits_jpegl - Gets next sequence of bits for data decoding
 #cat:                    from a memory buffer.
+#cat: biomeval_nbis_getc_nextbits_jpegl_r - Reentrant version of
+#cat:                    biomeval_nbis_getc_nextbits_jpegl.
 
 ***********************************************************************/
 
@@ -73,11 +82,29 @@ of the software.
 #include <jpegl.h>
 #include <dataio.h>
 
+/* Decoder state shared by the non-reentrant memory buffer routines. */
+static JPEGL_DECODER biomeval_nbis_jpegl_decoder;
+
 /******************/
 /*Start of Decoder*/
 /******************/
 int biomeval_nbis_jpegl_decode_mem(IMG_DAT **oimg_dat, int *lossyflag,
                      unsigned char *idata, const int ilen)
+{
+   JPEGL_DECODER decoder;
+
+   biomeval_nbis_init_jpegl_decoder(&decoder);
+   return(biomeval_nbis_jpegl_decode_mem_r(&decoder, oimg_dat, lossyflag,
+                                           idata, ilen));
+}
+
+/*****************************************************************/
+/* Reentrant decoder, keeping its state in the decoder context   */
+/* so that images may be decoded concurrently, provided each     */
+/* thread uses its own context.                                  */
+/*****************************************************************/
+int biomeval_nbis_jpegl_decode_mem_r(JPEGL_DECODER *decoder, IMG_DAT **oimg_dat,
+                     int *lossyflag, unsigned char *idata, const int ilen)
 {
    int ret;
    int i, cmpnt_i;
@@ -206,7 +233,8 @@ int biomeval_nbis_jpegl_decode_mem(IMG_DAT **oimg_dat, int *lossyflag,
 	 for(pixel = 0; pixel < num_pixels; pixel++) {
             /*get next huffman category code from compressed input
               data stream*/
-            if((ret = biomeval_nbis_decode_data(&diff_cat, huf_table[cmpnt_i]->mincode,
+            if((ret = biomeval_nbis_decode_data_r(decoder, &diff_cat,
+                                 huf_table[cmpnt_i]->mincode,
                                  huf_table[cmpnt_i]->maxcode,
                                  huf_table[cmpnt_i]->valptr,
                                  huf_table[cmpnt_i]->values,
@@ -219,8 +247,8 @@ int biomeval_nbis_jpegl_decode_mem(IMG_DAT **oimg_dat, int *lossyflag,
 
             /*get the required bits (given by huffman code) to reconstruct
               the difference value for the pixel*/
-            if((ret = biomeval_nbis_getc_nextbits_jpegl(&diff_code, &cbufptr, ebufptr,
-                                   &bit_count, diff_cat))){
+            if((ret = biomeval_nbis_getc_nextbits_jpegl_r(decoder, &diff_code,
+                                   &cbufptr, ebufptr, &bit_count, diff_cat))){
                biomeval_nbis_free_HUFF_TABLES(huf_table, MAX_CMPNTS);
                biomeval_nbis_free_IMG_DAT(img_dat, FREE_IMAGE);
                free(scn_header);
@@ -282,6 +310,14 @@ int biomeval_nbis_jpegl_decode_mem(IMG_DAT **oimg_dat, int *lossyflag,
    return(0);
 }
 
+/***********************************************/
+/*Routine to initialize a reentrant decoder state*/
+/***********************************************/
+void biomeval_nbis_init_jpegl_decoder(JPEGL_DECODER *decoder)
+{
+   decoder->code = 0;
+}
+
 /***************************************************/
 /*Routine to build code table for difference values*/
 /***************************************************/
@@ -316,6 +352,16 @@ void biomeval_nbis_build_huff_decode_table(int huff_decoder[MAX_CATEGORY][LARGES
 int biomeval_nbis_decode_data(int *odiff_cat, int *mincode, int *maxcode,
                 int *valptr, unsigned char *huffvalues,
                 unsigned char **cbufptr, unsigned char *ebufptr, int *bit_count)
+{
+   return(biomeval_nbis_decode_data_r(&biomeval_nbis_jpegl_decoder, odiff_cat,
+             mincode, maxcode, valptr, huffvalues, cbufptr, ebufptr,
+             bit_count));
+}
+
+int biomeval_nbis_decode_data_r(JPEGL_DECODER *decoder, int *odiff_cat,
+                int *mincode, int *maxcode, int *valptr,
+                unsigned char *huffvalues, unsigned char **cbufptr,
+                unsigned char *ebufptr, int *bit_count)
 {
    int ret;
    int inx, inx2;    /*increment variables*/
@@ -323,12 +369,14 @@ int biomeval_nbis_decode_data(int *odiff_cat, int *mincode, int *maxcode,
    unsigned short tcode, tcode2;
    int diff_cat;     /*category of the huffman code word*/
 
-   if((ret = biomeval_nbis_getc_nextbits_jpegl(&tcode, cbufptr, ebufptr, bit_count, 1)))
+   if((ret = biomeval_nbis_getc_nextbits_jpegl_r(decoder, &tcode, cbufptr,
+                                   ebufptr, bit_count, 1)))
       return(ret);
    code = tcode;
 
    for(inx = 1; code > maxcode[inx]; inx++){
-      if((ret = biomeval_nbis_getc_nextbits_jpegl(&tcode2, cbufptr, ebufptr, bit_count, 1)))
+      if((ret = biomeval_nbis_getc_nextbits_jpegl_r(decoder, &tcode2, cbufptr,
+                                      ebufptr, bit_count, 1)))
          return(ret);
       code = (code << 1) + tcode2;
    }
@@ -398,16 +446,23 @@ int biomeval_nbis_nextbits_jpegl(unsigned short *obits, FILE *infp,
 /**************************************************************/
 int biomeval_nbis_getc_nextbits_jpegl(unsigned short *obits, unsigned char **cbufptr,
                   unsigned char *ebufptr, int *bit_count, const int bits_req)
+{
+   return(biomeval_nbis_getc_nextbits_jpegl_r(&biomeval_nbis_jpegl_decoder, obits,
+             cbufptr, ebufptr, bit_count, bits_req));
+}
+
+int biomeval_nbis_getc_nextbits_jpegl_r(JPEGL_DECODER *decoder,
+                  unsigned short *obits, unsigned char **cbufptr,
+                  unsigned char *ebufptr, int *bit_count, const int bits_req)
 {
    int ret;
-   static unsigned char code;    /*next byte of data*/
    unsigned char code2;
    unsigned short bits, tbits;   /*bits of current data byte requested*/
    int bits_needed;      /*additional bits required to finish request*/
 
    /*used to "mask out" n number of bits from data stream*/
-   static unsigned char bit_mask[9] = {0x00,0x01,0x03,0x07,0x0f,
-                                       0x1f,0x3f,0x7f,0xff};
+   static const unsigned char bit_mask[9] = {0x00,0x01,0x03,0x07,0x0f,
+                                             0x1f,0x3f,0x7f,0xff};
 
    if(bits_req == 0){
       *obits = 0;
@@ -415,10 +470,10 @@ int biomeval_nbis_getc_nextbits_jpegl(unsigned short *obits, unsigned char **cbu
    }
 
    if(*bit_count == 0) {
-      if((ret = biomeval_nbis_getc_byte(&code, cbufptr, ebufptr)))
+      if((ret = biomeval_nbis_getc_byte(&decoder->code, cbufptr, ebufptr)))
          return(ret);
       *bit_count = BITSPERBYTE;
-      if(code == 0xff) {
+      if(decoder->code == 0xff) {
          if((ret = biomeval_nbis_getc_byte(&code2, cbufptr, ebufptr)))
             return(ret);
 	 if(code2 != 0x00) {
@@ -428,16 +483,16 @@ int biomeval_nbis_getc_nextbits_jpegl(unsigned short *obits, unsigned char **cbu
       }
    }
    if(bits_req <= *bit_count) {
-      bits = (code >>(*bit_count - bits_req)) & (bit_mask[bits_req]);
+      bits = (decoder->code >>(*bit_count - bits_req)) & (bit_mask[bits_req]);
       *bit_count -= bits_req;
-      code &= bit_mask[*bit_count];
+      decoder->code &= bit_mask[*bit_count];
    }
    else {
       bits_needed = bits_req - *bit_count;
-      bits = code << bits_needed;
+      bits = decoder->code << bits_needed;
       *bit_count = 0;
-      if((ret = biomeval_nbis_getc_nextbits_jpegl(&tbits, cbufptr, ebufptr, bit_count,
-                                   bits_needed)))
+      if((ret = biomeval_nbis_getc_nextbits_jpegl_r(decoder, &tbits, cbufptr,
+                                   ebufptr, bit_count, bits_needed)))
          return(ret);
       bits |= tbits;
    }
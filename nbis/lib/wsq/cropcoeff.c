@@ -44,20 +44,32 @@ fingerprint-recompression-after-segmentation
 #cat:                pointer rather than QUANT_VALS.
 #cat:                I.e. no rate control is performed in this version.
 #cat: biomeval_nbis_wsq_crop_qdata - Crop quantized coeff structures.
+#cat: biomeval_nbis_wsq_crop_qdata_r - Reentrant version of
+#cat:                biomeval_nbis_wsq_crop_qdata, building the cropped
+#cat:                trees in a caller-supplied W_TREE.
 #cat: biomeval_nbis_wsq_cropcoeff_mem - Crops input buffer of WSQ compressed bytes
 #cat:                into output WSQ buffer, by eliminating unneeded 
 #cat:                wavelet coefficients. First call (NULL output,
 #cat:                and NULL qdata) will decode original data. 
 #cat:                Subsequent calls reuse data, and do not repeat 
 #cat:                the decode.
+#cat: biomeval_nbis_wsq_cropcoeff_mem_r - Reentrant version of
+#cat:                biomeval_nbis_wsq_cropcoeff_mem that keeps the
+#cat:                decoded tables in a caller-supplied context.
 #cat: biomeval_nbis_wsq_huffcode_mem - WSQ Huffman codes quantized coefficient array,
 #cat:                returning a changed memory buffer. Can be called
 #cat:                repeatedly with the same codestream header buffer.  
 #cat:                and won't reread the data.
+#cat: biomeval_nbis_wsq_huffcode_mem_r - Reentrant version of
+#cat:                biomeval_nbis_wsq_huffcode_mem, passed the tables
+#cat:                built by biomeval_nbis_wsq_crop_qdata_r.
 #cat: biomeval_nbis_wsq_dehuff_mem - Decodes WSQ to a quantized coefficient array,
 #cat:                and stops. Internal decode info (biomeval_nbis_dtt_table,biomeval_nbis_dqt_table)
 #cat:                is retained. Call once, followed by multiple calls
 #cat:                to biomeval_nbis_wsq_crop_qdata and biomeval_nbis_wsq_huffcode_mem. 
+#cat: biomeval_nbis_wsq_dehuff_mem_r - Reentrant version of
+#cat:                biomeval_nbis_wsq_dehuff_mem that retains the
+#cat:                decode info in a caller-supplied context.
 #cat: biomeval_nbis_read_wsq_frame_header - Parses WSQ memory until the frame header is
 #cat:                found. The image dimensions and scale and shift
 #cat:                fields are read and returned.
@@ -74,6 +86,11 @@ fingerprint-recompression-after-segmentation
 Q_TREE biomeval_nbis_q_tree2[Q_TREELEN];
 Q_TREE biomeval_nbis_q_tree3[Q_TREELEN];
 
+static int biomeval_nbis_wsq_cropcoeff_state(unsigned char *, int *, int *,
+                 int *, int, int, int, int, const int, const int,
+                 const DQT_TABLE *, W_TREE *, Q_TREE *, Q_TREE *, Q_TREE *,
+                 short *, unsigned char *, const int, const int, const int);
+
 /************************************************************************/
 /* Compute biomeval_nbis_quantized WSQ subband block sizes, using DQT_TABLE input     */
 /* Near duplicate of biomeval_nbis_quant_block_sizes (util.c), but passing a          */
@@ -134,6 +151,30 @@ int biomeval_nbis_wsq_crop_qdata(
    int width,            /* Crop region width */
    int height,           /* Crop region height */
    short *scp)           /* Cropped quantized data pointer       */
+{
+   return(biomeval_nbis_wsq_crop_qdata_r(dqt_table, biomeval_nbis_w_tree,
+                    q_tree, q_tree2, q_tree3, sip, ulx, uly, width, height,
+                    scp));
+}
+
+/*****************************************************************/
+/* Reentrant version of biomeval_nbis_wsq_crop_qdata.  The       */
+/* cropped trees are built in w_tree instead of the global       */
+/* biomeval_nbis_w_tree, so w_tree must be passed on to          */
+/* biomeval_nbis_wsq_huffcode_mem_r along with q_tree2.          */
+/*****************************************************************/
+int biomeval_nbis_wsq_crop_qdata_r(
+   const DQT_TABLE *dqt_table, /* quantization table structure   */
+   W_TREE w_tree[],      /* Returned wavelet tree of cropped region */
+   Q_TREE q_tree[], 
+   Q_TREE q_tree2[],
+   Q_TREE q_tree3[],
+   short *sip,           /* Original quantized data pointer      */
+   int ulx,              /* UL corner col */
+   int uly,              /* UL corner row */
+   int width,            /* Crop region width */
+   int height,           /* Crop region height */
+   short *scp)           /* Cropped quantized data pointer       */
 {
    int row;  /* row counter */
    short *cptr;   /* image pointers */
@@ -154,8 +195,8 @@ int biomeval_nbis_wsq_crop_qdata(
       data.  Note that q_tree is not touched, so it can still be used to 
       access the uncropped coefficient data. 
    */
-   biomeval_nbis_build_wsq_trees(biomeval_nbis_w_tree, W_TREELEN, q_tree3, Q_TREELEN, ulx, uly);
-   biomeval_nbis_build_wsq_trees(biomeval_nbis_w_tree, W_TREELEN, q_tree2, Q_TREELEN, width, height);
+   biomeval_nbis_build_wsq_trees(w_tree, W_TREELEN, q_tree3, Q_TREELEN, ulx, uly);
+   biomeval_nbis_build_wsq_trees(w_tree, W_TREELEN, q_tree2, Q_TREELEN, width, height);
 
    if(dqt_table->dqt_def != 1) {
       fprintf(stderr,
@@ -213,7 +254,6 @@ int biomeval_nbis_wsq_cropcoeff_mem(
    int width, height;             /* image parameters */
    unsigned char *wsq_data;      /* compressed data buffer      */
    short *qdata;                  /* image pointers */
-   short *qdata2;                  /* image pointers */
    int first;
    double scale, shift;
 
@@ -250,6 +290,115 @@ int biomeval_nbis_wsq_cropcoeff_mem(
      height = *ih;
    }
 
+   if((ret = biomeval_nbis_wsq_cropcoeff_state(wsq_data, olen, ow, oh,
+                    ulx, uly, lrx, lry, width, height, &biomeval_nbis_dqt_table,
+                    biomeval_nbis_w_tree, biomeval_nbis_q_tree,
+                    biomeval_nbis_q_tree2, biomeval_nbis_q_tree3, qdata,
+                    idata, ilen, *hgt_pos, *huff_pos)))
+      return(ret);
+
+   if(*ow != -1)
+      *odata = wsq_data;
+
+   /* Return normally. */
+   return(0);
+}
+
+/*************************************************************
+   Reentrant version of biomeval_nbis_wsq_cropcoeff_mem.  The
+   tables read from idata on the first call are kept in the
+   decoder context, which must have been initialized by
+   biomeval_nbis_init_wsq_decoder(), instead of in the global
+   tables, so that any number of codestreams may be cropped
+   concurrently, provided each uses its own context.  The
+   context must be passed to every call for the same idata.
+
+   Unlike biomeval_nbis_wsq_cropcoeff_mem, *odata is set on the
+   first call even when no image is generated for the box.
+   Once done cropping, the caller frees *odata and *pqdata.
+**************************************************************/
+int biomeval_nbis_wsq_cropcoeff_mem_r(
+   WSQ_DECODER *decoder,  /* Decoder context for idata */
+   unsigned char **odata, /* Cropped WSQ mem */
+   int *olen,             /* Cropped WSQ coded length */
+   int *ow, int *oh,      /* Actual crop width/height */
+   int ulx, int uly,      /* UL corner request */
+   int lrx, int lry,      /* LR corner request */
+                          /* Note: LR corner pixel not included in crop */
+   int *iw, int *ih,      /* Input WSQ dimensions */
+   unsigned char *idata,  /* Input WSQ data */
+   const int ilen,        /* Input WSQ length */
+   short **pqdata,        /* Pointer to input image qdata array */
+   int *hgt_pos,          /* Position of Frame Header Height in idata */
+   int *huff_pos          /* Position where Huff data begins in idata */
+)
+{
+   int ret;
+   unsigned char *wsq_data;      /* compressed data buffer      */
+   short *qdata;                  /* image pointers */
+   double scale, shift;
+   W_TREE w_tree[W_TREELEN];      /* trees of cropped region */
+   Q_TREE q_tree2[Q_TREELEN];
+   Q_TREE q_tree3[Q_TREELEN];
+
+   if (*pqdata == NULL || *odata == NULL) {
+     if ((ret = biomeval_nbis_wsq_dehuff_mem_r(decoder, &qdata, iw, ih,
+                     &scale, &shift, hgt_pos, huff_pos, idata, ilen))) {
+       biomeval_nbis_free_wsq_decoder(decoder);
+       return(ret);
+     }
+
+     /* The transform table is only needed to reconstruct pixels. */
+     biomeval_nbis_free_wsq_decoder(decoder);
+
+     /* Allocate a WSQ-encoded output buffer the size of the */
+     /* original codestream, as biomeval_nbis_wsq_cropcoeff_mem. */
+     wsq_data = (unsigned char *)malloc(ilen);
+     if(wsq_data == (unsigned char *)NULL){
+       free(qdata);
+       fprintf(stderr, "ERROR : wsq_cropcoeff_mem_r : malloc : wsq_data\n");
+       return(-12);
+     }
+     *pqdata = qdata;
+     *odata = wsq_data;
+   }
+
+   return(biomeval_nbis_wsq_cropcoeff_state(*odata, olen, ow, oh,
+                    ulx, uly, lrx, lry, *iw, *ih, &decoder->dqt_table,
+                    w_tree, decoder->q_tree, q_tree2, q_tree3, *pqdata,
+                    idata, ilen, *hgt_pos, *huff_pos));
+}
+
+/*************************************************************
+   Crops the quantized coefficients qdata of a widthxheight
+   image to the requested box and Huffman codes them into
+   wsq_data, which must be at least ilen bytes.  Shared by
+   biomeval_nbis_wsq_cropcoeff_mem and its reentrant version,
+   which pass the tables they decoded idata with.
+**************************************************************/
+static int biomeval_nbis_wsq_cropcoeff_state(
+   unsigned char *wsq_data, /* Cropped WSQ mem */
+   int *olen,             /* Cropped WSQ coded length */
+   int *ow, int *oh,      /* Actual crop width/height */
+   int ulx, int uly,      /* UL corner request */
+   int lrx, int lry,      /* LR corner request */
+   const int width,       /* Input WSQ dimensions */
+   const int height,
+   const DQT_TABLE *dqt_table, /* Tables decoded from idata */
+   W_TREE w_tree[],
+   Q_TREE q_tree[],
+   Q_TREE q_tree2[],
+   Q_TREE q_tree3[],
+   short *qdata,          /* Input image qdata array */
+   unsigned char *idata,  /* Input WSQ data */
+   const int ilen,        /* Input WSQ length */
+   const int hgt_pos,     /* Position of Frame Header Height in idata */
+   const int huff_pos     /* Position where Huff data begins in idata */
+)
+{
+   int ret;
+   short *qdata2;                  /* image pointers */
+
    /* Check that box corners define a valid box */
    if (ulx >= lrx || uly >=lry) {
      fprintf(stderr, "WARNING : biomeval_nbis_wsq_cropcoeff_mem : invalid box UL(%d,%d), LR(%d,%d)\n", 
@@ -291,7 +440,7 @@ int biomeval_nbis_wsq_cropcoeff_mem(
    }
 
    /* Crop the wavelet coefficients back */
-   if((ret = biomeval_nbis_wsq_crop_qdata(&biomeval_nbis_dqt_table, biomeval_nbis_q_tree, biomeval_nbis_q_tree2, biomeval_nbis_q_tree3, qdata, ulx, uly, *ow, *oh, qdata2))) {
+   if((ret = biomeval_nbis_wsq_crop_qdata_r(dqt_table, w_tree, q_tree, q_tree2, q_tree3, qdata, ulx, uly, *ow, *oh, qdata2))) {
        free(qdata2);
        return(ret);
    }
@@ -299,9 +448,10 @@ int biomeval_nbis_wsq_cropcoeff_mem(
    if(biomeval_nbis_debug > 0)
      fprintf(stderr, "Cropped coefficients: UL (%d,%d)  %d x %d\n", ulx,uly,  *ow, *oh);
 
-   if((ret = biomeval_nbis_wsq_huffcode_mem(wsq_data, olen, 
+   if((ret = biomeval_nbis_wsq_huffcode_mem_r(dqt_table, w_tree, q_tree2,
+		    wsq_data, olen, 
 		    qdata2, *ow, *oh, 
-		    idata, ilen, *hgt_pos, *huff_pos))){
+		    idata, ilen, hgt_pos, huff_pos))){
        free(qdata2);
        return(ret);
    }
@@ -309,8 +459,6 @@ int biomeval_nbis_wsq_cropcoeff_mem(
    /* Done with cropped biomeval_nbis_quantized image buffer. */
    free(qdata2);
 
-   *odata = wsq_data;
-
    /* Return normally. */
    return(0);
 }
@@ -343,6 +491,32 @@ int biomeval_nbis_wsq_huffcode_mem(
      const int hgt_pos,       /* Position of Frame Header Height in idata */
      const int huff_pos       /* Position where Huff data begins in idata */
 )
+{
+   return(biomeval_nbis_wsq_huffcode_mem_r(&biomeval_nbis_dqt_table,
+                    biomeval_nbis_w_tree, biomeval_nbis_q_tree2, wsq_data, olen,
+                    qdata2, width, height, idata, wsq_alloc, hgt_pos,
+                    huff_pos));
+}
+
+/*************************************************************
+   Reentrant version of biomeval_nbis_wsq_huffcode_mem, passed
+   the quantization table of the original codestream and the
+   w_tree and q_tree2 built by biomeval_nbis_wsq_crop_qdata_r
+   instead of using the global tables.  qdata2 is not freed.
+***************************************************************/
+int biomeval_nbis_wsq_huffcode_mem_r(
+     const DQT_TABLE *dqt_table, /* Quantization table of idata */
+     W_TREE *w_tree,          /* Wavelet tree of cropped area */
+     Q_TREE *q_tree2,         /* Quantization tree of cropped area */
+     unsigned char *wsq_data, /* Output WSQ memory */
+     int *olen,               /* Output WSQ length */
+     short *qdata2,           /* Cropped coefficients to encode */
+     int width, int height,   /* Dimensions of cropped area */
+     unsigned char *idata,    /* Original WSQ codestream */
+     const int wsq_alloc,     /* Available length of wsq_data */
+     const int hgt_pos,       /* Position of Frame Header Height in idata */
+     const int huff_pos       /* Position where Huff data begins in idata */
+)
 {
    int ret, num_pix;
    int qsize1, qsize2, qsize3;   /* Quantized block sizes */
@@ -366,8 +540,8 @@ int biomeval_nbis_wsq_huffcode_mem(
       fprintf(stderr, "SOI, tables, and frame header written\n\n");
 
    /* Compute quantized WSQ subband block sizes */
-   biomeval_nbis_quant_block_sizes2(&qsize1, &qsize2, &qsize3, &biomeval_nbis_dqt_table,
-                           biomeval_nbis_w_tree, W_TREELEN, biomeval_nbis_q_tree2, Q_TREELEN);
+   biomeval_nbis_quant_block_sizes2(&qsize1, &qsize2, &qsize3, dqt_table,
+                           w_tree, W_TREELEN, q_tree2, Q_TREELEN);
 
    wsq_len = huff_pos;
 
@@ -380,7 +554,6 @@ int biomeval_nbis_wsq_huffcode_mem(
    /* this buffer size.                                                 */
    huff_buf = (unsigned char *)malloc(num_pix);
    if(huff_buf == (unsigned char *)NULL) {
-      free(qdata2);
       fprintf(stderr, "ERROR : wsq_huffcode_1 : malloc : huff_buf\n");
       return(-13);
    }
@@ -391,7 +564,6 @@ int biomeval_nbis_wsq_huffcode_mem(
    /* Compute Huffman table for Block 1. */
    if((ret = biomeval_nbis_gen_hufftable_wsq(&hufftable, &huffbits, &huffvalues,
                               qdata2, &qsize1, 1))){
-      free(qdata2);
       free(huff_buf);
       return(ret);
    }
@@ -399,7 +571,6 @@ int biomeval_nbis_wsq_huffcode_mem(
    /* Store Huffman table for Block 1 to WSQ buffer. */
    if((ret = biomeval_nbis_putc_huffman_table(DHT_WSQ, 0, huffbits, huffvalues,
                                wsq_data, wsq_alloc, &wsq_len))){
-      free(qdata2);
       free(huff_buf);
       free(huffbits);
       free(huffvalues);
@@ -415,7 +586,6 @@ int biomeval_nbis_wsq_huffcode_mem(
    /* Compress Block 1 data. */
    if((ret = biomeval_nbis_compress_block(huff_buf, &hsize1, qdata2, qsize1,
                            MAX_HUFFCOEFF, MAX_HUFFZRUN, hufftable))){
-      free(qdata2);
       free(huff_buf);
       free(hufftable);
       return(ret);
@@ -428,14 +598,12 @@ int biomeval_nbis_wsq_huffcode_mem(
 
    /* Store Block 1's header to WSQ buffer. */
    if((ret = biomeval_nbis_putc_block_header(0, wsq_data, wsq_alloc, &wsq_len))){
-      free(qdata2);
       free(huff_buf);
       return(ret);
    }
 
    /* Store Block 1's compressed data to WSQ buffer. */
    if((ret = biomeval_nbis_putc_bytes(huff_buf, hsize1, wsq_data, wsq_alloc, &wsq_len))){
-      free(qdata2);
       free(huff_buf);
       return(ret);
    }
@@ -451,7 +619,6 @@ int biomeval_nbis_wsq_huffcode_mem(
    block_sizes[1] = qsize3;
    if((ret = biomeval_nbis_gen_hufftable_wsq(&hufftable, &huffbits, &huffvalues,
                           qdata2+qsize1, block_sizes, 2))){
-      free(qdata2);
       free(huff_buf);
       return(ret);
    }
@@ -459,7 +626,6 @@ int biomeval_nbis_wsq_huffcode_mem(
    /* Store Huffman table for Blocks 2 & 3 to WSQ buffer. */
    if((ret = biomeval_nbis_putc_huffman_table(DHT_WSQ, 1, huffbits, huffvalues,
                                wsq_data, wsq_alloc, &wsq_len))){
-      free(qdata2);
       free(huff_buf);
       free(huffbits);
       free(huffvalues);
@@ -475,7 +641,6 @@ int biomeval_nbis_wsq_huffcode_mem(
    /* Compress Block 2 data. */
    if((ret = biomeval_nbis_compress_block(huff_buf, &hsize2, qdata2+qsize1, qsize2,
                            MAX_HUFFCOEFF, MAX_HUFFZRUN, hufftable))){
-      free(qdata2);
       free(huff_buf);
       free(hufftable);
       return(ret);
@@ -486,7 +651,6 @@ int biomeval_nbis_wsq_huffcode_mem(
 
    /* Store Block 2's header to WSQ buffer. */
    if((ret = biomeval_nbis_putc_block_header(1, wsq_data, wsq_alloc, &wsq_len))){
-      free(qdata2);
       free(huff_buf);
       free(hufftable);
       return(ret);
@@ -494,7 +658,6 @@ int biomeval_nbis_wsq_huffcode_mem(
 
    /* Store Block 2's compressed data to WSQ buffer. */
    if((ret = biomeval_nbis_putc_bytes(huff_buf, hsize2, wsq_data, wsq_alloc, &wsq_len))){
-      free(qdata2);
       free(huff_buf);
       free(hufftable);
       return(ret);
@@ -509,7 +672,6 @@ int biomeval_nbis_wsq_huffcode_mem(
    /* Compress Block 3 data. */
    if((ret = biomeval_nbis_compress_block(huff_buf, &hsize3, qdata2+qsize1+qsize2, qsize3,
                            MAX_HUFFCOEFF, MAX_HUFFZRUN, hufftable))){
-      free(qdata2);
       free(huff_buf);
       free(hufftable);
       return(ret);
@@ -582,6 +744,51 @@ int biomeval_nbis_wsq_dehuff_mem(
    unsigned char *idata, /* Input WSQ mem */
    const int ilen        /* Length of idata */
 )
+{
+   int ret;
+   WSQ_DECODER decoder;
+
+   /* Added by MDG on 02-24-05 */
+   biomeval_nbis_init_wsq_decoder_resources();
+
+   biomeval_nbis_init_wsq_decoder(&decoder);
+   if((ret = biomeval_nbis_wsq_dehuff_mem_r(&decoder, pqdata, iw, ih, scale,
+                    shift, hgt_pos, huff_pos, idata, ilen))){
+      biomeval_nbis_free_wsq_decoder(&decoder);
+      return(ret);
+   }
+
+   /* Retain the decode info for the routines using the global tables. */
+   biomeval_nbis_dtt_table = decoder.dtt_table;
+   biomeval_nbis_dqt_table = decoder.dqt_table;
+   memcpy(biomeval_nbis_dht_table, decoder.dht_table, sizeof(decoder.dht_table));
+   biomeval_nbis_frm_header_wsq = decoder.frm_header_wsq;
+   memcpy(biomeval_nbis_w_tree, decoder.w_tree, sizeof(decoder.w_tree));
+   memcpy(biomeval_nbis_q_tree, decoder.q_tree, sizeof(decoder.q_tree));
+
+   /* Return normally. */
+   return(0);
+}
+
+/*************************************************************
+   Reentrant version of biomeval_nbis_wsq_dehuff_mem.  The
+   decode info is retained in the decoder context, which must
+   have been initialized by biomeval_nbis_init_wsq_decoder(),
+   instead of the global tables.  The context is not released
+   here, even on error; call biomeval_nbis_free_wsq_decoder()
+   once its transform table is no longer required.
+***************************************************************/
+int biomeval_nbis_wsq_dehuff_mem_r(
+   WSQ_DECODER *decoder, /* Context retaining the decode info */
+   short **pqdata,    /* Returned pointer to biomeval_nbis_quantized coeff data */
+   int *iw, int *ih,  /* Dimensions of qdata / image */
+   double *scale,     /* r_scale from Frame header */
+   double *shift,     /* m_shift from Frame header */
+   int *hgt_pos,      /* Position of Frame Header Height in idata */
+   int *huff_pos,     /* Position where Huff data begins in idata */
+   unsigned char *idata, /* Input WSQ mem */
+   const int ilen        /* Length of idata */
+)
 {
    int ret, i, num_pix;
    unsigned short marker;         /* WSQ marker */
@@ -592,20 +799,17 @@ int biomeval_nbis_wsq_dehuff_mem(
    int ihsize;
    int found_dqt, found_dtt;
 
-   /* Added by MDG on 02-24-05 */
-   biomeval_nbis_init_wsq_decoder_resources();
-
    /* Set memory buffer pointers. */
    cbufptr = idata;
    ebufptr = idata + ilen;
 
    /* Init DHT Tables to 0. */
    for(i = 0; i < MAX_DHT_TABLES; i++)
-      (biomeval_nbis_dht_table + i)->tabdef = 0;
+      (decoder->dht_table + i)->tabdef = 0;
+   decoder->code = 0;
 
    /* Read the SOI marker. */
    if((ret = biomeval_nbis_getc_marker_wsq(&marker, SOI_WSQ, &cbufptr, ebufptr))){
-      biomeval_nbis_free_wsq_decoder_resources();
       return(ret);
    }
 
@@ -614,27 +818,23 @@ int biomeval_nbis_wsq_dehuff_mem(
    
    /* Read in supporting tables up to the SOF marker. */
    if((ret = biomeval_nbis_getc_marker_wsq(&marker, TBLS_N_SOF, &cbufptr, ebufptr))){
-      biomeval_nbis_free_wsq_decoder_resources();
       return(ret);
    }
    while(marker != SOF_WSQ) {
-      if((ret = biomeval_nbis_getc_table_wsq(marker, &biomeval_nbis_dtt_table, &biomeval_nbis_dqt_table, biomeval_nbis_dht_table,
+      if((ret = biomeval_nbis_getc_table_wsq(marker, &decoder->dtt_table, &decoder->dqt_table, decoder->dht_table,
 			      &cbufptr, ebufptr))){
-         biomeval_nbis_free_wsq_decoder_resources();
          return(ret);
       }
       if (marker == DQT_WSQ) found_dqt = 1;
       else if (marker == DTT_WSQ) found_dtt = 1;
 
       if((ret = biomeval_nbis_getc_marker_wsq(&marker, TBLS_N_SOF, &cbufptr, ebufptr))){
-         biomeval_nbis_free_wsq_decoder_resources();
          return(ret);
       }
    }
 
    /* Read in the Frame Header. */
-   if((ret = biomeval_nbis_getc_frame_header_wsq(&biomeval_nbis_frm_header_wsq, &cbufptr, ebufptr))){
-      biomeval_nbis_free_wsq_decoder_resources();
+   if((ret = biomeval_nbis_getc_frame_header_wsq(&decoder->frm_header_wsq, &cbufptr, ebufptr))){
       return(ret);
    }
 
@@ -642,10 +842,10 @@ int biomeval_nbis_wsq_dehuff_mem(
       since later functions may want to change the contents */
    *hgt_pos = cbufptr-idata - 13;
 
-   width = biomeval_nbis_frm_header_wsq.width;
-   height = biomeval_nbis_frm_header_wsq.height;
-   *scale = biomeval_nbis_frm_header_wsq.r_scale;
-   *shift = biomeval_nbis_frm_header_wsq.m_shift;
+   width = decoder->frm_header_wsq.width;
+   height = decoder->frm_header_wsq.height;
+   *scale = decoder->frm_header_wsq.r_scale;
+   *shift = decoder->frm_header_wsq.m_shift;
    *iw = width;
    *ih = height;
 
@@ -653,7 +853,7 @@ int biomeval_nbis_wsq_dehuff_mem(
       fprintf(stderr, "SOI, tables, and frame header read\n\n");
 
    /* Build WSQ decomposition trees. */
-   biomeval_nbis_build_wsq_trees(biomeval_nbis_w_tree, W_TREELEN, biomeval_nbis_q_tree, Q_TREELEN, width, height);
+   biomeval_nbis_build_wsq_trees(decoder->w_tree, W_TREELEN, decoder->q_tree, Q_TREELEN, width, height);
 
    if(biomeval_nbis_debug > 0)
       fprintf(stderr, "Tables for wavelet decomposition finished\n\n");
@@ -675,13 +875,11 @@ int biomeval_nbis_wsq_dehuff_mem(
    }
    else { /* Continue looking for transform or q-tables */
      if((ret = biomeval_nbis_getc_marker_wsq(&marker, TBLS_N_SOB, &cbufptr, ebufptr))){
-       biomeval_nbis_free_wsq_decoder_resources();
        return(ret);
      }
      while(marker != SOB_WSQ && marker != DHT_WSQ) {
-       if((ret = biomeval_nbis_getc_table_wsq(marker, &biomeval_nbis_dtt_table, &biomeval_nbis_dqt_table,
-				biomeval_nbis_dht_table, &cbufptr, ebufptr))){
-	 biomeval_nbis_free_wsq_decoder_resources();
+       if((ret = biomeval_nbis_getc_table_wsq(marker, &decoder->dtt_table, &decoder->dqt_table,
+				decoder->dht_table, &cbufptr, ebufptr))){
 	 return(ret);
        }       
        if (marker == DQT_WSQ) found_dqt = 1;
@@ -689,7 +887,6 @@ int biomeval_nbis_wsq_dehuff_mem(
        if (found_dqt && found_dtt) break;
        
        if((ret = biomeval_nbis_getc_marker_wsq(&marker, TBLS_N_SOB, &cbufptr, ebufptr))){
-	 biomeval_nbis_free_wsq_decoder_resources();
 	 return(ret);
        }
      }
@@ -702,6 +899,8 @@ int biomeval_nbis_wsq_dehuff_mem(
      }
      else {
        fprintf(stderr,"ERROR: Didn't find DTT and DQT before DHT\n");
+       /* Without them huff_pos is unknown, so the data can't be cropped. */
+       return(-97);
      }
    }
 
@@ -710,16 +909,14 @@ int biomeval_nbis_wsq_dehuff_mem(
    /* Allocate working memory. */
    qdata = (short *) malloc(num_pix * sizeof(short));
    if(qdata == (short *)NULL) {
-      biomeval_nbis_free_wsq_decoder_resources();
-      fprintf(stderr,"ERROR: biomeval_nbis_wsq_dehuff_mem : malloc : qdata1\n");
+      fprintf(stderr,"ERROR: biomeval_nbis_wsq_dehuff_mem_r : malloc : qdata1\n");
       return(-20);
    }
 
    /* Decode the Huffman encoded data blocks. */
-   if((ret = biomeval_nbis_huffman_decode_data_mem(qdata, &biomeval_nbis_dtt_table, &biomeval_nbis_dqt_table, biomeval_nbis_dht_table,
+   if((ret = biomeval_nbis_huffman_decode_data_mem_r(decoder, qdata,
 				     &cbufptr, ebufptr))){
       free(qdata);
-      biomeval_nbis_free_wsq_decoder_resources();
       return(ret);
    }
    /* Compute original huffman coded length */
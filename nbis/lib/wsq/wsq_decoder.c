@@ -58,11 +58,16 @@ of the software.
 #cat: biomeval_nbis_wsq_decode_mem - Decodes a datastream of WSQ compressed bytes
 #cat:                  from a memory buffer, returning a lossy
 #cat:                  reconstructed pixmap.
+#cat: biomeval_nbis_wsq_decode_mem_r - Reentrant version of biomeval_nbis_wsq_decode_mem
+#cat:                  that keeps all decoder state in a caller-supplied
+#cat:                  context.
 #cat: biomeval_nbis_wsq_decode_file - Decodes a datastream of WSQ compressed bytes
 #cat:                  from an open file, returning a lossy
 #cat:                  reconstructed pixmap.
 #cat: biomeval_nbis_huffman_decode_data_mem - Decodes a block of huffman encoded
 #cat:                  data from a memory buffer.
+#cat: biomeval_nbis_huffman_decode_data_mem_r - Reentrant version of
+#cat:                  biomeval_nbis_huffman_decode_data_mem.
 #cat: biomeval_nbis_huffman_decode_data_file - Decodes a block of huffman encoded
 #cat:                  data from an open file.
 #cat: biomeval_nbis_decode_data_mem - Decodes huffman encoded data from a memory buffer.
@@ -80,6 +85,20 @@ of the software.
 #include <wsq.h>
 #include <dataio.h>
 
+static int biomeval_nbis_huffman_decode_data_mem_state(short *, DTT_TABLE *,
+                 DQT_TABLE *, DHT_TABLE *, const FRM_HEADER_WSQ *, Q_TREE *,
+                 unsigned char *, unsigned char **, unsigned char *);
+static int biomeval_nbis_decode_data_mem_state(int *, int *, int *, int *,
+                 unsigned char *, unsigned char **, unsigned char *, int *,
+                 unsigned short *, unsigned char *);
+static int biomeval_nbis_getc_nextbits_wsq_state(unsigned short *,
+                 unsigned short *, unsigned char **, unsigned char *, int *,
+                 unsigned char *, const int);
+
+/* Partially consumed byte of entropy coded data, shared by the */
+/* non-reentrant memory buffer routines.                        */
+static unsigned char biomeval_nbis_code_wsq;
+
 /************************************************************************/
 /*              This is an implementation based on the Crinimal         */
 /*              Justice Information Services (CJIS) document            */
@@ -91,6 +110,29 @@ of the software.
 /***************************************************************************/
 int biomeval_nbis_wsq_decode_mem(unsigned char **odata, int *ow, int *oh, int *od, int *oppi,
                    int *lossyflag, unsigned char *idata, const int ilen)
+{
+   int ret;
+   WSQ_DECODER decoder;   /* tables and state of this decoding */
+
+   biomeval_nbis_init_wsq_decoder(&decoder);
+   ret = biomeval_nbis_wsq_decode_mem_r(&decoder, odata, ow, oh, od, oppi,
+                           lossyflag, idata, ilen);
+   biomeval_nbis_free_wsq_decoder(&decoder);
+
+   return(ret);
+}
+
+/***************************************************************************/
+/* Reentrant WSQ Decoder routine.  Decodes a WSQ compressed memory buffer  */
+/* using the tables in the decoder context instead of the global tables,   */
+/* so that any number of images may be decoded concurrently, provided      */
+/* each thread uses its own context.  The context must be initialized by   */
+/* biomeval_nbis_init_wsq_decoder() and may be reused for multiple images  */
+/* before being released by biomeval_nbis_free_wsq_decoder().              */
+/***************************************************************************/
+int biomeval_nbis_wsq_decode_mem_r(WSQ_DECODER *decoder, unsigned char **odata,
+                   int *ow, int *oh, int *od, int *oppi, int *lossyflag,
+                   unsigned char *idata, const int ilen)
 {
    int ret, i;
    unsigned short marker;         /* WSQ marker */
@@ -102,59 +144,48 @@ int biomeval_nbis_wsq_decode_mem(unsigned char **odata, int *ow, int *oh, int *o
    unsigned char *cbufptr;        /* points to current byte in buffer */
    unsigned char *ebufptr;        /* points to end of buffer */
 
-   /* Added by MDG on 02-24-05 */
-   biomeval_nbis_init_wsq_decoder_resources();
-
    /* Set memory buffer pointers. */
    cbufptr = idata;
    ebufptr = idata + ilen;
 
    /* Init DHT Tables to 0. */
    for(i = 0; i < MAX_DHT_TABLES; i++)
-      (biomeval_nbis_dht_table + i)->tabdef = 0;
+      (decoder->dht_table + i)->tabdef = 0;
+   decoder->code = 0;
 
    /* Read the SOI marker. */
-   if((ret = biomeval_nbis_getc_marker_wsq(&marker, SOI_WSQ, &cbufptr, ebufptr))){
-      biomeval_nbis_free_wsq_decoder_resources();
+   if((ret = biomeval_nbis_getc_marker_wsq(&marker, SOI_WSQ, &cbufptr, ebufptr)))
       return(ret);
-   }
 
    /* Read in supporting tables up to the SOF marker. */
-   if((ret = biomeval_nbis_getc_marker_wsq(&marker, TBLS_N_SOF, &cbufptr, ebufptr))){
-      biomeval_nbis_free_wsq_decoder_resources();
+   if((ret = biomeval_nbis_getc_marker_wsq(&marker, TBLS_N_SOF, &cbufptr, ebufptr)))
       return(ret);
-   }
    while(marker != SOF_WSQ) {
-      if((ret = biomeval_nbis_getc_table_wsq(marker, &biomeval_nbis_dtt_table, &biomeval_nbis_dqt_table, biomeval_nbis_dht_table,
-                          &cbufptr, ebufptr))){
-         biomeval_nbis_free_wsq_decoder_resources();
+      if((ret = biomeval_nbis_getc_table_wsq(marker, &decoder->dtt_table,
+                          &decoder->dqt_table, decoder->dht_table,
+                          &cbufptr, ebufptr)))
          return(ret);
-      }
-      if((ret = biomeval_nbis_getc_marker_wsq(&marker, TBLS_N_SOF, &cbufptr, ebufptr))){
-         biomeval_nbis_free_wsq_decoder_resources();
+      if((ret = biomeval_nbis_getc_marker_wsq(&marker, TBLS_N_SOF, &cbufptr, ebufptr)))
          return(ret);
-      }
    }
 
    /* Read in the Frame Header. */
-   if((ret = biomeval_nbis_getc_frame_header_wsq(&biomeval_nbis_frm_header_wsq, &cbufptr, ebufptr))){
-      biomeval_nbis_free_wsq_decoder_resources();
+   if((ret = biomeval_nbis_getc_frame_header_wsq(&decoder->frm_header_wsq,
+                                    &cbufptr, ebufptr)))
       return(ret);
-   }
-   width = biomeval_nbis_frm_header_wsq.width;
-   height = biomeval_nbis_frm_header_wsq.height;
+   width = decoder->frm_header_wsq.width;
+   height = decoder->frm_header_wsq.height;
    num_pix = width * height;
 
-   if((ret = biomeval_nbis_getc_ppi_wsq(&ppi, idata, ilen))){
-      biomeval_nbis_free_wsq_decoder_resources();
+   if((ret = biomeval_nbis_getc_ppi_wsq(&ppi, idata, ilen)))
       return(ret);
-   }
 
    if(biomeval_nbis_debug > 0)
       fprintf(stderr, "SOI, tables, and frame header read\n\n");
 
    /* Build WSQ decomposition trees. */
-   biomeval_nbis_build_wsq_trees(biomeval_nbis_w_tree, W_TREELEN, biomeval_nbis_q_tree, Q_TREELEN, width, height);
+   biomeval_nbis_build_wsq_trees(decoder->w_tree, W_TREELEN, decoder->q_tree,
+                    Q_TREELEN, width, height);
 
    if(biomeval_nbis_debug > 0)
       fprintf(stderr, "Tables for wavelet decomposition finished\n\n");
@@ -162,15 +193,13 @@ int biomeval_nbis_wsq_decode_mem(unsigned char **odata, int *ow, int *oh, int *o
    /* Allocate working memory. */
    qdata = (short *) malloc(num_pix * sizeof(short));
    if(qdata == (short *)NULL) {
-      fprintf(stderr,"ERROR: biomeval_nbis_wsq_decode_mem : malloc : qdata1\n");
-      biomeval_nbis_free_wsq_decoder_resources();
+      fprintf(stderr,"ERROR: biomeval_nbis_wsq_decode_mem_r : malloc : qdata1\n");
       return(-20);
    }
    /* Decode the Huffman encoded data blocks. */
-   if((ret = biomeval_nbis_huffman_decode_data_mem(qdata, &biomeval_nbis_dtt_table, &biomeval_nbis_dqt_table, biomeval_nbis_dht_table,
+   if((ret = biomeval_nbis_huffman_decode_data_mem_r(decoder, qdata,
                                     &cbufptr, ebufptr))){
       free(qdata);
-      biomeval_nbis_free_wsq_decoder_resources();
       return(ret);
    }
 
@@ -179,10 +208,9 @@ int biomeval_nbis_wsq_decode_mem(unsigned char **odata, int *ow, int *oh, int *o
          "Quantized WSQ subband data blocks read and Huffman decoded\n\n");
 
    /* Decode the quantize wavelet subband data. */
-   if((ret = biomeval_nbis_unquantize(&fdata, &biomeval_nbis_dqt_table, biomeval_nbis_q_tree, Q_TREELEN,
-                         qdata, width, height))){
+   if((ret = biomeval_nbis_unquantize(&fdata, &decoder->dqt_table,
+                         decoder->q_tree, Q_TREELEN, qdata, width, height))){
       free(qdata);
-      biomeval_nbis_free_wsq_decoder_resources();
       return(ret);
    }
 
@@ -192,10 +220,10 @@ int biomeval_nbis_wsq_decode_mem(unsigned char **odata, int *ow, int *oh, int *o
    /* Done with quantized wavelet subband data. */
    free(qdata);
 
-   if((ret = biomeval_nbis_wsq_reconstruct(fdata, width, height, biomeval_nbis_w_tree, W_TREELEN,
-                              &biomeval_nbis_dtt_table))){
+   if((ret = biomeval_nbis_wsq_reconstruct(fdata, width, height,
+                              decoder->w_tree, W_TREELEN,
+                              &decoder->dtt_table))){
       free(fdata);
-      biomeval_nbis_free_wsq_decoder_resources();
       return(ret);
    }
 
@@ -205,21 +233,18 @@ int biomeval_nbis_wsq_decode_mem(unsigned char **odata, int *ow, int *oh, int *o
    cdata = (unsigned char *)malloc(num_pix * sizeof(unsigned char));
    if(cdata == (unsigned char *)NULL) {
       free(fdata);
-      biomeval_nbis_free_wsq_decoder_resources();
-      fprintf(stderr,"ERROR: biomeval_nbis_wsq_decode_mem : malloc : cdata\n");
+      fprintf(stderr,"ERROR: biomeval_nbis_wsq_decode_mem_r : malloc : cdata\n");
       return(-21);
    }
 
    /* Convert floating point pixels to unsigned char pixels. */
    biomeval_nbis_conv_img_2_uchar(cdata, fdata, width, height,
-                      biomeval_nbis_frm_header_wsq.m_shift, biomeval_nbis_frm_header_wsq.r_scale);
+                      decoder->frm_header_wsq.m_shift,
+                      decoder->frm_header_wsq.r_scale);
 
    /* Done with floating point pixels. */
    free(fdata);
 
-   /* Added by MDG on 02-24-05 */
-   biomeval_nbis_free_wsq_decoder_resources();
-
    if(biomeval_nbis_debug > 0)
       fprintf(stderr, "Doubleing point pixels converted to unsigned char\n\n");
 
@@ -378,6 +403,8 @@ int biomeval_nbis_wsq_decode_file(unsigned char **odata, int *ow, int *oh, int *
 
 /***************************************************************************/
 /* Routine to decode an entire "block" of encoded data from memory buffer. */
+/* The image dimensions and quantization tree are taken from the global    */
+/* frame header and tree.                                                  */
 /***************************************************************************/
 int biomeval_nbis_huffman_decode_data_mem(
    short *ip,               /* image pointer */
@@ -386,6 +413,38 @@ int biomeval_nbis_huffman_decode_data_mem(
    DHT_TABLE *dht_table,    /* huffman table */
    unsigned char **cbufptr, /* points to current byte in input buffer */
    unsigned char *ebufptr)  /* points to end of input buffer */
+{
+   return(biomeval_nbis_huffman_decode_data_mem_state(ip, dtt_table, dqt_table,
+             dht_table, &biomeval_nbis_frm_header_wsq, biomeval_nbis_q_tree,
+             &biomeval_nbis_code_wsq, cbufptr, ebufptr));
+}
+
+/***************************************************************************/
+/* Reentrant routine to decode an entire "block" of encoded data from a    */
+/* memory buffer, using the tables and state of a decoder context.         */
+/***************************************************************************/
+int biomeval_nbis_huffman_decode_data_mem_r(
+   WSQ_DECODER *decoder,    /* decoder tables and state */
+   short *ip,               /* image pointer */
+   unsigned char **cbufptr, /* points to current byte in input buffer */
+   unsigned char *ebufptr)  /* points to end of input buffer */
+{
+   return(biomeval_nbis_huffman_decode_data_mem_state(ip, &decoder->dtt_table,
+             &decoder->dqt_table, decoder->dht_table,
+             &decoder->frm_header_wsq, decoder->q_tree, &decoder->code,
+             cbufptr, ebufptr));
+}
+
+static int biomeval_nbis_huffman_decode_data_mem_state(
+   short *ip,               /* image pointer */
+   DTT_TABLE *dtt_table,    /*transform table pointer */
+   DQT_TABLE *dqt_table,    /* quantization table */
+   DHT_TABLE *dht_table,    /* huffman table */
+   const FRM_HEADER_WSQ *frm_header_wsq, /* frame header */
+   Q_TREE *q_tree,          /* quantization tree */
+   unsigned char *code,     /* partially consumed byte of encoded data */
+   unsigned char **cbufptr, /* points to current byte in input buffer */
+   unsigned char *ebufptr)  /* points to end of input buffer */
 {
    int ret;
    int blk = 0;           /* block number */
@@ -409,7 +468,7 @@ int biomeval_nbis_huffman_decode_data_mem(
    bit_count = 0;
    ipc = 0;
    ipc_q = 0;
-   ipc_mx = biomeval_nbis_frm_header_wsq.width * biomeval_nbis_frm_header_wsq.height;
+   ipc_mx = frm_header_wsq->width * frm_header_wsq->height;
 
    while(marker != EOI_WSQ) {
 
@@ -425,7 +484,7 @@ int biomeval_nbis_huffman_decode_data_mem(
          if(dqt_table->dqt_def && !ipc_q) {
             for(n = 0; n < 64; n++)
                if(dqt_table->q_bin[n] == 0.0)
-                  ipc_mx -= biomeval_nbis_q_tree[n].lenx*biomeval_nbis_q_tree[n].leny;
+                  ipc_mx -= q_tree[n].lenx*q_tree[n].leny;
 
             ipc_q = 1;
          }
@@ -459,9 +518,9 @@ int biomeval_nbis_huffman_decode_data_mem(
       }
 
       /* get next huffman category code from compressed input data stream */
-      if((ret = biomeval_nbis_decode_data_mem(&nodeptr, mincode, maxcode, valptr,
-                            (dht_table+hufftable_id)->huffvalues,
-                            cbufptr, ebufptr, &bit_count, &marker)))
+      if((ret = biomeval_nbis_decode_data_mem_state(&nodeptr, mincode, maxcode,
+                            valptr, (dht_table+hufftable_id)->huffvalues,
+                            cbufptr, ebufptr, &bit_count, &marker, code)))
          return(ret);
 
       if(nodeptr == -1) {
@@ -500,36 +559,36 @@ int biomeval_nbis_huffman_decode_data_mem(
          ipc++;
       }
       else if(nodeptr == 101){
-         if((ret = biomeval_nbis_getc_nextbits_wsq(&tbits, &marker, cbufptr, ebufptr,
-                                &bit_count, 8)))
+         if((ret = biomeval_nbis_getc_nextbits_wsq_state(&tbits, &marker, cbufptr,
+                                ebufptr, &bit_count, code, 8)))
             return(ret);
          *ip++ = tbits;
          ipc++;
       }
       else if(nodeptr == 102){
-         if((ret = biomeval_nbis_getc_nextbits_wsq(&tbits, &marker, cbufptr, ebufptr,
-                                &bit_count, 8)))
+         if((ret = biomeval_nbis_getc_nextbits_wsq_state(&tbits, &marker, cbufptr,
+                                ebufptr, &bit_count, code, 8)))
             return(ret);
          *ip++ = -tbits;
          ipc++;
       }
       else if(nodeptr == 103){
-         if((ret = biomeval_nbis_getc_nextbits_wsq(&tbits, &marker, cbufptr, ebufptr,
-                                &bit_count, 16)))
+         if((ret = biomeval_nbis_getc_nextbits_wsq_state(&tbits, &marker, cbufptr,
+                                ebufptr, &bit_count, code, 16)))
             return(ret);
          *ip++ = tbits;
          ipc++;
       }
       else if(nodeptr == 104){
-         if((ret = biomeval_nbis_getc_nextbits_wsq(&tbits, &marker, cbufptr, ebufptr,
-                                &bit_count, 16)))
+         if((ret = biomeval_nbis_getc_nextbits_wsq_state(&tbits, &marker, cbufptr,
+                                ebufptr, &bit_count, code, 16)))
             return(ret);
          *ip++ = -tbits;
          ipc++;
       }
       else if(nodeptr == 105) {
-         if((ret = biomeval_nbis_getc_nextbits_wsq(&tbits, &marker, cbufptr, ebufptr,
-                                &bit_count, 8)))
+         if((ret = biomeval_nbis_getc_nextbits_wsq_state(&tbits, &marker, cbufptr,
+                                ebufptr, &bit_count, code, 8)))
             return(ret);
          ipc += tbits;
          if(ipc > ipc_mx) {
@@ -544,8 +603,8 @@ int biomeval_nbis_huffman_decode_data_mem(
             *ip++ = 0;
       }
       else if(nodeptr == 106) {
-         if((ret = biomeval_nbis_getc_nextbits_wsq(&tbits, &marker, cbufptr, ebufptr,
-                                &bit_count, 16)))
+         if((ret = biomeval_nbis_getc_nextbits_wsq_state(&tbits, &marker, cbufptr,
+                                ebufptr, &bit_count, code, 16)))
             return(ret);
          ipc += tbits;
          if(ipc > ipc_mx) {
@@ -723,13 +782,35 @@ int biomeval_nbis_decode_data_mem(
    unsigned char *ebufptr,      /* points to end of input buffer          */
    int *bit_count,      /* marks the bit to receive from the input byte */
    unsigned short *marker)
+{
+   return(biomeval_nbis_decode_data_mem_state(onodeptr, mincode, maxcode, valptr,
+             huffvalues, cbufptr, ebufptr, bit_count, marker,
+             &biomeval_nbis_code_wsq));
+}
+
+static int biomeval_nbis_decode_data_mem_state(
+   int *onodeptr,       /* returned huffman code category        */
+   int *mincode,        /* points to minimum code value for      */
+                        /*    a given code length                */
+   int *maxcode,        /* points to maximum code value for      */
+                        /*    a given code length                */
+   int *valptr,         /* points to first code in the huffman   */
+                        /*    code table for a given code length */
+   unsigned char *huffvalues,   /* defines order of huffman code          */
+                                /*    lengths in relation to code sizes   */
+   unsigned char **cbufptr,     /* points to current byte in input buffer */
+   unsigned char *ebufptr,      /* points to end of input buffer          */
+   int *bit_count,      /* marks the bit to receive from the input byte */
+   unsigned short *marker,
+   unsigned char *bitcode)      /* partially consumed byte of input */
 {
    int ret;
    int inx, inx2;       /*increment variables*/
    unsigned short code, tbits;  /* becomes a huffman code word
                                    (one bit at a time)*/
 
-   if((ret = biomeval_nbis_getc_nextbits_wsq(&code, marker, cbufptr, ebufptr, bit_count, 1)))
+   if((ret = biomeval_nbis_getc_nextbits_wsq_state(&code, marker, cbufptr, ebufptr,
+                                 bit_count, bitcode, 1)))
       return(ret);
 
    if(*marker != 0){
@@ -738,7 +819,8 @@ int biomeval_nbis_decode_data_mem(
    }
 
    for(inx = 1; (int)code > maxcode[inx]; inx++) {
-      if((ret = biomeval_nbis_getc_nextbits_wsq(&tbits, marker, cbufptr, ebufptr, bit_count, 1)))
+      if((ret = biomeval_nbis_getc_nextbits_wsq_state(&tbits, marker, cbufptr,
+                                    ebufptr, bit_count, bitcode, 1)))
          return(ret);
 
       code = (code << 1) + tbits;
@@ -866,28 +948,40 @@ int biomeval_nbis_getc_nextbits_wsq(
    unsigned char *ebufptr,      /* points to end of input buffer */
    int *bit_count,      /* marks the bit to receive from the input byte */
    const int bits_req)  /* number of bits requested */
+{
+   return(biomeval_nbis_getc_nextbits_wsq_state(obits, marker, cbufptr, ebufptr,
+             bit_count, &biomeval_nbis_code_wsq, bits_req));
+}
+
+static int biomeval_nbis_getc_nextbits_wsq_state(
+   unsigned short *obits,       /* returned bits */
+   unsigned short *marker,      /* returned marker */
+   unsigned char **cbufptr,     /* points to current byte in input buffer */
+   unsigned char *ebufptr,      /* points to end of input buffer */
+   int *bit_count,      /* marks the bit to receive from the input byte */
+   unsigned char *code, /* partially consumed byte of input */
+   const int bits_req)  /* number of bits requested */
 {
    int ret;
-   static unsigned char code;   /*next byte of data*/
-   static unsigned char code2;  /*stuffed byte of data*/
+   unsigned char code2;         /*stuffed byte of data*/
    unsigned short bits, tbits;  /*bits of current data byte requested*/
    int bits_needed;     /*additional bits required to finish request*/
 
                               /*used to "mask out" n number of
                                 bits from data stream*/
-   static unsigned char bit_mask[9] = {0x00,0x01,0x03,0x07,0x0f,
-                                       0x1f,0x3f,0x7f,0xff};
+   static const unsigned char bit_mask[9] = {0x00,0x01,0x03,0x07,0x0f,
+                                             0x1f,0x3f,0x7f,0xff};
    if(*bit_count == 0) {
-      if((ret = biomeval_nbis_getc_byte(&code, cbufptr, ebufptr))){
+      if((ret = biomeval_nbis_getc_byte(code, cbufptr, ebufptr))){
          return(ret);
       }
       *bit_count = 8;
-      if(code == 0xFF) {
+      if(*code == 0xFF) {
          if((ret = biomeval_nbis_getc_byte(&code2, cbufptr, ebufptr))){
             return(ret);
          }
          if(code2 != 0x00 && bits_req == 1) {
-            *marker = (code << 8) | code2;
+            *marker = (*code << 8) | code2;
             *obits = 1;
             return(0);
          }
@@ -898,16 +992,16 @@ int biomeval_nbis_getc_nextbits_wsq(
       }
    }
    if(bits_req <= *bit_count) {
-      bits = (code >>(*bit_count - bits_req)) & (bit_mask[bits_req]);
+      bits = (*code >>(*bit_count - bits_req)) & (bit_mask[bits_req]);
       *bit_count -= bits_req;
-      code &= bit_mask[*bit_count];
+      *code &= bit_mask[*bit_count];
    }
    else {
       bits_needed = bits_req - *bit_count;
-      bits = code << bits_needed;
+      bits = *code << bits_needed;
       *bit_count = 0;
-      if((ret = biomeval_nbis_getc_nextbits_wsq(&tbits, (unsigned short *)NULL, cbufptr,
-                             ebufptr, bit_count, bits_needed)))
+      if((ret = biomeval_nbis_getc_nextbits_wsq_state(&tbits, (unsigned short *)NULL,
+                             cbufptr, ebufptr, bit_count, code, bits_needed)))
          return(ret);
       bits |= tbits;
    }
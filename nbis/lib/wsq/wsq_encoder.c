@@ -58,6 +58,8 @@ of the software.
       ROUTINES:
 #cat: biomeval_nbis_wsq_encode_mem - WSQ encodes image data storing the compressed
 #cat:                   bytes to a memory buffer.
+#cat: biomeval_nbis_wsq_encode_mem_r - Reentrant version of biomeval_nbis_wsq_encode_mem
+#cat:                   that keeps all encoder state in a caller-supplied context.
 #cat: biomeval_nbis_gen_hufftable_wsq - Generates a huffman table for a quantized
 #cat:                   data block.
 #cat: biomeval_nbis_compress_block - Codes a quantized image using huffman tables.
@@ -68,6 +70,7 @@ of the software.
 ***********************************************************************/
 
 #include <stdio.h>
+#include <string.h>
 #include <wsq.h>
 #include <dataio.h>
 
@@ -82,6 +85,22 @@ of the software.
 int biomeval_nbis_wsq_encode_mem(unsigned char **odata, int *olen, const float r_bitrate,
                    unsigned char *idata, const int w, const int h,
                    const int d, const int ppi, char *comment_text)
+{
+   WSQ_ENCODER encoder;   /* tables of this encoding */
+
+   return(biomeval_nbis_wsq_encode_mem_r(&encoder, odata, olen, r_bitrate, idata,
+                            w, h, d, ppi, comment_text));
+}
+
+/***************************************************************************/
+/* Reentrant WSQ Encoder routine.  Encodes using the tables in the encoder */
+/* context instead of the global tables, so that any number of images    */
+/* may be encoded concurrently, provided each thread uses its own context. */
+/***************************************************************************/
+int biomeval_nbis_wsq_encode_mem_r(WSQ_ENCODER *encoder, unsigned char **odata,
+                   int *olen, const float r_bitrate, unsigned char *idata,
+                   const int w, const int h, const int d, const int ppi,
+                   char *comment_text)
 {
    int ret, num_pix;
    float *fdata;                 /* floating point pixel image  */
@@ -96,6 +115,8 @@ int biomeval_nbis_wsq_encode_mem(unsigned char **odata, int *olen, const float r
    int wsq_alloc, wsq_len;       /* number of bytes in buffer   */
    int block_sizes[2];
 
+   memset(encoder, 0, sizeof(WSQ_ENCODER));
+
    /* Compute the total number of pixels in image. */
    num_pix = w * h;
 
@@ -115,13 +136,13 @@ int biomeval_nbis_wsq_encode_mem(unsigned char **odata, int *olen, const float r
       fprintf(stderr, "Input image pixels converted to floating point\n\n");
 
    /* Build WSQ decomposition trees */
-   biomeval_nbis_build_wsq_trees(biomeval_nbis_w_tree, W_TREELEN, biomeval_nbis_q_tree, Q_TREELEN, w, h);
+   biomeval_nbis_build_wsq_trees(encoder->w_tree, W_TREELEN, encoder->q_tree, Q_TREELEN, w, h);
 
    if(biomeval_nbis_debug > 0)
       fprintf(stderr, "Tables for wavelet decomposition finished\n\n");
 
    /* WSQ decompose the image */
-   if((ret = biomeval_nbis_wsq_decompose(fdata, w, h, biomeval_nbis_w_tree, W_TREELEN,
+   if((ret = biomeval_nbis_wsq_decompose(fdata, w, h, encoder->w_tree, W_TREELEN,
                             biomeval_nbis_hifilt, MAX_HIFILT, biomeval_nbis_lofilt, MAX_LOFILT))){
       free(fdata);
       return(ret);
@@ -131,18 +152,18 @@ int biomeval_nbis_wsq_encode_mem(unsigned char **odata, int *olen, const float r
       fprintf(stderr, "WSQ decomposition of image finished\n\n");
 
    /* Set compression ratio and 'q' to zero. */
-   biomeval_nbis_quant_vals.cr = 0;
-   biomeval_nbis_quant_vals.q = 0.0;
+   encoder->quant_vals.cr = 0;
+   encoder->quant_vals.q = 0.0;
    /* Assign specified r-bitrate into quantization structure. */
-   biomeval_nbis_quant_vals.r = r_bitrate;
+   encoder->quant_vals.r = r_bitrate;
    /* Compute subband variances. */
-   biomeval_nbis_variance(&biomeval_nbis_quant_vals, biomeval_nbis_q_tree, Q_TREELEN, fdata, w, h);
+   biomeval_nbis_variance(&encoder->quant_vals, encoder->q_tree, Q_TREELEN, fdata, w, h);
 
    if(biomeval_nbis_debug > 0)
       fprintf(stderr, "Subband variances computed\n\n");
 
    /* Quantize the floating point pixmap. */
-   if((ret = biomeval_nbis_quantize(&qdata, &qsize, &biomeval_nbis_quant_vals, biomeval_nbis_q_tree, Q_TREELEN,
+   if((ret = biomeval_nbis_quantize(&qdata, &qsize, &encoder->quant_vals, encoder->q_tree, Q_TREELEN,
                       fdata, w, h))){
       free(fdata);
       return(ret);
@@ -155,8 +176,8 @@ int biomeval_nbis_wsq_encode_mem(unsigned char **odata, int *olen, const float r
       fprintf(stderr, "WSQ subband decomposition data quantized\n\n");
 
    /* Compute quantized WSQ subband block sizes */
-   biomeval_nbis_quant_block_sizes(&qsize1, &qsize2, &qsize3, &biomeval_nbis_quant_vals,
-                           biomeval_nbis_w_tree, W_TREELEN, biomeval_nbis_q_tree, Q_TREELEN);
+   biomeval_nbis_quant_block_sizes(&qsize1, &qsize2, &qsize3, &encoder->quant_vals,
+                           encoder->w_tree, W_TREELEN, encoder->q_tree, Q_TREELEN);
 
    if(qsize != qsize1+qsize2+qsize3){
       fprintf(stderr,
@@ -202,7 +223,7 @@ int biomeval_nbis_wsq_encode_mem(unsigned char **odata, int *olen, const float r
    }
 
    /* Store the quantization parameters to the WSQ buffer. */
-   if((ret = biomeval_nbis_putc_quantization_table(&biomeval_nbis_quant_vals,
+   if((ret = biomeval_nbis_putc_quantization_table(&encoder->quant_vals,
                                     wsq_data, wsq_alloc, &wsq_len))){
       free(qdata);
       free(wsq_data);
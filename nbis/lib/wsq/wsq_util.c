@@ -86,6 +86,10 @@ of the software.
 #cat:                      WSQ decoder
 #cat: biomeval_nbis_free_wsq_decoder_resources - Deallocates memory resources used by the
 #cat:                      WSQ decoder
+#cat: biomeval_nbis_init_wsq_decoder - Initializes a reentrant WSQ decoder context.
+#cat:
+#cat: biomeval_nbis_free_wsq_decoder - Deallocates memory resources used by a
+#cat:                      reentrant WSQ decoder context.
 
 ***********************************************************************/
 
@@ -1361,6 +1365,32 @@ void biomeval_nbis_free_wsq_decoder_resources()
    }
 }
 
+/*************************************************************/
+/* Initializes the state of a reentrant WSQ decoder.         */
+/*************************************************************/
+void biomeval_nbis_init_wsq_decoder(WSQ_DECODER *decoder)
+{
+   memset(decoder, 0, sizeof(WSQ_DECODER));
+   decoder->dtt_table.lofilt = (float *)NULL;
+   decoder->dtt_table.hifilt = (float *)NULL;
+}
+
+/*************************************************************/
+/* Deallocates memory used by a reentrant WSQ decoder.       */
+/*************************************************************/
+void biomeval_nbis_free_wsq_decoder(WSQ_DECODER *decoder)
+{
+   if(decoder->dtt_table.lofilt != (float *)NULL){
+      free(decoder->dtt_table.lofilt);
+      decoder->dtt_table.lofilt = (float *)NULL;
+   }
+
+   if(decoder->dtt_table.hifilt != (float *)NULL){
+      free(decoder->dtt_table.hifilt);
+      decoder->dtt_table.hifilt = (float *)NULL;
+   }
+}
+
 /************************************************************************
              
 #cat: biomeval_nbis_delete_comments_wsq - Deletes all comments in a WSQ compressed file.
@@ -11,6 +11,8 @@
 #ifndef __BE_DATA_INTERCHANGE_AN2K__
 #define __BE_DATA_INTERCHANGE_AN2K__
 
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -34,6 +36,15 @@ namespace BiometricEvaluation
 		 * An object of this class can be used to retrieve all
 		 * the general record information, finger views, and other
 		 * components of the ANSI/NIST record.
+		 *
+		 * Constructed with Construction::Lazy, only the Type-1
+		 * record is parsed and the other logical records are
+		 * indexed; views and minutiae records are constructed
+		 * when first requested, and then kept. Such an object
+		 * must not be used by more than one thread at a time.
+		 * Constructed with Construction::Eager, every view is
+		 * constructed by the constructor, and the object may
+		 * be read by any number of threads.
 		 */
 		class AN2KRecord {
 		public:
@@ -101,7 +112,31 @@ namespace BiometricEvaluation
 			};
 			/** Convenience alias for struct CharacterSet */
 			using CharacterSet = struct CharacterSet;
-			
+
+			/** When views and minutiae records are constructed */
+			enum class Construction
+			{
+				/** All of them, by the constructor */
+				Eager,
+				/** Each, when first requested */
+				Lazy
+			};
+
+			/** Location of a logical record in a transaction */
+			struct RecordIndexEntry
+			{
+				/** Type of the record */
+				View::AN2KView::RecordType type;
+				/**
+				 * Information designation character, from
+				 * the CNT field, or 0 for the Type-1 record
+				 */
+				uint32_t idc;
+				/** Offset of the record in the transaction */
+				uint64_t offset;
+				/** Length of the record, in bytes */
+				uint64_t length;
+			};
 			
 			/**
 			 * @brief
@@ -123,7 +158,17 @@ namespace BiometricEvaluation
 			 */
 			static std::set<int>
 			recordLocations(
-			    Memory::uint8Array &buf,
+			    const Memory::ByteSpan &buf,
+			    const View::AN2KView::RecordType recordType);
+
+			/**
+			 * @brief
+			 * As recordLocations(const Memory::ByteSpan&,
+			 * const View::AN2KView::RecordType).
+			 */
+			static std::set<int>
+			recordLocations(
+			    const Memory::uint8Array &buf,
 			    const View::AN2KView::RecordType recordType);
 			    
 			/**
@@ -144,6 +189,52 @@ namespace BiometricEvaluation
 			recordLocations(
 			    const ANSI_NIST *an2k,
 			    const View::AN2KView::RecordType recordType);
+
+			/**
+			 * @brief
+			 * Parse a complete AN2K record.
+			 * @details
+			 * The parse tree returned may be shared, read-only,
+			 * by every view and minutiae record constructed from
+			 * it, so that a transaction is parsed only once.
+			 *
+			 * @param[in] buf
+			 *	The memory buffer containing the complete
+			 *	ANSI/NIST record.
+			 *
+			 * @return
+			 *	Parse tree of buf, which does not refer to
+			 *	buf.
+			 *
+			 * @throw Error::DataError
+			 *	An error occurred when processing the AN2K
+			 *	record.
+			 */
+			static std::shared_ptr<const ANSI_NIST>
+			parse(
+			    const Memory::ByteSpan &buf);
+
+			/**
+			 * @brief
+			 * Map a file containing an AN2K record into memory.
+			 * @details
+			 * As IO::Utility::mapFile(), with the errors of
+			 * constructing from a file.
+			 *
+			 * @param[in] filename
+			 *	The name of the file containing the complete
+			 *	ANSI/NIST record.
+			 *
+			 * @return
+			 *	Contents of filename, for parse().
+			 *
+			 * @throw Error::FileError
+			 *	An error occurred when opening or reading
+			 *	the file.
+			 */
+			static Memory::ByteSpan
+			mapFile(
+			    const std::string &filename);
 			    
 			/**
 			 * @brief
@@ -151,6 +242,9 @@ namespace BiometricEvaluation
 			 * @param[in] filename
 			 *	The name of the file containing the complete
 			 *	ANSI/NIST record.
+			 * @param[in] construction
+			 *	When views and minutiae records are
+			 *	constructed.
 			 *
 			 * @throw Error::FileError
 			 *	An error occurred when opening or reading
@@ -160,21 +254,57 @@ namespace BiometricEvaluation
 			 *	record.
 			 */
 			AN2KRecord(
-			    const std::string filename);
+			    const std::string filename,
+			    const Construction construction =
+			    Construction::Eager);
 
 			/**
 			 * @brief
 			 * Constructor taking an AN2K record from a buffer.
 			 * @param[in] buf
 			 *	The memory buffer containing the complete
-			 *	ANSI/NIST record.
+			 *	ANSI/NIST record. With Construction::Lazy,
+			 *	a copy is kept unless buf owns its bytes.
+			 * @param[in] construction
+			 *	When views and minutiae records are
+			 *	constructed.
 			 *
 			 * @throw Error::DataError
 			 *	An error occurred when processing the AN2K
 			 *	record.
 			 */
 			AN2KRecord(
-			    Memory::uint8Array &buf);
+			    const Memory::ByteSpan &buf,
+			    const Construction construction =
+			    Construction::Eager);
+
+			/**
+			 * @brief
+			 * As the Memory::ByteSpan constructor. buf is
+			 * not retained.
+			 */
+			AN2KRecord(
+			    const Memory::uint8Array &buf,
+			    const Construction construction =
+			    Construction::Eager);
+
+			/**
+			 * @brief
+			 * Obtain the location of every logical record.
+			 * @details
+			 * With Construction::Lazy, the index is built from
+			 * the Type-1 record and the length of each record,
+			 * without parsing the records that follow the
+			 * Type-1 record. Otherwise, it is taken from the
+			 * parse of the whole transaction.
+			 *
+			 * @return
+			 *	One entry per logical record, in the order
+			 *	they appear, starting with the Type-1 record.
+			 */
+			std::vector<RecordIndexEntry>
+			getRecordIndex()
+			    const;
 
 			/**
 			 * @return
@@ -221,11 +351,42 @@ namespace BiometricEvaluation
 			/**
 			 * @brief
 			 * Obtain the count of latent (Type-13) finger views.
+			 * @details
+			 * With Construction::Lazy, this is the number of
+			 * Type-13 records indexed, some of which might
+			 * not form a valid view.
 			 * @return
 			 * The number of latents in the AN2K record.
 			 */
 			uint32_t getFingerLatentCount() const;
 
+			/**
+			 * @brief
+			 * Obtain one latent (Type-13) finger view.
+			 *
+			 * @param[in] index
+			 *	Index of the view, less than
+			 *	getFingerLatentCount().
+			 *
+			 * @return
+			 *	Element index of getFingerLatents().
+			 *
+			 * @throw Error::ParameterError
+			 *	index is out of range.
+			 * @throw Error::DataError
+			 *	The view could not be constructed.
+			 *
+			 * @warning
+			 * With Construction::Lazy, the first request for a
+			 * view constructs and keeps it, unsynchronized, so
+			 * this must not be called concurrently with other
+			 * getters of the same object.
+			 */
+			Latent::AN2KView
+			getFingerLatent(
+			    const uint32_t index)
+			    const;
+
 			/**
 			 * @brief
 			 * Obtain all latent (Type-13) finger views.
@@ -235,6 +396,12 @@ namespace BiometricEvaluation
 			 * @return
 			 * A vector of AN2KViewLatent objects, each
 			 * representing a single latent finger view.
+			 *
+			 * @warning
+			 * With Construction::Lazy, views not yet requested
+			 * are constructed and kept, unsynchronized, so this
+			 * must not be called concurrently with other getters
+			 * of the same object.
 			 */
 			std::vector<Latent::AN2KView>
 			    getFingerLatents() const;
@@ -242,11 +409,42 @@ namespace BiometricEvaluation
 			/**
 			 * @brief
 			 * Obtain the count of capture (Type-14) finger views.
+			 * @details
+			 * With Construction::Lazy, this is the number of
+			 * Type-14 records indexed, some of which might
+			 * not form a valid view.
 			 * @return
 			 * The number of captures in the AN2K record.
 			 */
 			uint32_t getFingerCaptureCount() const;
 
+			/**
+			 * @brief
+			 * Obtain one capture (Type-14) finger view.
+			 *
+			 * @param[in] index
+			 *	Index of the view, less than
+			 *	getFingerCaptureCount().
+			 *
+			 * @return
+			 *	Element index of getFingerCaptures().
+			 *
+			 * @throw Error::ParameterError
+			 *	index is out of range.
+			 * @throw Error::DataError
+			 *	The view could not be constructed.
+			 *
+			 * @warning
+			 * With Construction::Lazy, the first request for a
+			 * view constructs and keeps it, unsynchronized, so
+			 * this must not be called concurrently with other
+			 * getters of the same object.
+			 */
+			Finger::AN2KViewCapture
+			getFingerCapture(
+			    const uint32_t index)
+			    const;
+
 			/**
 			 * @brief
 			 * Obtain all capture (Type-14) finger views.
@@ -256,6 +454,12 @@ namespace BiometricEvaluation
 			 * @return
 			 * A vector of AN2KViewCapture objects, each
 			 * representing a single capture finger view.
+			 *
+			 * @warning
+			 * With Construction::Lazy, views not yet requested
+			 * are constructed and kept, unsynchronized, so this
+			 * must not be called concurrently with other getters
+			 * of the same object.
 			 */
 			std::vector<Finger::AN2KViewCapture>
 			    getFingerCaptures() const;
@@ -263,6 +467,10 @@ namespace BiometricEvaluation
 			/**
 			 * @brief
 			 * Obtain the count of capture (Type-15) palm views.
+			 * @details
+			 * With Construction::Lazy, this is the number of
+			 * Type-15 records indexed, some of which might
+			 * not form a valid view.
 			 *
 			 * @return
 			 * The number of palm captures in the AN2K record.
@@ -271,6 +479,33 @@ namespace BiometricEvaluation
 			getPalmCaptureCount()
 			    const;
 
+			/**
+			 * @brief
+			 * Obtain one capture (Type-15) palm view.
+			 *
+			 * @param[in] index
+			 *	Index of the view, less than
+			 *	getPalmCaptureCount().
+			 *
+			 * @return
+			 *	Element index of getPalmCaptures().
+			 *
+			 * @throw Error::ParameterError
+			 *	index is out of range.
+			 * @throw Error::DataError
+			 *	The view could not be constructed.
+			 *
+			 * @warning
+			 * With Construction::Lazy, the first request for a
+			 * view constructs and keeps it, unsynchronized, so
+			 * this must not be called concurrently with other
+			 * getters of the same object.
+			 */
+			Palm::AN2KView
+			getPalmCapture(
+			    const uint32_t index)
+			    const;
+
 			/**
 			 * @brief
 			 * Obtain all capture (Type-15) palm views.
@@ -281,6 +516,12 @@ namespace BiometricEvaluation
 			 * @return
 			 * A vector of AN2KView objects, each representing
 			 * a single capture palm view.
+			 *
+			 * @warning
+			 * With Construction::Lazy, views not yet requested
+			 * are constructed and kept, unsynchronized, so this
+			 * must not be called concurrently with other getters
+			 * of the same object.
 			 */
 			std::vector<Palm::AN2KView>
 			getPalmCaptures()
@@ -292,10 +533,58 @@ namespace BiometricEvaluation
 			 * @return
 			 * A vector of AN2KMinutiaeDataRecord objects,
 			 * each represeting a single Type-9 Record.
+			 *
+			 * @warning
+			 * With Construction::Lazy, records not yet requested
+			 * are constructed and kept, unsynchronized, so this
+			 * must not be called concurrently with other getters
+			 * of the same object.
 			 */
 			std::vector<Finger::AN2KMinutiaeDataRecord>
 			getMinutiaeDataRecordSet()
 			    const;
+
+			/**
+			 * @brief
+			 * Obtain the count of minutiae (Type-9) records.
+			 * @details
+			 * With Construction::Lazy, this is the number of
+			 * Type-9 records indexed, some of which might
+			 * not be valid.
+			 *
+			 * @return
+			 * The number of Type-9 records in the AN2K record.
+			 */
+			uint32_t
+			getMinutiaeDataRecordCount()
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain one minutiae (Type-9) record.
+			 *
+			 * @param[in] index
+			 *	Index of the record, less than
+			 *	getMinutiaeDataRecordCount().
+			 *
+			 * @return
+			 *	Element index of getMinutiaeDataRecordSet().
+			 *
+			 * @throw Error::ParameterError
+			 *	index is out of range.
+			 * @throw Error::DataError
+			 *	The record could not be constructed.
+			 *
+			 * @warning
+			 * With Construction::Lazy, the first request for a
+			 * record constructs and keeps it, unsynchronized, so
+			 * this must not be called concurrently with other
+			 * getters of the same object.
+			 */
+			Finger::AN2KMinutiaeDataRecord
+			getMinutiaeDataRecord(
+			    const uint32_t index)
+			    const;
 			    
 			/**
 			 * @brief
@@ -368,11 +657,28 @@ namespace BiometricEvaluation
 			/** Directory of character sets */
 			std::vector<CharacterSet> _dcs;
 			
-			std::vector<Latent::AN2KView> _fingerLatents;
-			std::vector<Finger::AN2KViewCapture> _fingerCaptures;
-			std::vector<Palm::AN2KView> _palmCaptures;
+			/** Whether views are constructed when requested */
+			bool _lazy{false};
+			/** Transaction, kept to construct views on demand */
+			Memory::ByteSpan _buf;
+			/** Logical records of the transaction */
+			std::vector<RecordIndexEntry> _index;
+			/** Parse tree of the transaction, once needed */
+			mutable std::shared_ptr<const ANSI_NIST> _an2k;
+
+			/*
+			 * Views and minutiae records constructed, keyed by
+			 * their index among those of their type.
+			 */
+			mutable std::map<uint32_t, Latent::AN2KView>
+			    _fingerLatents;
+			mutable std::map<uint32_t, Finger::AN2KViewCapture>
+			    _fingerCaptures;
+			mutable std::map<uint32_t, Palm::AN2KView>
+			    _palmCaptures;
 			/** Type-9 Records. */
-			std::vector<Finger::AN2KMinutiaeDataRecord> 
+			mutable std::map<uint32_t,
+			    Finger::AN2KMinutiaeDataRecord>
 			    _minutiaeDataRecordSet;
 			
 			/**
@@ -382,21 +688,57 @@ namespace BiometricEvaluation
 			 *
 			 * @param[in] buf
 			 *	AN2K buffer.
+			 * @param[in] construction
+			 *	When views and minutiae records are
+			 *	constructed.
 			 */
-			void readAN2KRecord(Memory::uint8Array &buf);
-			void readType1Record(Memory::uint8Array &buf);
-			    
+			void readAN2KRecord(
+			    const Memory::ByteSpan &buf,
+			    const Construction construction);
+			void readType1Record(const RECORD *rec);
+
 			/**
 			 * @brief
-			 * Populates _minutiaeDataRecordSet.
+			 * Populates _index and the Type-1 fields, parsing
+			 * only the Type-1 record.
 			 *
 			 * @param[in] buf
 			 *	AN2K buffer.
 			 */
-    			void readMinutiaeData(Memory::uint8Array &buf);
-			void readFingerCaptures(Memory::uint8Array &buf);
-			void readFingerLatents(Memory::uint8Array &buf);
-			void readPalmCaptures(Memory::uint8Array &buf);
+			void indexAN2KRecord(const Memory::ByteSpan &buf);
+
+			/**
+			 * @brief
+			 * Populates _index and the Type-1 fields from a
+			 * parse tree.
+			 *
+			 * @param[in] an2k
+			 *	Parse tree of the transaction.
+			 *
+			 * @throw Error::DataError
+			 *	The tree has no Type-1 record.
+			 */
+			void indexParseTree(const ANSI_NIST *an2k);
+
+			/**
+			 * @return
+			 *	Parse tree of the transaction, parsing _buf
+			 *	the first time it is needed.
+			 */
+			std::shared_ptr<const ANSI_NIST>
+			getParseTree()
+			    const;
+
+			/**
+			 * @return
+			 *	Positions in _index of the records of
+			 *	recordType, which are their positions in the
+			 *	parse tree.
+			 */
+			std::vector<int>
+			indexLocations(
+			    const View::AN2KView::RecordType recordType)
+			    const;
 		};
 	}
 }
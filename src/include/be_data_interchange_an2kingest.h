@@ -0,0 +1,172 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_DATA_INTERCHANGE_AN2KINGEST_H__
+#define __BE_DATA_INTERCHANGE_AN2KINGEST_H__
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <be_io_logsheet.h>
+#include <be_io_recordstore.h>
+
+namespace BiometricEvaluation
+{
+	namespace DataInterchange
+	{
+		/**
+		 * @brief
+		 * RecordStores receiving the records extracted by
+		 * ingestAN2K().
+		 * @details
+		 * Records of a kind are only extracted when there is a
+		 * RecordStore for them. Kinds may share a RecordStore.
+		 */
+		struct AN2KIngestStores
+		{
+			/** Image data of Type-14 records */
+			std::shared_ptr<IO::RecordStore> fingerCaptures{};
+			/** Image data of Type-13 records */
+			std::shared_ptr<IO::RecordStore> fingerLatents{};
+			/** Image data of Type-15 records */
+			std::shared_ptr<IO::RecordStore> palmCaptures{};
+			/** Type-9 records, as they are in the transaction */
+			std::shared_ptr<IO::RecordStore> minutiae{};
+		};
+
+		/** Parameters of ingestAN2K() */
+		struct AN2KIngestOptions
+		{
+			/**
+			 * Number of threads reading and parsing files. 0
+			 * uses one thread per CPU core.
+			 */
+			uint32_t threads{0};
+			/**
+			 * Whether records are inserted in the order of
+			 * the files. Otherwise, the records of each file
+			 * are inserted as soon as it is parsed.
+			 */
+			bool ordered{true};
+			/**
+			 * Most files parsed, or being parsed, whose
+			 * records are not yet inserted.
+			 */
+			uint32_t maxPending{64};
+			/**
+			 * Receives one entry for each file that could not
+			 * be ingested, or nullptr to not log.
+			 */
+			std::shared_ptr<IO::Logsheet> logsheet{};
+			/**
+			 * Extensions, such as ".eft", of the files
+			 * ingested from a directory, ignoring case. Empty
+			 * to ingest every file.
+			 */
+			std::vector<std::string> extensions{};
+		};
+
+		/** Outcome of ingestAN2K() */
+		struct AN2KIngestSummary
+		{
+			/** Number of files ingested, or that failed */
+			uint64_t files{0};
+			/** Number of files that failed */
+			uint64_t failures{0};
+			/** Number of records inserted */
+			uint64_t records{0};
+		};
+
+		/**
+		 * @brief
+		 * Ingest AN2K transactions into RecordStores.
+		 * @details
+		 * Files are memory-mapped and parsed, and the records
+		 * selected by stores extracted from them, on a pool of
+		 * threads, without copying the record data. Records are
+		 * inserted, and failures logged, on the calling thread.
+		 *
+		 * A record's key is the key of its file, then its record
+		 * type and its number among the records of that type in
+		 * the file, starting from 1, separated by underscores,
+		 * as in "subject_1.eft_14_1". The key of a file is its
+		 * path, with '%', characters that are invalid in a key,
+		 * and leading whitespace percent-encoded, as in
+		 * "images%2Fsubject_1.eft", so distinct paths have
+		 * distinct keys.
+		 *
+		 * A file fails when it cannot be read or parsed, or a
+		 * record cannot be inserted. Records of it inserted
+		 * before the failure are removed, and its failure is
+		 * logged.
+		 *
+		 * @param[in] paths
+		 *	Paths of the files to ingest.
+		 * @param[in] stores
+		 *	Destination of each kind of record extracted.
+		 *	The RecordStores must not be used by other
+		 *	threads during the call.
+		 * @param[in] options
+		 *	Parameters of the ingestion.
+		 *
+		 * @return
+		 *	Counts of the files and records ingested.
+		 *
+		 * @throw Error::ParameterError
+		 *	options.maxPending is 0.
+		 * @throw Error::StrategyError
+		 *	Error writing to the Logsheet. Remaining files
+		 *	are not ingested.
+		 */
+		AN2KIngestSummary
+		ingestAN2K(
+		    const std::vector<std::string> &paths,
+		    const AN2KIngestStores &stores,
+		    const AN2KIngestOptions &options = AN2KIngestOptions());
+
+		/**
+		 * @brief
+		 * Ingest the AN2K transactions in a directory tree into
+		 * RecordStores.
+		 * @details
+		 * As ingestAN2K() for paths, for the files beneath
+		 * directory whose extension is one of
+		 * options.extensions, in lexicographical order. The key
+		 * of a file is its path relative to directory.
+		 *
+		 * @param[in] directory
+		 *	Root of the directory tree.
+		 * @param[in] stores
+		 *	Destination of each kind of record extracted.
+		 * @param[in] options
+		 *	Parameters of the ingestion.
+		 *
+		 * @return
+		 *	Counts of the files and records ingested.
+		 *
+		 * @throw Error::ObjectDoesNotExist
+		 *	directory does not exist.
+		 * @throw Error::StrategyError
+		 *	Error reading the directory tree, or writing to
+		 *	the Logsheet.
+		 * @throw Error::ParameterError
+		 *	options.maxPending is 0.
+		 */
+		AN2KIngestSummary
+		ingestAN2KDirectory(
+		    const std::string &directory,
+		    const AN2KIngestStores &stores,
+		    const AN2KIngestOptions &options = AN2KIngestOptions());
+	}
+}
+
+#endif /* __BE_DATA_INTERCHANGE_AN2KINGEST_H__ */
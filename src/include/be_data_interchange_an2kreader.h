@@ -0,0 +1,188 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_DATA_INTERCHANGE_AN2KREADER_H__
+#define __BE_DATA_INTERCHANGE_AN2KREADER_H__
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <be_memory_bytespan.h>
+#include <be_view_an2kview.h>
+
+namespace BiometricEvaluation
+{
+	namespace DataInterchange
+	{
+		/**
+		 * @brief
+		 * Sequential access to the logical records of an
+		 * ANSI/NIST-ITL transaction.
+		 * @details
+		 * Only the Type-1 record is parsed. Each following
+		 * record is located from the length at its start when
+		 * it is sequenced, and returned as a span of the
+		 * transaction, so neither the transaction nor its
+		 * parse tree is materialized. Transactions read from
+		 * a file are memory-mapped, so even those larger than
+		 * memory can be processed, reading only the pages of
+		 * the records used.
+		 */
+		class AN2KReader
+		{
+		public:
+			/** A logical record of a transaction */
+			struct Record
+			{
+				/** Type of the record */
+				View::AN2KView::RecordType type;
+				/**
+				 * Information designation character, from
+				 * the CNT field, or 0 for the Type-1 record
+				 */
+				uint32_t idc;
+				/** Offset of the record in the transaction */
+				uint64_t offset;
+				/**
+				 * The bytes of the record, sharing ownership
+				 * of the transaction when it is owned.
+				 */
+				Memory::ByteSpan data;
+			};
+
+			/** Tell sequence() to sequence from the beginning */
+			static const int BE_AN2KREADER_SEQ_START = 1;
+			/** Tell sequence() to sequence from the current one */
+			static const int BE_AN2KREADER_SEQ_NEXT = 2;
+
+			/**
+			 * @brief
+			 * Constructor taking a transaction from a file.
+			 *
+			 * @param[in] pathname
+			 *	The name of the file containing the
+			 *	transaction, which is memory-mapped.
+			 *
+			 * @throw Error::FileError
+			 *	An error occurred when opening or mapping
+			 *	the file.
+			 * @throw Error::DataError
+			 *	An error occurred when processing the Type-1
+			 *	record.
+			 */
+			AN2KReader(
+			    const std::string &pathname);
+
+			/**
+			 * @brief
+			 * Constructor taking a transaction from a buffer.
+			 *
+			 * @param[in] buf
+			 *	The transaction. If it is not owned, it must
+			 *	remain valid for the life of this object and
+			 *	of the records sequenced.
+			 *
+			 * @throw Error::DataError
+			 *	An error occurred when processing the Type-1
+			 *	record.
+			 */
+			AN2KReader(
+			    const Memory::ByteSpan &buf);
+
+			/**
+			 * @return
+			 *	Number of logical records in the
+			 *	transaction, including the Type-1 record,
+			 *	as listed by the CNT field.
+			 */
+			uint32_t
+			getRecordCount()
+			    const;
+
+			/**
+			 * @return
+			 *	The whole transaction, sharing ownership of
+			 *	it when it is owned.
+			 */
+			Memory::ByteSpan
+			getData()
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain the parsed Type-1 record.
+			 *
+			 * @return
+			 *	The Type-1 record, valid for the life of
+			 *	this object.
+			 */
+			const RECORD *
+			getType1Record()
+			    const;
+
+			/**
+			 * @brief
+			 * Sequence through the logical records of the
+			 * transaction, starting with the Type-1 record.
+			 * @details
+			 * Sequencing starts from the Type-1 record when
+			 * the object is created, and is reset to it by
+			 * calling this method with cursor set to
+			 * BE_AN2KREADER_SEQ_START.
+			 *
+			 * @param[in] cursor
+			 *	The location within the sequence of the
+			 *	record to return.
+			 *
+			 * @return
+			 *	The record that is currently in sequence.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	End of sequencing.
+			 * @throw Error::ParameterError
+			 *	Invalid cursor.
+			 * @throw Error::DataError
+			 *	The record is truncated, or its type or
+			 *	length field is invalid.
+			 */
+			Record
+			sequence(
+			    int cursor = BE_AN2KREADER_SEQ_NEXT);
+
+		private:
+			/** The transaction */
+			Memory::ByteSpan _buf;
+			/** Parsed Type-1 record */
+			std::shared_ptr<RECORD> _type1;
+			/** Type and IDC of each record, from CNT */
+			std::vector<std::pair<unsigned int, uint32_t>>
+			    _contents;
+			/** Length of the Type-1 record */
+			uint64_t _type1Length{0};
+
+			/** Index in _contents of the next record */
+			uint32_t _next{0};
+			/** Offset of the next record */
+			uint64_t _offset{0};
+
+			/**
+			 * @brief
+			 * Parse the Type-1 record of _buf and read the
+			 * contents of the transaction from its CNT field.
+			 */
+			void readType1Record();
+		};
+	}
+}
+
+#endif /* __BE_DATA_INTERCHANGE_AN2KREADER_H__ */
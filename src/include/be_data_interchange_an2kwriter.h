@@ -0,0 +1,431 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_DATA_INTERCHANGE_AN2KWRITER_H__
+#define __BE_DATA_INTERCHANGE_AN2KWRITER_H__
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <be_data_interchange_an2kreader.h>
+#include <be_finger_an2kview_capture.h>
+#include <be_finger_an2kview_fixedres.h>
+#include <be_image_image.h>
+#include <be_io_recordstore.h>
+#include <be_latent_an2kview.h>
+#include <be_memory_bytespan.h>
+#include <be_palm_an2kview.h>
+
+namespace BiometricEvaluation
+{
+	namespace DataInterchange
+	{
+		/**
+		 * @brief
+		 * Assemble and serialize ANSI/NIST-ITL transactions.
+		 * @details
+		 * Logical records are formatted as they are added, so
+		 * that the length of each is known, and image data is
+		 * referenced rather than copied. Writing a transaction
+		 * computes the Type-1 record from the records added, then
+		 * copies every record into the output in a single pass.
+		 *
+		 * Image data of views and of Image objects is shared
+		 * with them. Spans that are not owned must remain valid
+		 * until the transaction is written.
+		 */
+		class AN2KWriter
+		{
+		public:
+			/**
+			 * Values of the fields of a tagged record, by
+			 * field number. Subfields are separated by
+			 * RecordSeparator and information items by
+			 * UnitSeparator.
+			 */
+			using Fields = std::map<uint16_t, std::string>;
+
+			/** Separates subfields of a tagged field */
+			static const char RecordSeparator = 0x1E;
+			/** Separates information items of a subfield */
+			static const char UnitSeparator = 0x1F;
+
+			/**
+			 * @brief
+			 * Constructor.
+			 *
+			 * @param[in] tot
+			 *	Type of transaction (TOT).
+			 * @param[in] dai
+			 *	Destination agency identifier (DAI).
+			 * @param[in] ori
+			 *	Originating agency identifier (ORI).
+			 * @param[in] tcn
+			 *	Transaction control number (TCN).
+			 * @param[in] date
+			 *	Date of the transaction (DAT), as YYYYMMDD.
+			 * @param[in] version
+			 *	Version of the standard (VER).
+			 * @param[in] nsr
+			 *	Native scanning resolution (NSR), in pixels
+			 *	per millimeter. Fixed resolution records
+			 *	that are not at the minimum scanning
+			 *	resolution are at this resolution.
+			 * @param[in] ntr
+			 *	Nominal transmitting resolution (NTR), in
+			 *	pixels per millimeter.
+			 */
+			AN2KWriter(
+			    const std::string &tot,
+			    const std::string &dai,
+			    const std::string &ori,
+			    const std::string &tcn,
+			    const std::string &date,
+			    const std::string &version = "0400",
+			    const std::string &nsr = "19.69",
+			    const std::string &ntr = "19.69");
+
+			/**
+			 * @brief
+			 * Set a field of the Type-1 record.
+			 *
+			 * @param[in] field
+			 *	Number of the field.
+			 * @param[in] value
+			 *	Value of the field.
+			 *
+			 * @throw Error::ParameterError
+			 *	field is not a field number, or is the LEN
+			 *	or CNT field, which are computed.
+			 */
+			void
+			setType1Field(
+			    const uint16_t field,
+			    const std::string &value);
+
+			/**
+			 * @brief
+			 * Add a logical record, as it was read.
+			 * @details
+			 * The bytes of the record are written verbatim,
+			 * so its IDC should be unique in the transaction.
+			 *
+			 * @param[in] record
+			 *	Record, such as one sequenced by AN2KReader.
+			 *
+			 * @throw Error::ParameterError
+			 *	record is a Type-1 record, or is empty.
+			 */
+			void
+			addRecord(
+			    const AN2KReader::Record &record);
+
+			/**
+			 * @brief
+			 * Add a tagged logical record.
+			 *
+			 * @param[in] type
+			 *	Type of the record.
+			 * @param[in] idc
+			 *	Information designation character.
+			 * @param[in] fields
+			 *	Fields of the record, other than LEN, IDC,
+			 *	and the image data.
+			 * @param[in] data
+			 *	Image data, written as the last field (999),
+			 *	or empty when there is none.
+			 *
+			 * @throw Error::ParameterError
+			 *	type is not a tagged record type, or fields
+			 *	contains a field that is computed or out of
+			 *	range.
+			 */
+			void
+			addTaggedRecord(
+			    const View::AN2KView::RecordType type,
+			    const uint32_t idc,
+			    const Fields &fields,
+			    const Memory::ByteSpan &data = Memory::ByteSpan());
+
+			/**
+			 * @brief
+			 * Add a fixed resolution image record.
+			 *
+			 * @param[in] type
+			 *	Type of the record, Type-3 through Type-6.
+			 * @param[in] idc
+			 *	Information designation character.
+			 * @param[in] impression
+			 *	Impression type.
+			 * @param[in] positions
+			 *	Up to six finger positions.
+			 * @param[in] nativeResolution
+			 *	Whether the image is at the native scanning
+			 *	resolution (NSR) instead of the minimum
+			 *	scanning resolution.
+			 * @param[in] size
+			 *	Dimensions of the image.
+			 * @param[in] compression
+			 *	Compression of the image data.
+			 * @param[in] data
+			 *	Image data.
+			 *
+			 * @throw Error::ParameterError
+			 *	A parameter cannot be represented in the
+			 *	record.
+			 */
+			void
+			addFixedResolutionRecord(
+			    const View::AN2KView::RecordType type,
+			    const uint32_t idc,
+			    const Finger::Impression impression,
+			    const Finger::PositionSet &positions,
+			    const bool nativeResolution,
+			    const Image::Size &size,
+			    const Image::CompressionAlgorithm compression,
+			    const Memory::ByteSpan &data);
+
+			/**
+			 * @brief
+			 * Add a fixed resolution finger image record
+			 * from a view.
+			 *
+			 * @param[in] view
+			 *	Type-3 through Type-6 view.
+			 * @param[in] idc
+			 *	Information designation character.
+			 *
+			 * @throw Error::ParameterError
+			 *	The view cannot be represented.
+			 */
+			void
+			addView(
+			    const Finger::AN2KViewFixedResolution &view,
+			    const uint32_t idc);
+
+			/**
+			 * @brief
+			 * Add a Type-14 record from a view.
+			 *
+			 * @param[in] view
+			 *	Variable resolution finger view.
+			 * @param[in] idc
+			 *	Information designation character.
+			 *
+			 * @throw Error::ParameterError
+			 *	The view cannot be represented.
+			 */
+			void
+			addView(
+			    const Finger::AN2KViewCapture &view,
+			    const uint32_t idc);
+
+			/**
+			 * @brief
+			 * Add a Type-13 record from a view.
+			 *
+			 * @param[in] view
+			 *	Latent view.
+			 * @param[in] idc
+			 *	Information designation character.
+			 *
+			 * @throw Error::ParameterError
+			 *	The view cannot be represented.
+			 */
+			void
+			addView(
+			    const Latent::AN2KView &view,
+			    const uint32_t idc);
+
+			/**
+			 * @brief
+			 * Add a Type-15 record from a view.
+			 *
+			 * @param[in] view
+			 *	Palm view.
+			 * @param[in] idc
+			 *	Information designation character.
+			 *
+			 * @throw Error::ParameterError
+			 *	The view cannot be represented.
+			 */
+			void
+			addView(
+			    const Palm::AN2KView &view,
+			    const uint32_t idc);
+
+			/**
+			 * @brief
+			 * Add a Type-14 record from an image.
+			 *
+			 * @param[in] image
+			 *	Image of the finger, whose data is written
+			 *	as it is encoded.
+			 * @param[in] idc
+			 *	Information designation character.
+			 * @param[in] position
+			 *	Finger position.
+			 * @param[in] impression
+			 *	Impression type.
+			 * @param[in] sourceAgency
+			 *	Source agency (SRC).
+			 * @param[in] captureDate
+			 *	Capture date (FCD), as YYYYMMDD.
+			 *
+			 * @throw Error::ParameterError
+			 *	The image cannot be represented.
+			 */
+			void
+			addFingerImage(
+			    const Image::Image &image,
+			    const uint32_t idc,
+			    const Finger::Position position,
+			    const Finger::Impression impression,
+			    const std::string &sourceAgency,
+			    const std::string &captureDate);
+
+			/**
+			 * @return
+			 *	Number of logical records in the
+			 *	transaction, including the Type-1 record.
+			 */
+			uint32_t
+			getRecordCount()
+			    const;
+
+			/**
+			 * @return
+			 *	Length of the transaction, in bytes.
+			 */
+			uint64_t
+			getLength()
+			    const;
+
+			/**
+			 * @brief
+			 * Serialize the transaction.
+			 *
+			 * @return
+			 *	The transaction.
+			 */
+			Memory::uint8Array
+			write()
+			    const;
+
+			/**
+			 * @brief
+			 * Serialize the transaction into a buffer.
+			 * @details
+			 * Allows a buffer to be reused for transactions.
+			 *
+			 * @param[out] buf
+			 *	Buffer to hold the transaction.
+			 * @param[in] size
+			 *	Size of buf.
+			 *
+			 * @return
+			 *	Length of the transaction written to buf.
+			 *
+			 * @throw Error::ParameterError
+			 *	buf is smaller than the transaction.
+			 */
+			uint64_t
+			write(
+			    uint8_t *buf,
+			    const uint64_t size)
+			    const;
+
+			/**
+			 * @brief
+			 * Serialize the transaction into a RecordStore.
+			 *
+			 * @param[in] store
+			 *	RecordStore in which to insert the
+			 *	transaction.
+			 * @param[in] key
+			 *	Key of the transaction.
+			 *
+			 * @throw Error::ObjectExists
+			 *	key exists in store.
+			 * @throw Error::StrategyError
+			 *	Error inserting into store.
+			 */
+			void
+			write(
+			    IO::RecordStore &store,
+			    const std::string &key)
+			    const;
+
+		private:
+			/** A formatted logical record */
+			struct Record
+			{
+				/** Type of the record */
+				unsigned int type;
+				/** Information designation character */
+				uint32_t idc;
+				/** Bytes before the data */
+				std::string header;
+				/** Data following the header */
+				Memory::ByteSpan data;
+				/** Bytes after the data */
+				std::string trailer;
+			};
+
+			/** Fields of the Type-1 record, but LEN and CNT */
+			Fields _type1;
+			/** Records following the Type-1 record */
+			std::vector<Record> _records;
+			/** Sum of the lengths of _records */
+			uint64_t _recordsLength{0};
+
+			/**
+			 * @brief
+			 * Add a formatted record.
+			 */
+			void
+			addRecord(
+			    Record &&record);
+
+			/**
+			 * @return
+			 *	The Type-1 record, listing _records.
+			 */
+			std::string
+			formatType1Record()
+			    const;
+
+			/**
+			 * @brief
+			 * Serialize the transaction, whose Type-1 record
+			 * is type1.
+			 */
+			void
+			write(
+			    const std::string &type1,
+			    uint8_t *buf,
+			    const uint64_t size)
+			    const;
+
+			/**
+			 * @return
+			 *	Fields common to variable resolution image
+			 *	records, from a view.
+			 */
+			static Fields
+			getVariableResolutionFields(
+			    const View::AN2KViewVariableResolution &view);
+		};
+	}
+}
+
+#endif /* __BE_DATA_INTERCHANGE_AN2KWRITER_H__ */
@@ -11,6 +11,8 @@
 #ifndef __BE_FEATURE_AN2K11EFS_H__
 #define __BE_FEATURE_AN2K11EFS_H__
 
+#include <memory>
+
 #include <be_image.h>
 #include <be_finger.h>
 #include <be_palm.h>
@@ -19,6 +21,11 @@
 #include <be_feature_minutiae.h>
 #include <be_framework_enumeration.h>
 #include <be_memory_autoarray.h>
+#include <be_memory_bytespan.h>
+
+/* an2k.h forward declares */
+struct ansi_nist;
+typedef ansi_nist ANSI_NIST;
 
 namespace BiometricEvaluation 
 {
@@ -629,7 +636,40 @@ namespace BiometricEvaluation
 			 *	for the requested number.
 			 */
 			ExtendedFeatureSet(
-			    Memory::uint8Array &buf,
+			    const Memory::ByteSpan &buf,
+			    int recordNumber);
+
+			/**
+			 * @brief
+			 * As the Memory::ByteSpan constructor. buf is
+			 * not retained.
+			 */
+			ExtendedFeatureSet(
+			    const Memory::uint8Array &buf,
+			    int recordNumber);
+
+			/**
+			 * @brief
+			 * Construct an ExtendedFeatureSet object from a shared
+			 * parse tree of a complete ANSI/NIST record.
+			 * @details
+			 * The parse tree is returned by
+			 * DataInterchange::AN2KRecord::parse(), so that
+			 * several objects may be constructed from one parse
+			 * of a transaction.
+			 *
+			 * @param[in] an2k
+			 * 	Parse tree of the complete ANSI/NIST record.
+			 * @param[in] recordNumber
+			 *	Which fingerprint minutiae record to read
+			 *	from the complete AN2K record.
+			 * @throw Error::DataError
+			 *	There is no fingerprint minutiae record
+			 *	for the requested number, or it has invalid
+			 *	or missing data.
+			 */
+			ExtendedFeatureSet(
+			    const std::shared_ptr<const ANSI_NIST> &an2k,
 			    int recordNumber);
 
 			/**
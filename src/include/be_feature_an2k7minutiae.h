@@ -12,11 +12,17 @@
 #define __BE_FEATURE_AN2K7MINUTIAE_H__
 
 #include <iostream>
+#include <memory>
 
 #include <be_framework_enumeration.h>
 #include <be_feature_minutiae.h>
 #include <be_finger.h>
 #include <be_memory_autoarray.h>
+#include <be_memory_bytespan.h>
+
+/* an2k.h forward declares */
+struct ansi_nist;
+typedef ansi_nist ANSI_NIST;
 
 namespace BiometricEvaluation 
 {
@@ -200,7 +206,40 @@ namespace BiometricEvaluation
 			 *	for the requested number.
 			 */
 			AN2K7Minutiae(
-			    Memory::uint8Array &buf,
+			    const Memory::ByteSpan &buf,
+			    int recordNumber);
+
+			/**
+			 * @brief
+			 * As the Memory::ByteSpan constructor. buf is
+			 * not retained.
+			 */
+			AN2K7Minutiae(
+			    const Memory::uint8Array &buf,
+			    int recordNumber);
+
+			/**
+			 * @brief
+			 * Construct an AN2K7 Minutiae object from a shared
+			 * parse tree of a complete ANSI/NIST record.
+			 * @details
+			 * The parse tree is returned by
+			 * DataInterchange::AN2KRecord::parse(), so that
+			 * several objects may be constructed from one parse
+			 * of a transaction.
+			 *
+			 * @param[in] an2k
+			 * 	Parse tree of the complete ANSI/NIST record.
+			 * @param[in] recordNumber
+			 *	Which fingerprint minutiae record to read
+			 *	from the complete AN2K record.
+			 * @throw Error::DataError
+			 *	There is no fingerprint minutiae record
+			 *	for the requested number, or it has invalid
+			 *	or missing data.
+			 */
+			AN2K7Minutiae(
+			    const std::shared_ptr<const ANSI_NIST> &an2k,
 			    int recordNumber);
 
 			/**
@@ -264,7 +303,7 @@ namespace BiometricEvaluation
 		protected:
 		private:
 			void readType9Record(
-			    Memory::uint8Array &buf,
+			    const ANSI_NIST *an2k,
     			    int recordNumber);
 
 			MinutiaPointSet _minutiaPointSet;
@@ -17,10 +17,13 @@
 #include <be_feature_an2k7minutiae.h>
 #include <be_feature_an2k11efs.h>
 #include <be_memory_autoarray.h>
+#include <be_memory_bytespan.h>
 
 /* an2k.h forward declares */
 struct record;
 typedef record RECORD;
+struct ansi_nist;
+typedef ansi_nist ANSI_NIST;
 
 namespace BiometricEvaluation {
 	namespace Finger {
@@ -86,7 +89,40 @@ namespace BiometricEvaluation {
 			 *	for the requested number.
 			 */
 			AN2KMinutiaeDataRecord(
-			    Memory::uint8Array &buf,
+			    const Memory::ByteSpan &buf,
+			    int recordNumber);
+
+			/**
+			 * @brief
+			 * As the Memory::ByteSpan constructor. buf is
+			 * not retained.
+			 */
+			AN2KMinutiaeDataRecord(
+			    const Memory::uint8Array &buf,
+			    int recordNumber);
+
+			/**
+			 * @brief
+			 * Construct an AN2KMinutiaeDataRecord object from a
+			 * shared parse tree of a complete ANSI/NIST record.
+			 * @details
+			 * The parse tree is returned by
+			 * DataInterchange::AN2KRecord::parse(), so that
+			 * several objects may be constructed from one parse
+			 * of a transaction.
+			 *
+			 * @param[in] an2k
+			 * 	Parse tree of the complete ANSI/NIST record.
+			 * @param[in] recordNumber
+			 *	Which fingerprint minutiae record to read
+			 *	from the complete AN2K record.
+			 * @throw Error::DataError
+			 *	There is no fingerprint minutiae record
+			 *	for the requested number, or it has invalid
+			 *	or missing data.
+			 */
+			AN2KMinutiaeDataRecord(
+			    const std::shared_ptr<const ANSI_NIST> &an2k,
 			    int recordNumber);
 		
 			/**
@@ -165,9 +201,8 @@ namespace BiometricEvaluation {
 			 * Parse information common to all vendors from the
 			 * Type-9 record.
 			 *
-			 * @param[in] buf
-			 * 	The memory buffer containing the complete
-			 *	ANSI/NIST record.
+			 * @param[in] an2k
+			 * 	Parse tree of the complete ANSI/NIST record.
 			 * @param[in] recordNumber
 			 *	Which fingerprint minutiae record to read
 			 *	from the complete AN2K record.
@@ -177,7 +212,7 @@ namespace BiometricEvaluation {
 			 */
 			void
 			readType9Record(
-			    Memory::uint8Array &buf,
+			    const std::shared_ptr<const ANSI_NIST> &an2k,
 			    int recordNumber);
 			
 			/**
@@ -107,7 +107,28 @@ namespace BiometricEvaluation
 			 * just the finger image and/or minutiae records.
 			 */
 			AN2KViewCapture(
-			    Memory::uint8Array &buf,
+			    const Memory::ByteSpan &buf,
+			    const uint32_t recordNumber);
+
+			/**
+			 * @brief
+			 * As the Memory::ByteSpan constructor. buf is
+			 * not retained.
+			 */
+			AN2KViewCapture(
+			    const Memory::uint8Array &buf,
+			    const uint32_t recordNumber);
+
+			/**
+			 * @brief
+			 * Construct an AN2K finger view from a shared parse
+			 * tree of an AN2K record.
+			 * @details
+			 * The parse tree must be of the entire AN2K record,
+			 * as returned by DataInterchange::AN2KRecord::parse().
+			 */
+			AN2KViewCapture(
+			    const std::shared_ptr<const ANSI_NIST> &an2k,
 			    const uint32_t recordNumber);
 
 			/**
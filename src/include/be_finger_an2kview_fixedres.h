@@ -85,7 +85,44 @@ namespace BiometricEvaluation
 			 *	An error occurred when parsing the AN2K record.
 			 */
 			AN2KViewFixedResolution(
-			    Memory::uint8Array &buf,
+			    const Memory::ByteSpan &buf,
+			    const RecordType typeID,
+			    const uint32_t recordNumber);
+
+			/**
+			 * @brief
+			 * As the Memory::ByteSpan constructor. buf is
+			 * not retained.
+			 */
+			AN2KViewFixedResolution(
+			    const Memory::uint8Array &buf,
+			    const RecordType typeID,
+			    const uint32_t recordNumber);
+
+			/**
+			 * @brief
+			 * Construct an AN2K finger view from a shared parse
+			 * tree of an AN2K record.
+			 * @details
+			 * The parse tree must be of the entire AN2K record,
+			 * as returned by DataInterchange::AN2KRecord::parse().
+			 *
+			 * @param[in] an2k
+			 *	Parse tree of the AN2K record, shared with
+			 *	this view.
+			 * @param[in] typeID
+			 *	The type of AN2K finger view: Type-3/Type-4/etc.
+			 * @param[in] recordNumber
+			 *	Which finger record to read as there may be 
+			 *	multiple finger views of the same type within
+			 *	a single AN2K record.
+			 * @throw Error::ParameterError
+			 *	An invalid parameter was passed in.
+			 * @throw Error::DataError
+			 *	An error occurred when parsing the AN2K record.
+			 */
+			AN2KViewFixedResolution(
+			    const std::shared_ptr<const ANSI_NIST> &an2k,
 			    const RecordType typeID,
 			    const uint32_t recordNumber);
 
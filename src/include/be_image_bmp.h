@@ -57,11 +57,17 @@ namespace BiometricEvaluation
 			    const statusCallback_t &statusCallback =
 			        Image::defaultStatusCallback);
 
+			BMP(
+			    const Memory::ByteSpan &data,
+			    const std::string &identifier = "",
+			    const statusCallback_t &statusCallback =
+			        Image::defaultStatusCallback);
+
 			~BMP() = default;
 
-			Memory::AutoArray<uint8_t>
-			getRawData()
-			    const;
+			uint64_t
+			getRawRowSize()
+			    const override;
 
 			Memory::AutoArray<uint8_t>
 			getRawGrayscaleData(
@@ -85,6 +91,9 @@ namespace BiometricEvaluation
 			    const uint8_t *data,
 			    uint64_t size);
 		protected:
+			Memory::uint8Array
+			decodeRawData()
+			    const override;
 
 		private:
 			/** Bitmap File Header */
@@ -0,0 +1,188 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_IMAGE_DECODEBATCH_H__
+#define __BE_IMAGE_DECODEBATCH_H__
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <be_image_image.h>
+#include <be_io_recordstore.h>
+#include <be_memory_bytespan.h>
+
+namespace BiometricEvaluation
+{
+	namespace Image
+	{
+		/** Default bytes of decoded data awaiting consumption */
+		static const uint64_t DEFAULT_DECODE_BATCH_MEMORY_BUDGET =
+		    1024 * 1024 * 1024;
+
+		/** Outcome of decoding one item of a batch */
+		struct DecodedImage
+		{
+			/** Position of the item within the batch */
+			uint64_t index{0};
+			/** RecordStore key of the item, if any */
+			std::string key{};
+			/** Image opened from the item's data */
+			std::shared_ptr<Image> image{};
+			/**
+			 * Raw data (or grayscale data, if requested)
+			 * decoded from image, shared with DecodeCache
+			 * when it is enabled.
+			 */
+			Memory::ByteSpan rawData{};
+			/**
+			 * Exception thrown while reading, opening, or
+			 * decoding the item, or nullptr on success. Use
+			 * std::rethrow_exception() to examine it.
+			 */
+			std::exception_ptr error{};
+		};
+
+		/** Parameters of decodeBatch() */
+		struct DecodeBatchOptions
+		{
+			/**
+			 * Number of decoding threads. 0 uses one thread
+			 * per CPU core.
+			 */
+			uint32_t threads{0};
+			/**
+			 * Decoding pauses while decoded data not yet
+			 * passed to the consumer exceeds this many
+			 * bytes. Each thread may finish one more item
+			 * past the budget.
+			 */
+			uint64_t memoryBudget{DEFAULT_DECODE_BATCH_MEMORY_BUDGET};
+			/**
+			 * When non-zero, decode with
+			 * Image::getRawGrayscaleData() at this depth
+			 * instead of Image::getRawData().
+			 */
+			uint8_t grayscaleDepth{0};
+		};
+
+		/** Receives decoded items, in batch order */
+		using DecodeBatchConsumer = std::function<void(
+		    DecodedImage &&decodedImage)>;
+
+		/**
+		 * @brief
+		 * Decode many encoded images in parallel.
+		 * @details
+		 * Items are distributed over a pool of threads, each
+		 * working through its own share of the batch and
+		 * stealing from others once done. Items are passed to
+		 * consumer on the calling thread in the order of data,
+		 * as soon as they and every item before them have been
+		 * decoded. Failures are captured per item and do not
+		 * stop the batch.
+		 *
+		 * @param[in] data
+		 *	Encoded images. The bytes must remain valid
+		 *	until decodeBatch() returns, and for as long as
+		 *	images passed to consumer are used when the
+		 *	spans are not owned.
+		 * @param[in] consumer
+		 *	Called once for each item, in order.
+		 * @param[in] options
+		 *	Parameters of the batch.
+		 *
+		 * @throw Error::Exception
+		 *	Propagated from consumer, after all decoding
+		 *	threads have stopped. Remaining items are
+		 *	not passed to consumer.
+		 */
+		void
+		decodeBatch(
+		    const std::vector<Memory::ByteSpan> &data,
+		    const DecodeBatchConsumer &consumer,
+		    const DecodeBatchOptions &options = DecodeBatchOptions());
+
+		/**
+		 * @brief
+		 * Decode many images stored in a RecordStore in
+		 * parallel.
+		 * @details
+		 * As decodeBatch() for buffers, except that records
+		 * are read by the decoding threads, one read at a time.
+		 *
+		 * @param[in] recordStore
+		 *	RecordStore holding encoded images. It must
+		 *	not be used by other threads during the call.
+		 * @param[in] keys
+		 *	Keys of the records to decode.
+		 * @param[in] consumer
+		 *	Called once for each key, in order.
+		 * @param[in] options
+		 *	Parameters of the batch.
+		 *
+		 * @throw Error::Exception
+		 *	Propagated from consumer, after all decoding
+		 *	threads have stopped.
+		 */
+		void
+		decodeBatch(
+		    const IO::RecordStore &recordStore,
+		    const std::vector<std::string> &keys,
+		    const DecodeBatchConsumer &consumer,
+		    const DecodeBatchOptions &options = DecodeBatchOptions());
+
+		/**
+		 * @brief
+		 * Decode many encoded images in parallel.
+		 *
+		 * @param[in] data
+		 *	Encoded images.
+		 * @param[in] options
+		 *	Parameters of the batch. The memory budget
+		 *	does not apply, since all items are returned.
+		 *
+		 * @return
+		 *	One DecodedImage per item of data, in the same
+		 *	order.
+		 */
+		std::vector<DecodedImage>
+		decodeBatch(
+		    const std::vector<Memory::ByteSpan> &data,
+		    const DecodeBatchOptions &options = DecodeBatchOptions());
+
+		/**
+		 * @brief
+		 * Decode many images stored in a RecordStore in
+		 * parallel.
+		 *
+		 * @param[in] recordStore
+		 *	RecordStore holding encoded images.
+		 * @param[in] keys
+		 *	Keys of the records to decode.
+		 * @param[in] options
+		 *	Parameters of the batch. The memory budget
+		 *	does not apply, since all items are returned.
+		 *
+		 * @return
+		 *	One DecodedImage per key, in the same order.
+		 */
+		std::vector<DecodedImage>
+		decodeBatch(
+		    const IO::RecordStore &recordStore,
+		    const std::vector<std::string> &keys,
+		    const DecodeBatchOptions &options = DecodeBatchOptions());
+	}
+}
+
+#endif /* __BE_IMAGE_DECODEBATCH_H__ */
@@ -0,0 +1,109 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_IMAGE_DECODECACHE_H__
+#define __BE_IMAGE_DECODECACHE_H__
+
+#include <cstdint>
+
+namespace BiometricEvaluation
+{
+	namespace Image
+	{
+		/**
+		 * @brief
+		 * Memoization of decoded images.
+		 * @details
+		 * When the cache has a non-zero budget, the raw data
+		 * decoded from an Image is kept until the Image is
+		 * destroyed or the data is evicted to stay within the
+		 * budget, least recently used first. Further calls to
+		 * Image::getRawData(), Image::getRawDataSpan(), and
+		 * conversions derived from raw data, such as
+		 * Image::getRawGrayscaleData(), then use the kept data
+		 * instead of decoding again.
+		 *
+		 * The cache is shared by all threads of the process. It
+		 * is disabled (budget of 0) by default.
+		 */
+		namespace DecodeCache
+		{
+			/** Default number of bytes of decoded data to keep */
+			static const uint64_t DEFAULT_BUDGET = 0;
+
+			/** Activity of the cache */
+			struct Statistics
+			{
+				/** Images decoded while the cache was enabled */
+				uint64_t decodes{0};
+				/** Requests satisfied by kept data */
+				uint64_t decodesAvoided{0};
+				/** Decoded images discarded to fit the budget */
+				uint64_t evictions{0};
+				/** Number of decoded images kept */
+				uint64_t cachedImages{0};
+				/** Number of bytes of decoded data kept */
+				uint64_t cachedSize{0};
+			};
+
+			/**
+			 * @brief
+			 * Set the maximum number of bytes of decoded data
+			 * to keep.
+			 *
+			 * @param[in] budget
+			 *	Maximum number of bytes. 0 disables
+			 *	caching and discards all kept data.
+			 *
+			 * @note
+			 * Decoded images larger than budget are not kept.
+			 */
+			void
+			setBudget(
+			    uint64_t budget);
+
+			/**
+			 * @return
+			 *	Maximum number of bytes of decoded data to
+			 *	keep.
+			 */
+			uint64_t
+			getBudget();
+
+			/**
+			 * @brief
+			 * Discard all kept data.
+			 */
+			void
+			clear();
+
+			/**
+			 * @return
+			 *	Activity of the cache since the process
+			 *	started or resetStatistics() was called.
+			 */
+			Statistics
+			getStatistics();
+
+			/**
+			 * @brief
+			 * Reset the counters returned by getStatistics().
+			 *
+			 * @note
+			 * cachedImages and cachedSize describe the current
+			 * contents and are not reset.
+			 */
+			void
+			resetStatistics();
+		}
+	}
+}
+
+#endif /* __BE_IMAGE_DECODECACHE_H__ */
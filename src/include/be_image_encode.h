@@ -0,0 +1,131 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_IMAGE_ENCODE_H__
+#define __BE_IMAGE_ENCODE_H__
+
+#include <cstdint>
+
+#include <be_image.h>
+#include <be_image_image.h>
+#include <be_memory_autoarray.h>
+
+namespace BiometricEvaluation
+{
+	namespace Image
+	{
+		/** Parameters of encode() */
+		struct EncodeParameters
+		{
+			/**
+			 * WSQ bitrate, in bits per pixel. 0.75 yields
+			 * roughly 15:1 compression, 2.25 roughly 5:1.
+			 */
+			float wsqBitrate{0.75};
+			/** JPEG quality, from 0 (worst) to 100 (best) */
+			uint8_t jpegQuality{90};
+			/**
+			 * zlib compression level of PNG, from 0 (none)
+			 * to 9 (smallest), or -1 for zlib's default.
+			 */
+			int8_t pngCompressionLevel{-1};
+			/**
+			 * Resolution recorded in the encoded image. When
+			 * either component is 0, the resolution of the
+			 * image being encoded is used.
+			 */
+			Resolution resolution{0, 0, Resolution::Units::PPI};
+		};
+
+		/**
+		 * @brief
+		 * Encode the raw data of an image.
+		 * @details
+		 * Supported encodings are:
+		 *  - CompressionAlgorithm::WSQ20: 8-bit grayscale.
+		 *  - CompressionAlgorithm::JPEGL: 8-bit grayscale.
+		 *  - CompressionAlgorithm::JPEGB: 8-bit grayscale and
+		 *    24-bit RGB.
+		 *  - CompressionAlgorithm::PNG: grayscale, grayscale
+		 *    with alpha, RGB and RGBA, with 8 or 16 bits per
+		 *    component.
+		 *
+		 * Encoding keeps no state between calls, so any number
+		 * of images may be encoded concurrently. Use Image::Raw
+		 * to encode pixels that are not already in an Image.
+		 *
+		 * @param[in] image
+		 *	Image whose raw data is encoded.
+		 * @param[in] algorithm
+		 *	Encoding to produce.
+		 * @param[out] output
+		 *	Encoded image. Its storage is reused when large
+		 *	enough, so passing the same AutoArray for a
+		 *	series of images avoids repeated allocation.
+		 *	JPEGB and PNG are encoded directly into output.
+		 *	The NBIS WSQ20 and JPEGL encoders allocate their
+		 *	own buffer, which is copied into output and
+		 *	freed, so those encodings still allocate once
+		 *	per call.
+		 * @param[in] parameters
+		 *	Parameters of the encoding.
+		 *
+		 * @throw Error::NotImplemented
+		 *	Encoding to algorithm is not supported.
+		 * @throw Error::ParameterError
+		 *	The color depth of image cannot be encoded
+		 *	with algorithm, or a parameter is out of range.
+		 * @throw Error::DataError
+		 *	Error decoding image.
+		 * @throw Error::StrategyError
+		 *	Error encoding image.
+		 */
+		void
+		encode(
+		    const Image &image,
+		    const CompressionAlgorithm algorithm,
+		    Memory::uint8Array &output,
+		    const EncodeParameters &parameters = EncodeParameters());
+
+		/**
+		 * @brief
+		 * Encode the raw data of an image.
+		 * @details
+		 * As encode() to an output AutoArray.
+		 *
+		 * @param[in] image
+		 *	Image whose raw data is encoded.
+		 * @param[in] algorithm
+		 *	Encoding to produce.
+		 * @param[in] parameters
+		 *	Parameters of the encoding.
+		 *
+		 * @return
+		 *	Encoded image.
+		 *
+		 * @throw Error::NotImplemented
+		 *	Encoding to algorithm is not supported.
+		 * @throw Error::ParameterError
+		 *	The color depth of image cannot be encoded
+		 *	with algorithm, or a parameter is out of range.
+		 * @throw Error::DataError
+		 *	Error decoding image.
+		 * @throw Error::StrategyError
+		 *	Error encoding image.
+		 */
+		Memory::uint8Array
+		encode(
+		    const Image &image,
+		    const CompressionAlgorithm algorithm,
+		    const EncodeParameters &parameters = EncodeParameters());
+	}
+}
+
+#endif /* __BE_IMAGE_ENCODE_H__ */
@@ -20,6 +20,7 @@
 #include <be_io.h>
 #include <be_image.h>
 #include <be_memory_autoarray.h>
+#include <be_memory_bytespan.h>
 
 namespace BiometricEvaluation
 {
@@ -51,6 +52,16 @@ namespace BiometricEvaluation
 		public:
 			using statusCallback_t = std::function<void(
 			    const Framework::Status)>;
+			/**
+			 * Receives rowCount consecutive rows of raw image
+			 * data, starting at row firstRow, from decodeRows().
+			 * rows holds the rows getRawRowSize() bytes apart
+			 * and is only valid during the call.
+			 */
+			using rowCallback_t = std::function<void(
+			    uint32_t firstRow,
+			    uint32_t rowCount,
+			    const uint8_t *rows)>;
 
 			/**
 		 	 * @brief
@@ -125,6 +136,73 @@ namespace BiometricEvaluation
 			    const statusCallback_t &statusCallback =
 			        Image::defaultStatusCallback);
 
+			/**
+		 	 * @brief
+			 * Parent constructor for all Image classes, referring
+			 * to image data without copying it.
+			 *
+			 * @param[in] data
+			 *	The image data. If data is not owned, it must
+			 *	remain valid for the life of this Image.
+			 * @param[in] dimensions
+			 *	The width and height of the image in pixels.
+			 * @param[in] colorDepth
+			 *	The image color depth, in bits-per-pixel.
+			 * @param[in] bitDepth
+			 *	The number of bits per color component.
+			 * @param[in] resolution
+			 *	The resolution of the image
+			 * @param[in] compression
+			 *	The CompressionAlgorithm of data.
+			 * @param[in] hasAlphaChannel
+			 *	Presence of an alpha channel.
+			 * @param identifier
+			 * Identifier for the encapsulated data.
+			 * @param statusCallback
+			 * Function to handle statuses sent when processing
+			 * images.
+			 *
+			 * @throw Error::StrategyError
+			 *	Error while creating Image.
+			 */
+			Image(
+			    const Memory::ByteSpan &data,
+			    const Size dimensions,
+			    const uint32_t colorDepth,
+			    const uint16_t bitDepth,
+			    const Resolution resolution,
+			    const CompressionAlgorithm compression,
+			    const bool hasAlphaChannel,
+			    const std::string &identifier = "",
+			    const statusCallback_t &statusCallback =
+			        Image::defaultStatusCallback);
+
+			/**
+		 	 * @brief
+			 * Parent constructor for all Image classes, referring
+			 * to image data without copying it.
+			 *
+			 * @param[in] data
+			 *	The image data. If data is not owned, it must
+			 *	remain valid for the life of this Image.
+			 * @param[in] compression
+			 *	The CompressionAlgorithm of data.
+			 * @param identifier
+			 * Identifier for the encapsulated data.
+			 * @param statusCallback
+			 * Function to handle statuses sent when processing
+			 * images.
+			 *
+			 * @throw Error::StrategyError
+			 *	Error while creating Image.
+			 */
+			Image(
+			    const Memory::ByteSpan &data,
+			    const CompressionAlgorithm compression,
+			    const std::string &identifier = "",
+			    const statusCallback_t &statusCallback =
+			        Image::defaultStatusCallback);
+
 			/**
 			 * @brief
 			 * Accessor for the CompressionAlgorithm of the image.
@@ -160,6 +238,18 @@ namespace BiometricEvaluation
 			getData()
 			    const;
 
+			/**
+			 * @brief
+			 * Accessor for the image data, without copying.
+			 *
+			 * @return
+			 *	Span of the image data, sharing ownership
+			 *	of it with this Image when owned.
+			 */
+			Memory::ByteSpan
+			getDataSpan()
+			    const;
+
 			/**
 		 	 * @brief
 			 * Accessor for the raw image data. The data returned
@@ -170,10 +260,165 @@ namespace BiometricEvaluation
 			 *
 			 * @throw Error::DataError
 			 *	Error decompressing image data.
+			 *
+			 * @note
+			 * When DecodeCache is enabled, the data is decoded
+			 * once, but each call returns a copy of the cached
+			 * data. Callers that only read the data should use
+			 * getRawDataSpan(), which shares it.
 			 */
 			virtual Memory::uint8Array
 			getRawData()
-			    const = 0;
+			    const;
+
+			/**
+		 	 * @brief
+			 * Accessor for the raw image data, without copying
+			 * data kept by DecodeCache.
+			 *
+			 * @return
+			 *	Span holding raw image data, shared with
+			 *	DecodeCache and other callers when caching
+			 *	is enabled.
+			 *
+			 * @throw Error::DataError
+			 *	Error decompressing image data.
+			 */
+			Memory::ByteSpan
+			getRawDataSpan()
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain the size of one row of raw image data.
+			 *
+			 * @return
+			 *	Number of bytes in each row of getRawData().
+			 */
+			virtual uint64_t
+			getRawRowSize()
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain the size of buffer that decodeInto()
+			 * requires.
+			 *
+			 * @param[in] stride
+			 *	Number of bytes from the start of one row
+			 *	to the start of the next, or 0 for
+			 *	getRawRowSize().
+			 *
+			 * @return
+			 *	Number of bytes needed to hold every row of
+			 *	raw image data, stride bytes apart. The last
+			 *	row is not padded to stride.
+			 *
+			 * @throw Error::ParameterError
+			 *	stride is less than getRawRowSize().
+			 */
+			uint64_t
+			requiredBufferSize(
+			    uint64_t stride = 0)
+			    const;
+
+			/**
+		 	 * @brief
+			 * Decode the raw image data into a buffer owned by
+			 * the caller.
+			 * @details
+			 * Rows are written in the format of getRawData(),
+			 * stride bytes apart, so a buffer can be reused
+			 * between images or be part of a larger canvas.
+			 * Bytes between rows are not modified. Codecs write
+			 * decoded rows directly into buffer where their
+			 * library allows.
+			 *
+			 * @param[in] buffer
+			 *	Buffer to hold the raw image data.
+			 * @param[in] size
+			 *	Size of buffer, at least
+			 *	requiredBufferSize(stride).
+			 * @param[in] stride
+			 *	Number of bytes from the start of one row
+			 *	to the start of the next, or 0 for
+			 *	getRawRowSize().
+			 *
+			 * @throw Error::DataError
+			 *	Error decompressing image data.
+			 * @throw Error::ParameterError
+			 *	buffer is too small, or stride is less than
+			 *	getRawRowSize().
+			 *
+			 * @note
+			 * When DecodeCache is enabled and holds this
+			 * Image's raw data, it is copied from the cache.
+			 * Data decoded by this method is not cached.
+			 */
+			void
+			decodeInto(
+			    uint8_t *buffer,
+			    uint64_t size,
+			    uint64_t stride = 0)
+			    const;
+
+			/**
+			 * @brief
+			 * Decode the raw image data into a reusable array.
+			 *
+			 * @param[in,out] buffer
+			 *	Array to hold the raw image data, resized to
+			 *	requiredBufferSize(). Its storage is reused
+			 *	when large enough.
+			 *
+			 * @throw Error::DataError
+			 *	Error decompressing image data.
+			 */
+			void
+			decodeInto(
+			    Memory::uint8Array &buffer)
+			    const;
+
+			/**
+			 * @brief
+			 * Decode the raw image data a few rows at a time.
+			 * @details
+			 * Rows are passed to callback in order, in the
+			 * format of getRawData(). Codecs that can decode
+			 * part of an image (JPEG, PNG, TIFF strips and
+			 * tiles, and JPEG 2000 tiles) keep only the rows
+			 * being decoded in memory, so very large images can
+			 * be processed in bounded memory. Other codecs
+			 * decode the whole image first.
+			 *
+			 * @param[in] callback
+			 *	Called for each chunk of rows.
+			 * @param[in] rowsPerChunk
+			 *	Maximum number of rows passed to each call
+			 *	of callback, or 0 for the codec's natural
+			 *	unit, such as a strip, row of tiles, or row
+			 *	of JPEG MCUs. Chunks are shorter at the end
+			 *	of the image and where a chunk would span
+			 *	rows of tiles.
+			 *
+			 * @throw Error::DataError
+			 *	Error decompressing image data.
+			 * @throw Error::ParameterError
+			 *	callback is empty.
+			 *
+			 * @note
+			 * Exceptions thrown by callback stop decoding and
+			 * are rethrown.
+			 * @note
+			 * When DecodeCache is enabled and holds this
+			 * Image's raw data, rows are passed from the cache.
+			 * Data decoded by this method is not cached.
+			 */
+			void
+			decodeRows(
+			    const rowCallback_t &callback,
+			    uint32_t rowsPerChunk = 0)
+			    const;
 
 			/**
 		 	 * @brief
@@ -200,6 +445,77 @@ namespace BiometricEvaluation
 			    const bool removeAlphaChannelIfPresent)
 			    const;
 
+			/**
+			 * @brief
+			 * Accessor for the raw data of part of the image,
+			 * optionally at reduced resolution.
+			 * @details
+			 * Only the bounding box of region is used. At a
+			 * reduction of n, each dimension of the image is
+			 * divided by 2^n, rounding up, and the region
+			 * becomes the reduced pixels that cover it. Reduced
+			 * pixels are the average of the pixels they cover.
+			 *
+			 * JPEG and JPEG2000 images decode only the pixels
+			 * needed, at the reduced resolution. Other images
+			 * are fully decoded, then cropped and reduced.
+			 *
+			 * @param[in] region
+			 *	Region to decode. A region with an empty
+			 *	size selects the entire image.
+			 * @param[in] reduction
+			 *	Number of times to halve the resolution,
+			 *	up to MAX_REDUCTION.
+			 *
+			 * @return
+			 *	Raw data of the region, in the format of
+			 *	getRawData(), with dimensions
+			 *	getRegionDimensions(region, reduction).
+			 *
+			 * @throw Error::DataError
+			 *	Error decompressing image data.
+			 * @throw Error::ParameterError
+			 *	region is not within the image, or
+			 *	reduction is too large.
+			 *
+			 * @note
+			 * Reduced pixels are computed by the codec when
+			 * possible, so they may differ slightly between
+			 * codecs.
+			 */
+			Memory::uint8Array
+			getRawData(
+			    const ROI &region,
+			    uint8_t reduction = 0)
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain the dimensions of data returned from
+			 * getRawData(region, reduction).
+			 *
+			 * @param[in] region
+			 *	Region to decode. A region with an empty
+			 *	size selects the entire image.
+			 * @param[in] reduction
+			 *	Number of times to halve the resolution.
+			 *
+			 * @return
+			 *	Dimensions of the decoded region.
+			 *
+			 * @throw Error::ParameterError
+			 *	region is not within the image, or
+			 *	reduction is too large.
+			 */
+			Size
+			getRegionDimensions(
+			    const ROI &region,
+			    uint8_t reduction = 0)
+			    const;
+
+			/** Largest reduction accepted by getRawData() */
+			static const uint8_t MAX_REDUCTION = 16;
+
 			/**
 			 * @brief
 			 * Accessor for decompressed data in grayscale.
@@ -219,9 +535,9 @@ namespace BiometricEvaluation
 			 *	Invalid value for depth.
 			 *
 			 * @note
-			 *	This method does not save a cached copy of the
-			 *	decompressed image because the bit depth of the
-			 *	image can be changed between calls.
+			 *	The grayscale data is not cached, but the raw
+			 *	data it is converted from is when DecodeCache
+			 *	is enabled.
 			 *
 			 * @note
 			 * When depth is 1, this method returns an image that
@@ -399,6 +715,36 @@ namespace BiometricEvaluation
 			    const statusCallback_t &statusCallback =
 			        Image::defaultStatusCallback);
 
+			/**
+			 * @brief
+			 * Determine the image type of a span of image data
+			 * and create an Image object referring to it.
+			 *
+ 			 * @param[in] data
+			 *	The image data, which is not copied. If data
+			 *	is not owned, it must remain valid for the
+			 *	life of the returned Image.
+			 * @param identifier
+			 * Identifier for the encapsulated data.
+			 * @param statusCallback
+			 * Function to handle statuses sent when processing
+			 * images.
+			 *
+			 * @return
+			 *	Image representation of the input data span.
+ 			 *
+			 * @throw Error::DataError
+			 *	Error manipulating data.
+			 * @throw Error::StrategyError
+			 *	Error while creating Image.
+			 */
+			static std::shared_ptr<Image>
+			openImage(
+			    const Memory::ByteSpan &data,
+			    const std::string &identifier = "",
+			    const statusCallback_t &statusCallback =
+			        Image::defaultStatusCallback);
+
 			/**
 			 * @brief
 			 * Determine the image type of an image file and create
@@ -534,6 +880,162 @@ namespace BiometricEvaluation
 			    const Framework::Status &status);
 
 		protected:
+			/**
+			 * @brief
+			 * Decode the image data.
+			 * @details
+			 * Called by getRawData() and getRawDataSpan() when
+			 * the decoded data is not cached. Implementations
+			 * override this method; images that are not
+			 * decoded may override getRawData() instead.
+			 * This method never calls getRawData().
+			 *
+			 * @return
+			 *	AutoArray holding raw image data.
+			 *
+			 * @throw Error::DataError
+			 *	Error decompressing image data.
+			 * @throw Error::NotImplemented
+			 *	Not overridden by the implementation.
+			 */
+			virtual Memory::uint8Array
+			decodeRawData()
+			    const;
+
+			/**
+			 * @brief
+			 * Decode the image data into a buffer.
+			 * @details
+			 * Called by decodeInto() when the decoded data is
+			 * not cached. Implementations override this method
+			 * to write rows directly into buffer. The default
+			 * implementation copies the rows of decodeRawData().
+			 *
+			 * @param[in] buffer
+			 *	Buffer of at least requiredBufferSize(stride)
+			 *	bytes.
+			 * @param[in] stride
+			 *	Number of bytes from the start of one row
+			 *	to the start of the next, at least
+			 *	getRawRowSize().
+			 *
+			 * @throw Error::DataError
+			 *	Error decompressing image data.
+			 */
+			virtual void
+			decodeRawDataInto(
+			    uint8_t *buffer,
+			    uint64_t stride)
+			    const;
+
+			/**
+			 * @brief
+			 * Copy packed raw image data into a buffer.
+			 *
+			 * @param[in] rawData
+			 *	Raw image data, rows of getRawRowSize() bytes
+			 *	without padding.
+			 * @param[in] rawDataSize
+			 *	Size of rawData.
+			 * @param[in] buffer
+			 *	Buffer of at least requiredBufferSize(stride)
+			 *	bytes.
+			 * @param[in] stride
+			 *	Number of bytes from the start of one row
+			 *	to the start of the next in buffer.
+			 *
+			 * @throw Error::DataError
+			 *	rawDataSize does not match the dimensions
+			 *	of the image.
+			 */
+			void
+			copyRawDataInto(
+			    const uint8_t *rawData,
+			    uint64_t rawDataSize,
+			    uint8_t *buffer,
+			    uint64_t stride)
+			    const;
+
+			/**
+			 * @brief
+			 * Decode the raw image data a few rows at a time.
+			 * @details
+			 * Called by decodeRows() when the decoded data is
+			 * not cached. Implementations override this method
+			 * to decode part of the image at a time. The
+			 * default implementation decodes the whole image
+			 * with decodeRawDataInto() and passes it in chunks.
+			 *
+			 * @param[in] callback
+			 *	Called for each chunk of rows.
+			 * @param[in] rowsPerChunk
+			 *	Maximum number of rows passed to each call
+			 *	of callback, or 0 for the codec's natural
+			 *	unit.
+			 *
+			 * @throw Error::DataError
+			 *	Error decompressing image data.
+			 */
+			virtual void
+			decodeRawRows(
+			    const rowCallback_t &callback,
+			    uint32_t rowsPerChunk)
+			    const;
+
+			/**
+			 * @brief
+			 * Pass decoded rows to a decodeRows() callback.
+			 *
+			 * @param[in] rows
+			 *	Packed rows, getRawRowSize() bytes apart.
+			 * @param[in] firstRow
+			 *	Row of the image at the start of rows.
+			 * @param[in] rowCount
+			 *	Number of rows in rows.
+			 * @param[in] callback
+			 *	Called for each chunk of rows.
+			 * @param[in] rowsPerChunk
+			 *	Maximum number of rows passed to each call
+			 *	of callback, or 0 to pass all rows at once.
+			 */
+			void
+			passRows(
+			    const uint8_t *rows,
+			    uint32_t firstRow,
+			    uint32_t rowCount,
+			    const rowCallback_t &callback,
+			    uint32_t rowsPerChunk)
+			    const;
+
+			/**
+			 * @brief
+			 * Decode part of the image data.
+			 * @details
+			 * Called by getRawData(region, reduction).
+			 * Implementations override this method when the
+			 * codec can decode a region or a reduced
+			 * resolution directly. The default implementation
+			 * crops and reduces getRawDataSpan().
+			 *
+			 * @param[in] region
+			 *	Region to decode, of non-empty size and
+			 *	within the image.
+			 * @param[in] reduction
+			 *	Number of times to halve the resolution,
+			 *	no more than MAX_REDUCTION.
+			 *
+			 * @return
+			 *	Raw data of the region.
+			 *
+			 * @throw Error::DataError
+			 *	Error decompressing image data.
+			 */
+			virtual Memory::uint8Array
+			decodeRegion(
+			    const ROI &region,
+			    uint8_t reduction)
+			    const;
+
 			/**
 		 	 * @brief
 			 * Mutator for the resolution of the image .
@@ -604,6 +1106,21 @@ namespace BiometricEvaluation
 			}
 
 		private:
+			/**
+			 * @brief
+			 * Obtain the decoded data from DecodeCache,
+			 * decoding and caching it when not present.
+			 *
+			 * @return
+			 *	Decoded data, shared with DecodeCache.
+			 *
+			 * @throw Error::DataError
+			 *	Error decompressing image data.
+			 */
+			std::shared_ptr<const Memory::uint8Array>
+			getCachedRawData()
+			    const;
+
 			/** Image dimensions (width and height) in pixels */
 			Size _dimensions;
 
@@ -620,7 +1137,7 @@ namespace BiometricEvaluation
 			Resolution _resolution;
 
 			/** Encoded image data */
-			Memory::AutoArray<uint8_t> _data;
+			Memory::ByteSpan _data;
 
 			/** Compression algorithm of _data */
 			CompressionAlgorithm _compressionAlgorithm;
@@ -68,16 +68,18 @@ namespace BiometricEvaluation
 			    const statusCallback_t &statusCallback =
 			        Image::defaultStatusCallback);
 
+			JPEG(
+			    const Memory::ByteSpan &data,
+			    const std::string &identifier = "",
+			    const statusCallback_t &statusCallback =
+			        Image::defaultStatusCallback);
+
 			~JPEG() = default;
 
 			Memory::uint8Array
 			getRawGrayscaleData(
 			    uint8_t depth) const;
 
-			Memory::uint8Array
-			getRawData()
-			    const;
-
 			/**
 			 * Whether or not data is a Lossy JPEG image.
 			 *
@@ -95,6 +97,34 @@ namespace BiometricEvaluation
 			    const uint8_t *data,
 			    uint64_t size);
 
+			/**
+			 * @brief
+			 * Find the kind of process of the first start of
+			 * frame marker of JPEG data.
+			 * @details
+			 * isJPEG() and JPEGL::isJPEGL() both test the
+			 * result of this single walk of the marker
+			 * segments.
+			 *
+			 * @param[in] data
+			 *	The buffer to check.
+			 * @param[in] size
+			 *	The size of data.
+			 *
+			 * @return
+			 *	CompressionAlgorithm::JPEGB if the first start
+			 *	of frame marker is of a lossy process,
+			 *	CompressionAlgorithm::JPEGL if it is of a
+			 *	lossless process, CompressionAlgorithm::None
+			 *	if data is not JPEG or a start of scan marker
+			 *	comes first. Fill bytes (0xFF) before
+			 *	markers are skipped.
+			 */
+			static CompressionAlgorithm
+			scanStartOfFrame(
+			    const uint8_t *data,
+			    uint64_t size);
+
 			static int
 			getc_skip_marker_segment(
 			    const unsigned short marker,
@@ -102,6 +132,27 @@ namespace BiometricEvaluation
 			    unsigned char *ebufptr);
 
 		protected:
+			Memory::uint8Array
+			decodeRawData()
+			    const override;
+
+			void
+			decodeRawDataInto(
+			    uint8_t *buffer,
+			    uint64_t stride)
+			    const override;
+
+			void
+			decodeRawRows(
+			    const rowCallback_t &callback,
+			    uint32_t rowsPerChunk)
+			    const override;
+
+			Memory::uint8Array
+			decodeRegion(
+			    const ROI &region,
+			    uint8_t reduction)
+			    const override;
 
 		private:
 			/**
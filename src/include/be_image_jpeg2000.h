@@ -57,16 +57,82 @@ namespace BiometricEvaluation
 			    const statusCallback_t &statusCallback =
 			        Image::defaultStatusCallback);
 
-			~JPEG2000() = default;
+			JPEG2000(
+			    const Memory::ByteSpan &data,
+			    const std::string &identifier = "",
+			    const statusCallback_t &statusCallback =
+			        Image::defaultStatusCallback,
+			    const int8_t codecFormat = 2);
 
-			Memory::uint8Array
-			getRawData()
-			    const;
+			~JPEG2000() = default;
 
 			Memory::uint8Array
 			getRawGrayscaleData(
 			    uint8_t depth) const;
 
+			/** Decode threads value selecting one per CPU */
+			static const uint32_t ALL_CPUS = 0;
+
+			/**
+			 * @brief
+			 * Set the number of threads OpenJPEG uses to
+			 * decode this image.
+			 * @details
+			 * Overrides setDefaultDecodeThreads() for this
+			 * image.
+			 *
+			 * @param[in] threads
+			 *	Number of threads, or ALL_CPUS.
+			 */
+			void
+			setDecodeThreads(
+			    uint32_t threads);
+
+			/**
+			 * @return
+			 *	Number of threads OpenJPEG uses to decode
+			 *	this image, or ALL_CPUS.
+			 */
+			uint32_t
+			getDecodeThreads()
+			    const;
+
+			/**
+			 * @brief
+			 * Set the number of threads OpenJPEG uses to
+			 * decode JPEG2000 images that have not been given
+			 * a number with setDecodeThreads().
+			 * @details
+			 * Tiles and code-blocks are decoded in parallel,
+			 * which shortens decoding of large images. When
+			 * many images are decoded concurrently, such as
+			 * with decodeBatch(), a single thread per image
+			 * is usually more efficient.
+			 *
+			 * Status callbacks are only called from the
+			 * thread decoding the image; messages from other
+			 * threads are discarded.
+			 *
+			 * @param[in] threads
+			 *	Number of threads, or ALL_CPUS. Defaults
+			 *	to 1.
+			 *
+			 * @note
+			 * Has no effect when OpenJPEG was built without
+			 * thread support or predates version 2.2.
+			 */
+			static void
+			setDefaultDecodeThreads(
+			    uint32_t threads);
+
+			/**
+			 * @return
+			 *	Default number of threads OpenJPEG uses to
+			 *	decode an image, or ALL_CPUS.
+			 */
+			static uint32_t
+			getDefaultDecodeThreads();
+
 			/**
 			 * Whether or not data is a JPEG-2000 image.
 			 *
@@ -84,9 +150,63 @@ namespace BiometricEvaluation
 			    const uint8_t *data,
 			    uint64_t size);
 
+		protected:
+			Memory::uint8Array
+			decodeRawData()
+			    const override;
+
+			void
+			decodeRawDataInto(
+			    uint8_t *buffer,
+			    uint64_t stride)
+			    const override;
+
+			void
+			decodeRawRows(
+			    const rowCallback_t &callback,
+			    uint32_t rowsPerChunk)
+			    const override;
+
+			Memory::uint8Array
+			decodeRegion(
+			    const ROI &region,
+			    uint8_t reduction)
+			    const override;
+
 		private:
+			/**
+			 * @brief
+			 * Decode part of the image data into a buffer.
+			 *
+			 * @param[in] region
+			 *	Region to decode, within the image.
+			 * @param[in] reduction
+			 *	Number of resolution levels to discard.
+			 * @param[in] buffer
+			 *	Buffer to hold the rows of the region.
+			 * @param[in] stride
+			 *	Number of bytes from the start of one row
+			 *	to the start of the next in buffer.
+			 *
+			 * @return
+			 *	false if the codestream has too few
+			 *	resolution levels for reduction, leaving
+			 *	buffer unmodified, true otherwise.
+			 */
+			bool
+			decode(
+			    const ROI &region,
+			    uint8_t reduction,
+			    uint8_t *buffer,
+			    uint64_t stride)
+			    const;
+
 			/** JPEG2000 codec to use (from libopenjpeg) */
 			const int8_t _codecFormat;
+			/** Decoding threads, if set for this image */
+			uint32_t _decodeThreads{ALL_CPUS};
+			/** Whether _decodeThreads was set */
+			bool _hasDecodeThreads{false};
 
 			/**
 			 * @brief
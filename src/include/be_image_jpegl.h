@@ -37,16 +37,18 @@ namespace BiometricEvaluation
 			    const statusCallback_t &statusCallback =
 			        Image::defaultStatusCallback);
 
+			JPEGL(
+			    const Memory::ByteSpan &data,
+			    const std::string &identifier = "",
+			    const statusCallback_t &statusCallback =
+			        Image::defaultStatusCallback);
+
 			~JPEGL() = default;
 
 			Memory::uint8Array
 			getRawGrayscaleData(
 			    uint8_t depth) const;
 
-			Memory::uint8Array
-			getRawData()
-			    const;
-
 			/**
 			 * Whether or not data is a Lossless JPEG image.
 			 *
@@ -65,6 +67,15 @@ namespace BiometricEvaluation
 			    uint64_t size);
 
 		protected:
+			Memory::uint8Array
+			decodeRawData()
+			    const override;
+
+			void
+			decodeRawDataInto(
+			    uint8_t *buffer,
+			    uint64_t stride)
+			    const override;
 
 		private:
 
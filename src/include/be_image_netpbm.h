@@ -54,8 +54,18 @@ namespace BiometricEvaluation
 			    const statusCallback_t &statusCallback =
 			        Image::defaultStatusCallback);
 
+			NetPBM(
+			    const Memory::ByteSpan &data,
+			    const std::string &identifier = "",
+			    const statusCallback_t &statusCallback =
+			        Image::defaultStatusCallback);
+
 			~NetPBM() = default;
 
+			uint64_t
+			getRawRowSize()
+			    const override;
+
 			/**
 		 	 * @brief
 			 * Accessor for the raw image data. The data returned
@@ -76,10 +86,6 @@ namespace BiometricEvaluation
 			 * are expanded to 8-bit.
 			 */
 			Memory::uint8Array
-			getRawData()
-			    const;
-
-			Memory::uint8Array
 			getRawGrayscaleData(
 			    uint8_t depth) const;
 
@@ -272,6 +278,17 @@ namespace BiometricEvaluation
 			    uint32_t width,
 			    uint32_t height);
 
+		protected:
+			Memory::uint8Array
+			decodeRawData()
+			    const override;
+
+			void
+			decodeRawDataInto(
+			    uint8_t *buffer,
+			    uint64_t stride)
+			    const override;
+
 		private:
 			/**
 			 * @brief
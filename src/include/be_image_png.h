@@ -37,11 +37,17 @@ namespace BiometricEvaluation
 			    const statusCallback_t &statusCallback =
 			        Image::defaultStatusCallback);
 
+			PNG(
+			    const Memory::ByteSpan &data,
+			    const std::string &identifier = "",
+			    const statusCallback_t &statusCallback =
+			        Image::defaultStatusCallback);
+
 			~PNG() = default;
 
-			Memory::uint8Array
-			getRawData()
-			    const;
+			uint64_t
+			getRawRowSize()
+			    const override;
 
 			Memory::uint8Array
 			getRawGrayscaleData(
@@ -63,6 +69,59 @@ namespace BiometricEvaluation
 			isPNG(
 			    const uint8_t *data,
 			    uint64_t size);
+
+		protected:
+			Memory::uint8Array
+			decodeRawData()
+			    const override;
+
+			void
+			decodeRawDataInto(
+			    uint8_t *buffer,
+			    uint64_t stride)
+			    const override;
+
+			void
+			decodeRawRows(
+			    const rowCallback_t &callback,
+			    uint32_t rowsPerChunk)
+			    const override;
+
+		private:
+			/**
+			 * @brief
+			 * Decode rows of raw image data into a buffer.
+			 *
+			 * @param[in] buffer
+			 *	Buffer to hold the rows being decoded: the
+			 *	whole image without callback, otherwise
+			 *	rowsPerChunk rows.
+			 * @param[in] stride
+			 *	Number of bytes from the start of one row
+			 *	to the start of the next in buffer.
+			 * @param[in] callback
+			 *	Called with buffer after each chunk of rows
+			 *	is decoded, or empty to decode the whole
+			 *	image at once.
+			 * @param[in] rowsPerChunk
+			 *	Number of rows to decode before each call of
+			 *	callback. Ignored without callback.
+			 *
+			 * @throw Error::DataError
+			 *	Error decompressing image data.
+			 */
+			void
+			readRows(
+			    uint8_t *buffer,
+			    uint64_t stride,
+			    const rowCallback_t &callback,
+			    uint32_t rowsPerChunk)
+			    const;
+
+			/** Whether the palette is expanded to RGB */
+			bool _colorPalette{false};
+			/** Whether rows are stored interlaced (Adam7) */
+			bool _interlaced{false};
 		};
 	}
 }
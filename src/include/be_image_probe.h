@@ -0,0 +1,76 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_IMAGE_PROBE_H__
+#define __BE_IMAGE_PROBE_H__
+
+#include <cstdint>
+
+#include <be_image.h>
+#include <be_memory_bytespan.h>
+
+namespace BiometricEvaluation
+{
+	namespace Image
+	{
+		/** Attributes of an image, as read by probe() */
+		struct Attributes
+		{
+			/** Compression algorithm of the image data */
+			CompressionAlgorithm compressionAlgorithm{
+			    CompressionAlgorithm::None};
+			/** Width and height, in pixels */
+			Size dimensions{};
+			/** Bits per pixel */
+			uint32_t colorDepth{0};
+			/** Bits per color component */
+			uint16_t bitDepth{0};
+			/** Resolution */
+			Resolution resolution{};
+			/** Presence of an alpha channel */
+			bool hasAlphaChannel{false};
+		};
+
+		/**
+		 * @brief
+		 * Read the attributes of encoded image data from its
+		 * headers.
+		 * @details
+		 * The attributes are those the Image subclass opened by
+		 * Image::openImage() would report, but are read without
+		 * constructing the Image, setting up a codec library, or
+		 * reading past the headers. JPEG, PNG, JPEG2000, and
+		 * TIFF headers are parsed directly; the other formats are
+		 * parsed by their Image subclass, whose constructors
+		 * already read only headers, referring to data without
+		 * copying it.
+		 *
+		 * @param[in] data
+		 *	Encoded image data, which is not copied.
+		 *
+		 * @return
+		 *	Attributes of data.
+		 *
+		 * @throw Error::StrategyError
+		 *	The compression algorithm of data could not be
+		 *	determined.
+		 * @throw Error::DataError
+		 *	The headers of data are invalid or truncated.
+		 * @throw Error::NotImplemented
+		 *	data uses a feature that the Image subclass for
+		 *	its compression algorithm does not support.
+		 */
+		Attributes
+		probe(
+		    const Memory::ByteSpan &data);
+	}
+}
+
+#endif /* __BE_IMAGE_PROBE_H__ */
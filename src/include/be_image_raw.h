@@ -47,6 +47,17 @@ namespace BiometricEvaluation
 			    const statusCallback_t &statusCallback =
 			        Image::defaultStatusCallback);
 
+			Raw(
+			    const Memory::ByteSpan &data,
+			    const Size dimensions,
+			    const uint32_t colorDepth,
+			    const uint16_t bitDepth,
+			    const Resolution resolution,
+			    const bool hasAlphaChannel,
+			    const std::string &identifier = "",
+			    const statusCallback_t &statusCallback =
+			        Image::defaultStatusCallback);
+
 			~Raw() = default;
 
 			/*
@@ -62,6 +73,17 @@ namespace BiometricEvaluation
 			    uint8_t depth) const;
 
 		protected:
+			void
+			decodeRawDataInto(
+			    uint8_t *buffer,
+			    uint64_t stride)
+			    const override;
+
+			void
+			decodeRawRows(
+			    const rowCallback_t &callback,
+			    uint32_t rowsPerChunk)
+			    const override;
 
 		private:
 
@@ -0,0 +1,189 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_IMAGE_RESAMPLE_H__
+#define __BE_IMAGE_RESAMPLE_H__
+
+#include <cstdint>
+
+#include <be_framework_enumeration.h>
+#include <be_image.h>
+#include <be_image_image.h>
+#include <be_image_raw.h>
+#include <be_memory_autoarray.h>
+
+namespace BiometricEvaluation
+{
+	namespace Image
+	{
+		/** Interpolation used when resampling */
+		enum class ResampleFilter
+		{
+			/** Mean of the source pixels covered (area) */
+			Box,
+			/** Linear interpolation between neighbors */
+			Bilinear,
+			/** Windowed sinc with three lobes */
+			Lanczos
+		};
+
+		/**
+		 * @brief
+		 * Obtain the dimensions of an image after resampling.
+		 *
+		 * @param[in] size
+		 *	Dimensions of the image.
+		 * @param[in] from
+		 *	Resolution of the image.
+		 * @param[in] to
+		 *	Resolution after resampling.
+		 *
+		 * @return
+		 *	size scaled by the ratio of to and from along each
+		 *	axis, rounded to the nearest pixel and at least 1.
+		 *
+		 * @throw Error::ParameterError
+		 *	from or to has unknown units or a resolution that
+		 *	is not positive.
+		 */
+		Size
+		getResampledSize(
+		    const Size &size,
+		    const Resolution &from,
+		    const Resolution &to);
+
+		/**
+		 * @brief
+		 * Resample raw image data to a different resolution.
+		 * @details
+		 * Rows and columns are filtered separately, with rows
+		 * divided among threads. Results are identical for any
+		 * number of threads and any instruction set used.
+		 *
+		 * @param[in] rawData
+		 *	Raw image data, as returned by
+		 *	Image::getRawData().
+		 * @param[in] rawDataSize
+		 *	Size of rawData in bytes.
+		 * @param[in] size
+		 *	Dimensions of rawData.
+		 * @param[in] colorDepth
+		 *	Bits per pixel of rawData.
+		 * @param[in] bitDepth
+		 *	Bits per component of rawData, 8 or 16.
+		 * @param[in] from
+		 *	Resolution of rawData.
+		 * @param[in] to
+		 *	Resolution to resample to.
+		 * @param[in] filter
+		 *	Interpolation to use.
+		 * @param[in] threads
+		 *	Maximum number of threads to use, or 0 for one
+		 *	per processor. Small images use fewer.
+		 *
+		 * @return
+		 *	Raw image data of getResampledSize(size, from, to)
+		 *	pixels, in the format of rawData.
+		 *
+		 * @throw Error::NotImplemented
+		 *	bitDepth is not 8 or 16.
+		 * @throw Error::ParameterError
+		 *	Resolutions are invalid, or rawData is too small
+		 *	for size and colorDepth.
+		 */
+		Memory::uint8Array
+		resample(
+		    const uint8_t *rawData,
+		    const uint64_t rawDataSize,
+		    const Size &size,
+		    const uint32_t colorDepth,
+		    const uint16_t bitDepth,
+		    const Resolution &from,
+		    const Resolution &to,
+		    const ResampleFilter filter = ResampleFilter::Lanczos,
+		    const uint32_t threads = 0);
+
+		/**
+		 * @brief
+		 * Resample an image to a different resolution.
+		 * @details
+		 * As resample() of raw data, for images whose encoded
+		 * resolution is missing or wrong, such as those whose
+		 * resolution is recorded in a biometric record.
+		 *
+		 * @param[in] image
+		 *	Image to resample.
+		 * @param[in] from
+		 *	Resolution of image, used in place of
+		 *	image.getResolution().
+		 * @param[in] to
+		 *	Resolution to resample to.
+		 * @param[in] filter
+		 *	Interpolation to use.
+		 * @param[in] threads
+		 *	Maximum number of threads to use, or 0 for one
+		 *	per processor. Small images use fewer.
+		 *
+		 * @return
+		 *	Resampled image, with resolution to.
+		 *
+		 * @throw Error::NotImplemented
+		 *	Bit depth of image is not 8 or 16.
+		 * @throw Error::ParameterError
+		 *	Resolutions are invalid.
+		 * @throw Error::DataError
+		 *	Error decoding image.
+		 */
+		Raw
+		resample(
+		    const Image &image,
+		    const Resolution &from,
+		    const Resolution &to,
+		    const ResampleFilter filter = ResampleFilter::Lanczos,
+		    const uint32_t threads = 0);
+
+		/**
+		 * @brief
+		 * Resample an image to a different resolution.
+		 *
+		 * @param[in] image
+		 *	Image to resample, from image.getResolution().
+		 * @param[in] to
+		 *	Resolution to resample to.
+		 * @param[in] filter
+		 *	Interpolation to use.
+		 * @param[in] threads
+		 *	Maximum number of threads to use, or 0 for one
+		 *	per processor. Small images use fewer.
+		 *
+		 * @return
+		 *	Resampled image, with resolution to.
+		 *
+		 * @throw Error::NotImplemented
+		 *	Bit depth of image is not 8 or 16.
+		 * @throw Error::ParameterError
+		 *	Resolutions are invalid.
+		 * @throw Error::DataError
+		 *	Error decoding image.
+		 */
+		Raw
+		resample(
+		    const Image &image,
+		    const Resolution &to,
+		    const ResampleFilter filter = ResampleFilter::Lanczos,
+		    const uint32_t threads = 0);
+	}
+}
+
+BE_FRAMEWORK_ENUMERATION_DECLARATIONS(
+    BiometricEvaluation::Image::ResampleFilter,
+    BE_Image_ResampleFilter_EnumToStringMap);
+
+#endif /* __BE_IMAGE_RESAMPLE_H__ */
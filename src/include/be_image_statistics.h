@@ -0,0 +1,149 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_IMAGE_STATISTICS_H__
+#define __BE_IMAGE_STATISTICS_H__
+
+#include <cstdint>
+#include <vector>
+
+#include <be_image.h>
+#include <be_image_image.h>
+
+namespace BiometricEvaluation
+{
+	namespace Image
+	{
+		/** Parameters of computeStatistics() */
+		struct StatisticsOptions
+		{
+			/**
+			 * Width and height of the square blocks of
+			 * Statistics::blockVariance, or 0 to not compute
+			 * it.
+			 */
+			uint32_t blockSize{0};
+			/**
+			 * Largest standard deviation, in sample values,
+			 * of an image considered blank.
+			 */
+			double blankThreshold{2.0};
+		};
+
+		/** Statistics of the samples of a grayscale image */
+		struct Statistics
+		{
+			/** Bits per sample, 8 or 16 */
+			uint8_t depth{};
+			/** Number of samples */
+			uint64_t count{};
+			/** Smallest sample */
+			uint16_t minimum{};
+			/** Largest sample */
+			uint16_t maximum{};
+			/** Mean of the samples */
+			double mean{};
+			/** Population variance of the samples */
+			double variance{};
+			/**
+			 * Whether the standard deviation of the samples
+			 * is at most StatisticsOptions::blankThreshold.
+			 */
+			bool blank{};
+			/**
+			 * Number of samples of each value: 256 bins for
+			 * 8-bit samples and 65536 for 16-bit.
+			 */
+			std::vector<uint64_t> histogram{};
+
+			/** StatisticsOptions::blockSize */
+			uint32_t blockSize{};
+			/** Number of blocks across and down the image */
+			Size blockMapSize{};
+			/**
+			 * Population variance of the samples of each
+			 * block, a row of blocks at a time. Blocks at the
+			 * right and bottom edges may be smaller than
+			 * blockSize. Foreground, such as friction ridges,
+			 * varies more than background.
+			 */
+			std::vector<float> blockVariance{};
+		};
+
+		/**
+		 * @brief
+		 * Compute statistics of a grayscale raster.
+		 *
+		 * @param[in] gray
+		 *	Grayscale samples, as returned by
+		 *	Image::getRawGrayscaleData().
+		 * @param[in] size
+		 *	Dimensions of gray.
+		 * @param[in] depth
+		 *	Bits per sample of gray, 8 or 16.
+		 * @param[in] options
+		 *	What to compute.
+		 *
+		 * @return
+		 *	Statistics of gray.
+		 *
+		 * @throw Error::ParameterError
+		 *	depth is not 8 or 16, or size is empty.
+		 */
+		Statistics
+		computeStatistics(
+		    const uint8_t *gray,
+		    const Size &size,
+		    const uint8_t depth,
+		    const StatisticsOptions &options = StatisticsOptions());
+
+		/**
+		 * @brief
+		 * Compute statistics of an image in grayscale.
+		 * @details
+		 * Rows are converted to gray as they are decoded, with
+		 * Image::decodeRows(), so neither the decoded image nor
+		 * its grayscale conversion is held in memory at once
+		 * when the codec decodes incrementally.
+		 *
+		 * Raw data is converted as by the Image implementation
+		 * of getRawGrayscaleData(). Codecs that convert to gray
+		 * while decoding, such as JPEG, may differ slightly
+		 * from their own getRawGrayscaleData(). Gray samples
+		 * packed 1, 2, or 4 bits to a byte are unpacked and
+		 * scaled to 8 bits first.
+		 *
+		 * @param[in] image
+		 *	Image whose statistics are computed.
+		 * @param[in] depth
+		 *	Bits per sample to convert image to, 8 or 16,
+		 *	as Image::getRawGrayscaleData().
+		 * @param[in] options
+		 *	What to compute.
+		 *
+		 * @return
+		 *	Statistics of the raw data of image, in gray.
+		 *
+		 * @throw Error::ParameterError
+		 *	depth is not 8 or 16, or image is empty.
+		 * @throw Error::NotImplemented
+		 *	Color depth of image cannot be converted to gray.
+		 * @throw Error::DataError
+		 *	Error decoding image.
+		 */
+		Statistics
+		computeStatistics(
+		    const Image &image,
+		    const uint8_t depth = 8,
+		    const StatisticsOptions &options = StatisticsOptions());
+	}
+}
+
+#endif /* __BE_IMAGE_STATISTICS_H__ */
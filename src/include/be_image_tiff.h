@@ -35,11 +35,13 @@ namespace BiometricEvaluation
 			    const statusCallback_t &statusCallback =
 			        Image::defaultStatusCallback);
 
-			~TIFF() = default;
+			TIFF(
+			    const Memory::ByteSpan &data,
+			    const std::string &identifier = "",
+			    const statusCallback_t &statusCallback =
+			        Image::defaultStatusCallback);
 
-			Memory::uint8Array
-			getRawData()
-			    const;
+			~TIFF() = default;
 
 			Memory::uint8Array
 			getRawGrayscaleData(
@@ -108,6 +110,23 @@ namespace BiometricEvaluation
 				const TIFF *tiffObject{nullptr};
 			};
 
+		protected:
+			Memory::uint8Array
+			decodeRawData()
+			    const override;
+
+			void
+			decodeRawDataInto(
+			    uint8_t *buffer,
+			    uint64_t stride)
+			    const override;
+
+			void
+			decodeRawRows(
+			    const rowCallback_t &callback,
+			    uint32_t rowsPerChunk)
+			    const override;
+
 		private:
 
 			/**
@@ -11,6 +11,8 @@
 #ifndef __BE_IMAGE_WSQ__
 #define __BE_IMAGE_WSQ__
 
+#include <vector>
+
 #include <be_image_image.h>
 
 namespace BiometricEvaluation
@@ -37,16 +39,79 @@ namespace BiometricEvaluation
 			    const statusCallback_t &statusCallback =
 			        Image::defaultStatusCallback);
 
-			~WSQ() = default;
+			WSQ(
+			    const Memory::ByteSpan &data,
+			    const std::string &identifier = "",
+			    const statusCallback_t &statusCallback =
+			        Image::defaultStatusCallback);
 
-			Memory::uint8Array
-			getRawData()
-			    const;
+			~WSQ() = default;
 
 			Memory::uint8Array
 			getRawGrayscaleData(
 			    uint8_t depth) const;
 
+			/**
+			 * @brief
+			 * Crop this image without reconstructing its pixels.
+			 * @details
+			 * The quantized wavelet coefficients covering roi
+			 * are kept and Huffman coded again, which costs a
+			 * fraction of decoding, cropping, and re-encoding,
+			 * and quantizes nothing a second time. Pixels near
+			 * edges of the crop that were not edges of this
+			 * image are reconstructed without the coefficients
+			 * beyond them and may differ noticeably from this
+			 * image, so pad regions where that matters.
+			 *
+			 * WSQ subbands are aligned to 32 pixels, so the
+			 * upper-left corner of roi is moved up and left to
+			 * the nearest multiple of 32. Portions of roi past
+			 * the edges of the image are clipped. Tables and
+			 * comments, including NISTCOM, are copied unchanged.
+			 *
+			 * @param[in] roi
+			 *	Region to crop. The path is ignored.
+			 *
+			 * @return
+			 *	WSQ image of the cropped region.
+			 *
+			 * @throw Error::ParameterError
+			 *	roi is empty or outside of the image.
+			 * @throw Error::DataError
+			 *	Could not crop the image.
+			 */
+			Memory::uint8Array
+			crop(
+			    const ROI &roi)
+			    const;
+
+			/**
+			 * @brief
+			 * Crop several regions of this image without
+			 * reconstructing its pixels.
+			 * @details
+			 * As crop(const ROI&), but the coefficients are
+			 * decoded once for all regions, such as when
+			 * segmenting a slap into individual fingers.
+			 *
+			 * @param[in] rois
+			 *	Regions to crop. Paths are ignored.
+			 *
+			 * @return
+			 *	WSQ images of the cropped regions, in the
+			 *	order of rois.
+			 *
+			 * @throw Error::ParameterError
+			 *	A region is empty or outside of the image.
+			 * @throw Error::DataError
+			 *	Could not crop the image.
+			 */
+			std::vector<Memory::uint8Array>
+			crop(
+			    const std::vector<ROI> &rois)
+			    const;
+
 			/**
 			 * Whether or not data is a WSQ image.
 			 *
@@ -65,6 +130,15 @@ namespace BiometricEvaluation
 			    uint64_t size);
 
 		protected:
+			Memory::uint8Array
+			decodeRawData()
+			    const override;
+
+			void
+			decodeRawDataInto(
+			    uint8_t *buffer,
+			    uint64_t stride)
+			    const override;
 
 		private:
 
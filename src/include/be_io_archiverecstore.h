@@ -93,11 +93,13 @@ namespace BiometricEvaluation {
 			 */
 
 			/*
-                         * We need the base class insert() and replace() as well
-			 * otherwise, they are hidden by the declarations below.
+                         * We need the base class insert(), replace(), and read()
+			 * as well, otherwise they are hidden by the
+			 * declarations below.
                          */
                         using RecordStore::insert;
                         using RecordStore::replace;
+                        using RecordStore::read;
 
 			void sync() const override;
 
@@ -114,6 +116,10 @@ namespace BiometricEvaluation {
 			Memory::uint8Array read(
 			    const std::string &key) const override;
 
+			std::vector<Memory::uint8Array> read(
+			    const std::vector<std::string> &keys) const
+			    override;
+
 			uint64_t length(
 			    const std::string &key) const override;
 
@@ -144,6 +150,10 @@ namespace BiometricEvaluation {
 			void changeDescription(
                             const std::string &description) override;
 
+			void setChecksumVerification(
+			    bool verify) override;
+			bool getChecksumVerification() const override;
+
 			/**
 			 * See if the ArchiveRecordStore would benefit from
 			 * calling vacuum() to remove deleted entries, since
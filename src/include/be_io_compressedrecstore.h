@@ -107,11 +107,13 @@ namespace BiometricEvaluation
 			 */
 
 			/*
-                         * We need the base class insert() and replace() as well
-			 * otherwise, they are hidden by the declarations below.
+                         * We need the base class insert(), replace(), and read()
+			 * as well, otherwise they are hidden by the
+			 * declarations below.
                          */
                         using RecordStore::insert;
                         using RecordStore::replace;
+                        using RecordStore::read;
 
 			uint64_t
 			getSpaceUsed() const override;
@@ -165,6 +167,16 @@ namespace BiometricEvaluation
 			    const std::string &pathname)
 			    override;
 
+			void
+			setChecksumVerification(
+			    bool verify)
+			    override;
+
+			bool
+			getChecksumVerification()
+			    const
+			    override;
+
 			/**
 			 * @brief
 			 * Copy constructor (disabled).
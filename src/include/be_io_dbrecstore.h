@@ -74,11 +74,13 @@ namespace BiometricEvaluation {
 			 */
 
 			/*
-                         * We need the base class insert() and replace() as well
-			 * otherwise, they are hidden by the declarations below.
+                         * We need the base class insert(), replace(), and read()
+			 * as well, otherwise they are hidden by the
+			 * declarations below.
                          */
                         using RecordStore::insert;
                         using RecordStore::replace;
+                        using RecordStore::read;
 
 			Memory::uint8Array
 			read(
@@ -125,6 +127,10 @@ namespace BiometricEvaluation {
 			void changeDescription(
                             const std::string &description) override;
 
+			void setChecksumVerification(
+			    bool verify) override;
+			bool getChecksumVerification() const override;
+
 			/* Prevent copying of DBRecordStore objects */
 			DBRecordStore(const DBRecordStore&) = delete;
 			DBRecordStore& operator=(const DBRecordStore&) = delete;
@@ -0,0 +1,312 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_IO_DEDUPLICATEDRECSTORE_H__
+#define __BE_IO_DEDUPLICATEDRECSTORE_H__
+
+#include <memory>
+#include <be_io_recordstore.h>
+
+namespace BiometricEvaluation
+{
+	namespace IO
+	{
+		/**
+		 * @brief
+		 * Sibling-implemented IO::RecordStore that stores each
+		 * unique value only once.
+		 * @details
+		 * Every value inserted is identified by a message digest of
+		 * its contents (its "content ID"). The value is written to an
+		 * internal RecordStore keyed by content ID the first time it
+		 * is seen. Subsequent inserts of the same bytes, under any
+		 * key, only record the key to content ID mapping and
+		 * increment a reference count. The value is removed from
+		 * storage when the last key referencing it is removed.
+		 *
+		 * Clients see an ordinary RecordStore: read() and length()
+		 * for every key return the value inserted under that key.
+		 *
+		 * @note
+		 * To keep inserts cheap, the key to content ID mappings
+		 * and the reference counts of values already stored are
+		 * written to storage by sync(), by sequencing, and on
+		 * destruction. A value's reference count is written
+		 * together with the value itself when it is first
+		 * stored or last removed. If the process ends without
+		 * a sync(), records inserted since the last sync() may
+		 * be lost, and their values may remain in storage
+		 * until they are inserted and removed again. A value
+		 * is never removed while a key written to storage
+		 * refers to it.
+		 */
+		class DeduplicatedRecordStore : public RecordStore
+		{
+		public:
+			/** Space used by a DeduplicatedRecordStore */
+			struct SpaceStatistics
+			{
+				/** getSpaceUsed() */
+				uint64_t spaceUsed{0};
+				/** getLogicalSize() */
+				uint64_t logicalSize{0};
+				/** getUniqueSize() */
+				uint64_t uniqueSize{0};
+				/**
+				 * Estimated space used were every record
+				 * stored separately: spaceUsed plus the
+				 * size of the duplicate values.
+				 */
+				uint64_t undeduplicatedSpace{0};
+				/** getDeduplicationRatio() */
+				double deduplicationRatio{1.0};
+				/**
+				 * undeduplicatedSpace / spaceUsed, the
+				 * savings of deduplication including the
+				 * space of the content ID mappings.
+				 */
+				double spaceRatio{1.0};
+			};
+
+			/**
+			 * Create a new DeduplicatedRecordStore, read/write
+			 * mode.
+			 *
+			 * @param[in] pathname
+			 * 	The directory where the store is to be created.
+			 * @param[in] description
+			 *	The store's description.
+			 * @param[in] recordStoreType
+			 *	The type of RecordStore subclass the internal
+			 *	RecordStores should be.
+			 * @param[in] digest
+			 *	Message digest used to compute content IDs.
+			 *	Any digest supported by Text::digest() may
+			 *	be used.
+			 *
+			 * @throw Error::ObjectExists
+			 * 	The store already exists.
+			 * @throw Error::StrategyError
+			 * 	An error occurred when accessing the underlying
+			 * 	file system, or digest is not supported.
+			 */
+			DeduplicatedRecordStore(
+			    const std::string &pathname,
+			    const std::string &description,
+			    const RecordStore::Kind &recordStoreType,
+			    const std::string &digest = "sha256");
+
+			/**
+			 * Open an existing DeduplicatedRecordStore.
+			 *
+			 * @param[in] pathname
+			 *	The path name of the store.
+			 * @param[in] mode
+			 *	Open mode, read-only or read-write.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	The store does not exist.
+			 * @throw Error::StrategyError
+			 *	An error occurred when accessing the underlying
+			 *	file system.
+			 */
+			DeduplicatedRecordStore(
+			    const std::string &pathname,
+			    IO::Mode mode = IO::Mode::ReadOnly);
+
+			/*
+			 * Destructor.
+			 */
+			~DeduplicatedRecordStore();
+
+			/*
+			 * Implementation of the RecordStore interface.
+			 */
+
+			/*
+			 * We need the base class insert(), replace(), and read()
+			 * as well, otherwise they are hidden by the
+			 * declarations below.
+			 */
+			using RecordStore::insert;
+			using RecordStore::replace;
+			using RecordStore::read;
+
+			/**
+			 * @brief
+			 * Obtain real storage utilization.
+			 * @details
+			 * Only unique values contribute to the space used,
+			 * which is less than the sum of the record lengths
+			 * by about getDeduplicationRatio(). The content ID
+			 * of each key and the reference counts are
+			 * included. See getSpaceStatistics() for how the
+			 * space used compares to storing each record
+			 * separately.
+			 *
+			 * @return
+			 *	The amount of backing storage used by
+			 *	the RecordStore.
+			 * @throw Error::StrategyError
+			 *	An error occurred when using the underlying
+			 *	storage system.
+			 */
+			uint64_t
+			getSpaceUsed() const override;
+			void sync() const override;
+			unsigned int getCount() const override;
+			std::string getPathname() const override;
+			std::string getDescription() const override;
+			void changeDescription(
+			    const std::string &description) override;
+
+			void
+			insert(
+			    const std::string &key,
+			    const void *const data,
+			    const uint64_t size)
+			    override;
+
+			void
+			remove(
+			    const std::string &key) override;
+
+			Memory::uint8Array
+			read(
+			    const std::string &key) const override;
+
+			uint64_t
+			length(
+			    const std::string &key) const override;
+
+			void
+			flush(
+			    const std::string &key) const override;
+
+			RecordStore::Record
+			sequence(
+			    int cursor = BE_RECSTORE_SEQ_NEXT)
+			    override;
+
+			std::string
+			sequenceKey(
+			    int cursor = BE_RECSTORE_SEQ_NEXT)
+			    override;
+
+			void
+			setCursorAtKey(
+			    const std::string &key)
+			    override;
+
+			void
+			move(
+			    const std::string &pathname)
+			    override;
+
+			void
+			setChecksumVerification(
+			    bool verify)
+			    override;
+
+			bool
+			getChecksumVerification()
+			    const
+			    override;
+
+			/**
+			 * @return
+			 *	Number of unique values held in the store.
+			 */
+			uint64_t
+			getUniqueCount()
+			    const;
+
+			/**
+			 * @return
+			 *	Sum of the lengths of all records, as if
+			 *	each were stored separately.
+			 */
+			uint64_t
+			getLogicalSize()
+			    const;
+
+			/**
+			 * @return
+			 *	Sum of the lengths of the unique values
+			 *	actually stored.
+			 */
+			uint64_t
+			getUniqueSize()
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain the space savings realized by deduplication.
+			 *
+			 * @return
+			 *	getLogicalSize() / getUniqueSize(), or 1.0
+			 *	if the store holds no data.
+			 */
+			double
+			getDeduplicationRatio()
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain the space used, and saved, by
+			 * deduplication.
+			 *
+			 * @return
+			 *	Space used by the store and by its records.
+			 * @throw Error::StrategyError
+			 *	An error occurred when using the underlying
+			 *	storage system.
+			 */
+			SpaceStatistics
+			getSpaceStatistics()
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain the content ID of the value stored for key.
+			 * @details
+			 * Records with identical values share a content ID.
+			 *
+			 * @param[in] key
+			 *	The key of the record.
+			 * @return
+			 *	Content ID of key's value.
+			 * @throw Error::ObjectDoesNotExist
+			 *	A record for the key does not exist.
+			 * @throw Error::StrategyError
+			 *	An error occurred when using the underlying
+			 *	storage system.
+			 */
+			std::string
+			getContentID(
+			    const std::string &key)
+			    const;
+
+			/** Copy constructor (disabled). */
+			DeduplicatedRecordStore(
+			    const DeduplicatedRecordStore &rhs) = delete;
+
+			/** Assignment operator (disabled). */
+			DeduplicatedRecordStore&
+			operator=(
+			    const DeduplicatedRecordStore &rhs) = delete;
+
+		private:
+			class Impl;
+			std::unique_ptr<DeduplicatedRecordStore::Impl> pimpl;
+		};
+	}
+}
+#endif	/* __BE_IO_DEDUPLICATEDRECSTORE_H__ */
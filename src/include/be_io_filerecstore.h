@@ -76,11 +76,13 @@ namespace BiometricEvaluation {
 			 */
 
 			/*
-                         * We need the base class insert() and replace() as well
-			 * otherwise, they are hidden by the declarations below.
+                         * We need the base class insert(), replace(), and read()
+			 * as well, otherwise they are hidden by the
+			 * declarations below.
                          */
                         using RecordStore::insert;
                         using RecordStore::replace;
+                        using RecordStore::read;
 
 			void insert(
 			    const std::string &key,
@@ -95,6 +97,10 @@ namespace BiometricEvaluation {
 			Memory::uint8Array read(
 			    const std::string &key) const override;
 
+			std::vector<Memory::uint8Array> read(
+			    const std::vector<std::string> &keys) const
+			    override;
+
 			void replace(
 			    const std::string &key,
 			    const void *const data,
@@ -131,6 +137,10 @@ namespace BiometricEvaluation {
 			void changeDescription(
 			    const std::string &description) override;
 
+			void setChecksumVerification(
+			    bool verify) override;
+			bool getChecksumVerification() const override;
+
 			/* Prevent copying of FileRecordStore objects */
 			FileRecordStore(const FileRecordStore&) = delete;
 			FileRecordStore& operator=(const FileRecordStore&) =
@@ -62,11 +62,13 @@ namespace BiometricEvaluation
 			 */
 
 			/*
-                         * We need the base class insert() and replace() as well
-			 * otherwise, they are hidden by the declarations below.
+                         * We need the base class insert(), replace(), and read()
+			 * as well, otherwise they are hidden by the
+			 * declarations below.
                          */
                         using RecordStore::insert;
                         using RecordStore::replace;
+                        using RecordStore::read;
 
 			void
 			insert(
@@ -131,6 +133,10 @@ namespace BiometricEvaluation
 			void changeDescription(
                             const std::string &description) override;
 
+			void setChecksumVerification(
+			    bool verify) override;
+			bool getChecksumVerification() const override;
+
 		private:
 			class Impl;
 			std::unique_ptr<ListRecordStore::Impl> pimpl;
@@ -10,6 +10,7 @@
 #ifndef __BE_IO_RECORDSTORE_H__
 #define __BE_IO_RECORDSTORE_H__
 
+#include <deque>
 #include <functional>
 #include <memory>
 #include <string>
@@ -46,7 +47,7 @@ namespace BiometricEvaluation {
 		 *
 		 * \see
 		 * IO::ArchiveRecordStore, IO::DBRecordStore,
-		 * IO::FileRecordStore.
+		 * IO::FileRecordStore, IO::DeduplicatedRecordStore.
 		 */
 		class RecordStore {
 		public:
@@ -89,6 +90,8 @@ namespace BiometricEvaluation {
 				Compressed,
 				/** ListRecordStore */
 				List,
+				/** DeduplicatedRecordStore */
+				Deduplicated,
 
 				/** "Default" RecordStore kind */
 				Default = BerkeleyDB
@@ -248,6 +251,9 @@ namespace BiometricEvaluation {
 			 *	The key of the record to be read.
 			 * @return
 			 *	The record associated with the key.
+			 * @throw Error::DataError
+			 *	Checksum verification is enabled and the
+			 *	record does not match its checksum.
 			 * @throw Error::ObjectDoesNotExist
 			 *	A record for the key does not exist.
 			 * @throw Error::StrategyError
@@ -258,6 +264,33 @@ namespace BiometricEvaluation {
 			read(
 			    const std::string &key) const = 0;
 
+			/**
+			 * @brief
+			 * Read many complete records from a store.
+			 * @details
+			 * Implementations may read records concurrently and
+			 * in storage order, which is considerably faster than
+			 * calling read() for each key when keys are not
+			 * in sequence order.
+			 *
+			 * @param[in] keys
+			 *	The keys of the records to be read.
+			 * @return
+			 *	The records associated with keys, in the
+			 *	same order as keys.
+			 * @throw Error::DataError
+			 *	Checksum verification is enabled and a
+			 *	record does not match its checksum.
+			 * @throw Error::ObjectDoesNotExist
+			 *	A record for a key does not exist.
+			 * @throw Error::StrategyError
+			 *	An error occurred when using the underlying
+			 *	storage system.
+			 */
+			virtual std::vector<Memory::uint8Array>
+			read(
+			    const std::vector<std::string> &keys) const;
+
 			/**
 			 * Replace a complete record in a RecordStore.
 			 *
@@ -436,6 +469,63 @@ namespace BiometricEvaluation {
 			end()
 			    noexcept;
 
+			/**
+			 * @brief
+			 * Set whether records are verified when read.
+			 * @details
+			 * A CRC-32C checksum of each record is kept when the
+			 * record is stored. When verification is enabled,
+			 * read() and sequence() throw Error::DataError for
+			 * records that no longer match their checksum.
+			 * Records stored before checksums were kept cannot
+			 * be verified. Verification is disabled by default.
+			 *
+			 * @param[in] verify
+			 *	true to verify records when read, false
+			 *	otherwise.
+			 *
+			 * @throw Error::NotImplemented
+			 *	verify is true and the implementation does
+			 *	not keep checksums, which is the default.
+			 */
+			virtual void
+			setChecksumVerification(
+			    bool verify);
+
+			/**
+			 * @return
+			 *	Whether records are verified when read.
+			 *	The default implementation returns false.
+			 */
+			virtual bool
+			getChecksumVerification()
+			    const;
+
+			/**
+			 * @brief
+			 * Verify the checksum of every record.
+			 * @details
+			 * The RecordStore is synced, then records are read
+			 * concurrently by independent read-only instances of
+			 * the RecordStore. The sequence cursor of this object
+			 * is not changed.
+			 *
+			 * @param[in] numThreads
+			 *	Number of threads reading records, or 0 for
+			 *	one thread per CPU.
+			 * @return
+			 *	Keys of records that do not match their
+			 *	checksum or could not be read, in sequence
+			 *	order.
+			 * @throw Error::StrategyError
+			 *	An error occurred when using the underlying
+			 *	storage system.
+			 */
+			std::vector<std::string>
+			verify(
+			    uint32_t numThreads = 0)
+			    const;
+
 			/**
 			 * @brief
 			 * Open an existing RecordStore and return a managed
@@ -558,8 +648,14 @@ namespace BiometricEvaluation {
 		 * Modifying a non-const iterator does not manipulate the
 		 * underlying RecordStore.
 		 * @note
-		 * This generic iterator provides no optimization over
-		 * RecordStore::sequence().
+		 * Records are read ahead in batches with
+		 * RecordStore::read(const std::vector<std::string>&),
+		 * which ArchiveRecordStore and FileRecordStore service
+		 * with a deep queue of reads in storage order. The
+		 * RecordStore's sequence cursor is therefore ahead of the
+		 * iterator, and an error reading any record of a batch is
+		 * thrown when the batch is read. Copies of an iterator
+		 * share the records read ahead, as they share the cursor.
 		 */
 		class RecordStoreIterator
 		{
@@ -720,11 +816,23 @@ namespace BiometricEvaluation {
 			bool _atEnd{true};
 			/** Current record returned when dereferencing */
 			value_type _currentRecord{};
+			/** Records read ahead of _currentRecord */
+			std::shared_ptr<std::deque<value_type>> _prefetched{};
 
 			/** Iterate the first object. */
 			void
 			setBegin();
 
+			/**
+			 * @brief
+			 * Read the next batch of records into _prefetched.
+			 * @details
+			 * _prefetched is left empty at the end of the
+			 * RecordStore.
+			 */
+			void
+			prefetch();
+
 			/**
 			 * @brief
 			 * Advance through the RecordStore.
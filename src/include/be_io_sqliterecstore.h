@@ -34,11 +34,13 @@ namespace BiometricEvaluation
 			    IO::Mode mode = Mode::ReadOnly);
 
 			/*
-                         * We need the base class insert() and replace() as well
-			 * otherwise, they are hidden by the declarations below.
+                         * We need the base class insert(), replace(), and read()
+			 * as well, otherwise they are hidden by the
+			 * declarations below.
                          */
                         using RecordStore::insert;
                         using RecordStore::replace;
+                        using RecordStore::read;
 
 			void
 			move(
@@ -97,6 +99,16 @@ namespace BiometricEvaluation
 			    const std::string &key)
 			    override;
 
+			void
+			setChecksumVerification(
+			    bool verify)
+			    override;
+
+			bool
+			getChecksumVerification()
+			    const
+			    override;
+
 			~SQLiteRecordStore();
 
 			SQLiteRecordStore(const SQLiteRecordStore&) = delete;
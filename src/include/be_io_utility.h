@@ -18,6 +18,7 @@
 
 #include <be_error_exception.h>
 #include <be_memory_autoarray.h>
+#include <be_memory_bytespan.h>
 #include <be_sysdeps.h>
 
 namespace BiometricEvaluation
@@ -224,6 +225,34 @@ namespace BiometricEvaluation
 			readFile(
 			    const std::string &path,
 			    std::ios_base::openmode mode = std::ios_base::binary);
+
+			/**
+			 * @brief
+			 * Map the contents of a file into memory, read-only.
+			 * @details
+			 * Pages of the file are read when first accessed,
+			 * so files larger than memory can be processed, and
+			 * only the parts used are read. The file must not
+			 * be truncated while mapped. Where mapping is not
+			 * supported, the file is read as by readFile().
+			 *
+			 * @param path
+			 *	Path to a file to be mapped.
+			 *
+			 * @return
+			 *	Contents of path, sharing ownership of the
+			 *	mapping, which is removed when the last span
+			 *	referring to it is destroyed.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	path does not exist.
+			 * @throw Error::StrategyError
+			 *	An error occurred when using the underlying
+			 *	storage system.
+			 */
+			Memory::ByteSpan
+			mapFile(
+			    const std::string &path);
 			
 			/**
 			 * @brief
@@ -20,12 +20,15 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <limits>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include <be_error_exception.h>
 #include <be_memory_autoarrayiterator.h>
+#include <be_memory_bufferpool.h>
 
 namespace BiometricEvaluation
 {
@@ -39,6 +42,13 @@ namespace BiometricEvaluation
 		 * manner for containers, where (size_type) construction creates
 		 * an array of the given size, while {...} construction creates
 		 * an array with the given elements.
+		 *
+		 * As with new[], elements of trivial types are left
+		 * uninitialized by (size_type) construction and resize(),
+		 * so buffers that are about to be filled are not written
+		 * twice. Storage of trivial types may also come from the
+		 * calling thread's BufferPool (see Allocation), which
+		 * recycles buffers of similar size.
 		 */
 		template<class T> 
 		class AutoArray
@@ -250,6 +260,11 @@ namespace BiometricEvaluation
 				/**
 				 * @brief
 				 * Change the number of accessible elements.
+				 * @details
+				 * When growing beyond the allocated size, at
+				 * least double the allocated size is reserved,
+				 * so that repeated growth copies each element
+				 * a constant number of times on average.
 				 *
 				 * @param[in] new_size
 				 *	The number of elements the AutoArray
@@ -257,7 +272,8 @@ namespace BiometricEvaluation
 				 * @param[in] free
 				 *	Whether or not excess memory should be
 				 *	freed if the new size is smaller than
-				 *	the current size.
+				 *	the current size. When true, exactly
+				 *	new_size elements are allocated.
 				 *
 				 * @throw Error::MemoryError
 				 *	Problem allocating memory.
@@ -344,6 +360,26 @@ namespace BiometricEvaluation
 				explicit AutoArray(
 				    size_type size = 0);
 
+				/**
+				 * @brief
+				 * Construct an AutoArray.
+				 *
+				 * @param[in] size
+				 *	The number of elements this AutoArray
+				 *	should initially hold.
+				 * @param[in] allocation
+				 *	Source of storage for this AutoArray,
+				 *	now and when resized. Types that are
+				 *	not trivial always use
+				 *	Allocation::Default.
+				 *
+				 * @throw Error::MemoryError
+				 *	Could not allocate new memory.
+				 */
+				AutoArray(
+				    size_type size,
+				    Allocation allocation);
+
 				/**
 				 * @brief
 				 * Construct an AutoArray.
@@ -351,6 +387,8 @@ namespace BiometricEvaluation
 				 * @param[in] copy
 				 *	An AutoArray whose contents will be 
 				 *	deep copied into the new AutoArray.
+				 *	Storage for the copy is obtained with
+				 *	Allocation::Default.
 				 *
 				 * @throw Error::MemoryError
 				 *	Could not allocate new memory.
@@ -435,6 +473,50 @@ namespace BiometricEvaluation
 				size_type _size;
 				/** Actual size of _data */
 				size_type _capacity;
+				/** Source of _data */
+				Allocation _allocation;
+
+				/**
+				 * @brief
+				 * Obtain storage for elements.
+				 *
+				 * @param[in] size
+				 *	Minimum number of elements.
+				 * @param[in] allocation
+				 *	Source of storage.
+				 * @param[out] capacity
+				 *	Number of elements allocated.
+				 *
+				 * @return
+				 *	Storage for capacity elements, or
+				 *	nullptr if size is 0.
+				 *
+				 * @throw Error::MemoryError
+				 *	Could not allocate new memory.
+				 */
+				static T*
+				allocate(
+				    size_type size,
+				    Allocation allocation,
+				    size_type &capacity);
+
+				/**
+				 * @brief
+				 * Release storage obtained from allocate().
+				 *
+				 * @param[in] data
+				 *	Storage to release.
+				 * @param[in] capacity
+				 *	Number of elements in data.
+				 * @param[in] allocation
+				 *	Source of data.
+				 */
+				static void
+				deallocate(
+				    T *data,
+				    size_type capacity,
+				    Allocation allocation)
+				    noexcept;
 		};
 
 		/**************************************************************/
@@ -511,22 +593,23 @@ BiometricEvaluation::Memory::AutoArray<T>::resize(
 		return;
 	}
 
-	T* new_data = nullptr;
-	if (new_size != 0) {
-		new_data = new (std::nothrow) T[new_size];
-		if (new_data == nullptr)
-			throw Error::MemoryError("Could not allocate data");
-	}
+	/* Grow geometrically so that appending is amortized */
+	size_type requested = new_size;
+	if (!free && (_capacity <= (std::numeric_limits<size_type>::max() / 2)))
+		requested = std::max(new_size, _capacity * 2);
+
+	size_type new_capacity;
+	T* new_data = allocate(requested, _allocation, new_capacity);
 
-	/* Copy as much data as will fit into the new buffer */
-	std::copy(&_data[0], &_data[((new_size < _size) ? new_size : _size)],
+	/* Move as much data as will fit into the new buffer */
+	std::move(&_data[0], &_data[((new_size < _size) ? new_size : _size)],
 	    new_data);
 
 	/* Delete the old buffer and assign the new buffer to this object */
-	if (_data != nullptr)
-		delete [] _data;
+	deallocate(_data, _capacity, _allocation);
 	_data = new_data;
-	_size = _capacity = new_size;
+	_size = new_size;
+	_capacity = new_capacity;
 }
 
 template<class T>
@@ -623,19 +706,15 @@ BiometricEvaluation::Memory::AutoArray<T>::operator=(
     const BiometricEvaluation::Memory::AutoArray<T> &other)
 {
 	if (this != &other) {
-		_size = _capacity = other._size;
-		if (_data != nullptr) {
-			delete [] _data;
-			_data = nullptr;
-		}
-		if (_size != 0) {
-			_data = new (std::nothrow) T[_size];
-			if (_data == nullptr)
-				throw Error::MemoryError("Could not "
-				    "allocate data");
-			std::copy(&(other._data[0]), &(other._data[_size]),
-			    _data);
-		}
+		deallocate(_data, _capacity, _allocation);
+		_data = nullptr;
+		_size = _capacity = 0;
+
+		size_type new_capacity;
+		_data = allocate(other._size, _allocation, new_capacity);
+		_size = other._size;
+		_capacity = new_capacity;
+		std::copy(&(other._data[0]), &(other._data[_size]), _data);
 	}
 
 	return (*this);
@@ -656,6 +735,7 @@ BiometricEvaluation::Memory::AutoArray<T>::operator=(
 	swap(_size, other._size);
 	swap(_capacity, other._capacity);
 	swap(_data, other._data);
+	swap(_allocation, other._allocation);
 
 	return (*this);
 }
@@ -715,30 +795,29 @@ BiometricEvaluation::Memory::AutoArray<T>::cend()
 template<class T>
 BiometricEvaluation::Memory::AutoArray<T>::AutoArray(
     size_type size) :
+    AutoArray(size, Allocation::Default)
+{
+
+}
+
+template<class T>
+BiometricEvaluation::Memory::AutoArray<T>::AutoArray(
+    size_type size,
+    Allocation allocation) :
     _data(nullptr),
     _size(size),
-    _capacity(size)
+    _capacity(0),
+    _allocation(allocation)
 {
-	if (_size != 0) {
-		_data = new (std::nothrow) T[_size];
-		if (_data == nullptr)
-			throw Error::MemoryError("Could not allocate data");
-	}
+	_data = allocate(_size, _allocation, _capacity);
 }
 
 template<class T>
 BiometricEvaluation::Memory::AutoArray<T>::AutoArray(
     const AutoArray& copy) :
-    _data(nullptr),
-    _size(copy._size),
-    _capacity(copy._size)
+    AutoArray(copy._size)
 {
-	if (_size != 0) {
-		_data = new (std::nothrow) T[_size];
-		if (_data == nullptr)
-			throw Error::MemoryError("Could not allocate data");
-		std::copy(&(copy._data[0]), &(copy._data[_size]), _data);
-	}
+	std::copy(&(copy._data[0]), &(copy._data[_size]), _data);
 }
 
 template<class T>
@@ -747,7 +826,8 @@ BiometricEvaluation::Memory::AutoArray<T>::AutoArray(
     noexcept :
     _data(rvalue._data),
     _size(rvalue._size),
-    _capacity(rvalue._capacity)
+    _capacity(rvalue._capacity),
+    _allocation(rvalue._allocation)
 {
 	/* Modify for a speedy destruction */
 	rvalue._data = nullptr;
@@ -768,8 +848,56 @@ BiometricEvaluation::Memory::AutoArray<T>::AutoArray(
 template<class T>
 BiometricEvaluation::Memory::AutoArray<T>::~AutoArray()
 {
-	if (_data != nullptr)
-		delete [] _data;
+	deallocate(_data, _capacity, _allocation);
+}
+
+/******************************************************************************/
+/* Storage.                                                                   */
+/******************************************************************************/
+template<class T>
+T*
+BiometricEvaluation::Memory::AutoArray<T>::allocate(
+    size_type size,
+    Allocation allocation,
+    size_type &capacity)
+{
+	capacity = 0;
+	if (size == 0)
+		return (nullptr);
+
+	/* Pooled storage is raw memory, so only trivial types may use it */
+	if ((allocation == Allocation::Pooled) && std::is_trivial<T>::value) {
+		if (size > (std::numeric_limits<uint64_t>::max() / sizeof(T)))
+			throw Error::MemoryError("Could not allocate data");
+		uint64_t bytes;
+		T *data = static_cast<T*>(BufferPool::allocate(
+		    size * sizeof(T), bytes));
+		capacity = static_cast<size_type>(bytes / sizeof(T));
+		return (data);
+	}
+
+	T *data = new (std::nothrow) T[size];
+	if (data == nullptr)
+		throw Error::MemoryError("Could not allocate data");
+	capacity = size;
+	return (data);
+}
+
+template<class T>
+void
+BiometricEvaluation::Memory::AutoArray<T>::deallocate(
+    T *data,
+    size_type capacity,
+    Allocation allocation)
+    noexcept
+{
+	if (data == nullptr)
+		return;
+
+	if ((allocation == Allocation::Pooled) && std::is_trivial<T>::value)
+		BufferPool::release(data, capacity * sizeof(T));
+	else
+		delete [] data;
 }
 
 /******************************************************************************/
@@ -0,0 +1,136 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_MEMORY_BUFFERPOOL_H__
+#define __BE_MEMORY_BUFFERPOOL_H__
+
+#include <cstdint>
+
+namespace BiometricEvaluation
+{
+	namespace Memory
+	{
+		/** Source of storage for an AutoArray */
+		enum class Allocation
+		{
+			/** new[] and delete[] */
+			Default,
+			/** The calling thread's BufferPool */
+			Pooled
+		};
+
+		/**
+		 * @brief
+		 * Recycling of large, similarly sized buffers.
+		 * @details
+		 * Each thread keeps a cache of released buffers, grouped
+		 * into size classes four to a power of two, so a buffer
+		 * is at most 25% larger than requested. Buffers
+		 * released to a thread's pool are handed out again by
+		 * allocate() in that thread, avoiding the cost of
+		 * mapping and faulting in new pages for every buffer
+		 * of a loop that reads or decodes many records.
+		 *
+		 * Buffers may be released by a thread other than the
+		 * one that allocated them, in which case they join the
+		 * releasing thread's pool.
+		 *
+		 * @note
+		 * Buffers are not initialized, and may contain the
+		 * contents of a previously released buffer.
+		 */
+		namespace BufferPool
+		{
+			/** Default number of bytes cached per thread */
+			static const uint64_t DEFAULT_CACHE_LIMIT =
+			    64 * 1024 * 1024;
+
+			/**
+			 * @brief
+			 * Obtain a buffer.
+			 *
+			 * @param[in] size
+			 *	Minimum number of bytes required.
+			 * @param[out] capacity
+			 *	Actual number of bytes in the returned
+			 *	buffer.
+			 *
+			 * @return
+			 *	Buffer of capacity bytes, to be released
+			 *	with release().
+			 *
+			 * @throw Error::MemoryError
+			 *	Could not allocate memory.
+			 */
+			void *
+			allocate(
+			    uint64_t size,
+			    uint64_t &capacity);
+
+			/**
+			 * @brief
+			 * Return a buffer to the calling thread's pool.
+			 *
+			 * @param[in] buffer
+			 *	Buffer returned from allocate().
+			 * @param[in] capacity
+			 *	Number of bytes of buffer to reuse, no
+			 *	more than the capacity obtained from
+			 *	allocate().
+			 *
+			 * @note
+			 * The buffer is freed if the pool is full.
+			 */
+			void
+			release(
+			    void *buffer,
+			    uint64_t capacity)
+			    noexcept;
+
+			/**
+			 * @brief
+			 * Free all buffers cached by the calling thread.
+			 */
+			void
+			clear();
+
+			/**
+			 * @return
+			 *	Number of bytes cached by the calling
+			 *	thread.
+			 */
+			uint64_t
+			getCachedSize();
+
+			/**
+			 * @brief
+			 * Set the maximum number of bytes cached by the
+			 * calling thread.
+			 *
+			 * @param[in] limit
+			 *	Maximum number of bytes to cache. 0
+			 *	disables caching.
+			 */
+			void
+			setCacheLimit(
+			    uint64_t limit);
+
+			/**
+			 * @return
+			 *	Maximum number of bytes cached by the
+			 *	calling thread.
+			 */
+			uint64_t
+			getCacheLimit();
+		}
+	}
+}
+
+#endif /* __BE_MEMORY_BUFFERPOOL_H__ */
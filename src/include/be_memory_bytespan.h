@@ -0,0 +1,256 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_MEMORY_BYTESPAN_H__
+#define __BE_MEMORY_BYTESPAN_H__
+
+#include <cstdint>
+#include <memory>
+
+#include <be_memory_autoarray.h>
+
+namespace BiometricEvaluation
+{
+	namespace Memory
+	{
+		/**
+		 * @brief
+		 * A read-only view of contiguous bytes.
+		 * @details
+		 * A ByteSpan refers to bytes it does not copy. It may share
+		 * ownership of the object holding the bytes, in which case
+		 * the bytes remain valid for as long as any ByteSpan
+		 * referring to them. Otherwise, the bytes are borrowed, and
+		 * the creator of the ByteSpan must keep them valid for as
+		 * long as the ByteSpan, or anything constructed from it,
+		 * is in use.
+		 *
+		 * Spans of owned bytes are cheap to copy, so they can be
+		 * passed through Image, View, and record constructors
+		 * without copying encoded data at every layer.
+		 */
+		class ByteSpan
+		{
+		public:
+			/** Type of element */
+			using value_type = uint8_t;
+			/** Type of subscripts, counts, etc. */
+			using size_type = uint64_t;
+			/** Iterator of element */
+			using const_iterator = const uint8_t*;
+
+			/** Construct an empty span. */
+			ByteSpan() = default;
+
+			/**
+			 * @brief
+			 * Construct a span of borrowed bytes.
+			 *
+			 * @param[in] data
+			 *	Start of the bytes.
+			 * @param[in] size
+			 *	Number of bytes.
+			 */
+			ByteSpan(
+			    const uint8_t *data,
+			    size_type size);
+
+			/**
+			 * @brief
+			 * Construct a span of bytes kept alive by an owner.
+			 *
+			 * @param[in] data
+			 *	Start of the bytes.
+			 * @param[in] size
+			 *	Number of bytes.
+			 * @param[in] owner
+			 *	Object that keeps data valid while it
+			 *	exists.
+			 */
+			ByteSpan(
+			    const uint8_t *data,
+			    size_type size,
+			    std::shared_ptr<const void> owner);
+
+			/**
+			 * @brief
+			 * Construct a span of the bytes of an AutoArray.
+			 *
+			 * @param[in] data
+			 *	AutoArray whose bytes are borrowed.
+			 *
+			 * @warning
+			 * The span is invalidated when data is resized or
+			 * destroyed.
+			 */
+			explicit ByteSpan(
+			    const uint8Array &data);
+
+			/**
+			 * Temporaries can't be borrowed; use share() to
+			 * take ownership of them instead.
+			 */
+			ByteSpan(
+			    uint8Array &&data) = delete;
+
+			/**
+			 * @brief
+			 * Construct a span sharing ownership of an
+			 * AutoArray.
+			 *
+			 * @param[in] data
+			 *	AutoArray whose bytes are referred to.
+			 */
+			explicit ByteSpan(
+			    std::shared_ptr<const uint8Array> data);
+
+			/**
+			 * @brief
+			 * Construct a span owning a copy of bytes.
+			 *
+			 * @param[in] data
+			 *	Start of the bytes to copy.
+			 * @param[in] size
+			 *	Number of bytes to copy.
+			 *
+			 * @return
+			 *	Span owning the copy.
+			 *
+			 * @throw Error::MemoryError
+			 *	Could not allocate memory.
+			 */
+			static ByteSpan
+			copyOf(
+			    const uint8_t *data,
+			    size_type size);
+
+			/**
+			 * @brief
+			 * Construct a span taking ownership of an AutoArray.
+			 *
+			 * @param[in] data
+			 *	AutoArray to be moved into the span's owner.
+			 *
+			 * @return
+			 *	Span owning data.
+			 */
+			static ByteSpan
+			share(
+			    uint8Array &&data);
+
+			/** @return Start of the bytes. */
+			const uint8_t *
+			data()
+			    const;
+
+			/** @return Number of bytes. */
+			size_type
+			size()
+			    const;
+
+			/** @return Whether size() is 0. */
+			bool
+			empty()
+			    const;
+
+			/** @return Iterator to the first byte. */
+			const_iterator
+			begin()
+			    const;
+
+			/** @return Iterator one past the last byte. */
+			const_iterator
+			end()
+			    const;
+
+			/**
+			 * @brief
+			 * Unchecked access to a byte.
+			 *
+			 * @param[in] index
+			 *	Offset of the byte.
+			 *
+			 * @return
+			 *	The byte at index.
+			 */
+			const uint8_t &
+			operator[](
+			    size_type index)
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain a span of a range of this span.
+			 *
+			 * @param[in] offset
+			 *	Offset of the first byte of the range.
+			 * @param[in] size
+			 *	Number of bytes in the range.
+			 *
+			 * @return
+			 *	Span of the range, sharing this span's
+			 *	owner, if any.
+			 *
+			 * @throw Error::ParameterError
+			 *	Range extends past the end of this span.
+			 */
+			ByteSpan
+			subspan(
+			    size_type offset,
+			    size_type size)
+			    const;
+
+			/**
+			 * @return
+			 *	Whether the span keeps its bytes valid, as
+			 *	opposed to borrowing them.
+			 */
+			bool
+			isOwned()
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain a span whose bytes outlive their creator.
+			 *
+			 * @return
+			 *	This span if it is owned, otherwise a span
+			 *	owning a copy of the bytes.
+			 *
+			 * @throw Error::MemoryError
+			 *	Could not allocate memory.
+			 */
+			ByteSpan
+			toOwned()
+			    const;
+
+			/**
+			 * @return
+			 *	Copy of the bytes.
+			 *
+			 * @throw Error::MemoryError
+			 *	Could not allocate memory.
+			 */
+			uint8Array
+			toUint8Array()
+			    const;
+
+		private:
+			/** Start of the bytes */
+			const uint8_t *_data{nullptr};
+			/** Number of bytes */
+			size_type _size{0};
+			/** Object keeping _data valid, if any */
+			std::shared_ptr<const void> _owner{};
+		};
+	}
+}
+
+#endif /* __BE_MEMORY_BYTESPAN_H__ */
@@ -49,7 +49,28 @@ namespace BiometricEvaluation
 			 * just the palm image and/or minutiae records.
 			 */
 			AN2KView(
-			    BiometricEvaluation::Memory::uint8Array &buf,
+			    const BiometricEvaluation::Memory::ByteSpan &buf,
+			    const uint32_t recordNumber);
+
+			/**
+			 * @brief
+			 * As the Memory::ByteSpan constructor. buf is
+			 * not retained.
+			 */
+			AN2KView(
+			    const Memory::uint8Array &buf,
+			    const uint32_t recordNumber);
+
+			/**
+			 * @brief
+			 * Construct an AN2K palm view from a shared parse
+			 * tree of an AN2K record.
+			 * @details
+			 * The parse tree must be of the entire AN2K record,
+			 * as returned by DataInterchange::AN2KRecord::parse().
+			 */
+			AN2KView(
+			    const std::shared_ptr<const ANSI_NIST> &an2k,
 			    const uint32_t recordNumber);
 
 			/**
@@ -10,6 +10,7 @@
 #ifndef __BE_TEXT_H__
 #define __BE_TEXT_H__
 
+#include <cstdint>
 #include <locale>
 #include <string>
 #include <vector>
@@ -191,6 +192,32 @@ namespace BiometricEvaluation {
 		    const size_t buffer_size,
 		    const std::string &digest = "md5");
 
+		/**
+		 * @brief
+		 * Compute the CRC-32C (Castagnoli) checksum of a memory
+		 * buffer.
+		 * @details
+		 * The SSE 4.2 or ARMv8 CRC32 instructions are used when
+		 * supported by the processor. Checksums may be computed
+		 * incrementally by passing the result of the previous
+		 * call as crc.
+		 *
+		 * @param[in] buffer
+		 * 	The buffer of which a checksum should be computed.
+		 * @param[in] buffer_size
+		 *	The size of buffer.
+		 * @param[in] crc
+		 *	Checksum of the data preceding buffer, or 0.
+		 *
+		 * @return
+		 *	CRC-32C of buffer.
+		 */
+		uint32_t
+		crc32c(
+		    const void *buffer,
+		    const size_t buffer_size,
+		    const uint32_t crc = 0);
+
 		/**
 		 * @brief
 		 * Return tokens bound by delimiters and the beginning and end
@@ -185,7 +185,31 @@ namespace BiometricEvaluation
 			 * just the image and other view-related records.
 			 */
 			AN2KView(
-			    Memory::uint8Array &buf,
+			    const Memory::ByteSpan &buf,
+			    const RecordType typeID,
+			    const uint32_t recordNumber);
+
+			/**
+			 * @brief
+			 * As the Memory::ByteSpan constructor. buf is
+			 * not retained.
+			 */
+			AN2KView(
+			    const Memory::uint8Array &buf,
+			    const RecordType typeID,
+			    const uint32_t recordNumber);
+
+			/**
+			 * @brief
+			 * Construct an AN2K view from a parsed AN2K record.
+			 * @details
+			 * The parse tree, from
+			 * DataInterchange::AN2KRecord::parse(), is shared
+			 * with this view and any copies of it, so many views
+			 * of one transaction do not each parse it.
+			 */
+			AN2KView(
+			    const std::shared_ptr<const ANSI_NIST> &an2k,
 			    const RecordType typeID,
 			    const uint32_t recordNumber);
 
@@ -218,7 +242,7 @@ namespace BiometricEvaluation
 			 * @brief
 			 * Obtain the complete ANSI/NIST record set.
 			 */
-			Memory::AutoBuffer<ANSI_NIST>
+			std::shared_ptr<const ANSI_NIST>
 			getAN2K()
 			    const;
 
@@ -262,26 +286,10 @@ namespace BiometricEvaluation
 			/**
 			 * @brief
 			 * Create AN2KMinutiaeDataRecord objects that share
-			 * the IDC of this View.
-			 * 
-			 * @param buf
-			 *	AN2K file in memory.
+			 * the IDC of this View, from the shared parse tree.
 			 */
 			void
-			associateMinutiaeData(
-			    Memory::uint8Array &buf);
-			    
-			/**
-			 * @brief
-			 * Create AN2KMinutiaeDataRecord objects that share
-			 * the IDC of this View.
-			 * 
-			 * @param filename
-			 *	Filename of an AN2K file.
-			 */
-    			void
-			associateMinutiaeData(
-			    const std::string &filename);
+			associateMinutiaeData();
 			    
     			/**
 			 * @brief
@@ -298,8 +306,10 @@ namespace BiometricEvaluation
 			/* The record that this object represents. The Nth
 			 * record is searched for when the object is
 			 * constructed and may be referenced by subclasses.
+			 * The complete record is shared, read-only, by
+			 * copies of this view and other views of it.
 			 */
-			Memory::AutoBuffer<ANSI_NIST> _an2k;
+			std::shared_ptr<const ANSI_NIST> _an2k;
 			RECORD *_an2kRecord;
 			RecordType _recordType;
 			int _idc;
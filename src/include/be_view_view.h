@@ -16,6 +16,7 @@
 #include <vector>
 
 #include <be_image_image.h>
+#include <be_image_resample.h>
 
 namespace BiometricEvaluation 
 {
@@ -38,13 +39,65 @@ namespace BiometricEvaluation
 			 * @details
 			 * Not all views will have an image, however
 			 * the derived information, such as minutiae, may
-			 * be present.
+			 * be present. The returned Image shares the view's
+			 * image data rather than copying it.
 			 * @return
 			 * The image data.
 		 	 */
 			std::shared_ptr<Image::Image>
 			    getImage() const;
 
+			/**
+			 * @brief
+			 * Obtain the image used for the biometric view,
+			 * resampled to a resolution.
+			 * @details
+			 * The image is resampled from the resolution in
+			 * the biometric record, getImageResolution(), so
+			 * that images from records of different
+			 * resolutions can be compared pixel for pixel.
+			 * When resampling would not change the dimensions
+			 * of the image, this is getImage().
+			 *
+			 * @param[in] resolution
+			 *	Resolution of the returned image.
+			 * @param[in] filter
+			 *	Interpolation used when resampling.
+			 *
+			 * @return
+			 *	The image data, at resolution.
+			 *
+			 * @throw Error::NotImplemented
+			 *	Bit depth of the image is not 8 or 16.
+			 * @throw Error::ParameterError
+			 *	The resolution of the view or resolution
+			 *	has unknown units.
+			 * @throw Error::DataError
+			 *	Error decoding the image.
+			 */
+			std::shared_ptr<Image::Image>
+			getImage(
+			    const Image::Resolution &resolution,
+			    const Image::ResampleFilter filter =
+			        Image::ResampleFilter::Lanczos)
+			    const;
+
+			/**
+			 * @brief
+			 * Obtain the image data of the view, as contained
+			 * in the record.
+			 * @details
+			 * The data is not copied. When the view owns it,
+			 * as views read from AN2K and INCITS records do,
+			 * the span shares that ownership and remains valid
+			 * after the view is destroyed.
+			 * @return
+			 * The encoded image data.
+			 */
+			Memory::ByteSpan
+			getImageData()
+			    const;
+
 			/**
 			 * @brief
 			 * Obtain the image size.
@@ -170,6 +223,18 @@ namespace BiometricEvaluation
 			    const BiometricEvaluation::Memory::uint8Array
 				&imageData);
 
+			/**
+			 * @brief
+			 * Mutator for the image data, without copying.
+			 * @param[in] imageData
+			 * The image data. If not owned, it must remain
+			 * valid for the life of this view and any Image
+			 * obtained from it.
+			 */
+			void setImageData(
+			    const BiometricEvaluation::Memory::ByteSpan
+				&imageData);
+
 			/**
 			 * @brief
 			 * Mutator for the compression algorithm.
@@ -184,7 +249,7 @@ namespace BiometricEvaluation
 			Image::Size _imageSize{};
 			Image::Resolution _imageResolution{};
 			Image::Resolution _scanResolution{};
-			Memory::AutoArray<uint8_t> _imageData;
+			Memory::ByteSpan _imageData;
 			Image::CompressionAlgorithm
 			    _compressionAlgorithm{};
 			uint32_t _imageColorDepth{};
@@ -8,32 +8,76 @@
  * about its quality, reliability, or any other characteristic.
  */
 
-#include <cstdio>
+#include <cstdlib>
 #include <set>
+#include <string>
 
 #include <be_data_interchange_an2k.h>
+#include <be_data_interchange_an2kreader.h>
 extern "C" {
 #include <an2k.h>
 }
 
 namespace BE = BiometricEvaluation;
 
+namespace
+{
+	/*
+	 * Obtain element index of cache, constructing it if it has not been.
+	 */
+	template<typename T, typename Constructor>
+	const T&
+	cached(
+	    std::map<uint32_t, T> &cache,
+	    const uint32_t index,
+	    Constructor construct)
+	{
+		auto it = cache.find(index);
+		if (it == cache.end())
+			it = cache.emplace(index, construct(index)).first;
+		return (it->second);
+	}
+
+	/*
+	 * Obtain the first count elements from get. As before, an element
+	 * that cannot be constructed ends the set.
+	 */
+	template<typename Getter>
+	auto
+	collect(
+	    const uint32_t count,
+	    Getter get) -> std::vector<decltype(get(0))>
+	{
+		std::vector<decltype(get(0))> elements;
+		elements.reserve(count);
+		for (uint32_t i = 0; i < count; i++) {
+			try {
+				elements.push_back(get(i));
+			} catch (const BE::Error::DataError&) {
+				break;
+			}
+		}
+		return (elements);
+	}
+}
+
 /******************************************************************************/
 /* Private functions.                                                         */
 /******************************************************************************/
 std::set<int>
 BiometricEvaluation::DataInterchange::AN2KRecord::recordLocations(
-    Memory::uint8Array &buf,
+    const Memory::ByteSpan &buf,
     View::AN2KView::RecordType recordType)
 {
-	Memory::AutoBuffer<ANSI_NIST> an2k(&biomeval_nbis_alloc_ANSI_NIST,
-	    &biomeval_nbis_free_ANSI_NIST, &biomeval_nbis_copy_ANSI_NIST);
-	AN2KBDB bdb;
-        INIT_AN2KBDB(&bdb, buf, buf.size());
-	if (biomeval_nbis_scan_ANSI_NIST(&bdb, an2k) != 0)
-		throw Error::DataError("Could not read AN2K buffer");
+	return (recordLocations(parse(buf).get(), recordType));
+}
 
-	return (recordLocations(an2k, recordType));
+std::set<int>
+BiometricEvaluation::DataInterchange::AN2KRecord::recordLocations(
+    const Memory::uint8Array &buf,
+    View::AN2KView::RecordType recordType)
+{
+	return (recordLocations(Memory::ByteSpan(buf), recordType));
 }
 
 std::set<int>
@@ -53,18 +97,8 @@ BiometricEvaluation::DataInterchange::AN2KRecord::recordLocations(
 
 void
 BiometricEvaluation::DataInterchange::AN2KRecord::readType1Record(
-    Memory::uint8Array &buf)
+    const RECORD *rec)
 {
-	Memory::AutoBuffer<ANSI_NIST> an2k(&biomeval_nbis_alloc_ANSI_NIST,
-	    &biomeval_nbis_free_ANSI_NIST, &biomeval_nbis_copy_ANSI_NIST);
-	AN2KBDB bdb;
-        INIT_AN2KBDB(&bdb, buf, buf.size());
-	if (biomeval_nbis_scan_ANSI_NIST(&bdb, an2k) != 0)
-		throw Error::DataError("Could not read AN2K buffer");
-
-	/* The Type-1 record is always first, but check anyway. */
-	RECORD *rec;
-	rec = an2k->records[0];
 	if (rec->type != TYPE_1_ID)
 		throw Error::DataError("Invalid AN2K Record");
 
@@ -164,108 +198,160 @@ BiometricEvaluation::DataInterchange::AN2KRecord::readType1Record(
 }
 
 void
-BiometricEvaluation::DataInterchange::AN2KRecord::readPalmCaptures(
-    Memory::uint8Array &buf)
-{
-	int i{1};
-	while (true) {
-		try {
-			this->_palmCaptures.emplace_back(buf, i);
-		} catch (const Error::DataError&) {
-			break;
-		}
-		++i;
+BiometricEvaluation::DataInterchange::AN2KRecord::indexAN2KRecord(
+    const Memory::ByteSpan &buf)
+{
+	AN2KReader reader(buf);
+	readType1Record(reader.getType1Record());
+	this->_index.reserve(reader.getRecordCount());
+	for (uint32_t i = 0; i < reader.getRecordCount(); i++) {
+		const auto record = reader.sequence();
+		this->_index.push_back({record.type, record.idc,
+		    record.offset, record.data.size()});
 	}
 }
 
 void
-BiometricEvaluation::DataInterchange::AN2KRecord::readFingerCaptures(
-    Memory::uint8Array &buf)
-{
-	int i = 1;
-	while(true) {
-		try {
-			BE::Finger::AN2KViewCapture an2kv(buf, i);
-			_fingerCaptures.push_back(an2kv);
-		} catch (Error::DataError &e) {
-			break;
-		}
-		i++;
+BiometricEvaluation::DataInterchange::AN2KRecord::indexParseTree(
+    const ANSI_NIST *an2k)
+{
+	if (an2k->num_records < 1)
+		throw Error::DataError("Invalid AN2K Record");
+	readType1Record(an2k->records[0]);
+
+	/* IDCs are listed in CNT, as AN2KReader reads them */
+	FIELD *cnt = nullptr;
+	int cnt_idx;
+	biomeval_nbis_lookup_ANSI_NIST_field(&cnt, &cnt_idx, CNT_ID,
+	    an2k->records[0]);
+
+	uint64_t offset = 0;
+	this->_index.reserve(an2k->num_records);
+	for (int i = 0; i < an2k->num_records; i++) {
+		const RECORD *record = an2k->records[i];
+		uint32_t idc = 0;
+		if (i > 0 && cnt != nullptr && i < cnt->num_subfields &&
+		    cnt->subfields[i]->num_items == 2)
+			idc = std::atoi(
+			    (char *)cnt->subfields[i]->items[1]->value);
+		this->_index.push_back({static_cast<View::AN2KView::RecordType>(
+		    record->type), idc, offset, static_cast<uint64_t>(
+		    record->total_bytes)});
+		offset += record->total_bytes;
 	}
 }
 
-void
-BiometricEvaluation::DataInterchange::AN2KRecord::readFingerLatents(
-    Memory::uint8Array &buf)
-{
-	int i = 1;
-	while(true) {
-		try {
-			BE::Latent::AN2KView an2kv(buf, i);
-			_fingerLatents.push_back(an2kv);
-		} catch (Error::DataError &e) {
-			break;
-		}
-		i++;
-	}
+std::shared_ptr<const ANSI_NIST>
+BiometricEvaluation::DataInterchange::AN2KRecord::getParseTree()
+    const
+{
+	if (this->_an2k == nullptr)
+		this->_an2k = parse(this->_buf);
+	return (this->_an2k);
 }
 
-void
-BiometricEvaluation::DataInterchange::AN2KRecord::readMinutiaeData(
-    Memory::uint8Array &buf)
-{
-	std::set<int> loc = recordLocations(
-	    buf, View::AN2KView::RecordType::Type_9);
-	for (std::set<int>::const_iterator it = loc.begin();
-	    it != loc.end(); it++) {
-		try {
-			_minutiaeDataRecordSet.push_back(
-			    BE::Finger::AN2KMinutiaeDataRecord(buf, *it));
-		} catch (Error::DataError &e) {
-			break;
-		}	
-	}
+std::vector<int>
+BiometricEvaluation::DataInterchange::AN2KRecord::indexLocations(
+    const View::AN2KView::RecordType recordType)
+    const
+{
+	std::vector<int> locations;
+	for (std::vector<int>::size_type i = 0; i < this->_index.size(); i++)
+		if (this->_index[i].type == recordType)
+			locations.push_back(i);
+	return (locations);
 }
 
 /******************************************************************************/
 /* Public functions.                                                          */
 /******************************************************************************/
-BiometricEvaluation::DataInterchange::AN2KRecord::AN2KRecord(
-    const std::string filename)
+std::shared_ptr<const ANSI_NIST>
+BiometricEvaluation::DataInterchange::AN2KRecord::parse(
+    const Memory::ByteSpan &buf)
 {
-	if (!IO::Utility::fileExists(filename))
-		throw Error::FileError("File not found.");
+	ANSI_NIST *an2k;
+	if (biomeval_nbis_alloc_ANSI_NIST(&an2k) != 0)
+		throw Error::MemoryError("Could not allocate AN2K record");
+	std::shared_ptr<const ANSI_NIST> tree(an2k,
+	    &biomeval_nbis_free_ANSI_NIST);
+
+	AN2KBDB bdb;
+	INIT_AN2KBDB(&bdb, const_cast<uint8_t *>(buf.data()), buf.size());
+	if (biomeval_nbis_scan_ANSI_NIST(&bdb, an2k) != 0)
+		throw Error::DataError("Could not read AN2K buffer");
 
-	FILE *fp = std::fopen(filename.c_str(), "rb");
-	if (fp == nullptr)
-                throw (Error::FileError("Could not open file."));
+	return (tree);
+}
 
-	uint64_t sz = IO::Utility::getFileSize(filename);
-	Memory::uint8Array buf(sz);
-	if (fread(buf, 1, sz, fp) != sz) {
-		fclose(fp);
-		throw Error::FileError("Could not read AN2K file");
+BiometricEvaluation::Memory::ByteSpan
+BiometricEvaluation::DataInterchange::AN2KRecord::mapFile(
+    const std::string &filename)
+{
+	try {
+		return (IO::Utility::mapFile(filename));
+	} catch (const Error::ObjectDoesNotExist&) {
+		throw Error::FileError("File not found.");
+	} catch (const Error::StrategyError &e) {
+		throw Error::FileError(e.whatString());
 	}
-	fclose(fp);
+}
 
-	readAN2KRecord(buf);
+BiometricEvaluation::DataInterchange::AN2KRecord::AN2KRecord(
+    const std::string filename,
+    const Construction construction)
+{
+	/* Mapped, so a lazy record reads only the pages it uses */
+	readAN2KRecord(mapFile(filename), construction);
 }
 
 BiometricEvaluation::DataInterchange::AN2KRecord::AN2KRecord(
-    Memory::uint8Array &buf)
+    const Memory::ByteSpan &buf,
+    const Construction construction)
 {
-	readAN2KRecord(buf);
+	readAN2KRecord(buf, construction);
+}
+
+BiometricEvaluation::DataInterchange::AN2KRecord::AN2KRecord(
+    const Memory::uint8Array &buf,
+    const Construction construction) :
+    AN2KRecord(Memory::ByteSpan(buf), construction)
+{
+
 }
 
 void
 BiometricEvaluation::DataInterchange::AN2KRecord::readAN2KRecord(
-    Memory::uint8Array &buf)
+    const Memory::ByteSpan &buf,
+    const Construction construction)
 {
-	readType1Record(buf);
-	readMinutiaeData(buf);
-	readFingerCaptures(buf);
-	readFingerLatents(buf);
-	readPalmCaptures(buf);
+	if (construction == Construction::Lazy) {
+		indexAN2KRecord(buf);
+		this->_lazy = true;
+		this->_buf = buf.toOwned();
+		return;
+	}
+
+	/*
+	 * Construct every view now, as on demand, parsing once and sharing
+	 * the tree with every view. Counts are then of views constructed.
+	 * The index comes from the same tree, so a transaction that NBIS
+	 * parses is not rejected by AN2KReader first.
+	 */
+	this->_an2k = parse(buf);
+	indexParseTree(this->_an2k.get());
+	this->_lazy = true;
+	getMinutiaeDataRecordSet();
+	getFingerCaptures();
+	getFingerLatents();
+	getPalmCaptures();
+	this->_lazy = false;
+}
+
+std::vector<BiometricEvaluation::DataInterchange::AN2KRecord::RecordIndexEntry>
+BiometricEvaluation::DataInterchange::AN2KRecord::getRecordIndex()
+    const
+{
+	return (this->_index);
 }
 
 std::string
@@ -313,46 +399,115 @@ BiometricEvaluation::DataInterchange::AN2KRecord::getNominalTransmittingResoluti
 uint32_t
 BiometricEvaluation::DataInterchange::AN2KRecord::getFingerLatentCount() const
 {
+	if (this->_lazy)
+		return (indexLocations(View::AN2KView::RecordType::Type_13).
+		    size());
 	return (_fingerLatents.size());
 }
 
+uint32_t
+BiometricEvaluation::DataInterchange::AN2KRecord::getMinutiaeDataRecordCount()
+    const
+{
+	if (this->_lazy)
+		return (indexLocations(View::AN2KView::RecordType::Type_9).
+		    size());
+	return (_minutiaeDataRecordSet.size());
+}
+
+BE::Finger::AN2KMinutiaeDataRecord
+BiometricEvaluation::DataInterchange::AN2KRecord::getMinutiaeDataRecord(
+    const uint32_t index)
+    const
+{
+	if (index >= getMinutiaeDataRecordCount())
+		throw Error::ParameterError("Index out of range");
+	return (cached(_minutiaeDataRecordSet, index, [this](uint32_t i) {
+		return (Finger::AN2KMinutiaeDataRecord(getParseTree(),
+		    indexLocations(View::AN2KView::RecordType::Type_9)[i]));
+	}));
+}
+
 std::vector<BE::Finger::AN2KMinutiaeDataRecord>
 BiometricEvaluation::DataInterchange::AN2KRecord::getMinutiaeDataRecordSet()
     const
 {
-	return (_minutiaeDataRecordSet);
+	return (collect(getMinutiaeDataRecordCount(),
+	    [this](uint32_t i) { return (getMinutiaeDataRecord(i)); }));
+}
+
+BE::Latent::AN2KView
+BiometricEvaluation::DataInterchange::AN2KRecord::getFingerLatent(
+    const uint32_t index)
+    const
+{
+	if (index >= getFingerLatentCount())
+		throw Error::ParameterError("Index out of range");
+	return (cached(_fingerLatents, index, [this](uint32_t i) {
+		return (Latent::AN2KView(getParseTree(), i + 1)); }));
 }
 
 std::vector<BE::Latent::AN2KView>
 BiometricEvaluation::DataInterchange::AN2KRecord::getFingerLatents() const
 {
-	return (_fingerLatents);
+	return (collect(getFingerLatentCount(),
+	    [this](uint32_t i) { return (getFingerLatent(i)); }));
 }
 
 uint32_t
 BiometricEvaluation::DataInterchange::AN2KRecord::getFingerCaptureCount() const
 {
+	if (this->_lazy)
+		return (indexLocations(View::AN2KView::RecordType::Type_14).
+		    size());
 	return (_fingerCaptures.size());
 }
 
+BE::Finger::AN2KViewCapture
+BiometricEvaluation::DataInterchange::AN2KRecord::getFingerCapture(
+    const uint32_t index)
+    const
+{
+	if (index >= getFingerCaptureCount())
+		throw Error::ParameterError("Index out of range");
+	return (cached(_fingerCaptures, index, [this](uint32_t i) {
+		return (Finger::AN2KViewCapture(getParseTree(), i + 1)); }));
+}
+
 std::vector<BE::Finger::AN2KViewCapture>
 BiometricEvaluation::DataInterchange::AN2KRecord::getFingerCaptures() const
 {
-	return (_fingerCaptures);
+	return (collect(getFingerCaptureCount(),
+	    [this](uint32_t i) { return (getFingerCapture(i)); }));
 }
 
 uint32_t
 BiometricEvaluation::DataInterchange::AN2KRecord::getPalmCaptureCount()
    const
 {
+	if (this->_lazy)
+		return (indexLocations(View::AN2KView::RecordType::Type_15).
+		    size());
 	return (this->_palmCaptures.size());
 }
 
+BE::Palm::AN2KView
+BiometricEvaluation::DataInterchange::AN2KRecord::getPalmCapture(
+    const uint32_t index)
+    const
+{
+	if (index >= getPalmCaptureCount())
+		throw Error::ParameterError("Index out of range");
+	return (cached(this->_palmCaptures, index, [this](uint32_t i) {
+		return (Palm::AN2KView(getParseTree(), i + 1)); }));
+}
+
 std::vector<BE::Palm::AN2KView>
 BiometricEvaluation::DataInterchange::AN2KRecord::getPalmCaptures()
     const
 {
-	return (this->_palmCaptures);
+	return (collect(getPalmCaptureCount(),
+	    [this](uint32_t i) { return (getPalmCapture(i)); }));
 }
 
 uint8_t
@@ -0,0 +1,498 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <be_data_interchange_an2k.h>
+#include <be_data_interchange_an2kingest.h>
+#include <be_error.h>
+#include <be_error_exception.h>
+#include <be_io_utility.h>
+#include <be_sysdeps.h>
+#include <be_system.h>
+
+namespace BE = BiometricEvaluation;
+
+namespace
+{
+	/** A record extracted from a file, to be inserted */
+	struct Output
+	{
+		/** Destination of the record */
+		BE::IO::RecordStore *store;
+		/** Key of the record */
+		std::string key;
+		/** The record, sharing ownership of the file */
+		BE::Memory::ByteSpan data;
+	};
+
+	/** Outcome of reading and parsing one file */
+	struct Extracted
+	{
+		/** Records to insert */
+		std::vector<Output> records{};
+		/** Failure reading or parsing the file, or nullptr */
+		std::exception_ptr error{};
+	};
+
+	/** A file to ingest */
+	struct Input
+	{
+		/** Path of the file */
+		std::string path;
+		/** Key of the file */
+		std::string key;
+	};
+
+	/**
+	 * Extracts records from files on a pool of threads, and inserts
+	 * them on the calling thread.
+	 *
+	 * Threads claim files in order. A file is only claimed while
+	 * fewer than maxPending files are claimed and not consumed, so
+	 * when consuming in order, the next file to consume has always
+	 * been claimed.
+	 */
+	class Ingest
+	{
+	public:
+		Ingest(
+		    const std::vector<Input> &inputs,
+		    const BE::DataInterchange::AN2KIngestStores &stores,
+		    const BE::DataInterchange::AN2KIngestOptions &options);
+
+		/** Ingest every file */
+		BE::DataInterchange::AN2KIngestSummary
+		run();
+
+	private:
+		/** Body of a parsing thread */
+		void
+		work();
+
+		/** Read and parse a file, capturing any failure */
+		Extracted
+		extract(
+		    const Input &input)
+		    const;
+
+		/**
+		 * Insert the records of a file.
+		 * @return Whether the file was ingested.
+		 */
+		bool
+		consume(
+		    const Input &input,
+		    Extracted &&extracted,
+		    BE::DataInterchange::AN2KIngestSummary &summary);
+
+		/** Stop parsing threads and wait for them to exit */
+		void
+		stop(
+		    std::vector<std::thread> &threads);
+
+		const std::vector<Input> &_inputs;
+		const BE::DataInterchange::AN2KIngestStores &_stores;
+		const BE::DataInterchange::AN2KIngestOptions &_options;
+
+		/** Protects members below */
+		std::mutex _mutex;
+		/** Signaled when any member below changes */
+		std::condition_variable _changed;
+		/** Files parsed and not yet consumed, by index */
+		std::map<uint64_t, Extracted> _done;
+		/** Number of files claimed */
+		uint64_t _claimed{0};
+		/** Number of files consumed */
+		uint64_t _consumed{0};
+		/** Set to make parsing threads exit */
+		bool _cancelled{false};
+	};
+
+	/** @return Number of threads to use for count items */
+	uint32_t
+	getThreadCount(
+	    uint32_t requested,
+	    uint64_t count)
+	{
+		if (requested == 0) {
+			try {
+				requested = BE::System::getCPUCoreCount();
+			} catch (const BE::Error::Exception&) {
+				requested = std::thread::hardware_concurrency();
+			}
+		}
+		return (static_cast<uint32_t>(std::max<uint64_t>(1,
+		    std::min<uint64_t>(requested, count))));
+	}
+
+	/**
+	 * @return path, made valid as a RecordStore key by replacing
+	 * '%', characters that are invalid in a key, and leading
+	 * whitespace with '%' and two uppercase hexadecimal digits.
+	 */
+	std::string
+	pathToKey(
+	    const std::string &path)
+	{
+		static const char hexDigits[] = "0123456789ABCDEF";
+
+		std::string key;
+		key.reserve(path.size());
+		for (const char c : path) {
+			if ((c != '%') && (BE::IO::RecordStore::INVALIDKEYCHARS.
+			    find(c) == std::string::npos) && (!key.empty() ||
+			    !std::isspace(static_cast<unsigned char>(c)))) {
+				key += c;
+				continue;
+			}
+			const auto byte = static_cast<unsigned char>(c);
+			key += '%';
+			key += hexDigits[byte >> 4];
+			key += hexDigits[byte & 0x0F];
+		}
+		return (key);
+	}
+
+	/** @return Whether name ends with one of extensions */
+	bool
+	hasExtension(
+	    const std::string &name,
+	    const std::vector<std::string> &extensions)
+	{
+		if (extensions.empty())
+			return (true);
+		for (const auto &extension : extensions) {
+			if (extension.size() > name.size())
+				continue;
+			if (std::equal(extension.begin(), extension.end(),
+			    name.end() - extension.size(),
+			    [](char a, char b) {
+				return (std::tolower(a) == std::tolower(b));
+			    }))
+				return (true);
+		}
+		return (false);
+	}
+
+	/**
+	 * Append the files beneath directory/relative whose extension is
+	 * one of extensions to inputs, keyed by their path relative to
+	 * directory.
+	 */
+	void
+	listFiles(
+	    const std::string &directory,
+	    const std::string &relative,
+	    const std::vector<std::string> &extensions,
+	    std::vector<Input> &inputs)
+	{
+		const std::string dirpath = relative.empty() ? directory :
+		    directory + "/" + relative;
+		DIR *dir = opendir(dirpath.c_str());
+		if (dir == nullptr)
+			throw BE::Error::StrategyError(dirpath + " could not "
+			    "be opened (" + BE::Error::errorStr() + ")");
+
+		std::vector<std::string> names;
+		struct dirent *entry;
+		while ((entry = readdir(dir)) != nullptr) {
+			if ((std::strcmp(entry->d_name, ".") == 0) ||
+			    (std::strcmp(entry->d_name, "..") == 0))
+				continue;
+			names.push_back(entry->d_name);
+		}
+		closedir(dir);
+		std::sort(names.begin(), names.end());
+
+		for (const auto &name : names) {
+			const std::string path = relative.empty() ? name :
+			    relative + "/" + name;
+			struct stat sb;
+			if (stat((directory + "/" + path).c_str(), &sb) != 0)
+				throw BE::Error::StrategyError("Could not "
+				    "stat " + directory + "/" + path);
+			if (S_ISDIR(sb.st_mode))
+				listFiles(directory, path, extensions, inputs);
+			else if (hasExtension(name, extensions))
+				inputs.push_back({directory + "/" + path,
+				    pathToKey(path)});
+		}
+	}
+
+	/** @return Description of the current exception */
+	std::string
+	describe(
+	    const std::exception_ptr &error)
+	{
+		try {
+			std::rethrow_exception(error);
+		} catch (const BE::Error::Exception &e) {
+			return (e.whatString());
+		} catch (const std::exception &e) {
+			return (e.what());
+		} catch (...) {
+			return ("Unknown error");
+		}
+	}
+
+	BE::DataInterchange::AN2KIngestSummary
+	ingest(
+	    const std::vector<Input> &inputs,
+	    const BE::DataInterchange::AN2KIngestStores &stores,
+	    const BE::DataInterchange::AN2KIngestOptions &options)
+	{
+		if (options.maxPending == 0)
+			throw BE::Error::ParameterError("maxPending must not "
+			    "be 0");
+		if (inputs.empty())
+			return (BE::DataInterchange::AN2KIngestSummary());
+		return (Ingest(inputs, stores, options).run());
+	}
+}
+
+Ingest::Ingest(
+    const std::vector<Input> &inputs,
+    const BE::DataInterchange::AN2KIngestStores &stores,
+    const BE::DataInterchange::AN2KIngestOptions &options) :
+    _inputs{inputs},
+    _stores{stores},
+    _options{options}
+{
+
+}
+
+Extracted
+Ingest::extract(
+    const Input &input)
+    const
+{
+	using RecordType = BE::View::AN2KView::RecordType;
+	Extracted extracted{};
+	auto &records = extracted.records;
+	const auto key = [&](RecordType type, uint32_t n) {
+		return (input.key + "_" + std::to_string(
+		    static_cast<unsigned int>(type)) + "_" + std::to_string(n));
+	};
+
+	try {
+		/* Parsed only when views are extracted */
+		const BE::Memory::ByteSpan buf = BE::IO::Utility::mapFile(
+		    input.path);
+		const BE::DataInterchange::AN2KRecord record(buf,
+		    BE::DataInterchange::AN2KRecord::Construction::Lazy);
+
+		if (this->_stores.minutiae) {
+			uint32_t n = 0;
+			for (const auto &entry : record.getRecordIndex())
+				if (entry.type == RecordType::Type_9)
+					records.push_back({
+					    this->_stores.minutiae.get(),
+					    key(entry.type, ++n),
+					    buf.subspan(entry.offset,
+					    entry.length)});
+		}
+		if (this->_stores.fingerLatents)
+			for (uint32_t i = 0; i < record.getFingerLatentCount();
+			    i++)
+				records.push_back({
+				    this->_stores.fingerLatents.get(),
+				    key(RecordType::Type_13, i + 1),
+				    record.getFingerLatent(i).getImageData()});
+		if (this->_stores.fingerCaptures)
+			for (uint32_t i = 0; i < record.getFingerCaptureCount();
+			    i++)
+				records.push_back({
+				    this->_stores.fingerCaptures.get(),
+				    key(RecordType::Type_14, i + 1),
+				    record.getFingerCapture(i).getImageData()});
+		if (this->_stores.palmCaptures)
+			for (uint32_t i = 0; i < record.getPalmCaptureCount();
+			    i++)
+				records.push_back({
+				    this->_stores.palmCaptures.get(),
+				    key(RecordType::Type_15, i + 1),
+				    record.getPalmCapture(i).getImageData()});
+	} catch (...) {
+		extracted.records.clear();
+		extracted.error = std::current_exception();
+	}
+	return (extracted);
+}
+
+void
+Ingest::work()
+{
+	for (;;) {
+		uint64_t index;
+		{
+			std::unique_lock<std::mutex> lock(this->_mutex);
+			this->_changed.wait(lock, [&]() {
+				return (this->_cancelled ||
+				    (this->_claimed == this->_inputs.size()) ||
+				    (this->_claimed - this->_consumed <
+				    this->_options.maxPending));
+			});
+			if (this->_cancelled ||
+			    (this->_claimed == this->_inputs.size()))
+				return;
+			index = this->_claimed++;
+		}
+
+		Extracted extracted = this->extract(this->_inputs[index]);
+
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		if (this->_cancelled)
+			return;
+		this->_done.emplace(index, std::move(extracted));
+		this->_changed.notify_all();
+	}
+}
+
+bool
+Ingest::consume(
+    const Input &input,
+    Extracted &&extracted,
+    BE::DataInterchange::AN2KIngestSummary &summary)
+{
+	summary.files++;
+	if (!extracted.error) {
+		std::vector<Output>::size_type inserted = 0;
+		try {
+			for (const auto &record : extracted.records) {
+				record.store->insert(record.key,
+				    record.data.data(), record.data.size());
+				inserted++;
+			}
+			summary.records += inserted;
+			return (true);
+		} catch (const BE::Error::Exception&) {
+			extracted.error = std::current_exception();
+		}
+
+		/* A file is ingested entirely or not at all */
+		for (std::vector<Output>::size_type i = 0; i < inserted; i++) {
+			const auto &record = extracted.records[i];
+			try {
+				record.store->remove(record.key);
+			} catch (const BE::Error::Exception&) {
+				/* The insertion failure is still logged */
+			}
+		}
+	}
+
+	summary.failures++;
+	if (this->_options.logsheet)
+		this->_options.logsheet->write(input.path + ": " +
+		    describe(extracted.error));
+	return (false);
+}
+
+void
+Ingest::stop(
+    std::vector<std::thread> &threads)
+{
+	{
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		this->_cancelled = true;
+		this->_changed.notify_all();
+	}
+	for (auto &thread : threads)
+		thread.join();
+}
+
+BE::DataInterchange::AN2KIngestSummary
+Ingest::run()
+{
+	std::vector<std::thread> threads;
+	try {
+		const uint32_t count = getThreadCount(this->_options.threads,
+		    this->_inputs.size());
+		for (uint32_t i = 0; i < count; i++)
+			threads.emplace_back(&Ingest::work, this);
+	} catch (...) {
+		this->stop(threads);
+		throw;
+	}
+
+	BE::DataInterchange::AN2KIngestSummary summary{};
+	while (this->_consumed < this->_inputs.size()) {
+		uint64_t index;
+		Extracted extracted;
+		{
+			std::unique_lock<std::mutex> lock(this->_mutex);
+			this->_changed.wait(lock, [&]() {
+				return (this->_options.ordered ?
+				    (this->_done.count(this->_consumed) != 0) :
+				    !this->_done.empty());
+			});
+
+			const auto done = this->_options.ordered ?
+			    this->_done.find(this->_consumed) :
+			    this->_done.begin();
+			index = done->first;
+			extracted = std::move(done->second);
+			this->_done.erase(done);
+		}
+
+		try {
+			this->consume(this->_inputs[index],
+			    std::move(extracted), summary);
+		} catch (...) {
+			this->stop(threads);
+			throw;
+		}
+
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		this->_consumed++;
+		this->_changed.notify_all();
+	}
+
+	for (auto &thread : threads)
+		thread.join();
+	return (summary);
+}
+
+BiometricEvaluation::DataInterchange::AN2KIngestSummary
+BiometricEvaluation::DataInterchange::ingestAN2K(
+    const std::vector<std::string> &paths,
+    const AN2KIngestStores &stores,
+    const AN2KIngestOptions &options)
+{
+	std::vector<Input> inputs;
+	inputs.reserve(paths.size());
+	for (const auto &path : paths)
+		inputs.push_back({path, pathToKey(path)});
+	return (ingest(inputs, stores, options));
+}
+
+BiometricEvaluation::DataInterchange::AN2KIngestSummary
+BiometricEvaluation::DataInterchange::ingestAN2KDirectory(
+    const std::string &directory,
+    const AN2KIngestStores &stores,
+    const AN2KIngestOptions &options)
+{
+	if (!IO::Utility::pathIsDirectory(directory))
+		throw Error::ObjectDoesNotExist(directory);
+
+	std::vector<Input> inputs;
+	listFiles(directory, "", options.extensions, inputs);
+	return (ingest(inputs, stores, options));
+}
@@ -0,0 +1,183 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cctype>
+#include <cstdlib>
+#include <string>
+
+#include <be_data_interchange_an2kreader.h>
+#include <be_error_exception.h>
+#include <be_io_utility.h>
+extern "C" {
+#include <an2k.h>
+}
+
+namespace BE = BiometricEvaluation;
+
+namespace
+{
+	/*
+	 * Length of the logical record of type recordType at offset in buf,
+	 * read from its first field without parsing the record.
+	 */
+	uint64_t
+	recordLength(
+	    const BE::Memory::ByteSpan &buf,
+	    const uint64_t offset,
+	    const unsigned int recordType)
+	{
+		const uint8_t *record = buf.data() + offset;
+		const uint64_t available = buf.size() - offset;
+		uint64_t length = 0;
+
+		if (biomeval_nbis_binary_record(recordType)) {
+			/* Four-byte, big-endian length */
+			if (available < BINARY_LEN_BYTES)
+				throw BE::Error::DataError("AN2K record "
+				    "truncated");
+			for (int i = 0; i < BINARY_LEN_BYTES; i++)
+				length = (length << 8) | record[i];
+		} else if (biomeval_nbis_tagged_record(recordType)) {
+			/* "<type>.001:<length><GS>", or ".01:" */
+			uint64_t i = 0;
+			unsigned int type = 0;
+			for (; i < available && std::isdigit(record[i]); i++)
+				type = (type * 10) + (record[i] - '0');
+			if (i == 0 || type != recordType)
+				throw BE::Error::DataError("AN2K record type "
+				    "does not match field CNT");
+			while (i < available && record[i] != ':')
+				if (record[i++] != '.' &&
+				    !std::isdigit(record[i - 1]))
+					throw BE::Error::DataError("Invalid "
+					    "AN2K field LEN");
+			const uint64_t digits = ++i;
+			for (; i < available && std::isdigit(record[i]); i++)
+				length = (length * 10) + (record[i] - '0');
+			if (i == digits || i == available || (record[i] !=
+			    GS_CHAR && record[i] != FS_CHAR))
+				throw BE::Error::DataError("Invalid AN2K "
+				    "field LEN");
+		} else {
+			throw BE::Error::DataError("Unsupported AN2K record "
+			    "type " + std::to_string(recordType));
+		}
+
+		if (length == 0 || length > available)
+			throw BE::Error::DataError("AN2K record truncated");
+		return (length);
+	}
+}
+
+/******************************************************************************/
+/* Private functions.                                                         */
+/******************************************************************************/
+void
+BiometricEvaluation::DataInterchange::AN2KReader::readType1Record()
+{
+	AN2KBDB bdb;
+	INIT_AN2KBDB(&bdb, const_cast<uint8_t *>(this->_buf.data()),
+	    this->_buf.size());
+	RECORD *type1;
+	unsigned int version;
+	if (biomeval_nbis_scan_Type1_record(&bdb, &type1, &version) != 0)
+		throw Error::DataError("Could not read AN2K Type-1 record");
+	this->_type1.reset(type1, &biomeval_nbis_free_ANSI_NIST_record);
+	this->_type1Length = bdb.bdb_current - bdb.bdb_start;
+
+	/* CNT lists the type and IDC of every record after the Type-1 */
+	FIELD *cnt;
+	int cnt_idx;
+	if (biomeval_nbis_lookup_ANSI_NIST_field(&cnt, &cnt_idx, CNT_ID,
+	    type1) != TRUE)
+		throw Error::DataError("Field CNT not found");
+	this->_contents.emplace_back(TYPE_1_ID, 0);
+	for (int i = 1; i < cnt->num_subfields; i++) {
+		if (cnt->subfields[i]->num_items != 2)
+			throw Error::DataError("Invalid number of items in "
+			    "field CNT");
+		this->_contents.emplace_back(std::atoi(
+		    (char *)cnt->subfields[i]->items[0]->value),
+		    std::atoi((char *)cnt->subfields[i]->items[1]->value));
+	}
+}
+
+/******************************************************************************/
+/* Public functions.                                                          */
+/******************************************************************************/
+BiometricEvaluation::DataInterchange::AN2KReader::AN2KReader(
+    const std::string &pathname)
+{
+	try {
+		this->_buf = IO::Utility::mapFile(pathname);
+	} catch (const Error::ObjectDoesNotExist&) {
+		throw Error::FileError("File not found.");
+	} catch (const Error::StrategyError &e) {
+		throw Error::FileError(e.whatString());
+	}
+	this->readType1Record();
+}
+
+BiometricEvaluation::DataInterchange::AN2KReader::AN2KReader(
+    const Memory::ByteSpan &buf) :
+    _buf(buf)
+{
+	this->readType1Record();
+}
+
+uint32_t
+BiometricEvaluation::DataInterchange::AN2KReader::getRecordCount()
+    const
+{
+	return (this->_contents.size());
+}
+
+BiometricEvaluation::Memory::ByteSpan
+BiometricEvaluation::DataInterchange::AN2KReader::getData()
+    const
+{
+	return (this->_buf);
+}
+
+const RECORD *
+BiometricEvaluation::DataInterchange::AN2KReader::getType1Record()
+    const
+{
+	return (this->_type1.get());
+}
+
+BiometricEvaluation::DataInterchange::AN2KReader::Record
+BiometricEvaluation::DataInterchange::AN2KReader::sequence(
+    int cursor)
+{
+	switch (cursor) {
+	case BE_AN2KREADER_SEQ_START:
+		this->_next = 0;
+		this->_offset = 0;
+		break;
+	case BE_AN2KREADER_SEQ_NEXT:
+		break;
+	default:
+		throw Error::ParameterError("Invalid cursor position");
+	}
+	if (this->_next >= this->_contents.size())
+		throw Error::ObjectDoesNotExist("No more records");
+
+	const auto &contents = this->_contents[this->_next];
+	const uint64_t length = (this->_next == 0 ? this->_type1Length :
+	    recordLength(this->_buf, this->_offset, contents.first));
+	const Record record{static_cast<View::AN2KView::RecordType>(
+	    contents.first), contents.second, this->_offset,
+	    this->_buf.subspan(this->_offset, length)};
+
+	this->_next++;
+	this->_offset += length;
+	return (record);
+}
@@ -0,0 +1,538 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <string>
+
+#include <be_data_interchange_an2kwriter.h>
+#include <be_error_exception.h>
+#include <be_memory_mutableindexedbuffer.h>
+extern "C" {
+#include <an2k.h>
+}
+
+namespace BE = BiometricEvaluation;
+using namespace BiometricEvaluation::Framework::Enumeration;
+
+namespace
+{
+	/* Information designation character, as at least two digits */
+	std::string
+	formatIDC(
+	    const uint32_t idc)
+	{
+		return ((idc < 10 ? "0" : "") + std::to_string(idc));
+	}
+
+	/* Append "<type>.<field>:<value>" and its separator to record */
+	void
+	appendField(
+	    std::string &record,
+	    const unsigned int type,
+	    const uint16_t field,
+	    const std::string &value,
+	    const char separator = GS_CHAR)
+	{
+		const std::string number = std::to_string(field);
+		record += std::to_string(type) + '.' +
+		    std::string(3 - number.size(), '0') +
+		    number + ':' + value + separator;
+	}
+
+	/*
+	 * Prepend the LEN field to fields, the rest of a tagged record
+	 * that is followed by another following bytes. The length
+	 * includes its own digits, so the fewest digits that can hold
+	 * it are found: each digit added lengthens the record by one.
+	 */
+	std::string
+	prependLength(
+	    const unsigned int type,
+	    const std::string &fields,
+	    const uint64_t following)
+	{
+		std::string field;
+		for (size_t digits = 1; ; digits++) {
+			field.clear();
+			appendField(field, type, LEN_ID, std::string(digits,
+			    '0'));
+			const std::string length = std::to_string(
+			    field.size() + fields.size() + following);
+			if (length.size() <= digits) {
+				field.clear();
+				appendField(field, type, LEN_ID, length);
+				return (field + fields);
+			}
+		}
+	}
+
+	/* Value of the tagged field CGA */
+	std::string
+	taggedCompression(
+	    const BE::Image::CompressionAlgorithm compression)
+	{
+		switch (compression) {
+		case BE::Image::CompressionAlgorithm::None:
+			return ("NONE");
+		case BE::Image::CompressionAlgorithm::WSQ20:
+			return ("WSQ20");
+		case BE::Image::CompressionAlgorithm::JPEGB:
+			return ("JPEGB");
+		case BE::Image::CompressionAlgorithm::JPEGL:
+			return ("JPEGL");
+		case BE::Image::CompressionAlgorithm::JP2:
+			return ("JP2");
+		case BE::Image::CompressionAlgorithm::JP2L:
+			return ("JP2L");
+		case BE::Image::CompressionAlgorithm::PNG:
+			return ("PNG");
+		default:
+			throw BE::Error::ParameterError("Compression "
+			    "algorithm cannot be represented in a tagged "
+			    "AN2K record");
+		}
+	}
+
+	/* Value of the binary field CA for a record of type */
+	uint8_t
+	binaryCompression(
+	    const BE::View::AN2KView::RecordType type,
+	    const BE::Image::CompressionAlgorithm compression)
+	{
+		if (type == BE::View::AN2KView::RecordType::Type_5 ||
+		    type == BE::View::AN2KView::RecordType::Type_6) {
+			switch (compression) {
+			case BE::Image::CompressionAlgorithm::None:
+				return (0);
+			case BE::Image::CompressionAlgorithm::Facsimile:
+				return (1);
+			default:
+				break;
+			}
+		} else {
+			switch (compression) {
+			case BE::Image::CompressionAlgorithm::None:
+				return (0);
+			case BE::Image::CompressionAlgorithm::WSQ20:
+				return (1);
+			case BE::Image::CompressionAlgorithm::JPEGB:
+				return (2);
+			case BE::Image::CompressionAlgorithm::JPEGL:
+				return (3);
+			case BE::Image::CompressionAlgorithm::JP2:
+				return (4);
+			case BE::Image::CompressionAlgorithm::JP2L:
+				return (5);
+			case BE::Image::CompressionAlgorithm::PNG:
+				return (6);
+			default:
+				break;
+			}
+		}
+		throw BE::Error::ParameterError("Compression algorithm "
+		    "cannot be represented in a Type-" + std::to_string(
+		    to_int_type(type)) + " record");
+	}
+
+	/* Set the fields SLC, HPS, and VPS from resolution */
+	void
+	setResolutionFields(
+	    BE::DataInterchange::AN2KWriter::Fields &fields,
+	    const BE::Image::Resolution &resolution)
+	{
+		BE::Image::Resolution scale = resolution;
+		switch (resolution.units) {
+		case BE::Image::Resolution::Units::NA:
+			fields[SLC_ID] = "0";
+			break;
+		case BE::Image::Resolution::Units::PPI:
+			fields[SLC_ID] = "1";
+			break;
+		case BE::Image::Resolution::Units::PPMM:
+			scale = resolution.toUnits(
+			    BE::Image::Resolution::Units::PPCM);
+			/* FALLTHROUGH */
+		case BE::Image::Resolution::Units::PPCM:
+			fields[SLC_ID] = "2";
+			break;
+		}
+		fields[HPS_ID] = std::to_string(std::lround(scale.xRes));
+		fields[VPS_ID] = std::to_string(std::lround(scale.yRes));
+	}
+
+	/* Set the image fields of a variable resolution record */
+	void
+	setImageFields(
+	    BE::DataInterchange::AN2KWriter::Fields &fields,
+	    const BE::Image::Size &size,
+	    const BE::Image::Resolution &resolution,
+	    const BE::Image::CompressionAlgorithm compression,
+	    const uint32_t colorDepth)
+	{
+		fields[HLL_ID] = std::to_string(size.xSize);
+		fields[VLL_ID] = std::to_string(size.ySize);
+		setResolutionFields(fields, resolution);
+		fields[TAG_CA_ID] = taggedCompression(compression);
+		fields[BPX_ID] = std::to_string(colorDepth);
+	}
+}
+
+BiometricEvaluation::DataInterchange::AN2KWriter::AN2KWriter(
+    const std::string &tot,
+    const std::string &dai,
+    const std::string &ori,
+    const std::string &tcn,
+    const std::string &date,
+    const std::string &version,
+    const std::string &nsr,
+    const std::string &ntr) :
+    _type1{{VER_ID, version}, {TOT_ID, tot}, {DAT_ID, date},
+    {DAI_ID, dai}, {ORI_ID, ori}, {TCN_ID, tcn}, {NSR_ID, nsr},
+    {NTR_ID, ntr}}
+{
+
+}
+
+void
+BiometricEvaluation::DataInterchange::AN2KWriter::setType1Field(
+    const uint16_t field,
+    const std::string &value)
+{
+	if (field == 0 || field > 999)
+		throw Error::ParameterError("Invalid field number");
+	if (field == LEN_ID || field == CNT_ID)
+		throw Error::ParameterError("Fields LEN and CNT are computed");
+
+	this->_type1[field] = value;
+}
+
+void
+BiometricEvaluation::DataInterchange::AN2KWriter::addRecord(
+    const AN2KReader::Record &record)
+{
+	if (record.type == View::AN2KView::RecordType::Type_1)
+		throw Error::ParameterError("The Type-1 record is computed");
+	if (record.data.empty())
+		throw Error::ParameterError("Record is empty");
+
+	this->addRecord(Record{to_int_type(record.type), record.idc, "",
+	    record.data, ""});
+}
+
+void
+BiometricEvaluation::DataInterchange::AN2KWriter::addTaggedRecord(
+    const View::AN2KView::RecordType type,
+    const uint32_t idc,
+    const Fields &fields,
+    const Memory::ByteSpan &data)
+{
+	const unsigned int recordType = to_int_type(type);
+	if (type == View::AN2KView::RecordType::Type_1 ||
+	    !biomeval_nbis_tagged_record(recordType))
+		throw Error::ParameterError("Not a tagged record type");
+
+	Record record{recordType, idc, "", data, ""};
+	std::string rest;
+	appendField(rest, recordType, IDC_ID, formatIDC(idc),
+	    (fields.empty() && data.empty()) ? FS_CHAR : GS_CHAR);
+	for (auto it = fields.cbegin(); it != fields.cend(); it++) {
+		if (it->first == LEN_ID || it->first == IDC_ID ||
+		    it->first == 0 || it->first > 999 ||
+		    (it->first == DAT2_ID && !data.empty()))
+			throw Error::ParameterError("Invalid field number " +
+			    std::to_string(it->first));
+		appendField(rest, recordType, it->first, it->second,
+		    (std::next(it) == fields.cend() && data.empty()) ?
+		    FS_CHAR : GS_CHAR);
+	}
+	if (!data.empty()) {
+		/* Image data is last, and ends the record */
+		appendField(rest, recordType, DAT2_ID, "", FS_CHAR);
+		rest.pop_back();
+		record.trailer = FS_CHAR;
+	}
+
+	record.header = prependLength(recordType, rest, data.size() +
+	    record.trailer.size());
+	this->addRecord(std::move(record));
+}
+
+void
+BiometricEvaluation::DataInterchange::AN2KWriter::addFixedResolutionRecord(
+    const View::AN2KView::RecordType type,
+    const uint32_t idc,
+    const Finger::Impression impression,
+    const Finger::PositionSet &positions,
+    const bool nativeResolution,
+    const Image::Size &size,
+    const Image::CompressionAlgorithm compression,
+    const Memory::ByteSpan &data)
+{
+	const unsigned int recordType = to_int_type(type);
+	if (!biomeval_nbis_binary_record(recordType) ||
+	    type == View::AN2KView::RecordType::Type_7 ||
+	    type == View::AN2KView::RecordType::Type_8)
+		throw Error::ParameterError("Not a fixed resolution "
+		    "record type");
+	if (idc > 255)
+		throw Error::ParameterError("IDC out of range");
+	if (positions.size() > 6)
+		throw Error::ParameterError("Too many finger positions");
+	if (size.xSize > 65535 || size.ySize > 65535)
+		throw Error::ParameterError("Image is too large");
+
+	/*
+	 * LEN (4), IDC (1), IMP (1), FGP (6), ISR (1), HLL (2), VLL (2),
+	 * and CA (1), all big-endian.
+	 */
+	static const uint64_t HeaderLength = 18;
+	Record record{recordType, idc, std::string(HeaderLength, '\0'),
+	    data, ""};
+	Memory::MutableIndexedBuffer buf(reinterpret_cast<uint8_t*>(
+	    &record.header[0]), HeaderLength);
+	const uint64_t length = HeaderLength + data.size();
+	if (length > UINT32_MAX)
+		throw Error::ParameterError("Image data is too large");
+	buf.pushBeU32Val(static_cast<uint32_t>(length));
+	buf.pushU8Val(static_cast<uint8_t>(idc));
+	buf.pushU8Val(static_cast<uint8_t>(to_int_type(impression)));
+	/* Unused finger positions are 255 */
+	for (size_t i = 0; i < 6; i++) {
+		if (i < positions.size())
+			buf.pushU8Val(static_cast<uint8_t>(to_int_type(
+			    positions[i])));
+		else if (i == 0)
+			buf.pushU8Val(to_int_type(Finger::Position::Unknown));
+		else
+			buf.pushU8Val(255);
+	}
+	buf.pushU8Val(nativeResolution ? 1 : 0);
+	buf.pushBeU16Val(static_cast<uint16_t>(size.xSize));
+	buf.pushBeU16Val(static_cast<uint16_t>(size.ySize));
+	buf.pushU8Val(binaryCompression(type, compression));
+
+	this->addRecord(std::move(record));
+}
+
+void
+BiometricEvaluation::DataInterchange::AN2KWriter::addView(
+    const Finger::AN2KViewFixedResolution &view,
+    const uint32_t idc)
+{
+	/* Type-3 and Type-5 records are at half the minimum resolution */
+	const double minimum = (view.getRecordType() ==
+	    View::AN2KView::RecordType::Type_3 || view.getRecordType() ==
+	    View::AN2KView::RecordType::Type_5) ?
+	    View::AN2KView::HalfMinimumScanResolutionPPMM :
+	    View::AN2KView::MinimumScanResolutionPPMM;
+
+	this->addFixedResolutionRecord(view.getRecordType(), idc,
+	    view.getImpressionType(), view.getPositions(),
+	    view.getImageResolution().xRes != minimum, view.getImageSize(),
+	    view.getCompressionAlgorithm(), view.getImageData());
+}
+
+void
+BiometricEvaluation::DataInterchange::AN2KWriter::addView(
+    const Finger::AN2KViewCapture &view,
+    const uint32_t idc)
+{
+	Fields fields = getVariableResolutionFields(view);
+	fields[FGP3_ID] = std::to_string(to_int_type(view.getPosition()));
+
+	this->addTaggedRecord(View::AN2KView::RecordType::Type_14, idc,
+	    fields, view.getImageData());
+}
+
+void
+BiometricEvaluation::DataInterchange::AN2KWriter::addView(
+    const Latent::AN2KView &view,
+    const uint32_t idc)
+{
+	Fields fields = getVariableResolutionFields(view);
+	std::string positions;
+	for (const auto &fgp : view.getPositions()) {
+		if (!positions.empty())
+			positions += RecordSeparator;
+		switch (fgp.posType) {
+		case Feature::PositionType::Finger:
+			positions += std::to_string(to_int_type(
+			    fgp.position.fingerPos));
+			break;
+		case Feature::PositionType::Palm:
+			positions += std::to_string(to_int_type(
+			    fgp.position.palmPos));
+			break;
+		case Feature::PositionType::Plantar:
+			positions += std::to_string(to_int_type(
+			    fgp.position.plantarPos));
+			break;
+		}
+	}
+	fields[FGP3_ID] = positions;
+
+	this->addTaggedRecord(View::AN2KView::RecordType::Type_13, idc,
+	    fields, view.getImageData());
+}
+
+void
+BiometricEvaluation::DataInterchange::AN2KWriter::addView(
+    const Palm::AN2KView &view,
+    const uint32_t idc)
+{
+	Fields fields = getVariableResolutionFields(view);
+	fields[FGP3_ID] = std::to_string(to_int_type(view.getPosition()));
+
+	this->addTaggedRecord(View::AN2KView::RecordType::Type_15, idc,
+	    fields, view.getImageData());
+}
+
+void
+BiometricEvaluation::DataInterchange::AN2KWriter::addFingerImage(
+    const Image::Image &image,
+    const uint32_t idc,
+    const Finger::Position position,
+    const Finger::Impression impression,
+    const std::string &sourceAgency,
+    const std::string &captureDate)
+{
+	Fields fields{{IMP_ID, std::to_string(to_int_type(impression))},
+	    {SRC_ID, sourceAgency}, {CD_ID, captureDate},
+	    {FGP3_ID, std::to_string(to_int_type(position))}};
+	setImageFields(fields, image.getDimensions(), image.getResolution(),
+	    image.getCompressionAlgorithm(), image.getColorDepth());
+
+	this->addTaggedRecord(View::AN2KView::RecordType::Type_14, idc,
+	    fields, image.getDataSpan());
+}
+
+uint32_t
+BiometricEvaluation::DataInterchange::AN2KWriter::getRecordCount()
+    const
+{
+	return (static_cast<uint32_t>(this->_records.size() + 1));
+}
+
+uint64_t
+BiometricEvaluation::DataInterchange::AN2KWriter::getLength()
+    const
+{
+	return (this->formatType1Record().size() + this->_recordsLength);
+}
+
+BiometricEvaluation::Memory::uint8Array
+BiometricEvaluation::DataInterchange::AN2KWriter::write()
+    const
+{
+	const std::string type1 = this->formatType1Record();
+	Memory::uint8Array buf(type1.size() + this->_recordsLength);
+	this->write(type1, buf, buf.size());
+	return (buf);
+}
+
+uint64_t
+BiometricEvaluation::DataInterchange::AN2KWriter::write(
+    uint8_t *buf,
+    const uint64_t size)
+    const
+{
+	const std::string type1 = this->formatType1Record();
+	const uint64_t length = type1.size() + this->_recordsLength;
+	if (size < length)
+		throw Error::ParameterError("Buffer is smaller than the "
+		    "transaction");
+	this->write(type1, buf, size);
+	return (length);
+}
+
+void
+BiometricEvaluation::DataInterchange::AN2KWriter::write(
+    IO::RecordStore &store,
+    const std::string &key)
+    const
+{
+	store.insert(key, this->write());
+}
+
+void
+BiometricEvaluation::DataInterchange::AN2KWriter::addRecord(
+    Record &&record)
+{
+	this->_recordsLength += record.header.size() + record.data.size() +
+	    record.trailer.size();
+	this->_records.push_back(std::move(record));
+}
+
+std::string
+BiometricEvaluation::DataInterchange::AN2KWriter::formatType1Record()
+    const
+{
+	/* "1<US><count><RS><type><US><IDC>..." */
+	std::string contents = std::to_string(TYPE_1_ID) + UnitSeparator +
+	    std::to_string(this->_records.size());
+	for (const auto &record : this->_records)
+		contents += RecordSeparator + std::to_string(record.type) +
+		    UnitSeparator + formatIDC(record.idc);
+
+	std::string rest;
+	bool listed = false;
+	for (auto it = this->_type1.cbegin(); it != this->_type1.cend();
+	    it++) {
+		if (!listed && it->first > CNT_ID) {
+			appendField(rest, TYPE_1_ID, CNT_ID, contents);
+			listed = true;
+		}
+		appendField(rest, TYPE_1_ID, it->first, it->second,
+		    std::next(it) == this->_type1.cend() ? FS_CHAR : GS_CHAR);
+	}
+	if (!listed)
+		appendField(rest, TYPE_1_ID, CNT_ID, contents, FS_CHAR);
+
+	return (prependLength(TYPE_1_ID, rest, 0));
+}
+
+void
+BiometricEvaluation::DataInterchange::AN2KWriter::write(
+    const std::string &type1,
+    uint8_t *buf,
+    const uint64_t size)
+    const
+{
+	Memory::MutableIndexedBuffer out(buf, size);
+	out.push(type1.data(), type1.size());
+	for (const auto &record : this->_records) {
+		if (!record.header.empty())
+			out.push(record.header.data(), record.header.size());
+		if (!record.data.empty())
+			out.push(record.data.data(), record.data.size());
+		if (!record.trailer.empty())
+			out.push(record.trailer.data(),
+			    record.trailer.size());
+	}
+}
+
+BiometricEvaluation::DataInterchange::AN2KWriter::Fields
+BiometricEvaluation::DataInterchange::AN2KWriter::getVariableResolutionFields(
+    const View::AN2KViewVariableResolution &view)
+{
+	Fields fields{
+	    {IMP_ID, std::to_string(to_int_type(view.getImpressionType()))},
+	    {SRC_ID, view.getSourceAgency()},
+	    {CD_ID, view.getCaptureDate()}};
+	setImageFields(fields, view.getImageSize(),
+	    view.getImageResolution(), view.getCompressionAlgorithm(),
+	    view.getImageColorDepth());
+	const std::string comment = view.getComment();
+	if (!comment.empty())
+		fields[COM_ID] = comment;
+	return (fields);
+}
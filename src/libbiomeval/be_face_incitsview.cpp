@@ -288,7 +288,7 @@ BiometricEvaluation::Face::INCITSView::readFaceView(
 	    Image::Resolution(0, 0, BE::Image::Resolution::Units::NA));
 	BE::Memory::uint8Array imageData(remainLen);
 	buf.scan(&imageData[0], remainLen);
-	this->setImageData(imageData);
+	this->setImageData(BE::Memory::ByteSpan::share(std::move(imageData)));
 }
 
 /******************************************************************************/
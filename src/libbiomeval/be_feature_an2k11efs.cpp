@@ -534,13 +534,29 @@ BiometricEvaluation::Feature::AN2K11EFS::ExtendedFeatureSet::ExtendedFeatureSet(
 }
 
 BiometricEvaluation::Feature::AN2K11EFS::ExtendedFeatureSet::ExtendedFeatureSet(
-    Memory::uint8Array &buf,
+    const Memory::ByteSpan &buf,
     int recordNumber)
 {
 	this->pimpl.reset(new Feature::AN2K11EFS::ExtendedFeatureSet::Impl(
 	    buf, recordNumber));
 }
 
+BiometricEvaluation::Feature::AN2K11EFS::ExtendedFeatureSet::ExtendedFeatureSet(
+    const Memory::uint8Array &buf,
+    int recordNumber) :
+    ExtendedFeatureSet(Memory::ByteSpan(buf), recordNumber)
+{
+
+}
+
+BiometricEvaluation::Feature::AN2K11EFS::ExtendedFeatureSet::ExtendedFeatureSet(
+    const std::shared_ptr<const ANSI_NIST> &an2k,
+    int recordNumber)
+{
+	this->pimpl.reset(new Feature::AN2K11EFS::ExtendedFeatureSet::Impl(
+	    an2k.get(), recordNumber));
+}
+
 BiometricEvaluation::Feature::AN2K11EFS::ExtendedFeatureSet::~ExtendedFeatureSet()
 {
 }
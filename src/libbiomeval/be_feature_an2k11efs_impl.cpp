@@ -8,6 +8,7 @@
  * about its quality, reliability, or any other characteristic.
  */
 #include <map>
+#include <be_data_interchange_an2k.h>
 #include <be_framework_enumeration.h>
 #include <be_io_utility.h>
 #include <be_memory_autobuffer.h>
@@ -27,14 +28,24 @@ BiometricEvaluation::Feature::AN2K11EFS::ExtendedFeatureSet::Impl::Impl(
 {
 	/* Let exceptions float out. */
 	BE::Memory::uint8Array buf = BE::IO::Utility::readFile(filename);
-	readType9Record(buf, recordNumber);
+	readType9Record(DataInterchange::AN2KRecord::parse(
+	    BE::Memory::ByteSpan(buf)).get(),
+	    recordNumber);
 }
 
 BiometricEvaluation::Feature::AN2K11EFS::ExtendedFeatureSet::Impl::Impl(
-    Memory::uint8Array &buf,
+    const Memory::ByteSpan &buf,
     int recordNumber)
 {
-	readType9Record(buf, recordNumber);
+	readType9Record(DataInterchange::AN2KRecord::parse(buf).get(),
+	    recordNumber);
+}
+
+BiometricEvaluation::Feature::AN2K11EFS::ExtendedFeatureSet::Impl::Impl(
+    const ANSI_NIST *an2k,
+    int recordNumber)
+{
+	readType9Record(an2k, recordNumber);
 }
 
 BiometricEvaluation::Feature::AN2K11EFS::ExtendedFeatureSet::Impl::~Impl()
@@ -1038,19 +1049,9 @@ readMRCI(
 
 void
 BiometricEvaluation::Feature::AN2K11EFS::ExtendedFeatureSet::Impl::readType9Record(
-    Memory::uint8Array &buf,
+    const ANSI_NIST *an2k,
     int recordNumber)
 {
-	Memory::AutoBuffer<ANSI_NIST> an2k =
-	    Memory::AutoBuffer<ANSI_NIST>(&biomeval_nbis_alloc_ANSI_NIST,
-		&biomeval_nbis_free_ANSI_NIST, &biomeval_nbis_copy_ANSI_NIST);
-
-	AN2KBDB bdb;
-	INIT_AN2KBDB(&bdb, buf, buf.size());
-	if (biomeval_nbis_scan_ANSI_NIST(&bdb, an2k) != 0)
-		throw BE::Error::DataError(
-		    "Could not read complete AN2K record");
-
 	/*
 	 * Find the requested Type-9 in the file, throwing an exception
 	 * if not present. The first record in an AN2K file is always
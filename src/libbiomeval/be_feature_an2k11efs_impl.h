@@ -75,7 +75,16 @@ namespace BiometricEvaluation
 			 *	for the requested number.
 			 */
 			Impl(
-			    Memory::uint8Array &buf,
+			    const Memory::ByteSpan &buf,
+			    int recordNumber);
+
+			/**
+			 * @brief
+			 * Construct an ExtendedFeatureSet object from a
+			 * shared parse tree of a complete ANSI/NIST record.
+			 */
+			Impl(
+			    const ANSI_NIST *an2k,
 			    int recordNumber);
 
 			~Impl();
@@ -116,7 +125,7 @@ namespace BiometricEvaluation
 			std::vector<AN2K11EFS::Pattern> _pat{};
 
 			void readType9Record(
-			    Memory::uint8Array &buf,
+			    const ANSI_NIST *an2k,
     			    int recordNumber);
 		};
 	}
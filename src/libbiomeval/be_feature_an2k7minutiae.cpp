@@ -7,12 +7,10 @@
  * its use by other parties, and makes no guarantees, expressed or implied,
  * about its quality, reliability, or any other characteristic.
  */
-#include <cstdio>
-
+#include <be_data_interchange_an2k.h>
 #include <be_finger_an2kview.h>
 #include <be_feature_an2k7minutiae.h>
 #include <be_memory_autobuffer.h>
-#include <be_io_utility.h>
 extern "C" {
 #include <an2k.h>
 }
@@ -38,23 +36,9 @@ BiometricEvaluation::Feature::AN2K7Minutiae::AN2K7Minutiae(
     const std::string &filename,
     int recordNumber)
 {
-
-	if (!IO::Utility::fileExists(filename))
-		throw (BE::Error::FileError("File not found."));
-
-	FILE *fp = std::fopen(filename.c_str(), "rb");
-	if (fp == nullptr)
-		throw (BE::Error::FileError("Could not open file."));
-
-	uint64_t sz = IO::Utility::getFileSize(filename);
-	Memory::uint8Array buf(sz);
-	if (fread(buf, 1, sz, fp) != sz) {
-		fclose(fp);
-		throw BE::Error::FileError("Could not read AN2K file");
-	}
-        fclose(fp);
-	
-	readType9Record(buf, recordNumber);
+	readType9Record(DataInterchange::AN2KRecord::parse(
+	    DataInterchange::AN2KRecord::mapFile(filename)).get(),
+	    recordNumber);
 }
 
 BiometricEvaluation::Feature::MinutiaeFormat
@@ -64,10 +48,26 @@ BiometricEvaluation::Feature::AN2K7Minutiae::getFormat() const
 }
 
 BiometricEvaluation::Feature::AN2K7Minutiae::AN2K7Minutiae(
-    Memory::uint8Array &buf,
+    const Memory::ByteSpan &buf,
     int recordNumber)
 {
-	readType9Record(buf, recordNumber);
+	readType9Record(DataInterchange::AN2KRecord::parse(buf).get(),
+	    recordNumber);
+}
+
+BiometricEvaluation::Feature::AN2K7Minutiae::AN2K7Minutiae(
+    const Memory::uint8Array &buf,
+    int recordNumber) :
+    AN2K7Minutiae(Memory::ByteSpan(buf), recordNumber)
+{
+
+}
+
+BiometricEvaluation::Feature::AN2K7Minutiae::AN2K7Minutiae(
+    const std::shared_ptr<const ANSI_NIST> &an2k,
+    int recordNumber)
+{
+	readType9Record(an2k.get(), recordNumber);
 }
 
 BiometricEvaluation::Feature::AN2K7Minutiae::FingerprintReadingSystem
@@ -348,19 +348,9 @@ BiometricEvaluation::Feature::AN2K7Minutiae::convertCoordinate(
 
 void
 BiometricEvaluation::Feature::AN2K7Minutiae::readType9Record(
-    Memory::uint8Array &buf,
+    const ANSI_NIST *an2k,
     int recordNumber)
 {
-	Memory::AutoBuffer<ANSI_NIST> an2k =
-	    Memory::AutoBuffer<ANSI_NIST>(&biomeval_nbis_alloc_ANSI_NIST,
-		&biomeval_nbis_free_ANSI_NIST, &biomeval_nbis_copy_ANSI_NIST);
-
-	AN2KBDB bdb;
-	INIT_AN2KBDB(&bdb, buf, buf.size());
-	if (biomeval_nbis_scan_ANSI_NIST(&bdb, an2k) != 0)
-		throw BE::Error::DataError(
-		    "Could not read complete AN2K record");
-
 	/*
 	 * Find the requested Type-9 in the file, throwing an exception
 	 * if not present. The first record in an AN2K file is always
@@ -8,9 +8,9 @@
  * about its quality, reliability, or any other characteristic.
  */
 
+#include <be_data_interchange_an2k.h>
 #include <be_finger_an2kview.h>
 #include <be_finger_an2kminutiae_data_record.h>
-#include <be_io_utility.h>
 #include <be_memory_autobuffer.h>
 extern "C" {
 #include <an2k.h>
@@ -20,29 +20,30 @@ BiometricEvaluation::Finger::AN2KMinutiaeDataRecord::AN2KMinutiaeDataRecord(
     const std::string &filename,
     int recordNumber)
 {
-	if (IO::Utility::fileExists(filename) == false)
-		throw (Error::FileError("File not found."));
+	readType9Record(DataInterchange::AN2KRecord::parse(
+	    DataInterchange::AN2KRecord::mapFile(filename)), recordNumber);
+}
 
-	FILE *fp = std::fopen(filename.c_str(), "rb");
-	if (fp == nullptr)
-		throw (Error::FileError("Could not open file."));
+BiometricEvaluation::Finger::AN2KMinutiaeDataRecord::AN2KMinutiaeDataRecord(
+    const Memory::ByteSpan &buf,
+    int recordNumber)
+{
+	readType9Record(DataInterchange::AN2KRecord::parse(buf), recordNumber);
+}
+
+BiometricEvaluation::Finger::AN2KMinutiaeDataRecord::AN2KMinutiaeDataRecord(
+    const Memory::uint8Array &buf,
+    int recordNumber) :
+    AN2KMinutiaeDataRecord(Memory::ByteSpan(buf), recordNumber)
+{
 
-	uint64_t sz = IO::Utility::getFileSize(filename);
-	Memory::uint8Array buf(sz);
-	if (fread(buf, 1, sz, fp) != sz) {
-		fclose(fp);
-		throw Error::FileError("Could not read AN2K file");
-	}
-        fclose(fp);
-	
-	readType9Record(buf, recordNumber);
 }
 
 BiometricEvaluation::Finger::AN2KMinutiaeDataRecord::AN2KMinutiaeDataRecord(
-    Memory::uint8Array &buf,
+    const std::shared_ptr<const ANSI_NIST> &an2k,
     int recordNumber)
 {
-	readType9Record(buf, recordNumber);
+	readType9Record(an2k, recordNumber);
 }
 
 /******************************************************************************/
@@ -215,18 +216,9 @@ BiometricEvaluation::Finger::AN2KMinutiaeDataRecord::readRegisteredVendorBlock(
 
 void
 BiometricEvaluation::Finger::AN2KMinutiaeDataRecord::readType9Record(
-    Memory::uint8Array &buf,
+    const std::shared_ptr<const ANSI_NIST> &an2k,
     int recordNumber)
 {
-	Memory::AutoBuffer<ANSI_NIST> an2k =
-	    Memory::AutoBuffer<ANSI_NIST>(&biomeval_nbis_alloc_ANSI_NIST,
-		&biomeval_nbis_free_ANSI_NIST, &biomeval_nbis_copy_ANSI_NIST);
-
-	AN2KBDB bdb;
-	INIT_AN2KBDB(&bdb, buf, buf.size());
-	if (biomeval_nbis_scan_ANSI_NIST(&bdb, an2k) != 0)
-		throw Error::DataError("Could not read complete AN2K record");
-
 	/*
 	 * Find the requested Type-9 in the file, throwing an exception
 	 * if not present. The first record in an AN2K file is always
@@ -257,7 +249,7 @@ BiometricEvaluation::Finger::AN2KMinutiaeDataRecord::readType9Record(
 	/* Try to read AN2K7 feature data, although it may not be present */
 	try {
 		_AN2K7Features.reset(
-		    new Feature::AN2K7Minutiae(buf, recordNumber));
+		    new Feature::AN2K7Minutiae(an2k, recordNumber));
 	} catch (const Error::Exception&) {}
 	    
 	readRegisteredVendorBlock(type9, Feature::MinutiaeFormat::IAFIS);
@@ -274,7 +266,7 @@ BiometricEvaluation::Finger::AN2KMinutiaeDataRecord::readType9Record(
 	 */
 	try {
 		_AN2K11EFS.reset(
-		    new Feature::AN2K11EFS::ExtendedFeatureSet(buf,
+		    new Feature::AN2K11EFS::ExtendedFeatureSet(an2k,
 			recordNumber));
 	} catch (const Error::Exception&) {}
 	    
@@ -27,7 +27,7 @@ BiometricEvaluation::Finger::AN2KView::AN2KView(
 }
 
 BiometricEvaluation::Finger::AN2KView::AN2KView(
-    Memory::uint8Array &buf,
+    const Memory::ByteSpan &buf,
     const RecordType typeID,
     const uint32_t recordNumber) :
     BiometricEvaluation::View::AN2KView(buf, typeID, recordNumber)
@@ -35,6 +35,24 @@ BiometricEvaluation::Finger::AN2KView::AN2KView(
 	readImageRecord(typeID, recordNumber);
 }
 
+BiometricEvaluation::Finger::AN2KView::AN2KView(
+    const Memory::uint8Array &buf,
+    const RecordType typeID,
+    const uint32_t recordNumber) :
+    AN2KView(Memory::ByteSpan(buf), typeID, recordNumber)
+{
+
+}
+
+BiometricEvaluation::Finger::AN2KView::AN2KView(
+    const std::shared_ptr<const ANSI_NIST> &an2k,
+    const RecordType typeID,
+    const uint32_t recordNumber) :
+    BiometricEvaluation::View::AN2KView(an2k, typeID, recordNumber)
+{
+	readImageRecord(typeID, recordNumber);
+}
+
 /******************************************************************************/
 /* Public functions.                                                          */
 /******************************************************************************/
@@ -26,13 +26,29 @@ BiometricEvaluation::Finger::AN2KViewCapture::AN2KViewCapture(
 }
 
 BiometricEvaluation::Finger::AN2KViewCapture::AN2KViewCapture(
-    Memory::uint8Array &buf,
+    const Memory::ByteSpan &buf,
     const uint32_t recordNumber) :
     AN2KViewVariableResolution(buf, RecordType::Type_14, recordNumber)
 {
 	readImageRecord();
 }
 
+BiometricEvaluation::Finger::AN2KViewCapture::AN2KViewCapture(
+    const Memory::uint8Array &buf,
+    const uint32_t recordNumber) :
+    AN2KViewCapture(Memory::ByteSpan(buf), recordNumber)
+{
+
+}
+
+BiometricEvaluation::Finger::AN2KViewCapture::AN2KViewCapture(
+    const std::shared_ptr<const ANSI_NIST> &an2k,
+    const uint32_t recordNumber) :
+    AN2KViewVariableResolution(an2k, RecordType::Type_14, recordNumber)
+{
+	readImageRecord();
+}
+
 /******************************************************************************/
 /* Public functions.                                                          */
 /******************************************************************************/
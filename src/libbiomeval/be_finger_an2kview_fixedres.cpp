@@ -27,7 +27,7 @@ BiometricEvaluation::Finger::AN2KViewFixedResolution::AN2KViewFixedResolution(
 }
 
 BiometricEvaluation::Finger::AN2KViewFixedResolution::AN2KViewFixedResolution(
-    Memory::uint8Array &buf,
+    const Memory::ByteSpan &buf,
     const RecordType typeID,
     const uint32_t recordNumber) :
     Finger::AN2KView(buf, typeID, recordNumber)
@@ -35,6 +35,24 @@ BiometricEvaluation::Finger::AN2KViewFixedResolution::AN2KViewFixedResolution(
 	readImageRecord(typeID);
 }
 
+BiometricEvaluation::Finger::AN2KViewFixedResolution::AN2KViewFixedResolution(
+    const Memory::uint8Array &buf,
+    const RecordType typeID,
+    const uint32_t recordNumber) :
+    AN2KViewFixedResolution(Memory::ByteSpan(buf), typeID, recordNumber)
+{
+
+}
+
+BiometricEvaluation::Finger::AN2KViewFixedResolution::AN2KViewFixedResolution(
+    const std::shared_ptr<const ANSI_NIST> &an2k,
+    const RecordType typeID,
+    const uint32_t recordNumber) :
+    Finger::AN2KView(an2k, typeID, recordNumber)
+{
+	readImageRecord(typeID);
+}
+
 /******************************************************************************/
 /* Public functions.                                                          */
 /******************************************************************************/
@@ -65,7 +83,7 @@ BiometricEvaluation::Finger::AN2KViewFixedResolution::readImageRecord(
 	 */
 	FIELD *field;
 	int idx;
-	Memory::AutoBuffer<ANSI_NIST> an2k = AN2KView::getAN2K();
+	const auto an2k = AN2KView::getAN2K();
 	if (biomeval_nbis_lookup_ANSI_NIST_field(&field, &idx, NSR_ID, an2k->records[0])
 	    != TRUE)
 		throw Error::DataError("Field NSR not found");
@@ -119,14 +137,6 @@ BiometricEvaluation::Finger::AN2KViewFixedResolution::readImageRecord(
 	    AN2KView::convertCompressionAlgorithm((*record).type,
 	    field->subfields[0]->items[0]->value));
 
-	/* Retrieve the image data */
-	if (biomeval_nbis_lookup_ANSI_NIST_field(&field, &idx, BIN_IMAGE_ID, record) != TRUE)
-		throw Error::DataError("Field BIN_IMAGE not found");
-	Memory::AutoArray<uint8_t> data = Memory::AutoArray<uint8_t>(
-		    field->subfields[0]->items[0]->num_bytes);
-	for (unsigned int i = 0; i < data.size(); i++)
-		data[i] = field->subfields[0]->items[0]->value[i];
-
-	AN2KView::setImageData(data);
+	/* The image data was read, without copying, by AN2KView */
 }
 
@@ -11,7 +11,8 @@
 #include <cmath>
 
 #include <be_image.h>
-#include <be_memory_mutableindexedbuffer.h>
+
+#include "be_image_pixelconversion_impl.h"
 
 namespace BE = BiometricEvaluation;
 
@@ -128,9 +129,12 @@ BiometricEvaluation::Image::to_string(
     const Image::CoordinateSet &coordinates)
 {
 	std::string str{'{'};
-	for (size_t i = 0; i < coordinates.size() - 1; i++)
-		 str += to_string(coordinates.at(i)) + ", ";
-	str += to_string(coordinates.at(coordinates.size() - 1)) + '}';
+	for (size_t i = 0; i < coordinates.size(); i++) {
+		if (i != 0)
+			str += ", ";
+		str += to_string(coordinates.at(i));
+	}
+	str += '}';
 	
 	return (str);
 }
@@ -317,27 +321,12 @@ BiometricEvaluation::Image::removeComponents(
 		    "for " + std::to_string(numComponents) + ' ' +
 		    std::to_string(bitDepth) + "-bit components");
 
-	BE::Memory::uint8Array out((rawData.size() / pixelStride) *
-	    (numComponents - numComponentsToRemove) * componentStride);
-	BE::Memory::MutableIndexedBuffer outBuf(out);
-
-	/* Naively loop over image, skipping over specified components */
-	for (uint64_t px = 0; px < rawData.size(); px += pixelStride) {
-		for (uint8_t comp = 0; comp < numComponents; ++comp) {
-			if (!components[comp]) {
-				switch (bitDepth) {
-				case 8:
-					outBuf.pushU8Val(rawData[px +
-					    (comp * componentStride)]);
-					break;
-				case 16:
-					outBuf.pushBeU16Val(rawData[px +
-					    (comp * componentStride)]);
-					break;
-				}
-			}
-		}
-	}
+	const uint64_t pixelCount = rawData.size() / pixelStride;
+	BE::Memory::uint8Array out(pixelCount *
+	    (numComponents - numComponentsToRemove) * componentStride,
+	    BE::Memory::Allocation::Pooled);
+	PixelConversion::removeComponents(rawData, pixelCount,
+	    componentStride, components, out);
 
 	return (out);
 }
@@ -21,13 +21,25 @@ BiometricEvaluation::Image::BMP::BMP(
     const uint64_t size,
     const std::string &identifier,
     const statusCallback_t &statusCallback) :
-    Image::Image(data,
-    size,
+    BiometricEvaluation::Image::BMP::BMP(
+    Memory::ByteSpan::copyOf(data, size),
+    identifier,
+    statusCallback)
+{
+
+}
+
+BiometricEvaluation::Image::BMP::BMP(
+    const BiometricEvaluation::Memory::ByteSpan &data,
+    const std::string &identifier,
+    const statusCallback_t &statusCallback) :
+    Image::Image(
+    data,
     CompressionAlgorithm::BMP,
     identifier,
     statusCallback)
 {
-	if (BMP::isBMP(data, size) == false)
+	if (BMP::isBMP(data.data(), data.size()) == false)
 		throw Error::StrategyError("Not a BMP");
 
 	BITMAPINFOHEADER dibHeader;
@@ -37,7 +49,7 @@ BiometricEvaluation::Image::BMP::BMP(
 		 * if this type of BMP is supported.
 		 */
 		BMPHeader bmpHeader;
-		BMP::getBMPHeader(data, size, &bmpHeader);
+		BMP::getBMPHeader(data.data(), data.size(), &bmpHeader);
 
 		/*
 		 * The types of BMP supported in this class do not support
@@ -45,7 +57,7 @@ BiometricEvaluation::Image::BMP::BMP(
 		 */
 		this->setHasAlphaChannel(false);
 
-		BMP::getDIBHeader(data, size, &dibHeader);
+		BMP::getDIBHeader(data.data(), data.size(), &dibHeader);
 	} catch (Error::NotImplemented &e) {
 		throw Error::StrategyError(e.what());
 	}
@@ -71,7 +83,7 @@ BiometricEvaluation::Image::BMP::BMP(
 		} else {
 			numColors = dibHeader.numberOfColors;
 		}
-		BMP::getColorTable(data, size, numColors, this->_colorTable);
+		BMP::getColorTable(data.data(), data.size(), numColors, this->_colorTable);
 		for (auto cte : this->_colorTable) {
 			if ((cte.red == cte.green) && (cte.green == cte.blue)) {
 				continue;
@@ -114,8 +126,17 @@ rawPixelFromColorTable(
 	pixel += pixelSz;
 }
 
+uint64_t
+BiometricEvaluation::Image::BMP::getRawRowSize()
+    const
+{
+	/* Pixels are expanded to whole bytes, even for 1-bit images */
+	return (((this->getColorDepth() + 7) / 8) *
+	    static_cast<uint64_t>(this->getDimensions().xSize));
+}
+
 BiometricEvaluation::Memory::AutoArray<uint8_t>
-BiometricEvaluation::Image::BMP::getRawData()
+BiometricEvaluation::Image::BMP::decodeRawData()
     const
 {
 	const uint8_t *bmpData = this->getDataPointer();
@@ -150,7 +171,8 @@ BiometricEvaluation::Image::BMP::getRawData()
 	 * file offsets, etc.
 	 */
 	int32_t absHeight = abs(dibHeader.height);
-	Memory::uint8Array rawData(rawStride * absHeight);
+	Memory::uint8Array rawData(rawStride * absHeight,
+	    Memory::Allocation::Pooled);
 
 	switch (dibHeader.compressionMethod) {
 	case BI_RGB: {
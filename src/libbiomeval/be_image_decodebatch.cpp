@@ -0,0 +1,425 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include <be_error_exception.h>
+#include <be_image_decodebatch.h>
+#include <be_system.h>
+
+namespace BE = BiometricEvaluation;
+
+namespace
+{
+	/** Obtain the encoded data of an item, and its key */
+	using Loader = std::function<BE::Memory::ByteSpan(
+	    uint64_t index, std::string &key)>;
+
+	/** Items of a batch not yet claimed by a thread */
+	struct Range
+	{
+		/** Protects begin and end */
+		std::mutex mutex;
+		/** First unclaimed item */
+		uint64_t begin{0};
+		/** One past the last unclaimed item */
+		uint64_t end{0};
+	};
+
+	/**
+	 * Decodes items on a pool of threads and passes them, in order,
+	 * to a consumer on the calling thread.
+	 *
+	 * Each thread claims items from the front of its own Range and,
+	 * once that is empty, steals the back half of another thread's
+	 * Range. Decoded items wait in `done` until every item before
+	 * them has been consumed. While the bytes waiting exceed the
+	 * budget, threads claim only the next item to be consumed, which
+	 * is always at the front of some Range, so the batch progresses
+	 * with any budget.
+	 *
+	 * Locks are taken in the order `mutex`, then one Range::mutex.
+	 */
+	class Batch
+	{
+	public:
+		Batch(
+		    uint64_t count,
+		    const Loader &loader,
+		    const BE::Image::DecodeBatchConsumer &consumer,
+		    const BE::Image::DecodeBatchOptions &options);
+
+		/** Decode and consume every item */
+		void
+		run();
+
+	private:
+		/** Body of a decoding thread */
+		void
+		work(
+		    uint32_t thread);
+
+		/**
+		 * Claim an item from thread's Range, or steal from
+		 * another Range.
+		 * @return Whether an item was claimed.
+		 */
+		bool
+		claim(
+		    uint32_t thread,
+		    uint64_t &index);
+
+		/**
+		 * Claim a specific item, if unclaimed.
+		 * @note Caller must hold mutex.
+		 */
+		bool
+		claimNext(
+		    uint64_t index);
+
+		/** Load and decode an item, capturing any failure */
+		BE::Image::DecodedImage
+		decode(
+		    uint64_t index)
+		    const;
+
+		/** Stop decoding threads and wait for them to exit */
+		void
+		stop(
+		    std::vector<std::thread> &threads);
+
+		const uint64_t _count;
+		const Loader &_loader;
+		const BE::Image::DecodeBatchConsumer &_consumer;
+		const BE::Image::DecodeBatchOptions &_options;
+
+		/** Unclaimed items of each thread */
+		std::vector<Range> _ranges;
+		/** Number of unclaimed items */
+		std::atomic<uint64_t> _unclaimed;
+		/** Bytes decoded and not yet consumed */
+		std::atomic<uint64_t> _pending{0};
+
+		/** Protects members below */
+		std::mutex _mutex;
+		/** Signaled when any member below changes */
+		std::condition_variable _changed;
+		/** Decoded items not yet consumed */
+		std::map<uint64_t, BE::Image::DecodedImage> _done;
+		/** Index of the next item to consume */
+		uint64_t _next{0};
+		/** Set to make decoding threads exit */
+		bool _cancelled{false};
+		/** Failure of a decoding thread outside of an item */
+		std::exception_ptr _failure{};
+	};
+
+	/** @return Number of threads to use for count items */
+	uint32_t
+	getThreadCount(
+	    uint32_t requested,
+	    uint64_t count)
+	{
+		if (requested == 0) {
+			try {
+				requested = BE::System::getCPUCoreCount();
+			} catch (const BE::Error::Exception&) {
+				requested = std::thread::hardware_concurrency();
+			}
+		}
+		return (static_cast<uint32_t>(std::max<uint64_t>(1,
+		    std::min<uint64_t>(requested, count))));
+	}
+}
+
+Batch::Batch(
+    uint64_t count,
+    const Loader &loader,
+    const BE::Image::DecodeBatchConsumer &consumer,
+    const BE::Image::DecodeBatchOptions &options) :
+    _count{count},
+    _loader{loader},
+    _consumer{consumer},
+    _options{options},
+    _ranges(getThreadCount(options.threads, count)),
+    _unclaimed{count}
+{
+	const uint64_t threads = this->_ranges.size();
+	for (uint64_t i = 0; i < threads; i++) {
+		this->_ranges[i].begin = (count * i) / threads;
+		this->_ranges[i].end = (count * (i + 1)) / threads;
+	}
+}
+
+bool
+Batch::claim(
+    uint32_t thread,
+    uint64_t &index)
+{
+	Range &own = this->_ranges[thread];
+	{
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (own.begin < own.end) {
+			index = own.begin++;
+			this->_unclaimed--;
+			return (true);
+		}
+	}
+
+	const uint32_t threads = static_cast<uint32_t>(this->_ranges.size());
+	for (uint32_t i = 1; i < threads; i++) {
+		Range &victim = this->_ranges[(thread + i) % threads];
+		uint64_t begin, end;
+		{
+			std::lock_guard<std::mutex> lock(victim.mutex);
+			if (victim.begin >= victim.end)
+				continue;
+			begin = victim.begin + ((victim.end - victim.begin) / 2);
+			end = victim.end;
+			victim.end = begin;
+			this->_unclaimed--;
+		}
+
+		/*
+		 * The first stolen item is claimed before the rest become
+		 * visible, so the next item to consume is never hidden
+		 * while in transit.
+		 */
+		std::lock_guard<std::mutex> lock(own.mutex);
+		index = begin;
+		own.begin = begin + 1;
+		own.end = end;
+		return (true);
+	}
+
+	return (false);
+}
+
+bool
+Batch::claimNext(
+    uint64_t index)
+{
+	for (auto &range : this->_ranges) {
+		std::lock_guard<std::mutex> lock(range.mutex);
+		if ((range.begin < range.end) && (range.begin == index)) {
+			range.begin++;
+			this->_unclaimed--;
+			return (true);
+		}
+	}
+	return (false);
+}
+
+BE::Image::DecodedImage
+Batch::decode(
+    uint64_t index)
+    const
+{
+	BE::Image::DecodedImage item{};
+	item.index = index;
+	try {
+		const BE::Memory::ByteSpan data = this->_loader(index,
+		    item.key);
+		item.image = BE::Image::Image::openImage(data, item.key);
+		if (this->_options.grayscaleDepth == 0)
+			item.rawData = item.image->getRawDataSpan();
+		else
+			item.rawData = BE::Memory::ByteSpan::share(
+			    item.image->getRawGrayscaleData(
+			    this->_options.grayscaleDepth));
+	} catch (...) {
+		item.error = std::current_exception();
+	}
+	return (item);
+}
+
+void
+Batch::work(
+    uint32_t thread)
+{
+	try {
+		for (;;) {
+			uint64_t index;
+			if (this->_pending < this->_options.memoryBudget) {
+				if (!this->claim(thread, index))
+					return;
+			} else {
+				std::unique_lock<std::mutex> lock(this->_mutex);
+				for (;;) {
+					if (this->_cancelled)
+						return;
+					if (this->_pending <
+					    this->_options.memoryBudget) {
+						lock.unlock();
+						if (!this->claim(thread, index))
+							return;
+						break;
+					}
+					if (this->claimNext(this->_next)) {
+						index = this->_next;
+						break;
+					}
+					if (this->_unclaimed == 0)
+						return;
+					this->_changed.wait(lock);
+				}
+			}
+
+			BE::Image::DecodedImage item = this->decode(index);
+			const uint64_t size = item.rawData.size();
+
+			std::lock_guard<std::mutex> lock(this->_mutex);
+			if (this->_cancelled)
+				return;
+			this->_done.emplace(index, std::move(item));
+			this->_pending += size;
+			this->_changed.notify_all();
+		}
+	} catch (...) {
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		if (!this->_failure)
+			this->_failure = std::current_exception();
+		this->_cancelled = true;
+		this->_changed.notify_all();
+	}
+}
+
+void
+Batch::stop(
+    std::vector<std::thread> &threads)
+{
+	{
+		std::lock_guard<std::mutex> lock(this->_mutex);
+		this->_cancelled = true;
+		this->_changed.notify_all();
+	}
+	for (auto &thread : threads)
+		thread.join();
+}
+
+void
+Batch::run()
+{
+	std::vector<std::thread> threads;
+	try {
+		for (uint32_t i = 0; i < this->_ranges.size(); i++)
+			threads.emplace_back(&Batch::work, this, i);
+	} catch (...) {
+		this->stop(threads);
+		throw;
+	}
+
+	while (this->_next < this->_count) {
+		BE::Image::DecodedImage item;
+		{
+			std::unique_lock<std::mutex> lock(this->_mutex);
+			this->_changed.wait(lock, [&]() {
+				return (this->_failure ||
+				    (this->_done.count(this->_next) != 0));
+			});
+			if (this->_failure) {
+				lock.unlock();
+				this->stop(threads);
+				std::rethrow_exception(this->_failure);
+			}
+
+			const auto done = this->_done.find(this->_next);
+			item = std::move(done->second);
+			this->_done.erase(done);
+			this->_pending -= item.rawData.size();
+			this->_next++;
+			this->_changed.notify_all();
+		}
+
+		try {
+			this->_consumer(std::move(item));
+		} catch (...) {
+			this->stop(threads);
+			throw;
+		}
+	}
+
+	for (auto &thread : threads)
+		thread.join();
+}
+
+void
+BiometricEvaluation::Image::decodeBatch(
+    const std::vector<Memory::ByteSpan> &data,
+    const DecodeBatchConsumer &consumer,
+    const DecodeBatchOptions &options)
+{
+	if (data.empty())
+		return;
+
+	const Loader loader = [&](uint64_t index, std::string&) {
+		return (data[index]);
+	};
+	Batch(data.size(), loader, consumer, options).run();
+}
+
+void
+BiometricEvaluation::Image::decodeBatch(
+    const IO::RecordStore &recordStore,
+    const std::vector<std::string> &keys,
+    const DecodeBatchConsumer &consumer,
+    const DecodeBatchOptions &options)
+{
+	if (keys.empty())
+		return;
+
+	/* RecordStores are not safe for concurrent reads */
+	std::mutex readMutex;
+	const Loader loader = [&](uint64_t index, std::string &key) {
+		key = keys[index];
+		std::lock_guard<std::mutex> lock(readMutex);
+		return (Memory::ByteSpan::share(recordStore.read(key)));
+	};
+	Batch(keys.size(), loader, consumer, options).run();
+}
+
+std::vector<BiometricEvaluation::Image::DecodedImage>
+BiometricEvaluation::Image::decodeBatch(
+    const std::vector<Memory::ByteSpan> &data,
+    const DecodeBatchOptions &options)
+{
+	DecodeBatchOptions unbounded = options;
+	unbounded.memoryBudget = std::numeric_limits<uint64_t>::max();
+
+	std::vector<DecodedImage> items;
+	items.reserve(data.size());
+	decodeBatch(data, [&](DecodedImage &&item) {
+		items.push_back(std::move(item));
+	}, unbounded);
+	return (items);
+}
+
+std::vector<BiometricEvaluation::Image::DecodedImage>
+BiometricEvaluation::Image::decodeBatch(
+    const IO::RecordStore &recordStore,
+    const std::vector<std::string> &keys,
+    const DecodeBatchOptions &options)
+{
+	DecodeBatchOptions unbounded = options;
+	unbounded.memoryBudget = std::numeric_limits<uint64_t>::max();
+
+	std::vector<DecodedImage> items;
+	items.reserve(keys.size());
+	decodeBatch(recordStore, keys, [&](DecodedImage &&item) {
+		items.push_back(std::move(item));
+	}, unbounded);
+	return (items);
+}
@@ -0,0 +1,189 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "be_image_decodecache_impl.h"
+
+namespace BE = BiometricEvaluation;
+
+namespace
+{
+	/** Decoded data of live Images, in order of use */
+	class Cache
+	{
+	public:
+		/** Data kept for an Image */
+		struct Entry
+		{
+			std::shared_ptr<const BE::Memory::uint8Array> data;
+			std::list<const BE::Image::Image *>::iterator use;
+		};
+
+		/** Discard least recently used data until within limit */
+		void
+		evict(
+		    uint64_t limit);
+
+		/** Discard data kept for an Image */
+		void
+		erase(
+		    std::unordered_map<const BE::Image::Image *,
+		    Entry>::iterator entry);
+
+		/** Protects all members */
+		std::mutex mutex;
+		/** Kept data, by Image */
+		std::unordered_map<const BE::Image::Image *, Entry> entries;
+		/** Images with kept data, most recently used first */
+		std::list<const BE::Image::Image *> uses;
+		/** Activity and contents */
+		BE::Image::DecodeCache::Statistics statistics;
+	};
+
+	/** Maximum value of Cache::statistics.cachedSize */
+	std::atomic<uint64_t> budget{BE::Image::DecodeCache::DEFAULT_BUDGET};
+
+	Cache &
+	getCache()
+	{
+		/* Never destroyed: Images may outlive static destruction */
+		static Cache *cache = new Cache();
+		return (*cache);
+	}
+}
+
+void
+Cache::evict(
+    uint64_t limit)
+{
+	while (!this->uses.empty() && (this->statistics.cachedSize > limit)) {
+		this->erase(this->entries.find(this->uses.back()));
+		this->statistics.evictions++;
+	}
+}
+
+void
+Cache::erase(
+    std::unordered_map<const BE::Image::Image *, Entry>::iterator entry)
+{
+	this->statistics.cachedSize -= entry->second.data->size();
+	this->statistics.cachedImages--;
+	this->uses.erase(entry->second.use);
+	this->entries.erase(entry);
+}
+
+void
+BiometricEvaluation::Image::DecodeCache::setBudget(
+    uint64_t newBudget)
+{
+	Cache &cache = getCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	budget = newBudget;
+	cache.evict(newBudget);
+}
+
+uint64_t
+BiometricEvaluation::Image::DecodeCache::getBudget()
+{
+	return (budget);
+}
+
+void
+BiometricEvaluation::Image::DecodeCache::clear()
+{
+	Cache &cache = getCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	cache.entries.clear();
+	cache.uses.clear();
+	cache.statistics.cachedImages = 0;
+	cache.statistics.cachedSize = 0;
+}
+
+BiometricEvaluation::Image::DecodeCache::Statistics
+BiometricEvaluation::Image::DecodeCache::getStatistics()
+{
+	Cache &cache = getCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	return (cache.statistics);
+}
+
+void
+BiometricEvaluation::Image::DecodeCache::resetStatistics()
+{
+	Cache &cache = getCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	cache.statistics.decodes = 0;
+	cache.statistics.decodesAvoided = 0;
+	cache.statistics.evictions = 0;
+}
+
+bool
+BiometricEvaluation::Image::DecodeCache::isEnabled()
+{
+	return (budget.load(std::memory_order_relaxed) != 0);
+}
+
+std::shared_ptr<const BiometricEvaluation::Memory::uint8Array>
+BiometricEvaluation::Image::DecodeCache::find(
+    const Image *image)
+{
+	Cache &cache = getCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	const auto entry = cache.entries.find(image);
+	if (entry == cache.entries.end())
+		return (nullptr);
+
+	cache.uses.splice(cache.uses.begin(), cache.uses, entry->second.use);
+	cache.statistics.decodesAvoided++;
+	return (entry->second.data);
+}
+
+void
+BiometricEvaluation::Image::DecodeCache::insert(
+    const Image *image,
+    const std::shared_ptr<const Memory::uint8Array> &data)
+{
+	Cache &cache = getCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	cache.statistics.decodes++;
+
+	/* Another thread may have decoded the same Image */
+	const auto existing = cache.entries.find(image);
+	if (existing != cache.entries.end())
+		cache.erase(existing);
+
+	const uint64_t limit = budget;
+	if (data->size() > limit)
+		return;
+	cache.evict(limit - data->size());
+
+	cache.uses.push_front(image);
+	cache.entries[image] = {data, cache.uses.begin()};
+	cache.statistics.cachedImages++;
+	cache.statistics.cachedSize += data->size();
+}
+
+void
+BiometricEvaluation::Image::DecodeCache::erase(
+    const Image *image)
+    noexcept
+{
+	Cache &cache = getCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+
+	const auto entry = cache.entries.find(image);
+	if (entry != cache.entries.end())
+		cache.erase(entry);
+}
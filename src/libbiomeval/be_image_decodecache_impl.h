@@ -0,0 +1,65 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_IMAGE_DECODECACHE_IMPL_H__
+#define __BE_IMAGE_DECODECACHE_IMPL_H__
+
+#include <memory>
+
+#include <be_image_decodecache.h>
+#include <be_memory_autoarray.h>
+
+namespace BiometricEvaluation
+{
+	namespace Image
+	{
+		class Image;
+
+		/*
+		 * Operations used by Image to maintain the cache. Entries
+		 * are keyed by the address of the Image that decoded them,
+		 * so an Image must erase its entry before it is destroyed.
+		 */
+		namespace DecodeCache
+		{
+			/** @return Whether the budget is non-zero. */
+			bool
+			isEnabled();
+
+			/**
+			 * @return
+			 *	Data kept for image, marked most recently
+			 *	used, or nullptr.
+			 */
+			std::shared_ptr<const Memory::uint8Array>
+			find(
+			    const Image *image);
+
+			/**
+			 * @brief
+			 * Keep data decoded from image, evicting other
+			 * data as needed to stay within the budget.
+			 */
+			void
+			insert(
+			    const Image *image,
+			    const std::shared_ptr<const Memory::uint8Array>
+			        &data);
+
+			/** @brief Discard data kept for image, if any. */
+			void
+			erase(
+			    const Image *image)
+			    noexcept;
+		}
+	}
+}
+
+#endif /* __BE_IMAGE_DECODECACHE_IMPL_H__ */
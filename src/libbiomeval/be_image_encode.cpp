@@ -0,0 +1,487 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>		/* Needed for NBIS and libjpeg headers */
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include <png.h>
+
+extern "C" {
+	#include <jpeglib.h>
+	#include <jpegl.h>
+	#include <wsq.h>
+}
+
+#include <be_error_exception.h>
+#include <be_image_encode.h>
+#include <be_memory.h>
+
+namespace BE = BiometricEvaluation;
+
+namespace
+{
+	/** Initial size of output grown while encoding */
+	const uint64_t INITIAL_OUTPUT_SIZE = 16 * 1024;
+
+	/**
+	 * @return
+	 *	Resolution to record in an encoding of image, in units,
+	 *	or 0 in both dimensions when not known.
+	 */
+	BE::Image::Resolution
+	getResolution(
+	    const BE::Image::Image &image,
+	    const BE::Image::EncodeParameters &parameters,
+	    const BE::Image::Resolution::Units units)
+	{
+		BE::Image::Resolution resolution = parameters.resolution;
+		if ((resolution.xRes <= 0) || (resolution.yRes <= 0))
+			resolution = image.getResolution();
+		if ((resolution.xRes <= 0) || (resolution.yRes <= 0) ||
+		    (resolution.units == BE::Image::Resolution::Units::NA))
+			return (BE::Image::Resolution(0, 0, units));
+
+		return (resolution.toUnits(units));
+	}
+
+	/** @return Resolution of image in PPI, or -1 when unknown */
+	int
+	getPPI(
+	    const BE::Image::Image &image,
+	    const BE::Image::EncodeParameters &parameters)
+	{
+		const BE::Image::Resolution resolution = getResolution(image,
+		    parameters, BE::Image::Resolution::Units::PPI);
+		if (resolution.xRes <= 0)
+			return (-1);
+		return (static_cast<int>(std::lround(resolution.xRes)));
+	}
+
+	/**
+	 * @brief
+	 * Copy a buffer allocated by NBIS into output and free it.
+	 * @details
+	 * NBIS encoders allocate their own output, so output's storage
+	 * can only be reused for the copy.
+	 */
+	void
+	moveNBISOutput(
+	    unsigned char *nbisData,
+	    int nbisLength,
+	    BE::Memory::uint8Array &output)
+	{
+		/* Freed even when resizing output throws */
+		std::unique_ptr<unsigned char, void(*)(void*)> nbisOutput(
+		    nbisData, std::free);
+		output.resize(nbisLength);
+		std::memcpy(output, nbisOutput.get(), nbisLength);
+	}
+
+	/** @throw Error::ParameterError colorDepth is not 8 */
+	void
+	requireGray8(
+	    const BE::Image::Image &image,
+	    const std::string &encoding)
+	{
+		if (image.getColorDepth() != 8)
+			throw BE::Error::ParameterError(encoding + " encoding "
+			    "requires 8-bit grayscale, not " + std::to_string(
+			    image.getColorDepth()) + "-bit");
+	}
+
+	void
+	encodeWSQ(
+	    const BE::Image::Image &image,
+	    const BE::Memory::ByteSpan &raw,
+	    BE::Memory::uint8Array &output,
+	    const BE::Image::EncodeParameters &parameters)
+	{
+		requireGray8(image, "WSQ");
+		if (!(parameters.wsqBitrate > 0))
+			throw BE::Error::ParameterError("WSQ bitrate must be "
+			    "positive");
+
+		/* Per-call encoder state allows concurrent encoding */
+		WSQ_ENCODER encoder;
+		unsigned char *wsqData{nullptr};
+		int wsqLength{0};
+		const auto dimensions = image.getDimensions();
+		const int rv = biomeval_nbis_wsq_encode_mem_r(&encoder,
+		    &wsqData, &wsqLength, parameters.wsqBitrate,
+		    const_cast<unsigned char *>(raw.data()),
+		    dimensions.xSize, dimensions.ySize, 8,
+		    getPPI(image, parameters), nullptr);
+		if (rv != 0)
+			throw BE::Error::StrategyError("Could not encode WSQ "
+			    "(NBIS error " + std::to_string(rv) + ")");
+		moveNBISOutput(wsqData, wsqLength, output);
+	}
+
+	void
+	encodeJPEGL(
+	    const BE::Image::Image &image,
+	    const BE::Memory::ByteSpan &raw,
+	    BE::Memory::uint8Array &output,
+	    const BE::Image::EncodeParameters &parameters)
+	{
+		requireGray8(image, "Lossless JPEG");
+
+		IMG_DAT *imgDat{nullptr};
+		int samplingFactor[1] = {1};
+		const auto dimensions = image.getDimensions();
+		int rv = biomeval_nbis_setup_IMG_DAT_nonintrlv_encode(&imgDat,
+		    const_cast<unsigned char *>(raw.data()), dimensions.xSize,
+		    dimensions.ySize, 8, getPPI(image, parameters),
+		    samplingFactor, samplingFactor, 1, 0, PRED4);
+		if (rv != 0)
+			throw BE::Error::StrategyError("Could not prepare "
+			    "Lossless JPEG encoding (NBIS error " +
+			    std::to_string(rv) + ")");
+
+		unsigned char *jpeglData{nullptr};
+		int jpeglLength{0};
+		rv = biomeval_nbis_jpegl_encode_mem(&jpeglData, &jpeglLength,
+		    imgDat, nullptr);
+		biomeval_nbis_free_IMG_DAT(imgDat, FREE_IMAGE);
+		if (rv != 0)
+			throw BE::Error::StrategyError("Could not encode "
+			    "Lossless JPEG (NBIS error " + std::to_string(rv) +
+			    ")");
+		moveNBISOutput(jpeglData, jpeglLength, output);
+	}
+
+	/** libjpeg destination writing to an AutoArray */
+	struct JPEGDestination
+	{
+		/** Must be first, libjpeg sees only this */
+		struct jpeg_destination_mgr manager;
+		/** Encoded data, grown as needed */
+		BE::Memory::uint8Array *output;
+	};
+
+	void
+	jpegInitDestination(
+	    j_compress_ptr cinfo)
+	{
+		auto dest = reinterpret_cast<JPEGDestination *>(cinfo->dest);
+		dest->output->resize(std::max(dest->output->size(),
+		    INITIAL_OUTPUT_SIZE));
+		dest->manager.next_output_byte = *dest->output;
+		dest->manager.free_in_buffer = dest->output->size();
+	}
+
+	boolean
+	jpegEmptyOutputBuffer(
+	    j_compress_ptr cinfo)
+	{
+		/* libjpeg calls when the buffer is full, ignoring free */
+		auto dest = reinterpret_cast<JPEGDestination *>(cinfo->dest);
+		const uint64_t used = dest->output->size();
+		dest->output->resize(used * 2);
+		dest->manager.next_output_byte = *dest->output + used;
+		dest->manager.free_in_buffer = dest->output->size() - used;
+		return (TRUE);
+	}
+
+	void
+	jpegTermDestination(
+	    j_compress_ptr cinfo)
+	{
+		auto dest = reinterpret_cast<JPEGDestination *>(cinfo->dest);
+		dest->output->resize(dest->output->size() -
+		    dest->manager.free_in_buffer);
+	}
+
+	/** @throw Error::StrategyError Always, with libjpeg's message */
+	void
+	jpegErrorExit(
+	    j_common_ptr cinfo)
+	{
+		char buffer[JMSG_LENGTH_MAX];
+		cinfo->err->format_message(cinfo, buffer);
+		throw BE::Error::StrategyError(buffer);
+	}
+
+	/** Discard libjpeg warnings and trace messages */
+	void
+	jpegOutputMessage(
+	    j_common_ptr cinfo)
+	{
+
+	}
+
+	void
+	encodeJPEG(
+	    const BE::Image::Image &image,
+	    const BE::Memory::ByteSpan &raw,
+	    BE::Memory::uint8Array &output,
+	    const BE::Image::EncodeParameters &parameters)
+	{
+		if ((image.getColorDepth() != 8) &&
+		    (image.getColorDepth() != 24))
+			throw BE::Error::ParameterError("JPEG encoding "
+			    "requires 8-bit grayscale or 24-bit RGB, not " +
+			    std::to_string(image.getColorDepth()) + "-bit");
+		if (parameters.jpegQuality > 100)
+			throw BE::Error::ParameterError("JPEG quality must be "
+			    "at most 100");
+
+		struct jpeg_error_mgr jerr;
+		jpeg_std_error(&jerr);
+		jerr.error_exit = jpegErrorExit;
+		jerr.output_message = jpegOutputMessage;
+
+		struct jpeg_compress_struct cinfo;
+		cinfo.err = &jerr;
+		jpeg_create_compress(&cinfo);
+
+		JPEGDestination dest;
+		dest.manager.init_destination = jpegInitDestination;
+		dest.manager.empty_output_buffer = jpegEmptyOutputBuffer;
+		dest.manager.term_destination = jpegTermDestination;
+		dest.output = &output;
+		cinfo.dest = &dest.manager;
+
+		try {
+			const auto dimensions = image.getDimensions();
+			cinfo.image_width = dimensions.xSize;
+			cinfo.image_height = dimensions.ySize;
+			if (image.getColorDepth() == 8) {
+				cinfo.input_components = 1;
+				cinfo.in_color_space = JCS_GRAYSCALE;
+			} else {
+				cinfo.input_components = 3;
+				cinfo.in_color_space = JCS_RGB;
+			}
+			jpeg_set_defaults(&cinfo);
+			jpeg_set_quality(&cinfo, parameters.jpegQuality, TRUE);
+
+			const BE::Image::Resolution resolution = getResolution(
+			    image, parameters, BE::Image::Resolution::Units::PPI);
+			if (resolution.xRes > 0) {
+				cinfo.density_unit = 1;	/* Dots/inch */
+				cinfo.X_density = static_cast<UINT16>(
+				    std::lround(resolution.xRes));
+				cinfo.Y_density = static_cast<UINT16>(
+				    std::lround(resolution.yRes));
+			}
+
+			jpeg_start_compress(&cinfo, TRUE);
+			const uint64_t rowSize = dimensions.xSize *
+			    cinfo.input_components;
+			while (cinfo.next_scanline < cinfo.image_height) {
+				JSAMPROW row = const_cast<JSAMPROW>(raw.data() +
+				    (cinfo.next_scanline * rowSize));
+				jpeg_write_scanlines(&cinfo, &row, 1);
+			}
+			jpeg_finish_compress(&cinfo);
+		} catch (...) {
+			jpeg_destroy_compress(&cinfo);
+			throw;
+		}
+		jpeg_destroy_compress(&cinfo);
+	}
+
+	/** libpng destination writing to an AutoArray */
+	struct PNGDestination
+	{
+		/** Encoded data, grown as needed */
+		BE::Memory::uint8Array *output;
+		/** Bytes of output written */
+		uint64_t offset;
+	};
+
+	void
+	pngWrite(
+	    png_structp png_ptr,
+	    png_bytep data,
+	    png_size_t length)
+	{
+		auto dest = static_cast<PNGDestination *>(png_get_io_ptr(
+		    png_ptr));
+		if ((dest->offset + length) > dest->output->size())
+			dest->output->resize(std::max(dest->offset + length,
+			    dest->output->size() * 2));
+		std::memcpy(*dest->output + dest->offset, data, length);
+		dest->offset += length;
+	}
+
+	void
+	pngFlush(
+	    png_structp png_ptr)
+	{
+
+	}
+
+	/** @throw Error::StrategyError Always, with libpng's message */
+	void
+	pngError(
+	    png_structp png_ptr,
+	    png_const_charp msg)
+	{
+		throw BE::Error::StrategyError(msg);
+	}
+
+	/** Discard libpng warnings */
+	void
+	pngWarning(
+	    png_structp png_ptr,
+	    png_const_charp msg)
+	{
+
+	}
+
+	void
+	encodePNG(
+	    const BE::Image::Image &image,
+	    const BE::Memory::ByteSpan &raw,
+	    BE::Memory::uint8Array &output,
+	    const BE::Image::EncodeParameters &parameters)
+	{
+		const uint16_t bitDepth = image.getBitDepth();
+		const uint32_t colorDepth = image.getColorDepth();
+		if (((bitDepth != 8) && (bitDepth != 16)) ||
+		    ((colorDepth % bitDepth) != 0) ||
+		    (colorDepth / bitDepth < 1) || (colorDepth / bitDepth > 4))
+			throw BE::Error::ParameterError("PNG encoding requires "
+			    "1 to 4 components of 8 or 16 bits, not " +
+			    std::to_string(colorDepth) + "-bit color with " +
+			    std::to_string(bitDepth) + "-bit components");
+		if ((parameters.pngCompressionLevel < -1) ||
+		    (parameters.pngCompressionLevel > 9))
+			throw BE::Error::ParameterError("PNG compression level "
+			    "must be from -1 to 9");
+
+		int colorType;
+		switch (colorDepth / bitDepth) {
+		case 1:
+			colorType = PNG_COLOR_TYPE_GRAY;
+			break;
+		case 2:
+			colorType = PNG_COLOR_TYPE_GRAY_ALPHA;
+			break;
+		case 3:
+			colorType = PNG_COLOR_TYPE_RGB;
+			break;
+		default:
+			colorType = PNG_COLOR_TYPE_RGB_ALPHA;
+			break;
+		}
+
+		png_structp png_ptr = png_create_write_struct(
+		    PNG_LIBPNG_VER_STRING, nullptr, pngError, pngWarning);
+		if (png_ptr == nullptr)
+			throw BE::Error::StrategyError("Could not initialize "
+			    "writing");
+		png_infop png_info_ptr = png_create_info_struct(png_ptr);
+		if (png_info_ptr == nullptr) {
+			png_destroy_write_struct(&png_ptr, nullptr);
+			throw BE::Error::StrategyError("Could not initialize "
+			    "container for information");
+		}
+
+		PNGDestination dest{&output, 0};
+		output.resize(std::max(output.size(), INITIAL_OUTPUT_SIZE));
+		try {
+			png_set_write_fn(png_ptr, &dest, pngWrite, pngFlush);
+			if (parameters.pngCompressionLevel != -1)
+				png_set_compression_level(png_ptr,
+				    parameters.pngCompressionLevel);
+
+			const auto dimensions = image.getDimensions();
+			png_set_IHDR(png_ptr, png_info_ptr, dimensions.xSize,
+			    dimensions.ySize, bitDepth, colorType,
+			    PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT,
+			    PNG_FILTER_TYPE_DEFAULT);
+
+			const BE::Image::Resolution resolution = getResolution(
+			    image, parameters,
+			    BE::Image::Resolution::Units::PPCM);
+			if (resolution.xRes > 0)
+				png_set_pHYs(png_ptr, png_info_ptr,
+				    static_cast<png_uint_32>(std::lround(
+				    resolution.xRes * 100)),
+				    static_cast<png_uint_32>(std::lround(
+				    resolution.yRes * 100)),
+				    PNG_RESOLUTION_METER);
+
+			png_write_info(png_ptr, png_info_ptr);
+
+			/* Raw data is in native byte order, PNG big-endian */
+			if ((bitDepth > 8) && BE::Memory::isLittleEndian())
+				png_set_swap(png_ptr);
+
+			const uint64_t rowSize = static_cast<uint64_t>(
+			    dimensions.xSize) * (colorDepth / 8);
+			for (uint32_t row = 0; row < dimensions.ySize; row++)
+				png_write_row(png_ptr, const_cast<png_bytep>(
+				    raw.data() + (row * rowSize)));
+			png_write_end(png_ptr, png_info_ptr);
+		} catch (...) {
+			png_destroy_write_struct(&png_ptr, &png_info_ptr);
+			throw;
+		}
+		png_destroy_write_struct(&png_ptr, &png_info_ptr);
+		output.resize(dest.offset);
+	}
+}
+
+void
+BiometricEvaluation::Image::encode(
+    const Image &image,
+    const CompressionAlgorithm algorithm,
+    Memory::uint8Array &output,
+    const EncodeParameters &parameters)
+{
+	void (*encoder)(const Image&, const Memory::ByteSpan&,
+	    Memory::uint8Array&, const EncodeParameters&);
+	switch (algorithm) {
+	case CompressionAlgorithm::WSQ20:
+		encoder = encodeWSQ;
+		break;
+	case CompressionAlgorithm::JPEGL:
+		encoder = encodeJPEGL;
+		break;
+	case CompressionAlgorithm::JPEGB:
+		encoder = encodeJPEG;
+		break;
+	case CompressionAlgorithm::PNG:
+		encoder = encodePNG;
+		break;
+	default:
+		throw Error::NotImplemented("Encoding to " +
+		    Framework::Enumeration::to_string(algorithm));
+	}
+
+	const Memory::ByteSpan raw = image.getRawDataSpan();
+	const auto dimensions = image.getDimensions();
+	if (raw.size() < (static_cast<uint64_t>(dimensions.xSize) *
+	    dimensions.ySize * image.getColorDepth() / 8))
+		throw Error::DataError("Raw data is smaller than the "
+		    "dimensions of the image");
+
+	encoder(image, raw, output, parameters);
+}
+
+BiometricEvaluation::Memory::uint8Array
+BiometricEvaluation::Image::encode(
+    const Image &image,
+    const CompressionAlgorithm algorithm,
+    const EncodeParameters &parameters)
+{
+	Memory::uint8Array output;
+	encode(image, algorithm, output, parameters);
+	return (output);
+}
@@ -8,9 +8,17 @@
  * about its quality, reliability, or any other characteristic.
  */
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstring>
 #include <stdexcept>
 #include <memory>
+#include <vector>
+
+extern "C" {
+	#include <dataio.h>
+}
 
 #include <be_image_image.h>
 #include <be_image_bmp.h>
@@ -24,7 +32,9 @@
 #include <be_image_wsq.h>
 #include <be_io_utility.h>
 #include <be_memory_autoarrayiterator.h>
-#include <be_memory_mutableindexedbuffer.h>
+
+#include "be_image_decodecache_impl.h"
+#include "be_image_pixelconversion_impl.h"
 
 namespace BE = BiometricEvaluation;
 
@@ -39,17 +49,41 @@ BiometricEvaluation::Image::Image::Image(
     const bool hasAlphaChannel,
     const std::string &identifier,
     const statusCallback_t &statusCallback) :
+    BiometricEvaluation::Image::Image::Image(
+    Memory::ByteSpan::copyOf(data, size),
+    dimensions,
+    colorDepth,
+    bitDepth,
+    resolution,
+    compressionAlgorithm,
+    hasAlphaChannel,
+    identifier,
+    statusCallback)
+{
+
+}
+
+BiometricEvaluation::Image::Image::Image(
+    const Memory::ByteSpan &data,
+    const Size dimensions,
+    const uint32_t colorDepth,
+    const uint16_t bitDepth,
+    const Resolution resolution,
+    const CompressionAlgorithm compressionAlgorithm,
+    const bool hasAlphaChannel,
+    const std::string &identifier,
+    const statusCallback_t &statusCallback) :
     _dimensions(dimensions),
     _colorDepth(colorDepth),
     _hasAlphaChannel(hasAlphaChannel),
     _bitDepth(bitDepth),
     _resolution(resolution),
-    _data(size),
+    _data(data),
     _compressionAlgorithm(compressionAlgorithm),
     _identifier(identifier),
     _statusCallback(statusCallback)
 {
-	std::memcpy(_data, data, size);
+
 }
 
 BiometricEvaluation::Image::Image::Image(
@@ -59,8 +93,21 @@ BiometricEvaluation::Image::Image::Image(
     const std::string &identifier,
     const statusCallback_t &statusCallback) :
     BiometricEvaluation::Image::Image::Image(
+    Memory::ByteSpan::copyOf(data, size),
+    compressionAlgorithm,
+    identifier,
+    statusCallback)
+{
+
+}
+
+BiometricEvaluation::Image::Image::Image(
+    const Memory::ByteSpan &data,
+    const CompressionAlgorithm compressionAlgorithm,
+    const std::string &identifier,
+    const statusCallback_t &statusCallback) :
+    BiometricEvaluation::Image::Image::Image(
     data,
-    size,
     Size(),
     0,
     0,
@@ -108,6 +155,207 @@ BiometricEvaluation::Image::Image::getBitDepth()
 	return (this->_bitDepth);
 }
 
+BiometricEvaluation::Memory::uint8Array
+BiometricEvaluation::Image::Image::getRawData()
+    const
+{
+	if (!DecodeCache::isEnabled() ||
+	    (this->getCompressionAlgorithm() == CompressionAlgorithm::None))
+		return (this->decodeRawData());
+
+	/* Callers that only read the data use getRawDataSpan() */
+	return (*(this->getCachedRawData()));
+}
+
+BiometricEvaluation::Memory::ByteSpan
+BiometricEvaluation::Image::Image::getRawDataSpan()
+    const
+{
+	/* Undecoded images gain nothing from a second copy */
+	if (!DecodeCache::isEnabled() ||
+	    (this->getCompressionAlgorithm() == CompressionAlgorithm::None))
+		return (Memory::ByteSpan::share(this->getRawData()));
+
+	return (Memory::ByteSpan(this->getCachedRawData()));
+}
+
+std::shared_ptr<const BiometricEvaluation::Memory::uint8Array>
+BiometricEvaluation::Image::Image::getCachedRawData()
+    const
+{
+	std::shared_ptr<const Memory::uint8Array> rawData =
+	    DecodeCache::find(this);
+	if (rawData == nullptr) {
+		rawData = std::make_shared<const Memory::uint8Array>(
+		    this->decodeRawData());
+		DecodeCache::insert(this, rawData);
+	}
+	return (rawData);
+}
+
+BiometricEvaluation::Memory::uint8Array
+BiometricEvaluation::Image::Image::decodeRawData()
+    const
+{
+	throw Error::NotImplemented("Decoding " +
+	    BE::Framework::Enumeration::to_string(
+	    this->getCompressionAlgorithm()) + " data");
+}
+
+void
+BiometricEvaluation::Image::Image::decodeRawDataInto(
+    uint8_t *buffer,
+    uint64_t stride)
+    const
+{
+	const Memory::uint8Array rawData = this->decodeRawData();
+	this->copyRawDataInto(rawData, rawData.size(), buffer, stride);
+}
+
+void
+BiometricEvaluation::Image::Image::copyRawDataInto(
+    const uint8_t *rawData,
+    uint64_t rawDataSize,
+    uint8_t *buffer,
+    uint64_t stride)
+    const
+{
+	const uint64_t rowSize = this->getRawRowSize();
+	const uint32_t height = this->getDimensions().ySize;
+	if (rawDataSize != (rowSize * height))
+		throw Error::DataError("Raw data size does not match image "
+		    "dimensions");
+
+	if (stride == rowSize) {
+		std::memcpy(buffer, rawData, rawDataSize);
+		return;
+	}
+	for (uint32_t row = 0; row < height; row++)
+		std::memcpy(buffer + (row * stride), rawData + (row * rowSize),
+		    rowSize);
+}
+
+uint64_t
+BiometricEvaluation::Image::Image::getRawRowSize()
+    const
+{
+	/* Components smaller than a byte are packed */
+	return (((static_cast<uint64_t>(this->getDimensions().xSize) *
+	    this->getColorDepth()) + 7) / 8);
+}
+
+uint64_t
+BiometricEvaluation::Image::Image::requiredBufferSize(
+    uint64_t stride)
+    const
+{
+	const uint64_t rowSize = this->getRawRowSize();
+	if (stride == 0)
+		stride = rowSize;
+	else if (stride < rowSize)
+		throw Error::ParameterError("Stride is less than row size of " +
+		    std::to_string(rowSize));
+
+	const uint32_t height = this->getDimensions().ySize;
+	if (height == 0)
+		return (0);
+	return ((stride * (height - 1)) + rowSize);
+}
+
+void
+BiometricEvaluation::Image::Image::decodeInto(
+    uint8_t *buffer,
+    uint64_t size,
+    uint64_t stride)
+    const
+{
+	if (stride == 0)
+		stride = this->getRawRowSize();
+	const uint64_t required = this->requiredBufferSize(stride);
+	if ((size < required) || ((buffer == nullptr) && (required > 0)))
+		throw Error::ParameterError("Buffer is smaller than " +
+		    std::to_string(required) + " bytes");
+
+	if (DecodeCache::isEnabled()) {
+		const std::shared_ptr<const Memory::uint8Array> rawData =
+		    DecodeCache::find(this);
+		if (rawData != nullptr) {
+			this->copyRawDataInto(*rawData, rawData->size(),
+			    buffer, stride);
+			return;
+		}
+	}
+
+	this->decodeRawDataInto(buffer, stride);
+}
+
+void
+BiometricEvaluation::Image::Image::decodeInto(
+    Memory::uint8Array &buffer)
+    const
+{
+	buffer.resize(this->requiredBufferSize());
+	this->decodeInto(buffer, buffer.size());
+}
+
+void
+BiometricEvaluation::Image::Image::decodeRows(
+    const rowCallback_t &callback,
+    uint32_t rowsPerChunk)
+    const
+{
+	if (!callback)
+		throw Error::ParameterError("No callback for decoded rows");
+
+	if (DecodeCache::isEnabled()) {
+		const std::shared_ptr<const Memory::uint8Array> rawData =
+		    DecodeCache::find(this);
+		if (rawData != nullptr) {
+			const uint32_t height = this->getDimensions().ySize;
+			if (rawData->size() < (this->getRawRowSize() * height))
+				throw Error::DataError("Raw data size does not "
+				    "match image dimensions");
+			this->passRows(*rawData, 0, height, callback,
+			    rowsPerChunk);
+			return;
+		}
+	}
+
+	this->decodeRawRows(callback, rowsPerChunk);
+}
+
+void
+BiometricEvaluation::Image::Image::decodeRawRows(
+    const rowCallback_t &callback,
+    uint32_t rowsPerChunk)
+    const
+{
+	Memory::uint8Array rawData(this->requiredBufferSize(),
+	    Memory::Allocation::Pooled);
+	this->decodeRawDataInto(rawData, this->getRawRowSize());
+	this->passRows(rawData, 0, this->getDimensions().ySize, callback,
+	    rowsPerChunk);
+}
+
+void
+BiometricEvaluation::Image::Image::passRows(
+    const uint8_t *rows,
+    uint32_t firstRow,
+    uint32_t rowCount,
+    const rowCallback_t &callback,
+    uint32_t rowsPerChunk)
+    const
+{
+	if (rowsPerChunk == 0)
+		rowsPerChunk = rowCount;
+
+	const uint64_t rowSize = this->getRawRowSize();
+	for (uint64_t row = 0; row < rowCount; row += rowsPerChunk)
+		callback(firstRow + row, static_cast<uint32_t>(std::min<
+		    uint64_t>(rowsPerChunk, rowCount - row)),
+		    rows + (row * rowSize));
+}
+
 BiometricEvaluation::Memory::uint8Array
 BiometricEvaluation::Image::Image::getRawData(
     const bool removeAlphaChannelIfPresent)
@@ -125,6 +373,195 @@ BiometricEvaluation::Image::Image::getRawData(
 	    this->getBitDepth(), components));
 }
 
+namespace
+{
+	/**
+	 * @return
+	 *	region, or the entire image when region has an empty
+	 *	size.
+	 * @throw Error::ParameterError
+	 *	region is not within dimensions, or reduction is too
+	 *	large.
+	 */
+	BE::Image::ROI
+	validateRegion(
+	    const BE::Image::ROI &region,
+	    const BE::Image::Size &dimensions,
+	    uint8_t reduction)
+	{
+		if (reduction > BE::Image::Image::MAX_REDUCTION)
+			throw BE::Error::ParameterError("Reduction exceeds " +
+			    std::to_string(BE::Image::Image::MAX_REDUCTION));
+
+		if ((region.size.xSize == 0) || (region.size.ySize == 0))
+			return (BE::Image::ROI(dimensions, 0, 0, {}));
+
+		if ((static_cast<uint64_t>(region.horzOffset) +
+		    region.size.xSize > dimensions.xSize) ||
+		    (static_cast<uint64_t>(region.vertOffset) +
+		    region.size.ySize > dimensions.ySize))
+			throw BE::Error::ParameterError("Region " +
+			    to_string(region) + " is not within image of "
+			    "size " + to_string(dimensions));
+		return (region);
+	}
+
+	/**
+	 * Crop a region from fully decoded raw data, averaging blocks
+	 * of 2^reduction pixels square (clipped to the image).
+	 */
+	BE::Memory::uint8Array
+	reduceRegion(
+	    const BE::Memory::ByteSpan &rawData,
+	    const BE::Image::Size &dimensions,
+	    uint16_t bitDepth,
+	    const BE::Image::ROI &region,
+	    uint8_t reduction)
+	{
+		const uint64_t pixelCount = static_cast<uint64_t>(
+		    dimensions.xSize) * dimensions.ySize;
+		if ((pixelCount == 0) || (rawData.size() % pixelCount != 0))
+			throw BE::Error::DataError("Raw data size does not "
+			    "match image dimensions");
+		const uint64_t pixelSize = rawData.size() / pixelCount;
+		const uint64_t rowSize = pixelSize * dimensions.xSize;
+
+		const uint64_t scale = uint64_t(1) << reduction;
+		const uint64_t x0 = region.horzOffset >> reduction;
+		const uint64_t y0 = region.vertOffset >> reduction;
+		const uint64_t x1 = (static_cast<uint64_t>(region.horzOffset) +
+		    region.size.xSize + scale - 1) >> reduction;
+		const uint64_t y1 = (static_cast<uint64_t>(region.vertOffset) +
+		    region.size.ySize + scale - 1) >> reduction;
+		const uint64_t outRowSize = (x1 - x0) * pixelSize;
+
+		BE::Memory::uint8Array out(outRowSize * (y1 - y0),
+		    BE::Memory::Allocation::Pooled);
+		if (reduction == 0) {
+			for (uint64_t y = y0; y < y1; y++)
+				std::memcpy(out + ((y - y0) * outRowSize),
+				    rawData.data() + (y * rowSize) +
+				    (x0 * pixelSize), outRowSize);
+			return (out);
+		}
+
+		const uint8_t componentSize = ((bitDepth == 16) &&
+		    (pixelSize % 2 == 0) ? 2 : 1);
+		const uint64_t componentsPerRow = outRowSize / componentSize;
+		std::vector<uint64_t> sums(componentsPerRow);
+		for (uint64_t oy = y0; oy < y1; oy++) {
+			const uint64_t yStart = oy * scale;
+			const uint64_t yEnd = std::min<uint64_t>(yStart + scale,
+			    dimensions.ySize);
+
+			std::fill(sums.begin(), sums.end(), 0);
+			for (uint64_t y = yStart; y < yEnd; y++) {
+				const uint8_t *row = rawData.data() +
+				    (y * rowSize);
+				for (uint64_t ox = x0; ox < x1; ox++) {
+					const uint64_t xStart = ox * scale;
+					const uint64_t xEnd = std::min<uint64_t>(
+					    xStart + scale, dimensions.xSize);
+					uint64_t *sum = &sums[((ox - x0) *
+					    pixelSize) / componentSize];
+					for (uint64_t x = xStart; x < xEnd;
+					    x++) {
+						const uint8_t *pixel = row +
+						    (x * pixelSize);
+						for (uint64_t c = 0; c <
+						    pixelSize / componentSize;
+						    c++) {
+							if (componentSize == 1) {
+								sum[c] += pixel[c];
+							} else {
+								uint16_t value;
+								std::memcpy(&value,
+								    pixel + (c * 2),
+								    2);
+								sum[c] += value;
+							}
+						}
+					}
+				}
+			}
+
+			uint8_t *outRow = out + ((oy - y0) * outRowSize);
+			for (uint64_t i = 0; i < componentsPerRow; i++) {
+				const uint64_t ox = x0 + ((i * componentSize) /
+				    pixelSize);
+				const uint64_t count = (yEnd - yStart) *
+				    (std::min<uint64_t>((ox + 1) * scale,
+				    dimensions.xSize) - (ox * scale));
+				const uint64_t average = (sums[i] +
+				    (count / 2)) / count;
+				if (componentSize == 1) {
+					outRow[i] = static_cast<uint8_t>(average);
+				} else {
+					const uint16_t value =
+					    static_cast<uint16_t>(average);
+					std::memcpy(outRow + (i * 2), &value, 2);
+				}
+			}
+		}
+
+		return (out);
+	}
+}
+
+BiometricEvaluation::Memory::uint8Array
+BiometricEvaluation::Image::Image::getRawData(
+    const ROI &region,
+    uint8_t reduction)
+    const
+{
+	const Size dimensions = this->getDimensions();
+	const ROI validRegion = validateRegion(region, dimensions, reduction);
+	if ((reduction == 0) && (validRegion.size == dimensions))
+		return (this->getRawData());
+
+	/* Prefer cropping decoded data to decoding again */
+	if (DecodeCache::isEnabled()) {
+		const std::shared_ptr<const Memory::uint8Array> rawData =
+		    DecodeCache::find(this);
+		if (rawData != nullptr)
+			return (reduceRegion(Memory::ByteSpan(rawData),
+			    dimensions, this->getBitDepth(), validRegion,
+			    reduction));
+	}
+
+	return (this->decodeRegion(validRegion, reduction));
+}
+
+BiometricEvaluation::Image::Size
+BiometricEvaluation::Image::Image::getRegionDimensions(
+    const ROI &region,
+    uint8_t reduction)
+    const
+{
+	const ROI validRegion = validateRegion(region, this->getDimensions(),
+	    reduction);
+
+	const uint64_t scale = uint64_t(1) << reduction;
+	const uint64_t x0 = validRegion.horzOffset >> reduction;
+	const uint64_t y0 = validRegion.vertOffset >> reduction;
+	const uint64_t x1 = (static_cast<uint64_t>(validRegion.horzOffset) +
+	    validRegion.size.xSize + scale - 1) >> reduction;
+	const uint64_t y1 = (static_cast<uint64_t>(validRegion.vertOffset) +
+	    validRegion.size.ySize + scale - 1) >> reduction;
+	return (Size(static_cast<uint32_t>(x1 - x0),
+	    static_cast<uint32_t>(y1 - y0)));
+}
+
+BiometricEvaluation::Memory::uint8Array
+BiometricEvaluation::Image::Image::decodeRegion(
+    const ROI &region,
+    uint8_t reduction)
+    const
+{
+	return (reduceRegion(this->getRawDataSpan(), this->getDimensions(),
+	    this->getBitDepth(), region, reduction));
+}
+
 BiometricEvaluation::Memory::uint8Array
 BiometricEvaluation::Image::Image::getRawGrayscaleData(
     uint8_t depth)
@@ -137,121 +574,23 @@ BiometricEvaluation::Image::Image::getRawGrayscaleData(
 	if (this->getColorDepth() == depth)
 		return (this->getRawData());
 
-	const uint8_t bpcIn = static_cast<uint8_t>(
-	    std::ceil(this->getColorDepth() / 8.0));
-	const Memory::uint8Array rawColor{this->getRawData()};
-	Memory::IndexedBuffer inBuffer{rawColor};
+	/* 1-bit conversions are quantized after converting to 8-bit */
+	const uint8_t grayDepth = (depth == 1 ? 8 : depth);
 
-	const uint8_t bpcOut = static_cast<uint8_t>(std::ceil(depth / 8.0));
-	Memory::uint8Array rawGray(
-	    bpcOut * this->getDimensions().xSize * this->getDimensions().ySize);
-	Memory::MutableIndexedBuffer outBuffer(rawGray);
+	const uint32_t colorDepth = this->getColorDepth();
+	const uint8_t bpcIn = static_cast<uint8_t>(std::ceil(colorDepth / 8.0));
+	const uint64_t pixelCount = static_cast<uint64_t>(
+	    this->getDimensions().xSize) * this->getDimensions().ySize;
+	const Memory::ByteSpan rawColor{this->getRawDataSpan()};
+	if (rawColor.size() != (pixelCount * bpcIn))
+		throw Error::DataError("Raw data size does not match image "
+		    "dimensions");
 
-	/* Constants from ITU-R BT.601 */
-	static const float redFactor = 0.299;
-	static const float greenFactor = 0.587;
-	static const float blueFactor = 0.114;
+	Memory::uint8Array rawGray(pixelCount * (grayDepth / 8),
+	    Memory::Allocation::Pooled);
 
-	uint16_t rValue, bValue, gValue;
-
-	/*
-	 * Convert to 16-bit or 8-bit. 1-bit conversions will be quantized
-	 * after converting to 8-bit.
-	 */
-	for (uint32_t i = 0; i < rawColor.size(); i += bpcIn) {
-		switch (this->getColorDepth()) {
-		case 1:
-			/* Bitmap images are upped to 8-bit in getRawData() */
-			/* FALLTHROUGH */
-		case 8: /* 8-bit single-channel (grayscale) */
-			if (depth == 8) {
-				outBuffer.pushU8Val(inBuffer.scanU8Val());
-			} else if (depth == 16) {
-				/* Get 16-bit colorspace interpolated value */
-				outBuffer.pushU16Val(valueInColorspace(
-				    inBuffer.scanU8Val(), UINT8_MAX, 16));
-			}
-
-			break;
-		case 16: /* 16-bit single-channel (grayscale) */
-			if (depth == 8) {
-				/* Interpolate value in 8-bit colorspace */
-				outBuffer.pushU8Val(valueInColorspace(
-				    inBuffer.scanU16Val(), UINT16_MAX, 8));
-			}
-
-			break;
-		case 32: /* 8-bit RGBA */
-			/* FALLTHROUGH (ignoring alpha channel) */
-		case 24: /* 8-bit RGB */
-			if (depth == 16) {
-				/* Get 16-bit colorspace interpolated value */
-				rValue = static_cast<uint16_t>(
-				    valueInColorspace(inBuffer.scanU8Val(),
-				    UINT8_MAX, 16));
-				gValue = static_cast<uint16_t>(
-				    valueInColorspace(inBuffer.scanU8Val(),
-				    UINT8_MAX, 16));
-				bValue = static_cast<uint16_t>(
-				    valueInColorspace(inBuffer.scanU8Val(),
-				    UINT8_MAX, 16));
-
-				/* Pull Y' component from Y'CbCr */
-				outBuffer.pushU16Val((rValue * redFactor) +
-				    (gValue * greenFactor) +
-				    (bValue * blueFactor));
-			} else {
-				/* Pull Y' component from Y'CbCr */
-				outBuffer.pushU8Val(static_cast<uint8_t>(
-				    (inBuffer.scanU8Val() * redFactor) +
-				    (inBuffer.scanU8Val() * greenFactor) +
-				    (inBuffer.scanU8Val() * blueFactor)));
-			}
-
-			/* Increment over the alpha channel */
-			if (this->getColorDepth() == 32)
-				inBuffer.scanU8Val();
-
-			break;
-		case 64: /* 16-bit RGBA */
-			/* FALLTHROUGH (ignoring alpha channel) */
-		case 48: /* 16-bit RGB */
-			/* Extract 16-bit values */
-			rValue = inBuffer.scanU16Val();
-			gValue = inBuffer.scanU16Val();
-			bValue = inBuffer.scanU16Val();
-
-			if (depth == 16) {
-				/* Y' component from Y'CbCr */
-				outBuffer.pushU16Val((rValue * redFactor) +
-				    (gValue * greenFactor) +
-				    (bValue * blueFactor));
-			} else {
-				/* Interpolate colors in 8-bit colorspace */
-				rValue = static_cast<uint8_t>(
-				    valueInColorspace(rValue, UINT16_MAX, 8));
-				gValue = static_cast<uint8_t>(
-				    valueInColorspace(gValue, UINT16_MAX, 8));
-				bValue = static_cast<uint8_t>(
-				    valueInColorspace(bValue, UINT16_MAX, 8));
-
-				/* Pull Y' component from Y'CbCr */
-				outBuffer.pushU8Val((rValue * redFactor) +
-				    (gValue * greenFactor) +
-				    (bValue * blueFactor));
-			}
-
-			/* Increment over the alpha channel */
-			if (this->getColorDepth() == 64)
-				inBuffer.scanU16Val();
-
-			break;
-		default:
-			throw BE::Error::NotImplemented("Grayscale conversion "
-			    "for " + std::to_string(this->getColorDepth()) + "-bit "
-			    "depth imagery");
-		}
-	}
+	PixelConversion::toGray(rawColor.data(), colorDepth, pixelCount,
+	    rawGray, grayDepth);
 
 	/* Quantize down to black and white */
 	if (depth == 1)
@@ -265,7 +604,14 @@ BiometricEvaluation::Memory::uint8Array
 BiometricEvaluation::Image::Image::getData()
     const
 {
-	return (Memory::uint8Array(_data));
+	return (this->_data.toUint8Array());
+}
+
+BiometricEvaluation::Memory::ByteSpan
+BiometricEvaluation::Image::Image::getDataSpan()
+    const
+{
+	return (this->_data);
 }
 
 void
@@ -300,7 +646,7 @@ const uint8_t *
 BiometricEvaluation::Image::Image::getDataPointer()
     const
 {
-	return (&(*(this->_data)));
+	return (this->_data.data());
 }
 
 uint64_t
@@ -312,7 +658,8 @@ BiometricEvaluation::Image::Image::getDataSize()
 
 BiometricEvaluation::Image::Image::~Image()
 {
-
+	/* Entries may remain from before the cache was disabled */
+	DecodeCache::erase(this);
 }
 
 uint64_t
@@ -339,32 +686,42 @@ BiometricEvaluation::Image::Image::openImage(
     const std::string &identifier,
     const statusCallback_t &statusCallback)
 {
-	switch (Image::getCompressionAlgorithm(data, size)) {
+	return (Image::openImage(Memory::ByteSpan::copyOf(data, size),
+	    identifier, statusCallback));
+}
+
+std::shared_ptr<BiometricEvaluation::Image::Image>
+BiometricEvaluation::Image::Image::openImage(
+    const Memory::ByteSpan &data,
+    const std::string &identifier,
+    const statusCallback_t &statusCallback)
+{
+	switch (Image::getCompressionAlgorithm(data.data(), data.size())) {
 	case CompressionAlgorithm::JPEGB:
-		return (std::shared_ptr<Image>(new JPEG(data, size,
+		return (std::shared_ptr<Image>(new JPEG(data,
 		    identifier, statusCallback)));
 	case CompressionAlgorithm::JPEGL:
-		return (std::shared_ptr<Image>(new JPEGL(data, size,
+		return (std::shared_ptr<Image>(new JPEGL(data,
 		    identifier, statusCallback)));
 	case CompressionAlgorithm::JP2:
 		/* FALLTHROUGH */
 	case CompressionAlgorithm::JP2L:
-		return (std::shared_ptr<Image>(new JPEG2000(data, size,
+		return (std::shared_ptr<Image>(new JPEG2000(data,
 		    identifier, statusCallback)));
 	case CompressionAlgorithm::PNG:
-		return (std::shared_ptr<Image>(new PNG(data, size,
+		return (std::shared_ptr<Image>(new PNG(data,
 		    identifier, statusCallback)));
 	case CompressionAlgorithm::NetPBM:
-		return (std::shared_ptr<Image>(new NetPBM(data, size,
+		return (std::shared_ptr<Image>(new NetPBM(data,
 		    identifier, statusCallback)));
 	case CompressionAlgorithm::WSQ20:
-		return (std::shared_ptr<Image>(new WSQ(data, size,
+		return (std::shared_ptr<Image>(new WSQ(data,
 		    identifier, statusCallback)));
 	case CompressionAlgorithm::BMP:
-		return (std::shared_ptr<Image>(new BMP(data, size,
+		return (std::shared_ptr<Image>(new BMP(data,
 		    identifier, statusCallback)));
 	case CompressionAlgorithm::TIFF:
-		return (std::shared_ptr<Image>(new TIFF(data, size,
+		return (std::shared_ptr<Image>(new TIFF(data,
 		    identifier, statusCallback)));
 	default:
 		throw Error::StrategyError("Could not determine compression "
@@ -411,8 +768,90 @@ BiometricEvaluation::Image::Image::openImage(
     const std::string &path,
     const statusCallback_t &statusCallback)
 {
-	Memory::uint8Array data = IO::Utility::readFile(path);
-	return (Image::openImage(data, path, statusCallback));
+	return (Image::openImage(Memory::ByteSpan::share(
+	    IO::Utility::readFile(path)), path, statusCallback));
+}
+
+namespace
+{
+	/** Leading bytes that identify a compression algorithm */
+	struct Signature
+	{
+		/** Bytes at the start of the data */
+		const char *magic;
+		/** Number of bytes in magic */
+		uint8_t length;
+		/** Smallest data the codec's predicate accepts */
+		uint8_t minimumSize;
+		/** Compression algorithm identified by magic */
+		BE::Image::CompressionAlgorithm algorithm;
+		/**
+		 * Resolves data whose magic alone is ambiguous, or
+		 * nullptr when magic is conclusive.
+		 */
+		BE::Image::CompressionAlgorithm (*resolve)(
+		    const uint8_t *data,
+		    uint64_t size);
+	};
+
+	/** @return NetPBM if data is NetPBM after leading comments */
+	BE::Image::CompressionAlgorithm
+	resolveNetPBM(
+	    const uint8_t *data,
+	    uint64_t size)
+	{
+		return (BE::Image::NetPBM::isNetPBM(data, size) ?
+		    BE::Image::CompressionAlgorithm::NetPBM :
+		    BE::Image::CompressionAlgorithm::None);
+	}
+
+	/*
+	 * No two entries match the same data, so detection agrees with
+	 * trying each codec's predicate in turn. Minimum sizes preserve
+	 * the bounds checks of those predicates.
+	 */
+	const Signature Signatures[] = {
+	    {"\x00\x00\x00\x0C\x6A\x50\x20\x20\x0D\x0A\x87\x0A",
+	        12, 12, BE::Image::CompressionAlgorithm::JP2, nullptr},
+	    {"#", 1, 1, BE::Image::CompressionAlgorithm::None,
+	        resolveNetPBM},
+	    {"BA", 2, 2, BE::Image::CompressionAlgorithm::BMP, nullptr},
+	    {"BM", 2, 2, BE::Image::CompressionAlgorithm::BMP, nullptr},
+	    {"CI", 2, 2, BE::Image::CompressionAlgorithm::BMP, nullptr},
+	    {"CP", 2, 2, BE::Image::CompressionAlgorithm::BMP, nullptr},
+	    {"IC", 2, 2, BE::Image::CompressionAlgorithm::BMP, nullptr},
+	    {"II", 2, 4, BE::Image::CompressionAlgorithm::TIFF, nullptr},
+	    {"MM", 2, 4, BE::Image::CompressionAlgorithm::TIFF, nullptr},
+	    {"P1", 2, 2, BE::Image::CompressionAlgorithm::NetPBM, nullptr},
+	    {"P2", 2, 2, BE::Image::CompressionAlgorithm::NetPBM, nullptr},
+	    {"P3", 2, 2, BE::Image::CompressionAlgorithm::NetPBM, nullptr},
+	    {"P4", 2, 2, BE::Image::CompressionAlgorithm::NetPBM, nullptr},
+	    {"P5", 2, 2, BE::Image::CompressionAlgorithm::NetPBM, nullptr},
+	    {"P6", 2, 2, BE::Image::CompressionAlgorithm::NetPBM, nullptr},
+	    {"PT", 2, 2, BE::Image::CompressionAlgorithm::BMP, nullptr},
+	    {"\x89PNG\x0D\x0A\x1A\x0A", 8, 9,
+	        BE::Image::CompressionAlgorithm::PNG, nullptr},
+	    {"\xFF\xA0", 2, 2, BE::Image::CompressionAlgorithm::WSQ20,
+	        nullptr},
+	    {"\xFF\xD8", 2, 2, BE::Image::CompressionAlgorithm::None,
+	        BE::Image::JPEG::scanStartOfFrame}
+	};
+	const uint8_t SignatureCount = sizeof(Signatures) / sizeof(Signature);
+
+	/*
+	 * Index into Signatures of the first entry for each leading byte,
+	 * or SignatureCount when there is none. Entries with the same
+	 * leading byte are adjacent.
+	 */
+	const std::array<uint8_t, 256> FirstSignature = []() {
+		std::array<uint8_t, 256> first;
+		first.fill(SignatureCount);
+		for (uint8_t i = SignatureCount; i > 0; i--) {
+			const uint8_t leading = Signatures[i - 1].magic[0];
+			first[leading] = i - 1;
+		}
+		return (first);
+	}();
 }
 
 BiometricEvaluation::Image::CompressionAlgorithm
@@ -420,22 +859,20 @@ BiometricEvaluation::Image::Image::getCompressionAlgorithm(
     const uint8_t *data,
     const uint64_t size)
 {
-	if (NetPBM::isNetPBM(data, size))
-		return (CompressionAlgorithm::NetPBM);
-	else if (JPEG2000::isJPEG2000(data, size))
-		return (CompressionAlgorithm::JP2);
-	else if (JPEG::isJPEG(data, size))
-		return (CompressionAlgorithm::JPEGB);
-	else if (JPEGL::isJPEGL(data, size))
-		return (CompressionAlgorithm::JPEGL);
-	else if (PNG::isPNG(data, size))
-		return (CompressionAlgorithm::PNG);
-	else if (BMP::isBMP(data, size))
-		return (CompressionAlgorithm::BMP);
-	else if (WSQ::isWSQ(data, size))
-		return (CompressionAlgorithm::WSQ20);
-	else if (TIFF::isTIFF(data, size))
-		return (CompressionAlgorithm::TIFF);
+	if (size == 0)
+		return (CompressionAlgorithm::None);
+
+	for (uint8_t i = FirstSignature[data[0]]; (i < SignatureCount) &&
+	    (static_cast<uint8_t>(Signatures[i].magic[0]) == data[0]); i++) {
+		const Signature &signature = Signatures[i];
+		if ((size < signature.minimumSize) ||
+		    (std::memcmp(data, signature.magic, signature.length) != 0))
+			continue;
+
+		if (signature.resolve != nullptr)
+			return (signature.resolve(data, size));
+		return (signature.algorithm);
+	}
 
 	return (CompressionAlgorithm::None);
 }
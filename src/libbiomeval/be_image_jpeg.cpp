@@ -8,6 +8,7 @@
  * about its quality, reliability, or any other characteristic.
  */
 
+#include <algorithm>
 #include <cstdio>		/* Needed for NBIS headers */
 
 extern "C" {
@@ -26,9 +27,20 @@ BiometricEvaluation::Image::JPEG::JPEG(
     const uint64_t size,
     const std::string &identifier,
     const statusCallback_t &statusCallback) :
+    BiometricEvaluation::Image::JPEG::JPEG(
+    Memory::ByteSpan::copyOf(data, size),
+    identifier,
+    statusCallback)
+{
+
+}
+
+BiometricEvaluation::Image::JPEG::JPEG(
+    const BiometricEvaluation::Memory::ByteSpan &data,
+    const std::string &identifier,
+    const statusCallback_t &statusCallback) :
     Image::Image(
     data,
-    size,
     CompressionAlgorithm::JPEGB,
     identifier,
     statusCallback)
@@ -81,7 +93,19 @@ BiometricEvaluation::Image::JPEG::JPEG(
 }
 
 BiometricEvaluation::Memory::uint8Array
-BiometricEvaluation::Image::JPEG::getRawData()
+BiometricEvaluation::Image::JPEG::decodeRawData()
+    const
+{
+	Memory::uint8Array rawData(this->requiredBufferSize(),
+	    Memory::Allocation::Pooled);
+	this->decodeRawDataInto(rawData, this->getRawRowSize());
+	return (rawData);
+}
+
+void
+BiometricEvaluation::Image::JPEG::decodeRawDataInto(
+    uint8_t *buffer,
+    uint64_t stride)
     const
 {
 	/* Initialize custom JPEG error manager to throw exceptions */
@@ -104,24 +128,190 @@ BiometricEvaluation::Image::JPEG::getRawData()
 	    this->getDataSize());
 #endif
 
-	if (jpeg_read_header(&dinfo, TRUE) != JPEG_HEADER_OK)
-		throw Error::StrategyError("jpeg_read_header()");
-	if (jpeg_start_decompress(&dinfo) != TRUE)
-		throw Error::StrategyError("jpeg_start_decompress()");
+	try {
+		if (jpeg_read_header(&dinfo, TRUE) != JPEG_HEADER_OK)
+			throw Error::StrategyError("jpeg_read_header()");
+		if (jpeg_start_decompress(&dinfo) != TRUE)
+			throw Error::StrategyError("jpeg_start_decompress()");
+
+		const uint64_t row_stride = static_cast<uint64_t>(
+		    dinfo.output_width) * dinfo.output_components;
+		if ((row_stride != this->getRawRowSize()) ||
+		    (dinfo.output_height != this->getDimensions().ySize))
+			throw Error::DataError("Decoded size does not match "
+			    "image dimensions");
+
+		/* Scanlines are written directly into buffer */
+		while (dinfo.output_scanline < dinfo.output_height) {
+			JSAMPROW row = buffer +
+			    (dinfo.output_scanline * stride);
+			jpeg_read_scanlines(&dinfo, &row, 1);
+		}
 
-	uint64_t row_stride = dinfo.output_width * dinfo.output_components;
-	Memory::uint8Array rawData(dinfo.output_height * row_stride);
+		jpeg_finish_decompress(&dinfo);
+	} catch (...) {
+		jpeg_destroy_decompress(&dinfo);
+		throw;
+	}
+	jpeg_destroy_decompress(&dinfo);
+}
 
-	JSAMPARRAY buffer = (*dinfo.mem->alloc_sarray)(
-	    (j_common_ptr)&dinfo, JPOOL_IMAGE, row_stride, 1);
+void
+BiometricEvaluation::Image::JPEG::decodeRawRows(
+    const rowCallback_t &callback,
+    uint32_t rowsPerChunk)
+    const
+{
+	/* Initialize custom JPEG error manager to throw exceptions */
+	struct jpeg_error_mgr jpeg_error_mgr;
+	jpeg_std_error(&jpeg_error_mgr);
+	jpeg_error_mgr.error_exit = JPEG::error_exit;
+	jpeg_error_mgr.emit_message = JPEG::emit_message;
+	jpeg_error_mgr.output_message = JPEG::output_message;
 
-	for (int n = 0; dinfo.output_scanline < dinfo.output_height; n++) {
-		jpeg_read_scanlines(&dinfo, buffer, 1);
-		memcpy(&rawData[n * row_stride], buffer[0], row_stride);
+	struct jpeg_decompress_struct dinfo;
+	dinfo.err = &jpeg_error_mgr;
+	dinfo.client_data = (void *)this;
+	jpeg_create_decompress(&dinfo);
+
+#if JPEG_LIB_VERSION >= 80
+	::jpeg_mem_src(&dinfo, (unsigned char *)this->getDataPointer(),
+	    this->getDataSize());
+#else
+	JPEG::jpeg_mem_src(&dinfo, (unsigned char *)this->getDataPointer(),
+	    this->getDataSize());
+#endif
+
+	try {
+		if (jpeg_read_header(&dinfo, TRUE) != JPEG_HEADER_OK)
+			throw Error::StrategyError("jpeg_read_header()");
+		if (jpeg_start_decompress(&dinfo) != TRUE)
+			throw Error::StrategyError("jpeg_start_decompress()");
+
+		const uint64_t row_stride = static_cast<uint64_t>(
+		    dinfo.output_width) * dinfo.output_components;
+		if ((row_stride != this->getRawRowSize()) ||
+		    (dinfo.output_height != this->getDimensions().ySize))
+			throw Error::DataError("Decoded size does not match "
+			    "image dimensions");
+
+		/* libjpeg decodes a row of MCUs at a time */
+		if (rowsPerChunk == 0)
+			rowsPerChunk = dinfo.max_v_samp_factor * DCTSIZE;
+		rowsPerChunk = std::min(rowsPerChunk, dinfo.output_height);
+		Memory::uint8Array chunk(row_stride * rowsPerChunk,
+		    Memory::Allocation::Pooled);
+
+		while (dinfo.output_scanline < dinfo.output_height) {
+			const uint32_t firstRow = dinfo.output_scanline;
+			const uint32_t rowCount = std::min(rowsPerChunk,
+			    dinfo.output_height - firstRow);
+			while (dinfo.output_scanline < (firstRow + rowCount)) {
+				JSAMPROW row = chunk + ((dinfo.output_scanline -
+				    firstRow) * row_stride);
+				jpeg_read_scanlines(&dinfo, &row, 1);
+			}
+			callback(firstRow, rowCount, chunk);
+		}
+
+		jpeg_finish_decompress(&dinfo);
+	} catch (...) {
+		jpeg_destroy_decompress(&dinfo);
+		throw;
 	}
+	jpeg_destroy_decompress(&dinfo);
+}
 
-	/* Clean up after libjpeg */
-	jpeg_finish_decompress(&dinfo);
+BiometricEvaluation::Memory::uint8Array
+BiometricEvaluation::Image::JPEG::decodeRegion(
+    const ROI &region,
+    uint8_t reduction)
+    const
+{
+	/* libjpeg scales by 1/1, 1/2, 1/4, and 1/8 */
+	if (reduction > 3)
+		return (Image::decodeRegion(region, reduction));
+
+	/* Initialize custom JPEG error manager to throw exceptions */
+	struct jpeg_error_mgr jpeg_error_mgr;
+	jpeg_std_error(&jpeg_error_mgr);
+	jpeg_error_mgr.error_exit = JPEG::error_exit;
+	jpeg_error_mgr.emit_message = JPEG::emit_message;
+	jpeg_error_mgr.output_message = JPEG::output_message;
+
+	struct jpeg_decompress_struct dinfo;
+	dinfo.err = &jpeg_error_mgr;
+	dinfo.client_data = (void *)this;
+	jpeg_create_decompress(&dinfo);
+
+#if JPEG_LIB_VERSION >= 80
+	::jpeg_mem_src(&dinfo, (unsigned char *)this->getDataPointer(),
+	    this->getDataSize());
+#else
+	JPEG::jpeg_mem_src(&dinfo, (unsigned char *)this->getDataPointer(),
+	    this->getDataSize());
+#endif
+
+	Memory::uint8Array rawData;
+	try {
+		if (jpeg_read_header(&dinfo, TRUE) != JPEG_HEADER_OK)
+			throw Error::StrategyError("jpeg_read_header()");
+
+		/* Scale in the inverse DCT */
+		dinfo.scale_num = 1;
+		dinfo.scale_denom = 1 << reduction;
+		if (jpeg_start_decompress(&dinfo) != TRUE)
+			throw Error::StrategyError("jpeg_start_decompress()");
+
+		const Size regionSize = this->getRegionDimensions(region,
+		    reduction);
+		const JDIMENSION x0 = region.horzOffset >> reduction;
+		const JDIMENSION y0 = region.vertOffset >> reduction;
+		if ((x0 + regionSize.xSize > dinfo.output_width) ||
+		    (y0 + regionSize.ySize > dinfo.output_height))
+			throw Error::DataError("Scaled dimensions do not match "
+			    "image dimensions");
+
+		/*
+		 * libjpeg-turbo decodes only the iMCU columns spanning the
+		 * region and skips the rows above it without dequantizing.
+		 */
+		JDIMENSION firstColumn = x0;
+#if defined(LIBJPEG_TURBO_VERSION_NUMBER) && \
+    (LIBJPEG_TURBO_VERSION_NUMBER >= 1005000)
+		JDIMENSION cropOffset = x0, cropWidth = regionSize.xSize;
+		jpeg_crop_scanline(&dinfo, &cropOffset, &cropWidth);
+		firstColumn = x0 - cropOffset;
+		if (y0 > 0)
+			jpeg_skip_scanlines(&dinfo, y0);
+#endif
+
+		const uint64_t row_stride = dinfo.output_width *
+		    dinfo.output_components;
+		const uint64_t regionStride = static_cast<uint64_t>(
+		    regionSize.xSize) * dinfo.output_components;
+		rawData = Memory::uint8Array(regionSize.ySize * regionStride,
+		    Memory::Allocation::Pooled);
+
+		JSAMPARRAY buffer = (*dinfo.mem->alloc_sarray)(
+		    (j_common_ptr)&dinfo, JPOOL_IMAGE, row_stride, 1);
+
+		while (dinfo.output_scanline < y0 + regionSize.ySize) {
+			const JDIMENSION row = dinfo.output_scanline;
+			jpeg_read_scanlines(&dinfo, buffer, 1);
+			if (row < y0)
+				continue;
+			memcpy(&rawData[(row - y0) * regionStride],
+			    buffer[0] + (firstColumn * dinfo.output_components),
+			    regionStride);
+		}
+
+		/* Rows below the region are never decoded */
+		jpeg_abort_decompress(&dinfo);
+	} catch (...) {
+		jpeg_destroy_decompress(&dinfo);
+		throw;
+	}
 	jpeg_destroy_decompress(&dinfo);
 
 	return (rawData);
@@ -175,7 +365,8 @@ BiometricEvaluation::Image::JPEG::getRawGrayscaleData(
 		throw Error::StrategyError("jpeg_start_decompress()");
 
 	uint64_t row_stride = dinfo.output_width * dinfo.output_components;
-	Memory::uint8Array rawGray(dinfo.output_height * row_stride);
+	Memory::uint8Array rawGray(dinfo.output_height * row_stride,
+	    Memory::Allocation::Pooled);
 
 	JSAMPARRAY buffer = (*dinfo.mem->alloc_sarray)(
 	    (j_common_ptr)&dinfo, JPOOL_IMAGE, row_stride, 1);
@@ -206,8 +397,8 @@ BiometricEvaluation::Image::JPEG::getRawGrayscaleData(
 	return (rawGray);
 }
 
-bool
-BiometricEvaluation::Image::JPEG::isJPEG(
+BiometricEvaluation::Image::CompressionAlgorithm
+BiometricEvaluation::Image::JPEG::scanStartOfFrame(
     const uint8_t *data,
     uint64_t size)
 {
@@ -241,21 +432,24 @@ BiometricEvaluation::Image::JPEG::isJPEG(
 	/* First marker should be start of image */
 	uint16_t marker;
 	if (biomeval_nbis_getc_ushort(&marker, &markerBuf, endPtr) != 0)
-		return (false);
+		return (CompressionAlgorithm::None);
 	if (marker != startOfImage)
-		return (false);
+		return (CompressionAlgorithm::None);
 
 	/* Read markers until end of buffer or an identifying marker is found */
 	for (;;) {
 		/* Get next 16 bits */
 		if (biomeval_nbis_getc_ushort(&marker, &markerBuf, endPtr) != 0)
-			return (false);
-
-		/* 16-bit markers start with 0xFF but aren't 0xFF00 or 0xFFFF */
-		while (((marker >> 8) != 0xFF) &&
-		    ((marker == 0xFF00) || (marker == 0xFFFF)))
-			if (biomeval_nbis_getc_ushort(&marker, &markerBuf, endPtr) != 0)
-				return (false);
+			return (CompressionAlgorithm::None);
+
+		/* Any marker may be preceded by 0xFF fill bytes */
+		while (marker == 0xFFFF) {
+			uint8_t code;
+			if (biomeval_nbis_getc_byte(&code, &markerBuf,
+			    endPtr) != 0)
+				return (CompressionAlgorithm::None);
+			marker = 0xFF00 | code;
+		}
 
 		switch (marker) {
 		/* Lossy start of frame markers */
@@ -276,7 +470,7 @@ BiometricEvaluation::Image::JPEG::isJPEG(
 		case SOFDifferentialSequentialDCTArith:
 			/* FALLTHROUGH */
 		case SOFDifferentialProgressiveDCTArith:
-			return (true);
+			return (CompressionAlgorithm::JPEGB);
 
 		/* Lossless start of frame markers */
 		case SOFLosslessSequential:
@@ -286,19 +480,25 @@ BiometricEvaluation::Image::JPEG::isJPEG(
 		case SOFLosslessArith:
 			/* FALLTHROUGH */
 		case SOFDifferentialLosslessArith:
-			/* FALLTHROUGH */
+			return (CompressionAlgorithm::JPEGL);
 
 		/* Start of scan found before a start of frame */
 		case startOfScan:
-			return (false);
+			return (CompressionAlgorithm::None);
 		}
 
 		/* Reposition marker pointer after current marker segment */
 		if (JPEG::getc_skip_marker_segment(marker, &markerBuf, endPtr))
-			return (false);
+			return (CompressionAlgorithm::None);
 	}
+}
 
-	return (false);
+bool
+BiometricEvaluation::Image::JPEG::isJPEG(
+    const uint8_t *data,
+    uint64_t size)
+{
+	return (scanStartOfFrame(data, size) == CompressionAlgorithm::JPEGB);
 }
 
 void
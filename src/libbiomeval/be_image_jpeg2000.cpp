@@ -10,9 +10,12 @@
 
 #include <openjpeg.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <cstring>
 #include <be_image_jpeg2000.h>
-#include <be_memory_mutableindexedbuffer.h>
+#include <be_memory_indexedbuffer.h>
 
 namespace BE = BiometricEvaluation;
 
@@ -73,20 +76,61 @@ struct OpenJPEG_StreamDeleter
 	}
 };
 
+namespace
+{
+	/** Threads used when not set for an image */
+	std::atomic<uint32_t> defaultDecodeThreads{1};
+
+	/**
+	 * Number of OpenJPEG calls in progress on this thread. OpenJPEG
+	 * worker threads never have calls in progress, so they do not
+	 * call status callbacks or throw exceptions through OpenJPEG.
+	 */
+	thread_local uint32_t openjpegCalls{0};
+
+	/** Marks this thread as calling OpenJPEG while in scope */
+	struct OpenJPEGCall
+	{
+		OpenJPEGCall()
+		{
+			openjpegCalls++;
+		}
+
+		~OpenJPEGCall()
+		{
+			openjpegCalls--;
+		}
+	};
+}
+
 BiometricEvaluation::Image::JPEG2000::JPEG2000(
     const uint8_t *data,
     const uint64_t size,
     const std::string &identifier,
     const statusCallback_t &statusCallback,
     const int8_t codecFormat) :
+    BiometricEvaluation::Image::JPEG2000::JPEG2000(
+    Memory::ByteSpan::copyOf(data, size),
+    identifier,
+    statusCallback,
+    codecFormat)
+{
+
+}
+
+BiometricEvaluation::Image::JPEG2000::JPEG2000(
+    const BiometricEvaluation::Memory::ByteSpan &data,
+    const std::string &identifier,
+    const statusCallback_t &statusCallback,
+    const int8_t codecFormat) :
     Image::Image(
     data,
-    size,
     CompressionAlgorithm::JP2,
     identifier,
     statusCallback),
     _codecFormat(codecFormat)
 {
+	const OpenJPEGCall call;
 	std::unique_ptr<opj_codec_t, OpenJPEG_CodecDeleter> codec(
 	    static_cast<opj_codec_t*>(this->getDecompressionCodec()),
 	    OpenJPEG_CodecDeleter{});
@@ -172,9 +216,113 @@ BiometricEvaluation::Image::JPEG2000::JPEG2000(
 }
 
 BiometricEvaluation::Memory::uint8Array
-BiometricEvaluation::Image::JPEG2000::getRawData()
+BiometricEvaluation::Image::JPEG2000::decodeRawData()
+    const
+{
+	Memory::uint8Array rawData(this->requiredBufferSize(),
+	    Memory::Allocation::Pooled);
+	this->decodeRawDataInto(rawData, this->getRawRowSize());
+	return (rawData);
+}
+
+void
+BiometricEvaluation::Image::JPEG2000::decodeRawDataInto(
+    uint8_t *buffer,
+    uint64_t stride)
+    const
+{
+	/* Without reduction, the whole image is always decoded */
+	this->decode(ROI(this->getDimensions(), 0, 0, {}), 0, buffer, stride);
+}
+
+void
+BiometricEvaluation::Image::JPEG2000::decodeRawRows(
+    const rowCallback_t &callback,
+    uint32_t rowsPerChunk)
     const
 {
+	/* Find the grid of tiles */
+	OPJ_UINT32 tileOriginY{}, tileHeight{}, tileRows{};
+	{
+		const OpenJPEGCall call;
+		std::unique_ptr<opj_codec_t, OpenJPEG_CodecDeleter> codec(
+		    static_cast<opj_codec_t*>(this->getDecompressionCodec()),
+		    OpenJPEG_CodecDeleter{});
+		std::unique_ptr<opj_stream_t, OpenJPEG_StreamDeleter> stream(
+		    static_cast<opj_stream_t*>(
+		    this->getDecompressionStream()),
+		    OpenJPEG_StreamDeleter{});
+
+		opj_image_t *imagePtr = nullptr;
+		if (opj_read_header(stream.get(), codec.get(),
+		    &imagePtr) == OPJ_FALSE)
+			throw Error::Exception("Could not read header");
+		std::unique_ptr<opj_image_t, OpenJPEG_ImageDeleter> image(
+		    imagePtr, OpenJPEG_ImageDeleter{});
+
+		opj_codestream_info_v2_t *info = opj_get_cstr_info(
+		    codec.get());
+		if (info != nullptr) {
+			tileOriginY = info->ty0;
+			tileHeight = info->tdy;
+			tileRows = info->th;
+		}
+		opj_destroy_cstr_info(&info);
+	}
+
+	/*
+	 * A single tile is decoded all at once regardless. Grids offset
+	 * from the image origin are rare, and also decoded at once.
+	 */
+	if ((tileRows <= 1) || (tileHeight == 0) || (tileOriginY != 0)) {
+		Image::decodeRawRows(callback, rowsPerChunk);
+		return;
+	}
+
+	/* Decode one row of tiles at a time */
+	const Size dimensions = this->getDimensions();
+	const uint64_t rowSize = this->getRawRowSize();
+	Memory::uint8Array band(rowSize * std::min(tileHeight,
+	    dimensions.ySize), Memory::Allocation::Pooled);
+	for (uint32_t firstRow = 0; firstRow < dimensions.ySize; ) {
+		const uint32_t nextTileRow = ((firstRow / tileHeight) + 1) *
+		    tileHeight;
+		const uint32_t rowCount = std::min(nextTileRow,
+		    dimensions.ySize) - firstRow;
+
+		this->decode(ROI(Size(dimensions.xSize, rowCount), 0,
+		    firstRow, {}), 0, band, rowSize);
+		this->passRows(band, firstRow, rowCount, callback,
+		    rowsPerChunk);
+		firstRow += rowCount;
+	}
+}
+
+BiometricEvaluation::Memory::uint8Array
+BiometricEvaluation::Image::JPEG2000::decodeRegion(
+    const ROI &region,
+    uint8_t reduction)
+    const
+{
+	const Size regionSize = this->getRegionDimensions(region, reduction);
+	const uint64_t rowSize = ((static_cast<uint64_t>(regionSize.xSize) *
+	    this->getColorDepth()) + 7) / 8;
+	Memory::uint8Array rawData(rowSize * regionSize.ySize,
+	    Memory::Allocation::Pooled);
+	if (!this->decode(region, reduction, rawData, rowSize))
+		return (Image::decodeRegion(region, reduction));
+	return (rawData);
+}
+
+bool
+BiometricEvaluation::Image::JPEG2000::decode(
+    const ROI &region,
+    uint8_t reduction,
+    uint8_t *buffer,
+    uint64_t stride)
+    const
+{
+	const OpenJPEGCall call;
 	std::unique_ptr<opj_codec_t, OpenJPEG_CodecDeleter> codec(
 	    static_cast<opj_codec_t*>(this->getDecompressionCodec()),
 	    OpenJPEG_CodecDeleter{});
@@ -195,11 +343,45 @@ BiometricEvaluation::Image::JPEG2000::getRawData()
 	if (image->comps[0].sgnd == 1)
 		throw Error::NotImplemented("Signed buffers");
 
+	if (reduction > 0) {
+		/*
+		 * Discard resolution levels in the inverse wavelet
+		 * transform, when the codestream has enough of them.
+		 */
+		opj_codestream_info_v2_t *info = opj_get_cstr_info(codec.get());
+		bool haveLevels = (info != nullptr);
+		for (uint32_t i = 0; haveLevels && (i < image->numcomps); i++)
+			if (info->m_default_tile_info.tccp_info[i].
+			    numresolutions <= reduction)
+				haveLevels = false;
+		opj_destroy_cstr_info(&info);
+		if (!haveLevels)
+			return (false);
+
+		if (opj_set_decoded_resolution_factor(codec.get(),
+		    reduction) == OPJ_FALSE)
+			throw Error::StrategyError("Could not set resolution "
+			    "factor");
+	}
+
+	if (region.size != this->getDimensions()) {
+		/* Align to the reduced grid so no partial pixels remain */
+		const OPJ_INT32 x0 = std::max<OPJ_INT32>(image->x0,
+		    (region.horzOffset >> reduction) << reduction);
+		const OPJ_INT32 y0 = std::max<OPJ_INT32>(image->y0,
+		    (region.vertOffset >> reduction) << reduction);
+		if (opj_set_decode_area(codec.get(), image.get(), x0, y0,
+		    region.horzOffset + region.size.xSize,
+		    region.vertOffset + region.size.ySize) == OPJ_FALSE)
+			throw Error::StrategyError("Could not set decode area");
+	}
+
 	if (opj_decode(codec.get(), stream.get(), image.get()) == OPJ_FALSE)
 		throw Error::StrategyError("Could not initialize decoding");
 
-	const uint32_t w = this->getDimensions().xSize;
-	const uint32_t h = this->getDimensions().ySize;
+	const Size regionSize = this->getRegionDimensions(region, reduction);
+	const uint32_t w = regionSize.xSize;
+	const uint32_t h = regionSize.ySize;
 	const uint8_t bpc = image->comps[0].prec;
 
 	std::vector<int32_t*> ptr;
@@ -210,32 +392,34 @@ BiometricEvaluation::Image::JPEG2000::getRawData()
 			throw Error::NotImplemented("Non-equal components");
 	}
 
-	Memory::uint8Array rawData(image->numcomps * (bpc / 8) * image->x1 *
-	    image->y1);
-	Memory::MutableIndexedBuffer buffer(rawData);
+	if (bpc > 16)
+		throw Error::NotImplemented(std::to_string(bpc) +
+		    "-bit-per-component images");
+	const uint8_t bytesPerComponent = (bpc <= 8 ? 1 : 2);
+	if ((static_cast<uint64_t>(w) * image->numcomps * bytesPerComponent) !=
+	    (((static_cast<uint64_t>(w) * this->getColorDepth()) + 7) / 8))
+		throw Error::NotImplemented("Components not aligned to bytes");
 
+	/* Interleave components directly into the rows of buffer */
 	const int32_t mask = (1 << image->comps[0].prec) - 1;
 	for (uint32_t row = 0; row < h; ++row) {
+		uint8_t *rawRow = buffer + (row * stride);
 		for (uint32_t col = 0; col < w; ++col) {
-			if (bpc <= 8) {
-				for (uint32_t i = 0; i < image->numcomps; ++i) {
-					buffer.pushU8Val(*ptr[i] & mask);
-					ptr[i]++;
-				}
-			} else if (bpc <= 16) {
-				for (uint32_t i = 0; i < image->numcomps; ++i) {
-					buffer.pushU16Val(*ptr[i] & mask);
-					ptr[i]++;
+			for (uint32_t i = 0; i < image->numcomps; ++i) {
+				if (bytesPerComponent == 1) {
+					*rawRow++ = *ptr[i] & mask;
+				} else {
+					const uint16_t value = *ptr[i] & mask;
+					std::memcpy(rawRow, &value,
+					    sizeof(value));
+					rawRow += sizeof(value);
 				}
-			} else {
-				throw Error::NotImplemented(
-				    std::to_string(bpc) +
-				    "-bit-per-component images");
+				ptr[i]++;
 			}
 		}
 	}
 
-	return (rawData);
+	return (true);
 }
 
 BiometricEvaluation::Memory::uint8Array
@@ -246,6 +430,36 @@ BiometricEvaluation::Image::JPEG2000::getRawGrayscaleData(
 	return (Image::getRawGrayscaleData(depth));
 }
 
+void
+BiometricEvaluation::Image::JPEG2000::setDecodeThreads(
+    uint32_t threads)
+{
+	this->_decodeThreads = threads;
+	this->_hasDecodeThreads = true;
+}
+
+uint32_t
+BiometricEvaluation::Image::JPEG2000::getDecodeThreads()
+    const
+{
+	if (this->_hasDecodeThreads)
+		return (this->_decodeThreads);
+	return (defaultDecodeThreads);
+}
+
+void
+BiometricEvaluation::Image::JPEG2000::setDefaultDecodeThreads(
+    uint32_t threads)
+{
+	defaultDecodeThreads = threads;
+}
+
+uint32_t
+BiometricEvaluation::Image::JPEG2000::getDefaultDecodeThreads()
+{
+	return (defaultDecodeThreads);
+}
+
 bool
 BiometricEvaluation::Image::JPEG2000::isJPEG2000(
     const uint8_t *data,
@@ -267,6 +481,10 @@ BiometricEvaluation::Image::JPEG2000::openjpeg_error(
     const char *msg,
     void *client_data)
 {
+	/* Decoding threads report failure through the calling thread */
+	if (openjpegCalls == 0)
+		return;
+
 	if (client_data != nullptr) {
 		const JPEG2000 *jp2 = static_cast<const JPEG2000*>(client_data);
 		jp2->getStatusCallback()({Framework::Status::Type::Error,
@@ -282,7 +500,7 @@ BiometricEvaluation::Image::JPEG2000::openjpeg_warning(
     const char *msg,
     void *client_data)
 {
-	if (client_data == nullptr)
+	if ((client_data == nullptr) || (openjpegCalls == 0))
 		return;
 
 	const JPEG2000 *jp2 = static_cast<const JPEG2000*>(client_data);
@@ -295,7 +513,7 @@ BiometricEvaluation::Image::JPEG2000::openjpeg_info(
     const char *msg,
     void *client_data)
 {
-	if (client_data == nullptr)
+	if ((client_data == nullptr) || (openjpegCalls == 0))
 		return;
 
 	const JPEG2000 *jp2 = static_cast<const JPEG2000*>(client_data);
@@ -431,6 +649,22 @@ BiometricEvaluation::Image::JPEG2000::getDecompressionCodec()
 		throw Error::StrategyError("Could not initialize decoding");
 	}
 
+#if (OPJ_VERSION_MAJOR > 2) || \
+    ((OPJ_VERSION_MAJOR == 2) && (OPJ_VERSION_MINOR >= 2))
+	/* Decode tiles and code-blocks in parallel */
+	uint32_t threads = this->getDecodeThreads();
+	if (threads == ALL_CPUS)
+		threads = static_cast<uint32_t>(std::max(1, opj_get_num_cpus()));
+	if ((threads > 1) && (opj_has_thread_support() == OPJ_TRUE)) {
+		if (opj_codec_set_threads(codec, static_cast<int>(threads)) ==
+		    OPJ_FALSE) {
+			opj_destroy_codec(codec);
+			throw Error::StrategyError("Could not set decoding "
+			    "threads");
+		}
+	}
+#endif
+
 	return (codec);
 }
 
@@ -9,6 +9,7 @@
  */
 
 #include <cstdio>
+#include <cstdlib>
 
 extern "C" {
 	#include <dataio.h>
@@ -23,9 +24,20 @@ BiometricEvaluation::Image::JPEGL::JPEGL(
     const uint64_t size,
     const std::string &identifier,
     const statusCallback_t &statusCallback) :
+    BiometricEvaluation::Image::JPEGL::JPEGL(
+    Memory::ByteSpan::copyOf(data, size),
+    identifier,
+    statusCallback)
+{
+
+}
+
+BiometricEvaluation::Image::JPEGL::JPEGL(
+    const BiometricEvaluation::Memory::ByteSpan &data,
+    const std::string &identifier,
+    const statusCallback_t &statusCallback) :
     Image::Image(
     data,
-    size,
     CompressionAlgorithm::JPEGL,
     identifier,
     statusCallback)
@@ -102,29 +114,56 @@ BiometricEvaluation::Image::JPEGL::JPEGL(
 }
 
 BiometricEvaluation::Memory::uint8Array
-BiometricEvaluation::Image::JPEGL::getRawData()
+BiometricEvaluation::Image::JPEGL::decodeRawData()
+    const
+{
+	Memory::uint8Array rawData(this->requiredBufferSize(),
+	    Memory::Allocation::Pooled);
+	this->decodeRawDataInto(rawData, this->getRawRowSize());
+	return (rawData);
+}
+
+void
+BiometricEvaluation::Image::JPEGL::decodeRawDataInto(
+    uint8_t *buffer,
+    uint64_t stride)
     const
 {
-	/* TODO: Extract the raw data without using the IMG_DAT struct */
 	IMG_DAT *imgDat = nullptr;
 	int32_t lossy;
-	if (biomeval_nbis_jpegl_decode_mem(&imgDat, &lossy,
+	/* Per-call decoder state allows concurrent decoding */
+	JPEGL_DECODER decoder;
+	biomeval_nbis_init_jpegl_decoder(&decoder);
+	if (biomeval_nbis_jpegl_decode_mem_r(&decoder, &imgDat, &lossy,
 	    (unsigned char *)this->getDataPointer(), this->getDataSize()))
 		throw Error::DataError("Could not decode Lossless JPEG data");
 
+	/* Single component planes are copied without concatenation */
 	uint8_t *rawDataPtr = nullptr;
-	int32_t width, height, depth, ppi, rawSize;
-	if (biomeval_nbis_get_IMG_DAT_image(&rawDataPtr, &rawSize, &width, &height, &depth,
-	    &ppi, imgDat)) {
-		biomeval_nbis_free_IMG_DAT(imgDat, NO_FREE_IMAGE);
-		throw Error::DataError("Could not extract raw data");
+	int32_t rawSize = 0;
+	if (imgDat->n_cmpnts == 1) {
+		rawDataPtr = imgDat->image[0];
+		rawSize = imgDat->samp_width[0] * imgDat->samp_height[0];
+	} else {
+		int32_t width, height, depth, ppi;
+		if (biomeval_nbis_get_IMG_DAT_image(&rawDataPtr, &rawSize,
+		    &width, &height, &depth, &ppi, imgDat)) {
+			biomeval_nbis_free_IMG_DAT(imgDat, FREE_IMAGE);
+			throw Error::DataError("Could not extract raw data");
+		}
 	}
-	Memory::uint8Array rawData(rawSize);
-	rawData.copy(rawDataPtr);
 
+	try {
+		this->copyRawDataInto(rawDataPtr, rawSize, buffer, stride);
+	} catch (...) {
+		if (imgDat->n_cmpnts != 1)
+			free(rawDataPtr);
+		biomeval_nbis_free_IMG_DAT(imgDat, FREE_IMAGE);
+		throw;
+	}
+	if (imgDat->n_cmpnts != 1)
+		free(rawDataPtr);
 	biomeval_nbis_free_IMG_DAT(imgDat, FREE_IMAGE);
-
-	return (rawData);
 }
 
 BiometricEvaluation::Memory::uint8Array
@@ -140,93 +179,7 @@ BiometricEvaluation::Image::JPEGL::isJPEGL(
     const uint8_t *data,
     uint64_t size)
 {
-	uint8_t *markerBuf = (uint8_t *)data;
-	uint8_t *endPtr = (uint8_t *)data + size;
-
-	/*
-	 * JPEG markers (ISO/IEC 10918-1:1993)
-	 */
-	static const uint16_t startOfScan = 0xFFDA;
-	static const uint16_t startOfImage = 0xFFD8;
-
-	/* Start of frame, non-differential, Huffman coding */
-	static const uint16_t SOFBaselineDCT = 0xFFC0;
-	static const uint16_t SOFExtendedSequentialDCT = 0xFFC1;
-	static const uint16_t SOFProgressiveDCT = 0xFFC2;
-	static const uint16_t SOFLosslessSequential = 0xFFC3;
-	/* Start of frame, differential, Huffman coding */
-	static const uint16_t SOFDifferentialSequentialDCT = 0xFFC5;
-	static const uint16_t SOFDifferentialProgressiveDCT = 0xFFC6;
-	static const uint16_t SOFDifferentialLossless = 0xFFC7;
-	/* Start of frame, non-differential, arithmetic coding */
-	static const uint16_t SOFExtendedSequentialDCTArith = 0xFFC9;
-	static const uint16_t SOFProgressiveDCTArith = 0xFFCA;
-	static const uint16_t SOFLosslessArith = 0xFFCB;
-	/* Start of frame, differential, arithmetic coding */
-	static const uint16_t SOFDifferentialSequentialDCTArith = 0xFFCD;
-	static const uint16_t SOFDifferentialProgressiveDCTArith = 0xFFCE;
-	static const uint16_t SOFDifferentialLosslessArith = 0xFFCF;
-
-	/* First marker should be start of image */
-	uint16_t marker;
-	if (biomeval_nbis_getc_ushort(&marker, &markerBuf, endPtr) != 0)
-		return (false);
-	if (marker != startOfImage)
-		return (false);
-
-	/* Read markers until end of buffer or an identifying marker is found */
-	for (;;) {
-		/* Get next 16 bits */
-		if (biomeval_nbis_getc_ushort(&marker, &markerBuf, endPtr) != 0)
-			return (false);
-
-		/* 16-bit markers start with 0xFF but aren't 0xFF00 or 0xFFFF */
-		while (((marker >> 8) != 0xFF) &&
-		    ((marker == 0xFF00) || (marker == 0xFFFF)))
-			if (biomeval_nbis_getc_ushort(&marker, &markerBuf, endPtr) != 0)
-				return (false);
-
-		switch (marker) {
-		/* Lossless start of frame markers */
-		case SOFLosslessSequential:
-			/* FALLTHROUGH */
-		case SOFDifferentialLossless:
-			/* FALLTHROUGH */
-		case SOFLosslessArith:
-			/* FALLTHROUGH */
-		case SOFDifferentialLosslessArith:
-			return (true);
-
-		/* Lossy start of frame markers */
-		case SOFBaselineDCT:
-			/* FALLTHROUGH */
-		case SOFExtendedSequentialDCT:
-			/* FALLTHROUGH */
-		case SOFProgressiveDCT:
-			/* FALLTHROUGH */
-		case SOFDifferentialSequentialDCT:
-			/* FALLTHROUGH */
-		case SOFDifferentialProgressiveDCT:
-			/* FALLTHROUGH */
-		case SOFExtendedSequentialDCTArith:
-			/* FALLTHROUGH */
-		case SOFProgressiveDCTArith:
-			/* FALLTHROUGH */
-		case SOFDifferentialSequentialDCTArith:
-			/* FALLTHROUGH */
-		case SOFDifferentialProgressiveDCTArith:
-			/* FALLTHROUGH */
-
-		/* Start of scan found before a start of frame */
-		case startOfScan:
-			return (false);
-		}
-
-		/* Reposition marker pointer after current marker segment */
-		if (JPEG::getc_skip_marker_segment(marker, &markerBuf, endPtr))
-			return (false);
-	}
-
-	return (false);
+	return (JPEG::scanStartOfFrame(data, size) ==
+	    CompressionAlgorithm::JPEGL);
 }
 
@@ -10,6 +10,7 @@
 
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <sstream>
 #include <type_traits>
 
@@ -35,14 +36,25 @@ BiometricEvaluation::Image::NetPBM::NetPBM(
     const uint64_t size,
     const std::string &identifier,
     const statusCallback_t &statusCallback) :
+    BiometricEvaluation::Image::NetPBM::NetPBM(
+    Memory::ByteSpan::copyOf(data, size),
+    identifier,
+    statusCallback)
+{
+
+}
+
+BiometricEvaluation::Image::NetPBM::NetPBM(
+    const BiometricEvaluation::Memory::ByteSpan &data,
+    const std::string &identifier,
+    const statusCallback_t &statusCallback) :
     Image::Image(
     data,
-    size,
     CompressionAlgorithm::NetPBM,
     identifier,
     statusCallback)
 {
-	if (isNetPBM(data, size) != true)
+	if (isNetPBM(data.data(), data.size()) != true)
 		throw Error::DataError("Not a NetPBM formatted image");
 
 	try {
@@ -238,8 +250,19 @@ BiometricEvaluation::Image::NetPBM::skipLine(
 		offset++;
 }
 
+uint64_t
+BiometricEvaluation::Image::NetPBM::getRawRowSize()
+    const
+{
+	/* Bitmaps are expanded to 8-bit grayscale */
+	if ((this->_kind == Kind::ASCIIPortableBitmap) ||
+	    (this->_kind == Kind::BinaryPortableBitmap))
+		return (this->getDimensions().xSize);
+	return (Image::getRawRowSize());
+}
+
 BiometricEvaluation::Memory::uint8Array
-BiometricEvaluation::Image::NetPBM::getRawData()
+BiometricEvaluation::Image::NetPBM::decodeRawData()
     const
 {
 	const uint8_t *data = this->getDataPointer() + this->_headerLength;
@@ -261,7 +284,8 @@ BiometricEvaluation::Image::NetPBM::getRawData()
 	case Kind::BinaryPortableGraymap:
 		/* FALLTHROUGH */
 	case Kind::BinaryPortablePixmap: {
-		Memory::uint8Array rawData(dataSize);
+		Memory::uint8Array rawData(dataSize,
+		    Memory::Allocation::Pooled);
 		rawData.copy(data);
 
 		/* NetPBM stores data big-endian */
@@ -278,6 +302,38 @@ BiometricEvaluation::Image::NetPBM::getRawData()
 	}
 }
 
+void
+BiometricEvaluation::Image::NetPBM::decodeRawDataInto(
+    uint8_t *buffer,
+    uint64_t stride)
+    const
+{
+	if ((this->_kind != Kind::BinaryPortableGraymap) &&
+	    (this->_kind != Kind::BinaryPortablePixmap)) {
+		Image::decodeRawDataInto(buffer, stride);
+		return;
+	}
+
+	/* Binary maps are already raw, so copy rows straight to buffer */
+	const uint8_t *data = this->getDataPointer() + this->_headerLength;
+	const uint64_t dataSize = this->getDataSize() - this->_headerLength;
+	const uint64_t rowSize = this->getRawRowSize();
+	const uint32_t height = this->getDimensions().ySize;
+	if (dataSize < (rowSize * height))
+		throw Error::DataError("Not enough data for image dimensions");
+
+	/* NetPBM stores data big-endian */
+	const bool swap = ((this->getColorDepth() == 16 ||
+	    this->getColorDepth() == 48) && Memory::isLittleEndian());
+	for (uint32_t row = 0; row < height; row++) {
+		uint8_t *rawRow = buffer + (row * stride);
+		std::memcpy(rawRow, data + (row * rowSize), rowSize);
+		if (swap)
+			for (uint64_t i = 0; i < (rowSize - 1); i += 2)
+				std::swap(rawRow[i], rawRow[i + 1]);
+	}
+}
+
 BiometricEvaluation::Memory::uint8Array
 BiometricEvaluation::Image::NetPBM::ASCIIBitmapTo8Bit(
     const uint8_t *bitmap,
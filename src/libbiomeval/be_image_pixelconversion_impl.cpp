@@ -0,0 +1,825 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#include <cstring>
+#include <string>
+
+#include <be_error_exception.h>
+
+#include "be_image_pixelconversion_impl.h"
+
+/*
+ * Every implementation of a conversion performs the same single
+ * precision operations in the same order, so results do not depend on
+ * the instruction set used. The SIMD kernels return the index of the
+ * first pixel they did not convert, and the remaining pixels are
+ * converted by the next narrower implementation.
+ */
+
+/* Constants from ITU-R BT.601 */
+static const float RED_FACTOR = 0.299;
+static const float GREEN_FACTOR = 0.587;
+static const float BLUE_FACTOR = 0.114;
+
+/*
+ * Image::valueInColorspace(x, UINT8_MAX, 16) == x * 257 and
+ * Image::valueInColorspace(x, UINT16_MAX, 8) == x / 257. For 16-bit x,
+ * x / 257 == (x * DIVIDE_BY_257) >> 24.
+ */
+static const uint32_t WIDEN_8_TO_16 = 257;
+static const uint32_t DIVIDE_BY_257 = 65281;
+
+static inline uint16_t
+load16(
+    const uint8_t *p)
+{
+	uint16_t value;
+	std::memcpy(&value, p, sizeof(value));
+	return (value);
+}
+
+static inline void
+store16(
+    uint8_t *p,
+    uint16_t value)
+{
+	std::memcpy(p, &value, sizeof(value));
+}
+
+static inline float
+luma(
+    uint32_t r,
+    uint32_t g,
+    uint32_t b)
+{
+	/* Y' component from Y'CbCr */
+	return ((r * RED_FACTOR) + (g * GREEN_FACTOR) + (b * BLUE_FACTOR));
+}
+
+/*
+ * Portable implementations.
+ */
+
+static void
+gray8ToGray16Portable(
+    const uint8_t *in,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out)
+{
+	for (uint64_t i = first; i < count; i++)
+		store16(out + (i * 2), static_cast<uint16_t>(
+		    in[i] * WIDEN_8_TO_16));
+}
+
+static void
+gray16ToGray8Portable(
+    const uint8_t *in,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out)
+{
+	for (uint64_t i = first; i < count; i++)
+		out[i] = static_cast<uint8_t>(load16(in + (i * 2)) / 257);
+}
+
+static void
+rgb8ToGrayPortable(
+    const uint8_t *in,
+    uint8_t components,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out,
+    uint8_t depth)
+{
+	for (uint64_t i = first; i < count; i++) {
+		const uint8_t *p = in + (i * components);
+		if (depth == 16)
+			store16(out + (i * 2), static_cast<uint16_t>(luma(
+			    p[0] * WIDEN_8_TO_16, p[1] * WIDEN_8_TO_16,
+			    p[2] * WIDEN_8_TO_16)));
+		else
+			out[i] = static_cast<uint8_t>(luma(p[0], p[1], p[2]));
+	}
+}
+
+static void
+rgb16ToGrayPortable(
+    const uint8_t *in,
+    uint8_t components,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out,
+    uint8_t depth)
+{
+	for (uint64_t i = first; i < count; i++) {
+		const uint8_t *p = in + (i * components * 2);
+		const uint16_t r = load16(p);
+		const uint16_t g = load16(p + 2);
+		const uint16_t b = load16(p + 4);
+		if (depth == 16)
+			store16(out + (i * 2), static_cast<uint16_t>(
+			    luma(r, g, b)));
+		else
+			out[i] = static_cast<uint8_t>(luma(r / 257, g / 257,
+			    b / 257));
+	}
+}
+
+static void
+removeComponentsPortable(
+    const uint8_t *in,
+    uint64_t first,
+    uint64_t count,
+    uint8_t pixelSize,
+    const std::vector<uint8_t> &keptBytes,
+    uint8_t *out)
+{
+	const uint64_t keptSize = keptBytes.size();
+	for (uint64_t i = first; i < count; i++) {
+		const uint8_t *p = in + (i * pixelSize);
+		uint8_t *o = out + (i * keptSize);
+		for (const uint8_t offset : keptBytes)
+			*o++ = p[offset];
+	}
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#ifdef _MSC_VER
+#define TARGET_SSE41
+#define TARGET_AVX2
+#else
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+/*
+ * SSE4.1 implementations, converting four pixels at a time.
+ */
+
+/* Luma of four pixels whose components are in 32-bit lanes */
+TARGET_SSE41
+static inline __m128i
+lumaSSE41(
+    __m128i r,
+    __m128i g,
+    __m128i b)
+{
+	const __m128 y = _mm_add_ps(_mm_add_ps(
+	    _mm_mul_ps(_mm_cvtepi32_ps(r), _mm_set1_ps(RED_FACTOR)),
+	    _mm_mul_ps(_mm_cvtepi32_ps(g), _mm_set1_ps(GREEN_FACTOR))),
+	    _mm_mul_ps(_mm_cvtepi32_ps(b), _mm_set1_ps(BLUE_FACTOR)));
+	return (_mm_cvttps_epi32(y));
+}
+
+/*
+ * Shuffle moving 8-bit component `component` of four pixels of
+ * `pixelSize` bytes into 32-bit lanes.
+ */
+TARGET_SSE41
+static inline __m128i
+component8Shuffle(
+    uint8_t pixelSize,
+    uint8_t component)
+{
+	alignas(16) int8_t shuffle[16];
+	std::memset(shuffle, -1, sizeof(shuffle));
+	for (uint8_t px = 0; px < 4; px++)
+		shuffle[px * 4] = static_cast<int8_t>(
+		    (px * pixelSize) + component);
+	return (_mm_load_si128(reinterpret_cast<const __m128i *>(shuffle)));
+}
+
+/*
+ * Shuffle moving 16-bit component `component` of two pixels of
+ * `pixelSize` bytes into 32-bit lanes `lane` and `lane` + 1.
+ */
+TARGET_SSE41
+static inline __m128i
+component16Shuffle(
+    uint8_t pixelSize,
+    uint8_t component,
+    uint8_t lane)
+{
+	alignas(16) int8_t shuffle[16];
+	std::memset(shuffle, -1, sizeof(shuffle));
+	for (uint8_t px = 0; px < 2; px++) {
+		const uint8_t offset = (px * pixelSize) + (component * 2);
+		shuffle[(lane + px) * 4] = static_cast<int8_t>(offset);
+		shuffle[((lane + px) * 4) + 1] = static_cast<int8_t>(
+		    offset + 1);
+	}
+	return (_mm_load_si128(reinterpret_cast<const __m128i *>(shuffle)));
+}
+
+/* Components of four 16-bit pixels, given shuffles from above */
+struct Shuffle16
+{
+	__m128i r[2];
+	__m128i g[2];
+	__m128i b[2];
+};
+
+TARGET_SSE41
+static inline void
+initShuffle16(
+    Shuffle16 &shuffle,
+    uint8_t pixelSize)
+{
+	for (uint8_t half = 0; half < 2; half++) {
+		shuffle.r[half] = component16Shuffle(pixelSize, 0, half * 2);
+		shuffle.g[half] = component16Shuffle(pixelSize, 1, half * 2);
+		shuffle.b[half] = component16Shuffle(pixelSize, 2, half * 2);
+	}
+}
+
+/*
+ * Load components of four 16-bit pixels. Two 16-byte loads each
+ * cover two pixels, reading pixelSize * 2 + 16 bytes.
+ */
+TARGET_SSE41
+static inline void
+load16x4(
+    const uint8_t *p,
+    uint8_t pixelSize,
+    const Shuffle16 &shuffle,
+    __m128i &r,
+    __m128i &g,
+    __m128i &b)
+{
+	const __m128i lo = _mm_loadu_si128(
+	    reinterpret_cast<const __m128i *>(p));
+	const __m128i hi = _mm_loadu_si128(
+	    reinterpret_cast<const __m128i *>(p + (pixelSize * 2)));
+	r = _mm_or_si128(_mm_shuffle_epi8(lo, shuffle.r[0]),
+	    _mm_shuffle_epi8(hi, shuffle.r[1]));
+	g = _mm_or_si128(_mm_shuffle_epi8(lo, shuffle.g[0]),
+	    _mm_shuffle_epi8(hi, shuffle.g[1]));
+	b = _mm_or_si128(_mm_shuffle_epi8(lo, shuffle.b[0]),
+	    _mm_shuffle_epi8(hi, shuffle.b[1]));
+}
+
+/* Store four 32-bit lanes as 8-bit or 16-bit samples */
+TARGET_SSE41
+static inline void
+storeGrayx4(
+    uint8_t *out,
+    __m128i y,
+    uint8_t depth)
+{
+	const __m128i words = _mm_packus_epi32(y, y);
+	if (depth == 16) {
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(out), words);
+	} else {
+		const int32_t packed = _mm_cvtsi128_si32(
+		    _mm_packus_epi16(words, words));
+		std::memcpy(out, &packed, sizeof(packed));
+	}
+}
+
+TARGET_SSE41
+static uint64_t
+gray8ToGray16SSE41(
+    const uint8_t *in,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out)
+{
+	uint64_t i = first;
+	for (; (i + 16) <= count; i += 16) {
+		const __m128i v = _mm_loadu_si128(
+		    reinterpret_cast<const __m128i *>(in + i));
+		/* (x << 8) | x == x * 257 */
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + (i * 2)),
+		    _mm_unpacklo_epi8(v, v));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(
+		    out + (i * 2) + 16), _mm_unpackhi_epi8(v, v));
+	}
+	return (i);
+}
+
+TARGET_SSE41
+static uint64_t
+gray16ToGray8SSE41(
+    const uint8_t *in,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out)
+{
+	const __m128i divisor = _mm_set1_epi16(
+	    static_cast<int16_t>(DIVIDE_BY_257));
+	uint64_t i = first;
+	for (; (i + 16) <= count; i += 16) {
+		const __m128i lo = _mm_loadu_si128(
+		    reinterpret_cast<const __m128i *>(in + (i * 2)));
+		const __m128i hi = _mm_loadu_si128(
+		    reinterpret_cast<const __m128i *>(in + (i * 2) + 16));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+		    _mm_packus_epi16(
+		    _mm_srli_epi16(_mm_mulhi_epu16(lo, divisor), 8),
+		    _mm_srli_epi16(_mm_mulhi_epu16(hi, divisor), 8)));
+	}
+	return (i);
+}
+
+TARGET_SSE41
+static uint64_t
+rgb8ToGraySSE41(
+    const uint8_t *in,
+    uint8_t components,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out,
+    uint8_t depth)
+{
+	const __m128i rShuffle = component8Shuffle(components, 0);
+	const __m128i gShuffle = component8Shuffle(components, 1);
+	const __m128i bShuffle = component8Shuffle(components, 2);
+	const __m128i widen = _mm_set1_epi32(WIDEN_8_TO_16);
+
+	/* Each load reads 16 bytes, possibly past the fourth pixel */
+	uint64_t i = first;
+	for (; ((i * components) + 16) <= (count * components); i += 4) {
+		const __m128i v = _mm_loadu_si128(
+		    reinterpret_cast<const __m128i *>(in + (i * components)));
+		__m128i r = _mm_shuffle_epi8(v, rShuffle);
+		__m128i g = _mm_shuffle_epi8(v, gShuffle);
+		__m128i b = _mm_shuffle_epi8(v, bShuffle);
+		if (depth == 16) {
+			r = _mm_mullo_epi32(r, widen);
+			g = _mm_mullo_epi32(g, widen);
+			b = _mm_mullo_epi32(b, widen);
+			storeGrayx4(out + (i * 2), lumaSSE41(r, g, b), depth);
+		} else {
+			storeGrayx4(out + i, lumaSSE41(r, g, b), depth);
+		}
+	}
+	return (i);
+}
+
+TARGET_SSE41
+static uint64_t
+rgb16ToGraySSE41(
+    const uint8_t *in,
+    uint8_t components,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out,
+    uint8_t depth)
+{
+	const uint8_t pixelSize = components * 2;
+	Shuffle16 shuffle;
+	initShuffle16(shuffle, pixelSize);
+	const __m128i divisor = _mm_set1_epi32(DIVIDE_BY_257);
+
+	uint64_t i = first;
+	for (; (((i + 2) * pixelSize) + 16) <= (count * pixelSize); i += 4) {
+		__m128i r, g, b;
+		load16x4(in + (i * pixelSize), pixelSize, shuffle, r, g, b);
+		if (depth == 16) {
+			storeGrayx4(out + (i * 2), lumaSSE41(r, g, b), depth);
+		} else {
+			r = _mm_srli_epi32(_mm_mullo_epi32(r, divisor), 24);
+			g = _mm_srli_epi32(_mm_mullo_epi32(g, divisor), 24);
+			b = _mm_srli_epi32(_mm_mullo_epi32(b, divisor), 24);
+			storeGrayx4(out + i, lumaSSE41(r, g, b), depth);
+		}
+	}
+	return (i);
+}
+
+TARGET_SSE41
+static uint64_t
+removeComponentsSSE41(
+    const uint8_t *in,
+    uint64_t first,
+    uint64_t count,
+    uint8_t pixelSize,
+    const std::vector<uint8_t> &keptBytes,
+    uint8_t *out)
+{
+	if (pixelSize > 16)
+		return (first);
+
+	/* Keep as many whole pixels as fit in a register */
+	const uint8_t pixelsPerLoad = 16 / pixelSize;
+	const uint64_t keptSize = keptBytes.size();
+	alignas(16) int8_t shuffleBytes[16];
+	std::memset(shuffleBytes, -1, sizeof(shuffleBytes));
+	uint8_t next = 0;
+	for (uint8_t px = 0; px < pixelsPerLoad; px++)
+		for (const uint8_t offset : keptBytes)
+			shuffleBytes[next++] = static_cast<int8_t>(
+			    (px * pixelSize) + offset);
+	const __m128i shuffle = _mm_load_si128(
+	    reinterpret_cast<const __m128i *>(shuffleBytes));
+
+	/*
+	 * Loads and stores are 16 bytes, which may extend past the
+	 * pixels converted. Excess output is overwritten by the next
+	 * iteration.
+	 */
+	const uint64_t inSize = count * pixelSize;
+	const uint64_t outSize = count * keptSize;
+	uint64_t i = first;
+	for (; (((i * pixelSize) + 16) <= inSize) &&
+	    (((i * keptSize) + 16) <= outSize); i += pixelsPerLoad) {
+		const __m128i v = _mm_loadu_si128(
+		    reinterpret_cast<const __m128i *>(in + (i * pixelSize)));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(
+		    out + (i * keptSize)), _mm_shuffle_epi8(v, shuffle));
+	}
+	return (i);
+}
+
+/*
+ * AVX2 implementations, converting eight or more pixels at a time.
+ */
+
+/* Luma of eight pixels whose components are in 32-bit lanes */
+TARGET_AVX2
+static inline __m256i
+lumaAVX2(
+    __m256i r,
+    __m256i g,
+    __m256i b)
+{
+	const __m256 y = _mm256_add_ps(_mm256_add_ps(
+	    _mm256_mul_ps(_mm256_cvtepi32_ps(r), _mm256_set1_ps(RED_FACTOR)),
+	    _mm256_mul_ps(_mm256_cvtepi32_ps(g),
+	    _mm256_set1_ps(GREEN_FACTOR))),
+	    _mm256_mul_ps(_mm256_cvtepi32_ps(b), _mm256_set1_ps(BLUE_FACTOR)));
+	return (_mm256_cvttps_epi32(y));
+}
+
+TARGET_AVX2
+static inline __m256i
+combine(
+    __m128i lo,
+    __m128i hi)
+{
+	return (_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1));
+}
+
+/* Store eight 32-bit lanes as 8-bit or 16-bit samples */
+TARGET_AVX2
+static inline void
+storeGrayx8(
+    uint8_t *out,
+    __m256i y,
+    uint8_t depth)
+{
+	const __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(y),
+	    _mm256_extracti128_si256(y, 1));
+	if (depth == 16)
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(out), words);
+	else
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(out),
+		    _mm_packus_epi16(words, words));
+}
+
+TARGET_AVX2
+static uint64_t
+gray8ToGray16AVX2(
+    const uint8_t *in,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out)
+{
+	const __m256i widen = _mm256_set1_epi16(
+	    static_cast<int16_t>(WIDEN_8_TO_16));
+	uint64_t i = first;
+	for (; (i + 16) <= count; i += 16) {
+		const __m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128(
+		    reinterpret_cast<const __m128i *>(in + i)));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + (i * 2)),
+		    _mm256_mullo_epi16(v, widen));
+	}
+	return (i);
+}
+
+TARGET_AVX2
+static uint64_t
+gray16ToGray8AVX2(
+    const uint8_t *in,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out)
+{
+	const __m256i divisor = _mm256_set1_epi16(
+	    static_cast<int16_t>(DIVIDE_BY_257));
+	uint64_t i = first;
+	for (; (i + 32) <= count; i += 32) {
+		const __m256i lo = _mm256_loadu_si256(
+		    reinterpret_cast<const __m256i *>(in + (i * 2)));
+		const __m256i hi = _mm256_loadu_si256(
+		    reinterpret_cast<const __m256i *>(in + (i * 2) + 32));
+		/* Packing interleaves 128-bit lanes; restore their order */
+		const __m256i packed = _mm256_packus_epi16(
+		    _mm256_srli_epi16(_mm256_mulhi_epu16(lo, divisor), 8),
+		    _mm256_srli_epi16(_mm256_mulhi_epu16(hi, divisor), 8));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+		    _mm256_permute4x64_epi64(packed, 0xD8));
+	}
+	return (i);
+}
+
+TARGET_AVX2
+static uint64_t
+rgb8ToGrayAVX2(
+    const uint8_t *in,
+    uint8_t components,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out,
+    uint8_t depth)
+{
+	const __m128i rShuffle = component8Shuffle(components, 0);
+	const __m128i gShuffle = component8Shuffle(components, 1);
+	const __m128i bShuffle = component8Shuffle(components, 2);
+	const __m256i widen = _mm256_set1_epi32(WIDEN_8_TO_16);
+
+	uint64_t i = first;
+	for (; (((i + 4) * components) + 16) <= (count * components);
+	    i += 8) {
+		const uint8_t *p = in + (i * components);
+		const __m128i lo = _mm_loadu_si128(
+		    reinterpret_cast<const __m128i *>(p));
+		const __m128i hi = _mm_loadu_si128(
+		    reinterpret_cast<const __m128i *>(p + (components * 4)));
+		__m256i r = combine(_mm_shuffle_epi8(lo, rShuffle),
+		    _mm_shuffle_epi8(hi, rShuffle));
+		__m256i g = combine(_mm_shuffle_epi8(lo, gShuffle),
+		    _mm_shuffle_epi8(hi, gShuffle));
+		__m256i b = combine(_mm_shuffle_epi8(lo, bShuffle),
+		    _mm_shuffle_epi8(hi, bShuffle));
+		if (depth == 16) {
+			r = _mm256_mullo_epi32(r, widen);
+			g = _mm256_mullo_epi32(g, widen);
+			b = _mm256_mullo_epi32(b, widen);
+			storeGrayx8(out + (i * 2), lumaAVX2(r, g, b), depth);
+		} else {
+			storeGrayx8(out + i, lumaAVX2(r, g, b), depth);
+		}
+	}
+	return (i);
+}
+
+TARGET_AVX2
+static uint64_t
+rgb16ToGrayAVX2(
+    const uint8_t *in,
+    uint8_t components,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out,
+    uint8_t depth)
+{
+	const uint8_t pixelSize = components * 2;
+	Shuffle16 shuffle;
+	initShuffle16(shuffle, pixelSize);
+	const __m256i divisor = _mm256_set1_epi32(DIVIDE_BY_257);
+
+	uint64_t i = first;
+	for (; (((i + 6) * pixelSize) + 16) <= (count * pixelSize); i += 8) {
+		const uint8_t *p = in + (i * pixelSize);
+		__m128i rLo, gLo, bLo, rHi, gHi, bHi;
+		load16x4(p, pixelSize, shuffle, rLo, gLo, bLo);
+		load16x4(p + (pixelSize * 4), pixelSize, shuffle,
+		    rHi, gHi, bHi);
+		__m256i r = combine(rLo, rHi);
+		__m256i g = combine(gLo, gHi);
+		__m256i b = combine(bLo, bHi);
+		if (depth == 16) {
+			storeGrayx8(out + (i * 2), lumaAVX2(r, g, b), depth);
+		} else {
+			r = _mm256_srli_epi32(_mm256_mullo_epi32(r, divisor),
+			    24);
+			g = _mm256_srli_epi32(_mm256_mullo_epi32(g, divisor),
+			    24);
+			b = _mm256_srli_epi32(_mm256_mullo_epi32(b, divisor),
+			    24);
+			storeGrayx8(out + i, lumaAVX2(r, g, b), depth);
+		}
+	}
+	return (i);
+}
+
+namespace
+{
+	/** Widest instruction set usable by this processor */
+	enum class InstructionSet
+	{
+		Portable,
+		SSE41,
+		AVX2
+	};
+}
+
+static InstructionSet
+detectInstructionSet()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	const bool sse41 = ((info[2] & (1 << 19)) != 0);
+	const bool osAVX = ((info[2] & (1 << 27)) != 0) &&
+	    ((info[2] & (1 << 28)) != 0) && ((_xgetbv(0) & 0x6) == 0x6);
+	__cpuidex(info, 7, 0);
+	if (osAVX && ((info[1] & (1 << 5)) != 0))
+		return (InstructionSet::AVX2);
+	if (sse41)
+		return (InstructionSet::SSE41);
+#else
+	if (__builtin_cpu_supports("avx2"))
+		return (InstructionSet::AVX2);
+	if (__builtin_cpu_supports("sse4.1"))
+		return (InstructionSet::SSE41);
+#endif
+	return (InstructionSet::Portable);
+}
+
+static InstructionSet
+getInstructionSet()
+{
+	static const InstructionSet instructionSet = detectInstructionSet();
+	return (instructionSet);
+}
+
+#endif /* x86-64 */
+
+void
+BiometricEvaluation::Image::PixelConversion::gray8ToGray16(
+    const uint8_t *in,
+    uint64_t count,
+    uint8_t *out)
+{
+	uint64_t i = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+	switch (getInstructionSet()) {
+	case InstructionSet::AVX2:
+		i = gray8ToGray16AVX2(in, i, count, out);
+		/* FALLTHROUGH */
+	case InstructionSet::SSE41:
+		i = gray8ToGray16SSE41(in, i, count, out);
+		/* FALLTHROUGH */
+	case InstructionSet::Portable:
+		break;
+	}
+#endif
+	gray8ToGray16Portable(in, i, count, out);
+}
+
+void
+BiometricEvaluation::Image::PixelConversion::gray16ToGray8(
+    const uint8_t *in,
+    uint64_t count,
+    uint8_t *out)
+{
+	uint64_t i = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+	switch (getInstructionSet()) {
+	case InstructionSet::AVX2:
+		i = gray16ToGray8AVX2(in, i, count, out);
+		/* FALLTHROUGH */
+	case InstructionSet::SSE41:
+		i = gray16ToGray8SSE41(in, i, count, out);
+		/* FALLTHROUGH */
+	case InstructionSet::Portable:
+		break;
+	}
+#endif
+	gray16ToGray8Portable(in, i, count, out);
+}
+
+void
+BiometricEvaluation::Image::PixelConversion::rgb8ToGray(
+    const uint8_t *in,
+    uint8_t components,
+    uint64_t count,
+    uint8_t *out,
+    uint8_t depth)
+{
+	uint64_t i = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+	switch (getInstructionSet()) {
+	case InstructionSet::AVX2:
+		i = rgb8ToGrayAVX2(in, components, i, count, out, depth);
+		/* FALLTHROUGH */
+	case InstructionSet::SSE41:
+		i = rgb8ToGraySSE41(in, components, i, count, out, depth);
+		/* FALLTHROUGH */
+	case InstructionSet::Portable:
+		break;
+	}
+#endif
+	rgb8ToGrayPortable(in, components, i, count, out, depth);
+}
+
+void
+BiometricEvaluation::Image::PixelConversion::rgb16ToGray(
+    const uint8_t *in,
+    uint8_t components,
+    uint64_t count,
+    uint8_t *out,
+    uint8_t depth)
+{
+	uint64_t i = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+	switch (getInstructionSet()) {
+	case InstructionSet::AVX2:
+		i = rgb16ToGrayAVX2(in, components, i, count, out, depth);
+		/* FALLTHROUGH */
+	case InstructionSet::SSE41:
+		i = rgb16ToGraySSE41(in, components, i, count, out, depth);
+		/* FALLTHROUGH */
+	case InstructionSet::Portable:
+		break;
+	}
+#endif
+	rgb16ToGrayPortable(in, components, i, count, out, depth);
+}
+
+void
+BiometricEvaluation::Image::PixelConversion::toGray(
+    const uint8_t *in,
+    uint32_t colorDepth,
+    uint64_t count,
+    uint8_t *out,
+    uint8_t depth)
+{
+	if (colorDepth == depth) {
+		std::memcpy(out, in, count * (depth / 8));
+		return;
+	}
+
+	switch (colorDepth) {
+	case 1:
+		/* Bitmap images are upped to 8-bit in getRawData() */
+		/* FALLTHROUGH */
+	case 8: /* 8-bit single-channel (grayscale) */
+		if (depth == 8)
+			std::memcpy(out, in, count);
+		else
+			gray8ToGray16(in, count, out);
+		break;
+	case 16: /* 16-bit single-channel (grayscale) */
+		gray16ToGray8(in, count, out);
+		break;
+	case 24: /* 8-bit RGB */
+		/* FALLTHROUGH */
+	case 32: /* 8-bit RGBA (ignoring alpha channel) */
+		rgb8ToGray(in, colorDepth / 8, count, out, depth);
+		break;
+	case 48: /* 16-bit RGB */
+		/* FALLTHROUGH */
+	case 64: /* 16-bit RGBA (ignoring alpha channel) */
+		rgb16ToGray(in, colorDepth / 16, count, out, depth);
+		break;
+	default:
+		throw BiometricEvaluation::Error::NotImplemented("Grayscale "
+		    "conversion for " + std::to_string(colorDepth) + "-bit "
+		    "depth imagery");
+	}
+}
+
+void
+BiometricEvaluation::Image::PixelConversion::removeComponents(
+    const uint8_t *in,
+    uint64_t count,
+    uint8_t componentSize,
+    const std::vector<bool> &components,
+    uint8_t *out)
+{
+	/* Offsets within a pixel of each byte to keep */
+	std::vector<uint8_t> keptBytes;
+	for (uint8_t c = 0; c < components.size(); c++)
+		if (!components[c])
+			for (uint8_t b = 0; b < componentSize; b++)
+				keptBytes.push_back((c * componentSize) + b);
+	const uint8_t pixelSize = components.size() * componentSize;
+
+	uint64_t i = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+	/* Shuffles cross 128-bit lanes in AVX2, so use SSE4.1 for both */
+	if (getInstructionSet() != InstructionSet::Portable)
+		i = removeComponentsSSE41(in, i, count, pixelSize, keptBytes,
+		    out);
+#endif
+	removeComponentsPortable(in, i, count, pixelSize, keptBytes, out);
+}
@@ -0,0 +1,178 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_IMAGE_PIXELCONVERSION_IMPL_H__
+#define __BE_IMAGE_PIXELCONVERSION_IMPL_H__
+
+#include <cstdint>
+#include <vector>
+
+namespace BiometricEvaluation
+{
+	namespace Image
+	{
+		/**
+		 * @brief
+		 * Conversions between raw pixel formats.
+		 * @details
+		 * Each conversion has a portable implementation and, on
+		 * x86-64, SSE4.1 and AVX2 implementations chosen when
+		 * the processor supports them. All implementations
+		 * produce identical output.
+		 *
+		 * 16-bit samples are in native byte order, as produced
+		 * by Image::getRawData(). Luma is computed with the
+		 * ITU-R BT.601 coefficients in single precision, and
+		 * truncated.
+		 */
+		namespace PixelConversion
+		{
+			/**
+			 * @brief
+			 * Widen 8-bit gray samples to 16 bits.
+			 *
+			 * @param[in] in
+			 *	count 8-bit samples.
+			 * @param[in] count
+			 *	Number of pixels.
+			 * @param[out] out
+			 *	Buffer of at least count * 2 bytes.
+			 */
+			void
+			gray8ToGray16(
+			    const uint8_t *in,
+			    uint64_t count,
+			    uint8_t *out);
+
+			/**
+			 * @brief
+			 * Narrow 16-bit gray samples to 8 bits.
+			 *
+			 * @param[in] in
+			 *	count 16-bit samples.
+			 * @param[in] count
+			 *	Number of pixels.
+			 * @param[out] out
+			 *	Buffer of at least count bytes.
+			 */
+			void
+			gray16ToGray8(
+			    const uint8_t *in,
+			    uint64_t count,
+			    uint8_t *out);
+
+			/**
+			 * @brief
+			 * Convert 8-bit RGB or RGBA pixels to gray.
+			 *
+			 * @param[in] in
+			 *	count pixels of components 8-bit samples.
+			 * @param[in] components
+			 *	3 (RGB) or 4 (RGBA, alpha is ignored).
+			 * @param[in] count
+			 *	Number of pixels.
+			 * @param[out] out
+			 *	Buffer of at least count * depth / 8
+			 *	bytes.
+			 * @param[in] depth
+			 *	Bit depth of out, 8 or 16.
+			 */
+			void
+			rgb8ToGray(
+			    const uint8_t *in,
+			    uint8_t components,
+			    uint64_t count,
+			    uint8_t *out,
+			    uint8_t depth);
+
+			/**
+			 * @brief
+			 * Convert 16-bit RGB or RGBA pixels to gray.
+			 *
+			 * @param[in] in
+			 *	count pixels of components 16-bit
+			 *	samples.
+			 * @param[in] components
+			 *	3 (RGB) or 4 (RGBA, alpha is ignored).
+			 * @param[in] count
+			 *	Number of pixels.
+			 * @param[out] out
+			 *	Buffer of at least count * depth / 8
+			 *	bytes.
+			 * @param[in] depth
+			 *	Bit depth of out, 8 or 16.
+			 */
+			void
+			rgb16ToGray(
+			    const uint8_t *in,
+			    uint8_t components,
+			    uint64_t count,
+			    uint8_t *out,
+			    uint8_t depth);
+
+			/**
+			 * @brief
+			 * Convert pixels of any supported color depth to
+			 * gray, as Image::getRawGrayscaleData().
+			 *
+			 * @param[in] in
+			 *	count pixels of colorDepth bits, or 8 bits
+			 *	when colorDepth is 1.
+			 * @param[in] colorDepth
+			 *	Bits per pixel of in: 1, 8 or 16 (gray), 24
+			 *	or 48 (RGB), 32 or 64 (RGBA).
+			 * @param[in] count
+			 *	Number of pixels.
+			 * @param[out] out
+			 *	Buffer of at least count * depth / 8
+			 *	bytes.
+			 * @param[in] depth
+			 *	Bit depth of out, 8 or 16.
+			 *
+			 * @throw Error::NotImplemented
+			 *	colorDepth is not supported.
+			 */
+			void
+			toGray(
+			    const uint8_t *in,
+			    uint32_t colorDepth,
+			    uint64_t count,
+			    uint8_t *out,
+			    uint8_t depth);
+
+			/**
+			 * @brief
+			 * Copy pixels, omitting some of their components.
+			 *
+			 * @param[in] in
+			 *	count pixels of components.size()
+			 *	components.
+			 * @param[in] count
+			 *	Number of pixels.
+			 * @param[in] componentSize
+			 *	Bytes per component.
+			 * @param[in] components
+			 *	true for each component to be omitted.
+			 * @param[out] out
+			 *	Buffer large enough for count pixels of
+			 *	the remaining components.
+			 */
+			void
+			removeComponents(
+			    const uint8_t *in,
+			    uint64_t count,
+			    uint8_t componentSize,
+			    const std::vector<bool> &components,
+			    uint8_t *out);
+		}
+	}
+}
+
+#endif /* __BE_IMAGE_PIXELCONVERSION_IMPL_H__ */
@@ -8,12 +8,13 @@
  * about its quality, reliability, or any other characteristic.
  */
 
+#include <algorithm>
+
 #include <png.h>
 
 #include <be_image_png.h>
 #include <be_memory.h>
 #include <be_memory_autoarray.h>
-#include <be_memory_mutableindexedbuffer.h>
 
 namespace BE = BiometricEvaluation;
 
@@ -88,9 +89,20 @@ BiometricEvaluation::Image::PNG::PNG(
     const uint64_t size,
     const std::string &identifier,
     const statusCallback_t &statusCallback) :
+    BiometricEvaluation::Image::PNG::PNG(
+    Memory::ByteSpan::copyOf(data, size),
+    identifier,
+    statusCallback)
+{
+
+}
+
+BiometricEvaluation::Image::PNG::PNG(
+    const BiometricEvaluation::Memory::ByteSpan &data,
+    const std::string &identifier,
+    const statusCallback_t &statusCallback) :
     Image::Image(
     data,
-    size,
     CompressionAlgorithm::PNG,
     identifier,
     statusCallback)
@@ -154,6 +166,21 @@ BiometricEvaluation::Image::PNG::PNG(
 	this->setHasAlphaChannel((color_type & PNG_COLOR_MASK_ALPHA) ==
 	    PNG_COLOR_MASK_ALPHA);
 
+	/* Palettes that are not grayscale are expanded to RGB */
+	png_colorp palette{};
+	int paletteSize{};
+	if ((this->getBitDepth() <= 8) &&
+	    ((color_type & PNG_COLOR_MASK_PALETTE) == PNG_COLOR_MASK_PALETTE) &&
+	    (png_get_PLTE(png_ptr, png_info_ptr, &palette, &paletteSize) ==
+	    PNG_INFO_PLTE))
+		this->_colorPalette = !std::all_of(&palette[0],
+		    &palette[paletteSize], [](const png_color &c) -> bool {
+			return ((c.red == c.green) && (c.green == c.blue));
+		});
+
+	this->_interlaced = (png_get_interlace_type(png_ptr, png_info_ptr) !=
+	    PNG_INTERLACE_NONE);
+
 	png_destroy_read_struct(&png_ptr, &png_info_ptr, nullptr);
 }
 
@@ -170,8 +197,64 @@ BiometricEvaluation::Image::PNG::PNG(
 
 }
 
+uint64_t
+BiometricEvaluation::Image::PNG::getRawRowSize()
+    const
+{
+	if (this->_colorPalette)
+		return (Image::getRawRowSize() * 3);
+	return (Image::getRawRowSize());
+}
+
 BiometricEvaluation::Memory::uint8Array
-BiometricEvaluation::Image::PNG::getRawData()
+BiometricEvaluation::Image::PNG::decodeRawData()
+    const
+{
+	Memory::uint8Array rawData(this->requiredBufferSize(),
+	    Memory::Allocation::Pooled);
+	this->decodeRawDataInto(rawData, this->getRawRowSize());
+	return (rawData);
+}
+
+void
+BiometricEvaluation::Image::PNG::decodeRawDataInto(
+    uint8_t *buffer,
+    uint64_t stride)
+    const
+{
+	this->readRows(buffer, stride, {}, 0);
+}
+
+void
+BiometricEvaluation::Image::PNG::decodeRawRows(
+    const rowCallback_t &callback,
+    uint32_t rowsPerChunk)
+    const
+{
+	/* Interlaced rows are only complete after the last pass */
+	if (this->_interlaced) {
+		Image::decodeRawRows(callback, rowsPerChunk);
+		return;
+	}
+
+	/* libpng decodes a row at a time, so any chunk is natural */
+	static const uint32_t DefaultRowsPerChunk = 16;
+	if (rowsPerChunk == 0)
+		rowsPerChunk = DefaultRowsPerChunk;
+	rowsPerChunk = std::min(rowsPerChunk, this->getDimensions().ySize);
+
+	const uint64_t rowSize = this->getRawRowSize();
+	Memory::uint8Array chunk(rowSize * rowsPerChunk,
+	    Memory::Allocation::Pooled);
+	this->readRows(chunk, rowSize, callback, rowsPerChunk);
+}
+
+void
+BiometricEvaluation::Image::PNG::readRows(
+    uint8_t *buffer,
+    uint64_t stride,
+    const rowCallback_t &callback,
+    uint32_t rowsPerChunk)
     const
 {
 	png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING,
@@ -190,72 +273,98 @@ BiometricEvaluation::Image::PNG::getRawData()
 		throw Error::StrategyError("Could not initialize container for "
 		    "information");
 	}
-	png_read_info(png_ptr, png_info_ptr);
-
-	/* PNG default storage is big-endian */
-	if ((png_get_bit_depth(png_ptr, png_info_ptr) > 8) &&
-	    BiometricEvaluation::Memory::isLittleEndian())
-		png_set_swap(png_ptr);
-
-	/* Determine size of decompressed data */
-	const png_uint_32 rowbytes = png_get_rowbytes(png_ptr, png_info_ptr);
-	const uint32_t height = this->getDimensions().ySize;
-	Memory::AutoArray<png_bytep> row_pointers(height);
-	Memory::uint8Array rawData(rowbytes * height);
 
-	/* Tell libpng to store decompressed PNG data directly into AutoArray */
-	for (uint32_t row = 0; row < height; row++)
-		row_pointers[row] = rawData + (row * rowbytes);
-	png_read_image(png_ptr, row_pointers);
+	try {
+		png_read_info(png_ptr, png_info_ptr);
+
+		/* PNG default storage is big-endian */
+		if ((png_get_bit_depth(png_ptr, png_info_ptr) > 8) &&
+		    BiometricEvaluation::Memory::isLittleEndian())
+			png_set_swap(png_ptr);
+
+		/* Check size of decompressed data */
+		const png_size_t rowbytes = png_get_rowbytes(png_ptr,
+		    png_info_ptr);
+		const uint32_t height = this->getDimensions().ySize;
+		if ((rowbytes != Image::getRawRowSize()) ||
+		    (png_get_image_height(png_ptr, png_info_ptr) != height))
+			throw Error::DataError("Decoded size does not match "
+			    "image dimensions");
+
+		/* Check for palette color (1, 2, 4, 8-bit depth only) */
+		const png_byte color_type{png_get_color_type(png_ptr,
+		    png_info_ptr)};
+		png_colorp palette{};
+		int paletteSize{};
+		const bool hasPalette = (this->getBitDepth() <= 8) &&
+		    ((color_type & PNG_COLOR_MASK_PALETTE) ==
+		    PNG_COLOR_MASK_PALETTE);
+		if (hasPalette && (png_get_PLTE(png_ptr, png_info_ptr,
+		    &palette, &paletteSize) != PNG_INFO_PLTE))
+			throw BE::Error::StrategyError("Expected palette "
+			    "data, but no PLTE chunk found");
 
-	/* Check for palette color (1, 2, 4, 8-bit depth only) */
-	if (this->getBitDepth() > 8) {
-		png_destroy_read_struct(&png_ptr, &png_info_ptr, nullptr);
-		return (rawData);
-	}
-	png_byte color_type{png_get_color_type(png_ptr, png_info_ptr)};
-	if ((color_type & PNG_COLOR_MASK_PALETTE) != PNG_COLOR_MASK_PALETTE) {
+		/*
+		 * Tell libpng to store decompressed PNG data directly into
+		 * buffer, except for palette indexes that will be expanded
+		 * to RGB.
+		 */
+		const uint32_t chunkRows = (callback ? rowsPerChunk : height);
+		Memory::uint8Array indexes;
+		uint8_t *rows = buffer;
+		uint64_t rowStride = stride;
+		if (this->_colorPalette) {
+			indexes.resize(rowbytes * chunkRows);
+			rows = indexes;
+			rowStride = rowbytes;
+		}
+		Memory::AutoArray<png_bytep> row_pointers(chunkRows);
+		for (uint32_t row = 0; row < chunkRows; row++)
+			row_pointers[row] = rows + (row * rowStride);
+
+		for (uint32_t firstRow = 0; firstRow < height;
+		    firstRow += chunkRows) {
+			const uint32_t rowCount = std::min(chunkRows,
+			    height - firstRow);
+			if (callback)
+				png_read_rows(png_ptr, row_pointers, nullptr,
+				    rowCount);
+			else
+				png_read_image(png_ptr, row_pointers);
+
+			for (uint32_t row = 0; hasPalette &&
+			    (row < rowCount); row++) {
+				uint8_t *rawRow = buffer + (row * stride);
+				if (this->_colorPalette) {
+					const uint8_t *indexRow = indexes +
+					    (row * rowbytes);
+					for (png_size_t i = 0; i < rowbytes;
+					    i++) {
+						const auto paletteColor =
+						    palette[indexRow[i]];
+						*rawRow++ = paletteColor.red;
+						*rawRow++ = paletteColor.green;
+						*rawRow++ = paletteColor.blue;
+					}
+				} else {
+					for (png_size_t i = 0; i < rowbytes;
+					    i++)
+						rawRow[i] =
+						    palette[rawRow[i]].red;
+				}
+			}
+
+			if (callback)
+				callback(firstRow, rowCount, buffer);
+		}
+		if (hasPalette)
+			png_free_data(png_ptr, png_info_ptr, PNG_FREE_PLTE, 0);
+	} catch (...) {
 		png_destroy_read_struct(&png_ptr, &png_info_ptr, nullptr);
-		return (rawData);
-	}
-
-	/* Read and parse the palette data */
-	png_colorp palette{};
-	int paletteSize{};
-	if (png_get_PLTE(png_ptr, png_info_ptr, &palette, &paletteSize) !=
-	    PNG_INFO_PLTE) {
-	    	png_destroy_read_struct(&png_ptr, &png_info_ptr, nullptr);
-		throw BE::Error::StrategyError("Expected palette data, but no "
-		    "PLTE chunk found");
+		throw;
 	}
 
-	const bool paletteIsGrayscale = std::all_of(&palette[0],
-	    &palette[paletteSize], [](const png_color &c) -> bool {
-		return ((c.red == c.green) && (c.green == c.blue));
-	});
-
-	if (paletteIsGrayscale) {
-		std::for_each(rawData.begin(), rawData.end(), [&](uint8_t &c) {
-			c = palette[c].red;
-		});
-	} else {
-		BE::Memory::uint8Array expandedRawData(rawData.size() * 3);
-		BE::Memory::MutableIndexedBuffer buf{expandedRawData};
-
-		std::for_each(rawData.begin(), rawData.end(),
-		    [&](const uint8_t &c) {
-			const auto paletteColor = palette[c];
-			buf.pushU8Val(paletteColor.red);
-			buf.pushU8Val(paletteColor.green);
-			buf.pushU8Val(paletteColor.blue);
-		});
-
-		rawData = expandedRawData;
-	}
-
-	png_free_data(png_ptr, png_info_ptr, PNG_FREE_PLTE, 0);
 	png_destroy_read_struct(&png_ptr, &png_info_ptr, nullptr);
-	return (rawData);
 }
 
 BiometricEvaluation::Memory::uint8Array
@@ -0,0 +1,689 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#include <be_error_exception.h>
+#include <be_image_bmp.h>
+#include <be_image_image.h>
+#include <be_image_jpegl.h>
+#include <be_image_netpbm.h>
+#include <be_image_probe.h>
+#include <be_image_tiff.h>
+#include <be_image_wsq.h>
+#include <be_memory_indexedbuffer.h>
+
+namespace BE = BiometricEvaluation;
+
+namespace
+{
+	/** @return Attributes reported by an Image */
+	BE::Image::Attributes
+	attributesOf(
+	    const BE::Image::Image &image)
+	{
+		BE::Image::Attributes attributes;
+		attributes.compressionAlgorithm =
+		    image.getCompressionAlgorithm();
+		attributes.dimensions = image.getDimensions();
+		attributes.colorDepth = image.getColorDepth();
+		attributes.bitDepth = image.getBitDepth();
+		attributes.resolution = image.getResolution();
+		attributes.hasAlphaChannel = image.hasAlphaChannel();
+		return (attributes);
+	}
+
+	/**
+	 * @brief
+	 * Read the JPEG markers up to the first scan.
+	 * @details
+	 * Mirrors what libjpeg's jpeg_read_header() reports to
+	 * Image::JPEG: density from a JFIF APP0 segment (1x1 when
+	 * absent) and components from the start of frame.
+	 */
+	BE::Image::Attributes
+	probeJPEG(
+	    const BE::Memory::ByteSpan &data)
+	{
+		BE::Memory::IndexedBuffer ib(data.data(), data.size());
+		if (ib.scanBeU16Val() != 0xFFD8)
+			throw BE::Error::DataError("No JPEG SOI marker");
+
+		BE::Image::Attributes attributes;
+		attributes.compressionAlgorithm =
+		    BE::Image::CompressionAlgorithm::JPEGB;
+		attributes.bitDepth = 8;
+		attributes.resolution = {1, 1,
+		    BE::Image::Resolution::Units::PPI};
+
+		bool sawFrame{false};
+		for (;;) {
+			/* Markers may be preceded by any number of fills */
+			if (ib.scanU8Val() != 0xFF)
+				continue;
+			uint8_t marker = ib.scanU8Val();
+			while (marker == 0xFF)
+				marker = ib.scanU8Val();
+
+			/* Standalone markers */
+			if ((marker == 0x00) || (marker == 0x01) ||
+			    ((marker >= 0xD0) && (marker <= 0xD7)))
+				continue;
+			if ((marker == 0xDA) || (marker == 0xD9))
+				break;
+
+			const uint16_t length = ib.scanBeU16Val();
+			if (length < 2)
+				throw BE::Error::DataError("Invalid JPEG "
+				    "marker segment length");
+			const uint64_t next = ib.getIndex() + length - 2;
+
+			switch (marker) {
+			case 0xC0:	/* Baseline */
+				/* FALLTHROUGH */
+			case 0xC1:	/* Extended sequential */
+				/* FALLTHROUGH */
+			case 0xC2:	/* Progressive */
+				/* FALLTHROUGH */
+			case 0xC9:	/* Extended sequential, arithmetic */
+				/* FALLTHROUGH */
+			case 0xCA:	/* Progressive, arithmetic */
+				if (sawFrame)
+					throw BE::Error::DataError("Multiple "
+					    "JPEG SOF markers");
+				sawFrame = true;
+				(void)ib.scanU8Val();	/* Precision */
+				attributes.dimensions.ySize =
+				    ib.scanBeU16Val();
+				attributes.dimensions.xSize =
+				    ib.scanBeU16Val();
+				attributes.colorDepth = ib.scanU8Val() * 8;
+				break;
+			case 0xC3:	/* Lossless */
+				/* FALLTHROUGH */
+			case 0xC5:	/* Hierarchical */
+				/* FALLTHROUGH */
+			case 0xC6:
+				/* FALLTHROUGH */
+			case 0xC7:
+				/* FALLTHROUGH */
+			case 0xCB:
+				/* FALLTHROUGH */
+			case 0xCD:
+				/* FALLTHROUGH */
+			case 0xCE:
+				/* FALLTHROUGH */
+			case 0xCF:
+				throw BE::Error::DataError("Unsupported JPEG "
+				    "process");
+			case 0xE0: {	/* APP0 */
+				static const uint8_t JFIF[5] = {'J', 'F',
+				    'I', 'F', 0};
+				if (length < (2 + 14))
+					break;
+				uint8_t identifier[sizeof(JFIF)];
+				ib.scan(identifier, sizeof(identifier));
+				if (std::memcmp(identifier, JFIF,
+				    sizeof(JFIF)) != 0)
+					break;
+				ib.scan(nullptr, 3);	/* Version, units */
+				const uint16_t xDensity = ib.scanBeU16Val();
+				const uint16_t yDensity = ib.scanBeU16Val();
+				/* Image::JPEG ignores the density units */
+				attributes.resolution = {
+				    static_cast<double>(xDensity),
+				    static_cast<double>(yDensity),
+				    BE::Image::Resolution::Units::PPI};
+				break;
+			}
+			default:
+				break;
+			}
+			ib.setIndex(next);
+		}
+
+		if (!sawFrame)
+			throw BE::Error::DataError("No JPEG SOF marker before "
+			    "first scan");
+		return (attributes);
+	}
+
+	/**
+	 * @brief
+	 * Read the PNG chunks up to the image data.
+	 * @details
+	 * Mirrors what libpng's png_read_info() reports to Image::PNG.
+	 */
+	BE::Image::Attributes
+	probePNG(
+	    const BE::Memory::ByteSpan &data)
+	{
+		static const uint8_t Signature[8] = {0x89, 'P', 'N', 'G',
+		    0x0D, 0x0A, 0x1A, 0x0A};
+		BE::Memory::IndexedBuffer ib(data.data(), data.size());
+		uint8_t signature[sizeof(Signature)];
+		ib.scan(signature, sizeof(signature));
+		if (std::memcmp(signature, Signature, sizeof(Signature)) != 0)
+			throw BE::Error::DataError("No PNG signature");
+
+		BE::Image::Attributes attributes;
+		attributes.compressionAlgorithm =
+		    BE::Image::CompressionAlgorithm::PNG;
+		/* libpng's default when pHYs is absent */
+		attributes.resolution = {72, 72,
+		    BE::Image::Resolution::Units::PPI};
+
+		bool sawHeader{false}, sawPHYs{false};
+		for (;;) {
+			const uint32_t length = ib.scanBeU32Val();
+			char type[4];
+			ib.scan(type, sizeof(type));
+			const uint64_t next = ib.getIndex() +
+			    static_cast<uint64_t>(length) + 4;
+
+			if (std::memcmp(type, "IHDR", 4) == 0) {
+				if (sawHeader || (length != 13))
+					throw BE::Error::DataError("Invalid "
+					    "PNG IHDR chunk");
+				sawHeader = true;
+
+				attributes.dimensions.xSize =
+				    ib.scanBeU32Val();
+				attributes.dimensions.ySize =
+				    ib.scanBeU32Val();
+				const uint8_t bitDepth = ib.scanU8Val();
+				const uint8_t colorType = ib.scanU8Val();
+
+				uint8_t channels;
+				switch (colorType) {
+				case 0:		/* Grayscale */
+					/* FALLTHROUGH */
+				case 3:		/* Palette */
+					channels = 1;
+					break;
+				case 2:		/* RGB */
+					channels = 3;
+					break;
+				case 4:		/* Grayscale and alpha */
+					channels = 2;
+					break;
+				case 6:		/* RGBA */
+					channels = 4;
+					break;
+				default:
+					throw BE::Error::DataError("Invalid "
+					    "PNG color type");
+				}
+				if ((attributes.dimensions.xSize == 0) ||
+				    (attributes.dimensions.ySize == 0) ||
+				    ((bitDepth != 1) && (bitDepth != 2) &&
+				    (bitDepth != 4) && (bitDepth != 8) &&
+				    (bitDepth != 16)))
+					throw BE::Error::DataError("Invalid "
+					    "PNG IHDR chunk");
+
+				attributes.bitDepth = bitDepth;
+				attributes.colorDepth = bitDepth * channels;
+				attributes.hasAlphaChannel =
+				    ((colorType & 0x04) == 0x04);
+			} else if (!sawHeader) {
+				throw BE::Error::DataError("PNG IHDR chunk is "
+				    "not first");
+			} else if (std::memcmp(type, "pHYs", 4) == 0) {
+				/* libpng keeps the first of duplicates */
+				if ((length == 9) && !sawPHYs) {
+					sawPHYs = true;
+					const uint32_t x = ib.scanBeU32Val();
+					const uint32_t y = ib.scanBeU32Val();
+					if (ib.scanU8Val() == 1)  /* Meter */
+						attributes.resolution = {
+						    x / 100.0, y / 100.0,
+						    BE::Image::Resolution::
+						    Units::PPCM};
+					else
+						attributes.resolution = {0, 0,
+						    BE::Image::Resolution::
+						    Units::PPCM};
+				}
+			} else if ((std::memcmp(type, "IDAT", 4) == 0) ||
+			    (std::memcmp(type, "IEND", 4) == 0)) {
+				break;
+			}
+			ib.setIndex(next);
+		}
+
+		return (attributes);
+	}
+
+	/** Box of a JPEG2000 file */
+	struct JP2Box
+	{
+		/** Box type */
+		uint32_t type;
+		/** Offset of the box contents */
+		uint64_t offset;
+		/** Size of the box contents */
+		uint64_t size;
+	};
+
+	/**
+	 * @brief
+	 * Read the next JPEG2000 box header.
+	 *
+	 * @param[in] ib
+	 *	Buffer positioned at a box header, moved past it.
+	 * @param[in] end
+	 *	Offset just past the last byte of the enclosing box.
+	 *
+	 * @return
+	 *	Next box.
+	 */
+	JP2Box
+	scanJP2Box(
+	    BE::Memory::IndexedBuffer &ib,
+	    uint64_t end)
+	{
+		const uint64_t start = ib.getIndex();
+		uint64_t length = ib.scanBeU32Val();
+		JP2Box box;
+		box.type = ib.scanBeU32Val();
+		if (length == 1) {
+			length = (static_cast<uint64_t>(ib.scanBeU32Val()) <<
+			    32) | ib.scanBeU32Val();
+		} else if (length == 0) {
+			/* Box extends to the end */
+			length = end - start;
+		}
+
+		box.offset = ib.getIndex();
+		if ((length < (box.offset - start)) || ((start + length) > end))
+			throw BE::Error::DataError("Invalid JPEG2000 box "
+			    "length");
+		box.size = length - (box.offset - start);
+		return (box);
+	}
+
+	/**
+	 * @brief
+	 * Read the JPEG2000 header boxes and main codestream header.
+	 * @details
+	 * Mirrors what OpenJPEG's opj_read_header() and the box
+	 * searches of Image::JPEG2000 report.
+	 */
+	BE::Image::Attributes
+	probeJPEG2000(
+	    const BE::Memory::ByteSpan &data)
+	{
+		static const uint32_t JP2H = 0x6A703268;	/* jp2h */
+		static const uint32_t COLR = 0x636F6C72;	/* colr */
+		static const uint32_t RES = 0x72657320;		/* "res " */
+		static const uint32_t RESC = 0x72657363;	/* resc */
+		static const uint32_t CDEF = 0x63646566;	/* cdef */
+		static const uint32_t JP2C = 0x6A703263;	/* jp2c */
+
+		BE::Memory::IndexedBuffer ib(data.data(), data.size());
+		const uint64_t end = ib.getSize();
+
+		BE::Image::Attributes attributes;
+		attributes.compressionAlgorithm =
+		    BE::Image::CompressionAlgorithm::JP2;
+		/* The Capture Resolution Box is optional */
+		attributes.resolution = {72, 72,
+		    BE::Image::Resolution::Units::PPI};
+
+		uint32_t colorspace{0};
+		bool sawCDEF{false}, sawCodestream{false};
+		while (!sawCodestream && (ib.getIndex() < end)) {
+			const JP2Box box = scanJP2Box(ib, end);
+			if (box.type == JP2H) {
+				const uint64_t headerEnd = box.offset +
+				    box.size;
+				while (ib.getIndex() < headerEnd) {
+					const JP2Box child = scanJP2Box(ib,
+					    headerEnd);
+					if ((child.type == COLR) &&
+					    (colorspace == 0)) {
+						/* Enumerated colorspace */
+						if (ib.scanU8Val() == 1) {
+							ib.scan(nullptr, 2);
+							colorspace =
+							    ib.scanBeU32Val();
+						}
+					} else if (child.type == RES) {
+						const uint64_t resEnd =
+						    child.offset + child.size;
+						while (ib.getIndex() < resEnd) {
+							const JP2Box res =
+							    scanJP2Box(ib,
+							    resEnd);
+							if ((res.type != RESC) ||
+							    (res.size != 10)) {
+								ib.setIndex(
+								    res.offset +
+								    res.size);
+								continue;
+							}
+
+							/* I.7.3.6.1 */
+							const double vrN =
+							    ib.scanBeU16Val();
+							const double vrD =
+							    ib.scanBeU16Val();
+							const double hrN =
+							    ib.scanBeU16Val();
+							const double hrD =
+							    ib.scanBeU16Val();
+							const int8_t vrE =
+							    static_cast<int8_t>(
+							    ib.scanU8Val());
+							const int8_t hrE =
+							    static_cast<int8_t>(
+							    ib.scanU8Val());
+							/* Vertical first, as
+							 * Image::JPEG2000 */
+							attributes.resolution = {
+							    static_cast<float>(
+							    vrN / vrD) *
+							    std::pow(10.0,
+							    vrE) / 100.0,
+							    static_cast<float>(
+							    hrN / hrD) *
+							    std::pow(10.0,
+							    hrE) / 100.0,
+							    BE::Image::
+							    Resolution::Units::
+							    PPCM};
+						}
+					} else if (child.type == CDEF) {
+						sawCDEF = true;
+						const uint16_t count =
+						    ib.scanBeU16Val();
+						for (uint16_t c = 0; c < count;
+						    c++) {
+							(void)ib.scanBeU16Val();
+							if (ib.scanBeU16Val() ==
+							    1)
+								attributes.
+								    hasAlphaChannel =
+								    true;
+							(void)ib.scanBeU16Val();
+						}
+					}
+					ib.setIndex(child.offset + child.size);
+				}
+			} else if (box.type == JP2C) {
+				sawCodestream = true;
+
+				/* SOC, then SIZ */
+				if ((ib.scanBeU16Val() != 0xFF4F) ||
+				    (ib.scanBeU16Val() != 0xFF51))
+					throw BE::Error::DataError("No "
+					    "JPEG2000 SIZ marker");
+				ib.scan(nullptr, 4);	/* Lsiz, Rsiz */
+				attributes.dimensions.xSize =
+				    ib.scanBeU32Val();
+				attributes.dimensions.ySize =
+				    ib.scanBeU32Val();
+				ib.scan(nullptr, 24);	/* Offsets, tiles */
+				const uint16_t components = ib.scanBeU16Val();
+				if (components == 0)
+					throw BE::Error::NotImplemented("No "
+					    "components");
+
+				uint16_t precision{0};
+				for (uint16_t c = 0; c < components; c++) {
+					const uint16_t prec =
+					    (ib.scanU8Val() & 0x7F) + 1;
+					ib.scan(nullptr, 2);  /* Sampling */
+					if (c == 0)
+						precision = prec;
+					else if (prec != precision)
+						throw BE::Error::NotImplemented(
+						    "Non-equivalent component "
+						    "bit depths");
+				}
+				attributes.bitDepth = precision;
+				attributes.colorDepth = components * precision;
+
+				/* 16 is sRGB and 17 is grayscale */
+				if ((colorspace != 16) && (colorspace != 17))
+					throw BE::Error::NotImplemented(
+					    "Colorspace " +
+					    std::to_string(colorspace));
+				if (!sawCDEF)
+					attributes.hasAlphaChannel =
+					    ((colorspace == 17) &&
+					    (components == 2)) ||
+					    ((colorspace == 16) &&
+					    (components == 4));
+			} else {
+				ib.setIndex(box.offset + box.size);
+			}
+		}
+
+		if (!sawCodestream)
+			throw BE::Error::DataError("No JPEG2000 codestream");
+		return (attributes);
+	}
+
+	/** @return 16-bit TIFF value in the file's byte order */
+	uint16_t
+	scanTIFF16(
+	    BE::Memory::IndexedBuffer &ib,
+	    bool bigEndian)
+	{
+		const uint16_t first = ib.scanU8Val();
+		const uint16_t second = ib.scanU8Val();
+		return (bigEndian ? ((first << 8) | second) :
+		    ((second << 8) | first));
+	}
+
+	/** @return 32-bit TIFF value in the file's byte order */
+	uint32_t
+	scanTIFF32(
+	    BE::Memory::IndexedBuffer &ib,
+	    bool bigEndian)
+	{
+		const uint32_t first = scanTIFF16(ib, bigEndian);
+		const uint32_t second = scanTIFF16(ib, bigEndian);
+		return (bigEndian ? ((first << 16) | second) :
+		    ((second << 16) | first));
+	}
+
+	/**
+	 * @brief
+	 * Read the first image file directory of a TIFF.
+	 * @details
+	 * Mirrors what libtiff reports to Image::TIFF, including
+	 * its defaults for absent tags. BigTIFF files are parsed by
+	 * Image::TIFF.
+	 */
+	BE::Image::Attributes
+	probeTIFF(
+	    const BE::Memory::ByteSpan &data)
+	{
+		BE::Memory::IndexedBuffer ib(data.data(), data.size());
+		/* Byte order ("II" or "MM") was checked by isTIFF() */
+		const bool bigEndian = (ib.scanU8Val() == 'M');
+		(void)ib.scanU8Val();
+		const uint16_t version = scanTIFF16(ib, bigEndian);
+		if (version == 43)
+			return (attributesOf(BE::Image::TIFF(data)));
+		if (version != 42)
+			throw BE::Error::DataError("Invalid TIFF version");
+		ib.setIndex(scanTIFF32(ib, bigEndian));
+
+		bool sawWidth{false}, sawHeight{false};
+		uint32_t width{0}, height{0};
+		uint16_t bitsPerSample{1}, samplesPerPixel{1};
+		uint16_t photometric{0}, planarConfig{1}, resolutionUnit{2};
+		uint32_t extraSamples{0};
+		bool sawPhotometric{false};
+		double xRes{72}, yRes{72};
+
+		const uint16_t entries = scanTIFF16(ib, bigEndian);
+		for (uint16_t e = 0; e < entries; e++) {
+			const uint16_t tag = scanTIFF16(ib, bigEndian);
+			const uint16_t type = scanTIFF16(ib, bigEndian);
+			const uint32_t count = scanTIFF32(ib, bigEndian);
+			const uint64_t next = ib.getIndex() + 4;
+
+			/* SHORT or LONG values fit within the entry */
+			uint32_t value{0};
+			if (type == 3)
+				value = scanTIFF16(ib, bigEndian);
+			else if (type == 4)
+				value = scanTIFF32(ib, bigEndian);
+
+			switch (tag) {
+			case 256:	/* ImageWidth */
+				width = value;
+				sawWidth = true;
+				break;
+			case 257:	/* ImageLength */
+				height = value;
+				sawHeight = true;
+				break;
+			case 258:	/* BitsPerSample */
+				/* More than two values are at an offset */
+				if ((type == 3) && (count > 2)) {
+					ib.setIndex(next - 4);
+					ib.setIndex(scanTIFF32(ib, bigEndian));
+					value = scanTIFF16(ib, bigEndian);
+				}
+				bitsPerSample = value;
+				break;
+			case 262:	/* PhotometricInterpretation */
+				photometric = value;
+				sawPhotometric = true;
+				break;
+			case 277:	/* SamplesPerPixel */
+				samplesPerPixel = value;
+				break;
+			case 282:	/* XResolution */
+				/* FALLTHROUGH */
+			case 283: {	/* YResolution */
+				if (type != 5)	/* RATIONAL */
+					break;
+				ib.setIndex(next - 4);
+				ib.setIndex(scanTIFF32(ib, bigEndian));
+				const double numerator = scanTIFF32(ib,
+				    bigEndian);
+				const double denominator = scanTIFF32(ib,
+				    bigEndian);
+				/* libtiff reports resolution as a float */
+				const float res = static_cast<float>(
+				    denominator == 0 ? 0 :
+				    numerator / denominator);
+				if (tag == 282)
+					xRes = res;
+				else
+					yRes = res;
+				break;
+			}
+			case 284:	/* PlanarConfiguration */
+				planarConfig = value;
+				break;
+			case 296:	/* ResolutionUnit */
+				resolutionUnit = value;
+				break;
+			case 338:	/* ExtraSamples */
+				extraSamples = count;
+				break;
+			default:
+				break;
+			}
+			ib.setIndex(next);
+		}
+
+		/* libtiff guesses a missing PhotometricInterpretation */
+		if (!sawPhotometric)
+			photometric = (samplesPerPixel >= 3 ? 2 : 1);
+		if ((photometric != 1) && (photometric != 2))
+			throw BE::Error::NotImplemented("Unsupported TIFF "
+			    "colortype: " + std::to_string(photometric));
+		if (!sawWidth || !sawHeight)
+			throw BE::Error::DataError("No TIFF dimensions");
+
+		BE::Image::Attributes attributes;
+		attributes.compressionAlgorithm =
+		    BE::Image::CompressionAlgorithm::TIFF;
+		attributes.dimensions = {width, height};
+		attributes.bitDepth = bitsPerSample;
+		attributes.colorDepth = samplesPerPixel * bitsPerSample;
+		if ((samplesPerPixel != 1) && (samplesPerPixel != 3)) {
+			/* Image::TIFF treats one extra sample as alpha */
+			if (extraSamples != 1)
+				throw BE::Error::NotImplemented("Unusual color "
+				    "depth, and unsure what do to with extra "
+				    "samples");
+			attributes.hasAlphaChannel = true;
+		}
+		if (planarConfig != 1)
+			throw BE::Error::NotImplemented("TIFF images separated "
+			    "by component are not yet supported");
+
+		BE::Image::Resolution::Units units;
+		switch (resolutionUnit) {
+		case 2:
+			units = BE::Image::Resolution::Units::PPI;
+			break;
+		case 3:
+			units = BE::Image::Resolution::Units::PPCM;
+			break;
+		default:
+			units = BE::Image::Resolution::Units::NA;
+			break;
+		}
+		attributes.resolution = {xRes, yRes, units};
+
+		return (attributes);
+	}
+}
+
+BiometricEvaluation::Image::Attributes
+BiometricEvaluation::Image::probe(
+    const Memory::ByteSpan &data)
+{
+	const CompressionAlgorithm algorithm =
+	    Image::getCompressionAlgorithm(data.data(), data.size());
+	try {
+		switch (algorithm) {
+		case CompressionAlgorithm::JPEGB:
+			return (probeJPEG(data));
+		case CompressionAlgorithm::PNG:
+			return (probePNG(data));
+		case CompressionAlgorithm::JP2:
+			/* FALLTHROUGH */
+		case CompressionAlgorithm::JP2L:
+			return (probeJPEG2000(data));
+		case CompressionAlgorithm::TIFF:
+			return (probeTIFF(data));
+
+		/* Constructors of these read only headers, without copying */
+		case CompressionAlgorithm::JPEGL:
+			return (attributesOf(JPEGL(data)));
+		case CompressionAlgorithm::NetPBM:
+			return (attributesOf(NetPBM(data)));
+		case CompressionAlgorithm::WSQ20:
+			return (attributesOf(WSQ(data)));
+		case CompressionAlgorithm::BMP:
+			return (attributesOf(BMP(data)));
+		default:
+			throw Error::StrategyError("Could not determine "
+			    "compression algorithm");
+		}
+	} catch (const Error::ParameterError &e) {
+		/* Offsets in the headers past the end of data */
+		throw Error::DataError(e.whatString());
+	}
+}
@@ -57,6 +57,28 @@ BiometricEvaluation::Image::Raw::Raw(
 
 }
 
+BiometricEvaluation::Image::Raw::Raw(
+    const BiometricEvaluation::Memory::ByteSpan &data,
+    const Size dimensions,
+    const uint32_t colorDepth,
+    const uint16_t bitDepth,
+    const Resolution resolution,
+    const bool hasAlphaChannel,
+    const std::string &identifier,
+    const statusCallback_t &statusCallback) :
+    Image(data,
+    dimensions,
+    colorDepth,
+    bitDepth,
+    resolution,
+    CompressionAlgorithm::None,
+    hasAlphaChannel,
+    identifier,
+    statusCallback)
+{
+
+}
+
 BiometricEvaluation::Memory::uint8Array
 BiometricEvaluation::Image::Raw::getRawData()
     const
@@ -64,6 +86,31 @@ BiometricEvaluation::Image::Raw::getRawData()
 	return (this->getData());
 }
 
+void
+BiometricEvaluation::Image::Raw::decodeRawDataInto(
+    uint8_t *buffer,
+    uint64_t stride)
+    const
+{
+	/* Copy once, rather than through getRawData() */
+	this->copyRawDataInto(this->getDataPointer(), this->getDataSize(),
+	    buffer, stride);
+}
+
+void
+BiometricEvaluation::Image::Raw::decodeRawRows(
+    const rowCallback_t &callback,
+    uint32_t rowsPerChunk)
+    const
+{
+	/* Rows are passed straight from the data */
+	if (this->getDataSize() != this->requiredBufferSize())
+		throw Error::DataError("Raw data size does not match image "
+		    "dimensions");
+	this->passRows(this->getDataPointer(), 0, this->getDimensions().ySize,
+	    callback, rowsPerChunk);
+}
+
 BiometricEvaluation::Memory::uint8Array
 BiometricEvaluation::Image::Raw::getRawGrayscaleData(
     uint8_t depth)
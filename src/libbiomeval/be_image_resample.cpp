@@ -0,0 +1,818 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <vector>
+
+#include <be_error_exception.h>
+#include <be_image_resample.h>
+
+namespace BE = BiometricEvaluation;
+
+const std::map<BiometricEvaluation::Image::ResampleFilter, std::string>
+BE_Image_ResampleFilter_EnumToStringMap = {
+	{BiometricEvaluation::Image::ResampleFilter::Box, "Box"},
+	{BiometricEvaluation::Image::ResampleFilter::Bilinear, "Bilinear"},
+	{BiometricEvaluation::Image::ResampleFilter::Lanczos, "Lanczos"}
+};
+BE_FRAMEWORK_ENUMERATION_DEFINITIONS(
+    BiometricEvaluation::Image::ResampleFilter,
+    BE_Image_ResampleFilter_EnumToStringMap);
+
+/*
+ * Resampling is separable: each row is first filtered horizontally
+ * into single precision samples, then each output row is filtered
+ * vertically from those. Filter weights are computed once per axis.
+ *
+ * As with pixel conversion, every kernel implementation performs the
+ * same single precision operations in the same order, so results do
+ * not depend on the instruction set used. The SIMD kernels return the
+ * index of the first sample they did not compute, and the remaining
+ * samples are computed by the next narrower implementation.
+ */
+
+namespace
+{
+	/** Weights of the source samples contributing to each output */
+	struct Axis
+	{
+		/** Source samples contributing to each output sample */
+		uint32_t taps{};
+		/** Index of the first contributing source sample */
+		std::vector<int32_t> first{};
+		/** taps weights for each output sample, in order */
+		std::vector<float> weights{};
+	};
+
+	/** Fewest multiply-adds worth starting a thread for */
+	const uint64_t MinimumWorkPerThread = 1 << 20;
+
+	const double Pi = 3.14159265358979323846;
+}
+
+static inline uint16_t
+load16(
+    const uint8_t *p)
+{
+	uint16_t value;
+	std::memcpy(&value, p, sizeof(value));
+	return (value);
+}
+
+static inline void
+store16(
+    uint8_t *p,
+    uint16_t value)
+{
+	std::memcpy(p, &value, sizeof(value));
+}
+
+/*
+ * Filters, as functions of the distance from the output sample in
+ * source samples, scaled when downsampling.
+ */
+
+static double
+getFilterRadius(
+    BE::Image::ResampleFilter filter)
+{
+	switch (filter) {
+	case BE::Image::ResampleFilter::Box:
+		return (0.5);
+	case BE::Image::ResampleFilter::Bilinear:
+		return (1.0);
+	case BE::Image::ResampleFilter::Lanczos:
+		return (3.0);
+	}
+	throw BE::Error::ParameterError("Invalid filter");
+}
+
+static double
+applyFilter(
+    BE::Image::ResampleFilter filter,
+    double x)
+{
+	switch (filter) {
+	case BE::Image::ResampleFilter::Box:
+		return (((x >= -0.5) && (x < 0.5)) ? 1.0 : 0.0);
+	case BE::Image::ResampleFilter::Bilinear:
+		x = std::abs(x);
+		return ((x < 1.0) ? 1.0 - x : 0.0);
+	case BE::Image::ResampleFilter::Lanczos: {
+		if (x == 0.0)
+			return (1.0);
+		if (std::abs(x) >= 3.0)
+			return (0.0);
+		const double pix = Pi * x;
+		return ((3.0 * std::sin(pix) * std::sin(pix / 3.0)) /
+		    (pix * pix));
+	}
+	}
+	throw BE::Error::ParameterError("Invalid filter");
+}
+
+/** @return Weights resampling inSize samples to outSize samples */
+static Axis
+computeAxis(
+    uint32_t inSize,
+    uint32_t outSize,
+    BE::Image::ResampleFilter filter)
+{
+	Axis axis;
+	axis.first.resize(outSize);
+
+	/* Unscaled axes are copied, whatever the filter */
+	if (inSize == outSize) {
+		axis.taps = 1;
+		axis.weights.assign(outSize, 1.0f);
+		for (uint32_t i = 0; i < outSize; i++)
+			axis.first[i] = static_cast<int32_t>(i);
+		return (axis);
+	}
+
+	/* Widen the filter when downsampling so every source counts */
+	const double scale = static_cast<double>(inSize) / outSize;
+	const double filterScale = std::max(1.0, scale);
+	const double support = getFilterRadius(filter) * filterScale;
+	axis.taps = std::min<uint32_t>(inSize,
+	    static_cast<uint32_t>(std::ceil(support * 2)) + 1);
+	axis.weights.assign(static_cast<uint64_t>(outSize) * axis.taps, 0);
+
+	std::vector<double> weights;
+	for (uint32_t i = 0; i < outSize; i++) {
+		/* Centers of samples are at half-integer coordinates */
+		const double center = (i + 0.5) * scale;
+		const int64_t lo = std::max<int64_t>(0,
+		    static_cast<int64_t>(std::floor(center - support)));
+		const int64_t hi = std::min<int64_t>(inSize - 1,
+		    static_cast<int64_t>(std::ceil(center + support)));
+
+		weights.clear();
+		int64_t first = -1, last = -1;
+		double sum = 0;
+		for (int64_t j = lo; j <= hi; j++) {
+			const double weight = applyFilter(filter,
+			    ((j + 0.5) - center) / filterScale);
+			if (weight == 0)
+				continue;
+			if (first == -1)
+				first = j;
+			weights.resize(j - first + 1, 0);
+			weights.back() = weight;
+			last = j;
+			sum += weight;
+		}
+		if ((first == -1) || (sum == 0)) {
+			/* Nearest source sample */
+			first = last = std::min<int64_t>(inSize - 1,
+			    static_cast<int64_t>(center));
+			weights.assign(1, 1.0);
+			sum = 1.0;
+		}
+		if ((last - first + 1) > axis.taps)
+			throw BE::Error::StrategyError("Too many filter taps");
+
+		/* Contributing samples must all be within the source */
+		const int64_t start = std::min<int64_t>(first,
+		    inSize - axis.taps);
+		axis.first[i] = static_cast<int32_t>(start);
+		float *w = axis.weights.data() +
+		    (static_cast<uint64_t>(i) * axis.taps);
+		for (uint64_t k = 0; k < weights.size(); k++)
+			w[(first - start) + k] = static_cast<float>(
+			    weights[k] / sum);
+	}
+
+	return (axis);
+}
+
+/*
+ * Portable implementations.
+ */
+
+static void
+toFloatPortable(
+    const uint8_t *in,
+    uint16_t depth,
+    uint64_t first,
+    uint64_t count,
+    float *out)
+{
+	if (depth == 16)
+		for (uint64_t i = first; i < count; i++)
+			out[i] = load16(in + (i * 2));
+	else
+		for (uint64_t i = first; i < count; i++)
+			out[i] = in[i];
+}
+
+/*
+ * out[i] is the sum over t of weights[(t * count) + i] *
+ * in[offsets[i] + (t * stride)].
+ */
+static void
+convolveRowPortable(
+    const float *in,
+    const int32_t *offsets,
+    const float *weights,
+    uint32_t taps,
+    uint32_t stride,
+    uint64_t first,
+    uint64_t count,
+    float *out)
+{
+	for (uint64_t i = first; i < count; i++) {
+		float sum = 0;
+		for (uint32_t t = 0; t < taps; t++)
+			sum += weights[(t * count) + i] *
+			    in[offsets[i] + (t * stride)];
+		out[i] = sum;
+	}
+}
+
+/*
+ * out[i] is the sum over t of weights[t] * rows[t][i], rounded and
+ * clamped to depth bits.
+ */
+static void
+convolveColumnsPortable(
+    const float * const *rows,
+    const float *weights,
+    uint32_t taps,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out,
+    uint16_t depth)
+{
+	const float maximum = (depth == 16) ? 65535.0f : 255.0f;
+	for (uint64_t i = first; i < count; i++) {
+		float sum = 0;
+		for (uint32_t t = 0; t < taps; t++)
+			sum += weights[t] * rows[t][i];
+		const uint32_t value = static_cast<uint32_t>(
+		    std::min(std::max(sum, 0.0f), maximum) + 0.5f);
+		if (depth == 16)
+			store16(out + (i * 2), static_cast<uint16_t>(value));
+		else
+			out[i] = static_cast<uint8_t>(value);
+	}
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#ifdef _MSC_VER
+#define TARGET_SSE41
+#define TARGET_AVX2
+#else
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+/*
+ * SSE4.1 implementations, computing four samples at a time.
+ */
+
+TARGET_SSE41
+static uint64_t
+toFloatSSE41(
+    const uint8_t *in,
+    uint16_t depth,
+    uint64_t first,
+    uint64_t count,
+    float *out)
+{
+	uint64_t i = first;
+	for (; (i + 4) <= count; i += 4) {
+		__m128i v;
+		if (depth == 16) {
+			v = _mm_cvtepu16_epi32(_mm_loadl_epi64(
+			    reinterpret_cast<const __m128i *>(in + (i * 2))));
+		} else {
+			int32_t bytes;
+			std::memcpy(&bytes, in + i, sizeof(bytes));
+			v = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(bytes));
+		}
+		_mm_storeu_ps(out + i, _mm_cvtepi32_ps(v));
+	}
+	return (i);
+}
+
+TARGET_SSE41
+static uint64_t
+convolveRowSSE41(
+    const float *in,
+    const int32_t *offsets,
+    const float *weights,
+    uint32_t taps,
+    uint32_t stride,
+    uint64_t first,
+    uint64_t count,
+    float *out)
+{
+	uint64_t i = first;
+	for (; (i + 4) <= count; i += 4) {
+		const int32_t *o = offsets + i;
+		__m128 sum = _mm_setzero_ps();
+		for (uint32_t t = 0; t < taps; t++) {
+			const float *p = in + (t * stride);
+			sum = _mm_add_ps(sum, _mm_mul_ps(
+			    _mm_loadu_ps(weights + (t * count) + i),
+			    _mm_setr_ps(p[o[0]], p[o[1]], p[o[2]], p[o[3]])));
+		}
+		_mm_storeu_ps(out + i, sum);
+	}
+	return (i);
+}
+
+/* Store four rounded samples of depth bits */
+TARGET_SSE41
+static inline void
+storeSamplesx4(
+    uint8_t *out,
+    __m128 sum,
+    uint16_t depth)
+{
+	const __m128 maximum = _mm_set1_ps((depth == 16) ? 65535.0f : 255.0f);
+	const __m128i v = _mm_cvttps_epi32(_mm_add_ps(_mm_min_ps(
+	    _mm_max_ps(sum, _mm_setzero_ps()), maximum), _mm_set1_ps(0.5f)));
+	const __m128i words = _mm_packus_epi32(v, v);
+	if (depth == 16) {
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(out), words);
+	} else {
+		const int32_t packed = _mm_cvtsi128_si32(
+		    _mm_packus_epi16(words, words));
+		std::memcpy(out, &packed, sizeof(packed));
+	}
+}
+
+TARGET_SSE41
+static uint64_t
+convolveColumnsSSE41(
+    const float * const *rows,
+    const float *weights,
+    uint32_t taps,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out,
+    uint16_t depth)
+{
+	const uint8_t sampleSize = depth / 8;
+	uint64_t i = first;
+	for (; (i + 4) <= count; i += 4) {
+		__m128 sum = _mm_setzero_ps();
+		for (uint32_t t = 0; t < taps; t++)
+			sum = _mm_add_ps(sum, _mm_mul_ps(
+			    _mm_set1_ps(weights[t]),
+			    _mm_loadu_ps(rows[t] + i)));
+		storeSamplesx4(out + (i * sampleSize), sum, depth);
+	}
+	return (i);
+}
+
+/*
+ * AVX2 implementations, computing eight samples at a time.
+ */
+
+TARGET_AVX2
+static uint64_t
+toFloatAVX2(
+    const uint8_t *in,
+    uint16_t depth,
+    uint64_t first,
+    uint64_t count,
+    float *out)
+{
+	uint64_t i = first;
+	for (; (i + 8) <= count; i += 8) {
+		__m256i v;
+		if (depth == 16)
+			v = _mm256_cvtepu16_epi32(_mm_loadu_si128(
+			    reinterpret_cast<const __m128i *>(in + (i * 2))));
+		else
+			v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(
+			    reinterpret_cast<const __m128i *>(in + i)));
+		_mm256_storeu_ps(out + i, _mm256_cvtepi32_ps(v));
+	}
+	return (i);
+}
+
+TARGET_AVX2
+static uint64_t
+convolveRowAVX2(
+    const float *in,
+    const int32_t *offsets,
+    const float *weights,
+    uint32_t taps,
+    uint32_t stride,
+    uint64_t first,
+    uint64_t count,
+    float *out)
+{
+	uint64_t i = first;
+	for (; (i + 8) <= count; i += 8) {
+		const __m256i o = _mm256_loadu_si256(
+		    reinterpret_cast<const __m256i *>(offsets + i));
+		__m256 sum = _mm256_setzero_ps();
+		for (uint32_t t = 0; t < taps; t++)
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(
+			    _mm256_loadu_ps(weights + (t * count) + i),
+			    _mm256_i32gather_ps(in + (t * stride), o, 4)));
+		_mm256_storeu_ps(out + i, sum);
+	}
+	return (i);
+}
+
+TARGET_AVX2
+static uint64_t
+convolveColumnsAVX2(
+    const float * const *rows,
+    const float *weights,
+    uint32_t taps,
+    uint64_t first,
+    uint64_t count,
+    uint8_t *out,
+    uint16_t depth)
+{
+	const uint8_t sampleSize = depth / 8;
+	uint64_t i = first;
+	for (; (i + 8) <= count; i += 8) {
+		__m256 sum = _mm256_setzero_ps();
+		for (uint32_t t = 0; t < taps; t++)
+			sum = _mm256_add_ps(sum, _mm256_mul_ps(
+			    _mm256_set1_ps(weights[t]),
+			    _mm256_loadu_ps(rows[t] + i)));
+		storeSamplesx4(out + (i * sampleSize),
+		    _mm256_castps256_ps128(sum), depth);
+		storeSamplesx4(out + ((i + 4) * sampleSize),
+		    _mm256_extractf128_ps(sum, 1), depth);
+	}
+	return (i);
+}
+
+namespace
+{
+	/** Widest instruction set usable by this processor */
+	enum class InstructionSet
+	{
+		Portable,
+		SSE41,
+		AVX2
+	};
+}
+
+static InstructionSet
+detectInstructionSet()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	const bool sse41 = ((info[2] & (1 << 19)) != 0);
+	const bool osAVX = ((info[2] & (1 << 27)) != 0) &&
+	    ((info[2] & (1 << 28)) != 0) && ((_xgetbv(0) & 0x6) == 0x6);
+	__cpuidex(info, 7, 0);
+	if (osAVX && ((info[1] & (1 << 5)) != 0))
+		return (InstructionSet::AVX2);
+	if (sse41)
+		return (InstructionSet::SSE41);
+#else
+	if (__builtin_cpu_supports("avx2"))
+		return (InstructionSet::AVX2);
+	if (__builtin_cpu_supports("sse4.1"))
+		return (InstructionSet::SSE41);
+#endif
+	return (InstructionSet::Portable);
+}
+
+static InstructionSet
+getInstructionSet()
+{
+	static const InstructionSet instructionSet = detectInstructionSet();
+	return (instructionSet);
+}
+
+#endif /* x86-64 */
+
+/*
+ * Kernels, dispatched to the widest implementation available.
+ */
+
+static void
+toFloat(
+    const uint8_t *in,
+    uint16_t depth,
+    uint64_t count,
+    float *out)
+{
+	uint64_t i = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+	switch (getInstructionSet()) {
+	case InstructionSet::AVX2:
+		i = toFloatAVX2(in, depth, i, count, out);
+		/* FALLTHROUGH */
+	case InstructionSet::SSE41:
+		i = toFloatSSE41(in, depth, i, count, out);
+		/* FALLTHROUGH */
+	case InstructionSet::Portable:
+		break;
+	}
+#endif
+	toFloatPortable(in, depth, i, count, out);
+}
+
+static void
+convolveRow(
+    const float *in,
+    const int32_t *offsets,
+    const float *weights,
+    uint32_t taps,
+    uint32_t stride,
+    uint64_t count,
+    float *out)
+{
+	uint64_t i = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+	switch (getInstructionSet()) {
+	case InstructionSet::AVX2:
+		i = convolveRowAVX2(in, offsets, weights, taps, stride, i,
+		    count, out);
+		/* FALLTHROUGH */
+	case InstructionSet::SSE41:
+		i = convolveRowSSE41(in, offsets, weights, taps, stride, i,
+		    count, out);
+		/* FALLTHROUGH */
+	case InstructionSet::Portable:
+		break;
+	}
+#endif
+	convolveRowPortable(in, offsets, weights, taps, stride, i, count,
+	    out);
+}
+
+static void
+convolveColumns(
+    const float * const *rows,
+    const float *weights,
+    uint32_t taps,
+    uint64_t count,
+    uint8_t *out,
+    uint16_t depth)
+{
+	uint64_t i = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+	switch (getInstructionSet()) {
+	case InstructionSet::AVX2:
+		i = convolveColumnsAVX2(rows, weights, taps, i, count, out,
+		    depth);
+		/* FALLTHROUGH */
+	case InstructionSet::SSE41:
+		i = convolveColumnsSSE41(rows, weights, taps, i, count, out,
+		    depth);
+		/* FALLTHROUGH */
+	case InstructionSet::Portable:
+		break;
+	}
+#endif
+	convolveColumnsPortable(rows, weights, taps, i, count, out, depth);
+}
+
+/**
+ * @return Number of threads to use for rows rows of workPerRow
+ * multiply-adds each.
+ */
+static uint32_t
+getThreadCount(
+    uint32_t requested,
+    uint32_t rows,
+    uint64_t workPerRow)
+{
+	/* 0 requests one thread per core, but never more than useful */
+	if (requested == 0)
+		requested = std::thread::hardware_concurrency();
+	const uint64_t useful = (static_cast<uint64_t>(rows) * workPerRow) /
+	    MinimumWorkPerThread;
+	return (static_cast<uint32_t>(std::max<uint64_t>(1,
+	    std::min<uint64_t>({requested, useful, rows}))));
+}
+
+/**
+ * Call body with consecutive ranges of [0, rows), each on its own
+ * thread, rethrowing the first exception thrown.
+ */
+static void
+forEachRowRange(
+    uint32_t rows,
+    uint32_t threads,
+    const std::function<void(uint32_t begin, uint32_t end)> &body)
+{
+	if (threads <= 1) {
+		body(0, rows);
+		return;
+	}
+
+	std::vector<std::exception_ptr> errors(threads);
+	const auto run = [&](uint32_t thread) {
+		try {
+			body(static_cast<uint32_t>(
+			    (static_cast<uint64_t>(rows) * thread) / threads),
+			    static_cast<uint32_t>((static_cast<uint64_t>(rows) *
+			    (thread + 1)) / threads));
+		} catch (...) {
+			errors[thread] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> pool;
+	try {
+		for (uint32_t thread = 1; thread < threads; thread++)
+			pool.emplace_back(run, thread);
+	} catch (...) {
+		/* Threads already started reference run and errors */
+		for (auto &thread : pool)
+			thread.join();
+		throw;
+	}
+	run(0);
+	for (auto &thread : pool)
+		thread.join();
+
+	for (const auto &error : errors)
+		if (error)
+			std::rethrow_exception(error);
+}
+
+/** @return res in pixels per centimeter, or throw ParameterError */
+static BE::Image::Resolution
+toPPCM(
+    const BE::Image::Resolution &res)
+{
+	if (res.units == BE::Image::Resolution::Units::NA)
+		throw BE::Error::ParameterError("Resolution units are unknown");
+	if (!(res.xRes > 0) || !(res.yRes > 0))
+		throw BE::Error::ParameterError("Resolution is not positive");
+	return (res.toUnits(BE::Image::Resolution::Units::PPCM));
+}
+
+/** @return Samples along an axis of size samples, scaled */
+static uint32_t
+scaleLength(
+    uint32_t size,
+    double from,
+    double to)
+{
+	const double length = std::round(size * (to / from));
+	if (length > std::numeric_limits<uint32_t>::max())
+		throw BE::Error::ParameterError("Resampled image is too large");
+	return (std::max<uint32_t>(1, static_cast<uint32_t>(length)));
+}
+
+BiometricEvaluation::Image::Size
+BiometricEvaluation::Image::getResampledSize(
+    const Size &size,
+    const Resolution &from,
+    const Resolution &to)
+{
+	const Resolution fromRes = toPPCM(from);
+	const Resolution toRes = toPPCM(to);
+	return (Size(scaleLength(size.xSize, fromRes.xRes, toRes.xRes),
+	    scaleLength(size.ySize, fromRes.yRes, toRes.yRes)));
+}
+
+BiometricEvaluation::Memory::uint8Array
+BiometricEvaluation::Image::resample(
+    const uint8_t *rawData,
+    const uint64_t rawDataSize,
+    const Size &size,
+    const uint32_t colorDepth,
+    const uint16_t bitDepth,
+    const Resolution &from,
+    const Resolution &to,
+    const ResampleFilter filter,
+    const uint32_t threads)
+{
+	if ((bitDepth != 8) && (bitDepth != 16))
+		throw Error::NotImplemented("Resampling " +
+		    std::to_string(bitDepth) + "-bit components");
+	if ((colorDepth == 0) || ((colorDepth % bitDepth) != 0))
+		throw Error::ParameterError("Color depth is not a multiple "
+		    "of bit depth");
+	const uint32_t components = colorDepth / bitDepth;
+	const uint8_t sampleSize = bitDepth / 8;
+	const uint64_t inRowLength = static_cast<uint64_t>(size.xSize) *
+	    components;
+	if ((size.xSize == 0) || (size.ySize == 0) ||
+	    (rawDataSize < (inRowLength * sampleSize * size.ySize)))
+		throw Error::ParameterError("Raw data is too small");
+	if (inRowLength > std::numeric_limits<int32_t>::max())
+		throw Error::ParameterError("Image is too wide to resample");
+
+	const Size outSize = getResampledSize(size, from, to);
+	const uint64_t outRowLength = static_cast<uint64_t>(outSize.xSize) *
+	    components;
+	Memory::uint8Array output(outRowLength * sampleSize * outSize.ySize);
+	if ((outSize.xSize == size.xSize) && (outSize.ySize == size.ySize)) {
+		std::memcpy(output, rawData, output.size());
+		return (output);
+	}
+
+	const Axis horizontal = computeAxis(size.xSize, outSize.xSize, filter);
+	const Axis vertical = computeAxis(size.ySize, outSize.ySize, filter);
+
+	/*
+	 * Lay out horizontal weights by tap, one per output sample, so
+	 * that kernels load consecutive weights for consecutive samples.
+	 */
+	std::vector<int32_t> offsets(outRowLength);
+	std::vector<float> weights(outRowLength * horizontal.taps);
+	for (uint64_t i = 0; i < outRowLength; i++) {
+		const uint64_t x = i / components;
+		offsets[i] = static_cast<int32_t>((horizontal.first[x] *
+		    components) + (i % components));
+		for (uint32_t t = 0; t < horizontal.taps; t++)
+			weights[(t * outRowLength) + i] = horizontal.weights[
+			    (x * horizontal.taps) + t];
+	}
+
+	/* Only source rows contributing to some output are filtered */
+	const uint32_t firstRow = static_cast<uint32_t>(vertical.first.front());
+	const uint32_t lastRow = static_cast<uint32_t>(vertical.first.back()) +
+	    vertical.taps;
+	std::vector<float> filtered(static_cast<uint64_t>(lastRow -
+	    firstRow) * outRowLength);
+	const uint64_t inRowSize = inRowLength * sampleSize;
+	const uint32_t filteredRows = lastRow - firstRow;
+	forEachRowRange(filteredRows, getThreadCount(threads, filteredRows,
+	    outRowLength * horizontal.taps), [&](uint32_t begin, uint32_t end) {
+		std::vector<float> row(inRowLength);
+		for (uint32_t r = begin; r < end; r++) {
+			toFloat(rawData + ((firstRow + r) * inRowSize),
+			    bitDepth, inRowLength, row.data());
+			convolveRow(row.data(), offsets.data(), weights.data(),
+			    horizontal.taps, components, outRowLength,
+			    filtered.data() + (r * outRowLength));
+		}
+	});
+
+	const uint64_t outRowSize = outRowLength * sampleSize;
+	forEachRowRange(outSize.ySize, getThreadCount(threads, outSize.ySize,
+	    outRowLength * vertical.taps), [&](uint32_t begin, uint32_t end) {
+		std::vector<const float *> rows(vertical.taps);
+		for (uint32_t y = begin; y < end; y++) {
+			for (uint32_t t = 0; t < vertical.taps; t++)
+				rows[t] = filtered.data() + ((vertical.first[y]
+				    - firstRow + t) * outRowLength);
+			convolveColumns(rows.data(), vertical.weights.data() +
+			    (static_cast<uint64_t>(y) * vertical.taps),
+			    vertical.taps, outRowLength, output + (y *
+			    outRowSize), bitDepth);
+		}
+	});
+
+	return (output);
+}
+
+BiometricEvaluation::Image::Raw
+BiometricEvaluation::Image::resample(
+    const Image &image,
+    const Resolution &from,
+    const Resolution &to,
+    const ResampleFilter filter,
+    const uint32_t threads)
+{
+	const Memory::ByteSpan rawData = image.getRawDataSpan();
+	return (Raw(Memory::ByteSpan::share(resample(rawData.data(),
+	    rawData.size(), image.getDimensions(), image.getColorDepth(),
+	    image.getBitDepth(), from, to, filter, threads)),
+	    getResampledSize(image.getDimensions(), from, to),
+	    image.getColorDepth(), image.getBitDepth(), to,
+	    image.hasAlphaChannel()));
+}
+
+BiometricEvaluation::Image::Raw
+BiometricEvaluation::Image::resample(
+    const Image &image,
+    const Resolution &to,
+    const ResampleFilter filter,
+    const uint32_t threads)
+{
+	return (resample(image, image.getResolution(), to, filter, threads));
+}
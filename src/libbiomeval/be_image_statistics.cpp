@@ -0,0 +1,686 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string>
+
+#include <be_error_exception.h>
+#include <be_image_statistics.h>
+#include <be_memory_autoarray.h>
+
+#include "be_image_pixelconversion_impl.h"
+
+namespace BE = BiometricEvaluation;
+
+/*
+ * Statistics are accumulated a row at a time. Each row is counted into
+ * a histogram, from which the global statistics are derived, and when
+ * a block variance map is requested, each row's samples and squared
+ * samples are added to per-column sums. At the end of each row of
+ * blocks, the column sums are folded into the sums of each block.
+ *
+ * Scattered histogram increments cannot be vectorized, so 8-bit rows
+ * are counted into four interleaved histograms to avoid stalls on
+ * repeated values. Column sums are vertical, so they vectorize for any
+ * block size, and are integers, so their SIMD implementations produce
+ * results identical to the portable one.
+ */
+
+namespace
+{
+	/** Rows requested from Image::decodeRows() at a time */
+	const uint32_t RowsPerChunk = 64;
+
+	/**
+	 * Rows that may be added to 32-bit column sums before they
+	 * could overflow (255 * 255 * 65536 and 65535 * 65536 < 2^32).
+	 */
+	const uint32_t MaximumColumnRows = 65536;
+
+	/** Statistics of rows added in order */
+	class Accumulator
+	{
+	public:
+		Accumulator(
+		    const BE::Image::Size &size,
+		    uint8_t depth,
+		    const BE::Image::StatisticsOptions &options);
+
+		/**
+		 * Add rowCount rows of gray samples, following the
+		 * rows already added.
+		 */
+		void
+		addRows(
+		    const uint8_t *rows,
+		    uint32_t rowCount);
+
+		/** @return Statistics of all rows added */
+		BE::Image::Statistics
+		finish();
+
+	private:
+		/** Count a row's samples into the histograms */
+		void
+		countRow(
+		    const uint8_t *row);
+
+		/** Add the column sums to the sums of their blocks */
+		void
+		foldColumns();
+
+		/** Append the variance of blocks of the current row */
+		void
+		finishBlockRow(
+		    uint32_t rows);
+
+		const BE::Image::Size _size;
+		const uint8_t _depth;
+		const BE::Image::StatisticsOptions _options;
+		/** Number of histograms interleaved by sample */
+		const uint8_t _histogramCount;
+		/** _histogramCount consecutive histograms */
+		std::vector<uint64_t> _histograms;
+		/** Rows added so far */
+		uint32_t _row{0};
+		/** Rows added to the column sums since they were folded */
+		uint32_t _columnRows{0};
+		/** Sum of samples of each column */
+		std::vector<uint32_t> _columnSums{};
+		/** Sum of squared samples of each column, 8-bit samples */
+		std::vector<uint32_t> _columnSquares{};
+		/** Sum of squared samples of each column, 16-bit samples */
+		std::vector<uint64_t> _columnWideSquares{};
+		/** Sum of samples of each block of this row of blocks */
+		std::vector<uint64_t> _blockSums{};
+		/** Sum of squared samples of each block */
+		std::vector<uint64_t> _blockSquares{};
+		/** Variance of each finished block */
+		std::vector<float> _blockVariance{};
+	};
+}
+
+static inline uint16_t
+load16(
+    const uint8_t *p)
+{
+	uint16_t value;
+	std::memcpy(&value, p, sizeof(value));
+	return (value);
+}
+
+/** @return Number of bins in a histogram of depth-bit samples */
+static uint64_t
+getHistogramSize(
+    uint8_t depth)
+{
+	if ((depth != 8) && (depth != 16))
+		throw BE::Error::ParameterError("Invalid value for bit depth");
+	return (uint64_t(1) << depth);
+}
+
+/*
+ * Portable implementation.
+ */
+
+/* Add 8-bit samples [first, count) of a row to their column sums */
+static void
+addColumns8Portable(
+    const uint8_t *in,
+    uint64_t first,
+    uint64_t count,
+    uint32_t *sums,
+    uint32_t *squares)
+{
+	for (uint64_t i = first; i < count; i++) {
+		sums[i] += in[i];
+		squares[i] += static_cast<uint32_t>(in[i]) * in[i];
+	}
+}
+
+/* Add 16-bit samples [first, count) of a row to their column sums */
+static void
+addColumns16Portable(
+    const uint8_t *in,
+    uint64_t first,
+    uint64_t count,
+    uint32_t *sums,
+    uint64_t *squares)
+{
+	for (uint64_t i = first; i < count; i++) {
+		const uint64_t value = load16(in + (i * 2));
+		sums[i] += static_cast<uint32_t>(value);
+		squares[i] += value * value;
+	}
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#ifdef _MSC_VER
+#define TARGET_SSE41
+#define TARGET_AVX2
+#else
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+/*
+ * SSE4.1 implementation, adding 8 samples at a time.
+ */
+
+TARGET_SSE41
+static uint64_t
+addColumns8SSE41(
+    const uint8_t *in,
+    uint64_t first,
+    uint64_t count,
+    uint32_t *sums,
+    uint32_t *squares)
+{
+	uint64_t i = first;
+	for (; (i + 8) <= count; i += 8) {
+		/* 255 * 255 fits in 16 bits */
+		const __m128i v = _mm_cvtepu8_epi16(_mm_loadl_epi64(
+		    reinterpret_cast<const __m128i *>(in + i)));
+		const __m128i v2 = _mm_mullo_epi16(v, v);
+		const __m128i zero = _mm_setzero_si128();
+
+		__m128i *s = reinterpret_cast<__m128i *>(sums + i);
+		_mm_storeu_si128(s, _mm_add_epi32(_mm_loadu_si128(s),
+		    _mm_unpacklo_epi16(v, zero)));
+		_mm_storeu_si128(s + 1, _mm_add_epi32(_mm_loadu_si128(s + 1),
+		    _mm_unpackhi_epi16(v, zero)));
+
+		__m128i *q = reinterpret_cast<__m128i *>(squares + i);
+		_mm_storeu_si128(q, _mm_add_epi32(_mm_loadu_si128(q),
+		    _mm_unpacklo_epi16(v2, zero)));
+		_mm_storeu_si128(q + 1, _mm_add_epi32(_mm_loadu_si128(q + 1),
+		    _mm_unpackhi_epi16(v2, zero)));
+	}
+	return (i);
+}
+
+TARGET_SSE41
+static uint64_t
+addColumns16SSE41(
+    const uint8_t *in,
+    uint64_t first,
+    uint64_t count,
+    uint32_t *sums,
+    uint64_t *squares)
+{
+	uint64_t i = first;
+	for (; (i + 4) <= count; i += 4) {
+		const __m128i v = _mm_cvtepu16_epi32(_mm_loadl_epi64(
+		    reinterpret_cast<const __m128i *>(in + (i * 2))));
+		__m128i *s = reinterpret_cast<__m128i *>(sums + i);
+		_mm_storeu_si128(s, _mm_add_epi32(_mm_loadu_si128(s), v));
+
+		/* Squares of samples 0 and 2, and 1 and 3 */
+		const __m128i even = _mm_mul_epu32(v, v);
+		const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(v, 32),
+		    _mm_srli_epi64(v, 32));
+		__m128i *q = reinterpret_cast<__m128i *>(squares + i);
+		_mm_storeu_si128(q, _mm_add_epi64(_mm_loadu_si128(q),
+		    _mm_unpacklo_epi64(even, odd)));
+		_mm_storeu_si128(q + 1, _mm_add_epi64(_mm_loadu_si128(q + 1),
+		    _mm_unpackhi_epi64(even, odd)));
+	}
+	return (i);
+}
+
+/*
+ * AVX2 implementation, adding 16 or 8 samples at a time.
+ */
+
+TARGET_AVX2
+static uint64_t
+addColumns8AVX2(
+    const uint8_t *in,
+    uint64_t first,
+    uint64_t count,
+    uint32_t *sums,
+    uint32_t *squares)
+{
+	uint64_t i = first;
+	for (; (i + 16) <= count; i += 16) {
+		const __m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128(
+		    reinterpret_cast<const __m128i *>(in + i)));
+		const __m256i v2 = _mm256_mullo_epi16(v, v);
+
+		__m256i *s = reinterpret_cast<__m256i *>(sums + i);
+		_mm256_storeu_si256(s, _mm256_add_epi32(_mm256_loadu_si256(s),
+		    _mm256_cvtepu16_epi32(_mm256_castsi256_si128(v))));
+		_mm256_storeu_si256(s + 1, _mm256_add_epi32(
+		    _mm256_loadu_si256(s + 1), _mm256_cvtepu16_epi32(
+		    _mm256_extracti128_si256(v, 1))));
+
+		__m256i *q = reinterpret_cast<__m256i *>(squares + i);
+		_mm256_storeu_si256(q, _mm256_add_epi32(_mm256_loadu_si256(q),
+		    _mm256_cvtepu16_epi32(_mm256_castsi256_si128(v2))));
+		_mm256_storeu_si256(q + 1, _mm256_add_epi32(
+		    _mm256_loadu_si256(q + 1), _mm256_cvtepu16_epi32(
+		    _mm256_extracti128_si256(v2, 1))));
+	}
+	return (i);
+}
+
+TARGET_AVX2
+static uint64_t
+addColumns16AVX2(
+    const uint8_t *in,
+    uint64_t first,
+    uint64_t count,
+    uint32_t *sums,
+    uint64_t *squares)
+{
+	uint64_t i = first;
+	for (; (i + 8) <= count; i += 8) {
+		const __m128i v16 = _mm_loadu_si128(
+		    reinterpret_cast<const __m128i *>(in + (i * 2)));
+		__m256i *s = reinterpret_cast<__m256i *>(sums + i);
+		_mm256_storeu_si256(s, _mm256_add_epi32(_mm256_loadu_si256(s),
+		    _mm256_cvtepu16_epi32(v16)));
+
+		const __m256i lo = _mm256_cvtepu16_epi64(v16);
+		const __m256i hi = _mm256_cvtepu16_epi64(
+		    _mm_srli_si128(v16, 8));
+		__m256i *q = reinterpret_cast<__m256i *>(squares + i);
+		_mm256_storeu_si256(q, _mm256_add_epi64(_mm256_loadu_si256(q),
+		    _mm256_mul_epu32(lo, lo)));
+		_mm256_storeu_si256(q + 1, _mm256_add_epi64(
+		    _mm256_loadu_si256(q + 1), _mm256_mul_epu32(hi, hi)));
+	}
+	return (i);
+}
+
+namespace
+{
+	/** Widest instruction set usable by this processor */
+	enum class InstructionSet
+	{
+		Portable,
+		SSE41,
+		AVX2
+	};
+}
+
+static InstructionSet
+detectInstructionSet()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	const bool sse41 = ((info[2] & (1 << 19)) != 0);
+	const bool osAVX = ((info[2] & (1 << 27)) != 0) &&
+	    ((info[2] & (1 << 28)) != 0) && ((_xgetbv(0) & 0x6) == 0x6);
+	__cpuidex(info, 7, 0);
+	if (osAVX && ((info[1] & (1 << 5)) != 0))
+		return (InstructionSet::AVX2);
+	if (sse41)
+		return (InstructionSet::SSE41);
+#else
+	if (__builtin_cpu_supports("avx2"))
+		return (InstructionSet::AVX2);
+	if (__builtin_cpu_supports("sse4.1"))
+		return (InstructionSet::SSE41);
+#endif
+	return (InstructionSet::Portable);
+}
+
+static InstructionSet
+getInstructionSet()
+{
+	static const InstructionSet instructionSet = detectInstructionSet();
+	return (instructionSet);
+}
+
+#endif /* x86-64 */
+
+/* Add a row of 8-bit samples to their column sums */
+static void
+addColumns8(
+    const uint8_t *in,
+    uint64_t count,
+    uint32_t *sums,
+    uint32_t *squares)
+{
+	uint64_t i = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+	switch (getInstructionSet()) {
+	case InstructionSet::AVX2:
+		i = addColumns8AVX2(in, i, count, sums, squares);
+		/* FALLTHROUGH */
+	case InstructionSet::SSE41:
+		i = addColumns8SSE41(in, i, count, sums, squares);
+		/* FALLTHROUGH */
+	case InstructionSet::Portable:
+		break;
+	}
+#endif
+	addColumns8Portable(in, i, count, sums, squares);
+}
+
+/* Add a row of 16-bit samples to their column sums */
+static void
+addColumns16(
+    const uint8_t *in,
+    uint64_t count,
+    uint32_t *sums,
+    uint64_t *squares)
+{
+	uint64_t i = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+	switch (getInstructionSet()) {
+	case InstructionSet::AVX2:
+		i = addColumns16AVX2(in, i, count, sums, squares);
+		/* FALLTHROUGH */
+	case InstructionSet::SSE41:
+		i = addColumns16SSE41(in, i, count, sums, squares);
+		/* FALLTHROUGH */
+	case InstructionSet::Portable:
+		break;
+	}
+#endif
+	addColumns16Portable(in, i, count, sums, squares);
+}
+
+Accumulator::Accumulator(
+    const BE::Image::Size &size,
+    uint8_t depth,
+    const BE::Image::StatisticsOptions &options) :
+    _size(size),
+    _depth(depth),
+    _options(options),
+    _histogramCount((depth == 8) ? 4 : 1),
+    _histograms(_histogramCount * getHistogramSize(depth))
+{
+	if ((size.xSize == 0) || (size.ySize == 0))
+		throw BE::Error::ParameterError("Image is empty");
+
+	if (options.blockSize != 0) {
+		const uint32_t blocksAcross = static_cast<uint32_t>(
+		    ((static_cast<uint64_t>(size.xSize) + options.blockSize -
+		    1) / options.blockSize));
+		this->_blockSums.resize(blocksAcross);
+		this->_blockSquares.resize(blocksAcross);
+		this->_columnSums.resize(size.xSize);
+		if (depth == 16)
+			this->_columnWideSquares.resize(size.xSize);
+		else
+			this->_columnSquares.resize(size.xSize);
+	}
+}
+
+void
+Accumulator::countRow(
+    const uint8_t *row)
+{
+	const uint32_t width = this->_size.xSize;
+	uint64_t *h0 = this->_histograms.data();
+	if (this->_depth == 16) {
+		for (uint32_t x = 0; x < width; x++)
+			h0[load16(row + (x * 2))]++;
+		return;
+	}
+
+	uint64_t *h1 = h0 + 256, *h2 = h1 + 256, *h3 = h2 + 256;
+	uint32_t x = 0;
+	for (; (x + 4) <= width; x += 4) {
+		h0[row[x]]++;
+		h1[row[x + 1]]++;
+		h2[row[x + 2]]++;
+		h3[row[x + 3]]++;
+	}
+	for (; x < width; x++)
+		h0[row[x]]++;
+}
+
+void
+Accumulator::foldColumns()
+{
+	const uint32_t blockSize = this->_options.blockSize;
+	for (uint64_t block = 0; block < this->_blockSums.size(); block++) {
+		const uint64_t first = block * blockSize;
+		const uint64_t last = std::min<uint64_t>(first + blockSize,
+		    this->_size.xSize);
+		uint64_t sum = 0, squares = 0;
+		for (uint64_t x = first; x < last; x++) {
+			sum += this->_columnSums[x];
+			squares += (this->_depth == 16) ?
+			    this->_columnWideSquares[x] :
+			    this->_columnSquares[x];
+		}
+		this->_blockSums[block] += sum;
+		this->_blockSquares[block] += squares;
+	}
+
+	std::fill(this->_columnSums.begin(), this->_columnSums.end(), 0);
+	std::fill(this->_columnSquares.begin(), this->_columnSquares.end(), 0);
+	std::fill(this->_columnWideSquares.begin(),
+	    this->_columnWideSquares.end(), 0);
+	this->_columnRows = 0;
+}
+
+void
+Accumulator::finishBlockRow(
+    uint32_t rows)
+{
+	this->foldColumns();
+
+	const uint32_t blockSize = this->_options.blockSize;
+	for (uint64_t block = 0; block < this->_blockSums.size(); block++) {
+		const double count = static_cast<double>(rows) *
+		    std::min<uint64_t>(blockSize, this->_size.xSize -
+		    (block * blockSize));
+		const double sum = static_cast<double>(this->_blockSums[block]);
+		const double squares = static_cast<double>(
+		    this->_blockSquares[block]);
+		const double variance = (squares - ((sum * sum) / count)) /
+		    count;
+		this->_blockVariance.push_back(static_cast<float>(
+		    std::max(0.0, variance)));
+		this->_blockSums[block] = 0;
+		this->_blockSquares[block] = 0;
+	}
+}
+
+void
+Accumulator::addRows(
+    const uint8_t *rows,
+    uint32_t rowCount)
+{
+	const uint64_t rowSize = static_cast<uint64_t>(this->_size.xSize) *
+	    (this->_depth / 8);
+	const uint32_t blockSize = this->_options.blockSize;
+	for (uint32_t r = 0; r < rowCount; r++, this->_row++) {
+		const uint8_t *row = rows + (r * rowSize);
+		this->countRow(row);
+		if (blockSize == 0)
+			continue;
+
+		if (this->_depth == 16)
+			addColumns16(row, this->_size.xSize,
+			    this->_columnSums.data(),
+			    this->_columnWideSquares.data());
+		else
+			addColumns8(row, this->_size.xSize,
+			    this->_columnSums.data(),
+			    this->_columnSquares.data());
+		if (++this->_columnRows == MaximumColumnRows)
+			this->foldColumns();
+
+		if (((this->_row + 1) % blockSize) == 0)
+			this->finishBlockRow(blockSize);
+		else if ((this->_row + 1) == this->_size.ySize)
+			this->finishBlockRow((this->_row % blockSize) + 1);
+	}
+}
+
+BE::Image::Statistics
+Accumulator::finish()
+{
+	if (this->_row != this->_size.ySize)
+		throw BE::Error::StrategyError("Not all rows were added");
+
+	BE::Image::Statistics statistics;
+	statistics.depth = this->_depth;
+	statistics.count = static_cast<uint64_t>(this->_size.xSize) *
+	    this->_size.ySize;
+
+	/* Combine the interleaved histograms */
+	const uint64_t bins = getHistogramSize(this->_depth);
+	statistics.histogram.assign(this->_histograms.begin(),
+	    this->_histograms.begin() + bins);
+	for (uint8_t h = 1; h < this->_histogramCount; h++)
+		for (uint64_t bin = 0; bin < bins; bin++)
+			statistics.histogram[bin] +=
+			    this->_histograms[(h * bins) + bin];
+
+	uint64_t sum = 0;
+	bool first = true;
+	for (uint64_t bin = 0; bin < bins; bin++) {
+		if (statistics.histogram[bin] == 0)
+			continue;
+		if (first) {
+			statistics.minimum = static_cast<uint16_t>(bin);
+			first = false;
+		}
+		statistics.maximum = static_cast<uint16_t>(bin);
+		sum += bin * statistics.histogram[bin];
+	}
+	statistics.mean = static_cast<double>(sum) / statistics.count;
+
+	/* Deviations from the mean avoid cancellation */
+	double deviations = 0;
+	for (uint64_t bin = statistics.minimum; bin <= statistics.maximum;
+	    bin++) {
+		const double deviation = bin - statistics.mean;
+		deviations += deviation * deviation * statistics.histogram[bin];
+	}
+	statistics.variance = deviations / statistics.count;
+	statistics.blank = (std::sqrt(statistics.variance) <=
+	    this->_options.blankThreshold);
+
+	statistics.blockSize = this->_options.blockSize;
+	if (statistics.blockSize != 0) {
+		statistics.blockMapSize = BE::Image::Size(
+		    static_cast<uint32_t>(this->_blockSums.size()),
+		    static_cast<uint32_t>(this->_blockVariance.size() /
+		    this->_blockSums.size()));
+		statistics.blockVariance = std::move(this->_blockVariance);
+	}
+
+	return (statistics);
+}
+
+/**
+ * Expand rows of samples packed into bits, most significant first, to
+ * 8-bit samples scaled to the full range.
+ */
+static void
+unpackRows(
+    const uint8_t *rows,
+    uint32_t rowCount,
+    uint32_t width,
+    uint32_t colorDepth,
+    uint64_t rowSize,
+    uint8_t *out)
+{
+	const uint8_t mask = static_cast<uint8_t>((1u << colorDepth) - 1);
+	const uint8_t scale = static_cast<uint8_t>(255 / mask);
+	for (uint32_t row = 0; row < rowCount; row++) {
+		const uint8_t *packed = rows + (row * rowSize);
+		for (uint32_t x = 0; x < width; x++) {
+			const uint64_t bit = static_cast<uint64_t>(x) *
+			    colorDepth;
+			const uint32_t shift = 8 - colorDepth - (bit % 8);
+			*out++ = static_cast<uint8_t>(((packed[bit / 8] >>
+			    shift) & mask) * scale);
+		}
+	}
+}
+
+BiometricEvaluation::Image::Statistics
+BiometricEvaluation::Image::computeStatistics(
+    const uint8_t *gray,
+    const Size &size,
+    const uint8_t depth,
+    const StatisticsOptions &options)
+{
+	Accumulator accumulator(size, depth, options);
+	accumulator.addRows(gray, size.ySize);
+	return (accumulator.finish());
+}
+
+BiometricEvaluation::Image::Statistics
+BiometricEvaluation::Image::computeStatistics(
+    const Image &image,
+    const uint8_t depth,
+    const StatisticsOptions &options)
+{
+	const Size size = image.getDimensions();
+	Accumulator accumulator(size, depth, options);
+
+	const uint32_t colorDepth = image.getColorDepth();
+	const uint8_t bpcIn = static_cast<uint8_t>((colorDepth + 7) / 8);
+	const uint64_t rowSize = image.getRawRowSize();
+
+	/*
+	 * Gray samples of fewer than 8 bits may be packed (PNG, TIFF), or
+	 * already expanded to bytes by the codec (NetPBM bitmaps).
+	 */
+	const bool packed = ((colorDepth == 1) || (colorDepth == 2) ||
+	    (colorDepth == 4)) && (rowSize == (((static_cast<uint64_t>(
+	    size.xSize) * colorDepth) + 7) / 8));
+	if (!packed && (rowSize != (static_cast<uint64_t>(size.xSize) *
+	    bpcIn))) {
+		if (colorDepth < 8)
+			throw Error::NotImplemented("Statistics of " +
+			    std::to_string(colorDepth) + "-bit depth imagery");
+		throw Error::DataError("Raw data size does not match image "
+		    "dimensions");
+	}
+
+	/* Converted rows of one chunk, as getRawGrayscaleData() */
+	Memory::uint8Array unpacked, gray;
+	image.decodeRows([&](uint32_t, uint32_t rowCount,
+	    const uint8_t *rows) {
+		const uint64_t pixelCount = static_cast<uint64_t>(rowCount) *
+		    size.xSize;
+		uint32_t rowDepth = colorDepth;
+		if (packed) {
+			unpacked.resize(pixelCount);
+			unpackRows(rows, rowCount, size.xSize, colorDepth,
+			    rowSize, unpacked);
+			rows = unpacked;
+			rowDepth = 8;
+		}
+		if (rowDepth == depth) {
+			accumulator.addRows(rows, rowCount);
+			return;
+		}
+		gray.resize(pixelCount * (depth / 8));
+		PixelConversion::toGray(rows, rowDepth, pixelCount, gray,
+		    depth);
+		accumulator.addRows(gray, rowCount);
+	    }, RowsPerChunk);
+
+	return (accumulator.finish());
+}
@@ -8,6 +8,9 @@
  * about its quality, reliability, or any other characteristic.
  */
 
+#include <algorithm>
+#include <cstring>
+
 #include <tiffio.h>
 
 #include <be_image_tiff.h>
@@ -160,6 +163,36 @@ BE_TIFFWarningHandler(
     va_list args)
     noexcept;
 
+/**
+ * @brief
+ * Read decoded rows from a TIFF organized in strips or tiles.
+ *
+ * @param[in] tiff
+ * Open TIFF handle.
+ * @param[in] firstRow
+ * First row to read. For tiled images, reading is most efficient when
+ * firstRow starts a row of tiles and rowCount covers whole rows of tiles.
+ * @param[in] rowCount
+ * Number of rows to read.
+ * @param[in] buffer
+ * Buffer to hold the rows.
+ * @param[in] stride
+ * Number of bytes from the start of one row to the start of the next in
+ * buffer.
+ *
+ * @throw Error::StrategyError
+ * Error reading a strip or tile.
+ * @throw Error::NotImplemented
+ * Tiled image with pixels smaller than a byte.
+ */
+static void
+readTIFFRows(
+    ::TIFF *tiff,
+    uint32_t firstRow,
+    uint32_t rowCount,
+    uint8_t *buffer,
+    uint64_t stride);
+
 /******************************************************************************/
 
 BiometricEvaluation::Image::TIFF::TIFF(
@@ -167,14 +200,25 @@ BiometricEvaluation::Image::TIFF::TIFF(
     const uint64_t size,
     const std::string &identifier,
     const statusCallback_t &statusCallback) :
-    Image(
+    BiometricEvaluation::Image::TIFF::TIFF(
+    Memory::ByteSpan::copyOf(data, size),
+    identifier,
+    statusCallback)
+{
+
+}
+
+BiometricEvaluation::Image::TIFF::TIFF(
+    const BiometricEvaluation::Memory::ByteSpan &data,
+    const std::string &identifier,
+    const statusCallback_t &statusCallback) :
+    Image::Image(
     data,
-    size,
     CompressionAlgorithm::TIFF,
     identifier,
     statusCallback)
 {
-	if (!isTIFF(data, size))
+	if (!isTIFF(data.data(), data.size()))
 		throw BE::Error::StrategyError("Not a TIFF image");
 
 	TIFFSetWarningHandlerExt(BE_TIFFWarningHandler);
@@ -275,25 +319,77 @@ BiometricEvaluation::Image::TIFF::TIFF(
 }
 
 BiometricEvaluation::Memory::uint8Array
-BiometricEvaluation::Image::TIFF::getRawData()
+BiometricEvaluation::Image::TIFF::decodeRawData()
+    const
+{
+	BE::Memory::uint8Array rawData(this->requiredBufferSize(),
+	    BE::Memory::Allocation::Pooled);
+	this->decodeRawDataInto(rawData, this->getRawRowSize());
+	return (rawData);
+}
+
+void
+BiometricEvaluation::Image::TIFF::decodeRawDataInto(
+    uint8_t *buffer,
+    uint64_t stride)
     const
 {
 	std::unique_ptr<::TIFF, void(*)(::TIFF*)> tiff(
 	    static_cast<::TIFF*>(this->getDecompressionStream()), TIFFClose);
 
 	const auto rowBytes = TIFFScanlineSize(tiff.get());
-	const auto dim = this->getDimensions();
-	BE::Memory::uint8Array rawData(dim.ySize * rowBytes);
-
-	for (uint32_t i{0}; i < dim.ySize; ++i) {
-		/* TODO: Per-component decompression (4th parameter) */
-		if (TIFFReadScanline(tiff.get(), rawData + (rowBytes * i),
-		    i, 0) != 1)
-			throw BE::Error::StrategyError("Error reading "
-			    "scanline at " + std::to_string(rowBytes * i));
-	}
+	if (static_cast<uint64_t>(rowBytes) != this->getRawRowSize())
+		throw BE::Error::DataError("Scanline size does not match "
+		    "image dimensions");
 
-	return (rawData);
+	readTIFFRows(tiff.get(), 0, this->getDimensions().ySize, buffer,
+	    stride);
+}
+
+void
+BiometricEvaluation::Image::TIFF::decodeRawRows(
+    const rowCallback_t &callback,
+    uint32_t rowsPerChunk)
+    const
+{
+	std::unique_ptr<::TIFF, void(*)(::TIFF*)> tiff(
+	    static_cast<::TIFF*>(this->getDecompressionStream()), TIFFClose);
+
+	const uint64_t rowSize = this->getRawRowSize();
+	if (static_cast<uint64_t>(TIFFScanlineSize(tiff.get())) != rowSize)
+		throw BE::Error::DataError("Scanline size does not match "
+		    "image dimensions");
+
+	/*
+	 * Tiles are decoded a row of tiles at a time, and strips a
+	 * scanline at a time.
+	 */
+	const uint32_t height = this->getDimensions().ySize;
+	uint32_t bandRows{};
+	if (TIFFIsTiled(tiff.get())) {
+		if (TIFFGetField(tiff.get(), TIFFTAG_TILELENGTH,
+		    &bandRows) != 1)
+			throw BE::Error::StrategyError("Could not read tile "
+			    "length");
+		if (rowsPerChunk == 0)
+			rowsPerChunk = bandRows;
+	} else {
+		if (rowsPerChunk == 0)
+			TIFFGetFieldDefaulted(tiff.get(), TIFFTAG_ROWSPERSTRIP,
+			    &rowsPerChunk);
+		bandRows = rowsPerChunk;
+	}
+	bandRows = std::max<uint32_t>(1, std::min(bandRows, height));
+
+	BE::Memory::uint8Array band(rowSize * bandRows,
+	    BE::Memory::Allocation::Pooled);
+	for (uint32_t firstRow{0}; firstRow < height; firstRow += bandRows) {
+		const uint32_t rowCount = std::min(bandRows,
+		    height - firstRow);
+		readTIFFRows(tiff.get(), firstRow, rowCount, band, rowSize);
+		this->passRows(band, firstRow, rowCount, callback,
+		    rowsPerChunk);
+	}
 }
 
 BiometricEvaluation::Memory::uint8Array
@@ -341,6 +437,65 @@ BiometricEvaluation::Image::TIFF::libtiffMessageToString(
 	return (formattedMessage);
 }
 
+void
+readTIFFRows(
+    ::TIFF *tiff,
+    uint32_t firstRow,
+    uint32_t rowCount,
+    uint8_t *buffer,
+    uint64_t stride)
+{
+	if (!TIFFIsTiled(tiff)) {
+		for (uint32_t i{0}; i < rowCount; ++i) {
+			/* TODO: Per-component decompression (4th parameter) */
+			if (TIFFReadScanline(tiff, buffer + (stride * i),
+			    firstRow + i, 0) != 1)
+				throw BE::Error::StrategyError("Error reading "
+				    "scanline " + std::to_string(firstRow + i));
+		}
+		return;
+	}
+
+	uint32_t width{}, tileWidth{}, tileLength{};
+	uint16_t bitsPerSample{}, samplesPerPixel{};
+	if ((TIFFGetField(tiff, TIFFTAG_IMAGEWIDTH, &width) != 1) ||
+	    (TIFFGetField(tiff, TIFFTAG_TILEWIDTH, &tileWidth) != 1) ||
+	    (TIFFGetField(tiff, TIFFTAG_TILELENGTH, &tileLength) != 1) ||
+	    (tileWidth == 0) || (tileLength == 0))
+		throw BE::Error::StrategyError("Could not read tile "
+		    "dimensions");
+	TIFFGetFieldDefaulted(tiff, TIFFTAG_BITSPERSAMPLE, &bitsPerSample);
+	TIFFGetFieldDefaulted(tiff, TIFFTAG_SAMPLESPERPIXEL, &samplesPerPixel);
+	if (((bitsPerSample * samplesPerPixel) % 8) != 0)
+		throw BE::Error::NotImplemented("Tiles with pixels smaller "
+		    "than a byte");
+	const uint64_t pixelSize = (bitsPerSample * samplesPerPixel) / 8;
+
+	/* Each tile intersecting the rows is decoded once */
+	BE::Memory::uint8Array tile(TIFFTileSize(tiff));
+	const uint64_t tileRowSize = TIFFTileRowSize(tiff);
+	const uint32_t lastRow = firstRow + rowCount;
+	for (uint32_t y = firstRow - (firstRow % tileLength); y < lastRow;
+	    y += tileLength) {
+		const uint32_t startRow = std::max(y, firstRow);
+		const uint32_t endRow = std::min(y + tileLength, lastRow);
+		for (uint32_t x{0}; x < width; x += tileWidth) {
+			if (TIFFReadTile(tiff, tile, x, y, 0, 0) < 0)
+				throw BE::Error::StrategyError("Error reading "
+				    "tile at (" + std::to_string(x) + ", " +
+				    std::to_string(y) + ")");
+
+			/* Tiles on the edges extend past the image */
+			const uint64_t columnSize = std::min(tileWidth,
+			    width - x) * pixelSize;
+			for (uint32_t row = startRow; row < endRow; ++row)
+				std::memcpy(buffer + ((row - firstRow) *
+				    stride) + (x * pixelSize), tile +
+				    ((row - y) * tileRowSize), columnSize);
+		}
+	}
+}
+
 void
 BE_TIFFErrorHandler(
     thandle_t handle,
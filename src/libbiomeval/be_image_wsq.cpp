@@ -8,7 +8,10 @@
  * about its quality, reliability, or any other characteristic.
  */
 
+#include <algorithm>
 #include <cstdio>
+#include <cstdlib>
+#include <memory>
 
 extern "C" {
 	#include <dataio.h>
@@ -23,9 +26,20 @@ BiometricEvaluation::Image::WSQ::WSQ(
     const uint64_t size,
     const std::string &identifier,
     const statusCallback_t &statusCallback) :
+    BiometricEvaluation::Image::WSQ::WSQ(
+    Memory::ByteSpan::copyOf(data, size),
+    identifier,
+    statusCallback)
+{
+
+}
+
+BiometricEvaluation::Image::WSQ::WSQ(
+    const BiometricEvaluation::Memory::ByteSpan &data,
+    const std::string &identifier,
+    const statusCallback_t &statusCallback) :
     Image::Image(
     data,
-    size,
     CompressionAlgorithm::WSQ20,
     identifier,
     statusCallback)
@@ -37,20 +51,20 @@ BiometricEvaluation::Image::WSQ::WSQ(
 	uint16_t marker, tbl_size;
 	uint32_t rv = 0;
 	if ((rv = biomeval_nbis_getc_marker_wsq(&marker, SOI_WSQ, &marker_buf,
-	    wsq_buf + size)))
+	    wsq_buf + data.size())))
 		throw Error::StrategyError("Could not read to SOI_WSQ");
 
 	/* Step through any tables up to the "start of frame" marker */
 	for (;;) {
 		if ((rv = biomeval_nbis_getc_marker_wsq(&marker, TBLS_N_SOF, &marker_buf,
-		    wsq_buf + size)))
+		    wsq_buf + data.size())))
 			throw Error::StrategyError("Could not read to "
 			    "TBLS_N_SOF");
 
 		if (marker == SOF_WSQ)
 			break;
 
-		if ((rv = biomeval_nbis_getc_ushort(&tbl_size, &marker_buf, wsq_buf + size)))
+		if ((rv = biomeval_nbis_getc_ushort(&tbl_size, &marker_buf, wsq_buf + data.size())))
 			throw Error::StrategyError("Could not read size "
 			    "of table");
 		/* Table size includes size of field but not the marker */
@@ -60,13 +74,13 @@ BiometricEvaluation::Image::WSQ::WSQ(
 	/* Read the frame header */
 	FRM_HEADER_WSQ wsq_header;
 	if ((rv = biomeval_nbis_getc_frame_header_wsq(&wsq_header, &marker_buf,
-	    wsq_buf + size)))
+	    wsq_buf + data.size())))
 		throw Error::DataError("Could not read frame header");
 	setDimensions(Size(wsq_header.width, wsq_header.height));
 
 	/* Read PPI from NISTCOM, if present */
 	int ppi{-1};
-	if (biomeval_nbis_getc_ppi_wsq(&ppi, wsq_buf, size) == 0) {
+	if (biomeval_nbis_getc_ppi_wsq(&ppi, wsq_buf, data.size()) == 0) {
 		/* Resolution does not have to be defined */
 		if (ppi == -1)
 			/* WSQ is a 500 ppi specification */
@@ -104,23 +118,110 @@ BiometricEvaluation::Image::WSQ::WSQ(
 }
 
 BiometricEvaluation::Memory::uint8Array
-BiometricEvaluation::Image::WSQ::getRawData()
+BiometricEvaluation::Image::WSQ::decodeRawData()
+    const
+{
+	Memory::uint8Array rawData(this->requiredBufferSize(),
+	    Memory::Allocation::Pooled);
+	this->decodeRawDataInto(rawData, this->getRawRowSize());
+	return (rawData);
+}
+
+void
+BiometricEvaluation::Image::WSQ::decodeRawDataInto(
+    uint8_t *buffer,
+    uint64_t stride)
     const
 {
 	uint8_t *rawbuf = nullptr;
 	int32_t depth, height, lossy, ppi, rv, width;
-	if ((rv = biomeval_nbis_wsq_decode_mem(&rawbuf, &width, &height, &depth, &ppi,
-	    &lossy, (unsigned char *)this->getDataPointer(),
-	    this->getDataSize())))
+	/* Per-call decoder state allows concurrent decoding */
+	WSQ_DECODER decoder;
+	biomeval_nbis_init_wsq_decoder(&decoder);
+	rv = biomeval_nbis_wsq_decode_mem_r(&decoder, &rawbuf, &width, &height,
+	    &depth, &ppi, &lossy, (unsigned char *)this->getDataPointer(),
+	    this->getDataSize());
+	biomeval_nbis_free_wsq_decoder(&decoder);
+	if (rv != 0)
 		throw Error::DataError("Could not convert WSQ to raw.");
 
-	/* rawbuf allocated within libwsq.  Copy to manage with AutoArray. */
-	/* TODO: AutoBuffer-wrapped AutoArray */
-	Memory::uint8Array rawData(width * height * (depth / 8));
-	rawData.copy(rawbuf);
+	/* rawbuf allocated within libwsq, so copy straight to the caller */
+	try {
+		this->copyRawDataInto(rawbuf, static_cast<uint64_t>(width) *
+		    height * (depth / 8), buffer, stride);
+	} catch (...) {
+		free(rawbuf);
+		throw;
+	}
 	free(rawbuf);
+}
 
-	return (rawData);
+BiometricEvaluation::Memory::uint8Array
+BiometricEvaluation::Image::WSQ::crop(
+    const ROI &roi)
+    const
+{
+	return (this->crop(std::vector<ROI>{roi}).front());
+}
+
+std::vector<BiometricEvaluation::Memory::uint8Array>
+BiometricEvaluation::Image::WSQ::crop(
+    const std::vector<ROI> &rois)
+    const
+{
+	const Size dimensions = this->getDimensions();
+	for (const auto &roi : rois) {
+		if ((roi.size.xSize == 0) || (roi.size.ySize == 0))
+			throw Error::ParameterError("Empty ROI");
+		if ((roi.horzOffset >= dimensions.xSize) ||
+		    (roi.vertOffset >= dimensions.ySize))
+			throw Error::ParameterError("ROI " + to_string(roi) +
+			    " is outside of image " + to_string(dimensions));
+	}
+
+	/*
+	 * The first call decodes the quantized coefficients into qdata
+	 * and allocates odata, which later calls reuse.
+	 */
+	WSQ_DECODER decoder;
+	biomeval_nbis_init_wsq_decoder(&decoder);
+	uint8_t *odata = nullptr;
+	short *qdata = nullptr;
+	int32_t height, hgtPos, huffPos, width;
+
+	/* Free the NBIS buffers and decoder however the loop exits */
+	const auto freeDecoder = [&](WSQ_DECODER *ptr) {
+		free(odata);
+		free(qdata);
+		biomeval_nbis_free_wsq_decoder(ptr);
+	};
+	std::unique_ptr<WSQ_DECODER, decltype(freeDecoder)>
+	    pDecoder(&decoder, freeDecoder);
+
+	std::vector<Memory::uint8Array> crops;
+	crops.reserve(rois.size());
+	for (const auto &roi : rois) {
+		/* Clip before converting to the signed corners of NBIS */
+		const uint32_t lrx = std::min<uint64_t>(dimensions.xSize,
+		    static_cast<uint64_t>(roi.horzOffset) + roi.size.xSize);
+		const uint32_t lry = std::min<uint64_t>(dimensions.ySize,
+		    static_cast<uint64_t>(roi.vertOffset) + roi.size.ySize);
+
+		int32_t cropHeight, cropWidth, length;
+		const int32_t rv = biomeval_nbis_wsq_cropcoeff_mem_r(&decoder,
+		    &odata, &length, &cropWidth, &cropHeight, roi.horzOffset,
+		    roi.vertOffset, lrx, lry, &width, &height,
+		    (unsigned char *)this->getDataPointer(),
+		    this->getDataSize(), &qdata, &hgtPos, &huffPos);
+		if ((rv != 0) || (cropWidth == -1))
+			throw Error::DataError("Could not crop WSQ to " +
+			    to_string(roi));
+
+		crops.emplace_back(length);
+		crops.back().copy(odata, length);
+	}
+
+	return (crops);
 }
 
 BiometricEvaluation::Memory::uint8Array
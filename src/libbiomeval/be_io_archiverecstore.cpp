@@ -82,6 +82,14 @@ BiometricEvaluation::IO::ArchiveRecordStore::read(
 	return (this->pimpl->read(key));
 }
 
+std::vector<BiometricEvaluation::Memory::uint8Array>
+BiometricEvaluation::IO::ArchiveRecordStore::read(
+    const std::vector<std::string> &keys)
+    const
+{
+	return (this->pimpl->read(keys));
+}
+
 uint64_t
 BiometricEvaluation::IO::ArchiveRecordStore::length(
     const std::string &key)
@@ -147,6 +155,20 @@ BiometricEvaluation::IO::ArchiveRecordStore::changeDescription(
 	return (this->pimpl->changeDescription(description));
 }
 
+void
+BiometricEvaluation::IO::ArchiveRecordStore::setChecksumVerification(
+    bool verify)
+{
+	this->pimpl->setChecksumVerification(verify);
+}
+
+bool
+BiometricEvaluation::IO::ArchiveRecordStore::getChecksumVerification()
+    const
+{
+	return (this->pimpl->getChecksumVerification());
+}
+
 bool
 BiometricEvaluation::IO::ArchiveRecordStore::needsVacuum()
 {
@@ -9,8 +9,14 @@
  */
 
 #include "be_io_archiverecstore_impl.h"
+#include "be_io_batchread_impl.h"
 #include <sys/stat.h>
-
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 #include <algorithm>
 #include <cerrno>
@@ -301,14 +307,75 @@ BiometricEvaluation::IO::ArchiveRecordStore::Impl::read(
 	if (!_archivefp)
 		throw Error::StrategyError("Archive cannot seek");
 
-	Memory::uint8Array data(entry->second.size);
+	Memory::uint8Array data(entry->second.size,
+	    Memory::Allocation::Pooled);
 	_archivefp.read((char *)&data[0], entry->second.size);
 	if (!_archivefp)
 		throw Error::StrategyError("Archive cannot read");
 
+	this->verifyChecksum(key, data, data.size());
 	return (data);
 }
 
+std::vector<BiometricEvaluation::Memory::uint8Array>
+BiometricEvaluation::IO::ArchiveRecordStore::Impl::read(
+    const std::vector<std::string> &keys)
+    const
+{
+	/* Locate every record before reading any of them */
+	std::vector<Memory::uint8Array> records;
+	std::vector<IO::BatchRead::Request> requests;
+	records.reserve(keys.size());
+	requests.reserve(keys.size());
+	for (const auto &key : keys) {
+		if (!validateKeyString(key))
+			throw Error::StrategyError("Invalid key format");
+		std::shared_ptr<ManifestMap::value_type> entry =
+		    _entries.find_quick(key);
+		if (entry.get() == nullptr)
+			throw Error::ObjectDoesNotExist(key);
+		if (entry->second.offset == OFFSET_RECORD_REMOVED)
+			throw Error::ObjectDoesNotExist(key + " was removed");
+
+		records.emplace_back(entry->second.size,
+		    Memory::Allocation::Pooled);
+		requests.push_back({-1,
+		    static_cast<uint64_t>(entry->second.offset),
+		    entry->second.size, records.back()});
+	}
+	if (requests.empty())
+		return (records);
+
+	/* Pending writes must be visible to the separate descriptor */
+	if (_archivefp.is_open())
+		_archivefp.flush();
+
+	const std::string pathname = canonicalName(ARCHIVE_FILE_NAME);
+#ifdef _WIN32
+	const int fd = _open(pathname.c_str(), _O_RDONLY | _O_BINARY);
+#else
+	const int fd = ::open(pathname.c_str(), O_RDONLY);
+#endif
+	if (fd == -1)
+		throw Error::StrategyError("Could not open " + pathname +
+		    " (" + Error::errorStr() + ")");
+	for (auto &request : requests)
+		request.fd = fd;
+
+	try {
+		IO::BatchRead::read(requests);
+	} catch (const Error::Exception &e) {
+		::close(fd);
+		throw Error::StrategyError("Archive cannot read (" +
+		    e.whatString() + ")");
+	}
+	::close(fd);
+
+	for (size_t i = 0; i < keys.size(); i++)
+		this->verifyChecksum(keys[i], records[i], records[i].size());
+	return (records);
+}
+
 void
 BiometricEvaluation::IO::ArchiveRecordStore::Impl::insert(
     const std::string &key,
@@ -334,6 +401,11 @@ BiometricEvaluation::IO::ArchiveRecordStore::Impl::insert(
 		}
 	}
 	_archivefp.clear();
+	/*
+	 * Writes in append mode always go to the end of the archive, but
+	 * the put position is not moved there until the first write.
+	 */
+	_archivefp.seekp(0, std::ios_base::end);
 	offset = _archivefp.tellp();
 	if (!_archivefp)
 		throw Error::StrategyError("Could not get archive position");
@@ -84,6 +84,9 @@ namespace BiometricEvaluation {
 			Memory::uint8Array read(
 			    const std::string &key) const;
 
+			std::vector<Memory::uint8Array> read(
+			    const std::vector<std::string> &keys) const;
+
 			uint64_t length(
 			    const std::string &key) const;
 
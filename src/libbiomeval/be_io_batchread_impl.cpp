@@ -0,0 +1,474 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_LINUX_IO_URING_H
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <thread>
+
+#include <be_error.h>
+#include <be_error_exception.h>
+
+#include "be_io_batchread_impl.h"
+
+namespace BE = BiometricEvaluation;
+
+using Request = BE::IO::BatchRead::Request;
+
+/*
+ * Read the entirety of a request synchronously, starting after the
+ * first `completed` bytes.
+ */
+static void
+readFully(
+    const Request &request,
+    uint64_t completed = 0)
+{
+	while (completed < request.size) {
+#ifdef _WIN32
+		/* Only called from a single thread on Windows */
+		if (_lseeki64(request.fd, request.offset + completed,
+		    SEEK_SET) == -1)
+			throw BE::Error::StrategyError("Could not seek (" +
+			    BE::Error::errorStr() + ")");
+		const int rv = _read(request.fd, request.buffer + completed,
+		    static_cast<unsigned int>(std::min<uint64_t>(
+		    request.size - completed, INT32_MAX)));
+#else
+		const ssize_t rv = pread(request.fd, request.buffer + completed,
+		    request.size - completed, request.offset + completed);
+#endif
+		if (rv < 0) {
+			if (errno == EINTR)
+				continue;
+			throw BE::Error::StrategyError("Could not read (" +
+			    BE::Error::errorStr() + ")");
+		}
+		if (rv == 0)
+			throw BE::Error::StrategyError("Unexpected end of "
+			    "file");
+		completed += rv;
+	}
+}
+
+/*
+ * Service requests from threads, each blocking in pread(). Threads are
+ * only started when there are enough requests to keep them busy, and
+ * never more than there are CPUs, so small batches are read on the
+ * calling thread.
+ */
+static void
+readWithThreads(
+    const std::vector<const Request*> &requests,
+    uint32_t numThreads)
+{
+	/* Fewest requests worth handing to another thread */
+	static const uint64_t REQUESTS_PER_THREAD = 8;
+
+#ifdef _WIN32
+	numThreads = 1;
+#endif
+	const uint32_t cpus = std::max(1u, std::thread::hardware_concurrency());
+	numThreads = std::max<uint32_t>(1, std::min<uint64_t>(
+	    std::min(numThreads, cpus), requests.size() / REQUESTS_PER_THREAD));
+
+	/* Threads take the next request, preserving offset order */
+	std::atomic<size_t> next{0};
+	std::vector<std::exception_ptr> errors(numThreads);
+	const auto worker = [&](const uint32_t thread) {
+		try {
+			size_t i;
+			while ((i = next.fetch_add(1)) < requests.size())
+				readFully(*requests[i]);
+		} catch (...) {
+			errors[thread] = std::current_exception();
+			next = requests.size();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	try {
+		for (uint32_t i = 1; i < numThreads; i++)
+			threads.emplace_back(worker, i);
+	} catch (...) {
+		/* Threads already started are reading into buffers */
+		next = requests.size();
+		for (auto &thread : threads)
+			thread.join();
+		throw;
+	}
+	worker(0);
+	for (auto &thread : threads)
+		thread.join();
+
+	for (const auto &error : errors)
+		if (error)
+			std::rethrow_exception(error);
+}
+
+#ifdef HAVE_LINUX_IO_URING_H
+namespace
+{
+	/*
+	 * Minimal io_uring submission/completion ring, using the kernel
+	 * interface directly so that liburing is not required.
+	 */
+	class IOURing
+	{
+	public:
+		explicit IOURing(
+		    uint32_t entries)
+		{
+			struct io_uring_params params;
+			std::memset(&params, 0, sizeof(params));
+			this->_fd = static_cast<int>(syscall(__NR_io_uring_setup,
+			    entries, &params));
+			if (this->_fd < 0)
+				throw BE::Error::NotImplemented("io_uring (" +
+				    BE::Error::errorStr() + ")");
+
+			this->_sqSize = params.sq_off.array +
+			    (params.sq_entries * sizeof(uint32_t));
+			this->_cqSize = params.cq_off.cqes +
+			    (params.cq_entries * sizeof(struct io_uring_cqe));
+			this->_sqesSize = params.sq_entries *
+			    sizeof(struct io_uring_sqe);
+
+			this->_sq = mmap(nullptr, this->_sqSize,
+			    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			    this->_fd, IORING_OFF_SQ_RING);
+			this->_cq = mmap(nullptr, this->_cqSize,
+			    PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			    this->_fd, IORING_OFF_CQ_RING);
+			this->_sqes = static_cast<struct io_uring_sqe *>(mmap(
+			    nullptr, this->_sqesSize, PROT_READ | PROT_WRITE,
+			    MAP_SHARED | MAP_POPULATE, this->_fd,
+			    IORING_OFF_SQES));
+			if ((this->_sq == MAP_FAILED) ||
+			    (this->_cq == MAP_FAILED) ||
+			    (this->_sqes == MAP_FAILED)) {
+				const std::string error = BE::Error::errorStr();
+				this->release();
+				throw BE::Error::StrategyError("Could not map "
+				    "io_uring (" + error + ")");
+			}
+
+			uint8_t *sq = static_cast<uint8_t *>(this->_sq);
+			this->_sqHead = reinterpret_cast<uint32_t *>(sq +
+			    params.sq_off.head);
+			this->_sqTail = reinterpret_cast<uint32_t *>(sq +
+			    params.sq_off.tail);
+			this->_sqMask = *reinterpret_cast<uint32_t *>(sq +
+			    params.sq_off.ring_mask);
+			this->_sqArray = reinterpret_cast<uint32_t *>(sq +
+			    params.sq_off.array);
+			this->_sqEntries = params.sq_entries;
+
+			uint8_t *cq = static_cast<uint8_t *>(this->_cq);
+			this->_cqHead = reinterpret_cast<uint32_t *>(cq +
+			    params.cq_off.head);
+			this->_cqTail = reinterpret_cast<uint32_t *>(cq +
+			    params.cq_off.tail);
+			this->_cqMask = *reinterpret_cast<uint32_t *>(cq +
+			    params.cq_off.ring_mask);
+			this->_cqes = reinterpret_cast<struct io_uring_cqe *>(
+			    cq + params.cq_off.cqes);
+		}
+
+		~IOURing()
+		{
+			this->release();
+		}
+
+		uint32_t
+		getEntries()
+		    const
+		{
+			return (this->_sqEntries);
+		}
+
+		/* Number of reads queued but not yet submitted */
+		uint32_t
+		getUnsubmitted()
+		    const
+		{
+			return (this->_unsubmitted);
+		}
+
+		/* Queue a read, identified by id, to be submitted by enter() */
+		void
+		prepareRead(
+		    const Request &request,
+		    uint64_t id)
+		{
+			const uint32_t tail = *this->_sqTail;
+			const uint32_t index = tail & this->_sqMask;
+			struct io_uring_sqe *sqe = &this->_sqes[index];
+			std::memset(sqe, 0, sizeof(*sqe));
+			sqe->opcode = IORING_OP_READ;
+			sqe->fd = request.fd;
+			sqe->off = request.offset;
+			sqe->addr = reinterpret_cast<uint64_t>(request.buffer);
+			sqe->len = static_cast<uint32_t>(std::min<uint64_t>(
+			    request.size, UINT32_MAX));
+			sqe->user_data = id;
+			this->_sqArray[index] = index;
+			__atomic_store_n(this->_sqTail, tail + 1,
+			    __ATOMIC_RELEASE);
+			this->_unsubmitted++;
+		}
+
+		/* Submit queued reads and wait for at least one */
+		void
+		enter()
+		{
+			while (true) {
+				const int rv = static_cast<int>(syscall(
+				    __NR_io_uring_enter, this->_fd,
+				    this->_unsubmitted, 1,
+				    IORING_ENTER_GETEVENTS, nullptr, 0));
+				if (rv >= 0) {
+					this->_unsubmitted -= rv;
+					return;
+				}
+				if (errno != EINTR)
+					throw BE::Error::StrategyError(
+					    "io_uring_enter (" +
+					    BE::Error::errorStr() + ")");
+			}
+		}
+
+		/*
+		 * Wait for a completion without submitting, polling when
+		 * the kernel refuses to wait.
+		 */
+		void
+		wait()
+		{
+			const int rv = static_cast<int>(syscall(
+			    __NR_io_uring_enter, this->_fd, 0, 1,
+			    IORING_ENTER_GETEVENTS, nullptr, 0));
+			if ((rv < 0) && (errno != EINTR))
+				std::this_thread::sleep_for(
+				    std::chrono::milliseconds(1));
+		}
+
+		/* Call a function with the id and result of each completion */
+		template<typename F>
+		uint32_t
+		reap(
+		    F &&completed)
+		{
+			uint32_t count = 0;
+			uint32_t head = *this->_cqHead;
+			while (head != __atomic_load_n(this->_cqTail,
+			    __ATOMIC_ACQUIRE)) {
+				const struct io_uring_cqe &cqe =
+				    this->_cqes[head & this->_cqMask];
+				completed(cqe.user_data, cqe.res);
+				head++;
+				count++;
+				__atomic_store_n(this->_cqHead, head,
+				    __ATOMIC_RELEASE);
+			}
+			return (count);
+		}
+
+		IOURing(const IOURing&) = delete;
+		IOURing& operator=(const IOURing&) = delete;
+
+	private:
+		int _fd{-1};
+		void *_sq{MAP_FAILED};
+		size_t _sqSize{0};
+		void *_cq{MAP_FAILED};
+		size_t _cqSize{0};
+		struct io_uring_sqe *_sqes{
+		    static_cast<struct io_uring_sqe *>(MAP_FAILED)};
+		size_t _sqesSize{0};
+
+		uint32_t *_sqHead{nullptr};
+		uint32_t *_sqTail{nullptr};
+		uint32_t _sqMask{0};
+		uint32_t *_sqArray{nullptr};
+		uint32_t _sqEntries{0};
+		uint32_t _unsubmitted{0};
+
+		uint32_t *_cqHead{nullptr};
+		uint32_t *_cqTail{nullptr};
+		uint32_t _cqMask{0};
+		struct io_uring_cqe *_cqes{nullptr};
+
+		void
+		release()
+		{
+			if (this->_sqes != MAP_FAILED)
+				munmap(this->_sqes, this->_sqesSize);
+			this->_sqes = static_cast<struct io_uring_sqe *>(
+			    MAP_FAILED);
+			if (this->_cq != MAP_FAILED)
+				munmap(this->_cq, this->_cqSize);
+			this->_cq = MAP_FAILED;
+			if (this->_sq != MAP_FAILED)
+				munmap(this->_sq, this->_sqSize);
+			this->_sq = MAP_FAILED;
+			if (this->_fd >= 0)
+				close(this->_fd);
+			this->_fd = -1;
+		}
+	};
+}
+
+/*
+ * Service requests through io_uring. If the ring fails, requests it has
+ * not completed are read with pread() instead.
+ */
+static void
+readWithIOURing(
+    const std::vector<const Request*> &requests,
+    uint32_t queueDepth)
+{
+	IOURing ring(queueDepth);
+
+	/*
+	 * The kernel writes to the buffers of requests in flight, so
+	 * errors are only reported once all requests have completed.
+	 */
+	std::exception_ptr error;
+	std::vector<bool> done(requests.size(), false);
+	size_t submitted = 0, inFlight = 0;
+	const auto complete = [&](const uint64_t i, const int32_t result) {
+		done[i] = true;
+		inFlight--;
+
+		/* Finish short or failed reads synchronously */
+		if ((result >= 0) &&
+		    (static_cast<uint64_t>(result) == requests[i]->size))
+			return;
+		try {
+			readFully(*requests[i], (result < 0 ? 0 : result));
+		} catch (...) {
+			if (!error)
+				error = std::current_exception();
+		}
+	};
+
+	bool ringFailed = false;
+	while (true) {
+		while ((inFlight < ring.getEntries()) &&
+		    (submitted < requests.size()) && !error) {
+			ring.prepareRead(*requests[submitted], submitted);
+			submitted++;
+			inFlight++;
+		}
+		if (inFlight == 0)
+			break;
+		try {
+			ring.enter();
+		} catch (const BE::Error::Exception&) {
+			ringFailed = true;
+			break;
+		}
+		ring.reap(complete);
+	}
+	if (!ringFailed) {
+		if (error)
+			std::rethrow_exception(error);
+		return;
+	}
+
+	/*
+	 * Reads the kernel accepted still complete into their buffers,
+	 * so wait for them before touching the buffers or unwinding.
+	 * Reads queued but never submitted are discarded with the ring.
+	 */
+	while (inFlight > ring.getUnsubmitted()) {
+		ring.wait();
+		ring.reap(complete);
+	}
+	if (error)
+		std::rethrow_exception(error);
+
+	std::vector<const Request*> remaining;
+	for (size_t i = 0; i < requests.size(); i++)
+		if (!done[i])
+			remaining.push_back(requests[i]);
+	readWithThreads(remaining, queueDepth);
+}
+#endif /* HAVE_LINUX_IO_URING_H */
+
+bool
+BiometricEvaluation::IO::BatchRead::isIOURingAvailable()
+{
+#ifdef HAVE_LINUX_IO_URING_H
+	/* Kernels may lack io_uring, or it may be disabled by policy */
+	static const bool available = []() {
+		try {
+			IOURing ring(1);
+		} catch (const Error::Exception&) {
+			return (false);
+		}
+		return (true);
+	    }();
+	return (available);
+#else
+	return (false);
+#endif
+}
+
+void
+BiometricEvaluation::IO::BatchRead::read(
+    const std::vector<Request> &requests,
+    uint32_t queueDepth,
+    bool useIOURing)
+{
+	if (requests.empty())
+		return;
+	queueDepth = std::max<uint32_t>(1, queueDepth);
+
+	/* Issue requests in file order for locality */
+	std::vector<const Request*> sorted;
+	sorted.reserve(requests.size());
+	for (const auto &request : requests)
+		if (request.size > 0)
+			sorted.push_back(&request);
+	std::sort(sorted.begin(), sorted.end(),
+	    [](const Request *lhs, const Request *rhs) {
+		if (lhs->fd != rhs->fd)
+			return (lhs->fd < rhs->fd);
+		return (lhs->offset < rhs->offset);
+	    });
+
+#ifdef HAVE_LINUX_IO_URING_H
+	if (useIOURing && isIOURingAvailable() && (sorted.size() > 1)) {
+		readWithIOURing(sorted, queueDepth);
+		return;
+	}
+#else
+	(void)useIOURing;
+#endif
+	readWithThreads(sorted, queueDepth);
+}
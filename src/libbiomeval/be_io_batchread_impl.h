@@ -0,0 +1,85 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_IO_BATCHREAD_IMPL_H__
+#define __BE_IO_BATCHREAD_IMPL_H__
+
+#include <cstdint>
+#include <vector>
+
+namespace BiometricEvaluation
+{
+	namespace IO
+	{
+		/**
+		 * @brief
+		 * Reading many regions of files with a deep queue.
+		 * @details
+		 * Used by RecordStores to service reads of many records
+		 * at once. On Linux, requests are submitted through
+		 * io_uring when the kernel permits it. Otherwise, a pool
+		 * of threads issues pread() for the requests.
+		 */
+		namespace BatchRead
+		{
+			/** Default number of reads in flight */
+			static const uint32_t DEFAULT_QUEUE_DEPTH = 32;
+
+			/** A single read of a region of an open file */
+			struct Request
+			{
+				/** Open file descriptor to read from */
+				int fd;
+				/** Offset within fd to start reading */
+				uint64_t offset;
+				/** Number of bytes to read */
+				uint64_t size;
+				/** Buffer of at least size bytes */
+				uint8_t *buffer;
+			};
+
+			/**
+			 * @brief
+			 * Fill the buffers of many read requests.
+			 * @details
+			 * Requests are issued in order of file and offset,
+			 * regardless of their order in requests.
+			 *
+			 * @param[in] requests
+			 *	Reads to perform.
+			 * @param[in] queueDepth
+			 *	Maximum number of reads in flight. Without
+			 *	io_uring, no more than one thread per CPU is
+			 *	used, and small batches are read by the
+			 *	calling thread.
+			 * @param[in] useIOURing
+			 *	Whether io_uring may be used. When false,
+			 *	requests are always serviced with pread().
+			 *
+			 * @throw Error::StrategyError
+			 *	A read failed or reached end of file.
+			 */
+			void
+			read(
+			    const std::vector<Request> &requests,
+			    uint32_t queueDepth = DEFAULT_QUEUE_DEPTH,
+			    bool useIOURing = true);
+
+			/**
+			 * @return
+			 *	Whether read() is able to use io_uring.
+			 */
+			bool
+			isIOURingAvailable();
+		}
+	}
+}
+
+#endif /* __BE_IO_BATCHREAD_IMPL_H__ */
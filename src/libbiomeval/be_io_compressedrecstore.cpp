@@ -163,3 +163,17 @@ BiometricEvaluation::IO::CompressedRecordStore::changeDescription(
 	return (this->pimpl->changeDescription(description));
 }
 
+void
+BiometricEvaluation::IO::CompressedRecordStore::setChecksumVerification(
+    bool verify)
+{
+	this->pimpl->setChecksumVerification(verify);
+}
+
+bool
+BiometricEvaluation::IO::CompressedRecordStore::getChecksumVerification()
+    const
+{
+	return (this->pimpl->getChecksumVerification());
+}
+
@@ -147,6 +147,7 @@ BiometricEvaluation::IO::CompressedRecordStore::Impl::read(
 	
 	Memory::uint8Array decompressedData = _compressor->decompress(
 	    compressedData);
+	this->verifyChecksum(key, decompressedData, decompressedData.size());
 	return (decompressedData);
 }
 
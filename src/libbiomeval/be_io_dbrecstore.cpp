@@ -146,3 +146,17 @@ BiometricEvaluation::IO::DBRecordStore::changeDescription(
 	return (this->pimpl->changeDescription(description));
 }
 
+void
+BiometricEvaluation::IO::DBRecordStore::setChecksumVerification(
+    bool verify)
+{
+	this->pimpl->setChecksumVerification(verify);
+}
+
+bool
+BiometricEvaluation::IO::DBRecordStore::getChecksumVerification()
+    const
+{
+	return (this->pimpl->getChecksumVerification());
+}
+
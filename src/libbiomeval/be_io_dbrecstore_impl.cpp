@@ -455,6 +455,7 @@ BiometricEvaluation::IO::DBRecordStore::Impl::read(
 	 * are the same.
 	 */
 	readRecordSegments(key, data);
+	this->verifyChecksum(key, data, data.size());
 	return (data);
 }
 
@@ -0,0 +1,428 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cstdlib>
+#include <string>
+
+#include "be_io_deduplicatedrecstore_impl.h"
+#include <be_error.h>
+#include <be_io_properties.h>
+#include <be_memory_autoarrayutility.h>
+#include <be_text.h>
+
+namespace BE = BiometricEvaluation;
+
+const std::string BLOB_STORE{"theBlobStore"};
+const std::string KEY_STORE{"theKeyStore"};
+const std::string REFERENCE_STORE{"theReferenceStore"};
+const std::string DIGEST_TYPE_KEY{"Digest_Type"};
+const std::string LOGICAL_SIZE_KEY{"Logical_Size"};
+const std::string UNIQUE_SIZE_KEY{"Unique_Size"};
+
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::Impl(
+    const std::string &pathname,
+    const std::string &description,
+    const RecordStore::Kind &recordStoreType,
+    const std::string &digest) :
+    RecordStore::Impl(pathname, description, RecordStore::Kind::Deduplicated),
+    _digest(digest),
+    _logicalSize(0),
+    _uniqueSize(0)
+{
+	/* Ensure the digest is supported before creating anything else */
+	(void)this->computeContentID(nullptr, 0);
+
+	this->_blobs = IO::RecordStore::createRecordStore(
+	    pathname + '/' + BLOB_STORE, description, recordStoreType);
+	this->_keys = IO::RecordStore::createRecordStore(
+	    pathname + '/' + KEY_STORE, description, recordStoreType);
+	this->_refs = IO::RecordStore::createRecordStore(
+	    pathname + '/' + REFERENCE_STORE, description, recordStoreType);
+
+	/* Store digest type */
+	std::shared_ptr<IO::Properties> props = this->getProperties();
+	props->setProperty(DIGEST_TYPE_KEY, digest);
+	props->setPropertyFromInteger(LOGICAL_SIZE_KEY, 0);
+	props->setPropertyFromInteger(UNIQUE_SIZE_KEY, 0);
+	this->setProperties(props);
+}
+
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::Impl(
+    const std::string &pathname,
+    IO::Mode mode) :
+    RecordStore::Impl(pathname, mode)
+{
+	try {
+		this->_digest = this->getProperties()->getProperty(
+		    DIGEST_TYPE_KEY);
+		this->_logicalSize = static_cast<uint64_t>(
+		    this->getPropertyAsInteger(LOGICAL_SIZE_KEY));
+		this->_uniqueSize = static_cast<uint64_t>(
+		    this->getPropertyAsInteger(UNIQUE_SIZE_KEY));
+	} catch (const Error::ObjectDoesNotExist &e) {
+		throw Error::StrategyError(e.whatString());
+	}
+	this->openBackingStores(pathname, mode);
+}
+
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::~Impl()
+{
+	try {
+		this->writePending();
+	} catch (const Error::Exception&) {
+		/* Don't throw exceptions in destructors */
+	}
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::openBackingStores(
+    const std::string &pathname,
+    IO::Mode mode)
+{
+	this->_blobs = RecordStore::openRecordStore(
+	    pathname + '/' + BLOB_STORE, mode);
+	this->_keys = RecordStore::openRecordStore(
+	    pathname + '/' + KEY_STORE, mode);
+	this->_refs = RecordStore::openRecordStore(
+	    pathname + '/' + REFERENCE_STORE, mode);
+}
+
+std::string
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::computeContentID(
+    const void *const data,
+    const uint64_t size)
+    const
+{
+	try {
+		return (Text::digest(data, size, this->_digest));
+	} catch (const Error::Exception &e) {
+		throw Error::StrategyError("Could not compute " +
+		    this->_digest + " content ID: " + e.whatString());
+	}
+}
+
+uint64_t
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::getReferenceCount(
+    const std::string &contentID)
+    const
+{
+	const auto cached = this->_refCounts.find(contentID);
+	if (cached != this->_refCounts.end())
+		return (cached->second);
+
+	uint64_t count{0};
+	if (this->_refs->containsKey(contentID)) {
+		const Memory::uint8Array buf = this->_refs->read(contentID);
+		count = static_cast<uint64_t>(strtoull(
+		    Memory::AutoArrayUtility::getString(buf, buf.size()).c_str(),
+		    nullptr, 10));
+	}
+	this->_refCounts[contentID] = count;
+	return (count);
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::setReferenceCount(
+    const std::string &contentID,
+    const uint64_t count)
+{
+	this->_refCounts[contentID] = count;
+	if (count > 1) {
+		this->_changedRefs.insert(contentID);
+		return;
+	}
+
+	/* Keep the count in step with the blob it accompanies */
+	this->_changedRefs.erase(contentID);
+	this->writeReferenceCount(contentID, count);
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::writeReferenceCount(
+    const std::string &contentID,
+    const uint64_t count)
+    const
+{
+	const bool stored = this->_refs->containsKey(contentID);
+	if (count == 0) {
+		if (stored)
+			this->_refs->remove(contentID);
+		return;
+	}
+
+	const std::string countStr = std::to_string(count);
+	if (stored)
+		this->_refs->replace(contentID, countStr.data(),
+		    countStr.size());
+	else
+		this->_refs->insert(contentID, countStr.data(),
+		    countStr.size());
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::writePending()
+    const
+{
+	if (this->getMode() == Mode::ReadOnly)
+		return;
+
+	/*
+	 * Counts are written first, so that a count in _refs is never
+	 * less than the number of keys in _keys referencing it.
+	 */
+	for (const auto &contentID : this->_changedRefs)
+		this->writeReferenceCount(contentID,
+		    this->_refCounts[contentID]);
+	this->_changedRefs.clear();
+
+	for (const auto &pending : this->_pendingKeys)
+		this->_keys->insert(pending.first, pending.second.data(),
+		    pending.second.size());
+	this->_pendingKeys.clear();
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::insert(
+    const std::string &key,
+    const void *const data,
+    const uint64_t size)
+{
+	if (this->getMode() == Mode::ReadOnly)
+		throw Error::StrategyError(RSREADONLYERROR);
+	if (!validateKeyString(key))
+		throw Error::StrategyError("Invalid key format");
+	if ((this->_pendingKeys.count(key) != 0) ||
+	    this->_keys->containsKey(key))
+		throw Error::ObjectExists(key);
+
+	/* Only new content is written now; the rest waits for sync() */
+	const std::string contentID = this->computeContentID(data, size);
+	const uint64_t refCount = this->getReferenceCount(contentID);
+	if (refCount == 0) {
+		this->_blobs->insert(contentID, data, size);
+		this->_uniqueSize += size;
+		this->setPropertyFromInteger(UNIQUE_SIZE_KEY,
+		    this->_uniqueSize);
+	}
+	this->setReferenceCount(contentID, refCount + 1);
+	this->_pendingKeys[key] = contentID;
+
+	this->_logicalSize += size;
+	this->setPropertyFromInteger(LOGICAL_SIZE_KEY, this->_logicalSize);
+	/* The blob store keeps the checksum of the content */
+	this->adjustCount(1);
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::remove(
+    const std::string &key)
+{
+	if (this->getMode() == Mode::ReadOnly)
+		throw Error::StrategyError(RSREADONLYERROR);
+
+	const std::string contentID = this->getContentID(key);
+	const uint64_t size = this->_blobs->length(contentID);
+	const uint64_t refCount = this->getReferenceCount(contentID);
+
+	if (this->_pendingKeys.erase(key) == 0)
+		this->_keys->remove(key);
+	if (refCount <= 1) {
+		this->_blobs->remove(contentID);
+		this->_uniqueSize -= size;
+		this->setPropertyFromInteger(UNIQUE_SIZE_KEY,
+		    this->_uniqueSize);
+		this->setReferenceCount(contentID, 0);
+	} else {
+		this->setReferenceCount(contentID, refCount - 1);
+	}
+
+	this->_logicalSize -= size;
+	this->setPropertyFromInteger(LOGICAL_SIZE_KEY, this->_logicalSize);
+	this->adjustCount(-1);
+}
+
+std::string
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::getContentID(
+    const std::string &key)
+    const
+{
+	const auto pending = this->_pendingKeys.find(key);
+	if (pending != this->_pendingKeys.end())
+		return (pending->second);
+
+	Memory::uint8Array buf = this->_keys->read(key);
+	return (Memory::AutoArrayUtility::getString(buf, buf.size()));
+}
+
+uint64_t
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::length(
+    const std::string &key)
+    const
+{
+	return (this->_blobs->length(this->getContentID(key)));
+}
+
+BiometricEvaluation::Memory::uint8Array
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::read(
+    const std::string &key)
+    const
+{
+	return (this->_blobs->read(this->getContentID(key)));
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::setChecksumVerification(
+    bool verify)
+{
+	this->_blobs->setChecksumVerification(verify);
+	RecordStore::Impl::setChecksumVerification(verify);
+}
+
+BiometricEvaluation::IO::RecordStore::Record
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::i_sequence(
+    bool returnData,
+    int cursor)
+{
+	/* Keys are sequenced by _keys, so it must hold every key */
+	this->writePending();
+
+	BE::IO::RecordStore::Record record;
+	/* Obtain the next key, but not data, which is the content ID */
+	record.key = this->_keys->sequenceKey(cursor);
+
+	if (returnData == true)
+		record.data = this->read(record.key);
+	return (record);
+}
+
+BiometricEvaluation::IO::RecordStore::Record
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::sequence(
+    int cursor)
+{
+	return (i_sequence(true, cursor));
+}
+
+std::string
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::sequenceKey(
+    int cursor)
+{
+	BiometricEvaluation::IO::RecordStore::Record record =
+	    i_sequence(false, cursor);
+	return (record.key);
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::setCursorAtKey(
+    const std::string &key)
+{
+	this->writePending();
+	this->_keys->setCursorAtKey(key);
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::sync()
+    const
+{
+	if (this->getMode() == Mode::ReadOnly)
+		return;
+
+	this->writePending();
+	this->_blobs->sync();
+	this->_keys->sync();
+	this->_refs->sync();
+	RecordStore::Impl::sync();
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::flush(
+    const std::string &key)
+    const
+{
+	if (this->getMode() == Mode::ReadOnly)
+		throw Error::StrategyError(RSREADONLYERROR);
+
+	const std::string contentID = this->getContentID(key);
+	this->writePending();
+	this->_keys->flush(key);
+	this->_blobs->flush(contentID);
+	this->_refs->flush(contentID);
+}
+
+void
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::move(
+    const std::string &pathname)
+{
+	if (this->getMode() == Mode::ReadOnly)
+		throw Error::StrategyError(RSREADONLYERROR);
+
+	this->writePending();
+	this->_blobs.reset();
+	this->_keys.reset();
+	this->_refs.reset();
+
+	RecordStore::Impl::move(pathname);
+	this->openBackingStores(pathname, IO::Mode::ReadWrite);
+}
+
+uint64_t
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::getSpaceUsed()
+    const
+{
+	return (this->_blobs->getSpaceUsed() + this->_keys->getSpaceUsed() +
+	    this->_refs->getSpaceUsed() + RecordStore::Impl::getSpaceUsed());
+}
+
+uint64_t
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::getUniqueCount()
+    const
+{
+	return (this->_blobs->getCount());
+}
+
+uint64_t
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::getLogicalSize()
+    const
+{
+	return (this->_logicalSize);
+}
+
+uint64_t
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::getUniqueSize()
+    const
+{
+	return (this->_uniqueSize);
+}
+
+double
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::getDeduplicationRatio()
+    const
+{
+	const uint64_t uniqueSize = this->getUniqueSize();
+	if (uniqueSize == 0)
+		return (1.0);
+	return (static_cast<double>(this->getLogicalSize()) / uniqueSize);
+}
+
+BiometricEvaluation::IO::DeduplicatedRecordStore::SpaceStatistics
+BiometricEvaluation::IO::DeduplicatedRecordStore::Impl::getSpaceStatistics()
+    const
+{
+	SpaceStatistics stats;
+	stats.spaceUsed = this->getSpaceUsed();
+	stats.logicalSize = this->getLogicalSize();
+	stats.uniqueSize = this->getUniqueSize();
+	stats.undeduplicatedSpace = stats.spaceUsed + stats.logicalSize -
+	    stats.uniqueSize;
+	stats.deduplicationRatio = this->getDeduplicationRatio();
+	if (stats.spaceUsed != 0)
+		stats.spaceRatio = static_cast<double>(
+		    stats.undeduplicatedSpace) / stats.spaceUsed;
+	return (stats);
+}
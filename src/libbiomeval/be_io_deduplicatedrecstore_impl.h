@@ -0,0 +1,316 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#ifndef __BE_IO_DEDUPLICATEDRECSTORE_IMPL_H__
+#define __BE_IO_DEDUPLICATEDRECSTORE_IMPL_H__
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include <be_io_deduplicatedrecstore.h>
+#include "be_io_recordstore_impl.h"
+
+namespace BiometricEvaluation
+{
+	namespace IO
+	{
+		/**
+		 * @brief
+		 * Implementation of DeduplicatedRecordStore.
+		 */
+		class DeduplicatedRecordStore::Impl : public RecordStore::Impl
+		{
+		public:
+			/**
+			 * Create a new DeduplicatedRecordStore, read/write
+			 * mode.
+			 *
+			 * @param[in] pathname
+			 * 	The directory where the store is to be created.
+			 * @param[in] description
+			 *	The store's description.
+			 * @param[in] recordStoreType
+			 *	The type of RecordStore subclass the internal
+			 *	RecordStores should be.
+			 * @param[in] digest
+			 *	Message digest used to compute content IDs.
+			 *
+			 * @throw Error::ObjectExists
+			 * 	The store already exists.
+			 * @throw Error::StrategyError
+			 * 	An error occurred when accessing the underlying
+			 * 	file system, or digest is not supported.
+			 */
+			Impl(
+			    const std::string &pathname,
+			    const std::string &description,
+			    const RecordStore::Kind &recordStoreType,
+			    const std::string &digest);
+
+			/**
+			 * Open an existing DeduplicatedRecordStore.
+			 *
+			 * @param[in] pathname
+			 *	The path name of the store.
+			 * @param[in] mode
+			 *	Open mode, read-only or read-write.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	The store does not exist.
+			 * @throw Error::StrategyError
+			 *	An error occurred when accessing the underlying
+			 *	file system.
+			 */
+			Impl(
+			    const std::string &pathname,
+			    IO::Mode mode = IO::Mode::ReadOnly);
+
+			/*
+			 * Destructor.
+			 */
+			~Impl();
+
+			uint64_t
+			getSpaceUsed() const;
+
+			void
+			sync() const;
+
+			void
+			insert(
+			    const std::string &key,
+			    const void *const data,
+			    const uint64_t size);
+
+			void
+			remove(
+			    const std::string &key);
+
+			Memory::uint8Array
+			read(
+			    const std::string &key) const;
+
+			/*
+			 * Content is read from the blob store, which keeps
+			 * its checksum, so it verifies the checksums.
+			 */
+			void
+			setChecksumVerification(
+			    bool verify);
+
+			uint64_t
+			length(
+			    const std::string &key) const;
+
+			void
+			flush(
+			    const std::string &key) const;
+
+			RecordStore::Record
+			sequence(
+			    int cursor = BE_RECSTORE_SEQ_NEXT);
+
+			std::string
+			sequenceKey(
+			    int cursor = BE_RECSTORE_SEQ_NEXT);
+
+			void
+			setCursorAtKey(
+			    const std::string &key);
+
+			void
+			move(
+			    const std::string &pathname);
+
+			uint64_t
+			getUniqueCount()
+			    const;
+
+			uint64_t
+			getLogicalSize()
+			    const;
+
+			uint64_t
+			getUniqueSize()
+			    const;
+
+			double
+			getDeduplicationRatio()
+			    const;
+
+			SpaceStatistics
+			getSpaceStatistics()
+			    const;
+
+			std::string
+			getContentID(
+			    const std::string &key)
+			    const;
+
+			/* Prevent copying of DeduplicatedRecordStore objects */
+			Impl(const DeduplicatedRecordStore&) = delete;
+			Impl& operator=(const Impl&) = delete;
+
+		private:
+			/** Unique values, keyed by content ID */
+			std::shared_ptr<IO::RecordStore> _blobs;
+
+			/** Content ID of each client key */
+			std::shared_ptr<IO::RecordStore> _keys;
+
+			/** Number of client keys referencing each content ID */
+			std::shared_ptr<IO::RecordStore> _refs;
+
+			/** Message digest used to compute content IDs */
+			std::string _digest;
+
+			/** Content ID of each key not yet written to _keys */
+			mutable std::unordered_map<std::string, std::string>
+			    _pendingKeys;
+
+			/**
+			 * Reference counts read from or not yet written to
+			 * _refs, keyed by content ID.
+			 */
+			mutable std::unordered_map<std::string, uint64_t>
+			    _refCounts;
+
+			/** Content IDs whose count differs from _refs */
+			mutable std::unordered_set<std::string> _changedRefs;
+
+			/** Cached Logical_Size property */
+			uint64_t _logicalSize;
+
+			/** Cached Unique_Size property */
+			uint64_t _uniqueSize;
+
+			/**
+			 * @brief
+			 * Write pending keys and changed reference counts
+			 * to the internal RecordStores.
+			 *
+			 * @throw Error::StrategyError
+			 *	An error occurred when using the underlying
+			 *	storage system.
+			 */
+			void
+			writePending()
+			    const;
+
+			/**
+			 * @brief
+			 * Open the internal RecordStores.
+			 *
+			 * @param[in] pathname
+			 *	Path name of this RecordStore.
+			 * @param[in] mode
+			 *	Open mode, read-only or read-write.
+			 */
+			void
+			openBackingStores(
+			    const std::string &pathname,
+			    IO::Mode mode);
+
+			/**
+			 * @brief
+			 * Compute the content ID of a buffer.
+			 *
+			 * @param[in] data
+			 *	Buffer to identify.
+			 * @param[in] size
+			 *	Size of data.
+			 * @return
+			 *	Content ID of data.
+			 */
+			std::string
+			computeContentID(
+			    const void *const data,
+			    const uint64_t size)
+			    const;
+
+			/**
+			 * @param[in] contentID
+			 *	Content ID of a stored value.
+			 * @return
+			 *	Number of keys that reference contentID, 0 if
+			 *	contentID is not stored.
+			 * @note
+			 * Counts read from _refs are kept in _refCounts.
+			 */
+			uint64_t
+			getReferenceCount(
+			    const std::string &contentID)
+			    const;
+
+			/**
+			 * @brief
+			 * Record the number of keys referencing a content ID.
+			 * @details
+			 * Counts of 0 and 1, which accompany removing and
+			 * storing the value, are written to _refs now.
+			 * Other counts are written by writePending().
+			 *
+			 * @param[in] contentID
+			 *	Content ID of a stored value.
+			 * @param[in] count
+			 *	Number of keys referencing contentID, or 0
+			 *	to remove the reference count.
+			 */
+			void
+			setReferenceCount(
+			    const std::string &contentID,
+			    const uint64_t count);
+
+			/**
+			 * @brief
+			 * Write the number of keys referencing a content ID
+			 * to _refs.
+			 *
+			 * @param[in] contentID
+			 *	Content ID of a stored value.
+			 * @param[in] count
+			 *	Number of keys referencing contentID, or 0
+			 *	to remove the reference count.
+			 *
+			 * @throw Error::StrategyError
+			 *	An error occurred when using the underlying
+			 *	storage system.
+			 */
+			void
+			writeReferenceCount(
+			    const std::string &contentID,
+			    const uint64_t count)
+			    const;
+
+			/**
+			 * Internal implementation of sequencing through a
+			 * store, returning the key, and optionally, the
+			 * data.
+			 * @param[in] returnData
+			 * 	Whether to return the data with the key.
+			 * @param[in] cursor
+			 *	The location within the sequence of the
+			 *	key/data pair to return.
+			 * @return
+			 *	The record that is next in sequence.
+			 * @throw Error::ObjectDoesNotExist
+			 *	End of sequencing.
+			 * @throw Error::StrategyError
+			 *	An error occurred when using the underlying
+			 *	storage system.
+			 */
+			RecordStore::Record
+			i_sequence(
+			    bool returnData,
+			    int cursor);
+		};
+	}
+}
+#endif	/* __BE_IO_DEDUPLICATEDRECSTORE_IMPL_H__ */
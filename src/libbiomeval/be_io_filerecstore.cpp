@@ -80,6 +80,14 @@ BiometricEvaluation::IO::FileRecordStore::read(
 	return (this->pimpl->read(key));
 }
 
+std::vector<BiometricEvaluation::Memory::uint8Array>
+BiometricEvaluation::IO::FileRecordStore::read(
+    const std::vector<std::string> &keys)
+    const
+{
+	return (this->pimpl->read(keys));
+}
+
 void
 BiometricEvaluation::IO::FileRecordStore::replace(
     const std::string &key,
@@ -154,3 +162,17 @@ BiometricEvaluation::IO::FileRecordStore::changeDescription(
 	return (this->pimpl->changeDescription(description));
 }
 
+void
+BiometricEvaluation::IO::FileRecordStore::setChecksumVerification(
+    bool verify)
+{
+	this->pimpl->setChecksumVerification(verify);
+}
+
+bool
+BiometricEvaluation::IO::FileRecordStore::getChecksumVerification()
+    const
+{
+	return (this->pimpl->getChecksumVerification());
+}
+
@@ -9,7 +9,15 @@
  ******************************************************************************/
 
 #include <sys/stat.h>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdio>
 #include <iostream>
 
@@ -18,6 +26,7 @@
 #include <be_io_utility.h>
 #include <be_sysdeps.h>
 
+#include "be_io_batchread_impl.h"
 #include "be_io_filerecstore_impl.h"
 
 namespace BE = BiometricEvaluation;
@@ -173,15 +182,83 @@ BiometricEvaluation::IO::FileRecordStore::Impl::read(
 		throw Error::StrategyError("Could not open " + pathname + 
 		    " (" + Error::errorStr() + ")");
 
-	Memory::uint8Array data(size);
+	Memory::uint8Array data(size, Memory::Allocation::Pooled);
 	std::size_t sz = fread(data, 1, size, fp);
 	std::fclose(fp);
 	if (sz != size)
 		throw Error::StrategyError("Could not write " + pathname + 
 		    " (" + Error::errorStr() + ")");
+	this->verifyChecksum(key, data, data.size());
 	return(data);
 }
 
+std::vector<BiometricEvaluation::Memory::uint8Array>
+BiometricEvaluation::IO::FileRecordStore::Impl::read(
+    const std::vector<std::string> &keys)
+    const
+{
+	/* Bound the number of descriptors open at once */
+	static const size_t MAX_OPEN_FILES = 256;
+
+	std::vector<Memory::uint8Array> records;
+	records.reserve(keys.size());
+	std::vector<IO::BatchRead::Request> requests;
+	for (size_t start = 0; start < keys.size(); start += MAX_OPEN_FILES) {
+		const size_t end = std::min(keys.size(),
+		    start + MAX_OPEN_FILES);
+		requests.clear();
+		try {
+			for (size_t i = start; i < end; i++) {
+				if (!validateKeyString(keys[i]))
+					throw Error::StrategyError("Invalid "
+					    "key format");
+				const std::string pathname =
+				    FileRecordStore::Impl::canonicalName(
+				    keys[i]);
+#ifdef _WIN32
+				const int fd = _open(pathname.c_str(),
+				    _O_RDONLY | _O_BINARY);
+#else
+				const int fd = ::open(pathname.c_str(),
+				    O_RDONLY);
+#endif
+				if (fd == -1) {
+					if (errno == ENOENT)
+						throw Error::ObjectDoesNotExist(
+						    keys[i]);
+					throw Error::StrategyError("Could not "
+					    "open " + pathname + " (" +
+					    Error::errorStr() + ")");
+				}
+				struct stat sb;
+				if (fstat(fd, &sb) != 0) {
+					::close(fd);
+					throw Error::StrategyError("Could not "
+					    "stat " + pathname + " (" +
+					    Error::errorStr() + ")");
+				}
+
+				records.emplace_back(sb.st_size,
+				    Memory::Allocation::Pooled);
+				requests.push_back({fd, 0,
+				    static_cast<uint64_t>(sb.st_size),
+				    records.back()});
+			}
+			IO::BatchRead::read(requests);
+		} catch (...) {
+			for (const auto &request : requests)
+				::close(request.fd);
+			throw;
+		}
+		for (const auto &request : requests)
+			::close(request.fd);
+	}
+
+	for (size_t i = 0; i < keys.size(); i++)
+		this->verifyChecksum(keys[i], records[i], records[i].size());
+	return (records);
+}
+
 void
 BiometricEvaluation::IO::FileRecordStore::Impl::replace(
     const std::string &key,
@@ -202,6 +279,7 @@ BiometricEvaluation::IO::FileRecordStore::Impl::replace(
 	} catch (Error::StrategyError& e) {
 		throw;
 	}
+	this->updateChecksum(key, data, size);
 }
 
 uint64_t
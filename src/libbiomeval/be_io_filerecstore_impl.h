@@ -87,6 +87,9 @@ namespace BiometricEvaluation {
 			Memory::uint8Array read(
 			    const std::string &key) const;
 
+			std::vector<Memory::uint8Array> read(
+			    const std::vector<std::string> &keys) const;
+
 			void replace(
 			    const std::string &key,
 			    const void *const data,
@@ -64,6 +64,14 @@ BiometricEvaluation::IO::ListRecordStore::Impl::read(
 	return (this->_sourceRecordStore->read(key));
 }
 
+void
+BiometricEvaluation::IO::ListRecordStore::Impl::setChecksumVerification(
+    bool verify)
+{
+	this->_sourceRecordStore->setChecksumVerification(verify);
+	RecordStore::Impl::setChecksumVerification(verify);
+}
+
 uint64_t
 BiometricEvaluation::IO::ListRecordStore::Impl::length(
     const std::string &key)
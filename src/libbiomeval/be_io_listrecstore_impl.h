@@ -56,6 +56,13 @@ namespace BiometricEvaluation
 			uint64_t
 			getSpaceUsed() const;
 
+			/*
+			 * Records are read from the source RecordStore, so
+			 * it verifies their checksums.
+			 */
+			void
+			setChecksumVerification(bool verify);
+
 			/**
 			 * @brief
 			 * Called from CRUD methods to stop execution and
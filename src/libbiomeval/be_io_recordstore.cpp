@@ -8,6 +8,11 @@
  * about its quality, reliability, or any other characteristic.
  ******************************************************************************/
 
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+#include "be_io_batchread_impl.h"
 #include "be_io_recordstore_impl.h"
 #include <be_io_recordstore.h>
 
@@ -39,7 +44,9 @@ BE_IO_RecordStore_Kind_EnumToStringMap = {
 	{BiometricEvaluation::IO::RecordStore::Kind::File, "File"},
 	{BiometricEvaluation::IO::RecordStore::Kind::SQLite, "SQLite"},
 	{BiometricEvaluation::IO::RecordStore::Kind::Compressed, "Compressed"},
-	{BiometricEvaluation::IO::RecordStore::Kind::List, "List"}
+	{BiometricEvaluation::IO::RecordStore::Kind::List, "List"},
+	{BiometricEvaluation::IO::RecordStore::Kind::Deduplicated,
+	    "Deduplicated"}
 };
 BE_FRAMEWORK_ENUMERATION_DEFINITIONS(
     BiometricEvaluation::IO::RecordStore::Kind,
@@ -77,6 +84,18 @@ BiometricEvaluation::IO::RecordStore::replace(
 	this->insert(key, data, size);
 }
 
+std::vector<BiometricEvaluation::Memory::uint8Array>
+BiometricEvaluation::IO::RecordStore::read(
+    const std::vector<std::string> &keys)
+    const
+{
+	std::vector<Memory::uint8Array> records;
+	records.reserve(keys.size());
+	for (const auto &key : keys)
+		records.push_back(this->read(key));
+	return (records);
+}
+
 bool
 BiometricEvaluation::IO::RecordStore::containsKey(
     const std::string &key) const
@@ -90,6 +109,114 @@ BiometricEvaluation::IO::RecordStore::containsKey(
 	return (true);
 }
 
+void
+BiometricEvaluation::IO::RecordStore::setChecksumVerification(
+    bool verify)
+{
+	if (verify)
+		throw Error::NotImplemented("Checksum verification");
+}
+
+bool
+BiometricEvaluation::IO::RecordStore::getChecksumVerification()
+    const
+{
+	return (false);
+}
+
+std::vector<std::string>
+BiometricEvaluation::IO::RecordStore::verify(
+    uint32_t numThreads)
+    const
+{
+	/* Ensure independent instances see every record */
+	this->sync();
+
+	/* Enumerate keys without disturbing this object's cursor */
+	std::vector<std::string> keys;
+	try {
+		auto rs = IO::RecordStore::openRecordStore(this->getPathname(),
+		    IO::Mode::ReadOnly);
+		keys.reserve(rs->getCount());
+		int cursor = BE_RECSTORE_SEQ_START;
+		while (true) {
+			try {
+				keys.push_back(rs->sequenceKey(cursor));
+			} catch (const Error::ObjectDoesNotExist&) {
+				break;
+			}
+			cursor = BE_RECSTORE_SEQ_NEXT;
+		}
+	} catch (const Error::ObjectDoesNotExist &e) {
+		throw Error::StrategyError(e.whatString());
+	}
+
+	if (numThreads == 0)
+		numThreads = std::thread::hardware_concurrency();
+	numThreads = std::max<uint32_t>(1, std::min<uint64_t>(numThreads,
+	    keys.size()));
+
+	/*
+	 * Each thread verifies a contiguous range of keys, so that
+	 * backing storage is read mostly sequentially.
+	 */
+	std::vector<char> failed(keys.size(), false);
+	std::vector<std::exception_ptr> errors(numThreads);
+	const auto verifyRange = [&](const uint32_t thread) {
+		const uint64_t first = (keys.size() * thread) / numThreads;
+		const uint64_t last = (keys.size() * (thread + 1)) /
+		    numThreads;
+		try {
+			auto rs = IO::RecordStore::openRecordStore(
+			    this->getPathname(), IO::Mode::ReadOnly);
+			rs->setChecksumVerification(true);
+			for (uint64_t i = first; i < last; i++) {
+				try {
+					(void)rs->read(keys[i]);
+				} catch (const Error::DataError&) {
+					failed[i] = true;
+				} catch (const Error::ObjectDoesNotExist&) {
+					failed[i] = true;
+				} catch (const Error::StrategyError&) {
+					failed[i] = true;
+				}
+			}
+		} catch (...) {
+			errors[thread] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	try {
+		for (uint32_t i = 1; i < numThreads; i++)
+			threads.emplace_back(verifyRange, i);
+	} catch (...) {
+		/* Threads already started reference keys and failed */
+		for (auto &thread : threads)
+			thread.join();
+		throw;
+	}
+	verifyRange(0);
+	for (auto &thread : threads)
+		thread.join();
+
+	for (const auto &error : errors) {
+		if (!error)
+			continue;
+		try {
+			std::rethrow_exception(error);
+		} catch (const Error::Exception &e) {
+			throw Error::StrategyError(e.whatString());
+		}
+	}
+
+	std::vector<std::string> badKeys;
+	for (uint64_t i = 0; i < keys.size(); i++)
+		if (failed[i])
+			badKeys.push_back(keys[i]);
+	return (badKeys);
+}
+
 std::shared_ptr<BiometricEvaluation::IO::RecordStore>
 BiometricEvaluation::IO::RecordStore::openRecordStore(
     const std::string &pathname,
@@ -151,7 +278,8 @@ BiometricEvaluation::IO::RecordStoreIterator::RecordStoreIterator(
     BiometricEvaluation::IO::RecordStore *recordStore,
     bool atEnd) :
     _recordStore{recordStore},
-    _atEnd{atEnd}
+    _atEnd{atEnd},
+    _prefetched{std::make_shared<std::deque<value_type>>()}
 {
 	if (_atEnd)
 		this->setEnd();
@@ -234,17 +362,26 @@ BiometricEvaluation::IO::RecordStoreIterator::step(
 	if (numSteps <= 0)
 		return;
 
+	/* Skip records already read ahead */
+	while ((numSteps > 1) && !this->_prefetched->empty()) {
+		this->_prefetched->pop_front();
+		numSteps--;
+	}
+
 	/* Forward one step */
 	if (numSteps == 1) {
-		try {
-			this->_currentRecord = this->_recordStore->sequence();
-		} catch (const Error::ObjectDoesNotExist&) {
+		if (this->_prefetched->empty())
+			this->prefetch();
+		if (this->_prefetched->empty()) {
 			this->setEnd();
+			return;
 		}
+		this->_currentRecord = std::move(this->_prefetched->front());
+		this->_prefetched->pop_front();
 		return;
 	}
 
-	/* Forward 2..n steps */
+	/* Forward 2..n steps, past anything read ahead */
 	std::string key;
 	for (difference_type i = 0; i < numSteps; i++) {
 		try {
@@ -260,6 +397,32 @@ BiometricEvaluation::IO::RecordStoreIterator::step(
 	this->_currentRecord = RecordStore::Record(key, data);
 }
 
+void
+BiometricEvaluation::IO::RecordStoreIterator::prefetch()
+{
+	/* Enough records to keep a batch read's queue full */
+	static const size_t PrefetchDepth =
+	    IO::BatchRead::DEFAULT_QUEUE_DEPTH;
+
+	std::vector<std::string> keys;
+	keys.reserve(PrefetchDepth);
+	try {
+		while (keys.size() < PrefetchDepth)
+			keys.push_back(this->_recordStore->sequenceKey());
+	} catch (const Error::ObjectDoesNotExist&) {
+		/* End of the RecordStore */
+	}
+	if (keys.empty())
+		return;
+
+	auto records = this->_recordStore->read(keys);
+	for (size_t i = 0; i < keys.size(); i++) {
+		this->_prefetched->emplace_back();
+		this->_prefetched->back().key = std::move(keys[i]);
+		this->_prefetched->back().data = std::move(records[i]);
+	}
+}
+
 void
 BiometricEvaluation::IO::RecordStoreIterator::setEnd()
 {
@@ -13,8 +13,10 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 
+#include <cstdio>
 #include <iostream>
 #include <fstream>
+#include <iomanip>
 #include <sstream>
 
 #include <be_error.h>
@@ -25,6 +27,7 @@
 #include <be_io_compressedrecstore.h>
 #include <be_io_compressor.h>
 #include <be_io_dbrecstore.h>
+#include <be_io_deduplicatedrecstore.h>
 #include <be_io_filerecstore.h>
 #include <be_io_listrecstore.h>
 #include <be_io_propertiesfile.h>
@@ -32,6 +35,7 @@
 #include <be_io_utility.h>
 #include <be_memory_autoarray.h>
 #include <be_sysdeps.h>
+#include <be_text.h>
 
 
 namespace BE = BiometricEvaluation;
@@ -46,6 +50,13 @@ static const std::string DESCRIPTIONPROPERTY("Description");
 static const std::string COUNTPROPERTY("Count");
 static const std::string TYPEPROPERTY("Type");
 
+/** Journal of the checksum of every record */
+static const std::string CHECKSUMFILENAME(".rschecksums");
+/** Checksum journal prefix of a removed record */
+static const char CHECKSUMREMOVED = '-';
+/** Size in bytes of a checksum journal worth compacting */
+static const uint64_t CHECKSUMCOMPACTSIZE = 1024 * 1024;
+
 /** Error message when trying to change a core property */
 static const std::string COREPROPERTYERROR("Cannot change core properties");
 
@@ -61,7 +72,10 @@ BiometricEvaluation::IO::RecordStore::Impl::Impl(
     const BE::IO::RecordStore::Kind &kind) :
     _pathname(pathname),
     _cursor(RecordStore::BE_RECSTORE_SEQ_START),
-    _mode(IO::Mode::ReadWrite)
+    _mode(IO::Mode::ReadWrite),
+    _verifyChecksums(false),
+    _checksumsLoaded(false),
+    _journalEntries(0)
 {
 	if (IO::Utility::fileExists(pathname))
 		throw Error::ObjectExists(pathname + " already exists");
@@ -90,7 +104,10 @@ BiometricEvaluation::IO::RecordStore::Impl::Impl(
     IO::Mode mode) :
     _pathname(pathname),
     _cursor(RecordStore::BE_RECSTORE_SEQ_START),
-    _mode(mode)
+    _mode(mode),
+    _verifyChecksums(false),
+    _checksumsLoaded(false),
+    _journalEntries(0)
 {
 	if (!IO::Utility::fileExists(pathname))
 		throw Error::ObjectDoesNotExist("Could not find " + pathname);
@@ -128,14 +145,32 @@ BiometricEvaluation::IO::RecordStore::Impl::insert(
     const void *const data,
     const uint64_t size)
 {
-	_props->setPropertyFromInteger(COUNTPROPERTY, this->getCount() + 1);
+	this->updateChecksum(key, data, size);
+	this->adjustCount(1);
 }
 
 void
 BiometricEvaluation::IO::RecordStore::Impl::remove(
     const std::string &key)
 {
-	_props->setPropertyFromInteger(COUNTPROPERTY, this->getCount() - 1);
+	this->appendChecksumJournal(CHECKSUMREMOVED + (' ' + key));
+	if (this->_checksumsLoaded)
+		this->_checksums.erase(key);
+	this->adjustCount(-1);
+}
+
+void
+BiometricEvaluation::IO::RecordStore::Impl::setChecksumVerification(
+    bool verify)
+{
+	this->_verifyChecksums = verify;
+}
+
+bool
+BiometricEvaluation::IO::RecordStore::Impl::getChecksumVerification()
+    const
+{
+	return (this->_verifyChecksums);
 }
 
 int
@@ -153,11 +188,25 @@ BiometricEvaluation::IO::RecordStore::Impl::setCursor(int cursor)
 uint64_t
 BiometricEvaluation::IO::RecordStore::Impl::getSpaceUsed() const
 {
+	uint64_t spaceUsed{0};
 	try {
-		return (BE::IO::Utility::getFileSize(this->_controlFile));
+		spaceUsed = BE::IO::Utility::getFileSize(this->_controlFile);
 	} catch (const BE::Error::StrategyError& e) {
 		throw Error::StrategyError("Could not get size of control file: " + e.whatString());
 	}
+
+	const std::string journal{this->canonicalName(CHECKSUMFILENAME)};
+	if (IO::Utility::fileExists(journal)) {
+		if (this->_checksumJournal.is_open())
+			this->_checksumJournal.flush();
+		try {
+			spaceUsed += BE::IO::Utility::getFileSize(journal);
+		} catch (const BE::Error::StrategyError& e) {
+			throw Error::StrategyError("Could not get size of "
+			    "checksum journal: " + e.whatString());
+		}
+	}
+	return (spaceUsed);
 }
 
 void
@@ -171,6 +220,14 @@ BiometricEvaluation::IO::RecordStore::Impl::sync() const
 	} catch (Error::Exception& e) {
 		throw Error::StrategyError(e.whatString());
 	}
+
+	if (this->_checksumJournal.is_open()) {
+		this->_checksumJournal.flush();
+		if (!this->_checksumJournal)
+			throw Error::StrategyError("Could not sync checksum "
+			    "journal");
+		this->compactChecksumJournal();
+	}
 }
 
 unsigned int
@@ -203,6 +260,8 @@ BiometricEvaluation::IO::RecordStore::Impl::move(const std::string &pathname)
 	/* Sync the old data first */
 	_props->sync();
 	_props.reset();
+	if (this->_checksumJournal.is_open())
+		this->_checksumJournal.close();
 
 	/* Rename the directory */
 	if (rename(this->_pathname.c_str(), pathname.c_str()))
@@ -267,6 +326,8 @@ BiometricEvaluation::IO::RecordStore::Impl::openRecordStore(
 		rs = new ArchiveRecordStore(pathname, mode);
 	else if (type == to_string(RecordStore::Kind::Compressed))
 		rs = new CompressedRecordStore(pathname, mode);
+	else if (type == to_string(RecordStore::Kind::Deduplicated))
+		rs = new DeduplicatedRecordStore(pathname, mode);
 	else if (type == to_string(RecordStore::Kind::List)) {
 		if (mode == IO::Mode::ReadWrite)
 			throw Error::StrategyError("ListRecordStores cannot "
@@ -303,6 +364,10 @@ BiometricEvaluation::IO::RecordStore::Impl::createRecordStore(
 		rs = new CompressedRecordStore(pathname, description,
 		    RecordStore::Kind::Default, IO::Compressor::Kind::GZIP);
 		break;
+	case BE::IO::RecordStore::Kind::Deduplicated:
+		rs = new DeduplicatedRecordStore(pathname, description,
+		    RecordStore::Kind::Archive);
+		break;
 	case BE::IO::RecordStore::Kind::List:
 		throw Error::StrategyError("ListRecordStores cannot be "
 		    "created with this function");
@@ -347,6 +412,8 @@ BiometricEvaluation::IO::RecordStore::Impl::mergeRecordStores(
 		case BiometricEvaluation::IO::RecordStore::Kind::File:
 			/* FALLTHROUGH */
 		case BiometricEvaluation::IO::RecordStore::Kind::SQLite:
+			/* FALLTHROUGH */
+		case BiometricEvaluation::IO::RecordStore::Kind::Deduplicated:
 			merged_rs = RecordStore::createRecordStore(
 			   mergePathname, description, kind);
 			break;
@@ -388,6 +455,50 @@ BiometricEvaluation::IO::RecordStore::Impl::getMode() const
 	return (_mode);
 }
 
+void
+BiometricEvaluation::IO::RecordStore::Impl::adjustCount(
+    const int64_t delta)
+{
+	_props->setPropertyFromInteger(COUNTPROPERTY, this->getCount() + delta);
+}
+
+void
+BiometricEvaluation::IO::RecordStore::Impl::updateChecksum(
+    const std::string &key,
+    const void *const data,
+    const uint64_t size)
+{
+	const uint32_t checksum = Text::crc32c(data, size);
+
+	std::ostringstream entry;
+	entry << std::hex << std::setw(8) << std::setfill('0') << checksum <<
+	    ' ' << key;
+	this->appendChecksumJournal(entry.str());
+	if (this->_checksumsLoaded)
+		this->_checksums[key] = checksum;
+}
+
+void
+BiometricEvaluation::IO::RecordStore::Impl::verifyChecksum(
+    const std::string &key,
+    const void *const data,
+    const uint64_t size)
+    const
+{
+	if (!this->_verifyChecksums)
+		return;
+	if (!this->_checksumsLoaded)
+		this->loadChecksums();
+
+	/* Records inserted before checksums were kept can't be verified */
+	const auto entry = this->_checksums.find(key);
+	if (entry == this->_checksums.end())
+		return;
+
+	if (Text::crc32c(data, size) != entry->second)
+		throw Error::DataError("Checksum mismatch for " + key);
+}
+
 bool
 BiometricEvaluation::IO::RecordStore::Impl::validateKeyString(
     const std::string &key)
@@ -472,6 +583,27 @@ BiometricEvaluation::IO::RecordStore::Impl::setProperties(
 	_props->sync();
 }
 
+void
+BiometricEvaluation::IO::RecordStore::Impl::setPropertyFromInteger(
+    const std::string &property,
+    int64_t value)
+{
+	if (this->getMode() == Mode::ReadOnly)
+		throw Error::StrategyError(RSREADONLYERROR);
+	if (isKeyCoreProperty(property))
+		throw Error::StrategyError(COREPROPERTYERROR);
+
+	_props->setPropertyFromInteger(property, value);
+}
+
+int64_t
+BiometricEvaluation::IO::RecordStore::Impl::getPropertyAsInteger(
+    const std::string &property)
+    const
+{
+	return (_props->getPropertyAsInteger(property));
+}
+
 /*
  * Private methods.
  */
@@ -528,3 +660,113 @@ BiometricEvaluation::IO::RecordStore::Impl::openControlFile()
 	}
 }
 
+void
+BiometricEvaluation::IO::RecordStore::Impl::loadChecksums()
+    const
+{
+	this->_checksums.clear();
+
+	const std::string journal{this->canonicalName(CHECKSUMFILENAME)};
+	if (IO::Utility::fileExists(journal)) {
+		if (this->_checksumJournal.is_open())
+			this->_checksumJournal.flush();
+
+		std::ifstream journalStream(journal);
+		if (!journalStream)
+			throw Error::StrategyError("Could not open " + journal);
+
+		/* Entries are "checksum key" or "- key", latest wins */
+		std::string line;
+		this->_journalEntries = 0;
+		while (std::getline(journalStream, line)) {
+			this->_journalEntries++;
+			const auto space = line.find(' ');
+			if ((space == std::string::npos) ||
+			    (space + 1 == line.length()))
+				throw Error::StrategyError("Invalid checksum "
+				    "journal entry: " + line);
+			const std::string key = line.substr(space + 1);
+			if (line[0] == CHECKSUMREMOVED) {
+				this->_checksums.erase(key);
+				continue;
+			}
+
+			try {
+				this->_checksums[key] = static_cast<uint32_t>(
+				    std::stoul(line.substr(0, space), nullptr,
+				    16));
+			} catch (const std::exception&) {
+				throw Error::StrategyError("Invalid checksum "
+				    "journal entry: " + line);
+			}
+		}
+		if (journalStream.bad())
+			throw Error::StrategyError("Could not read " + journal);
+	}
+
+	this->_checksumsLoaded = true;
+}
+
+void
+BiometricEvaluation::IO::RecordStore::Impl::appendChecksumJournal(
+    const std::string &entry)
+{
+	if (!this->_checksumJournal.is_open()) {
+		this->_checksumJournal.clear();
+		this->_checksumJournal.open(
+		    this->canonicalName(CHECKSUMFILENAME),
+		    std::ios_base::out | std::ios_base::app);
+		if (!this->_checksumJournal)
+			throw Error::StrategyError("Could not open checksum "
+			    "journal");
+	}
+
+	this->_checksumJournal << entry << '\n';
+	if (!this->_checksumJournal)
+		throw Error::StrategyError("Could not write checksum journal");
+	this->_journalEntries++;
+}
+
+void
+BiometricEvaluation::IO::RecordStore::Impl::compactChecksumJournal()
+    const
+{
+	/* Reading the journal is only worthwhile if it will be used */
+	if (!this->_verifyChecksums)
+		return;
+
+	const std::string journal{this->canonicalName(CHECKSUMFILENAME)};
+	try {
+		if (IO::Utility::getFileSize(journal) < CHECKSUMCOMPACTSIZE)
+			return;
+	} catch (const Error::ObjectDoesNotExist&) {
+		return;
+	}
+	if (!this->_checksumsLoaded)
+		this->loadChecksums();
+
+	/* Rewriting is linear in the live entries, so amortize it */
+	const uint64_t liveEntries = this->_checksums.size();
+	if (this->_journalEntries <= liveEntries * 2)
+		return;
+
+	const std::string compacted{journal + ".new"};
+	{
+		std::ofstream compactedStream(compacted,
+		    std::ios_base::out | std::ios_base::trunc);
+		for (const auto &checksum : this->_checksums)
+			compactedStream << std::hex << std::setw(8) <<
+			    std::setfill('0') << checksum.second << ' ' <<
+			    checksum.first << '\n';
+		compactedStream.flush();
+		if (!compactedStream)
+			throw Error::StrategyError("Could not write " +
+			    compacted);
+	}
+
+	this->_checksumJournal.close();
+	if (std::rename(compacted.c_str(), journal.c_str()) != 0)
+		throw Error::StrategyError("Could not replace " + journal +
+		    " (" + Error::errorStr() + ")");
+	this->_journalEntries = liveEntries;
+}
@@ -10,8 +10,10 @@
 #ifndef __BE_IO_RECORDSTORE_IMPL_H__
 #define __BE_IO_RECORDSTORE_IMPL_H__
 
+#include <fstream>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <be_io_propertiesfile.h>
@@ -145,6 +147,27 @@ namespace BiometricEvaluation {
 			void remove(
 			    const std::string &key);
 
+			/**
+			 * @brief
+			 * Set whether checksums are verified when records
+			 * are read.
+			 *
+			 * @param[in] verify
+			 *	true to verify checksums, false otherwise.
+			 */
+			void
+			setChecksumVerification(
+			    bool verify);
+
+			/**
+			 * @return
+			 *	Whether checksums are verified when records
+			 *	are read.
+			 */
+			bool
+			getChecksumVerification()
+			    const;
+
 			/**
 			 * @brief
 			 * Open an existing RecordStore and return a managed
@@ -364,6 +387,117 @@ namespace BiometricEvaluation {
 			std::shared_ptr<IO::Properties>
 			getProperties()
 			    const;
+
+			/**
+			 * @brief
+			 * Set a single integer property in the RecordStore
+			 * control file.
+			 * @details
+			 * Unlike setProperties(), the control file is not
+			 * rewritten immediately, so this may be called for
+			 * every record. The value is written on sync().
+			 *
+			 * @param[in] property
+			 *	Name of the property. Must not be a core
+			 *	property.
+			 * @param[in] value
+			 *	Value of the property.
+			 *
+			 * @throw Error::StrategyError
+			 *	RecordStore was opened ReadOnly, or property
+			 *	is a core property.
+			 */
+			void
+			setPropertyFromInteger(
+			    const std::string &property,
+			    int64_t value);
+
+			/**
+			 * @brief
+			 * Obtain a single integer property from the
+			 * RecordStore control file.
+			 *
+			 * @param[in] property
+			 *	Name of the property.
+			 *
+			 * @return
+			 *	Value of property.
+			 *
+			 * @throw Error::ObjectDoesNotExist
+			 *	property does not exist.
+			 * @throw Error::ConversionError
+			 *	Value of property is not an integer.
+			 */
+			int64_t
+			getPropertyAsInteger(
+			    const std::string &property)
+			    const;
+
+			/**
+			 * @brief
+			 * Change the number of records in the store.
+			 * @details
+			 * Called by insert() and remove(). Implementations
+			 * whose checksums are kept by a backing RecordStore
+			 * call this method instead.
+			 *
+			 * @param[in] delta
+			 *	Number of records added, or removed when
+			 *	negative.
+			 */
+			void
+			adjustCount(
+			    const int64_t delta);
+
+			/**
+			 * @brief
+			 * Record the checksum of a record's data.
+			 * @details
+			 * Called by insert(). Implementations that modify
+			 * a record without insert() must call this method.
+			 *
+			 * @param[in] key
+			 *	Key of the record.
+			 * @param[in] data
+			 *	Data stored for key.
+			 * @param[in] size
+			 *	Size of data.
+			 *
+			 * @throw Error::StrategyError
+			 *	Could not write the checksum journal.
+			 */
+			void
+			updateChecksum(
+			    const std::string &key,
+			    const void *const data,
+			    const uint64_t size);
+
+			/**
+			 * @brief
+			 * Compare a record read from storage against the
+			 * checksum computed when it was inserted.
+			 * @details
+			 * Does nothing if checksum verification is disabled
+			 * or no checksum was recorded for key.
+			 *
+			 * @param[in] key
+			 *	Key of the record.
+			 * @param[in] data
+			 *	Data read for key.
+			 * @param[in] size
+			 *	Size of data.
+			 *
+			 * @throw Error::DataError
+			 *	data does not match the recorded checksum.
+			 * @throw Error::StrategyError
+			 *	Could not read the checksum journal.
+			 */
+			void
+			verifyChecksum(
+			    const std::string &key,
+			    const void *const data,
+			    const uint64_t size)
+			    const;
 			
 		private:
 			/** Properties of the RecordStore */
@@ -388,7 +522,69 @@ namespace BiometricEvaluation {
 			 * Mode in which the RecordStore was opened.
 			 */
 			BiometricEvaluation::IO::Mode _mode;
-			
+
+			/** Whether read records are checked against _checksums */
+			bool _verifyChecksums;
+
+			/** Whether _checksums has been read from the journal */
+			mutable bool _checksumsLoaded;
+
+			/** CRC-32C of every record, keyed by record key */
+			mutable std::unordered_map<std::string, uint32_t>
+			    _checksums;
+
+			/** Append-only journal of checksum changes */
+			mutable std::ofstream _checksumJournal;
+
+			/**
+			 * Number of entries in the checksum journal,
+			 * known once _checksums has been loaded.
+			 */
+			mutable uint64_t _journalEntries;
+
+			/**
+			 * @brief
+			 * Read the checksum journal into _checksums.
+			 *
+			 * @throw Error::StrategyError
+			 *	The journal could not be read or is corrupt.
+			 */
+			void
+			loadChecksums()
+			    const;
+
+			/**
+			 * @brief
+			 * Append an entry to the checksum journal.
+			 *
+			 * @param[in] entry
+			 *	Line to append, without newline.
+			 *
+			 * @throw Error::StrategyError
+			 *	The journal could not be written.
+			 */
+			void
+			appendChecksumJournal(
+			    const std::string &entry);
+
+			/**
+			 * @brief
+			 * Rewrite the checksum journal with only the
+			 * latest entry of each record.
+			 * @details
+			 * Called by sync(). Does nothing unless checksums
+			 * are verified, the journal is at least
+			 * CHECKSUMCOMPACTSIZE bytes, and superseded
+			 * entries outnumber the live entries. _checksums
+			 * is loaded once and kept up to date afterward.
+			 *
+			 * @throw Error::StrategyError
+			 *	The journal could not be read or rewritten.
+			 */
+			void
+			compactChecksumJournal()
+			    const;
+
 			/**
 			 * @brief
 			 * Ensure all required RecordStore Property keys are
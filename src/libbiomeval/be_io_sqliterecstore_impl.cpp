@@ -359,6 +359,7 @@ BiometricEvaluation::IO::SQLiteRecordStore::Impl::read(
 	BiometricEvaluation::Memory::uint8Array data;
 	data.resize(this->length(key));
 	this->readSegments(key, data);
+	this->verifyChecksum(key, data, data.size());
 	return(data);
 }
 
@@ -547,6 +548,10 @@ BiometricEvaluation::IO::SQLiteRecordStore::Impl::i_sequence(
 			record.data.copy(
 				(uint8_t *)sqlite3_column_blob(_sequencer, 1),
 				bytes);
+			/* Only the first segment is returned here */
+			if (bytes < MAX_REC_SIZE)
+				this->verifyChecksum(record.key, record.data,
+				    record.data.size());
 		}
 		break;
 	} case SQLITE_DONE:
@@ -21,6 +21,12 @@
 #include <list>
 #include <sstream>
 
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include <be_error.h>
 #ifndef _WIN32
 #include <be_error_signal_manager.h>
@@ -363,6 +369,36 @@ BiometricEvaluation::IO::Utility::readFile(
 	return (contents);
 }
 
+BiometricEvaluation::Memory::ByteSpan
+BiometricEvaluation::IO::Utility::mapFile(
+    const std::string &path)
+{
+#ifdef _WIN32
+	return (Memory::ByteSpan::share(readFile(path)));
+#else
+	const uint64_t size = getFileSize(path);
+	if (size == 0)
+		return (Memory::ByteSpan());
+
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		throw Error::StrategyError("Could not open " + path + ": " +
+		    Error::errorStr());
+	void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	const std::string error = Error::errorStr();
+	close(fd);
+	if (data == MAP_FAILED)
+		throw Error::StrategyError("Could not map " + path + ": " +
+		    error);
+
+	/* Unmap when the last span sharing the mapping is destroyed */
+	const std::shared_ptr<const void> mapping(data, [size](void *p) {
+		munmap(p, size); });
+	return (Memory::ByteSpan(static_cast<const uint8_t *>(data), size,
+	    mapping));
+#endif
+}
+
 void
 BiometricEvaluation::IO::Utility::writeFile(
     const uint8_t *data,
@@ -283,7 +283,7 @@ BiometricEvaluation::Iris::INCITSView::readIrisView(
 	uval32 = buf.scanBeU32Val();	/* image length */
 	BE::Memory::uint8Array imageData(uval32);
 	buf.scan(&imageData[0], uval32);
-	this->setImageData(imageData);
+	this->setImageData(BE::Memory::ByteSpan::share(std::move(imageData)));
 }
 
 /******************************************************************************/
@@ -24,13 +24,29 @@ BiometricEvaluation::Latent::AN2KView::AN2KView(
 }
 
 BiometricEvaluation::Latent::AN2KView::AN2KView(
-    Memory::uint8Array &buf,
+    const Memory::ByteSpan &buf,
     const uint32_t recordNumber) :
     AN2KViewVariableResolution(buf, RecordType::Type_13, recordNumber)
 {
 	/* Parent classes handle all fields */
 }
 
+BiometricEvaluation::Latent::AN2KView::AN2KView(
+    const Memory::uint8Array &buf,
+    const uint32_t recordNumber) :
+    AN2KView(Memory::ByteSpan(buf), recordNumber)
+{
+
+}
+
+BiometricEvaluation::Latent::AN2KView::AN2KView(
+    const std::shared_ptr<const ANSI_NIST> &an2k,
+    const uint32_t recordNumber) :
+    AN2KViewVariableResolution(an2k, RecordType::Type_13, recordNumber)
+{
+	/* Parent classes handle all fields */
+}
+
 /******************************************************************************/
 /* Public functions.                                                          */
 /******************************************************************************/
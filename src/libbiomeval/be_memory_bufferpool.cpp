@@ -0,0 +1,194 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+#include <be_error_exception.h>
+#include <be_memory_bufferpool.h>
+
+namespace BE = BiometricEvaluation;
+
+/** Smallest size class; smaller buffers are rounded up to it */
+static const uint64_t MIN_CLASS_SIZE = 256;
+
+namespace
+{
+	/** Buffers cached by a single thread */
+	class Pool
+	{
+	public:
+		~Pool();
+
+		/** Released buffers, by size class */
+		std::unordered_map<uint64_t, std::vector<void *>> buffers;
+		/** Total bytes in buffers */
+		uint64_t cachedSize{0};
+		/** Maximum value of cachedSize */
+		uint64_t cacheLimit{BE::Memory::BufferPool::DEFAULT_CACHE_LIMIT};
+
+		void
+		clear();
+	};
+
+	/*
+	 * Buffers may be released by other thread_local destructors
+	 * after this thread's Pool has been destroyed.
+	 */
+	thread_local bool poolDestroyed = false;
+
+	Pool &
+	getPool()
+	{
+		thread_local Pool pool;
+		return (pool);
+	}
+}
+
+Pool::~Pool()
+{
+	this->clear();
+	poolDestroyed = true;
+}
+
+void
+Pool::clear()
+{
+	for (auto &sizeClass : this->buffers)
+		for (void *buffer : sizeClass.second)
+			::operator delete(buffer);
+	this->buffers.clear();
+	this->cachedSize = 0;
+}
+
+/** @return Largest power of two less than or equal to value (> 0) */
+static uint64_t
+floorPowerOfTwo(
+    uint64_t value)
+{
+	uint64_t power = 1;
+	while ((value >>= 1) != 0)
+		power <<= 1;
+	return (power);
+}
+
+/** @return Smallest size class holding at least size bytes */
+static uint64_t
+ceilSizeClass(
+    uint64_t size)
+{
+	if (size <= MIN_CLASS_SIZE)
+		return (MIN_CLASS_SIZE);
+
+	const uint64_t power = floorPowerOfTwo(size - 1);
+	const uint64_t step = power / 4;
+	return (power + (((size - power + step - 1) / step) * step));
+}
+
+/** @return Largest size class not exceeding size bytes, or 0 */
+static uint64_t
+floorSizeClass(
+    uint64_t size)
+{
+	if (size < MIN_CLASS_SIZE)
+		return (0);
+
+	const uint64_t power = floorPowerOfTwo(size);
+	const uint64_t step = power / 4;
+	return (power + (((size - power) / step) * step));
+}
+
+void *
+BiometricEvaluation::Memory::BufferPool::allocate(
+    uint64_t size,
+    uint64_t &capacity)
+{
+	capacity = ceilSizeClass(size);
+
+	if (!poolDestroyed) {
+		Pool &pool = getPool();
+		const auto sizeClass = pool.buffers.find(capacity);
+		if ((sizeClass != pool.buffers.end()) &&
+		    !sizeClass->second.empty()) {
+			void *buffer = sizeClass->second.back();
+			sizeClass->second.pop_back();
+			pool.cachedSize -= capacity;
+			return (buffer);
+		}
+	}
+
+	void *buffer = ::operator new(capacity, std::nothrow);
+	if (buffer == nullptr)
+		throw Error::MemoryError("Could not allocate data");
+	return (buffer);
+}
+
+void
+BiometricEvaluation::Memory::BufferPool::release(
+    void *buffer,
+    uint64_t capacity)
+    noexcept
+{
+	if (buffer == nullptr)
+		return;
+
+	capacity = floorSizeClass(capacity);
+	if (!poolDestroyed && (capacity != 0)) {
+		Pool &pool = getPool();
+		if ((pool.cachedSize + capacity) <= pool.cacheLimit) {
+			try {
+				pool.buffers[capacity].push_back(buffer);
+				pool.cachedSize += capacity;
+				return;
+			} catch (const std::bad_alloc&) {
+				/* Fall through and free the buffer */
+			}
+		}
+	}
+
+	::operator delete(buffer);
+}
+
+void
+BiometricEvaluation::Memory::BufferPool::clear()
+{
+	if (!poolDestroyed)
+		getPool().clear();
+}
+
+uint64_t
+BiometricEvaluation::Memory::BufferPool::getCachedSize()
+{
+	if (poolDestroyed)
+		return (0);
+	return (getPool().cachedSize);
+}
+
+void
+BiometricEvaluation::Memory::BufferPool::setCacheLimit(
+    uint64_t limit)
+{
+	if (poolDestroyed)
+		return;
+
+	Pool &pool = getPool();
+	pool.cacheLimit = limit;
+	if (pool.cachedSize > limit)
+		pool.clear();
+}
+
+uint64_t
+BiometricEvaluation::Memory::BufferPool::getCacheLimit()
+{
+	if (poolDestroyed)
+		return (0);
+	return (getPool().cacheLimit);
+}
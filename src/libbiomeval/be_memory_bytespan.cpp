@@ -0,0 +1,149 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <algorithm>
+
+#include <be_error_exception.h>
+#include <be_memory_bytespan.h>
+
+BiometricEvaluation::Memory::ByteSpan::ByteSpan(
+    const uint8_t *data,
+    size_type size) :
+    _data(data),
+    _size(size)
+{
+
+}
+
+BiometricEvaluation::Memory::ByteSpan::ByteSpan(
+    const uint8_t *data,
+    size_type size,
+    std::shared_ptr<const void> owner) :
+    _data(data),
+    _size(size),
+    _owner(std::move(owner))
+{
+
+}
+
+BiometricEvaluation::Memory::ByteSpan::ByteSpan(
+    const uint8Array &data) :
+    _data(data),
+    _size(data.size())
+{
+
+}
+
+BiometricEvaluation::Memory::ByteSpan::ByteSpan(
+    std::shared_ptr<const uint8Array> data) :
+    _data(*data),
+    _size(data->size()),
+    _owner(std::move(data))
+{
+
+}
+
+BiometricEvaluation::Memory::ByteSpan
+BiometricEvaluation::Memory::ByteSpan::copyOf(
+    const uint8_t *data,
+    size_type size)
+{
+	auto copy = std::make_shared<uint8Array>(size);
+	std::copy(data, data + size, static_cast<uint8_t *>(*copy));
+	return (ByteSpan(std::shared_ptr<const uint8Array>(std::move(copy))));
+}
+
+BiometricEvaluation::Memory::ByteSpan
+BiometricEvaluation::Memory::ByteSpan::share(
+    uint8Array &&data)
+{
+	return (ByteSpan(std::shared_ptr<const uint8Array>(
+	    std::make_shared<uint8Array>(std::move(data)))));
+}
+
+const uint8_t *
+BiometricEvaluation::Memory::ByteSpan::data()
+    const
+{
+	return (this->_data);
+}
+
+BiometricEvaluation::Memory::ByteSpan::size_type
+BiometricEvaluation::Memory::ByteSpan::size()
+    const
+{
+	return (this->_size);
+}
+
+bool
+BiometricEvaluation::Memory::ByteSpan::empty()
+    const
+{
+	return (this->_size == 0);
+}
+
+BiometricEvaluation::Memory::ByteSpan::const_iterator
+BiometricEvaluation::Memory::ByteSpan::begin()
+    const
+{
+	return (this->_data);
+}
+
+BiometricEvaluation::Memory::ByteSpan::const_iterator
+BiometricEvaluation::Memory::ByteSpan::end()
+    const
+{
+	return (this->_data + this->_size);
+}
+
+const uint8_t &
+BiometricEvaluation::Memory::ByteSpan::operator[](
+    size_type index)
+    const
+{
+	return (this->_data[index]);
+}
+
+BiometricEvaluation::Memory::ByteSpan
+BiometricEvaluation::Memory::ByteSpan::subspan(
+    size_type offset,
+    size_type size)
+    const
+{
+	if ((offset > this->_size) || (size > (this->_size - offset)))
+		throw Error::ParameterError("Range exceeds span");
+	return (ByteSpan(this->_data + offset, size, this->_owner));
+}
+
+bool
+BiometricEvaluation::Memory::ByteSpan::isOwned()
+    const
+{
+	/* Empty spans have nothing to keep valid */
+	return ((this->_owner != nullptr) || (this->_size == 0));
+}
+
+BiometricEvaluation::Memory::ByteSpan
+BiometricEvaluation::Memory::ByteSpan::toOwned()
+    const
+{
+	if (this->isOwned())
+		return (*this);
+	return (ByteSpan::copyOf(this->_data, this->_size));
+}
+
+BiometricEvaluation::Memory::uint8Array
+BiometricEvaluation::Memory::ByteSpan::toUint8Array()
+    const
+{
+	uint8Array copy(this->_size);
+	std::copy(this->begin(), this->end(), static_cast<uint8_t *>(copy));
+	return (copy);
+}
@@ -26,7 +26,7 @@ BiometricEvaluation::Palm::AN2KView::AN2KView(
 }
 
 BiometricEvaluation::Palm::AN2KView::AN2KView(
-    BE::Memory::uint8Array &buf,
+    const BE::Memory::ByteSpan &buf,
     const uint32_t recordNumber) :
     AN2KViewVariableResolution(buf, RecordType::Type_15, recordNumber)
 {
@@ -34,6 +34,23 @@ BiometricEvaluation::Palm::AN2KView::AN2KView(
 	readImageRecord(RecordType::Type_15);
 }
 
+BiometricEvaluation::Palm::AN2KView::AN2KView(
+    const Memory::uint8Array &buf,
+    const uint32_t recordNumber) :
+    AN2KView(Memory::ByteSpan(buf), recordNumber)
+{
+
+}
+
+BiometricEvaluation::Palm::AN2KView::AN2KView(
+    const std::shared_ptr<const ANSI_NIST> &an2k,
+    const uint32_t recordNumber) :
+    AN2KViewVariableResolution(an2k, RecordType::Type_15, recordNumber)
+{
+	/* Parent classes handle most fields */
+	readImageRecord(RecordType::Type_15);
+}
+
 /******************************************************************************/
 /* Public functions.                                                          */
 /******************************************************************************/
@@ -17,8 +17,19 @@
 #include <openssl/evp.h>
 #endif
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <nmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#elif defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <cstring>
 #include <locale>
 #include <iomanip>
 #include <memory>
@@ -232,6 +243,113 @@ BiometricEvaluation::Text::digest(
 	    digest));
 }
 
+/*
+ * Table-driven CRC-32C, used when the processor cannot compute the
+ * checksum directly.
+ */
+static uint32_t
+crc32cSoftware(
+    const uint8_t *buffer,
+    size_t buffer_size,
+    uint32_t crc)
+{
+	/* Reflected Castagnoli polynomial */
+	static const uint32_t POLYNOMIAL = 0x82F63B78;
+	static const std::array<uint32_t, 256> table = []() {
+		std::array<uint32_t, 256> t{};
+		for (uint32_t i = 0; i < 256; i++) {
+			uint32_t c = i;
+			for (int k = 0; k < 8; k++)
+				c = (c & 1) ? ((c >> 1) ^ POLYNOMIAL) : (c >> 1);
+			t[i] = c;
+		}
+		return (t);
+	    }();
+
+	while (buffer_size-- > 0)
+		crc = table[(crc ^ *buffer++) & 0xFF] ^ (crc >> 8);
+	return (crc);
+}
+
+#if defined(__x86_64__) || defined(_M_X64)
+#ifndef _MSC_VER
+__attribute__((target("sse4.2")))
+#endif
+static uint32_t
+crc32cHardware(
+    const uint8_t *buffer,
+    size_t buffer_size,
+    uint32_t crc)
+{
+	uint64_t crc64 = crc;
+	uint64_t word;
+	while (buffer_size >= sizeof(word)) {
+		std::memcpy(&word, buffer, sizeof(word));
+		crc64 = _mm_crc32_u64(crc64, word);
+		buffer += sizeof(word);
+		buffer_size -= sizeof(word);
+	}
+	crc = static_cast<uint32_t>(crc64);
+	while (buffer_size-- > 0)
+		crc = _mm_crc32_u8(crc, *buffer++);
+	return (crc);
+}
+
+static bool
+crc32cHardwareSupported()
+{
+#ifdef _MSC_VER
+	int info[4];
+	__cpuid(info, 1);
+	return ((info[2] & (1 << 20)) != 0);
+#else
+	return (__builtin_cpu_supports("sse4.2"));
+#endif
+}
+#elif defined(__ARM_FEATURE_CRC32)
+static uint32_t
+crc32cHardware(
+    const uint8_t *buffer,
+    size_t buffer_size,
+    uint32_t crc)
+{
+	uint64_t word;
+	while (buffer_size >= sizeof(word)) {
+		std::memcpy(&word, buffer, sizeof(word));
+		crc = __crc32cd(crc, word);
+		buffer += sizeof(word);
+		buffer_size -= sizeof(word);
+	}
+	while (buffer_size-- > 0)
+		crc = __crc32cb(crc, *buffer++);
+	return (crc);
+}
+
+static bool
+crc32cHardwareSupported()
+{
+	return (true);
+}
+#endif
+
+uint32_t
+BiometricEvaluation::Text::crc32c(
+    const void *buffer,
+    const size_t buffer_size,
+    const uint32_t crc)
+{
+	const uint8_t *bytes = static_cast<const uint8_t *>(buffer);
+	if (bytes == nullptr && buffer_size != 0)
+		throw Error::ParameterError("buffer is nullptr");
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__ARM_FEATURE_CRC32)
+	static const bool hardware = crc32cHardwareSupported();
+	if (hardware)
+		return (~crc32cHardware(bytes, buffer_size, ~crc));
+#endif
+	return (~crc32cSoftware(bytes, buffer_size, ~crc));
+}
+
 std::vector<std::string>
 BiometricEvaluation::Text::split(
     const std::string &str,
@@ -13,7 +13,6 @@
 
 #include <be_data_interchange_an2k.h>
 #include <be_finger_an2kminutiae_data_record.h>
-#include <be_io_utility.h>
 #include <be_view_an2kview.h>
 #include <be_memory_autobuffer.h>
 extern "C" {
@@ -70,42 +69,39 @@ BiometricEvaluation::View::AN2KView::AN2KView(
     const std::string filename,
     const RecordType typeID,
     const uint32_t recordNumber) :
-	_an2kRecord(nullptr)
+    AN2KView(DataInterchange::AN2KRecord::mapFile(filename), typeID,
+    recordNumber)
 {
-	if (!IO::Utility::fileExists(filename))
-		throw (Error::FileError("File not found."));
-
-	FILE *fp = std::fopen(filename.c_str(), "rb");
-	if (fp == nullptr)
-		throw (Error::FileError("Could not open file."));
-
-	_an2k = Memory::AutoBuffer<ANSI_NIST>(&biomeval_nbis_alloc_ANSI_NIST,
-		&biomeval_nbis_free_ANSI_NIST, &biomeval_nbis_copy_ANSI_NIST);
-	if (biomeval_nbis_read_ANSI_NIST(fp, _an2k) != 0) {
-		fclose(fp);
-		throw Error::FileError("Could not read AN2K file");
-	}
-	fclose(fp);
-	
-	readImageCommon(_an2k, typeID, recordNumber);
-	associateMinutiaeData(filename);
+
+}
+
+BiometricEvaluation::View::AN2KView::AN2KView(
+    const Memory::ByteSpan &buf,
+    const RecordType typeID,
+    const uint32_t recordNumber) :
+    AN2KView(DataInterchange::AN2KRecord::parse(buf), typeID, recordNumber)
+{
+
 }
 
 BiometricEvaluation::View::AN2KView::AN2KView(
-    Memory::uint8Array &buf,
+    const Memory::uint8Array &buf,
     const RecordType typeID,
     const uint32_t recordNumber) :
+    AN2KView(Memory::ByteSpan(buf), typeID, recordNumber)
+{
+
+}
+
+BiometricEvaluation::View::AN2KView::AN2KView(
+    const std::shared_ptr<const ANSI_NIST> &an2k,
+    const RecordType typeID,
+    const uint32_t recordNumber) :
+	_an2k(an2k),
 	_an2kRecord(nullptr)
 {
-	_an2k = Memory::AutoBuffer<ANSI_NIST>(&biomeval_nbis_alloc_ANSI_NIST,
-		&biomeval_nbis_free_ANSI_NIST, &biomeval_nbis_copy_ANSI_NIST);
-	
-	AN2KBDB bdb;
-	INIT_AN2KBDB(&bdb, buf, buf.size());
-	if (biomeval_nbis_scan_ANSI_NIST(&bdb, _an2k) != 0)
-		throw Error::DataError("Could not read AN2K buffer");
-	readImageCommon(_an2k, typeID, recordNumber);
-	associateMinutiaeData(buf);
+	readImageCommon(_an2k.get(), typeID, recordNumber);
+	associateMinutiaeData();
 }
 
 BiometricEvaluation::View::AN2KView::~AN2KView()
@@ -213,7 +209,7 @@ BiometricEvaluation::View::AN2KView::getRecordType() const
 /* Protected functions.                                                       */
 /******************************************************************************/
 
-BiometricEvaluation::Memory::AutoBuffer<ANSI_NIST>
+std::shared_ptr<const ANSI_NIST>
 BiometricEvaluation::View::AN2KView::getAN2K()
     const
 {
@@ -263,8 +259,8 @@ BiometricEvaluation::View::AN2KView::readImageCommon(
 	 * an exception if not present. The 0th record in an AN2K
 	 * file is always the Type-1, so skip that one.
 	 * The pointer is set to an object inside the complete ANSI-NIST 
-	 * record, and that object is free'd in the destructor by the
-	 * AutoBuffer that wraps it. Therefore the single RECORD object
+	 * record, and that object is free'd when the last view sharing
+	 * it is destroyed. Therefore the single RECORD object
 	 * is not explicitly destroyed.
 	 */
 	uint32_t count = 1;
@@ -347,55 +343,36 @@ BiometricEvaluation::View::AN2KView::readImageCommon(
     		/* Not reached */
   		throw Error::ParameterError("Invalid Record Type ID");
 	}
-	BE::Memory::uint8Array imageData;
-	imageData.copy(field->subfields[0]->items[0]->value,
-	    field->subfields[0]->items[0]->num_bytes);
-	this->setImageData(imageData);
+	/*
+	 * Refer to the image data in the parse tree rather than copying it.
+	 * The span shares ownership of the tree, so the data remains valid
+	 * for as long as the span, or any Image constructed from it.
+	 */
+	this->setImageData(BE::Memory::ByteSpan(
+	    field->subfields[0]->items[0]->value,
+	    field->subfields[0]->items[0]->num_bytes, _an2k));
 }
 
 void
-BiometricEvaluation::View::AN2KView::associateMinutiaeData(
-    Memory::uint8Array &buf)
+BiometricEvaluation::View::AN2KView::associateMinutiaeData()
 {
 	FIELD *field;
 	int idx;
-	std::set<int> type9Recs =
-	    DataInterchange::AN2KRecord::recordLocations(buf, RecordType::Type_9);
+	std::set<int> type9Recs = DataInterchange::AN2KRecord::recordLocations(
+	    _an2k.get(), RecordType::Type_9);
 	for (std::set<int>::const_iterator it = type9Recs.begin(); 
 	    it != type9Recs.end(); it++) {
 		if (biomeval_nbis_lookup_ANSI_NIST_field(&field, &idx, IDC_ID, 
 		    _an2k->records[*it]) == TRUE) {
 			if (_idc == atoi((char *)field->subfields[0]->
 			    items[0]->value)) {
-				Finger::AN2KMinutiaeDataRecord amdr(buf, *it);
+				Finger::AN2KMinutiaeDataRecord amdr(_an2k, *it);
 				addMinutiaeDataRecord(amdr);
 			}
 		}
 	}	
 }
 
-void
-BiometricEvaluation::View::AN2KView::associateMinutiaeData(
-    const std::string &filename)
-{
-	if (!IO::Utility::fileExists(filename))
-		throw (Error::FileError("File not found."));
-
-	FILE *fp = std::fopen(filename.c_str(), "rb");
-	if (fp == nullptr)
-		throw (Error::FileError("Could not open file."));
-
-	uint64_t sz = IO::Utility::getFileSize(filename);
-	Memory::uint8Array buf(sz);
-	if (fread(buf, 1, sz, fp) != sz) {
-		fclose(fp);
-		throw Error::FileError("Could not read AN2K file");
-	}
-        fclose(fp);
-
-	associateMinutiaeData(buf);
-}
-
 void
 BiometricEvaluation::View::AN2KView::addMinutiaeDataRecord(
     Finger::AN2KMinutiaeDataRecord &mdr)
@@ -32,7 +32,7 @@ BiometricEvaluation::View::AN2KViewVariableResolution::AN2KViewVariableResolutio
 }
 
 BiometricEvaluation::View::AN2KViewVariableResolution::AN2KViewVariableResolution(
-    Memory::uint8Array &buf,
+    const Memory::ByteSpan &buf,
     const RecordType typeID,
     const uint32_t recordNumber) :
     AN2KView(buf, typeID, recordNumber)
@@ -40,6 +40,24 @@ BiometricEvaluation::View::AN2KViewVariableResolution::AN2KViewVariableResolutio
 	readImageRecord(typeID);
 }
 
+BiometricEvaluation::View::AN2KViewVariableResolution::AN2KViewVariableResolution(
+    const Memory::uint8Array &buf,
+    const RecordType typeID,
+    const uint32_t recordNumber) :
+    AN2KViewVariableResolution(Memory::ByteSpan(buf), typeID, recordNumber)
+{
+
+}
+
+BiometricEvaluation::View::AN2KViewVariableResolution::AN2KViewVariableResolution(
+    const std::shared_ptr<const ANSI_NIST> &an2k,
+    const RecordType typeID,
+    const uint32_t recordNumber) :
+    AN2KView(an2k, typeID, recordNumber)
+{
+	readImageRecord(typeID);
+}
+
 /******************************************************************************/
 /* Public functions.                                                          */
 /******************************************************************************/
@@ -400,14 +418,7 @@ BiometricEvaluation::View::AN2KViewVariableResolution::readImageRecord(
         AN2KView::setImageColorDepth(
 	    atoi((char *)field->subfields[0]->items[0]->value));
 
-	/* Read the image data */
-	if (biomeval_nbis_lookup_ANSI_NIST_field(&field, &idx, DAT2_ID, record) != TRUE)
-		throw Error::DataError("Field DAT2 not found");
-	Memory::AutoArray<uint8_t>imageData = Memory::AutoArray<uint8_t>(
-	    field->subfields[0]->items[0]->num_bytes);
-	for (unsigned int i = 0; i < imageData.size(); i++)
-		imageData[i] = field->subfields[0]->items[0]->value[i];
-	AN2KView::setImageData(imageData);
+	/* The image data was read, without copying, by AN2KView */
 
 	/*********************************************************************/
 	/* Optional Fields.                                                  */
@@ -41,7 +41,7 @@ BiometricEvaluation::View::View::getImage() const
 			throw BE::Error::NotImplemented("> 16-bit depth");
 
 		return (std::make_shared<BE::Image::Raw>(this->_imageData,
-		    this->_imageData.size(), this->_imageSize,
+		    this->_imageSize,
 		    this->_imageColorDepth, bitDepth, this->_imageResolution,
 		    false));
 	}
@@ -50,6 +50,27 @@ BiometricEvaluation::View::View::getImage() const
 	}
 }
 
+std::shared_ptr<BE::Image::Image>
+BiometricEvaluation::View::View::getImage(
+    const Image::Resolution &resolution,
+    const Image::ResampleFilter filter)
+    const
+{
+	const auto image = this->getImage();
+	if (BE::Image::getResampledSize(image->getDimensions(),
+	    this->_imageResolution, resolution) == image->getDimensions())
+		return (image);
+	return (std::make_shared<BE::Image::Raw>(BE::Image::resample(*image,
+	    this->_imageResolution, resolution, filter)));
+}
+
+BiometricEvaluation::Memory::ByteSpan
+BiometricEvaluation::View::View::getImageData()
+    const
+{
+	return (this->_imageData);
+}
+
 BiometricEvaluation::Image::Size
 BiometricEvaluation::View::View::getImageSize() const
 {
@@ -101,6 +122,14 @@ BiometricEvaluation::View::View::setImageSize(
 void
 BiometricEvaluation::View::View::setImageData(
     const BiometricEvaluation::Memory::uint8Array &imageData)
+{
+	this->_imageData = Memory::ByteSpan::copyOf(imageData,
+	    imageData.size());
+}
+
+void
+BiometricEvaluation::View::View::setImageData(
+    const BiometricEvaluation::Memory::ByteSpan &imageData)
 {
 	this->_imageData = imageData;
 }
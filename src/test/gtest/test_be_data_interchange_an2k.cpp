@@ -0,0 +1,635 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <be_data_interchange_an2k.h>
+#include <be_data_interchange_an2kingest.h>
+#include <be_data_interchange_an2kreader.h>
+#include <be_data_interchange_an2kwriter.h>
+#include <be_image_wsq.h>
+#include <be_io_utility.h>
+extern "C" {
+#include <an2k.h>
+}
+
+#include <gtest/gtest.h>
+
+namespace BE = BiometricEvaluation;
+
+using Construction = BE::DataInterchange::AN2KRecord::Construction;
+using RecordType = BE::View::AN2KView::RecordType;
+using AN2KWriter = BE::DataInterchange::AN2KWriter;
+
+static const std::vector<std::string> AN2KPaths{"../test_data/type9.an2k",
+    "../test_data/type9-13.an2k", "../test_data/type9-15.an2k",
+    "../test_data/type9-efs.an2k", "../test_data/type3.an2k",
+    "../test_data/type4-slaps.an2k"};
+
+TEST(AN2KRecord, Index)
+{
+	for (const auto &path : AN2KPaths) {
+		const auto data = BE::IO::Utility::readFile(path);
+		const BE::Memory::ByteSpan buf(data);
+		const BE::DataInterchange::AN2KRecord record(buf,
+		    Construction::Lazy);
+		const auto tree = BE::DataInterchange::AN2KRecord::parse(buf);
+
+		const auto index = record.getRecordIndex();
+		ASSERT_EQ(tree->num_records, index.size()) << path;
+		EXPECT_EQ(RecordType::Type_1, index[0].type);
+		uint64_t offset = 0;
+		for (std::vector<int>::size_type i = 0; i < index.size(); i++) {
+			EXPECT_EQ(tree->records[i]->type, static_cast<
+			    unsigned int>(index[i].type)) << path;
+			EXPECT_EQ(offset, index[i].offset) << path;
+			EXPECT_EQ(tree->records[i]->total_bytes,
+			    index[i].length) << path;
+			offset += index[i].length;
+		}
+		EXPECT_EQ(buf.size(), offset) << path;
+
+		/* Eager construction indexes from the parse tree */
+		const BE::DataInterchange::AN2KRecord eager(buf);
+		const auto eagerIndex = eager.getRecordIndex();
+		ASSERT_EQ(index.size(), eagerIndex.size()) << path;
+		for (std::vector<int>::size_type i = 0; i < index.size(); i++) {
+			const auto &lazyEntry = index[i];
+			const auto &eagerEntry = eagerIndex[i];
+			EXPECT_EQ(lazyEntry.type, eagerEntry.type) << path;
+			EXPECT_EQ(lazyEntry.idc, eagerEntry.idc) << path;
+			EXPECT_EQ(lazyEntry.offset, eagerEntry.offset) << path;
+			EXPECT_EQ(lazyEntry.length, eagerEntry.length) << path;
+		}
+	}
+
+	/* type9-13: Type-1, Type-2, Type-9, Type-13 */
+	const BE::DataInterchange::AN2KRecord record(
+	    "../test_data/type9-13.an2k", Construction::Lazy);
+	const auto index = record.getRecordIndex();
+	ASSERT_EQ(4u, index.size());
+	EXPECT_EQ(RecordType::Type_9, index[2].type);
+	EXPECT_EQ(RecordType::Type_13, index[3].type);
+}
+
+TEST(AN2KRecord, Lazy)
+{
+	for (const auto &path : AN2KPaths) {
+		const BE::DataInterchange::AN2KRecord eager(path);
+		const BE::DataInterchange::AN2KRecord lazy(path,
+		    Construction::Lazy);
+
+		EXPECT_EQ(eager.getTransactionControlNumber(),
+		    lazy.getTransactionControlNumber());
+		EXPECT_EQ(eager.getDate(), lazy.getDate());
+		EXPECT_EQ(eager.getOriginatingAgency(),
+		    lazy.getOriginatingAgency());
+		EXPECT_EQ(eager.getDirectoryOfCharacterSets().size(),
+		    lazy.getDirectoryOfCharacterSets().size());
+
+		EXPECT_EQ(eager.getMinutiaeDataRecordCount(),
+		    lazy.getMinutiaeDataRecordCount()) << path;
+		EXPECT_EQ(eager.getFingerLatentCount(),
+		    lazy.getFingerLatentCount()) << path;
+		EXPECT_EQ(eager.getPalmCaptureCount(),
+		    lazy.getPalmCaptureCount()) << path;
+		EXPECT_EQ(eager.getFingerCaptureCount(),
+		    lazy.getFingerCaptureCount()) << path;
+
+		/* Out of order, then again from the cache */
+		for (uint32_t n = 0; n < 2; n++) {
+			for (uint32_t i = lazy.getFingerLatentCount(); i > 0;
+			    i--)
+				EXPECT_EQ(eager.getFingerLatent(i - 1).
+				    getImageSize(), lazy.getFingerLatent(i - 1).
+				    getImageSize());
+			for (uint32_t i = lazy.getMinutiaeDataRecordCount();
+			    i > 0; i--)
+				EXPECT_EQ(eager.getMinutiaeDataRecord(i - 1).
+				    getImpressionType(), lazy.
+				    getMinutiaeDataRecord(i - 1).
+				    getImpressionType());
+		}
+		EXPECT_EQ(eager.getMinutiaeDataRecordSet().size(),
+		    lazy.getMinutiaeDataRecordSet().size());
+		EXPECT_EQ(eager.getPalmCaptures().size(),
+		    lazy.getPalmCaptures().size());
+	}
+}
+
+TEST(AN2KRecord, ImageData)
+{
+	BE::Memory::ByteSpan data;
+	std::shared_ptr<BE::Image::Image> image;
+	{
+		const BE::DataInterchange::AN2KRecord record(
+		    "../test_data/type9-15.an2k", Construction::Lazy);
+		const auto palm = record.getPalmCapture(0);
+		data = palm.getImageData();
+		image = palm.getImage();
+
+		/* Views and images share the bytes of the parse tree */
+		EXPECT_EQ(data.data(), record.getPalmCapture(0).
+		    getImageData().data());
+		EXPECT_EQ(data.data(), record.getPalmCaptures()[0].
+		    getImageData().data());
+		EXPECT_EQ(data.data(), image->getDataSpan().data());
+	}
+
+	/* ...and keep them valid after the record is destroyed */
+	EXPECT_TRUE(data.isOwned());
+	EXPECT_EQ(189465u, data.size());
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::WSQ20,
+	    image->getCompressionAlgorithm());
+	EXPECT_EQ(BE::Image::Size(900, 2500), image->getDimensions());
+	EXPECT_NO_THROW(image->getRawData());
+}
+
+TEST(AN2KReader, Sequence)
+{
+	for (const auto &path : AN2KPaths) {
+		const auto buf = BE::IO::Utility::readFile(path);
+		const auto tree = BE::DataInterchange::AN2KRecord::parse(
+		    BE::Memory::ByteSpan(buf));
+		BE::DataInterchange::AN2KReader reader(path);
+		ASSERT_EQ(tree->num_records, reader.getRecordCount()) << path;
+		EXPECT_EQ(TYPE_1_ID, reader.getType1Record()->type);
+
+		uint64_t offset = 0;
+		for (int i = 0; i < tree->num_records; i++) {
+			const auto record = reader.sequence();
+			EXPECT_EQ(tree->records[i]->type, static_cast<
+			    unsigned int>(record.type)) << path;
+			EXPECT_EQ(offset, record.offset) << path;
+			ASSERT_EQ(tree->records[i]->total_bytes,
+			    record.data.size()) << path;
+			EXPECT_TRUE(record.data.isOwned());
+			EXPECT_EQ(0, std::memcmp(buf + offset,
+			    record.data.data(), record.data.size())) << path;
+			offset += record.data.size();
+		}
+		EXPECT_EQ(buf.size(), offset) << path;
+		EXPECT_THROW(reader.sequence(), BE::Error::ObjectDoesNotExist);
+
+		/* Restart */
+		const auto type1 = reader.sequence(
+		    BE::DataInterchange::AN2KReader::BE_AN2KREADER_SEQ_START);
+		EXPECT_EQ(RecordType::Type_1, type1.type);
+		EXPECT_EQ(0u, type1.offset);
+	}
+
+	/* IDCs, from CNT */
+	BE::DataInterchange::AN2KReader reader("../test_data/type9-13.an2k");
+	EXPECT_EQ(0u, reader.sequence().idc);
+	const auto type2 = reader.sequence();
+	EXPECT_EQ(RecordType::Type_2, type2.type);
+	const auto type9 = reader.sequence();
+	EXPECT_EQ(RecordType::Type_9, type9.type);
+	const auto type13 = reader.sequence();
+	EXPECT_EQ(RecordType::Type_13, type13.type);
+	EXPECT_EQ(type9.idc, type13.idc);
+
+	EXPECT_THROW(reader.sequence(0), BE::Error::ParameterError);
+	EXPECT_THROW(BE::DataInterchange::AN2KReader("NonExistent"),
+	    BE::Error::FileError);
+}
+
+TEST(AN2KRecord, Parameters)
+{
+	const BE::DataInterchange::AN2KRecord record(
+	    "../test_data/type9-13.an2k", Construction::Lazy);
+	EXPECT_NO_THROW(record.getFingerLatent(0));
+	EXPECT_THROW(record.getFingerLatent(1), BE::Error::ParameterError);
+	EXPECT_THROW(record.getFingerCapture(0), BE::Error::ParameterError);
+
+	/* Truncated transactions fail while indexing */
+	const auto buf = BE::IO::Utility::readFile(
+	    "../test_data/type9-13.an2k");
+	EXPECT_THROW(BE::DataInterchange::AN2KRecord(BE::Memory::ByteSpan(
+	    buf, buf.size() - 1), Construction::Lazy),
+	    BE::Error::DataError);
+}
+
+/** @return Fields of a Type-1 record, but LEN and CNT */
+static AN2KWriter::Fields
+type1Fields(
+    const BE::Memory::ByteSpan &type1)
+{
+	AN2KWriter::Fields fields;
+	const std::string text(reinterpret_cast<const char*>(type1.data()),
+	    type1.size() - 1);
+	for (std::string::size_type start = 0; start < text.size(); ) {
+		auto end = text.find(GS_CHAR, start);
+		if (end == std::string::npos)
+			end = text.size();
+		const auto field = text.substr(start, end - start);
+		const auto colon = field.find(':');
+		const auto number = static_cast<uint16_t>(std::stoi(
+		    field.substr(field.find('.') + 1, colon)));
+		if (number != LEN_ID && number != CNT_ID)
+			fields[number] = field.substr(colon + 1);
+		start = end + 1;
+	}
+	return (fields);
+}
+
+TEST(AN2KWriter, Repackage)
+{
+	for (const auto &path : AN2KPaths) {
+		const auto buf = BE::IO::Utility::readFile(path);
+		BE::DataInterchange::AN2KReader reader{
+		    BE::Memory::ByteSpan(buf)};
+
+		AN2KWriter writer("", "", "", "", "");
+		for (const auto &field : type1Fields(reader.sequence().data))
+			writer.setType1Field(field.first, field.second);
+		for (uint32_t i = 1; i < reader.getRecordCount(); i++)
+			writer.addRecord(reader.sequence());
+		EXPECT_EQ(reader.getRecordCount(), writer.getRecordCount());
+
+		/* The same records, fields, and IDCs: the same bytes */
+		ASSERT_EQ(buf.size(), writer.getLength()) << path;
+		const auto written = writer.write();
+		ASSERT_EQ(buf.size(), written.size()) << path;
+		EXPECT_EQ(0, std::memcmp(buf, written, buf.size())) << path;
+
+		BE::Memory::uint8Array reused(buf.size() + 10);
+		EXPECT_EQ(buf.size(), writer.write(reused, reused.size()));
+		EXPECT_EQ(0, std::memcmp(buf, reused, buf.size())) << path;
+	}
+}
+
+TEST(AN2KWriter, Views)
+{
+	const BE::DataInterchange::AN2KRecord palms(
+	    "../test_data/type9-15.an2k");
+	const BE::DataInterchange::AN2KRecord latents(
+	    "../test_data/type9-13.an2k");
+	const auto slaps = BE::IO::Utility::readFile(
+	    "../test_data/type4-slaps.an2k");
+	std::vector<BE::Finger::AN2KViewFixedResolution> fixed;
+	for (uint32_t i = 1; i <= 4; i++)
+		fixed.emplace_back(BE::Memory::ByteSpan(slaps),
+		    RecordType::Type_4, i);
+	fixed.emplace_back("../test_data/type3.an2k", RecordType::Type_3, 1);
+	const BE::Image::WSQ wsq(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+
+	AN2KWriter writer("TEST", "DAI000000", "ORI000000", "TCN0001",
+	    "20261018");
+	writer.setType1Field(PRY_ID, "4");
+	uint32_t idc = 1;
+	for (const auto &view : palms.getPalmCaptures())
+		writer.addView(view, idc++);
+	for (const auto &view : latents.getFingerLatents())
+		writer.addView(view, idc++);
+	for (const auto &view : fixed)
+		writer.addView(view, idc++);
+	writer.addFingerImage(wsq, idc++, BE::Finger::Position::RightIndex,
+	    BE::Finger::Impression::LiveScanPlain, "SRC", "20261018");
+	EXPECT_EQ(idc, writer.getRecordCount());
+
+	const auto written = writer.write();
+	ASSERT_EQ(writer.getLength(), written.size());
+	const BE::DataInterchange::AN2KRecord record{
+	    BE::Memory::ByteSpan(written)};
+	EXPECT_EQ("TCN0001", record.getTransactionControlNumber());
+	EXPECT_EQ("20261018", record.getDate());
+	EXPECT_EQ("ORI000000", record.getOriginatingAgency());
+	EXPECT_EQ(4, record.getPriority());
+
+	/* Views read back as they were written */
+	const auto expectSameImage = [](const BE::View::AN2KView &expected,
+	    const BE::View::AN2KView &actual) {
+		EXPECT_EQ(expected.getImageSize(), actual.getImageSize());
+		EXPECT_EQ(expected.getImageResolution(),
+		    actual.getImageResolution());
+		EXPECT_EQ(expected.getCompressionAlgorithm(),
+		    actual.getCompressionAlgorithm());
+		EXPECT_EQ(expected.getImageColorDepth(),
+		    actual.getImageColorDepth());
+		const auto data = expected.getImageData();
+		ASSERT_EQ(data.size(), actual.getImageData().size());
+		EXPECT_EQ(0, std::memcmp(data.data(),
+		    actual.getImageData().data(), data.size()));
+	};
+
+	ASSERT_EQ(palms.getPalmCaptureCount(), record.getPalmCaptureCount());
+	for (uint32_t i = 0; i < record.getPalmCaptureCount(); i++) {
+		const auto expected = palms.getPalmCapture(i);
+		const auto actual = record.getPalmCapture(i);
+		expectSameImage(expected, actual);
+		EXPECT_EQ(expected.getPosition(), actual.getPosition());
+		EXPECT_EQ(expected.getImpressionType(),
+		    actual.getImpressionType());
+		EXPECT_EQ(expected.getSourceAgency(),
+		    actual.getSourceAgency());
+		EXPECT_EQ(expected.getCaptureDate(), actual.getCaptureDate());
+	}
+
+	ASSERT_EQ(latents.getFingerLatentCount(),
+	    record.getFingerLatentCount());
+	for (uint32_t i = 0; i < record.getFingerLatentCount(); i++) {
+		const auto expected = latents.getFingerLatent(i);
+		const auto actual = record.getFingerLatent(i);
+		expectSameImage(expected, actual);
+		ASSERT_EQ(expected.getPositions().size(),
+		    actual.getPositions().size());
+		for (std::vector<int>::size_type p = 0;
+		    p < actual.getPositions().size(); p++)
+			EXPECT_EQ(expected.getPositions()[p].position.fingerPos,
+			    actual.getPositions()[p].position.fingerPos);
+		EXPECT_EQ(expected.getImpressionType(),
+		    actual.getImpressionType());
+	}
+
+	for (uint32_t i = 0; i < fixed.size(); i++) {
+		const BE::Finger::AN2KViewFixedResolution actual(
+		    BE::Memory::ByteSpan(written), fixed[i].getRecordType(),
+		    i < 4 ? i + 1 : 1);
+		expectSameImage(fixed[i], actual);
+		EXPECT_EQ(fixed[i].getPositions(), actual.getPositions());
+		EXPECT_EQ(fixed[i].getImpressionType(),
+		    actual.getImpressionType());
+	}
+
+	ASSERT_EQ(1u, record.getFingerCaptureCount());
+	const auto capture = record.getFingerCapture(0);
+	EXPECT_EQ(BE::Finger::Position::RightIndex, capture.getPosition());
+	EXPECT_EQ(BE::Finger::Impression::LiveScanPlain,
+	    capture.getImpressionType());
+	EXPECT_EQ("SRC", capture.getSourceAgency());
+	EXPECT_EQ(wsq.getDimensions(), capture.getImageSize());
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::WSQ20,
+	    capture.getCompressionAlgorithm());
+	ASSERT_EQ(wsq.getDataSpan().size(), capture.getImageData().size());
+	EXPECT_EQ(0, std::memcmp(wsq.getDataSpan().data(),
+	    capture.getImageData().data(), wsq.getDataSpan().size()));
+
+	/* A Type-14 record from the Type-14 view is the same record */
+	AN2KWriter again("TEST", "DAI000000", "ORI000000", "TCN0002",
+	    "20261018");
+	again.addView(capture, idc - 1);
+	const BE::DataInterchange::AN2KRecord rewritten(
+	    BE::Memory::ByteSpan::share(again.write()));
+	ASSERT_EQ(1u, rewritten.getFingerCaptureCount());
+	expectSameImage(capture, rewritten.getFingerCapture(0));
+	EXPECT_EQ(capture.getPosition(),
+	    rewritten.getFingerCapture(0).getPosition());
+}
+
+TEST(AN2KWriter, Parameters)
+{
+	AN2KWriter writer("TEST", "DAI000000", "ORI000000", "TCN0001",
+	    "20261018");
+	EXPECT_THROW(writer.setType1Field(LEN_ID, "1"),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(writer.setType1Field(CNT_ID, "1"),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(writer.setType1Field(1000, "1"),
+	    BE::Error::ParameterError);
+
+	EXPECT_THROW(writer.addTaggedRecord(RecordType::Type_4, 1, {}),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(writer.addTaggedRecord(RecordType::Type_1, 1, {}),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(writer.addTaggedRecord(RecordType::Type_2, 1,
+	    {{IDC_ID, "01"}}), BE::Error::ParameterError);
+	EXPECT_THROW(writer.addFixedResolutionRecord(RecordType::Type_4, 256,
+	    BE::Finger::Impression::LiveScanPlain, {}, false, {1, 1},
+	    BE::Image::CompressionAlgorithm::None, {}),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(writer.addFixedResolutionRecord(RecordType::Type_4, 1,
+	    BE::Finger::Impression::LiveScanPlain, {}, false, {1, 1},
+	    BE::Image::CompressionAlgorithm::Facsimile, {}),
+	    BE::Error::ParameterError);
+	EXPECT_EQ(1u, writer.getRecordCount());
+
+	/* A Type-2 record without image data */
+	writer.addTaggedRecord(RecordType::Type_2, 0, {{3, "text"}});
+	const auto written = writer.write();
+	const BE::DataInterchange::AN2KRecord record{
+	    BE::Memory::ByteSpan(written)};
+	EXPECT_EQ(2u, record.getRecordIndex().size());
+	EXPECT_EQ(RecordType::Type_2, record.getRecordIndex()[1].type);
+
+	BE::Memory::uint8Array small(written.size() - 1);
+	EXPECT_THROW(writer.write(small, small.size()),
+	    BE::Error::ParameterError);
+}
+
+/** Logsheet keeping its entries in memory */
+class MemoryLogsheet : public BE::IO::Logsheet
+{
+public:
+	void
+	write(
+	    const std::string &entry)
+	    override
+	{
+		this->entries.push_back(entry);
+	}
+
+	std::vector<std::string> entries;
+};
+
+/** @return A new RecordStore, replacing any of the same name */
+static std::shared_ptr<BE::IO::RecordStore>
+createStore(
+    const std::string &name)
+{
+	try {
+		BE::IO::RecordStore::removeRecordStore(name);
+	} catch (const BE::Error::Exception&) {}
+	return (BE::IO::RecordStore::createRecordStore(name, "AN2K ingestion",
+	    BE::IO::RecordStore::Kind::File));
+}
+
+TEST(AN2KIngest, Directory)
+{
+	BE::DataInterchange::AN2KIngestStores stores;
+	stores.fingerLatents = createStore("test_be_an2kingest_images");
+	stores.palmCaptures = stores.fingerLatents;
+	stores.fingerCaptures = stores.fingerLatents;
+	stores.minutiae = createStore("test_be_an2kingest_minutiae");
+	auto logsheet = std::make_shared<MemoryLogsheet>();
+
+	BE::DataInterchange::AN2KIngestOptions options;
+	options.threads = 3;
+	options.maxPending = 2;
+	options.logsheet = logsheet;
+	options.extensions = {".AN2K"};
+	const auto summary = BE::DataInterchange::ingestAN2KDirectory(
+	    "../test_data", stores, options);
+	EXPECT_EQ(AN2KPaths.size(), summary.files);
+	EXPECT_EQ(0u, summary.failures);
+	EXPECT_TRUE(logsheet->entries.empty());
+
+	uint64_t images = 0, minutiae = 0;
+	for (const auto &path : AN2KPaths) {
+		const BE::DataInterchange::AN2KRecord record(path);
+		images += record.getFingerLatentCount() +
+		    record.getFingerCaptureCount() +
+		    record.getPalmCaptureCount();
+		minutiae += record.getMinutiaeDataRecordCount();
+	}
+	EXPECT_EQ(images + minutiae, summary.records);
+	EXPECT_EQ(images, stores.palmCaptures->getCount());
+	EXPECT_EQ(minutiae, stores.minutiae->getCount());
+
+	/* Image data as it is in the transaction */
+	const BE::DataInterchange::AN2KRecord palms(
+	    "../test_data/type9-15.an2k");
+	const auto palm = palms.getPalmCapture(1).getImageData();
+	const auto stored = stores.palmCaptures->read("type9-15.an2k_15_2");
+	ASSERT_EQ(palm.size(), stored.size());
+	EXPECT_EQ(0, std::memcmp(palm.data(), stored, stored.size()));
+
+	/* Type-9 records as they are in the transaction */
+	BE::DataInterchange::AN2KReader reader("../test_data/type9-13.an2k");
+	reader.sequence();
+	reader.sequence();
+	const auto type9 = reader.sequence().data;
+	const auto minutia = stores.minutiae->read("type9-13.an2k_9_1");
+	ASSERT_EQ(type9.size(), minutia.size());
+	EXPECT_EQ(0, std::memcmp(type9.data(), minutia, minutia.size()));
+
+	stores = {};
+	BE::IO::RecordStore::removeRecordStore("test_be_an2kingest_images");
+	BE::IO::RecordStore::removeRecordStore("test_be_an2kingest_minutiae");
+}
+
+TEST(AN2KIngest, Failures)
+{
+	/* Only minutiae, from files that cannot all be ingested */
+	BE::DataInterchange::AN2KIngestStores stores;
+	stores.minutiae = createStore("test_be_an2kingest_minutiae");
+	auto logsheet = std::make_shared<MemoryLogsheet>();
+	std::vector<std::string> paths = AN2KPaths;
+	paths.push_back("NonExistent");
+	paths.push_back("../test_data/img.wsq");
+	paths.push_back("../test_data/type9.an2k");
+
+	for (const bool ordered : {true, false}) {
+		BE::DataInterchange::AN2KIngestOptions options;
+		options.ordered = ordered;
+		options.logsheet = logsheet;
+		const auto summary = BE::DataInterchange::ingestAN2K(paths,
+		    stores, options);
+		EXPECT_EQ(paths.size(), summary.files);
+
+		/*
+		 * The second time through, every key exists, and only
+		 * type3 and type4-slaps, without minutiae, are ingested
+		 */
+		if (ordered) {
+			EXPECT_EQ(3u, summary.failures);
+			ASSERT_EQ(3u, logsheet->entries.size());
+			EXPECT_EQ(0u, logsheet->entries[0].find(
+			    "NonExistent: "));
+			EXPECT_EQ(0u, logsheet->entries[1].find(
+			    "../test_data/img.wsq: "));
+			EXPECT_EQ(0u, logsheet->entries[2].find(
+			    "../test_data/type9.an2k: "));
+			EXPECT_EQ(stores.minutiae->getCount(),
+			    summary.records);
+		} else {
+			EXPECT_EQ(paths.size() - 2, summary.failures);
+			EXPECT_EQ(0u, summary.records);
+		}
+	}
+	EXPECT_EQ(3u + paths.size() - 2, logsheet->entries.size());
+
+	stores = {};
+	BE::IO::RecordStore::removeRecordStore("test_be_an2kingest_minutiae");
+}
+
+TEST(AN2KIngest, PartialFailure)
+{
+	const std::vector<std::string> paths{"../test_data/type9-efs.an2k"};
+	BE::DataInterchange::AN2KIngestStores stores;
+	stores.minutiae = createStore("test_be_an2kingest_minutiae");
+	auto summary = BE::DataInterchange::ingestAN2K(paths, stores);
+	ASSERT_LE(2u, summary.records);
+
+	/* Keep only the second record, so that inserting it fails */
+	std::vector<std::string> keys;
+	for (const auto &record : *stores.minutiae)
+		keys.push_back(record.key);
+	std::string kept;
+	for (const auto &key : keys) {
+		if ((key.size() > 4) && (key.substr(key.size() - 4) == "_9_2"))
+			kept = key;
+		else
+			stores.minutiae->remove(key);
+	}
+	ASSERT_FALSE(kept.empty());
+	ASSERT_EQ(1u, stores.minutiae->getCount());
+
+	/* The first record, inserted before the failure, is removed */
+	auto logsheet = std::make_shared<MemoryLogsheet>();
+	BE::DataInterchange::AN2KIngestOptions options;
+	options.logsheet = logsheet;
+	summary = BE::DataInterchange::ingestAN2K(paths, stores, options);
+	EXPECT_EQ(1u, summary.failures);
+	EXPECT_EQ(0u, summary.records);
+	EXPECT_EQ(1u, logsheet->entries.size());
+	EXPECT_EQ(1u, stores.minutiae->getCount());
+	EXPECT_TRUE(stores.minutiae->containsKey(kept));
+
+	stores = {};
+	BE::IO::RecordStore::removeRecordStore("test_be_an2kingest_minutiae");
+}
+
+TEST(AN2KIngest, Keys)
+{
+	/* Paths that differ only in characters invalid in a key */
+	const std::string directory = "test_be_an2kingest_keys";
+	const auto buf = BE::IO::Utility::readFile(
+	    "../test_data/type9-13.an2k");
+	ASSERT_EQ(0, BE::IO::Utility::makePath(directory + "/a", S_IRWXU));
+	BE::IO::Utility::writeFile(buf, directory + "/a/b.an2k");
+	BE::IO::Utility::writeFile(buf, directory + "/a_b.an2k");
+	BE::IO::Utility::writeFile(buf, directory + "/a%2Fb.an2k");
+
+	BE::DataInterchange::AN2KIngestStores stores;
+	stores.minutiae = createStore("test_be_an2kingest_minutiae");
+	const auto summary = BE::DataInterchange::ingestAN2KDirectory(
+	    directory, stores);
+	EXPECT_EQ(3u, summary.files);
+	EXPECT_EQ(0u, summary.failures);
+	EXPECT_EQ(3u, summary.records);
+	EXPECT_TRUE(stores.minutiae->containsKey("a%2Fb.an2k_9_1"));
+	EXPECT_TRUE(stores.minutiae->containsKey("a_b.an2k_9_1"));
+	EXPECT_TRUE(stores.minutiae->containsKey("a%252Fb.an2k_9_1"));
+
+	stores = {};
+	BE::IO::RecordStore::removeRecordStore("test_be_an2kingest_minutiae");
+	BE::IO::Utility::removeDirectory(directory);
+}
+
+TEST(AN2KIngest, Parameters)
+{
+	BE::DataInterchange::AN2KIngestOptions options;
+	options.maxPending = 0;
+	EXPECT_THROW(BE::DataInterchange::ingestAN2K(AN2KPaths, {}, options),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(BE::DataInterchange::ingestAN2KDirectory("NonExistent",
+	    {}), BE::Error::ObjectDoesNotExist);
+
+	/* Nothing selected: files are still read and parsed */
+	const auto summary = BE::DataInterchange::ingestAN2K(AN2KPaths, {});
+	EXPECT_EQ(AN2KPaths.size(), summary.files);
+	EXPECT_EQ(0u, summary.failures);
+	EXPECT_EQ(0u, summary.records);
+}
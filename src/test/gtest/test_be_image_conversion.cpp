@@ -0,0 +1,300 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <be_error_exception.h>
+#include <be_image.h>
+#include <be_image_raw.h>
+#include <be_memory_autoarray.h>
+#include <be_memory_indexedbuffer.h>
+#include <be_memory_mutableindexedbuffer.h>
+
+namespace BE = BiometricEvaluation;
+
+/*
+ * Dimensions chosen so that conversions use every SIMD width and a
+ * scalar remainder.
+ */
+static const std::vector<BE::Image::Size> sizes{
+    {1, 1}, {3, 1}, {5, 3}, {37, 11}, {128, 64}};
+
+static uint64_t
+valueInColorspace(
+    uint64_t color,
+    uint64_t maxColorValue,
+    uint8_t depth)
+{
+	return ((((uint64_t)pow(2.0, depth) - 1) * color) / maxColorValue);
+}
+
+/*
+ * Pixel-at-a-time grayscale conversion, as implemented before SIMD
+ * kernels were introduced. Converted images must match this exactly.
+ */
+static BE::Memory::uint8Array
+referenceGrayscale(
+    const BE::Memory::uint8Array &rawColor,
+    uint32_t colorDepth,
+    uint64_t pixelCount,
+    uint8_t depth)
+{
+	const uint8_t bpcIn = static_cast<uint8_t>(std::ceil(colorDepth / 8.0));
+	BE::Memory::IndexedBuffer inBuffer{rawColor};
+
+	const uint8_t bpcOut = static_cast<uint8_t>(std::ceil(depth / 8.0));
+	BE::Memory::uint8Array rawGray(bpcOut * pixelCount);
+	BE::Memory::MutableIndexedBuffer outBuffer(rawGray);
+
+	static const float redFactor = 0.299;
+	static const float greenFactor = 0.587;
+	static const float blueFactor = 0.114;
+
+	uint16_t rValue, bValue, gValue;
+	for (uint32_t i = 0; i < rawColor.size(); i += bpcIn) {
+		switch (colorDepth) {
+		case 8:
+			outBuffer.pushU16Val(valueInColorspace(
+			    inBuffer.scanU8Val(), UINT8_MAX, 16));
+			break;
+		case 16:
+			outBuffer.pushU8Val(valueInColorspace(
+			    inBuffer.scanU16Val(), UINT16_MAX, 8));
+			break;
+		case 32:
+			/* FALLTHROUGH */
+		case 24:
+			if (depth == 16) {
+				rValue = static_cast<uint16_t>(
+				    valueInColorspace(inBuffer.scanU8Val(),
+				    UINT8_MAX, 16));
+				gValue = static_cast<uint16_t>(
+				    valueInColorspace(inBuffer.scanU8Val(),
+				    UINT8_MAX, 16));
+				bValue = static_cast<uint16_t>(
+				    valueInColorspace(inBuffer.scanU8Val(),
+				    UINT8_MAX, 16));
+				outBuffer.pushU16Val((rValue * redFactor) +
+				    (gValue * greenFactor) +
+				    (bValue * blueFactor));
+			} else {
+				rValue = inBuffer.scanU8Val();
+				gValue = inBuffer.scanU8Val();
+				bValue = inBuffer.scanU8Val();
+				outBuffer.pushU8Val(static_cast<uint8_t>(
+				    (rValue * redFactor) +
+				    (gValue * greenFactor) +
+				    (bValue * blueFactor)));
+			}
+			if (colorDepth == 32)
+				inBuffer.scanU8Val();
+			break;
+		case 64:
+			/* FALLTHROUGH */
+		case 48:
+			rValue = inBuffer.scanU16Val();
+			gValue = inBuffer.scanU16Val();
+			bValue = inBuffer.scanU16Val();
+			if (depth == 16) {
+				outBuffer.pushU16Val((rValue * redFactor) +
+				    (gValue * greenFactor) +
+				    (bValue * blueFactor));
+			} else {
+				rValue = static_cast<uint8_t>(
+				    valueInColorspace(rValue, UINT16_MAX, 8));
+				gValue = static_cast<uint8_t>(
+				    valueInColorspace(gValue, UINT16_MAX, 8));
+				bValue = static_cast<uint8_t>(
+				    valueInColorspace(bValue, UINT16_MAX, 8));
+				outBuffer.pushU8Val((rValue * redFactor) +
+				    (gValue * greenFactor) +
+				    (bValue * blueFactor));
+			}
+			if (colorDepth == 64)
+				inBuffer.scanU16Val();
+			break;
+		}
+	}
+
+	return (rawGray);
+}
+
+/* Random samples, with extremes at the start and end */
+static BE::Memory::uint8Array
+makeRawData(
+    uint64_t size,
+    std::mt19937 &generator)
+{
+	std::uniform_int_distribution<uint16_t> distribution(0, UINT8_MAX);
+	BE::Memory::uint8Array raw(size);
+	for (uint64_t i = 0; i < size; i++)
+		raw[i] = static_cast<uint8_t>(distribution(generator));
+	for (uint64_t i = 0; (i < 8) && (i < size); i++) {
+		raw[i] = 0xFF;
+		raw[size - i - 1] = 0x00;
+	}
+	return (raw);
+}
+
+TEST(ImageConversion, GrayscaleBitIdentical)
+{
+	std::mt19937 generator(31);
+
+	for (const auto &size : sizes) {
+		const uint64_t pixelCount = static_cast<uint64_t>(
+		    size.xSize) * size.ySize;
+		for (const uint32_t colorDepth : {8, 16, 24, 32, 48, 64}) {
+			const uint16_t bitDepth = (colorDepth % 16 == 0 &&
+			    colorDepth != 32 ? 16 : 8);
+			const BE::Memory::uint8Array raw = makeRawData(
+			    pixelCount * (colorDepth / 8), generator);
+			const BE::Image::Raw image(raw, size, colorDepth,
+			    bitDepth, BE::Image::Resolution(500, 500),
+			    (colorDepth == 32 || colorDepth == 64));
+
+			for (const uint8_t depth : {8, 16}) {
+				if (depth == colorDepth)
+					continue;
+
+				const auto expected = referenceGrayscale(raw,
+				    colorDepth, pixelCount, depth);
+				const auto actual = image.getRawGrayscaleData(
+				    depth);
+				ASSERT_EQ(expected.size(), actual.size());
+				for (uint64_t i = 0; i < expected.size(); i++)
+					ASSERT_EQ(expected[i], actual[i]) <<
+					    to_string(size) << ", " <<
+					    colorDepth << " -> " <<
+					    static_cast<int>(depth) <<
+					    ", byte " << i;
+			}
+		}
+	}
+}
+
+TEST(ImageConversion, GrayscaleExhaustive)
+{
+	/* Every 8-bit and 16-bit gray value */
+	BE::Memory::uint8Array gray8(256);
+	for (uint16_t i = 0; i <= UINT8_MAX; i++)
+		gray8[i] = static_cast<uint8_t>(i);
+	const BE::Image::Raw image8(gray8, BE::Image::Size(16, 16), 8, 8,
+	    BE::Image::Resolution(500, 500), false);
+	EXPECT_EQ(referenceGrayscale(gray8, 8, 256, 16),
+	    image8.getRawGrayscaleData(16));
+
+	BE::Memory::uint8Array gray16(65536 * 2);
+	for (uint32_t i = 0; i <= UINT16_MAX; i++) {
+		const uint16_t value = static_cast<uint16_t>(i);
+		std::memcpy(&gray16[i * 2], &value, sizeof(value));
+	}
+	const BE::Image::Raw image16(gray16, BE::Image::Size(256, 256), 16,
+	    16, BE::Image::Resolution(500, 500), false);
+	EXPECT_EQ(referenceGrayscale(gray16, 16, 65536, 8),
+	    image16.getRawGrayscaleData(8));
+}
+
+TEST(ImageConversion, GrayscaleQuantized)
+{
+	std::mt19937 generator(1);
+	const BE::Image::Size size(37, 11);
+	const uint64_t pixelCount = size.xSize * size.ySize;
+
+	for (const uint32_t colorDepth : {8, 16, 24}) {
+		const BE::Memory::uint8Array raw = makeRawData(
+		    pixelCount * (colorDepth / 8), generator);
+		const BE::Image::Raw image(raw, size, colorDepth,
+		    (colorDepth == 16 ? 16 : 8),
+		    BE::Image::Resolution(500, 500), false);
+
+		const auto gray = image.getRawGrayscaleData(8);
+		const auto bw = image.getRawGrayscaleData(1);
+		ASSERT_EQ(gray.size(), bw.size());
+		for (uint64_t i = 0; i < gray.size(); i++)
+			EXPECT_EQ((gray[i] <= 127 ? 0x00 : 0xFF), bw[i]);
+	}
+}
+
+TEST(ImageConversion, GrayscaleSizeMismatch)
+{
+	BE::Memory::uint8Array raw(10 * 10 * 3);
+	const BE::Image::Raw image(raw, BE::Image::Size(10, 11), 24, 8,
+	    BE::Image::Resolution(500, 500), false);
+	EXPECT_THROW(image.getRawGrayscaleData(8), BE::Error::DataError);
+}
+
+TEST(ImageConversion, RemoveComponents)
+{
+	std::mt19937 generator(32);
+
+	for (const auto &size : sizes) {
+		const uint64_t pixelCount = static_cast<uint64_t>(
+		    size.xSize) * size.ySize;
+		for (const uint8_t bitDepth : {8, 16}) {
+			const uint8_t componentSize = bitDepth / 8;
+			for (const std::vector<bool> &components :
+			    std::vector<std::vector<bool>>{
+			    {false, false, false, true},
+			    {true, false, false, false},
+			    {false, true, false},
+			    {false, true}}) {
+				const uint64_t pixelSize = components.size() *
+				    componentSize;
+				const auto raw = makeRawData(pixelCount *
+				    pixelSize, generator);
+
+				/* Components copied as-is, in order */
+				std::vector<uint8_t> expected;
+				for (uint64_t px = 0; px < pixelCount; px++)
+					for (uint8_t c = 0; c <
+					    components.size(); c++)
+						if (!components[c])
+							for (uint8_t b = 0; b <
+							    componentSize; b++)
+								expected.push_back(raw[
+								    (px * pixelSize) +
+								    (c * componentSize) +
+								    b]);
+
+				const auto actual = BE::Image::removeComponents(
+				    raw, bitDepth, components);
+				ASSERT_EQ(expected.size(), actual.size());
+				for (uint64_t i = 0; i < expected.size(); i++)
+					ASSERT_EQ(expected[i], actual[i]) <<
+					    to_string(size) << ", " <<
+					    static_cast<int>(bitDepth) <<
+					    "-bit, byte " << i;
+			}
+		}
+	}
+}
+
+TEST(ImageConversion, RemoveAlpha)
+{
+	std::mt19937 generator(33);
+	const BE::Image::Size size(37, 11);
+	const uint64_t pixelCount = size.xSize * size.ySize;
+	const auto raw = makeRawData(pixelCount * 4, generator);
+	const BE::Image::Raw image(raw, size, 32, 8,
+	    BE::Image::Resolution(500, 500), true);
+
+	const auto rgb = static_cast<const BE::Image::Image &>(
+	    image).getRawData(true);
+	ASSERT_EQ(pixelCount * 3, rgb.size());
+	for (uint64_t px = 0; px < pixelCount; px++)
+		for (uint8_t c = 0; c < 3; c++)
+			EXPECT_EQ(raw[(px * 4) + c], rgb[(px * 3) + c]);
+}
@@ -0,0 +1,186 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <be_error_exception.h>
+#include <be_image_decodebatch.h>
+#include <be_io_recordstore.h>
+#include <be_memory_autoarray.h>
+
+namespace BE = BiometricEvaluation;
+
+/* Side of the square test images, in pixels */
+static const uint32_t side = 32;
+
+/** @return Binary PGM image whose pixels all have value `value` */
+static BE::Memory::uint8Array
+makeImage(
+    uint8_t value)
+{
+	const std::string header = "P5\n" + std::to_string(side) + " " +
+	    std::to_string(side) + "\n255\n";
+	BE::Memory::uint8Array data(header.size() + (side * side));
+	std::copy(header.begin(), header.end(), data.begin());
+	std::fill(data.begin() + header.size(), data.end(), value);
+	return (data);
+}
+
+/** @return Images valued by index, with every seventh one invalid */
+static std::vector<BE::Memory::ByteSpan>
+makeBatch(
+    uint8_t count)
+{
+	std::vector<BE::Memory::ByteSpan> batch;
+	for (uint8_t i = 0; i < count; i++) {
+		if (i % 7 == 3)
+			batch.push_back(BE::Memory::ByteSpan::share(
+			    BE::Memory::uint8Array(16)));
+		else
+			batch.push_back(BE::Memory::ByteSpan::share(
+			    makeImage(i)));
+	}
+	return (batch);
+}
+
+static void
+checkItem(
+    const BE::Image::DecodedImage &item,
+    uint64_t expectedIndex,
+    bool fromBatch = true)
+{
+	ASSERT_EQ(expectedIndex, item.index);
+	if (fromBatch && (expectedIndex % 7 == 3)) {
+		EXPECT_TRUE(item.error);
+		EXPECT_EQ(nullptr, item.image);
+		EXPECT_EQ(0, item.rawData.size());
+		return;
+	}
+
+	ASSERT_FALSE(item.error);
+	ASSERT_NE(nullptr, item.image);
+	ASSERT_EQ(side * side, item.rawData.size());
+	EXPECT_EQ(expectedIndex, item.rawData[0]);
+	EXPECT_EQ(expectedIndex, item.rawData[(side * side) - 1]);
+}
+
+TEST(DecodeBatch, Ordered)
+{
+	const auto batch = makeBatch(100);
+	for (const uint32_t threads : {0, 1, 3, 8, 200}) {
+		BE::Image::DecodeBatchOptions options;
+		options.threads = threads;
+
+		uint64_t expected = 0;
+		BE::Image::decodeBatch(batch,
+		    [&](BE::Image::DecodedImage &&item) {
+			checkItem(item, expected++);
+		}, options);
+		EXPECT_EQ(batch.size(), expected) << threads << " threads";
+	}
+}
+
+TEST(DecodeBatch, Vector)
+{
+	const auto batch = makeBatch(50);
+	const auto items = BE::Image::decodeBatch(batch);
+	ASSERT_EQ(batch.size(), items.size());
+	for (uint64_t i = 0; i < items.size(); i++)
+		checkItem(items[i], i);
+
+	EXPECT_TRUE(BE::Image::decodeBatch(
+	    std::vector<BE::Memory::ByteSpan>()).empty());
+}
+
+TEST(DecodeBatch, Error)
+{
+	const auto items = BE::Image::decodeBatch(makeBatch(4));
+	ASSERT_TRUE(items[3].error);
+	EXPECT_THROW(std::rethrow_exception(items[3].error),
+	    BE::Error::Exception);
+}
+
+TEST(DecodeBatch, MemoryBudget)
+{
+	/* Less than one image, so at most one per thread is pending */
+	BE::Image::DecodeBatchOptions options;
+	options.threads = 4;
+	options.memoryBudget = 1;
+
+	const auto batch = makeBatch(60);
+	uint64_t expected = 0;
+	BE::Image::decodeBatch(batch, [&](BE::Image::DecodedImage &&item) {
+		checkItem(item, expected++);
+	}, options);
+	EXPECT_EQ(batch.size(), expected);
+}
+
+TEST(DecodeBatch, Grayscale)
+{
+	BE::Image::DecodeBatchOptions options;
+	options.grayscaleDepth = 16;
+
+	const auto items = BE::Image::decodeBatch(makeBatch(3), options);
+	ASSERT_EQ(3, items.size());
+	ASSERT_FALSE(items[2].error);
+	EXPECT_EQ(side * side * 2, items[2].rawData.size());
+}
+
+TEST(DecodeBatch, ConsumerException)
+{
+	BE::Image::DecodeBatchOptions options;
+	options.threads = 4;
+	options.memoryBudget = 1;
+
+	uint64_t consumed = 0;
+	EXPECT_THROW(BE::Image::decodeBatch(makeBatch(60),
+	    [&](BE::Image::DecodedImage&&) {
+		if (++consumed == 10)
+			throw BE::Error::StrategyError("Stop");
+	}, options), BE::Error::StrategyError);
+	EXPECT_EQ(10, consumed);
+}
+
+TEST(DecodeBatch, RecordStore)
+{
+	const std::string name = "test_be_image_decodebatch_rs";
+	std::vector<std::string> keys;
+	{
+		auto rs = BE::IO::RecordStore::createRecordStore(name,
+		    "Batch decoding", BE::IO::RecordStore::Kind::File);
+		for (uint8_t i = 0; i < 20; i++) {
+			keys.push_back("image" + std::to_string(i));
+			rs->insert(keys.back(), makeImage(i));
+		}
+		rs->sync();
+	}
+
+	auto rs = BE::IO::RecordStore::openRecordStore(name,
+	    BE::IO::Mode::ReadOnly);
+	keys.push_back("missing");
+	const auto items = BE::Image::decodeBatch(*rs, keys);
+	ASSERT_EQ(keys.size(), items.size());
+	for (uint64_t i = 0; i < 20; i++) {
+		EXPECT_EQ(keys[i], items[i].key);
+		checkItem(items[i], i, false);
+	}
+	ASSERT_TRUE(items.back().error);
+	EXPECT_THROW(std::rethrow_exception(items.back().error),
+	    BE::Error::ObjectDoesNotExist);
+
+	rs.reset();
+	BE::IO::RecordStore::removeRecordStore(name);
+}
@@ -0,0 +1,157 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <be_image_decodecache.h>
+#include <be_image_netpbm.h>
+#include <be_memory_autoarray.h>
+
+namespace BE = BiometricEvaluation;
+
+/* Side of the square test images, in pixels */
+static const uint32_t side = 64;
+
+/** @return Binary PGM image whose pixels all have value `value` */
+static std::shared_ptr<BE::Image::NetPBM>
+makeImage(
+    uint8_t value)
+{
+	const std::string header = "P5\n" + std::to_string(side) + " " +
+	    std::to_string(side) + "\n255\n";
+	BE::Memory::uint8Array data(header.size() + (side * side));
+	std::copy(header.begin(), header.end(), data.begin());
+	std::fill(data.begin() + header.size(), data.end(), value);
+	return (std::make_shared<BE::Image::NetPBM>(data));
+}
+
+class DecodeCache : public ::testing::Test
+{
+protected:
+	void
+	SetUp()
+	    override
+	{
+		BE::Image::DecodeCache::setBudget(side * side * 2);
+		BE::Image::DecodeCache::resetStatistics();
+	}
+
+	void
+	TearDown()
+	    override
+	{
+		BE::Image::DecodeCache::setBudget(
+		    BE::Image::DecodeCache::DEFAULT_BUDGET);
+	}
+};
+
+TEST(DecodeCacheDefault, Disabled)
+{
+	EXPECT_EQ(0, BE::Image::DecodeCache::getBudget());
+
+	const auto image = makeImage(1);
+	image->getRawData();
+	image->getRawData();
+
+	const auto stats = BE::Image::DecodeCache::getStatistics();
+	EXPECT_EQ(0, stats.decodes);
+	EXPECT_EQ(0, stats.decodesAvoided);
+	EXPECT_EQ(0, stats.cachedImages);
+}
+
+TEST_F(DecodeCache, Memoization)
+{
+	auto image = makeImage(7);
+
+	const auto raw = image->getRawData();
+	ASSERT_EQ(side * side, raw.size());
+	EXPECT_EQ(7, raw[0]);
+	EXPECT_EQ(7, image->getRawData()[side]);
+
+	/* Derived data and spans share the decoded data */
+	const auto gray = image->getRawGrayscaleData(16);
+	EXPECT_EQ(side * side * 2, gray.size());
+	const auto span1 = image->getRawDataSpan();
+	const auto span2 = image->getRawDataSpan();
+	EXPECT_EQ(span1.data(), span2.data());
+
+	auto stats = BE::Image::DecodeCache::getStatistics();
+	EXPECT_EQ(1, stats.decodes);
+	EXPECT_EQ(4, stats.decodesAvoided);
+	EXPECT_EQ(1, stats.cachedImages);
+	EXPECT_EQ(side * side, stats.cachedSize);
+
+	/* Spans outlive the cache entry */
+	image.reset();
+	stats = BE::Image::DecodeCache::getStatistics();
+	EXPECT_EQ(0, stats.cachedImages);
+	EXPECT_EQ(0, stats.cachedSize);
+	EXPECT_EQ(7, span1[side * side - 1]);
+}
+
+TEST_F(DecodeCache, Eviction)
+{
+	/* Budget holds two images */
+	const auto first = makeImage(1);
+	const auto second = makeImage(2);
+	const auto third = makeImage(3);
+
+	first->getRawData();
+	second->getRawData();
+	first->getRawData();
+	third->getRawData();
+
+	/* second was least recently used */
+	auto stats = BE::Image::DecodeCache::getStatistics();
+	EXPECT_EQ(3, stats.decodes);
+	EXPECT_EQ(1, stats.decodesAvoided);
+	EXPECT_EQ(1, stats.evictions);
+	EXPECT_EQ(2, stats.cachedImages);
+
+	first->getRawData();
+	third->getRawData();
+	stats = BE::Image::DecodeCache::getStatistics();
+	EXPECT_EQ(3, stats.decodes);
+	EXPECT_EQ(3, stats.decodesAvoided);
+
+	EXPECT_EQ(2, second->getRawData()[0]);
+	stats = BE::Image::DecodeCache::getStatistics();
+	EXPECT_EQ(4, stats.decodes);
+	EXPECT_EQ(2, stats.evictions);
+
+	/* Lowering the budget evicts */
+	BE::Image::DecodeCache::setBudget(side * side);
+	stats = BE::Image::DecodeCache::getStatistics();
+	EXPECT_EQ(1, stats.cachedImages);
+	EXPECT_EQ(3, stats.evictions);
+
+	BE::Image::DecodeCache::clear();
+	stats = BE::Image::DecodeCache::getStatistics();
+	EXPECT_EQ(0, stats.cachedImages);
+	EXPECT_EQ(0, stats.cachedSize);
+}
+
+TEST_F(DecodeCache, OverBudget)
+{
+	BE::Image::DecodeCache::setBudget((side * side) - 1);
+
+	const auto image = makeImage(4);
+	image->getRawData();
+	image->getRawData();
+
+	const auto stats = BE::Image::DecodeCache::getStatistics();
+	EXPECT_EQ(2, stats.decodes);
+	EXPECT_EQ(0, stats.decodesAvoided);
+	EXPECT_EQ(0, stats.cachedImages);
+}
@@ -0,0 +1,187 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <be_error_exception.h>
+#include <be_image_decodecache.h>
+#include <be_image_encode.h>
+#include <be_image_image.h>
+#include <be_image_netpbm.h>
+#include <be_image_raw.h>
+#include <be_image_wsq.h>
+#include <be_io_utility.h>
+
+#include "test_be_image_pattern.h"
+
+namespace BE = BiometricEvaluation;
+using TestImages::pattern;
+
+/** Value of bytes between rows, which decodeInto() must not modify */
+static const uint8_t Padding = 0xA5;
+
+/** Expect decodeInto() to produce getRawData(), packed and padded */
+static void
+expectMatchesRawData(
+    const BE::Image::Image &image)
+{
+	const auto rawData = image.getRawData();
+	const uint64_t rowSize = image.getRawRowSize();
+	const uint32_t height = image.getDimensions().ySize;
+	ASSERT_EQ(rowSize * height, rawData.size());
+	ASSERT_EQ(rawData.size(), image.requiredBufferSize());
+
+	BE::Memory::uint8Array packed;
+	image.decodeInto(packed);
+	EXPECT_EQ(rawData, packed);
+
+	const uint64_t stride = rowSize + 13;
+	BE::Memory::uint8Array padded(image.requiredBufferSize(stride));
+	std::fill(padded.begin(), padded.end(), Padding);
+	image.decodeInto(padded, padded.size(), stride);
+	for (uint32_t row = 0; row < height; row++) {
+		const uint8_t *rawRow = padded + (row * stride);
+		ASSERT_TRUE(std::equal(rawRow, rawRow + rowSize,
+		    rawData + (row * rowSize))) << "Row " << row;
+		if (row != (height - 1))
+			ASSERT_TRUE(std::all_of(rawRow + rowSize,
+			    rawRow + stride, [](uint8_t b) {
+			    return (b == Padding); })) << "Row " << row;
+	}
+}
+
+/** @return NetPBM image of the given kind with a 5x3 pattern */
+static BE::Memory::uint8Array
+netpbm(
+    const std::string &header,
+    uint32_t bytes)
+{
+	BE::Memory::uint8Array data(header.size() + bytes);
+	std::copy(header.begin(), header.end(), data.begin());
+	for (uint32_t i = 0; i < bytes; i++)
+		data[header.size() + i] = static_cast<uint8_t>(i * 29);
+	return (data);
+}
+
+TEST(ImageDecodeInto, WSQ)
+{
+	const BE::Image::WSQ wsq(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+	expectMatchesRawData(wsq);
+}
+
+TEST(ImageDecodeInto, JPEG)
+{
+	const auto jpeg = BE::Image::Image::openImage(
+	    BE::IO::Utility::readFile("../test_data/img.jpg"));
+	expectMatchesRawData(*jpeg);
+
+	const BE::Image::WSQ wsq(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+	const BE::Image::Raw gray(wsq.getRawData(), wsq.getDimensions(), 8, 8,
+	    wsq.getResolution(), false);
+	for (const auto algorithm : {BE::Image::CompressionAlgorithm::JPEGB,
+	    BE::Image::CompressionAlgorithm::JPEGL})
+		expectMatchesRawData(*BE::Image::Image::openImage(
+		    BE::Image::encode(gray, algorithm)));
+}
+
+TEST(ImageDecodeInto, PNG)
+{
+	for (const auto &format : std::vector<std::vector<uint32_t>>{
+	    {8, 8, 0}, {16, 8, 1}, {24, 8, 0}, {32, 8, 1}, {48, 16, 0}}) {
+		const auto raw = pattern(format[0], format[1], format[2]);
+		expectMatchesRawData(raw);
+		expectMatchesRawData(*BE::Image::Image::openImage(
+		    BE::Image::encode(raw,
+		    BE::Image::CompressionAlgorithm::PNG)));
+	}
+}
+
+TEST(ImageDecodeInto, NetPBM)
+{
+	/* Bitmaps expand to one byte per pixel */
+	const BE::Image::NetPBM bitmap(netpbm("P4\n5 3\n", 3));
+	EXPECT_EQ(5u, bitmap.getRawRowSize());
+	expectMatchesRawData(bitmap);
+
+	expectMatchesRawData(BE::Image::NetPBM(netpbm("P5\n5 3\n255\n", 15)));
+	expectMatchesRawData(BE::Image::NetPBM(netpbm("P5\n5 3\n65535\n",
+	    30)));
+	expectMatchesRawData(BE::Image::NetPBM(netpbm("P6\n5 3\n255\n", 45)));
+	expectMatchesRawData(BE::Image::NetPBM(netpbm(
+	    "P2\n5 3\n255\n1 2 3 4 5 6 7 8 9 10 11 12 13 14 15\n", 0)));
+
+	/* Truncated */
+	const BE::Image::NetPBM truncated(netpbm("P5\n5 3\n255\n", 14));
+	BE::Memory::uint8Array buffer(truncated.requiredBufferSize());
+	EXPECT_THROW(truncated.decodeInto(buffer, buffer.size()),
+	    BE::Error::DataError);
+}
+
+TEST(ImageDecodeInto, Parameters)
+{
+	const auto raw = pattern(24, 8, false);
+	const uint64_t rowSize = raw.getRawRowSize();
+	EXPECT_EQ(61u * 3, rowSize);
+	EXPECT_EQ((rowSize + 1) * 36 + rowSize,
+	    raw.requiredBufferSize(rowSize + 1));
+	EXPECT_THROW(raw.requiredBufferSize(rowSize - 1),
+	    BE::Error::ParameterError);
+
+	BE::Memory::uint8Array buffer(raw.requiredBufferSize());
+	EXPECT_THROW(raw.decodeInto(buffer, buffer.size() - 1),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(raw.decodeInto(buffer, buffer.size(), rowSize - 1),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(raw.decodeInto(nullptr, buffer.size()),
+	    BE::Error::ParameterError);
+}
+
+TEST(ImageDecodeInto, Reuse)
+{
+	const BE::Image::WSQ wsq(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+	const auto small = pattern(8, 8, false);
+
+	/* Shrinking keeps the storage of the larger image */
+	BE::Memory::uint8Array buffer;
+	wsq.decodeInto(buffer);
+	const uint8_t *storage = buffer;
+	small.decodeInto(buffer);
+	EXPECT_EQ(small.requiredBufferSize(), buffer.size());
+	EXPECT_EQ(storage, static_cast<const uint8_t *>(buffer));
+	EXPECT_EQ(small.getRawData(), buffer);
+}
+
+TEST(ImageDecodeInto, DecodeCache)
+{
+	const BE::Image::WSQ wsq(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+	const auto expected = wsq.getRawData();
+
+	BE::Image::DecodeCache::setBudget(64 * 1024 * 1024);
+	BE::Image::DecodeCache::resetStatistics();
+	const auto cached = wsq.getRawData();
+	BE::Memory::uint8Array buffer;
+	wsq.decodeInto(buffer);
+	const auto statistics = BE::Image::DecodeCache::getStatistics();
+	BE::Image::DecodeCache::setBudget(0);
+
+	EXPECT_EQ(expected, cached);
+	EXPECT_EQ(expected, buffer);
+	EXPECT_EQ(1u, statistics.decodes);
+	EXPECT_EQ(1u, statistics.decodesAvoided);
+}
@@ -0,0 +1,167 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <be_error_exception.h>
+#include <be_image_decodecache.h>
+#include <be_image_encode.h>
+#include <be_image_image.h>
+#include <be_image_netpbm.h>
+#include <be_image_raw.h>
+#include <be_image_wsq.h>
+#include <be_io_utility.h>
+
+#include "test_be_image_pattern.h"
+
+namespace BE = BiometricEvaluation;
+using TestImages::pattern;
+
+/**
+ * @return Raw data assembled from decodeRows(), checking that rows
+ * arrive in order and in chunks of at most rowsPerChunk rows.
+ */
+static BE::Memory::uint8Array
+assembleRows(
+    const BE::Image::Image &image,
+    uint32_t rowsPerChunk,
+    std::vector<uint32_t> &chunkSizes)
+{
+	const uint64_t rowSize = image.getRawRowSize();
+	BE::Memory::uint8Array rawData(image.requiredBufferSize());
+	uint32_t nextRow = 0;
+	chunkSizes.clear();
+	image.decodeRows([&](uint32_t firstRow, uint32_t rowCount,
+	    const uint8_t *rows) {
+		EXPECT_EQ(nextRow, firstRow);
+		EXPECT_GT(rowCount, 0u);
+		if (rowsPerChunk != 0)
+			EXPECT_LE(rowCount, rowsPerChunk);
+		ASSERT_LE(firstRow + rowCount, image.getDimensions().ySize);
+		std::copy(rows, rows + (rowCount * rowSize),
+		    rawData + (firstRow * rowSize));
+		chunkSizes.push_back(rowCount);
+		nextRow = firstRow + rowCount;
+	    }, rowsPerChunk);
+	EXPECT_EQ(image.getDimensions().ySize, nextRow);
+
+	return (rawData);
+}
+
+/** Expect decodeRows() to produce getRawData() for several chunk sizes */
+static void
+expectMatchesRawData(
+    const BE::Image::Image &image)
+{
+	const auto rawData = image.getRawData();
+	std::vector<uint32_t> chunkSizes;
+	for (const uint32_t rowsPerChunk : {0u, 1u, 7u, 16u, 100000u})
+		EXPECT_EQ(rawData, assembleRows(image, rowsPerChunk,
+		    chunkSizes)) << "rowsPerChunk = " << rowsPerChunk;
+}
+
+TEST(ImageDecodeRows, WSQ)
+{
+	const BE::Image::WSQ wsq(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+	expectMatchesRawData(wsq);
+
+	/* Decoded whole, so the natural chunk is the whole image */
+	std::vector<uint32_t> chunkSizes;
+	assembleRows(wsq, 0, chunkSizes);
+	EXPECT_EQ(1u, chunkSizes.size());
+}
+
+TEST(ImageDecodeRows, JPEG)
+{
+	const auto jpeg = BE::Image::Image::openImage(
+	    BE::IO::Utility::readFile("../test_data/img.jpg"));
+	expectMatchesRawData(*jpeg);
+
+	/* One row of MCUs at a time */
+	std::vector<uint32_t> chunkSizes;
+	assembleRows(*jpeg, 0, chunkSizes);
+	ASSERT_LT(1u, chunkSizes.size());
+	EXPECT_TRUE((chunkSizes.front() == 8) || (chunkSizes.front() == 16));
+
+	const BE::Image::WSQ wsq(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+	const BE::Image::Raw gray(wsq.getRawData(), wsq.getDimensions(), 8, 8,
+	    wsq.getResolution(), false);
+	for (const auto algorithm : {BE::Image::CompressionAlgorithm::JPEGB,
+	    BE::Image::CompressionAlgorithm::JPEGL})
+		expectMatchesRawData(*BE::Image::Image::openImage(
+		    BE::Image::encode(gray, algorithm)));
+}
+
+TEST(ImageDecodeRows, PNG)
+{
+	for (const auto &format : std::vector<std::vector<uint32_t>>{
+	    {8, 8, 0}, {16, 8, 1}, {24, 8, 0}, {32, 8, 1}, {48, 16, 0}}) {
+		const auto raw = pattern(format[0], format[1], format[2]);
+		expectMatchesRawData(raw);
+		const auto png = BE::Image::Image::openImage(BE::Image::encode(
+		    raw, BE::Image::CompressionAlgorithm::PNG));
+		expectMatchesRawData(*png);
+
+		std::vector<uint32_t> chunkSizes;
+		assembleRows(*png, 0, chunkSizes);
+		EXPECT_LT(1u, chunkSizes.size());
+	}
+}
+
+TEST(ImageDecodeRows, NetPBM)
+{
+	const std::string header = "P5\n5 3\n255\n";
+	BE::Memory::uint8Array data(header.size() + 15);
+	std::copy(header.begin(), header.end(), data.begin());
+	expectMatchesRawData(BE::Image::NetPBM(data));
+}
+
+TEST(ImageDecodeRows, Callback)
+{
+	const auto raw = pattern(8, 8, false);
+	EXPECT_THROW(raw.decodeRows({}), BE::Error::ParameterError);
+
+	/* Exceptions from the callback stop decoding */
+	const auto jpeg = BE::Image::Image::openImage(
+	    BE::IO::Utility::readFile("../test_data/img.jpg"));
+	uint32_t calls = 0;
+	EXPECT_THROW(jpeg->decodeRows([&](uint32_t, uint32_t, const uint8_t*) {
+		if (++calls == 2)
+			throw std::runtime_error("Stop");
+	    }, 1), std::runtime_error);
+	EXPECT_EQ(2u, calls);
+}
+
+TEST(ImageDecodeRows, DecodeCache)
+{
+	const BE::Image::WSQ wsq(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+	const auto expected = wsq.getRawData();
+
+	BE::Image::DecodeCache::setBudget(64 * 1024 * 1024);
+	BE::Image::DecodeCache::resetStatistics();
+	wsq.getRawDataSpan();
+	std::vector<uint32_t> chunkSizes;
+	const auto rawData = assembleRows(wsq, 10, chunkSizes);
+	const auto statistics = BE::Image::DecodeCache::getStatistics();
+	BE::Image::DecodeCache::setBudget(0);
+
+	EXPECT_EQ(expected, rawData);
+	EXPECT_EQ(1u, statistics.decodes);
+	EXPECT_EQ(1u, statistics.decodesAvoided);
+}
@@ -0,0 +1,167 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <be_image_bmp.h>
+#include <be_image_encode.h>
+#include <be_image_image.h>
+#include <be_image_jpeg.h>
+#include <be_image_jpeg2000.h>
+#include <be_image_jpegl.h>
+#include <be_image_netpbm.h>
+#include <be_image_png.h>
+#include <be_image_raw.h>
+#include <be_image_tiff.h>
+#include <be_image_wsq.h>
+#include <be_io_utility.h>
+
+namespace BE = BiometricEvaluation;
+
+/** @return Compression algorithm found by each codec's predicate in turn */
+static BE::Image::CompressionAlgorithm
+detectWithPredicates(
+    const uint8_t *data,
+    uint64_t size)
+{
+	if ((size > 0) && BE::Image::NetPBM::isNetPBM(data, size))
+		return (BE::Image::CompressionAlgorithm::NetPBM);
+	else if (BE::Image::JPEG2000::isJPEG2000(data, size))
+		return (BE::Image::CompressionAlgorithm::JP2);
+	else if (BE::Image::JPEG::isJPEG(data, size))
+		return (BE::Image::CompressionAlgorithm::JPEGB);
+	else if (BE::Image::JPEGL::isJPEGL(data, size))
+		return (BE::Image::CompressionAlgorithm::JPEGL);
+	else if (BE::Image::PNG::isPNG(data, size))
+		return (BE::Image::CompressionAlgorithm::PNG);
+	else if (BE::Image::BMP::isBMP(data, size))
+		return (BE::Image::CompressionAlgorithm::BMP);
+	else if (BE::Image::WSQ::isWSQ(data, size))
+		return (BE::Image::CompressionAlgorithm::WSQ20);
+	else if (BE::Image::TIFF::isTIFF(data, size))
+		return (BE::Image::CompressionAlgorithm::TIFF);
+	return (BE::Image::CompressionAlgorithm::None);
+}
+
+/** @return Compression algorithm of the leading bytes of a string */
+static BE::Image::CompressionAlgorithm
+detect(
+    const std::string &data)
+{
+	return (BE::Image::Image::getCompressionAlgorithm(
+	    reinterpret_cast<const uint8_t*>(data.data()), data.size()));
+}
+
+TEST(ImageDetect, Signatures)
+{
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::NetPBM, detect("P5\n1 1"));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::NetPBM,
+	    detect("# comment\n# another\nP6\n1 1"));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::None,
+	    detect("# comment\nP7\n"));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::None, detect("P7"));
+	for (const auto &magic : {"BM", "BA", "CI", "CP", "IC", "PT"})
+		EXPECT_EQ(BE::Image::CompressionAlgorithm::BMP,
+		    detect(magic)) << magic;
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::TIFF,
+	    detect(std::string("II*\0", 4)));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::TIFF,
+	    detect(std::string("MM\0*", 4)));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::WSQ20,
+	    detect("\xFF\xA0\xFF\xA8"));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::PNG,
+	    detect(std::string("\x89PNG\r\n\x1A\n\0", 9)));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::JP2,
+	    detect(std::string("\0\0\0\x0CjP  \r\n\x87\n", 12)));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::None, detect("GIF89a"));
+}
+
+TEST(ImageDetect, Truncated)
+{
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::None, detect(""));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::None, detect("P"));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::None, detect("II*"));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::None,
+	    detect("\x89PNG\r\n\x1A\n"));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::None,
+	    detect(std::string("\0\0\0\x0CjP  \r\n\x87", 11)));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::None, detect("\xFF\xD8"));
+}
+
+TEST(ImageDetect, JPEG)
+{
+	const auto jpeg = BE::IO::Utility::readFile("../test_data/img.jpg");
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::JPEGB,
+	    BE::Image::Image::getCompressionAlgorithm(jpeg));
+
+	const BE::Image::WSQ wsq(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+	const auto jpegl = BE::Image::encode(BE::Image::Raw(wsq.getRawData(),
+	    wsq.getDimensions(), 8, 8, wsq.getResolution(), false),
+	    BE::Image::CompressionAlgorithm::JPEGL);
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::JPEGL,
+	    BE::Image::Image::getCompressionAlgorithm(jpegl));
+
+	/* Start of scan before any start of frame */
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::None,
+	    detect("\xFF\xD8\xFF\xDA"));
+
+	/* Fill bytes before markers, odd and even in number */
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::JPEGB,
+	    detect("\xFF\xD8\xFF\xFF\xC0"));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::JPEGL,
+	    detect("\xFF\xD8\xFF\xFF\xFF\xC3"));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::None,
+	    detect("\xFF\xD8\xFF\xFF\xFF\xDA"));
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::None,
+	    detect("\xFF\xD8\xFF\xFF"));
+
+	/* Fill bytes directly before the start of frame */
+	std::string filled(reinterpret_cast<const char*>(&jpeg[0]),
+	    jpeg.size());
+	const auto sof = filled.find("\xFF\xC0");
+	ASSERT_NE(std::string::npos, sof);
+	filled.insert(sof, "\xFF\xFF\xFF");
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::JPEGB, detect(filled));
+	EXPECT_TRUE(BE::Image::JPEG::isJPEG(reinterpret_cast<const uint8_t*>(
+	    filled.data()), filled.size()));
+}
+
+TEST(ImageDetect, MatchesPredicates)
+{
+	for (const auto &path : {"../test_data/img.wsq",
+	    "../test_data/img.jpg", "../test_data/img.jp2"}) {
+		const auto data = BE::IO::Utility::readFile(path);
+		EXPECT_EQ(detectWithPredicates(data, data.size()),
+		    BE::Image::Image::getCompressionAlgorithm(data)) << path;
+	}
+
+	/* Random data, often starting with part of a signature */
+	static const std::vector<std::string> Prefixes{"", "#", "#\n", "B",
+	    "C", "I", "M", "P", "\x89PNG", "\xFF", "\xFF\xD8\xFF",
+	    std::string("\0\0\0\x0CjP", 6)};
+	std::mt19937 engine(20261018);
+	std::uniform_int_distribution<int> byte(0, 255), length(0, 24);
+	for (uint32_t i = 0; i < 100000; i++) {
+		std::string data = Prefixes[i % Prefixes.size()];
+		for (int n = length(engine); n > 0; n--)
+			data.push_back(static_cast<char>(byte(engine)));
+		const auto bytes = reinterpret_cast<const uint8_t*>(
+		    data.data());
+		ASSERT_EQ(detectWithPredicates(bytes, data.size()),
+		    detect(data));
+	}
+}
@@ -0,0 +1,209 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <be_error_exception.h>
+#include <be_image_encode.h>
+#include <be_image_jpeg.h>
+#include <be_image_jpegl.h>
+#include <be_image_png.h>
+#include <be_image_raw.h>
+#include <be_image_wsq.h>
+#include <be_io_utility.h>
+
+#include "test_be_image_pattern.h"
+
+namespace BE = BiometricEvaluation;
+using TestImages::pattern;
+
+/** @return Mean absolute difference between two buffers of equal size */
+static double
+meanError(
+    const BE::Memory::uint8Array &a,
+    const BE::Memory::uint8Array &b)
+{
+	uint64_t total = 0;
+	for (uint64_t i = 0; i < a.size(); i++)
+		total += std::abs(static_cast<int>(a[i]) - b[i]);
+	return (static_cast<double>(total) / a.size());
+}
+
+/** @return Decoded fingerprint from the WSQ test image, as Raw */
+static std::shared_ptr<BE::Image::Raw>
+fingerprint()
+{
+	const BE::Image::WSQ wsq(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+	return (std::make_shared<BE::Image::Raw>(wsq.getRawData(),
+	    wsq.getDimensions(), 8, 8, wsq.getResolution(), false));
+}
+
+TEST(ImageEncode, WSQ)
+{
+	const auto raw = fingerprint();
+	const auto encoded = BE::Image::encode(*raw,
+	    BE::Image::CompressionAlgorithm::WSQ20);
+	ASSERT_TRUE(BE::Image::WSQ::isWSQ(encoded, encoded.size()));
+
+	const BE::Image::WSQ wsq(encoded);
+	EXPECT_EQ(raw->getDimensions(), wsq.getDimensions());
+	EXPECT_DOUBLE_EQ(500, wsq.getResolution().xRes);
+	const auto decoded = wsq.getRawData();
+	ASSERT_EQ(raw->getRawData().size(), decoded.size());
+	EXPECT_LT(meanError(raw->getRawData(), decoded), 4);
+
+	/* Lower bitrates compress more */
+	BE::Image::EncodeParameters parameters;
+	parameters.wsqBitrate = 2.25;
+	EXPECT_GT(BE::Image::encode(*raw,
+	    BE::Image::CompressionAlgorithm::WSQ20, parameters).size(),
+	    encoded.size());
+}
+
+TEST(ImageEncode, JPEGL)
+{
+	const auto raw = fingerprint();
+	const auto encoded = BE::Image::encode(*raw,
+	    BE::Image::CompressionAlgorithm::JPEGL);
+	ASSERT_TRUE(BE::Image::JPEGL::isJPEGL(encoded, encoded.size()));
+
+	const BE::Image::JPEGL jpegl(encoded);
+	EXPECT_EQ(raw->getDimensions(), jpegl.getDimensions());
+	EXPECT_DOUBLE_EQ(500, jpegl.getResolution().xRes);
+	EXPECT_EQ(raw->getRawData(), jpegl.getRawData());
+}
+
+TEST(ImageEncode, JPEG)
+{
+	const BE::Image::JPEG color(BE::IO::Utility::readFile(
+	    "../test_data/img.jpg"));
+	BE::Image::EncodeParameters parameters;
+	parameters.jpegQuality = 95;
+	parameters.resolution = {300, 300, BE::Image::Resolution::Units::PPI};
+	const auto encoded = BE::Image::encode(color,
+	    BE::Image::CompressionAlgorithm::JPEGB, parameters);
+
+	const BE::Image::JPEG jpeg(encoded);
+	EXPECT_EQ(color.getDimensions(), jpeg.getDimensions());
+	EXPECT_EQ(24u, jpeg.getColorDepth());
+	EXPECT_DOUBLE_EQ(300, jpeg.getResolution().xRes);
+	EXPECT_LT(meanError(color.getRawData(), jpeg.getRawData()), 4);
+
+	const auto raw = fingerprint();
+	const BE::Image::JPEG gray(BE::Image::encode(*raw,
+	    BE::Image::CompressionAlgorithm::JPEGB));
+	EXPECT_EQ(8u, gray.getColorDepth());
+	EXPECT_LT(meanError(raw->getRawData(), gray.getRawData()), 4);
+}
+
+TEST(ImageEncode, PNG)
+{
+	struct Format { uint32_t colorDepth; uint16_t bitDepth; bool alpha; };
+	for (const auto &format : std::vector<Format>{{8, 8, false},
+	    {16, 8, true}, {24, 8, false}, {32, 8, true}, {16, 16, false},
+	    {48, 16, false}, {64, 16, true}}) {
+		const auto raw = pattern({61, 37}, format.colorDepth,
+		    format.bitDepth, format.alpha);
+		BE::Image::EncodeParameters parameters;
+		parameters.pngCompressionLevel = 9;
+		const BE::Image::PNG png(BE::Image::encode(raw,
+		    BE::Image::CompressionAlgorithm::PNG, parameters));
+
+		EXPECT_EQ(raw.getDimensions(), png.getDimensions());
+		EXPECT_EQ(format.colorDepth, png.getColorDepth());
+		EXPECT_EQ(format.bitDepth, png.getBitDepth());
+		EXPECT_EQ(format.alpha, png.hasAlphaChannel());
+		EXPECT_NEAR(500, png.getResolution().toUnits(
+		    BE::Image::Resolution::Units::PPI).xRes, 0.1);
+		EXPECT_EQ(raw.getRawData(), png.getRawData()) <<
+		    format.colorDepth << "-bit";
+	}
+}
+
+TEST(ImageEncode, ReuseOutput)
+{
+	const auto raw = fingerprint();
+	for (const auto algorithm : {BE::Image::CompressionAlgorithm::WSQ20,
+	    BE::Image::CompressionAlgorithm::JPEGL,
+	    BE::Image::CompressionAlgorithm::JPEGB,
+	    BE::Image::CompressionAlgorithm::PNG}) {
+		/* Stale contents are replaced */
+		BE::Memory::uint8Array output(4 * 1024 * 1024);
+		output[0] = 0xAB;
+		const uint8_t *storage = output;
+		BE::Image::encode(*raw, algorithm, output);
+		EXPECT_EQ(BE::Image::encode(*raw, algorithm), output);
+
+		/* Storage large enough is not reallocated */
+		BE::Image::encode(*raw, algorithm, output);
+		EXPECT_EQ(storage, static_cast<const uint8_t *>(output));
+	}
+}
+
+TEST(ImageEncode, Unsupported)
+{
+	const auto raw = fingerprint();
+	EXPECT_THROW(BE::Image::encode(*raw,
+	    BE::Image::CompressionAlgorithm::JP2), BE::Error::NotImplemented);
+	EXPECT_THROW(BE::Image::encode(*raw,
+	    BE::Image::CompressionAlgorithm::None), BE::Error::NotImplemented);
+
+	const auto color = pattern({10, 10}, 24, 8, false);
+	EXPECT_THROW(BE::Image::encode(color,
+	    BE::Image::CompressionAlgorithm::WSQ20), BE::Error::ParameterError);
+	EXPECT_THROW(BE::Image::encode(color,
+	    BE::Image::CompressionAlgorithm::JPEGL), BE::Error::ParameterError);
+
+	BE::Image::EncodeParameters parameters;
+	parameters.jpegQuality = 101;
+	EXPECT_THROW(BE::Image::encode(*raw,
+	    BE::Image::CompressionAlgorithm::JPEGB, parameters),
+	    BE::Error::ParameterError);
+	parameters = {};
+	parameters.wsqBitrate = 0;
+	EXPECT_THROW(BE::Image::encode(*raw,
+	    BE::Image::CompressionAlgorithm::WSQ20, parameters),
+	    BE::Error::ParameterError);
+}
+
+TEST(ImageEncode, Concurrent)
+{
+	const auto raw = fingerprint();
+	const auto expected = BE::Image::encode(*raw,
+	    BE::Image::CompressionAlgorithm::WSQ20);
+
+	std::vector<std::thread> threads;
+	std::vector<uint32_t> mismatches(std::max(4u,
+	    std::thread::hardware_concurrency()), 0);
+	for (auto &count : mismatches) {
+		threads.emplace_back([&]() {
+			BE::Memory::uint8Array output;
+			for (int i = 0; i < 10; i++) {
+				BE::Image::encode(*raw,
+				    BE::Image::CompressionAlgorithm::WSQ20,
+				    output);
+				if (output != expected)
+					count++;
+			}
+		});
+	}
+	for (auto &thread : threads)
+		thread.join();
+
+	for (const auto count : mismatches)
+		EXPECT_EQ(0u, count);
+}
@@ -0,0 +1,59 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#ifndef TEST_BE_IMAGE_PATTERN_H_
+#define TEST_BE_IMAGE_PATTERN_H_
+
+/*
+ * Synthetic images shared by the image tests.
+ */
+
+#include <cstdint>
+
+#include <be_image.h>
+#include <be_image_raw.h>
+#include <be_memory_autoarray.h>
+
+namespace TestImages
+{
+	/**
+	 * @return Raw image of size with a pattern varying by pixel and
+	 * component, at 500 PPI.
+	 */
+	inline BiometricEvaluation::Image::Raw
+	pattern(
+	    const BiometricEvaluation::Image::Size &size,
+	    uint32_t colorDepth,
+	    uint16_t bitDepth,
+	    bool hasAlphaChannel)
+	{
+		namespace BE = BiometricEvaluation;
+
+		BE::Memory::uint8Array data(static_cast<uint64_t>(
+		    size.xSize) * size.ySize * colorDepth / 8);
+		for (uint64_t i = 0; i < data.size(); i++)
+			data[i] = static_cast<uint8_t>((i * 7) + (i / 251));
+		return (BE::Image::Raw(data, size, colorDepth, bitDepth,
+		    {500, 500, BE::Image::Resolution::Units::PPI},
+		    hasAlphaChannel));
+	}
+
+	/** @return pattern() of 61x37 pixels */
+	inline BiometricEvaluation::Image::Raw
+	pattern(
+	    uint32_t colorDepth,
+	    uint16_t bitDepth,
+	    bool hasAlphaChannel)
+	{
+		return (pattern({61, 37}, colorDepth, bitDepth,
+		    hasAlphaChannel));
+	}
+}
+
+#endif /* TEST_BE_IMAGE_PATTERN_H_ */
@@ -0,0 +1,218 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <be_error_exception.h>
+#include <be_image_encode.h>
+#include <be_image_image.h>
+#include <be_image_probe.h>
+#include <be_image_raw.h>
+#include <be_image_wsq.h>
+#include <be_io_utility.h>
+
+#include "test_be_image_pattern.h"
+
+namespace BE = BiometricEvaluation;
+using TestImages::pattern;
+
+/** Expect probe() to report what the Image opened from data reports */
+static void
+expectMatchesImage(
+    const BE::Memory::uint8Array &data)
+{
+	const BE::Memory::ByteSpan span(data, data.size());
+	const auto attributes = BE::Image::probe(span);
+	const auto image = BE::Image::Image::openImage(span);
+
+	EXPECT_EQ(image->getCompressionAlgorithm(),
+	    attributes.compressionAlgorithm);
+	EXPECT_EQ(image->getDimensions(), attributes.dimensions);
+	EXPECT_EQ(image->getColorDepth(), attributes.colorDepth);
+	EXPECT_EQ(image->getBitDepth(), attributes.bitDepth);
+	EXPECT_EQ(image->getResolution(), attributes.resolution);
+	EXPECT_EQ(image->hasAlphaChannel(), attributes.hasAlphaChannel);
+}
+
+/** @return Minimal uncompressed TIFF, in either byte order */
+static BE::Memory::uint8Array
+tiff(
+    bool bigEndian)
+{
+	std::vector<uint8_t> data;
+	const auto put16 = [&](uint16_t v) {
+		if (bigEndian)
+			data.insert(data.end(), {uint8_t(v >> 8), uint8_t(v)});
+		else
+			data.insert(data.end(), {uint8_t(v), uint8_t(v >> 8)});
+	};
+	const auto put32 = [&](uint32_t v) {
+		if (bigEndian) {
+			put16(v >> 16);
+			put16(v);
+		} else {
+			put16(v);
+			put16(v >> 16);
+		}
+	};
+	const auto entry = [&](uint16_t tag, uint16_t type, uint32_t value) {
+		put16(tag);
+		put16(type);
+		put32(1);
+		if (type == 3) {
+			put16(value);
+			put16(0);
+		} else {
+			put32(value);
+		}
+	};
+
+	/* Header, IFD of 9 entries, rationals, and 30x20 RGB pixels */
+	static const uint32_t Rationals = 8 + 2 + (9 * 12) + 4;
+	static const uint32_t Pixels = Rationals + 16;
+	data.insert(data.end(), bigEndian ? "MM" : "II", (bigEndian ? "MM" :
+	    "II") + 2);
+	put16(42);
+	put32(8);
+	put16(9);
+	entry(256, 3, 30);		/* ImageWidth */
+	entry(257, 3, 20);		/* ImageLength */
+	entry(258, 3, 8);		/* BitsPerSample, same for all */
+	entry(262, 3, 2);		/* RGB */
+	entry(273, 4, Pixels);		/* StripOffsets */
+	entry(277, 3, 3);		/* SamplesPerPixel */
+	entry(282, 5, Rationals);	/* XResolution */
+	entry(283, 5, Rationals + 8);	/* YResolution */
+	entry(296, 3, 3);		/* Centimeter */
+	put32(0);
+	put32(3937);
+	put32(10);
+	put32(197);
+	put32(1);
+	data.resize(Pixels + (30 * 20 * 3));
+
+	BE::Memory::uint8Array array(data.size());
+	std::copy(data.begin(), data.end(), array.begin());
+	return (array);
+}
+
+TEST(ImageProbe, WSQ)
+{
+	const auto data = BE::IO::Utility::readFile("../test_data/img.wsq");
+	expectMatchesImage(data);
+
+	const auto attributes = BE::Image::probe({data, data.size()});
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::WSQ20,
+	    attributes.compressionAlgorithm);
+	EXPECT_EQ(8u, attributes.colorDepth);
+}
+
+TEST(ImageProbe, JPEG)
+{
+	const auto data = BE::IO::Utility::readFile("../test_data/img.jpg");
+	expectMatchesImage(data);
+
+	const BE::Image::WSQ wsq(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+	const BE::Image::Raw gray(wsq.getRawData(), wsq.getDimensions(), 8, 8,
+	    wsq.getResolution(), false);
+	expectMatchesImage(BE::Image::encode(gray,
+	    BE::Image::CompressionAlgorithm::JPEGB));
+	expectMatchesImage(BE::Image::encode(gray,
+	    BE::Image::CompressionAlgorithm::JPEGL));
+}
+
+TEST(ImageProbe, PNG)
+{
+	for (const auto &format : std::vector<std::vector<uint32_t>>{
+	    {8, 8, 0}, {16, 8, 1}, {24, 8, 0}, {32, 8, 1}, {48, 16, 0}}) {
+		const auto raw = pattern(format[0], format[1], format[2]);
+		const auto data = BE::Image::encode(raw,
+		    BE::Image::CompressionAlgorithm::PNG);
+		expectMatchesImage(data);
+
+		const auto attributes = BE::Image::probe({data, data.size()});
+		EXPECT_EQ(format[0], attributes.colorDepth);
+		EXPECT_EQ(format[2] == 1, attributes.hasAlphaChannel);
+	}
+}
+
+TEST(ImageProbe, JPEG2000)
+{
+	const auto data = BE::IO::Utility::readFile("../test_data/img.jp2");
+	const auto attributes = BE::Image::probe({data, data.size()});
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::JP2,
+	    attributes.compressionAlgorithm);
+	EXPECT_EQ(BE::Image::Size(908, 1007), attributes.dimensions);
+	EXPECT_EQ(8u, attributes.colorDepth);
+	EXPECT_EQ(8u, attributes.bitDepth);
+	EXPECT_FALSE(attributes.hasAlphaChannel);
+	EXPECT_EQ(BE::Image::Resolution::Units::PPCM,
+	    attributes.resolution.units);
+	EXPECT_NEAR(393.7, attributes.resolution.xRes, 0.01);
+	EXPECT_NEAR(393.7, attributes.resolution.yRes, 0.01);
+}
+
+TEST(ImageProbe, TIFF)
+{
+	for (const bool bigEndian : {false, true}) {
+		const auto data = tiff(bigEndian);
+		const auto attributes = BE::Image::probe({data, data.size()});
+		EXPECT_EQ(BE::Image::CompressionAlgorithm::TIFF,
+		    attributes.compressionAlgorithm);
+		EXPECT_EQ(BE::Image::Size(30, 20), attributes.dimensions);
+		EXPECT_EQ(24u, attributes.colorDepth);
+		EXPECT_EQ(8u, attributes.bitDepth);
+		EXPECT_FALSE(attributes.hasAlphaChannel);
+		EXPECT_EQ(BE::Image::Resolution::Units::PPCM,
+		    attributes.resolution.units);
+		EXPECT_NEAR(393.7, attributes.resolution.xRes, 0.001);
+		EXPECT_NEAR(197, attributes.resolution.yRes, 0.001);
+	}
+}
+
+TEST(ImageProbe, NetPBM)
+{
+	const std::string header = "P5\n# comment\n4 3\n255\n";
+	BE::Memory::uint8Array data(header.size() + 12);
+	std::copy(header.begin(), header.end(), data.begin());
+	expectMatchesImage(data);
+
+	const auto attributes = BE::Image::probe({data, data.size()});
+	EXPECT_EQ(BE::Image::Size(4, 3), attributes.dimensions);
+}
+
+TEST(ImageProbe, Invalid)
+{
+	const BE::Memory::uint8Array garbage(128);
+	EXPECT_THROW(BE::Image::probe({garbage, garbage.size()}),
+	    BE::Error::StrategyError);
+
+	/* Headers cut off before the dimensions */
+	const auto jpeg = BE::IO::Utility::readFile("../test_data/img.jpg");
+	const uint8_t SOF0[] = {0xFF, 0xC0};
+	const uint64_t sof = std::search(jpeg.begin(), jpeg.end(),
+	    std::begin(SOF0), std::end(SOF0)) - jpeg.begin();
+	ASSERT_LT(sof, jpeg.size());
+	EXPECT_THROW(BE::Image::probe({jpeg, sof + 6}), BE::Error::DataError);
+	const auto jp2 = BE::IO::Utility::readFile("../test_data/img.jp2");
+	EXPECT_THROW(BE::Image::probe({jp2, 24}), BE::Error::DataError);
+	const auto png = BE::Image::encode(pattern(8, 8, false),
+	    BE::Image::CompressionAlgorithm::PNG);
+	EXPECT_THROW(BE::Image::probe({png, 20}), BE::Error::DataError);
+	const auto littleTIFF = tiff(false);
+	EXPECT_THROW(BE::Image::probe({littleTIFF, 40}), BE::Error::DataError);
+}
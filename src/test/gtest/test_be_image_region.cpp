@@ -0,0 +1,236 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <be_error_exception.h>
+#include <be_image_decodecache.h>
+#include <be_image_jpeg.h>
+#include <be_image_netpbm.h>
+#include <be_io_utility.h>
+#include <be_memory_autoarray.h>
+
+namespace BE = BiometricEvaluation;
+
+/* Regions with offsets and sizes aligned and unaligned to 8x8 blocks */
+static const std::vector<BE::Image::ROI> regions{
+    {{0, 0}, 0, 0, {}},
+    {{64, 32}, 0, 0, {}},
+    {{50, 40}, 16, 24, {}},
+    {{37, 21}, 101, 77, {}},
+    {{1, 1}, 226, 150, {}},
+    {{227, 151}, 0, 0, {}}};
+
+/** @return 8-bit binary PPM of size, with a pattern varying by pixel */
+static BE::Memory::uint8Array
+makePPM(
+    const BE::Image::Size &size)
+{
+	const std::string header = "P6\n" + std::to_string(size.xSize) + " " +
+	    std::to_string(size.ySize) + "\n255\n";
+	BE::Memory::uint8Array data(header.size() + (size.xSize *
+	    size.ySize * 3));
+	std::copy(header.begin(), header.end(), data.begin());
+	uint8_t *pixel = data + header.size();
+	for (uint32_t y = 0; y < size.ySize; y++) {
+		for (uint32_t x = 0; x < size.xSize; x++) {
+			*pixel++ = static_cast<uint8_t>(x * 7 + y);
+			*pixel++ = static_cast<uint8_t>(y * 3);
+			*pixel++ = static_cast<uint8_t>((x * y) % 251);
+		}
+	}
+	return (data);
+}
+
+/** @return Region of full-resolution raw data, averaged over blocks */
+static std::vector<uint8_t>
+referenceRegion(
+    const BE::Memory::uint8Array &raw,
+    const BE::Image::Size &dimensions,
+    uint8_t pixelSize,
+    BE::Image::ROI region,
+    uint8_t reduction)
+{
+	if ((region.size.xSize == 0) || (region.size.ySize == 0))
+		region = BE::Image::ROI(dimensions, 0, 0, {});
+
+	const uint32_t scale = 1 << reduction;
+	const uint32_t x0 = region.horzOffset / scale;
+	const uint32_t y0 = region.vertOffset / scale;
+	const uint32_t x1 = (region.horzOffset + region.size.xSize +
+	    scale - 1) / scale;
+	const uint32_t y1 = (region.vertOffset + region.size.ySize +
+	    scale - 1) / scale;
+
+	std::vector<uint8_t> out;
+	for (uint32_t oy = y0; oy < y1; oy++) {
+		for (uint32_t ox = x0; ox < x1; ox++) {
+			for (uint8_t c = 0; c < pixelSize; c++) {
+				uint64_t sum = 0, count = 0;
+				for (uint32_t y = oy * scale; y < std::min(
+				    (oy + 1) * scale, dimensions.ySize); y++) {
+					for (uint32_t x = ox * scale; x <
+					    std::min((ox + 1) * scale,
+					    dimensions.xSize); x++) {
+						sum += raw[(((y *
+						    dimensions.xSize) + x) *
+						    pixelSize) + c];
+						count++;
+					}
+				}
+				out.push_back(static_cast<uint8_t>(
+				    (sum + (count / 2)) / count));
+			}
+		}
+	}
+	return (out);
+}
+
+TEST(ImageRegion, Dimensions)
+{
+	const BE::Image::NetPBM image(makePPM({227, 151}));
+
+	EXPECT_EQ(BE::Image::Size(227, 151), image.getRegionDimensions({}));
+	EXPECT_EQ(BE::Image::Size(114, 76), image.getRegionDimensions({}, 1));
+	EXPECT_EQ(BE::Image::Size(29, 19), image.getRegionDimensions({}, 3));
+	EXPECT_EQ(BE::Image::Size(1, 1), image.getRegionDimensions({}, 8));
+
+	/* Reduced pixels covering [101, 138) x [77, 98) */
+	const BE::Image::ROI region({37, 21}, 101, 77, {});
+	EXPECT_EQ(BE::Image::Size(37, 21), image.getRegionDimensions(region));
+	EXPECT_EQ(BE::Image::Size(19, 11),
+	    image.getRegionDimensions(region, 1));
+	EXPECT_EQ(BE::Image::Size(6, 4), image.getRegionDimensions(region, 3));
+}
+
+TEST(ImageRegion, InvalidRegion)
+{
+	const BE::Image::NetPBM image(makePPM({227, 151}));
+
+	EXPECT_THROW(image.getRawData(BE::Image::ROI({10, 10}, 220, 0, {})),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(image.getRawData(BE::Image::ROI({10, 152}, 0, 0, {})),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(image.getRawData(BE::Image::ROI(),
+	    BE::Image::Image::MAX_REDUCTION + 1), BE::Error::ParameterError);
+}
+
+TEST(ImageRegion, Fallback)
+{
+	const BE::Image::Size size(227, 151);
+	const BE::Image::NetPBM image(makePPM(size));
+	const auto raw = image.getRawData();
+
+	for (const auto &region : regions) {
+		for (const uint8_t reduction : {0, 1, 2, 3, 5}) {
+			const auto expected = referenceRegion(raw, size, 3,
+			    region, reduction);
+			const auto actual = image.getRawData(region, reduction);
+			ASSERT_EQ(expected.size(), actual.size());
+			EXPECT_TRUE(std::equal(expected.begin(),
+			    expected.end(), actual.begin())) <<
+			    to_string(region) << ", reduction " <<
+			    static_cast<int>(reduction);
+		}
+	}
+}
+
+TEST(ImageRegion, FallbackCached)
+{
+	const BE::Image::NetPBM image(makePPM({227, 151}));
+	const BE::Image::ROI region({50, 40}, 16, 24, {});
+	const auto uncached = image.getRawData(region, 2);
+
+	BE::Image::DecodeCache::setBudget(1024 * 1024);
+	(void)image.getRawDataSpan();
+	EXPECT_EQ(uncached, image.getRawData(region, 2));
+	BE::Image::DecodeCache::setBudget(
+	    BE::Image::DecodeCache::DEFAULT_BUDGET);
+}
+
+TEST(ImageRegion, JPEG)
+{
+	const BE::Image::JPEG image(BE::IO::Utility::readFile(
+	    "../test_data/img.jpg"));
+	ASSERT_EQ(BE::Image::Size(227, 151), image.getDimensions());
+	const auto raw = image.getRawData();
+
+	for (const auto &region : regions) {
+		/* Without chroma subsampling, crops are exact */
+		const auto crop = image.getRawData(region);
+		const auto expected = referenceRegion(raw,
+		    image.getDimensions(), 3, region, 0);
+		ASSERT_EQ(expected.size(), crop.size());
+		EXPECT_TRUE(std::equal(expected.begin(), expected.end(),
+		    crop.begin())) << to_string(region);
+
+		/*
+		 * The inverse DCT approximates a box filter, less so
+		 * for blocks clipped at the edge of the image.
+		 */
+		for (const uint8_t reduction : {1, 2, 3}) {
+			const auto scaled = image.getRawData(region,
+			    reduction);
+			const auto average = referenceRegion(raw,
+			    image.getDimensions(), 3, region, reduction);
+			ASSERT_EQ(average.size(), scaled.size()) <<
+			    to_string(region) << ", reduction " <<
+			    static_cast<int>(reduction);
+
+			uint64_t totalError = 0;
+			for (uint64_t i = 0; i < average.size(); i++)
+				totalError += std::abs(static_cast<int>(
+				    average[i]) - scaled[i]);
+			EXPECT_LE(totalError, average.size() * 6) <<
+			    to_string(region) << ", reduction " <<
+			    static_cast<int>(reduction);
+		}
+	}
+}
+
+TEST(ImageRegion, JPEGScaledCrop)
+{
+	/* Regions of a scaled image match crops of the scaled image */
+	const BE::Image::JPEG image(BE::IO::Utility::readFile(
+	    "../test_data/img.jpg"));
+	for (const uint8_t reduction : {1, 2, 3}) {
+		const BE::Image::Size scaledSize = image.getRegionDimensions({},
+		    reduction);
+		const auto scaled = image.getRawData({}, reduction);
+		ASSERT_EQ(scaledSize.xSize * scaledSize.ySize * 3,
+		    scaled.size());
+
+		for (const auto &region : regions) {
+			const auto actual = image.getRawData(region,
+			    reduction);
+			const BE::Image::Size regionSize =
+			    image.getRegionDimensions(region, reduction);
+			const uint32_t x0 = region.horzOffset >> reduction;
+			const uint32_t y0 = region.vertOffset >> reduction;
+
+			ASSERT_EQ(regionSize.xSize * regionSize.ySize * 3,
+			    actual.size());
+			for (uint32_t y = 0; y < regionSize.ySize; y++)
+				ASSERT_TRUE(std::equal(actual + (y *
+				    regionSize.xSize * 3), actual + ((y + 1) *
+				    regionSize.xSize * 3), scaled + ((((y0 + y) *
+				    scaledSize.xSize) + x0) * 3))) <<
+				    to_string(region) << ", reduction " <<
+				    static_cast<int>(reduction) << ", row " << y;
+		}
+	}
+}
@@ -0,0 +1,278 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <be_error_exception.h>
+#include <be_image_raw.h>
+#include <be_image_resample.h>
+#include <be_image_wsq.h>
+#include <be_io_utility.h>
+#include <be_latent_an2kview.h>
+
+namespace BE = BiometricEvaluation;
+
+static const BE::Image::Resolution PPI500{500, 500,
+    BE::Image::Resolution::Units::PPI};
+static const BE::Image::Resolution PPI250{250, 250,
+    BE::Image::Resolution::Units::PPI};
+static const BE::Image::Resolution PPI1000{1000, 1000,
+    BE::Image::Resolution::Units::PPI};
+
+static const std::vector<BE::Image::ResampleFilter> Filters{
+    BE::Image::ResampleFilter::Box, BE::Image::ResampleFilter::Bilinear,
+    BE::Image::ResampleFilter::Lanczos};
+
+/** @return Raw image of random samples */
+static BE::Image::Raw
+randomImage(
+    const BE::Image::Size &size,
+    uint32_t colorDepth,
+    uint16_t bitDepth)
+{
+	BE::Memory::uint8Array data(static_cast<uint64_t>(size.xSize) *
+	    size.ySize * colorDepth / 8);
+	std::mt19937 engine(20261018);
+	std::uniform_int_distribution<int> byte(0, 255);
+	for (auto &b : data)
+		b = static_cast<uint8_t>(byte(engine));
+	return (BE::Image::Raw(data, size, colorDepth, bitDepth, PPI500,
+	    false));
+}
+
+/** @return Raw image whose every pixel is sample */
+static BE::Image::Raw
+constantImage(
+    const BE::Image::Size &size,
+    const std::vector<uint16_t> &sample,
+    uint16_t bitDepth)
+{
+	const uint8_t sampleSize = bitDepth / 8;
+	BE::Memory::uint8Array data(static_cast<uint64_t>(size.xSize) *
+	    size.ySize * sample.size() * sampleSize);
+	for (uint64_t i = 0; i < (data.size() / sampleSize); i++) {
+		const uint16_t value = sample[i % sample.size()];
+		if (bitDepth == 16)
+			std::memcpy(data + (i * 2), &value, sizeof(value));
+		else
+			data[i] = static_cast<uint8_t>(value);
+	}
+	return (BE::Image::Raw(data, size, sample.size() * bitDepth,
+	    bitDepth, PPI500, false));
+}
+
+TEST(ImageResample, Size)
+{
+	const BE::Image::Size size{1000, 801};
+	EXPECT_EQ(BE::Image::Size(500, 401),
+	    BE::Image::getResampledSize(size, PPI500, PPI250));
+	EXPECT_EQ(BE::Image::Size(2000, 1602),
+	    BE::Image::getResampledSize(size, PPI500, PPI1000));
+	EXPECT_EQ(size, BE::Image::getResampledSize(size, PPI500,
+	    PPI500.toUnits(BE::Image::Resolution::Units::PPCM)));
+	EXPECT_EQ(BE::Image::Size(1000, 401),
+	    BE::Image::getResampledSize(size, PPI500, {500, 250}));
+	EXPECT_EQ(BE::Image::Size(1, 1), BE::Image::getResampledSize({2, 2},
+	    PPI1000, PPI250));
+
+	EXPECT_THROW(BE::Image::getResampledSize(size, PPI500,
+	    {500, 500, BE::Image::Resolution::Units::NA}),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(BE::Image::getResampledSize(size, {0, 500}, PPI500),
+	    BE::Error::ParameterError);
+}
+
+TEST(ImageResample, Identity)
+{
+	const auto raw = randomImage({61, 37}, 24, 8);
+	for (const auto filter : Filters) {
+		const auto same = BE::Image::resample(raw, PPI500, filter);
+		EXPECT_EQ(raw.getDimensions(), same.getDimensions());
+		EXPECT_EQ(raw.getRawData(), same.getRawData());
+	}
+
+	/* Only the scaled axis changes */
+	const auto wide = BE::Image::resample(raw, {1000, 500});
+	EXPECT_EQ(BE::Image::Size(122, 37), wide.getDimensions());
+}
+
+TEST(ImageResample, Constant)
+{
+	for (const auto bitDepth : {8, 16}) {
+		const std::vector<uint16_t> sample = (bitDepth == 8) ?
+		    std::vector<uint16_t>{0, 255, 77} :
+		    std::vector<uint16_t>{0, 65535, 12345};
+		const auto raw = constantImage({97, 83}, sample, bitDepth);
+		for (const auto filter : Filters) {
+			for (const auto &to : {PPI250, PPI1000,
+			    BE::Image::Resolution(333, 777)}) {
+				const auto resampled = BE::Image::resample(
+				    raw, to, filter);
+				const auto expected = constantImage(
+				    resampled.getDimensions(), sample,
+				    bitDepth);
+				EXPECT_EQ(expected.getRawData(),
+				    resampled.getRawData());
+				EXPECT_EQ(to, resampled.getResolution());
+				EXPECT_EQ(raw.getColorDepth(),
+				    resampled.getColorDepth());
+				EXPECT_EQ(raw.getBitDepth(),
+				    resampled.getBitDepth());
+			}
+		}
+	}
+}
+
+TEST(ImageResample, BoxAverages)
+{
+	const auto raw = randomImage({64, 48}, 8, 8);
+	const auto rawData = raw.getRawData();
+	const auto half = BE::Image::resample(raw, PPI250,
+	    BE::Image::ResampleFilter::Box);
+	ASSERT_EQ(BE::Image::Size(32, 24), half.getDimensions());
+
+	/* Mean of each 2x2 block, rounded half up */
+	const auto halfData = half.getRawData();
+	for (uint32_t y = 0; y < 24; y++) {
+		for (uint32_t x = 0; x < 32; x++) {
+			const uint8_t *p = rawData + (y * 2 * 64) + (x * 2);
+			const uint32_t sum = p[0] + p[1] + p[64] + p[65];
+			ASSERT_EQ((sum + 2) / 4, halfData[(y * 32) + x]) <<
+			    x << "," << y;
+		}
+	}
+}
+
+TEST(ImageResample, Reference)
+{
+	/* Lanczos weights of a 3:2 reduction, in double precision */
+	const auto raw = randomImage({90, 60}, 8, 8);
+	const auto rawData = raw.getRawData();
+	const auto resampled = BE::Image::resample(raw,
+	    {500 * 2.0 / 3, 500 * 2.0 / 3});
+	ASSERT_EQ(BE::Image::Size(60, 40), resampled.getDimensions());
+
+	const auto lanczos = [](double x) {
+		if (x == 0)
+			return (1.0);
+		if (std::abs(x) >= 3)
+			return (0.0);
+		const double pix = 3.14159265358979323846 * x;
+		return (3 * std::sin(pix) * std::sin(pix / 3) / (pix * pix));
+	};
+	const auto weights = [&](uint32_t out, uint32_t in) {
+		std::vector<std::vector<double>> w(out,
+		    std::vector<double>(in));
+		for (uint32_t i = 0; i < out; i++) {
+			double sum = 0;
+			for (uint32_t j = 0; j < in; j++) {
+				w[i][j] = lanczos(((j + 0.5) -
+				    ((i + 0.5) * 1.5)) / 1.5);
+				sum += w[i][j];
+			}
+			for (auto &v : w[i])
+				v /= sum;
+		}
+		return (w);
+	};
+	const auto wx = weights(60, 90);
+	const auto wy = weights(40, 60);
+
+	const auto resampledData = resampled.getRawData();
+	for (uint32_t y = 0; y < 40; y++) {
+		for (uint32_t x = 0; x < 60; x++) {
+			double value = 0;
+			for (uint32_t j = 0; j < 60; j++)
+				for (uint32_t i = 0; i < 90; i++)
+					value += wy[y][j] * wx[x][i] *
+					    rawData[(j * 90) + i];
+			value = std::min(std::max(value, 0.0), 255.0);
+			ASSERT_NEAR(value, resampledData[(y * 60) + x], 0.51)
+			    << x << "," << y;
+		}
+	}
+}
+
+TEST(ImageResample, Threads)
+{
+	for (const auto colorDepth : {8, 24}) {
+		const auto raw = randomImage({641, 479}, colorDepth, 8);
+		for (const auto filter : Filters) {
+			for (const auto &to : {PPI250,
+			    BE::Image::Resolution(1100, 700)}) {
+				const auto expected = BE::Image::resample(raw,
+				    to, filter, 1).getRawData();
+				for (const uint32_t threads : {0, 2, 3, 7})
+					EXPECT_EQ(expected, BE::Image::resample(
+					    raw, to, filter, threads).
+					    getRawData()) << threads;
+			}
+		}
+	}
+
+	const auto wide = randomImage({401, 301}, 16, 16);
+	EXPECT_EQ(BE::Image::resample(wide, PPI1000,
+	    BE::Image::ResampleFilter::Lanczos, 1).getRawData(),
+	    BE::Image::resample(wide, PPI1000,
+	    BE::Image::ResampleFilter::Lanczos, 4).getRawData());
+}
+
+TEST(ImageResample, Parameters)
+{
+	BE::Memory::uint8Array data(100);
+	EXPECT_THROW(BE::Image::resample(data, data.size(), {10, 10}, 1, 1,
+	    PPI500, PPI250), BE::Error::NotImplemented);
+	EXPECT_THROW(BE::Image::resample(data, data.size(), {10, 10}, 12, 8,
+	    PPI500, PPI250), BE::Error::ParameterError);
+	EXPECT_THROW(BE::Image::resample(data, data.size(), {10, 11}, 8, 8,
+	    PPI500, PPI250), BE::Error::ParameterError);
+	EXPECT_THROW(BE::Image::resample(data, data.size(), {10, 10}, 8, 8,
+	    {500, 500, BE::Image::Resolution::Units::NA}, PPI250),
+	    BE::Error::ParameterError);
+}
+
+TEST(ImageResample, Image)
+{
+	const BE::Image::WSQ wsq(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+	const auto resampled = BE::Image::resample(wsq, PPI250);
+	EXPECT_EQ(BE::Image::getResampledSize(wsq.getDimensions(),
+	    wsq.getResolution(), PPI250), resampled.getDimensions());
+	EXPECT_EQ(PPI250, resampled.getResolution());
+	EXPECT_EQ(BE::Image::CompressionAlgorithm::None,
+	    resampled.getCompressionAlgorithm());
+}
+
+TEST(ImageResample, View)
+{
+	const BE::Latent::AN2KView an2k("../test_data/type9-13.an2k", 1);
+	const BE::Image::Resolution half{98.5, 98.5,
+	    BE::Image::Resolution::Units::PPCM};
+
+	const auto image = an2k.getImage(half,
+	    BE::Image::ResampleFilter::Bilinear);
+	EXPECT_EQ(BE::Image::Size(96, 179), image->getDimensions());
+	EXPECT_EQ(half, image->getResolution());
+	EXPECT_EQ(BE::Image::resample(*an2k.getImage(),
+	    an2k.getImageResolution(), half,
+	    BE::Image::ResampleFilter::Bilinear).getRawData(),
+	    image->getRawData());
+
+	/* No resampling needed */
+	EXPECT_EQ(an2k.getImage()->getRawData(), an2k.getImage(
+	    an2k.getImageResolution())->getRawData());
+}
@@ -0,0 +1,272 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <be_error_exception.h>
+#include <be_image_encode.h>
+#include <be_image_raw.h>
+#include <be_image_statistics.h>
+#include <be_image_wsq.h>
+#include <be_io_utility.h>
+
+namespace BE = BiometricEvaluation;
+
+static const BE::Image::Resolution PPI500{500, 500,
+    BE::Image::Resolution::Units::PPI};
+
+/** @return Random samples, limited to [low, high] */
+static BE::Memory::uint8Array
+randomSamples(
+    const BE::Image::Size &size,
+    uint8_t depth,
+    uint16_t low,
+    uint16_t high)
+{
+	const uint64_t count = static_cast<uint64_t>(size.xSize) * size.ySize;
+	BE::Memory::uint8Array data(count * (depth / 8));
+	std::mt19937 engine(20261018);
+	std::uniform_int_distribution<uint32_t> sample(low, high);
+	for (uint64_t i = 0; i < count; i++) {
+		const uint16_t value = static_cast<uint16_t>(sample(engine));
+		if (depth == 16)
+			std::memcpy(data + (i * 2), &value, sizeof(value));
+		else
+			data[i] = static_cast<uint8_t>(value);
+	}
+	return (data);
+}
+
+/** Expect statistics to be those computed directly from gray */
+static void
+expectMatchesReference(
+    const BE::Memory::uint8Array &gray,
+    const BE::Image::Size &size,
+    uint8_t depth,
+    uint32_t blockSize)
+{
+	std::vector<uint32_t> samples;
+	for (uint64_t i = 0; i < (gray.size() / (depth / 8)); i++) {
+		uint16_t value = gray[i];
+		if (depth == 16)
+			std::memcpy(&value, gray + (i * 2), sizeof(value));
+		samples.push_back(value);
+	}
+
+	BE::Image::StatisticsOptions options;
+	options.blockSize = blockSize;
+	const auto statistics = BE::Image::computeStatistics(gray, size,
+	    depth, options);
+
+	ASSERT_EQ(samples.size(), statistics.count);
+	ASSERT_EQ(uint64_t(1) << depth, statistics.histogram.size());
+	std::vector<uint64_t> histogram(statistics.histogram.size());
+	double sum = 0;
+	for (const auto value : samples) {
+		histogram[value]++;
+		sum += value;
+	}
+	EXPECT_EQ(histogram, statistics.histogram);
+	EXPECT_EQ(*std::min_element(samples.begin(), samples.end()),
+	    statistics.minimum);
+	EXPECT_EQ(*std::max_element(samples.begin(), samples.end()),
+	    statistics.maximum);
+	const double mean = sum / samples.size();
+	double deviations = 0;
+	for (const auto value : samples)
+		deviations += (value - mean) * (value - mean);
+	EXPECT_DOUBLE_EQ(mean, statistics.mean);
+	EXPECT_NEAR(deviations / samples.size(), statistics.variance,
+	    statistics.variance * 1e-12);
+
+	if (blockSize == 0) {
+		EXPECT_TRUE(statistics.blockVariance.empty());
+		return;
+	}
+	const uint32_t across = (size.xSize + blockSize - 1) / blockSize;
+	const uint32_t down = (size.ySize + blockSize - 1) / blockSize;
+	EXPECT_EQ(blockSize, statistics.blockSize);
+	EXPECT_EQ(BE::Image::Size(across, down), statistics.blockMapSize);
+	ASSERT_EQ(across * down, statistics.blockVariance.size());
+	for (uint32_t by = 0; by < down; by++) {
+		for (uint32_t bx = 0; bx < across; bx++) {
+			std::vector<double> block;
+			for (uint32_t y = by * blockSize; y < std::min(
+			    size.ySize, (by + 1) * blockSize); y++)
+				for (uint32_t x = bx * blockSize; x < std::min(
+				    size.xSize, (bx + 1) * blockSize); x++)
+					block.push_back(samples[
+					    (y * size.xSize) + x]);
+			double blockMean = 0, blockDeviations = 0;
+			for (const auto value : block)
+				blockMean += value / block.size();
+			for (const auto value : block)
+				blockDeviations += (value - blockMean) *
+				    (value - blockMean);
+			const float variance = statistics.blockVariance[
+			    (by * across) + bx];
+			ASSERT_NEAR(blockDeviations / block.size(), variance,
+			    std::max(1e-3, variance * 1e-5)) << bx << "," <<
+			    by;
+		}
+	}
+}
+
+TEST(ImageStatistics, Known)
+{
+	const uint8_t gray[] = {0, 10, 10, 20, 20, 20};
+	BE::Image::StatisticsOptions options;
+	options.blockSize = 2;
+	const auto statistics = BE::Image::computeStatistics(gray, {3, 2}, 8,
+	    options);
+
+	EXPECT_EQ(8, statistics.depth);
+	EXPECT_EQ(6u, statistics.count);
+	EXPECT_EQ(0, statistics.minimum);
+	EXPECT_EQ(20, statistics.maximum);
+	EXPECT_DOUBLE_EQ(80.0 / 6, statistics.mean);
+	EXPECT_DOUBLE_EQ((((80.0 / 6) * (80.0 / 6)) + (2 * (10 - (80.0 / 6)) *
+	    (10 - (80.0 / 6))) + (3 * (20 - (80.0 / 6)) * (20 - (80.0 / 6)))) /
+	    6, statistics.variance);
+	EXPECT_EQ(1u, statistics.histogram[0]);
+	EXPECT_EQ(2u, statistics.histogram[10]);
+	EXPECT_EQ(3u, statistics.histogram[20]);
+	EXPECT_FALSE(statistics.blank);
+
+	/* {0, 10, 20, 20} and {10, 20} */
+	EXPECT_EQ(BE::Image::Size(2, 1), statistics.blockMapSize);
+	ASSERT_EQ(2u, statistics.blockVariance.size());
+	EXPECT_FLOAT_EQ(68.75f, statistics.blockVariance[0]);
+	EXPECT_FLOAT_EQ(25.0f, statistics.blockVariance[1]);
+}
+
+TEST(ImageStatistics, Reference)
+{
+	for (const uint8_t depth : {8, 16}) {
+		const uint16_t high = (depth == 8) ? 255 : 65535;
+		for (const auto &size : {BE::Image::Size(203, 117),
+		    BE::Image::Size(64, 64), BE::Image::Size(1, 9)}) {
+			const auto gray = randomSamples(size, depth, 0, high);
+			for (const uint32_t blockSize : {0, 1, 7, 16, 33, 500})
+				expectMatchesReference(gray, size, depth,
+				    blockSize);
+		}
+	}
+}
+
+TEST(ImageStatistics, Blank)
+{
+	const BE::Image::Size size{100, 80};
+	const auto flat = BE::Image::computeStatistics(randomSamples(size, 8,
+	    200, 202), size, 8);
+	EXPECT_TRUE(flat.blank);
+	EXPECT_EQ(200, flat.minimum);
+	EXPECT_EQ(202, flat.maximum);
+
+	const auto noisy = randomSamples(size, 8, 0, 255);
+	EXPECT_FALSE(BE::Image::computeStatistics(noisy, size, 8).blank);
+	BE::Image::StatisticsOptions options;
+	options.blankThreshold = 1000;
+	EXPECT_TRUE(BE::Image::computeStatistics(noisy, size, 8,
+	    options).blank);
+}
+
+TEST(ImageStatistics, Image)
+{
+	const BE::Image::WSQ wsq(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+	const BE::Image::Size size{61, 37};
+	const BE::Image::Raw rgb(randomSamples({size.xSize * 3, size.ySize},
+	    8, 0, 255), size, 24, 8, PPI500, false);
+	const auto png = BE::Image::Image::openImage(BE::Image::encode(rgb,
+	    BE::Image::CompressionAlgorithm::PNG));
+	const auto jpeg = BE::Image::Image::openImage(BE::IO::Utility::readFile(
+	    "../test_data/img.jpg"));
+
+	BE::Image::StatisticsOptions options;
+	options.blockSize = 16;
+	for (const BE::Image::Image *image :
+	    std::vector<const BE::Image::Image*>{&wsq, &rgb, png.get(),
+	    jpeg.get()}) {
+		/* JPEG converts to gray itself, so convert as Raw does */
+		const BE::Image::Raw raw(image->getRawData(),
+		    image->getDimensions(), image->getColorDepth(),
+		    image->getBitDepth(), image->getResolution(),
+		    image->hasAlphaChannel());
+		for (const uint8_t depth : {8, 16}) {
+			const auto expected = BE::Image::computeStatistics(
+			    raw.getRawGrayscaleData(depth),
+			    image->getDimensions(), depth, options);
+			const auto statistics = BE::Image::computeStatistics(
+			    *image, depth, options);
+			EXPECT_EQ(expected.histogram, statistics.histogram);
+			EXPECT_EQ(expected.mean, statistics.mean);
+			EXPECT_EQ(expected.variance, statistics.variance);
+			EXPECT_EQ(expected.blockVariance,
+			    statistics.blockVariance);
+		}
+	}
+}
+
+TEST(ImageStatistics, Packed)
+{
+	/* 1-bit samples, packed, and expanded by NetPBM (1 is black) */
+	const uint8_t bits[4]{0xFF, 0x80, 0x00, 0x00};
+	const BE::Image::Raw bitmap(bits, sizeof(bits), {9, 2}, 1, 1, PPI500,
+	    false);
+	const std::string header = "P4\n9 2\n";
+	BE::Memory::uint8Array pbm(header.size() + sizeof(bits));
+	std::memcpy(pbm, header.data(), header.size());
+	std::memcpy(pbm + header.size(), bits, sizeof(bits));
+	const auto netpbm = BE::Image::Image::openImage(pbm);
+	for (const BE::Image::Image *image :
+	    std::vector<const BE::Image::Image*>{&bitmap, netpbm.get()}) {
+		const auto statistics = BE::Image::computeStatistics(*image);
+		EXPECT_EQ(18u, statistics.count);
+		EXPECT_EQ(9u, statistics.histogram[0]);
+		EXPECT_EQ(9u, statistics.histogram[255]);
+		EXPECT_EQ(127.5, statistics.mean);
+	}
+
+	/* 2-bit samples are scaled to the full range */
+	const uint8_t crumbs[1]{0x1B};
+	const BE::Image::Raw gray2(crumbs, sizeof(crumbs), {3, 1}, 2, 2,
+	    PPI500, false);
+	const auto statistics = BE::Image::computeStatistics(gray2, 16);
+	EXPECT_EQ(0, statistics.minimum);
+	EXPECT_EQ(170 * 257, statistics.maximum);
+	EXPECT_EQ(1u, statistics.histogram[85 * 257]);
+
+	const BE::Image::Raw gray3(crumbs, sizeof(crumbs), {2, 1}, 3, 3,
+	    PPI500, false);
+	EXPECT_THROW(BE::Image::computeStatistics(gray3),
+	    BE::Error::NotImplemented);
+}
+
+TEST(ImageStatistics, Parameters)
+{
+	const uint8_t gray[4]{};
+	EXPECT_THROW(BE::Image::computeStatistics(gray, {2, 2}, 1),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(BE::Image::computeStatistics(gray, {0, 2}, 8),
+	    BE::Error::ParameterError);
+
+	const BE::Image::WSQ wsq(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+	EXPECT_THROW(BE::Image::computeStatistics(wsq, 1),
+	    BE::Error::ParameterError);
+}
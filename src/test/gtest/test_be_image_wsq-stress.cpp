@@ -0,0 +1,133 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+/*
+ * Decode WSQ and Lossless JPEG images from many threads at once, checking
+ * that the NBIS decoders do not share state between concurrent decodings.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <be_error_exception.h>
+#include <be_image_jpegl.h>
+#include <be_image_wsq.h>
+#include <be_io_recordstore.h>
+#include <be_io_utility.h>
+
+namespace BE = BiometricEvaluation;
+
+static const uint32_t DECODES_PER_THREAD = 25;
+
+/** @return Number of threads to decode with, oversubscribing the CPUs */
+static uint32_t
+threadCount()
+{
+	return (std::max(8u, std::thread::hardware_concurrency() * 2));
+}
+
+/**
+ * @brief
+ * Decode images concurrently.
+ *
+ * @param[in] images
+ *	Images to decode, each thread starting at a different image.
+ * @param[in] expected
+ *	Raw data of each image, decoded by a single thread.
+ *
+ * @return
+ *	Number of decodings that threw or did not match expected.
+ */
+static uint64_t
+decodeConcurrently(
+    const std::vector<std::shared_ptr<BE::Image::Image>> &images,
+    const std::vector<BE::Memory::uint8Array> &expected)
+{
+	std::atomic<uint64_t> failures{0};
+	std::atomic<bool> start{false};
+
+	std::vector<std::thread> threads;
+	for (uint32_t t = 0; t < threadCount(); t++) {
+		threads.emplace_back([&, t]() {
+			while (!start)
+				std::this_thread::yield();
+
+			for (uint32_t i = 0; i < DECODES_PER_THREAD; i++) {
+				const size_t n = (t + i) % images.size();
+				try {
+					if (images[n]->getRawData() !=
+					    expected[n])
+						failures++;
+				} catch (const BE::Error::Exception&) {
+					failures++;
+				}
+			}
+		});
+	}
+	start = true;
+	for (auto &thread : threads)
+		thread.join();
+
+	return (failures);
+}
+
+TEST(DecodeStress, WSQ)
+{
+	const auto data = BE::IO::Utility::readFile("../test_data/img.wsq");
+
+	std::vector<std::shared_ptr<BE::Image::Image>> images;
+	for (uint32_t i = 0; i < threadCount(); i++)
+		images.push_back(std::make_shared<BE::Image::WSQ>(data));
+	const auto reference = images.front()->getRawData();
+	ASSERT_EQ(images.front()->getDimensions().xSize *
+	    images.front()->getDimensions().ySize, reference.size());
+	const std::vector<BE::Memory::uint8Array> expected(images.size(),
+	    reference);
+
+	EXPECT_EQ(0u, decodeConcurrently(images, expected));
+}
+
+TEST(DecodeStress, WSQSameImage)
+{
+	const std::shared_ptr<BE::Image::Image> image =
+	    std::make_shared<BE::Image::WSQ>(BE::IO::Utility::readFile(
+	    "../test_data/img.wsq"));
+	const auto reference = image->getRawData();
+
+	EXPECT_EQ(0u, decodeConcurrently({image}, {reference}));
+}
+
+TEST(DecodeStress, JPEGL)
+{
+	std::shared_ptr<BE::IO::RecordStore> rs;
+	ASSERT_NO_THROW(rs = BE::IO::RecordStore::openRecordStore(
+	    "../test_data/ImageRS", BE::IO::Mode::ReadOnly));
+
+	/* Different images, so table and bit reader state would collide */
+	std::vector<std::shared_ptr<BE::Image::Image>> images;
+	std::vector<BE::Memory::uint8Array> expected;
+	for (const auto &record : *rs) {
+		if ((record.key.size() < 3) ||
+		    (record.key.substr(record.key.size() - 3) != "jpl"))
+			continue;
+		images.push_back(std::make_shared<BE::Image::JPEGL>(
+		    record.data, record.key));
+		expected.push_back(images.back()->getRawData());
+	}
+	ASSERT_FALSE(images.empty());
+
+	EXPECT_EQ(0u, decodeConcurrently(images, expected));
+}
@@ -0,0 +1,119 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <be_error_exception.h>
+#include <be_image_wsq.h>
+#include <be_io_utility.h>
+
+namespace BE = BiometricEvaluation;
+
+class WSQCrop : public ::testing::Test
+{
+protected:
+	WSQCrop() :
+	    wsq(BE::IO::Utility::readFile("../test_data/img.wsq"))
+	{
+
+	}
+
+	const BE::Image::WSQ wsq;
+};
+
+TEST_F(WSQCrop, Whole)
+{
+	/* All coefficients are kept, so pixels are unchanged */
+	const BE::Image::WSQ crop(wsq.crop({wsq.getDimensions(), 0, 0, {}}));
+	EXPECT_EQ(wsq.getDimensions(), crop.getDimensions());
+	EXPECT_EQ(wsq.getRawData(), crop.getRawData());
+}
+
+TEST_F(WSQCrop, Aligned)
+{
+	const auto data = wsq.crop({{128, 96}, 64, 96, {}});
+	ASSERT_TRUE(BE::Image::WSQ::isWSQ(data, data.size()));
+	EXPECT_LT(data.size(), wsq.getData().size());
+
+	const BE::Image::WSQ crop(data);
+	EXPECT_EQ(BE::Image::Size(128, 96), crop.getDimensions());
+	EXPECT_EQ(wsq.getResolution(), crop.getResolution());
+	EXPECT_EQ(128u * 96u, crop.getRawData().size());
+}
+
+TEST_F(WSQCrop, Unaligned)
+{
+	/* Upper-left moves to (64, 96) */
+	const BE::Image::WSQ crop(wsq.crop({{50, 50}, 70, 100, {}}));
+	EXPECT_EQ(BE::Image::Size(56, 54), crop.getDimensions());
+	EXPECT_EQ(56u * 54u, crop.getRawData().size());
+}
+
+TEST_F(WSQCrop, Clipped)
+{
+	const auto dimensions = wsq.getDimensions();
+	const BE::Image::WSQ crop(wsq.crop({{UINT32_MAX, UINT32_MAX},
+	    dimensions.xSize - 100, dimensions.ySize - 100, {}}));
+
+	const uint32_t horzOffset = ((dimensions.xSize - 100) / 32) * 32;
+	const uint32_t vertOffset = ((dimensions.ySize - 100) / 32) * 32;
+	EXPECT_EQ(BE::Image::Size(dimensions.xSize - horzOffset,
+	    dimensions.ySize - vertOffset), crop.getDimensions());
+}
+
+TEST_F(WSQCrop, Multiple)
+{
+	const std::vector<BE::Image::ROI> rois{{{128, 128}, 0, 0, {}},
+	    {{100, 200}, 160, 32, {}}, {{128, 128}, 0, 0, {}}};
+	const auto crops = wsq.crop(rois);
+	ASSERT_EQ(rois.size(), crops.size());
+	for (size_t i = 0; i < rois.size(); i++)
+		EXPECT_EQ(wsq.crop(rois[i]), crops[i]);
+	EXPECT_EQ(crops[0], crops[2]);
+
+	EXPECT_TRUE(wsq.crop(std::vector<BE::Image::ROI>{}).empty());
+}
+
+TEST_F(WSQCrop, Invalid)
+{
+	const auto dimensions = wsq.getDimensions();
+	EXPECT_THROW(wsq.crop({{0, 10}, 0, 0, {}}),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(wsq.crop({{10, 10}, dimensions.xSize, 0, {}}),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(wsq.crop({{10, 10}, 0, dimensions.ySize, {}}),
+	    BE::Error::ParameterError);
+}
+
+TEST_F(WSQCrop, Concurrent)
+{
+	const BE::Image::ROI roi({200, 200}, 32, 32, {});
+	const auto expected = wsq.crop(roi);
+
+	std::vector<std::thread> threads;
+	std::vector<uint32_t> mismatches(std::max(4u,
+	    std::thread::hardware_concurrency()), 0);
+	for (auto &count : mismatches) {
+		threads.emplace_back([&]() {
+			for (int i = 0; i < 10; i++)
+				if (wsq.crop(roi) != expected)
+					count++;
+		});
+	}
+	for (auto &thread : threads)
+		thread.join();
+
+	for (const auto count : mismatches)
+		EXPECT_EQ(0u, count);
+}
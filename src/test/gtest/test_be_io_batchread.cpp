@@ -0,0 +1,270 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <be_error_exception.h>
+#include <be_io_recordstore.h>
+#include <be_io_utility.h>
+#include <be_memory_autoarray.h>
+
+#include "../../libbiomeval/be_io_batchread_impl.h"
+
+#include <gtest/gtest.h>
+
+namespace BE = BiometricEvaluation;
+
+/** @return Contents of the record for key number i */
+static std::string
+recordData(
+    const uint32_t i)
+{
+	/* Vary sizes so that records straddle storage boundaries */
+	return (std::string(1 + ((i * 97) % 5000),
+	    static_cast<char>('A' + (i % 26))) + std::to_string(i));
+}
+
+/** @return Keys of numRecords records, inserted into a new store */
+static std::vector<std::string>
+createStore(
+    const std::string &name,
+    const BE::IO::RecordStore::Kind kind,
+    const uint32_t numRecords)
+{
+	if (BE::IO::Utility::fileExists(name))
+		BE::IO::RecordStore::removeRecordStore(name);
+
+	std::vector<std::string> keys;
+	auto rs = BE::IO::RecordStore::createRecordStore(name, "Batch read",
+	    kind);
+	for (uint32_t i = 0; i < numRecords; i++) {
+		const std::string data = recordData(i);
+		keys.push_back("key" + std::to_string(i));
+		rs->insert(keys.back(), data.data(), data.size());
+	}
+	rs->sync();
+	return (keys);
+}
+
+/** Read keys in a shuffled order and compare against what was stored */
+static void
+checkOrdering(
+    const std::string &name,
+    const BE::IO::RecordStore::Kind kind)
+{
+	static const uint32_t numRecords = 200;
+	std::vector<std::string> keys;
+	ASSERT_NO_THROW(keys = createStore(name, kind, numRecords));
+
+	std::vector<uint32_t> order(numRecords);
+	for (uint32_t i = 0; i < numRecords; i++)
+		order[i] = i;
+	std::shuffle(order.begin(), order.end(), std::mt19937(1));
+	std::vector<std::string> shuffled;
+	for (const auto i : order)
+		shuffled.push_back(keys[i]);
+
+	auto rs = BE::IO::RecordStore::openRecordStore(name,
+	    BE::IO::Mode::ReadOnly);
+	std::vector<BE::Memory::uint8Array> records;
+	ASSERT_NO_THROW(records = rs->read(shuffled));
+	ASSERT_EQ(numRecords, records.size());
+	for (uint32_t i = 0; i < numRecords; i++) {
+		const std::string expected = recordData(order[i]);
+		ASSERT_EQ(expected.size(), records[i].size());
+		EXPECT_EQ(expected, std::string(reinterpret_cast<const char*>(
+		    &records[i][0]), records[i].size()));
+	}
+
+	/* Repeated keys are each returned */
+	const std::vector<std::string> repeated{keys[3], keys[1], keys[3]};
+	ASSERT_NO_THROW(records = rs->read(repeated));
+	ASSERT_EQ(3, records.size());
+	EXPECT_EQ(recordData(3).size(), records[0].size());
+	EXPECT_EQ(recordData(1).size(), records[1].size());
+	EXPECT_EQ(recordData(3).size(), records[2].size());
+
+	EXPECT_NO_THROW(records = rs->read(std::vector<std::string>()));
+	EXPECT_EQ(0, records.size());
+
+	rs.reset();
+	EXPECT_NO_THROW(BE::IO::RecordStore::removeRecordStore(name));
+}
+
+/** Reading a key that is not stored throws, wherever it is in the batch */
+static void
+checkMissingKeys(
+    const std::string &name,
+    const BE::IO::RecordStore::Kind kind)
+{
+	std::vector<std::string> keys;
+	ASSERT_NO_THROW(keys = createStore(name, kind, 50));
+
+	auto rs = BE::IO::RecordStore::openRecordStore(name,
+	    BE::IO::Mode::ReadOnly);
+	for (const size_t position : {size_t(0), size_t(25), keys.size()}) {
+		std::vector<std::string> withMissing(keys);
+		withMissing.insert(withMissing.begin() + position, "missing");
+		EXPECT_THROW(rs->read(withMissing),
+		    BE::Error::ObjectDoesNotExist);
+	}
+
+	/* The store remains usable */
+	EXPECT_EQ(keys.size(), rs->read(keys).size());
+
+	rs.reset();
+	EXPECT_NO_THROW(BE::IO::RecordStore::removeRecordStore(name));
+}
+
+TEST(BatchRead, FileRecordStoreOrdering)
+{
+	checkOrdering("batchread_file", BE::IO::RecordStore::Kind::File);
+}
+
+TEST(BatchRead, ArchiveRecordStoreOrdering)
+{
+	checkOrdering("batchread_archive", BE::IO::RecordStore::Kind::Archive);
+}
+
+TEST(BatchRead, FileRecordStoreMissingKeys)
+{
+	checkMissingKeys("batchread_file", BE::IO::RecordStore::Kind::File);
+}
+
+TEST(BatchRead, ArchiveRecordStoreMissingKeys)
+{
+	checkMissingKeys("batchread_archive",
+	    BE::IO::RecordStore::Kind::Archive);
+}
+
+/** Iterate a store, which reads records ahead in batches */
+static void
+checkIterator(
+    const std::string &name,
+    const BE::IO::RecordStore::Kind kind)
+{
+	static const uint32_t numRecords = 100;
+	ASSERT_NO_THROW(createStore(name, kind, numRecords));
+	auto rs = BE::IO::RecordStore::openRecordStore(name,
+	    BE::IO::Mode::ReadOnly);
+
+	std::vector<std::string> sequenced;
+	for (uint32_t i = 0; i < numRecords; i++)
+		sequenced.push_back(rs->sequenceKey());
+
+	/* Every record, in sequence order */
+	uint32_t count = 0;
+	for (const auto &record : *rs) {
+		ASSERT_LT(count, numRecords);
+		EXPECT_EQ(sequenced[count], record.key);
+		const std::string expected = recordData(std::stoul(
+		    record.key.substr(3)));
+		EXPECT_EQ(expected, std::string(reinterpret_cast<const char*>(
+		    &record.data[0]), record.data.size()));
+		count++;
+	}
+	EXPECT_EQ(numRecords, count);
+
+	/* Skipping through and past records read ahead */
+	for (const uint32_t skip : {2u, 7u, 40u}) {
+		auto it = rs->begin();
+		for (uint32_t i = 0; (i + skip) < numRecords; i += skip) {
+			EXPECT_EQ(sequenced[i], it->key);
+			it += skip;
+			ASSERT_TRUE(it != rs->end());
+		}
+	}
+
+	rs.reset();
+	EXPECT_NO_THROW(BE::IO::RecordStore::removeRecordStore(name));
+}
+
+TEST(BatchRead, FileRecordStoreIterator)
+{
+	checkIterator("batchread_file", BE::IO::RecordStore::Kind::File);
+}
+
+TEST(BatchRead, ArchiveRecordStoreIterator)
+{
+	checkIterator("batchread_archive", BE::IO::RecordStore::Kind::Archive);
+}
+
+/** Read out-of-order regions of a file, with and without io_uring */
+static void
+checkRequests(
+    const bool useIOURing)
+{
+	const std::string path = "batchread_regions";
+	std::string contents;
+	for (uint32_t i = 0; i < 64 * 1024; i++)
+		contents.push_back(static_cast<char>(i % 251));
+	FILE *fp = std::fopen(path.c_str(), "wb");
+	ASSERT_NE(nullptr, fp);
+	ASSERT_EQ(contents.size(), std::fwrite(contents.data(), 1,
+	    contents.size(), fp));
+	std::fclose(fp);
+
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	ASSERT_NE(-1, fd);
+
+	/* Batches smaller and larger than the thread threshold */
+	for (const uint32_t numRequests : {1u, 3u, 100u}) {
+		std::vector<BE::Memory::uint8Array> buffers;
+		std::vector<BE::IO::BatchRead::Request> requests;
+		buffers.reserve(numRequests);
+		for (uint32_t i = 0; i < numRequests; i++) {
+			const uint64_t offset = ((numRequests - i) * 613) %
+			    (contents.size() - 1024);
+			const uint64_t size = 1 + ((i * 37) % 1024);
+			buffers.emplace_back(size);
+			requests.push_back({fd, offset, size, buffers.back()});
+		}
+
+		EXPECT_NO_THROW(BE::IO::BatchRead::read(requests, 4,
+		    useIOURing));
+		for (const auto &request : requests)
+			EXPECT_EQ(contents.substr(request.offset,
+			    request.size), std::string(reinterpret_cast<
+			    const char*>(request.buffer), request.size));
+	}
+
+	/* Reading past the end of the file fails */
+	BE::Memory::uint8Array buffer(16);
+	std::vector<BE::IO::BatchRead::Request> requests{
+	    {fd, 0, 16, buffer},
+	    {fd, contents.size() - 8, 16, buffer}};
+	EXPECT_THROW(BE::IO::BatchRead::read(requests, 4, useIOURing),
+	    BE::Error::StrategyError);
+
+	::close(fd);
+	std::remove(path.c_str());
+}
+
+TEST(BatchRead, PreadFallback)
+{
+	checkRequests(false);
+}
+
+TEST(BatchRead, DefaultMethod)
+{
+	if (!BE::IO::BatchRead::isIOURingAvailable())
+		std::cout << "io_uring is not available; testing pread()" <<
+		    std::endl;
+	checkRequests(true);
+}
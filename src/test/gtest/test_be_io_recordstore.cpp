@@ -11,6 +11,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -51,6 +52,11 @@
 #define TESTDEFINED
 #endif
 
+#ifdef DEDUPLICATEDRECORDSTORETEST
+#include <be_io_deduplicatedrecstore.h>
+#define TESTDEFINED
+#endif
+
 #ifdef TESTDEFINED
 namespace BE = BiometricEvaluation;
 #endif
@@ -218,6 +224,10 @@ protected:
 		EXPECT_NO_THROW(_rs.reset(
 		    new BE::IO::CompressedRecordStore(rsname, desc,
 	    	    BE::IO::RecordStore::Kind::BerkeleyDB, "GZIP")));
+#elif defined DEDUPLICATEDRECORDSTORETEST
+		EXPECT_NO_THROW(_rs.reset(
+		    new BE::IO::DeduplicatedRecordStore(rsname, desc,
+		    BE::IO::RecordStore::Kind::Archive)));
 #else
 		EXPECT_NO_THROW(_rs.reset(nullptr));
 #endif
@@ -237,6 +247,8 @@ protected:
 	std::shared_ptr<BE::IO::SQLiteRecordStore> _rs;
 #elif defined COMPRESSEDRECORDSTORETEST
 	std::shared_ptr<BE::IO::CompressedRecordStore> _rs;
+#elif defined DEDUPLICATEDRECORDSTORETEST
+	std::shared_ptr<BE::IO::DeduplicatedRecordStore> _rs;
 #endif
 };
 
@@ -452,8 +464,148 @@ TEST(ArchiveRecordStore, vacuum)
 	EXPECT_GE(startingSpace, rs->getSpaceUsed());
 	delete rs;
 }
+
+TEST(ArchiveRecordStore, corruption)
+{
+	const std::string corruptname = "corrupt_test";
+	const std::string wdata = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+	std::unique_ptr<BE::IO::ArchiveRecordStore> rs;
+	ASSERT_NO_THROW(rs.reset(new BE::IO::ArchiveRecordStore(corruptname,
+	    "Corruption Test")));
+	rs->insert("good", wdata.data(), wdata.size());
+	rs->insert("bad", wdata.data(), wdata.size());
+	rs->sync();
+
+	/* Flip a byte of the second record */
+	std::fstream archive(corruptname + "/" +
+	    BE::IO::ArchiveRecordStore::ARCHIVE_FILE_NAME,
+	    std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+	ASSERT_TRUE(archive.is_open());
+	archive.seekp(wdata.size() + 1);
+	archive.put('!');
+	archive.close();
+
+	/* Verification is off by default */
+	EXPECT_NO_THROW(rs->read("bad"));
+	rs->setChecksumVerification(true);
+	EXPECT_NO_THROW(rs->read("good"));
+	EXPECT_THROW(rs->read("bad"), BE::Error::DataError);
+
+	const std::vector<std::string> badKeys = rs->verify();
+	ASSERT_EQ(1, badKeys.size());
+	EXPECT_EQ("bad", badKeys[0]);
+
+	rs.reset();
+	EXPECT_NO_THROW(BE::IO::RecordStore::removeRecordStore(corruptname));
+}
+
+TEST(ArchiveRecordStore, checksumCompaction)
+{
+	const std::string compactname = "compact_test";
+	const std::string wdata = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+	std::unique_ptr<BE::IO::ArchiveRecordStore> rs;
+	ASSERT_NO_THROW(rs.reset(new BE::IO::ArchiveRecordStore(compactname,
+	    "Compaction Test")));
+	rs->insert("kept", wdata.data(), wdata.size());
+	const std::string churn(200, 'c');
+	for (int i = 0; i < 5000; i++) {
+		rs->insert(churn, wdata.data(), wdata.size());
+		rs->remove(churn);
+	}
+	rs->sync();
+
+	/* The journal is left alone while checksums are not verified */
+	const std::string journal = compactname + "/.rschecksums";
+	ASSERT_TRUE(BE::IO::Utility::fileExists(journal));
+	EXPECT_LE(1024 * 1024, BE::IO::Utility::getFileSize(journal));
+
+	/* Superseded checksums are dropped from the journal on sync */
+	rs->setChecksumVerification(true);
+	rs->sync();
+	EXPECT_GT(1024, BE::IO::Utility::getFileSize(journal));
+
+	EXPECT_NO_THROW(rs->read("kept"));
+	EXPECT_EQ(0, rs->verify().size());
+
+	rs.reset();
+	EXPECT_NO_THROW(BE::IO::RecordStore::removeRecordStore(compactname));
+}
 #endif /* ARCHIVERECORDSTORETEST */
 
+#ifdef DEDUPLICATEDRECORDSTORETEST
+TEST(DeduplicatedRecordStore, deduplication)
+{
+	const std::string dedupname = "dedup_test";
+	const std::string dup = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+	const std::string unique = "abcdefghijklmnopqrstuvwxyz0123456789";
+
+	std::unique_ptr<BE::IO::DeduplicatedRecordStore> rs;
+	ASSERT_NO_THROW(rs.reset(new BE::IO::DeduplicatedRecordStore(
+	    dedupname, "Dedup Test", BE::IO::RecordStore::Kind::Archive)));
+	EXPECT_DOUBLE_EQ(1.0, rs->getDeduplicationRatio());
+
+	rs->insert("dup1", dup.data(), dup.size());
+	rs->insert("dup2", dup.data(), dup.size());
+	rs->insert("dup3", dup.data(), dup.size());
+	rs->insert("unique", unique.data(), unique.size());
+
+	EXPECT_EQ(4, rs->getCount());
+	EXPECT_EQ(2, rs->getUniqueCount());
+	EXPECT_EQ(rs->getContentID("dup1"), rs->getContentID("dup3"));
+	EXPECT_NE(rs->getContentID("dup1"), rs->getContentID("unique"));
+	EXPECT_EQ((3 * dup.size()) + unique.size(), rs->getLogicalSize());
+	EXPECT_EQ(dup.size() + unique.size(), rs->getUniqueSize());
+	EXPECT_DOUBLE_EQ(static_cast<double>((3 * dup.size()) +
+	    unique.size()) / (dup.size() + unique.size()),
+	    rs->getDeduplicationRatio());
+
+	/* Space of the duplicates is saved in the space used */
+	rs->sync();
+	const auto stats = rs->getSpaceStatistics();
+	EXPECT_EQ(rs->getSpaceUsed(), stats.spaceUsed);
+	EXPECT_EQ(rs->getLogicalSize(), stats.logicalSize);
+	EXPECT_EQ(rs->getUniqueSize(), stats.uniqueSize);
+	EXPECT_EQ(stats.spaceUsed + (2 * dup.size()),
+	    stats.undeduplicatedSpace);
+	EXPECT_DOUBLE_EQ(rs->getDeduplicationRatio(),
+	    stats.deduplicationRatio);
+	EXPECT_LT(1.0, stats.spaceRatio);
+
+	BE::Memory::uint8Array rdata = rs->read("dup2");
+	EXPECT_EQ(dup, std::string(reinterpret_cast<const char *>(
+	    &rdata[0]), rdata.size()));
+	EXPECT_EQ(dup.size(), rs->length("dup2"));
+
+	/* Shared value survives until its last reference is removed */
+	rs->remove("dup1");
+	rs->remove("dup2");
+	EXPECT_EQ(2, rs->getUniqueCount());
+	rdata = rs->read("dup3");
+	EXPECT_EQ(dup, std::string(reinterpret_cast<const char *>(
+	    &rdata[0]), rdata.size()));
+	rs->remove("dup3");
+	EXPECT_EQ(1, rs->getUniqueCount());
+	EXPECT_EQ(unique.size(), rs->getLogicalSize());
+	EXPECT_EQ(unique.size(), rs->getUniqueSize());
+
+	/* Statistics persist */
+	rs->insert("dup1", dup.data(), dup.size());
+	rs->insert("dup2", dup.data(), dup.size());
+	const double ratio = rs->getDeduplicationRatio();
+	rs.reset();
+	ASSERT_NO_THROW(rs.reset(new BE::IO::DeduplicatedRecordStore(
+	    dedupname)));
+	EXPECT_DOUBLE_EQ(ratio, rs->getDeduplicationRatio());
+	EXPECT_EQ(3, rs->getCount());
+	EXPECT_EQ(2, rs->getUniqueCount());
+	rs.reset();
+
+	EXPECT_NO_THROW(BE::IO::RecordStore::removeRecordStore(dedupname));
+}
+#endif /* DEDUPLICATEDRECORDSTORETEST */
+
 int
 main(
     int argc,
@@ -13,6 +13,8 @@
 
 #include <unistd.h>
 
+#include <cstring>
+
 #include <be_io_utility.h>
 #include <be_memory_autoarray.h>
 
@@ -69,6 +71,33 @@ TEST(IOUtility, FileIO)
 	EXPECT_EQ(0, unlink(tempFileName.c_str()));
 }
 
+TEST(IOUtility, MapFile)
+{
+	const std::string filename = "test_be_io_utility.cpp";
+	const auto originalFile = BE::IO::Utility::readFile(filename);
+
+	BE::Memory::ByteSpan mapped;
+	EXPECT_NO_THROW(mapped = BE::IO::Utility::mapFile(filename));
+	EXPECT_TRUE(mapped.isOwned());
+	ASSERT_FALSE(different(originalFile, mapped.toUint8Array()));
+
+	/* Spans of the mapping remain valid after the original */
+	auto tail = mapped.subspan(mapped.size() - 10, 10);
+	mapped = BE::Memory::ByteSpan();
+	EXPECT_EQ(0, std::memcmp(originalFile + (originalFile.size() - 10),
+	    tail.data(), tail.size()));
+
+	/* Empty files can't be mapped, but are empty spans */
+	std::string emptyFile;
+	ASSERT_NO_THROW(emptyFile = BE::IO::Utility::createTemporaryFile(
+	    "test"));
+	EXPECT_EQ(0u, BE::IO::Utility::mapFile(emptyFile).size());
+	EXPECT_EQ(0, unlink(emptyFile.c_str()));
+
+	EXPECT_THROW(BE::IO::Utility::mapFile("DoesNotExist"),
+	    BE::Error::ObjectDoesNotExist);
+}
+
 TEST(IOUtility, SetAside)
 {
 	const std::string filename = "test_be_io_utility.cpp";
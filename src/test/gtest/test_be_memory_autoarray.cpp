@@ -175,3 +175,66 @@ TEST(AutoArray, Assignment)
 	EXPECT_EQ(a1[25], a3[25]);
 }
 
+
+TEST(AutoArray, Growth)
+{
+	BE::Memory::uint8Array aa;
+	for (uint32_t i = 0; i < 100000; i++) {
+		aa.resize(i + 1);
+		aa[i] = static_cast<uint8_t>(i);
+	}
+	ASSERT_EQ(aa.size(), 100000);
+	for (uint32_t i = 0; i < aa.size(); i++)
+		EXPECT_EQ(aa[i], static_cast<uint8_t>(i));
+
+	/* Growth of non-trivial types moves the existing elements */
+	BE::Memory::AutoArray<std::string> as(1);
+	as[0] = "Test";
+	as.resize(1024);
+	EXPECT_EQ(as[0], "Test");
+}
+
+TEST(AutoArray, Pooled)
+{
+	BE::Memory::BufferPool::clear();
+	EXPECT_EQ(BE::Memory::BufferPool::getCachedSize(), 0);
+
+	const uint8_t *first;
+	{
+		BE::Memory::uint8Array aa(1000000,
+		    BE::Memory::Allocation::Pooled);
+		EXPECT_EQ(aa.size(), 1000000);
+		std::fill(aa.begin(), aa.end(), 42);
+		first = aa;
+	}
+	EXPECT_GE(BE::Memory::BufferPool::getCachedSize(), 1000000);
+
+	/* A buffer of a similar size is recycled */
+	BE::Memory::uint8Array aa(999000, BE::Memory::Allocation::Pooled);
+	EXPECT_EQ(static_cast<const uint8_t *>(aa), first);
+	EXPECT_EQ(BE::Memory::BufferPool::getCachedSize(), 0);
+
+	/* Pooled arrays resize, copy, and move like any other */
+	aa[0] = 1;
+	aa.resize(2000000);
+	EXPECT_EQ(aa[0], 1);
+	BE::Memory::uint8Array copy(aa);
+	EXPECT_EQ(copy, aa);
+	BE::Memory::uint8Array moved(std::move(aa));
+	EXPECT_EQ(moved, copy);
+
+	/* Non-trivial types ignore the pool */
+	BE::Memory::AutoArray<std::string> as(16,
+	    BE::Memory::Allocation::Pooled);
+	as[15] = "Test";
+	EXPECT_EQ(as[15], "Test");
+
+	BE::Memory::BufferPool::setCacheLimit(0);
+	{
+		BE::Memory::uint8Array uncached(1000000,
+		    BE::Memory::Allocation::Pooled);
+	}
+	EXPECT_EQ(BE::Memory::BufferPool::getCachedSize(), 0);
+	BE::Memory::BufferPool::setCacheLimit(
+	    BE::Memory::BufferPool::DEFAULT_CACHE_LIMIT);
+}
@@ -0,0 +1,128 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <be_error_exception.h>
+#include <be_image_raw.h>
+#include <be_memory_autoarray.h>
+#include <be_memory_bytespan.h>
+
+namespace BE = BiometricEvaluation;
+
+const uint64_t bufSize = 1024;
+
+static BE::Memory::uint8Array
+makeBuffer()
+{
+	BE::Memory::uint8Array buf(bufSize);
+	for (uint64_t i = 0; i < bufSize; i++)
+		buf[i] = static_cast<uint8_t>(i);
+	return (buf);
+}
+
+TEST(ByteSpan, Construction)
+{
+	BE::Memory::ByteSpan empty;
+	EXPECT_TRUE(empty.empty());
+	EXPECT_EQ(0, empty.size());
+	EXPECT_TRUE(empty.isOwned());
+
+	/* Borrowing is explicit, and never from a temporary */
+	static_assert(!std::is_convertible<const BE::Memory::uint8Array&,
+	    BE::Memory::ByteSpan>::value, "Implicit borrow");
+	static_assert(!std::is_constructible<BE::Memory::ByteSpan,
+	    BE::Memory::uint8Array&&>::value, "Borrow of temporary");
+
+	/* Borrowed from an AutoArray */
+	BE::Memory::uint8Array buf = makeBuffer();
+	BE::Memory::ByteSpan borrowed(buf);
+	EXPECT_EQ(bufSize, borrowed.size());
+	EXPECT_EQ(&(*buf), borrowed.data());
+	EXPECT_FALSE(borrowed.isOwned());
+
+	/* Copied */
+	auto copied = BE::Memory::ByteSpan::copyOf(buf, buf.size());
+	EXPECT_EQ(bufSize, copied.size());
+	EXPECT_NE(&(*buf), copied.data());
+	EXPECT_TRUE(copied.isOwned());
+	for (uint64_t i = 0; i < bufSize; i++)
+		EXPECT_EQ(buf[i], copied[i]);
+
+	/* Ownership taken */
+	const uint8_t *original = buf;
+	auto shared = BE::Memory::ByteSpan::share(std::move(buf));
+	EXPECT_EQ(original, shared.data());
+	EXPECT_TRUE(shared.isOwned());
+}
+
+TEST(ByteSpan, Lifetime)
+{
+	BE::Memory::ByteSpan copy;
+	{
+		BE::Memory::uint8Array buf = makeBuffer();
+		auto shared = BE::Memory::ByteSpan::share(std::move(buf));
+		copy = shared;
+	}
+	/* Owner outlives the original span */
+	ASSERT_EQ(bufSize, copy.size());
+	for (uint64_t i = 0; i < bufSize; i++)
+		EXPECT_EQ(static_cast<uint8_t>(i), copy[i]);
+
+	BE::Memory::uint8Array buf = makeBuffer();
+	auto owned = BE::Memory::ByteSpan(buf).toOwned();
+	EXPECT_TRUE(owned.isOwned());
+	EXPECT_NE(&(*buf), owned.data());
+	EXPECT_EQ(owned.data(), owned.toOwned().data());
+}
+
+TEST(ByteSpan, Subspan)
+{
+	auto span = BE::Memory::ByteSpan::share(makeBuffer());
+
+	auto sub = span.subspan(10, 20);
+	EXPECT_EQ(20, sub.size());
+	EXPECT_EQ(span.data() + 10, sub.data());
+	EXPECT_TRUE(sub.isOwned());
+	EXPECT_EQ(10, *sub.begin());
+	EXPECT_EQ(20, sub.end() - sub.begin());
+
+	EXPECT_NO_THROW(span.subspan(bufSize, 0));
+	EXPECT_THROW(span.subspan(bufSize, 1), BE::Error::ParameterError);
+	EXPECT_THROW(span.subspan(bufSize + 1, 0),
+	    BE::Error::ParameterError);
+	EXPECT_THROW(sub.subspan(10, 11), BE::Error::ParameterError);
+
+	auto copy = sub.toUint8Array();
+	ASSERT_EQ(sub.size(), copy.size());
+	for (uint64_t i = 0; i < copy.size(); i++)
+		EXPECT_EQ(sub[i], copy[i]);
+}
+
+TEST(ByteSpan, Image)
+{
+	auto span = BE::Memory::ByteSpan::share(makeBuffer());
+
+	/* Image constructed from a span does not copy the data */
+	BE::Image::Raw raw(span, BE::Image::Size(32, 32), 8, 8,
+	    BE::Image::Resolution(500, 500), false);
+	EXPECT_EQ(span.data(), raw.getDataSpan().data());
+	EXPECT_EQ(bufSize, raw.getDataSpan().size());
+
+	/* Raw data of an uncompressed image is the original data */
+	auto rawData = raw.getRawData();
+	ASSERT_EQ(bufSize, rawData.size());
+	for (uint64_t i = 0; i < bufSize; i++)
+		EXPECT_EQ(span[i], rawData[i]);
+}
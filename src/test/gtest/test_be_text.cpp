@@ -49,6 +49,21 @@ TEST(Text, digestSHA256)
 	    "af2ef", BE::Text::digest("Hello, world.", "sha256"));
 }
 
+TEST(Text, crc32c)
+{
+	/* Check value from RFC 3720 */
+	const std::string check{"123456789"};
+	EXPECT_EQ(0xE3069283, BE::Text::crc32c(check.data(), check.size()));
+	EXPECT_EQ(0, BE::Text::crc32c(nullptr, 0));
+
+	/* Unaligned lengths and incremental computation */
+	const std::string s{"The quick brown fox jumps over the lazy dog"};
+	EXPECT_EQ(0x22620404, BE::Text::crc32c(s.data(), s.size()));
+	const uint32_t partial = BE::Text::crc32c(s.data(), 13);
+	EXPECT_EQ(0x22620404, BE::Text::crc32c(s.data() + 13, s.size() - 13,
+	    partial));
+}
+
 TEST(Text, split)
 {
 	/* Split on commas */
@@ -0,0 +1,138 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+/*
+ * Compare constructing every view and minutiae record of an AN2K
+ * transaction from the buffer, each parsing the transaction, to
+ * constructing a DataInterchange::AN2KRecord, which parses it once and
+ * shares the parse tree with all of them, and to constructing one lazily
+ * to read only its Type-1 fields, as when scanning for metadata.
+ *
+ * Usage: test_be_data_interchange_an2k-bench [iterations]
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <be_data_interchange_an2k.h>
+#include <be_error_exception.h>
+#include <be_io_utility.h>
+#include <be_time_timer.h>
+
+using namespace BiometricEvaluation;
+using namespace std;
+
+static const vector<string> AN2KPaths{"test_data/type9.an2k",
+    "test_data/type9-13.an2k", "test_data/type9-15.an2k",
+    "test_data/type9-efs.an2k", "test_data/type3.an2k",
+    "test_data/type4-slaps.an2k"};
+
+/*
+ * Construct each view and minutiae record of buf from the buffer, as
+ * AN2KRecord did before sharing one parse.
+ * @return Number of views and minutiae records constructed.
+ */
+static uint64_t
+readSeparately(
+    const Memory::ByteSpan &buf)
+{
+	using RecordType = View::AN2KView::RecordType;
+	const auto an2k = DataInterchange::AN2KRecord::parse(buf);
+	uint64_t count = 0;
+
+	for (const auto i : DataInterchange::AN2KRecord::recordLocations(
+	    an2k.get(), RecordType::Type_9)) {
+		Finger::AN2KMinutiaeDataRecord record(buf, i);
+		count++;
+	}
+	const auto captures = DataInterchange::AN2KRecord::recordLocations(
+	    an2k.get(), RecordType::Type_14).size();
+	for (uint32_t i = 1; i <= captures; i++, count++)
+		Finger::AN2KViewCapture view(buf, i);
+	const auto latents = DataInterchange::AN2KRecord::recordLocations(
+	    an2k.get(), RecordType::Type_13).size();
+	for (uint32_t i = 1; i <= latents; i++, count++)
+		Latent::AN2KView view(buf, i);
+	const auto palms = DataInterchange::AN2KRecord::recordLocations(
+	    an2k.get(), RecordType::Type_15).size();
+	for (uint32_t i = 1; i <= palms; i++, count++)
+		Palm::AN2KView view(buf, i);
+
+	return (count);
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+	const uint32_t iterations = (argc > 1 ? std::atoi(argv[1]) : 100);
+	if (iterations == 0) {
+		cerr << "Usage: " << argv[0] << " [iterations]" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	cout << "Mean time (us) of " << iterations << " reads of each "
+	    "transaction" << endl;
+	cout << left << setw(28) << "Transaction" << right << setw(8) <<
+	    "Objects" << setw(14) << "Separately" << setw(14) <<
+	    "AN2KRecord" << setw(10) << "Speedup" << setw(12) << "Type-1" <<
+	    setw(10) << "Speedup" << endl;
+
+	Time::Timer timer;
+	for (const auto &path : AN2KPaths) {
+		try {
+			const auto data = IO::Utility::readFile(path);
+			const Memory::ByteSpan buf(data);
+
+			uint64_t objects = 0;
+			timer.start();
+			for (uint32_t n = 0; n < iterations; n++)
+				objects = readSeparately(buf);
+			timer.stop();
+			const double separateUS = static_cast<double>(
+			    timer.elapsed()) / iterations;
+
+			timer.start();
+			for (uint32_t n = 0; n < iterations; n++)
+				DataInterchange::AN2KRecord record(buf);
+			timer.stop();
+			const double recordUS = static_cast<double>(
+			    timer.elapsed()) / iterations;
+
+			string tcn;
+			timer.start();
+			for (uint32_t n = 0; n < iterations; n++) {
+				DataInterchange::AN2KRecord record(buf,
+				    DataInterchange::AN2KRecord::Construction::
+				    Lazy);
+				tcn = record.getTransactionControlNumber();
+			}
+			timer.stop();
+			const double type1US = static_cast<double>(
+			    timer.elapsed()) / iterations;
+
+			cout << left << setw(28) << path << right <<
+			    setw(8) << objects << fixed << setprecision(1) <<
+			    setw(14) << separateUS << setw(14) << recordUS <<
+			    setprecision(2) << setw(10) <<
+			    (separateUS / recordUS) << setprecision(1) <<
+			    setw(12) << type1US << setprecision(2) <<
+			    setw(10) << (recordUS / type1US) << endl;
+		} catch (const Error::Exception &e) {
+			cerr << path << ": " << e.whatString() << endl;
+		}
+	}
+
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,188 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+/*
+ * Time writing AN2K transactions with DataInterchange::AN2KWriter:
+ * repackaging the records of a transaction as read by AN2KReader, and
+ * assembling a transaction from views, whose image records are formatted
+ * from the views, into a reused buffer. Writing the NBIS parse tree of
+ * the transaction into the same buffer is timed for comparison.
+ *
+ * Usage: test_be_data_interchange_an2kwriter-bench [iterations]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <be_data_interchange_an2k.h>
+#include <be_data_interchange_an2kreader.h>
+#include <be_data_interchange_an2kwriter.h>
+#include <be_error_exception.h>
+#include <be_io_utility.h>
+#include <be_time_timer.h>
+extern "C" {
+#include <an2k.h>
+}
+
+using namespace BiometricEvaluation;
+using namespace std;
+
+static const vector<string> AN2KPaths{"test_data/type9.an2k",
+    "test_data/type9-13.an2k", "test_data/type9-15.an2k",
+    "test_data/type9-efs.an2k", "test_data/type3.an2k",
+    "test_data/type4-slaps.an2k"};
+
+/* Views and records of a transaction, read once */
+struct Contents
+{
+	vector<DataInterchange::AN2KReader::Record> records;
+	vector<Finger::AN2KViewFixedResolution> fixed;
+	vector<Latent::AN2KView> latents;
+	vector<Palm::AN2KView> palms;
+	vector<Finger::AN2KViewCapture> captures;
+};
+
+static Contents
+readContents(
+    const Memory::ByteSpan &buf)
+{
+	using RecordType = View::AN2KView::RecordType;
+	const DataInterchange::AN2KRecord record(buf);
+	Contents contents;
+	contents.latents = record.getFingerLatents();
+	contents.palms = record.getPalmCaptures();
+	contents.captures = record.getFingerCaptures();
+
+	/* Other records are repackaged as they were read */
+	DataInterchange::AN2KReader reader(buf);
+	reader.sequence();
+	uint32_t type3 = 0, type4 = 0;
+	for (uint32_t i = 1; i < reader.getRecordCount(); i++) {
+		const auto r = reader.sequence();
+		switch (r.type) {
+		case RecordType::Type_3:
+			contents.fixed.emplace_back(buf, r.type, ++type3);
+			break;
+		case RecordType::Type_4:
+			contents.fixed.emplace_back(buf, r.type, ++type4);
+			break;
+		case RecordType::Type_13:
+		case RecordType::Type_14:
+		case RecordType::Type_15:
+			break;
+		default:
+			contents.records.push_back(r);
+			break;
+		}
+	}
+	return (contents);
+}
+
+/* Assemble a transaction from contents */
+static DataInterchange::AN2KWriter
+assemble(
+    const Contents &contents)
+{
+	DataInterchange::AN2KWriter writer("TEST", "DAI000000", "ORI000000",
+	    "TCN0001", "20261018");
+	uint32_t idc = 1;
+	for (const auto &record : contents.records)
+		writer.addRecord(record);
+	for (const auto &view : contents.fixed)
+		writer.addView(view, idc++);
+	for (const auto &view : contents.latents)
+		writer.addView(view, idc++);
+	for (const auto &view : contents.palms)
+		writer.addView(view, idc++);
+	for (const auto &view : contents.captures)
+		writer.addView(view, idc++);
+	return (writer);
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+	const uint32_t iterations = (argc > 1 ? std::atoi(argv[1]) : 1000);
+	if (iterations == 0) {
+		cerr << "Usage: " << argv[0] << " [iterations]" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	cout << "Mean time (us) of " << iterations << " writes of each "
+	    "transaction" << endl;
+	cout << left << setw(28) << "Transaction" << right << setw(10) <<
+	    "Bytes" << setw(12) << "NBIS" << setw(12) << "Records" <<
+	    setw(12) << "Views" << setw(12) << "Views/s" << endl;
+
+	Time::Timer timer;
+	for (const auto &path : AN2KPaths) {
+		try {
+			const auto data = IO::Utility::readFile(path);
+			const Memory::ByteSpan buf(data);
+			const auto an2k = DataInterchange::AN2KRecord::parse(
+			    buf);
+			const Contents contents = readContents(buf);
+
+			Memory::uint8Array out(buf.size() * 2);
+			timer.start();
+			for (uint32_t n = 0; n < iterations; n++) {
+				FILE *fp = fmemopen(out, out.size(), "wb");
+				if (fp == nullptr)
+					throw Error::StrategyError("fmemopen");
+				biomeval_nbis_write_ANSI_NIST(fp, an2k.get());
+				std::fclose(fp);
+			}
+			timer.stop();
+			const double nbisUS = static_cast<double>(
+			    timer.elapsed()) / iterations;
+
+			timer.start();
+			for (uint32_t n = 0; n < iterations; n++) {
+				DataInterchange::AN2KReader reader(buf);
+				DataInterchange::AN2KWriter writer("TEST",
+				    "DAI000000", "ORI000000", "TCN0001",
+				    "20261018");
+				reader.sequence();
+				const uint32_t count = reader.getRecordCount();
+				for (uint32_t i = 1; i < count; i++)
+					writer.addRecord(reader.sequence());
+				writer.write(out, out.size());
+			}
+			timer.stop();
+			const double recordsUS = static_cast<double>(
+			    timer.elapsed()) / iterations;
+
+			uint64_t length = 0;
+			timer.start();
+			for (uint32_t n = 0; n < iterations; n++)
+				length = assemble(contents).write(out,
+				    out.size());
+			timer.stop();
+			const double viewsUS = static_cast<double>(
+			    timer.elapsed()) / iterations;
+
+			cout << left << setw(28) << path << right <<
+			    setw(10) << length << fixed << setprecision(1) <<
+			    setw(12) << nbisUS << setw(12) << recordsUS <<
+			    setw(12) << viewsUS << setprecision(0) <<
+			    setw(12) << (1e6 / viewsUS) << endl;
+		} catch (const Error::Exception &e) {
+			cerr << path << ": " << e.whatString() << endl;
+		}
+	}
+
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,99 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+#ifndef TEST_BE_IMAGE_BENCH_H_
+#define TEST_BE_IMAGE_BENCH_H_
+
+/*
+ * Test images shared by the image benchmarks.
+ */
+
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <be_error_exception.h>
+#include <be_io_recordstore.h>
+#include <be_io_utility.h>
+#include <be_memory_autoarray.h>
+
+namespace BenchImages
+{
+	/** RecordStore of test images, relative to the test directory */
+	static const std::string ImageRSPath = "test_data/ImageRS";
+
+	/** @return Whether key ends with ext */
+	inline bool
+	hasExtension(
+	    const std::string &key,
+	    const std::string &ext)
+	{
+		return ((key.size() >= ext.size()) && (key.compare(
+		    key.size() - ext.size(), ext.size(), ext) == 0));
+	}
+
+	/**
+	 * @brief
+	 * Read test images.
+	 * @details
+	 * Images that cannot be read are reported on std::cerr and
+	 * skipped.
+	 *
+	 * @param[in] paths
+	 *	Paths of image files to read.
+	 * @param[in] extensions
+	 *	Endings, such as "wsq", of the keys of the records of
+	 *	ImageRSPath to read. Empty to read every record.
+	 *
+	 * @return
+	 *	Names and data of the images, files first.
+	 */
+	inline std::vector<std::pair<std::string,
+	    BiometricEvaluation::Memory::uint8Array>>
+	loadImages(
+	    const std::vector<std::string> &paths,
+	    const std::vector<std::string> &extensions = {})
+	{
+		namespace BE = BiometricEvaluation;
+
+		std::vector<std::pair<std::string, BE::Memory::uint8Array>>
+		    images;
+		for (const auto &path : paths) {
+			try {
+				images.emplace_back(path,
+				    BE::IO::Utility::readFile(path));
+			} catch (const BE::Error::Exception &e) {
+				std::cerr << path << ": " << e.whatString() <<
+				    std::endl;
+			}
+		}
+
+		try {
+			auto rs = BE::IO::RecordStore::openRecordStore(
+			    ImageRSPath, BE::IO::Mode::ReadOnly);
+			for (const auto &record : *rs) {
+				bool wanted = extensions.empty();
+				for (const auto &ext : extensions)
+					if (hasExtension(record.key, ext))
+						wanted = true;
+				if (wanted)
+					images.emplace_back(record.key,
+					    record.data);
+			}
+		} catch (const BE::Error::Exception &e) {
+			std::cerr << ImageRSPath << ": " << e.whatString() <<
+			    std::endl;
+		}
+
+		return (images);
+	}
+}
+
+#endif /* TEST_BE_IMAGE_BENCH_H_ */
@@ -0,0 +1,92 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+/*
+ * Compare decoding images with Image::getRawData(), which returns a new
+ * array each time, to Image::decodeInto() with one buffer reused for
+ * every decode.
+ *
+ * Usage: test_be_image_decodeinto-bench [iterations]
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <be_error_exception.h>
+#include <be_framework_enumeration.h>
+#include <be_image_image.h>
+#include <be_io_utility.h>
+#include <be_time_timer.h>
+
+using namespace BiometricEvaluation;
+using namespace std;
+
+static const std::vector<std::string> ImagePaths{"test_data/img.wsq",
+    "test_data/img.jpg", "test_data/img.jp2"};
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+	const uint32_t iterations = (argc > 1 ? std::atoi(argv[1]) : 100);
+	if (iterations == 0) {
+		cerr << "Usage: " << argv[0] << " [iterations]" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	cout << "Mean time (us) of " << iterations << " decodes" << endl;
+	cout << left << setw(24) << "Image" << setw(8) << "Format" << right <<
+	    setw(14) << "getRawData" << setw(14) << "decodeInto" <<
+	    setw(10) << "Speedup" << endl;
+
+	/* Sized by the first decode and reused after */
+	Memory::uint8Array buffer;
+	for (const auto &path : ImagePaths) {
+		try {
+			const auto image = Image::Image::openImage(
+			    IO::Utility::readFile(path));
+
+			Time::Timer timer;
+			timer.start();
+			for (uint32_t n = 0; n < iterations; n++)
+				image->getRawData();
+			timer.stop();
+			const double rawDataUS = static_cast<double>(
+			    timer.elapsed()) / iterations;
+
+			timer.start();
+			for (uint32_t n = 0; n < iterations; n++)
+				image->decodeInto(buffer);
+			timer.stop();
+			const double decodeIntoUS = static_cast<double>(
+			    timer.elapsed()) / iterations;
+
+			cout << left << setw(24) << path << setw(8) <<
+			    Framework::Enumeration::to_string(
+			    image->getCompressionAlgorithm()) << right <<
+			    fixed << setprecision(2) << setw(14) << rawDataUS <<
+			    setw(14) << decodeIntoUS << setw(10) <<
+			    (rawDataUS / decodeIntoUS);
+			if (image->getRawData() != buffer)
+				cout << "  (raw data differs)";
+			cout << endl;
+		} catch (const Error::Exception &e) {
+			cout << left << setw(24) << path <<
+			    "Could not decode: " << e.whatString() << endl;
+		}
+	}
+
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,135 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+/*
+ * Compare detecting the compression algorithm of each test image with
+ * Image::getCompressionAlgorithm() to trying each codec's predicate in
+ * turn, as getCompressionAlgorithm() once did.
+ *
+ * Usage: test_be_image_detect-bench [iterations]
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <be_error_exception.h>
+#include <be_framework_enumeration.h>
+#include <be_image_bmp.h>
+#include <be_image_image.h>
+#include <be_image_jpeg.h>
+#include <be_image_jpeg2000.h>
+#include <be_image_jpegl.h>
+#include <be_image_netpbm.h>
+#include <be_image_png.h>
+#include <be_image_tiff.h>
+#include <be_image_wsq.h>
+#include <be_time_timer.h>
+
+#include "test_be_image_bench.h"
+
+using namespace BiometricEvaluation;
+using namespace std;
+
+static const std::vector<std::string> SingleImagePaths{"test_data/img.wsq",
+    "test_data/img.jpg", "test_data/img.jp2"};
+
+/** @return Compression algorithm found by each codec's predicate in turn */
+static Image::CompressionAlgorithm
+detectWithPredicates(
+    const uint8_t *data,
+    uint64_t size)
+{
+	if (Image::NetPBM::isNetPBM(data, size))
+		return (Image::CompressionAlgorithm::NetPBM);
+	else if (Image::JPEG2000::isJPEG2000(data, size))
+		return (Image::CompressionAlgorithm::JP2);
+	else if (Image::JPEG::isJPEG(data, size))
+		return (Image::CompressionAlgorithm::JPEGB);
+	else if (Image::JPEGL::isJPEGL(data, size))
+		return (Image::CompressionAlgorithm::JPEGL);
+	else if (Image::PNG::isPNG(data, size))
+		return (Image::CompressionAlgorithm::PNG);
+	else if (Image::BMP::isBMP(data, size))
+		return (Image::CompressionAlgorithm::BMP);
+	else if (Image::WSQ::isWSQ(data, size))
+		return (Image::CompressionAlgorithm::WSQ20);
+	else if (Image::TIFF::isTIFF(data, size))
+		return (Image::CompressionAlgorithm::TIFF);
+	return (Image::CompressionAlgorithm::None);
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+	const uint32_t iterations = (argc > 1 ? std::atoi(argv[1]) : 100000);
+	if (iterations == 0) {
+		cerr << "Usage: " << argv[0] << " [iterations]" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	const auto images = BenchImages::loadImages(SingleImagePaths);
+	if (images.empty()) {
+		cerr << "No images found" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	cout << "Mean time (ns) of " << iterations << " detections of " <<
+	    "compression algorithm" << endl;
+	cout << left << setw(32) << "Image" << setw(8) << "Format" << right <<
+	    setw(12) << "Chain ns" << setw(12) << "Table ns" << setw(10) <<
+	    "Speedup" << endl;
+
+	double chainTotal = 0, tableTotal = 0;
+	for (const auto &image : images) {
+		const uint8_t *data = image.second;
+		const uint64_t size = image.second.size();
+
+		Image::CompressionAlgorithm chained{}, tabled{};
+		Time::Timer timer;
+		timer.start();
+		for (uint32_t n = 0; n < iterations; n++)
+			chained = detectWithPredicates(data, size);
+		timer.stop();
+		const double chainNS = static_cast<double>(
+		    timer.elapsed(true)) / iterations;
+
+		timer.start();
+		for (uint32_t n = 0; n < iterations; n++)
+			tabled = Image::Image::getCompressionAlgorithm(data,
+			    size);
+		timer.stop();
+		const double tableNS = static_cast<double>(
+		    timer.elapsed(true)) / iterations;
+
+		chainTotal += chainNS;
+		tableTotal += tableNS;
+		cout << left << setw(32) << image.first << setw(8) <<
+		    Framework::Enumeration::to_string(tabled) << right <<
+		    fixed << setprecision(1) << setw(12) << chainNS <<
+		    setw(12) << tableNS << setw(10) << setprecision(2) <<
+		    (chainNS / tableNS);
+		if (chained != tabled)
+			cout << "  (differs: " <<
+			    Framework::Enumeration::to_string(chained) << ")";
+		cout << endl;
+	}
+
+	cout << left << setw(40) << "Total" << right << fixed <<
+	    setprecision(1) << setw(12) << chainTotal << setw(12) <<
+	    tableTotal << setw(10) << setprecision(2) <<
+	    (chainTotal / tableTotal) << endl;
+
+	return (EXIT_SUCCESS);
+}
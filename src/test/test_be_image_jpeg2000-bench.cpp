@@ -0,0 +1,113 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+/*
+ * Measure JPEG2000 decoding time as the number of OpenJPEG decoding
+ * threads increases.
+ *
+ * Usage: test_be_image_jpeg2000-bench [iterations]
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <be_error_exception.h>
+#include <be_image_jpeg2000.h>
+#include <be_system.h>
+#include <be_time_timer.h>
+
+#include "test_be_image_bench.h"
+
+using namespace BiometricEvaluation;
+using namespace std;
+
+static const std::string SingleImagePath = "test_data/img.jp2";
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+	const uint32_t iterations = (argc > 1 ? std::atoi(argv[1]) : 5);
+	if (iterations == 0) {
+		cerr << "Usage: " << argv[0] << " [iterations]" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	uint32_t cpus;
+	try {
+		cpus = System::getCPUCount();
+	} catch (const Error::NotImplemented&) {
+		cpus = 1;
+	}
+	vector<uint32_t> threadCounts;
+	for (uint32_t threads = 1; threads < cpus; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(cpus);
+
+	const auto images = BenchImages::loadImages({SingleImagePath},
+	    {"jp2", "j2k", "p2l"});
+	if (images.empty()) {
+		cerr << "No JPEG2000 images found" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	cout << "Mean decoding time (ms) of " << iterations << " decodes "
+	    "by number of threads" << endl;
+	cout << left << setw(32) << "Image" << setw(12) << "Size";
+	for (const auto threads : threadCounts)
+		cout << right << setw(9) << threads;
+	cout << endl;
+
+	vector<double> totals(threadCounts.size(), 0);
+	for (const auto &image : images) {
+		try {
+			Image::JPEG2000 jp2(image.second, image.first);
+			cout << left << setw(32) << image.first << setw(12) <<
+			    to_string(jp2.getDimensions());
+
+			for (size_t i = 0; i < threadCounts.size(); i++) {
+				jp2.setDecodeThreads(threadCounts[i]);
+				/* Warm up allocators and thread pool */
+				jp2.getRawData();
+
+				Time::Timer timer;
+				timer.start();
+				for (uint32_t n = 0; n < iterations; n++)
+					jp2.getRawData();
+				timer.stop();
+
+				const double ms = timer.elapsed() / 1000.0 /
+				    iterations;
+				totals[i] += ms;
+				cout << right << setw(9) << fixed <<
+				    setprecision(1) << ms;
+			}
+			cout << endl;
+		} catch (const Error::Exception &e) {
+			cout << "Could not decode: " << e.whatString() << endl;
+		}
+	}
+
+	cout << left << setw(44) << "Total";
+	for (const auto total : totals)
+		cout << right << setw(9) << fixed << setprecision(1) << total;
+	cout << endl << left << setw(44) << "Speedup";
+	for (const auto total : totals)
+		cout << right << setw(9) << fixed << setprecision(2) <<
+		    (totals.front() / total);
+	cout << endl;
+
+	return (EXIT_SUCCESS);
+}
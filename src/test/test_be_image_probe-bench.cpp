@@ -0,0 +1,122 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+/*
+ * Compare reading image attributes with Image::probe() to opening each
+ * image with Image::openImage() and calling its getters. Both refer to
+ * the encoded data without copying it.
+ *
+ * Usage: test_be_image_probe-bench [iterations]
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <be_error_exception.h>
+#include <be_framework_enumeration.h>
+#include <be_image_image.h>
+#include <be_image_probe.h>
+#include <be_time_timer.h>
+
+#include "test_be_image_bench.h"
+
+using namespace BiometricEvaluation;
+using namespace std;
+
+static const std::vector<std::string> SingleImagePaths{"test_data/img.wsq",
+    "test_data/img.jpg", "test_data/img.jp2"};
+
+/** @return Attributes read through an opened Image */
+static Image::Attributes
+open(
+    const Memory::ByteSpan &data)
+{
+	const auto image = Image::Image::openImage(data);
+
+	Image::Attributes attributes;
+	attributes.compressionAlgorithm = image->getCompressionAlgorithm();
+	attributes.dimensions = image->getDimensions();
+	attributes.colorDepth = image->getColorDepth();
+	attributes.bitDepth = image->getBitDepth();
+	attributes.resolution = image->getResolution();
+	attributes.hasAlphaChannel = image->hasAlphaChannel();
+	return (attributes);
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+	const uint32_t iterations = (argc > 1 ? std::atoi(argv[1]) : 1000);
+	if (iterations == 0) {
+		cerr << "Usage: " << argv[0] << " [iterations]" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	const auto images = BenchImages::loadImages(SingleImagePaths);
+	if (images.empty()) {
+		cerr << "No images found" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	cout << "Mean time (us) of " << iterations << " reads of image " <<
+	    "attributes" << endl;
+	cout << left << setw(32) << "Image" << setw(8) << "Format" << right <<
+	    setw(12) << "Open us" << setw(12) << "Probe us" << setw(10) <<
+	    "Speedup" << endl;
+
+	double openTotal = 0, probeTotal = 0;
+	for (const auto &image : images) {
+		const Memory::ByteSpan data(image.second, image.second.size());
+		try {
+			Image::Attributes opened, probed;
+			Time::Timer timer;
+			timer.start();
+			for (uint32_t n = 0; n < iterations; n++)
+				opened = open(data);
+			timer.stop();
+			const double openUS = static_cast<double>(
+			    timer.elapsed()) / iterations;
+
+			timer.start();
+			for (uint32_t n = 0; n < iterations; n++)
+				probed = Image::probe(data);
+			timer.stop();
+			const double probeUS = static_cast<double>(
+			    timer.elapsed()) / iterations;
+
+			openTotal += openUS;
+			probeTotal += probeUS;
+			cout << left << setw(32) << image.first << setw(8) <<
+			    Framework::Enumeration::to_string(
+			    probed.compressionAlgorithm) << right << fixed <<
+			    setprecision(2) << setw(12) << openUS << setw(12) <<
+			    probeUS << setw(10) << (openUS / probeUS);
+			if ((opened.dimensions != probed.dimensions) ||
+			    (opened.colorDepth != probed.colorDepth) ||
+			    (opened.resolution != probed.resolution))
+				cout << "  (attributes differ)";
+			cout << endl;
+		} catch (const Error::Exception &e) {
+			cout << left << setw(32) << image.first <<
+			    "Could not read: " << e.whatString() << endl;
+		}
+	}
+
+	cout << left << setw(40) << "Total" << right << fixed <<
+	    setprecision(2) << setw(12) << openTotal << setw(12) <<
+	    probeTotal << setw(10) << (openTotal / probeTotal) << endl;
+
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,102 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+/*
+ * Time resampling a fingerprint image to other resolutions with each
+ * filter, on one thread and on one thread per processor core.
+ *
+ * Usage: test_be_image_resample-bench [iterations]
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <be_error_exception.h>
+#include <be_framework_enumeration.h>
+#include <be_image_resample.h>
+#include <be_image_wsq.h>
+#include <be_io_utility.h>
+#include <be_time_timer.h>
+
+using namespace BiometricEvaluation;
+using namespace std;
+
+static const std::vector<Image::ResampleFilter> Filters{
+    Image::ResampleFilter::Box, Image::ResampleFilter::Bilinear,
+    Image::ResampleFilter::Lanczos};
+
+/** @return Mean time (us) of resampling image to resolution */
+static double
+timeResample(
+    const Image::Raw &image,
+    const Image::Resolution &resolution,
+    Image::ResampleFilter filter,
+    uint32_t threads,
+    uint32_t iterations)
+{
+	Time::Timer timer;
+	timer.start();
+	for (uint32_t n = 0; n < iterations; n++)
+		Image::resample(image, resolution, filter, threads);
+	timer.stop();
+	return (static_cast<double>(timer.elapsed()) / iterations);
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+	const uint32_t iterations = (argc > 1 ? std::atoi(argv[1]) : 20);
+	if (iterations == 0) {
+		cerr << "Usage: " << argv[0] << " [iterations]" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	try {
+		/* Resample decoded pixels, so decoding is not timed */
+		const Image::WSQ wsq(IO::Utility::readFile(
+		    "test_data/img.wsq"));
+		const Image::Raw raw(wsq.getRawData(), wsq.getDimensions(),
+		    wsq.getColorDepth(), wsq.getBitDepth(),
+		    wsq.getResolution(), false);
+
+		cout << "Mean time (us) of " << iterations << " resamples "
+		    "of " << wsq.getDimensions() << " at " <<
+		    wsq.getResolution() << endl;
+		cout << left << setw(10) << "Filter" << setw(10) <<
+		    "To (PPI)" << right << setw(14) << "1 thread" <<
+		    setw(14) << "All cores" << setw(10) << "Speedup" << endl;
+		for (const auto filter : Filters) {
+			for (const double ppi : {250.0, 1000.0}) {
+				const Image::Resolution to{ppi, ppi,
+				    Image::Resolution::Units::PPI};
+				const double oneUS = timeResample(raw, to,
+				    filter, 1, iterations);
+				const double allUS = timeResample(raw, to,
+				    filter, 0, iterations);
+				cout << left << setw(10) <<
+				    Framework::Enumeration::to_string(filter) <<
+				    setw(10) << static_cast<uint32_t>(ppi) <<
+				    right << fixed <<
+				    setprecision(2) << setw(14) << oneUS <<
+				    setw(14) << allUS << setw(10) <<
+				    (oneUS / allUS) << endl;
+			}
+		}
+	} catch (const Error::Exception &e) {
+		cerr << "Could not resample: " << e.whatString() << endl;
+		return (EXIT_FAILURE);
+	}
+
+	return (EXIT_SUCCESS);
+}
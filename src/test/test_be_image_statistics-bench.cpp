@@ -0,0 +1,131 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+/*
+ * Compare a scalar loop over Image::getRawGrayscaleData() computing the
+ * histogram, mean, variance and 16x16 block variance to
+ * Image::computeStatistics() of the same decoded image.
+ *
+ * Usage: test_be_image_statistics-bench [iterations]
+ */
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <be_error_exception.h>
+#include <be_image_raw.h>
+#include <be_image_statistics.h>
+#include <be_image_wsq.h>
+#include <be_io_utility.h>
+#include <be_time_timer.h>
+
+using namespace BiometricEvaluation;
+using namespace std;
+
+static const uint32_t BlockSize = 16;
+
+/* Statistics as clients compute them, returning the variance */
+static double
+scalarStatistics(
+    const Image::Image &image)
+{
+	const auto gray = image.getRawGrayscaleData(8);
+	const Image::Size size = image.getDimensions();
+
+	std::vector<uint64_t> histogram(256);
+	double sum = 0, squares = 0;
+	for (uint64_t i = 0; i < gray.size(); i++) {
+		histogram[gray[i]]++;
+		sum += gray[i];
+		squares += gray[i] * gray[i];
+	}
+	const double mean = sum / gray.size();
+
+	std::vector<float> blockVariance;
+	for (uint32_t by = 0; by < size.ySize; by += BlockSize) {
+		for (uint32_t bx = 0; bx < size.xSize; bx += BlockSize) {
+			double blockSum = 0, blockSquares = 0, count = 0;
+			for (uint32_t y = by; (y < by + BlockSize) &&
+			    (y < size.ySize); y++) {
+				for (uint32_t x = bx; (x < bx + BlockSize) &&
+				    (x < size.xSize); x++) {
+					const double v = gray[(y * size.xSize) +
+					    x];
+					blockSum += v;
+					blockSquares += v * v;
+					count++;
+				}
+			}
+			const double blockMean = blockSum / count;
+			blockVariance.push_back(static_cast<float>(
+			    (blockSquares / count) - (blockMean * blockMean)));
+		}
+	}
+
+	return ((squares / gray.size()) - (mean * mean));
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+	const uint32_t iterations = (argc > 1 ? std::atoi(argv[1]) : 1000);
+	if (iterations == 0) {
+		cerr << "Usage: " << argv[0] << " [iterations]" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	try {
+		/* Time the statistics, not decoding */
+		const Image::WSQ wsq(IO::Utility::readFile(
+		    "test_data/img.wsq"));
+		const Image::Raw raw(wsq.getRawData(), wsq.getDimensions(),
+		    wsq.getColorDepth(), wsq.getBitDepth(),
+		    wsq.getResolution(), false);
+		Image::StatisticsOptions options;
+		options.blockSize = BlockSize;
+
+		Time::Timer timer;
+		double variance = 0;
+		timer.start();
+		for (uint32_t n = 0; n < iterations; n++)
+			variance = scalarStatistics(raw);
+		timer.stop();
+		const double scalarUS = static_cast<double>(
+		    timer.elapsed()) / iterations;
+
+		Image::Statistics statistics;
+		timer.start();
+		for (uint32_t n = 0; n < iterations; n++)
+			statistics = Image::computeStatistics(raw, 8, options);
+		timer.stop();
+		const double statisticsUS = static_cast<double>(
+		    timer.elapsed()) / iterations;
+
+		cout << "Mean time (us) of " << iterations << " passes over " <<
+		    raw.getDimensions() << endl;
+		cout << right << setw(20) << "Scalar loop" << setw(20) <<
+		    "computeStatistics" << setw(10) << "Speedup" << endl;
+		cout << fixed << setprecision(2) << setw(20) << scalarUS <<
+		    setw(20) << statisticsUS << setw(10) <<
+		    (scalarUS / statisticsUS) << endl;
+		cout << "Variance " << variance << " and " <<
+		    statistics.variance << endl;
+	} catch (const Error::Exception &e) {
+		cerr << "Could not compute statistics: " << e.whatString() <<
+		    endl;
+		return (EXIT_FAILURE);
+	}
+
+	return (EXIT_SUCCESS);
+}
@@ -0,0 +1,163 @@
+/*
+ * This software was developed at the National Institute of Standards and
+ * Technology (NIST) by employees of the Federal Government in the course
+ * of their official duties. Pursuant to title 17 Section 105 of the
+ * United States Code, this software is not subject to copyright protection
+ * and is in the public domain. NIST assumes no responsibility whatsoever for
+ * its use by other parties, and makes no guarantees, expressed or implied,
+ * about its quality, reliability, or any other characteristic.
+ */
+
+/*
+ * Compare cropping WSQ images in the coefficient domain with decoding,
+ * cropping the pixels, and encoding each region again, splitting each
+ * image into four side-by-side regions as when segmenting a slap.
+ *
+ * Usage: test_be_image_wsq-bench [iterations]
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <be_error_exception.h>
+#include <be_image_encode.h>
+#include <be_image_raw.h>
+#include <be_image_wsq.h>
+#include <be_time_timer.h>
+
+#include "test_be_image_bench.h"
+
+using namespace BiometricEvaluation;
+using namespace std;
+
+static const std::string SingleImagePath = "test_data/img.wsq";
+static const uint32_t RegionCount = 4;
+
+/**
+ * @return Side-by-side regions covering an image, each starting on a
+ * multiple of 32 pixels so both methods crop the same pixels.
+ */
+static vector<Image::ROI>
+slapRegions(
+    const Image::Size &dimensions)
+{
+	const uint32_t width = std::max<uint32_t>(32,
+	    ((dimensions.xSize / RegionCount) / 32) * 32);
+
+	vector<Image::ROI> rois;
+	for (uint32_t x = 0; x < dimensions.xSize; x += width) {
+		rois.emplace_back(Image::Size(std::min(width,
+		    dimensions.xSize - x), dimensions.ySize), x, 0,
+		    Image::CoordinateSet());
+	}
+	return (rois);
+}
+
+/** @return Regions of wsq decoded, cropped, and encoded again */
+static vector<Memory::uint8Array>
+recompress(
+    const Image::WSQ &wsq,
+    const vector<Image::ROI> &rois)
+{
+	const auto raw = wsq.getRawData();
+	const uint32_t width = wsq.getDimensions().xSize;
+
+	vector<Memory::uint8Array> crops;
+	for (const auto &roi : rois) {
+		Memory::uint8Array pixels(roi.size.xSize * roi.size.ySize);
+		for (uint32_t y = 0; y < roi.size.ySize; y++)
+			std::copy_n(&raw[((roi.vertOffset + y) * width) +
+			    roi.horzOffset], roi.size.xSize,
+			    &pixels[y * roi.size.xSize]);
+
+		crops.push_back(Image::encode(Image::Raw(pixels, roi.size, 8,
+		    8, wsq.getResolution(), false),
+		    Image::CompressionAlgorithm::WSQ20));
+	}
+	return (crops);
+}
+
+/** @return Total size of crops, in bytes */
+static uint64_t
+totalSize(
+    const vector<Memory::uint8Array> &crops)
+{
+	uint64_t size = 0;
+	for (const auto &crop : crops)
+		size += crop.size();
+	return (size);
+}
+
+int
+main(
+    int argc,
+    char *argv[])
+{
+	const uint32_t iterations = (argc > 1 ? std::atoi(argv[1]) : 10);
+	if (iterations == 0) {
+		cerr << "Usage: " << argv[0] << " [iterations]" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	const auto images = BenchImages::loadImages({SingleImagePath},
+	    {"wsq"});
+	if (images.empty()) {
+		cerr << "No WSQ images found" << endl;
+		return (EXIT_FAILURE);
+	}
+
+	cout << "Mean time (ms) of " << iterations << " crops into " <<
+	    RegionCount << " regions, and total size (bytes) of the regions" <<
+	    endl;
+	cout << left << setw(32) << "Image" << setw(12) << "Size" << right <<
+	    setw(10) << "Coeff ms" << setw(10) << "Recomp ms" << setw(10) <<
+	    "Speedup" << setw(12) << "Coeff B" << setw(12) << "Recomp B" <<
+	    endl;
+
+	double coeffTotal = 0, recompressTotal = 0;
+	for (const auto &image : images) {
+		try {
+			const Image::WSQ wsq(image.second, image.first);
+			const auto rois = slapRegions(wsq.getDimensions());
+			cout << left << setw(32) << image.first << setw(12) <<
+			    to_string(wsq.getDimensions());
+
+			vector<Memory::uint8Array> coeffCrops, recompressCrops;
+			Time::Timer timer;
+			timer.start();
+			for (uint32_t n = 0; n < iterations; n++)
+				coeffCrops = wsq.crop(rois);
+			timer.stop();
+			const double coeffMS = timer.elapsed() / 1000.0 /
+			    iterations;
+
+			timer.start();
+			for (uint32_t n = 0; n < iterations; n++)
+				recompressCrops = recompress(wsq, rois);
+			timer.stop();
+			const double recompressMS = timer.elapsed() / 1000.0 /
+			    iterations;
+
+			coeffTotal += coeffMS;
+			recompressTotal += recompressMS;
+			cout << right << fixed << setprecision(2) << setw(10) <<
+			    coeffMS << setw(10) << recompressMS << setw(10) <<
+			    (recompressMS / coeffMS) << setw(12) <<
+			    totalSize(coeffCrops) << setw(12) <<
+			    totalSize(recompressCrops) << endl;
+		} catch (const Error::Exception &e) {
+			cout << "Could not crop: " << e.whatString() << endl;
+		}
+	}
+
+	cout << left << setw(44) << "Total" << right << fixed <<
+	    setprecision(2) << setw(10) << coeffTotal << setw(10) <<
+	    recompressTotal << setw(10) << (recompressTotal / coeffTotal) <<
+	    endl;
+
+	return (EXIT_SUCCESS);
+}
@@ -15,6 +15,7 @@
 #include <sstream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include <be_io_utility.h>
 #include <be_memory_autoarrayutility.h>
@@ -50,6 +51,11 @@
 #define TESTDEFINED
 #endif
 
+#ifdef DEDUPLICATEDRECORDSTORETEST
+#include <be_io_deduplicatedrecstore.h>
+#define TESTDEFINED
+#endif
+
 #ifdef TESTDEFINED
 using namespace BiometricEvaluation;
 #endif
@@ -474,6 +480,51 @@ runTests(IO::RecordStore *rs)
 	Memory::AutoArrayUtility::setString(rdata, str);
 	rs->insert(tempKey, rdata);
 
+	/* Test checksum verification of the sequenced records */
+	cout << endl << "Verifying checksums... ";
+	try {
+		const std::vector<std::string> badKeys = rs->verify();
+		if (badKeys.empty()) {
+			cout << "success." << endl;
+		} else {
+			cout << "FAILED:";
+			for (const auto &badKey : badKeys)
+				cout << " " << badKey;
+			cout << endl;
+		}
+		rs->setChecksumVerification(true);
+		(void)rs->read(tempKey);
+		rs->setChecksumVerification(false);
+		cout << "Read with verification... success." << endl;
+	} catch (Error::Exception &e) {
+		cout << "Caught: " << e.what() << endl;
+	}
+
+	/* Read the sequenced records at once, in reverse order */
+	cout << endl << "Batch reading records... ";
+	try {
+		std::vector<std::string> keys;
+		for (i = SEQUENCECOUNT - 1; i >= 0; i--)
+			keys.push_back("key" + std::to_string(i));
+		const std::vector<Memory::uint8Array> records = rs->read(keys);
+		bool same = (records.size() == keys.size());
+		for (size_t k = 0; same && (k < keys.size()); k++) {
+			const Memory::uint8Array record = rs->read(keys[k]);
+			same = ((record.size() == records[k].size()) &&
+			    (memcmp(record, records[k], record.size()) == 0));
+		}
+		cout << (same ? "success." : "FAILED (mismatch).") << endl;
+
+		keys.push_back("aBogusKey");
+		cout << "Batch reading a missing record... ";
+		(void)rs->read(keys);
+		cout << "FAILED (no exception)." << endl;
+	} catch (Error::ObjectDoesNotExist &e) {
+		cout << "success." << endl;
+	} catch (Error::Exception &e) {
+		cout << "Caught: " << e.what() << endl;
+	}
+
 	cout << endl << "Changing RecordStore path..." << endl;
 	try {
 		string newPath = IO::Utility::createTemporaryFile("", "");
@@ -697,6 +748,22 @@ main(int argc, char* argv[]) {
 	}
 #endif
 
+#ifdef DEDUPLICATEDRECORDSTORETEST
+	/* Call the constructor that will create a new DeduplicatedRecordStore. */
+	rsPath = "deduprs_test";
+	IO::DeduplicatedRecordStore *rs;
+	try {
+		rs = new IO::DeduplicatedRecordStore(rsPath,
+		    "DeduplicatedRecordStore Test", IO::RecordStore::Kind::Archive);
+	} catch (Error::ObjectExists &e) {
+		cout << "The Deduplicated Record Store exists; exiting." << endl;
+		return (EXIT_FAILURE);
+	} catch (Error::StrategyError& e) {
+		cout << "A strategy error occurred: " << e.what() << endl;
+		return (EXIT_FAILURE);
+	}
+#endif
+
 #ifdef TESTDEFINED
 
 	cout << "Running tests with new record store:" << endl;
@@ -778,6 +845,20 @@ main(int argc, char* argv[]) {
 	}
 #endif
 
+#ifdef DEDUPLICATEDRECORDSTORETEST
+	/* Call the constructor that will open an existing DeduplicatedRecordStore.*/
+	rsPath = "deduprs_test";
+	try {
+		rs = new IO::DeduplicatedRecordStore(rsPath, IO::Mode::ReadWrite);
+	} catch (Error::ObjectDoesNotExist &e) {
+		cout << "The Deduplicated Record Store does not exist; exiting." << endl;
+		return (EXIT_FAILURE);
+	} catch (Error::StrategyError& e) {
+		cout << "A strategy error occurred: " << e.what() << endl;
+		return (EXIT_FAILURE);
+	}
+#endif
+
 #ifdef TESTDEFINED
 
 	cout << endl << "----------------------------------------" << endl << endl;
@@ -805,6 +886,31 @@ main(int argc, char* argv[]) {
 	} catch (Error::StrategyError& e) {
 		cout << "failed:" << e.what() << "." << endl;
 	}
+#endif
+#ifdef DEDUPLICATEDRECORDSTORETEST
+	/*
+	 * Insert the same value under several keys; it should be
+	 * stored only once.
+	 */
+	cout << "Deduplicating... ";
+	try {
+		const uint64_t uniqueCount = rs->getUniqueCount();
+		const string dupStr = "DUPLICATE VALUE";
+		rs->insert("dup1", dupStr.data(), dupStr.size());
+		rs->insert("dup2", dupStr.data(), dupStr.size());
+		rs->insert("dup3", dupStr.data(), dupStr.size());
+		if (rs->getUniqueCount() == (uniqueCount + 1))
+			cout << "success." << endl;
+		else
+			cout << "FAILED." << endl;
+		cout << "Deduplication ratio is " <<
+		    rs->getDeduplicationRatio() << endl;
+		rs->remove("dup1");
+		rs->remove("dup2");
+		rs->remove("dup3");
+	} catch (Error::Exception &e) {
+		cout << "Caught: " << e.what() << endl;
+	}
 #endif
 	delete rs;
 